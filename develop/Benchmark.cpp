@@ -0,0 +1,365 @@
+/**
+ * \file Benchmark.cpp
+ * \brief Microbenchmarks for the principal GeographicLib kernels
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ *
+ * Usage: Benchmark [-t mintime] [-r reps] [-f filter] [-g geoid]
+ *
+ * Each benchmark cycles through a fixed set of pseudo-random inputs
+ * (generated with a fixed seed, so the runs are reproducible).  Its
+ * iteration count is doubled until a run takes at least mintime seconds
+ * (default 0.2); this run is repeated reps times (default 5) and the median
+ * and minimum times per call are reported.  The results are written to
+ * standard output as JSON whose context records the precision, so that
+ * builds with different values of GEOGRAPHICLIB_PRECISION and different
+ * releases can be compared.  Only benchmarks whose names contain filter are
+ * run.  The Geoid benchmarks use the geoid named by -g (default egm96-5) and
+ * are skipped if it is not installed.
+ **********************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <memory>
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/NearestNeighbor.hpp>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+namespace {
+
+  typedef Math::real real;
+
+  // The number of distinct inputs cycled through by each benchmark
+  const size_t ninput = 4096;
+
+  // Accumulate the results here so that the calculations are not optimized
+  // away.
+  volatile double sink = 0;
+
+  struct result {
+    string name;
+    unsigned long long iterations;
+    double median, min;         // nanoseconds per call
+  };
+
+  class Runner {
+  private:
+    double _mintime;
+    int _reps;
+    string _filter;
+    vector<result> _results;
+  public:
+    Runner(double mintime, int reps, const string& filter)
+      : _mintime(mintime), _reps(reps), _filter(filter) {}
+    // f(i) performs one call using input i (in [0, ninput)).
+    void run(const string& name, const function<real(size_t)>& f) {
+      if (name.find(_filter) == string::npos) return;
+      typedef chrono::steady_clock clock;
+      auto timeit = [&f](unsigned long long n) -> double {
+        auto t0 = clock::now();
+        real s = 0;
+        for (unsigned long long k = 0; k < n; ++k)
+          s += f(size_t(k % ninput));
+        auto t1 = clock::now();
+        sink = sink + double(s);
+        return chrono::duration<double>(t1 - t0).count();
+      };
+      unsigned long long n = 1;
+      while (timeit(n) < _mintime && n < (1ULL << 40)) n *= 2;
+      vector<double> t(_reps);
+      for (int r = 0; r < _reps; ++r)
+        t[r] = timeit(n) / double(n) * 1e9;
+      sort(t.begin(), t.end());
+      result res = {name, n, t[_reps / 2], t[0]};
+      _results.push_back(res);
+      cerr << name << ": " << res.median << " ns\n";
+    }
+    void json(ostream& os) const {
+      os << "{\n  \"context\": {\n"
+         << "    \"library\": \"GeographicLib\",\n"
+         << "    \"version\": \"" << GEOGRAPHICLIB_VERSION_STRING << "\",\n"
+         << "    \"precision\": " << GEOGRAPHICLIB_PRECISION << ",\n"
+         << "    \"digits\": " << Math::digits() << ",\n"
+         << "    \"min_time\": " << _mintime << ",\n"
+         << "    \"repetitions\": " << _reps << "\n  },\n"
+         << "  \"benchmarks\": [";
+      for (size_t i = 0; i < _results.size(); ++i) {
+        const result& r = _results[i];
+        os << (i ? ",\n" : "\n")
+           << "    {\"name\": \"" << r.name << "\", "
+           << "\"iterations\": " << r.iterations << ", "
+           << "\"real_time\": " << r.median << ", "
+           << "\"min_time\": " << r.min << ", "
+           << "\"time_unit\": \"ns\"}";
+      }
+      os << "\n  ]\n}\n";
+    }
+  };
+
+  struct pos {
+    real lat, lon;
+    pos(real lat1 = 0, real lon1 = 0) : lat(lat1), lon(lon1) {}
+  };
+
+  class DistanceCalculator {
+  private:
+    const Geodesic& _geod;
+  public:
+    explicit DistanceCalculator(const Geodesic& geod) : _geod(geod) {}
+    real operator() (const pos& a, const pos& b) const {
+      real d;
+      _geod.Inverse(a.lat, a.lon, b.lat, b.lon, d);
+      return d;
+    }
+  };
+
+}
+
+int main(int argc, const char* const argv[]) {
+  typedef Math::real real;
+  try {
+    Utility::set_digits();
+    double mintime = 0.2;
+    int reps = 5;
+    string filter, geoidname = "egm96-5";
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-t" && m + 1 < argc)
+        mintime = Utility::val<double>(string(argv[++m]));
+      else if (arg == "-r" && m + 1 < argc)
+        reps = max(1, Utility::val<int>(string(argv[++m])));
+      else if (arg == "-f" && m + 1 < argc)
+        filter = argv[++m];
+      else if (arg == "-g" && m + 1 < argc)
+        geoidname = argv[++m];
+      else {
+        cerr << "Usage: " << argv[0]
+             << " [-t mintime] [-r reps] [-f filter] [-g geoid]\n";
+        return 1;
+      }
+    }
+
+    // Inputs: global points, nearby points (for the projections), and
+    // azimuths and distances.
+    mt19937 r(17);
+    uniform_real_distribution<double> U(0, 1);
+    vector<real> lat1(ninput), lon1(ninput), lat2(ninput), lon2(ninput),
+      azi1(ninput), s12(ninput), latl(ninput), lonl(ninput),
+      x(ninput), y(ninput);
+    vector<int> zone(ninput);
+    vector<bool> northp(ninput);
+    vector<string> mgrs(ninput);
+    for (size_t i = 0; i < ninput; ++i) {
+      using std::asin;
+      lat1[i] = asin(real(2 * U(r) - 1)) / Math::degree();
+      lat2[i] = asin(real(2 * U(r) - 1)) / Math::degree();
+      lon1[i] = real(360 * U(r) - 180);
+      lon2[i] = real(360 * U(r) - 180);
+      azi1[i] = real(360 * U(r) - 180);
+      s12[i] = real(2e7 * U(r));
+      // Within the UTM zones, and within 3 degrees of the central meridian
+      latl[i] = real(160 * U(r) - 80);
+      lonl[i] = real(6 * U(r) - 3);
+    }
+    Runner runner(mintime, reps, filter);
+
+    {
+      const Geodesic& g = Geodesic::WGS84();
+      runner.run("Geodesic::Inverse", [&](size_t i) -> real {
+        real s; g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s);
+        return s;
+      });
+      runner.run("Geodesic::Direct", [&](size_t i) -> real {
+        real lat, lon; g.Direct(lat1[i], lon1[i], azi1[i], s12[i], lat, lon);
+        return lat;
+      });
+    }
+    {
+      const GeodesicExact& g = GeodesicExact::WGS84();
+      runner.run("GeodesicExact::Inverse", [&](size_t i) -> real {
+        real s; g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s);
+        return s;
+      });
+      runner.run("GeodesicExact::Direct", [&](size_t i) -> real {
+        real lat, lon; g.Direct(lat1[i], lon1[i], azi1[i], s12[i], lat, lon);
+        return lat;
+      });
+    }
+    {
+      const Rhumb& rh = Rhumb::WGS84();
+      runner.run("Rhumb::Inverse", [&](size_t i) -> real {
+        real s, azi; rh.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s, azi);
+        return s;
+      });
+      runner.run("Rhumb::Direct", [&](size_t i) -> real {
+        real lat, lon; rh.Direct(lat1[i], lon1[i], azi1[i], s12[i], lat, lon);
+        return lat;
+      });
+    }
+    {
+      const TransverseMercator& tm = TransverseMercator::UTM();
+      for (size_t i = 0; i < ninput; ++i)
+        tm.Forward(0, latl[i], lonl[i], x[i], y[i]);
+      runner.run("TransverseMercator::Forward", [&](size_t i) -> real {
+        real xx, yy; tm.Forward(0, latl[i], lonl[i], xx, yy);
+        return xx;
+      });
+      runner.run("TransverseMercator::Reverse", [&](size_t i) -> real {
+        real lat, lon; tm.Reverse(0, x[i], y[i], lat, lon);
+        return lat;
+      });
+    }
+    {
+      for (size_t i = 0; i < ninput; ++i) {
+        bool n;
+        UTMUPS::Forward(lat1[i], lon1[i], zone[i], n, x[i], y[i]);
+        northp[i] = n;
+        MGRS::Forward(zone[i], n, x[i], y[i], lat1[i], 5, mgrs[i]);
+      }
+      runner.run("UTMUPS::Forward", [&](size_t i) -> real {
+        int z; bool n; real xx, yy;
+        UTMUPS::Forward(lat1[i], lon1[i], z, n, xx, yy);
+        return xx;
+      });
+      runner.run("UTMUPS::Reverse", [&](size_t i) -> real {
+        real lat, lon;
+        UTMUPS::Reverse(zone[i], northp[i], x[i], y[i], lat, lon);
+        return lat;
+      });
+      string str;
+      runner.run("MGRS::Forward", [&](size_t i) -> real {
+        MGRS::Forward(zone[i], northp[i], x[i], y[i], lat1[i], 5, str);
+        return real(str.size());
+      });
+      runner.run("MGRS::Reverse", [&](size_t i) -> real {
+        int z, prec; bool n; real xx, yy;
+        MGRS::Reverse(mgrs[i], z, n, xx, yy, prec);
+        return xx;
+      });
+    }
+    {
+      unique_ptr<Geoid> geoids[4];
+      try {
+        for (int k = 0; k < 4; ++k)
+          geoids[k].reset(new Geoid(geoidname, "", k & 1));
+      }
+      catch (const exception& e) {
+        cerr << "Skipping the Geoid benchmarks: " << e.what() << "\n";
+      }
+      if (geoids[3]) {
+        // k & 1 = cubic, k & 2 = cached
+        geoids[2]->CacheAll(); geoids[3]->CacheAll();
+        const char* names[4] = {"bilinear", "cubic",
+                                "bilinear/cached", "cubic/cached"};
+        for (int k = 0; k < 4; ++k) {
+          const Geoid& geoid = *geoids[k];
+          runner.run(string("Geoid/") + names[k], [&](size_t i) -> real {
+            return geoid(lat1[i], lon1[i]);
+          });
+        }
+      }
+    }
+    {
+      // Random coefficients decaying as 1/n^2 (roughly like a geopotential
+      // model).
+      const int degrees[] = {10, 100, 360};
+      for (int N : degrees) {
+        int K = (N + 1) * (N + 2) / 2;
+        vector<real> C(K), S(K - (N + 1));
+        for (int m = 0, k = 0; m <= N; ++m)
+          for (int n = m; n <= N; ++n, ++k) {
+            real scale = 1 / real((n + 1) * (n + 1));
+            C[k] = real(2 * U(r) - 1) * scale;
+            if (m > 0) S[k - (N + 1)] = real(2 * U(r) - 1) * scale;
+          }
+        SphericalHarmonic h(C, S, N, real(6378137));
+        vector<real> X(ninput), Y(ninput), Z(ninput);
+        for (size_t i = 0; i < ninput; ++i) {
+          real sphi, cphi, slam, clam;
+          Math::sincosd(lat1[i], sphi, cphi);
+          Math::sincosd(lon1[i], slam, clam);
+          X[i] = 7e6 * cphi * clam; Y[i] = 7e6 * cphi * slam;
+          Z[i] = 7e6 * sphi;
+        }
+        ostringstream name; name << "SphericalEngine/" << N;
+        runner.run(name.str(), [&](size_t i) -> real {
+          return h(X[i], Y[i], Z[i]);
+        });
+        runner.run(name.str() + "/gradient", [&](size_t i) -> real {
+          real gx, gy, gz;
+          return h(X[i], Y[i], Z[i], gx, gy, gz);
+        });
+      }
+    }
+    {
+      // Polygons with 10 vertices distributed on circles of radius 100 km.
+      const int nvert = 10;
+      const Geodesic& g = Geodesic::WGS84();
+      vector<real> plat(ninput * nvert), plon(ninput * nvert);
+      for (size_t i = 0; i < ninput; ++i)
+        for (int j = 0; j < nvert; ++j)
+          g.Direct(lat1[i], lon1[i], real(360 * j) / nvert, real(1e5),
+                   plat[i * nvert + j], plon[i * nvert + j]);
+      PolygonArea poly(g);
+      runner.run("PolygonArea/10", [&](size_t i) -> real {
+        poly.Clear();
+        for (int j = 0; j < nvert; ++j)
+          poly.AddPoint(plat[i * nvert + j], plon[i * nvert + j]);
+        real perimeter, area;
+        poly.Compute(false, true, perimeter, area);
+        return area;
+      });
+    }
+    {
+      // Nearest of 10000 random points
+      const Geodesic& g = Geodesic::WGS84();
+      DistanceCalculator dist(g);
+      vector<pos> pts;
+      pts.reserve(10000);
+      for (int i = 0; i < 10000; ++i) {
+        using std::asin;
+        pts.push_back(pos(asin(real(2 * U(r) - 1)) / Math::degree(),
+                          real(360 * U(r) - 180)));
+      }
+      vector<pos> queries;
+      for (size_t i = 0; i < ninput; ++i)
+        queries.push_back(pos(lat2[i], lon2[i]));
+      NearestNeighbor<real, pos, DistanceCalculator> nn(pts, dist);
+      vector<int> ind;
+      runner.run("NearestNeighbor::Search/10000", [&](size_t i) -> real {
+        return nn.Search(pts, dist, queries[i], ind);
+      });
+    }
+
+    runner.json(cout);
+    return 0;
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    cerr << "Caught unknown exception\n";
+    return 1;
+  }
+}
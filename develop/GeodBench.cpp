@@ -0,0 +1,241 @@
+/**
+ * \file GeodBench.cpp
+ * \brief Throughput and latency of the geodesic routines on GeodTest.dat
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/Utility.hpp>
+#include "Geodesic30.hpp"
+#include "GeodesicLine30.hpp"
+
+using namespace std;
+using namespace GeographicLib;
+
+int usage(int retval) {
+  ( retval ? cerr : cout ) <<
+"GeodBench [ -g | -e | -3 ] [ -m mode ] [ -j nthreads ] [ -h ]\n\
+\n\
+Time the geodesic routines using the data in GeodTest.dat (read on\n\
+standard input; it may be truncated).\n\
+-g (default) use Geodesic\n\
+-e use GeodesicExact\n\
+-3 use Geodesic30 (with doubles)\n\
+-m mode, one of direct, inverse, area, line, or all (the default);\n\
+   direct = Direct, inverse = Inverse for s12 azi1 azi2, area = Inverse\n\
+   for all the quantities including S12, line = construct a line and\n\
+   find one point on it\n\
+-j nthreads, also measure the throughput with nthreads threads\n\
+   (default 0 = the number of threads the hardware supports)\n\
+\n\
+For each mode, a single-threaded pass times each call and reports the\n\
+throughput and the latency percentiles, overall and for each of the 9\n\
+classes of geodesics in GeodTest.dat (the class is determined by the\n\
+line number).  The tail of the Inverse latencies comes from the Newton\n\
+iterations on Lambda12 for nearly antipodal points (class 1).  A\n\
+multi-threaded pass (without the per-call timings) then reports the\n\
+throughput with nthreads threads.\n";
+  return retval;
+}
+
+namespace {
+
+  typedef Math::real real;
+  typedef chrono::steady_clock timer;
+
+  // The classes of geodesics in GeodTest.dat, given by starting line number.
+  const size_t nclass = 9;
+  const size_t classstart[nclass + 1] = {
+    0, 100000, 150000, 200000, 250000, 300000, 350000, 400000, 450000,
+    500000};
+  const char* classname[nclass] = {
+    "random", "nearly antipodal", "short", "one end near pole",
+    "both ends near pole", "nearly meridional", "nearly equatorial",
+    "between vertices", "ending near vertices"};
+
+  struct data {
+    vector<real> lat1, lon1, azi1, lat2, lon2, s12;
+    size_t size() const { return lat1.size(); }
+  };
+
+  enum { DIRECT, INVERSE, AREA, LINE, NMODES };
+  const char* modename[NMODES] = {"direct", "inverse", "area", "line"};
+
+  // Perform call i in the given mode, returning a result to accumulate.
+  template<class G, class L, typename T>
+  double call(const G& g, const data& d, int mode, size_t i) {
+    T lat2, lon2, azi2, s12, azi1, m12, M12, M21, S12;
+    switch (mode) {
+    case DIRECT:
+      g.Direct(T(d.lat1[i]), T(d.lon1[i]), T(d.azi1[i]), T(d.s12[i]),
+               lat2, lon2, azi2);
+      return double(lat2);
+    case INVERSE:
+      g.Inverse(T(d.lat1[i]), T(d.lon1[i]), T(d.lat2[i]), T(d.lon2[i]),
+                s12, azi1, azi2);
+      return double(s12);
+    case AREA:
+      g.Inverse(T(d.lat1[i]), T(d.lon1[i]), T(d.lat2[i]), T(d.lon2[i]),
+                s12, azi1, azi2, m12, M12, M21, S12);
+      return double(S12);
+    default:                    // LINE
+      {
+        L l(g, T(d.lat1[i]), T(d.lon1[i]), T(d.azi1[i]));
+        l.Position(T(d.s12[i]), lat2, lon2);
+        return double(lat2);
+      }
+    }
+  }
+
+  double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t k = min(sorted.size() - 1, size_t(p / 100 * double(sorted.size())));
+    return sorted[k];
+  }
+
+  void report(const string& label, vector<double>& lat) {
+    sort(lat.begin(), lat.end());
+    cout << "  " << left << setw(22) << label << right
+         << setw(9) << lat.size()
+         << setw(9) << percentile(lat, 50) << setw(9) << percentile(lat, 90)
+         << setw(9) << percentile(lat, 99) << setw(9) << percentile(lat, 99.9)
+         << setw(9) << (lat.empty() ? 0 : lat.back()) << "\n";
+  }
+
+  template<class G, class L, typename T>
+  void bench(const G& g, const data& d, int mode, int nthreads) {
+    size_t n = d.size();
+    double sum = 0;
+    // Single-threaded pass timing each call (in ns)
+    vector<double> lat(n);
+    auto t0 = timer::now();
+    for (size_t i = 0; i < n; ++i) {
+      auto c0 = timer::now();
+      sum += call<G, L, T>(g, d, mode, i);
+      auto c1 = timer::now();
+      lat[i] = chrono::duration<double, nano>(c1 - c0).count();
+    }
+    double t1 = chrono::duration<double>(timer::now() - t0).count();
+    cout << modename[mode] << ": 1 thread " << double(n) / t1
+         << " ops/s\n  " << left << setw(22) << "latency (ns)" << right
+         << setw(9) << "count" << setw(9) << "p50" << setw(9) << "p90"
+         << setw(9) << "p99" << setw(9) << "p99.9" << setw(9) << "max\n";
+    for (size_t c = 0; c < nclass && classstart[c] < n; ++c) {
+      vector<double> cl(lat.begin() + classstart[c],
+                        lat.begin() + min(n, classstart[c + 1]));
+      report(classname[c], cl);
+    }
+    if (n > classstart[nclass]) {
+      vector<double> cl(lat.begin() + classstart[nclass], lat.end());
+      report("extra", cl);
+    }
+    report("all", lat);
+    // Multi-threaded pass; the lines are handed out in chunks
+    if (nthreads > 1) {
+      const size_t chunk = 1024;
+      atomic<size_t> next(0);
+      vector<double> sums(nthreads, 0);
+      auto worker = [&](int k) -> void {
+        for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+          for (size_t i = i0; i < min(n, i0 + chunk); ++i)
+            sums[k] += call<G, L, T>(g, d, mode, i);
+      };
+      t0 = timer::now();
+      vector<thread> threads;
+      for (int k = 1; k < nthreads; ++k)
+        threads.push_back(thread(worker, k));
+      worker(0);
+      for (auto& th : threads) th.join();
+      double tn = chrono::duration<double>(timer::now() - t0).count();
+      cout << modename[mode] << ": " << nthreads << " threads "
+           << double(n) / tn << " ops/s (speedup " << t1 / tn << ")\n";
+      for (double s : sums) sum += s;
+    }
+    // Print the checksum so that the calls are not optimized away
+    cout << "  checksum " << sum << "\n";
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+  typedef Math::real real;
+  try {
+    Utility::set_digits();
+    int geodtype = 0, mode = NMODES,
+      nthreads = int(thread::hardware_concurrency());
+    for (int m = 1; m < argc; ++m) {
+      string arg(argv[m]);
+      if (arg == "-g")
+        geodtype = 0;
+      else if (arg == "-e")
+        geodtype = 1;
+      else if (arg == "-3")
+        geodtype = 2;
+      else if (arg == "-m" && m + 1 < argc) {
+        string s(argv[++m]);
+        for (mode = 0; mode < NMODES && s != modename[mode]; ++mode) {}
+        if (mode == NMODES && s != "all") return usage(1);
+      } else if (arg == "-j" && m + 1 < argc) {
+        nthreads = Utility::val<int>(string(argv[++m]));
+        if (nthreads <= 0) nthreads = int(thread::hardware_concurrency());
+      } else
+        return usage(arg == "-h" ? 0 : 1);
+    }
+    nthreads = max(1, nthreads);
+
+    data d;
+    {
+      string s;
+      real lat1, lon1, azi1, lat2, lon2, azi2, s12;
+      istringstream str;
+      while (getline(cin, s)) {
+        str.clear(); str.str(s);
+        if (!(str >> lat1 >> lon1 >> azi1 >> lat2 >> lon2 >> azi2 >> s12))
+          throw GeographicErr("Bad input line: " + s);
+        d.lat1.push_back(lat1); d.lon1.push_back(lon1);
+        d.azi1.push_back(azi1); d.lat2.push_back(lat2);
+        d.lon2.push_back(lon2); d.s12.push_back(s12);
+      }
+    }
+    cout << d.size() << " geodesics; "
+         << (geodtype == 0 ? "Geodesic" :
+             (geodtype == 1 ? "GeodesicExact" : "Geodesic30"))
+         << "; precision " << Math::digits() << " bits\n";
+    for (int k = 0; k < NMODES; ++k) {
+      if (!(mode == NMODES || mode == k)) continue;
+      if (geodtype == 0)
+        bench<Geodesic, GeodesicLine, real>
+          (Geodesic::WGS84(), d, k, nthreads);
+      else if (geodtype == 1)
+        bench<GeodesicExact, GeodesicLineExact, real>
+          (GeodesicExact::WGS84(), d, k, nthreads);
+      else {
+        static const Geodesic30<double>
+          g30(Constants::WGS84_a<double>(), Constants::WGS84_f<double>());
+        bench<Geodesic30<double>, GeodesicLine30<double>, double>
+          (g30, d, k, nthreads);
+      }
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -61,10 +61,10 @@ namespace GeographicLib {
     , _f(f <= 1 ? f : 1/f)
     , _f1(1 - _f)
     , _e2(_f * (2 - _f))
-    , _ep2(_e2 / Math::sq(_f1))       // e2 / (1 - e2)
+    , _ep2(_e2 / Math::_sq(_f1))       // e2 / (1 - e2)
     , _n(_f / ( 2 - _f))
     , _b(_a * _f1)
-    , _c2((Math::sq(_a) + Math::sq(_b) *
+    , _c2((Math::_sq(_a) + Math::_sq(_b) *
            (_e2 == 0 ? 1 :
             (_e2 > 0 ? atanh(sqrt(_e2)) : atan(sqrt(-_e2))) /
             sqrt(abs(_e2))))/2) // authalic radius squared
@@ -281,9 +281,9 @@ namespace GeographicLib {
 
       if (sig12 >= 0) {
         // Short lines (InverseStart sets salp2, calp2)
-        real wm = sqrt(1 - _e2 * Math::sq((cbet1 + cbet2) / 2));
+        real wm = sqrt(1 - _e2 * Math::_sq((cbet1 + cbet2) / 2));
         s12x = sig12 * _a * wm;
-        m12x = Math::sq(wm) * _a / _f1 * sin(sig12 * _f1 / wm);
+        m12x = Math::_sq(wm) * _a / _f1 * sin(sig12 * _f1 / wm);
         if (outmask & GEODESICSCALE)
           M12 = M21 = cos(sig12 * _f1 / wm);
         a12 = sig12 / Math::degree<real>();
@@ -318,7 +318,7 @@ namespace GeographicLib {
           // 200 * epsilon.  The second takes credit for an anticipated
           // reduction in abs(v) by v/ov (due to the latest update in alp1) and
           // checks this against epsilon.
-          if (!(abs(v) >= tol1_ && Math::sq(v) >= ov * tol0_)) ++trip;
+          if (!(abs(v) >= tol1_ && Math::_sq(v) >= ov * tol0_)) ++trip;
           ov = abs(v);
         }
 
@@ -367,9 +367,9 @@ namespace GeographicLib {
           // From Lambda12: tan(bet) = tan(sig) * cos(alp)
           ssig1 = sbet1, csig1 = calp1 * cbet1,
           ssig2 = sbet2, csig2 = calp2 * cbet2,
-          k2 = Math::sq(calp0) * _ep2,
+          k2 = Math::_sq(calp0) * _ep2,
           // Multiplier = a^2 * e^2 * cos(alpha0) * sin(alpha0).
-          A4 = Math::sq(_a) * calp0 * salp0 * _e2;
+          A4 = Math::_sq(_a) * calp0 * salp0 * _e2;
         SinCosNorm(ssig1, csig1);
         SinCosNorm(ssig2, csig2);
         real C4a[nC4_];
@@ -455,8 +455,8 @@ namespace GeographicLib {
       A2m1 = A2m1f(eps),
       AB2 = (1 + A2m1) * (SinCosSeries(true, ssig2, csig2, C2a, nC2_) -
                           SinCosSeries(true, ssig1, csig1, C2a, nC2_)),
-      cbet1sq = Math::sq(cbet1),
-      cbet2sq = Math::sq(cbet2),
+      cbet1sq = Math::_sq(cbet1),
+      cbet2sq = Math::_sq(cbet2),
       w1 = sqrt(1 - _e2 * cbet1sq),
       w2 = sqrt(1 - _e2 * cbet2sq),
       // Make sure it's OK to have repeated dummy arguments
@@ -486,15 +486,15 @@ namespace GeographicLib {
     // This solution is adapted from Geocentric::Reverse.
     real k;
     real
-      p = Math::sq(x),
-      q = Math::sq(y),
+      p = Math::_sq(x),
+      q = Math::_sq(y),
       r = (p + q - 1) / 6;
     if ( !(q == 0 && r <= 0) ) {
       real
         // Avoid possible division by zero when r = 0 by multiplying equations
         // for s and t by r^3 and r, resp.
         S = p * q / 4,            // S = r^3 * s
-        r2 = Math::sq(r),
+        r2 = Math::_sq(r),
         r3 = r * r2,
         // The discrimant of the quadratic equation for T3.  This is zero on
         // the evolute curve p^(1/3)+q^(1/3) = 1
@@ -518,13 +518,13 @@ namespace GeographicLib {
         u += 2 * r * cos(ang / 3);
       }
       real
-        v = sqrt(Math::sq(u) + q),    // guaranteed positive
+        v = sqrt(Math::_sq(u) + q),    // guaranteed positive
         // Avoid loss of accuracy when u < 0.
         uv = u < 0 ? q / (v - u) : u + v, // u+v, guaranteed positive
         w = (uv - q) / (2 * v);           // positive?
       // Rearrange expression for k to avoid loss of accuracy due to
       // subtraction.  Division by 0 not possible because uv > 0, w >= 0.
-      k = uv / (sqrt(uv + Math::sq(w)) + w);   // guaranteed positive
+      k = uv / (sqrt(uv + Math::_sq(w)) + w);   // guaranteed positive
     } else {               // q == 0 && r <= 0
       // y = 0 with |x| <= 1.  Handle this case directly.
       // for y small, positive root is k = abs(y)/sqrt(1-x^2)
@@ -571,13 +571,13 @@ namespace GeographicLib {
       lam12 <= Math::pi<real>() / 6;
     real
       omg12 = (!shortline ? lam12 :
-               lam12 / sqrt(1 - _e2 * Math::sq((cbet1 + cbet2) / 2))),
+               lam12 / sqrt(1 - _e2 * Math::_sq((cbet1 + cbet2) / 2))),
       somg12 = sin(omg12), comg12 = cos(omg12);
 
     salp1 = cbet2 * somg12;
     calp1 = comg12 >= 0 ?
-      sbet12 + cbet2 * sbet1 * Math::sq(somg12) / (1 + comg12) :
-      sbet12a - cbet2 * sbet1 * Math::sq(somg12) / (1 - comg12);
+      sbet12 + cbet2 * sbet1 * Math::_sq(somg12) / (1 + comg12) :
+      sbet12a - cbet2 * sbet1 * Math::_sq(somg12) / (1 - comg12);
 
     real
       ssig12 = hypot(salp1, calp1),
@@ -586,12 +586,12 @@ namespace GeographicLib {
     if (shortline && ssig12 < _etol2) {
       // really short lines
       salp2 = cbet1 * somg12;
-      calp2 = sbet12 - cbet1 * sbet2 * Math::sq(somg12) / (1 + comg12);
+      calp2 = sbet12 - cbet1 * sbet2 * Math::_sq(somg12) / (1 + comg12);
       SinCosNorm(salp2, calp2);
       // Set return value
       sig12 = atan2(ssig12, csig12);
     } else if (csig12 >= 0 ||
-               ssig12 >= 3 * abs(_f) * Math::pi<real>() * Math::sq(cbet1)) {
+               ssig12 >= 3 * abs(_f) * Math::pi<real>() * Math::_sq(cbet1)) {
       // Nothing to do, zeroth order spherical approximation is OK
     } else {
       // Scale lam12 and bet2 to x, y coordinate system where antipodal point
@@ -605,7 +605,7 @@ namespace GeographicLib {
         // x = dlong, y = dlat
         {
           real
-            k2 = Math::sq(sbet1) * _ep2,
+            k2 = Math::_sq(sbet1) * _ep2,
             eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
           lamscale = _f * cbet1 * A3f(eps) * Math::pi<real>();
         }
@@ -626,7 +626,7 @@ namespace GeographicLib {
                 dummy, dummy, C1a, C2a);
         x = -1 + m12a/(_f1 * cbet1 * cbet2 * m0 * Math::pi<real>());
         betscale = x < -real(0.01) ? sbet12a / x :
-          -_f * Math::sq(cbet1) * Math::pi<real>();
+          -_f * Math::_sq(cbet1) * Math::pi<real>();
         lamscale = betscale / cbet1;
         y = (lam12 - Math::pi<real>()) / lamscale;
       }
@@ -634,10 +634,10 @@ namespace GeographicLib {
       if (y > -tol1_ && x > -1 - xthresh_) {
         // strip near cut
         if (_f >= 0) {
-          salp1 = min(real(1), -real(x)); calp1 = - sqrt(1 - Math::sq(salp1));
+          salp1 = min(real(1), -real(x)); calp1 = - sqrt(1 - Math::_sq(salp1));
         } else {
           calp1 = max(real(x > -tol1_ ? 0 : -1), real(x));
-          salp1 = sqrt(1 - Math::sq(calp1));
+          salp1 = sqrt(1 - Math::_sq(calp1));
         }
       } else {
         // Estimate alp1, by solving the astroid problem.
@@ -680,7 +680,7 @@ namespace GeographicLib {
         somg12 = sin(omg12a), comg12 = -cos(omg12a);
         // Update spherical estimate of alp1 using omg12 instead of lam12
         salp1 = cbet2 * somg12;
-        calp1 = sbet12a - cbet2 * sbet1 * Math::sq(somg12) / (1 - comg12);
+        calp1 = sbet12a - cbet2 * sbet1 * Math::_sq(somg12) / (1 - comg12);
       }
     }
     SinCosNorm(salp1, calp1);
@@ -729,7 +729,7 @@ namespace GeographicLib {
     // and subst for calp0 and rearrange to give (choose positive sqrt
     // to give alp2 in [0, pi/2]).
     calp2 = cbet2 != cbet1 || abs(sbet2) != -sbet1 ?
-      sqrt(Math::sq(calp1 * cbet1) +
+      sqrt(Math::_sq(calp1 * cbet1) +
            (cbet1 < -sbet1 ?
             (cbet2 - cbet1) * (cbet1 + cbet2) :
             (sbet1 - sbet2) * (sbet1 + sbet2))) / cbet2 :
@@ -749,7 +749,7 @@ namespace GeographicLib {
     omg12 = atan2(max(comg1 * somg2 - somg1 * comg2, real(0)),
                   comg1 * comg2 + somg1 * somg2);
     real B312, h0;
-    real k2 = Math::sq(calp0) * _ep2;
+    real k2 = Math::_sq(calp0) * _ep2;
     eps = k2 / (2 * (1 + sqrt(1 + k2)) + k2);
     C3f(eps, C3a);
     B312 = (SinCosSeries(true, ssig2, csig2, C3a, nC3_-1) -
@@ -760,7 +760,7 @@ namespace GeographicLib {
 
     if (diffp) {
       if (calp2 == 0)
-        dlam12 = - 2 * sqrt(1 - _e2 * Math::sq(cbet1)) / sbet1;
+        dlam12 = - 2 * sqrt(1 - _e2 * Math::_sq(cbet1)) / sbet1;
       else {
         real dummy;
         Lengths(eps, sig12, ssig1, csig1, ssig2, csig2,
@@ -823,7 +823,7 @@ namespace GeographicLib {
   template<typename real>
   real Geodesic30<real>::A1m1f(real eps) {
     real
-      eps2 = Math::sq(eps),
+      eps2 = Math::_sq(eps),
       t;
     switch (nA1_/2) {
     case 15:
@@ -846,7 +846,7 @@ namespace GeographicLib {
   template<typename real>
   void Geodesic30<real>::C1f(real eps, real c[]) {
     real
-      eps2 = Math::sq(eps),
+      eps2 = Math::_sq(eps),
       d = eps;
     switch (nC1_) {
     case 30:
@@ -1024,7 +1024,7 @@ namespace GeographicLib {
   template<typename real>
   void Geodesic30<real>::C1pf(real eps, real c[]) {
     real
-      eps2 = Math::sq(eps),
+      eps2 = Math::_sq(eps),
       d = eps;
     switch (nC1p_) {
     case 30:
@@ -1359,7 +1359,7 @@ namespace GeographicLib {
   template<typename real>
   real Geodesic30<real>::A2m1f(real eps) {
     real
-      eps2 = Math::sq(eps),
+      eps2 = Math::_sq(eps),
       t;
     switch (nA2_/2) {
     case 15:
@@ -1384,7 +1384,7 @@ namespace GeographicLib {
   template<typename real>
   void Geodesic30<real>::C2f(real eps, real c[]) {
     real
-      eps2 = Math::sq(eps),
+      eps2 = Math::_sq(eps),
       d = eps;
     switch (nC2_) {
     case 30:
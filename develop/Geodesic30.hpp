@@ -7,8 +7,8 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
-#if !defined(GEOGRAPHICLIB_GEODESICEXACT_HPP)
-#define GEOGRAPHICLIB_GEODESICEXACT_HPP 1
+#if !defined(GEOGRAPHICLIB_GEODESIC30_HPP)
+#define GEOGRAPHICLIB_GEODESIC30_HPP 1
 
 #include <GeographicLib/Constants.hpp>
 
@@ -835,4 +835,4 @@ namespace GeographicLib {
 
 } // namespace GeographicLib
 
-#endif  // GEOGRAPHICLIB_GEODESICEXACT_HPP
+#endif  // GEOGRAPHICLIB_GEODESIC30_HPP
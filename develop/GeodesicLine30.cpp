@@ -83,7 +83,7 @@ namespace GeographicLib {
     Geodesic30<real>::SinCosNorm(_ssig1, _csig1); // sig1 in (-pi, pi]
     Geodesic30<real>::SinCosNorm(_somg1, _comg1);
 
-    _k2 = Math::sq(_calp0) * g._ep2;
+    _k2 = Math::_sq(_calp0) * g._ep2;
     real eps = _k2 / (2 * (1 + sqrt(1 + _k2)) + _k2);
 
     if (_caps & CAP_C1) {
@@ -117,7 +117,7 @@ namespace GeographicLib {
     if (_caps & CAP_C4) {
       g.C4f(_k2, _C4a);
       // Multiplier = a^2 * e^2 * cos(alpha0) * sin(alpha0)
-      _A4 = Math::sq(_a) * _calp0 * _salp0 * g._e2;
+      _A4 = Math::_sq(_a) * _calp0 * _salp0 * g._e2;
       _B41 = Geodesic30<real>::SinCosSeries(false, _ssig1, _csig1, _C4a, nC4_);
     }
   }
@@ -206,8 +206,8 @@ namespace GeographicLib {
 
     if (outmask & (REDUCEDLENGTH | GEODESICSCALE)) {
       real
-        ssig1sq = Math::sq(_ssig1),
-        ssig2sq = Math::sq( ssig2),
+        ssig1sq = Math::_sq(_ssig1),
+        ssig2sq = Math::_sq( ssig2),
         w1 = sqrt(1 + _k2 * ssig1sq),
         w2 = sqrt(1 + _k2 * ssig2sq),
         B22 = Geodesic30<real>::SinCosSeries(true, ssig2, csig2, _C2a, nC2_),
@@ -254,7 +254,7 @@ namespace GeographicLib {
         salp12 = _calp0 * _salp0 *
           (csig12 <= 0 ? _csig1 * (1 - csig12) + ssig12 * _ssig1 :
            ssig12 * (_csig1 * ssig12 / (1 + csig12) + _ssig1));
-        calp12 = Math::sq(_salp0) + Math::sq(_calp0) * _csig1 * csig2;
+        calp12 = Math::_sq(_salp0) + Math::_sq(_calp0) * _csig1 * csig2;
       }
       S12 = _c2 * atan2(salp12, calp12) + _A4 * (B42 - _B41);
     }
@@ -0,0 +1,107 @@
+// Convert a global gtx file of geoid heights (e.g., one written by
+// GeoidToGTX) into the pgm format read by Geoid.  The result can be
+// converted into the tiled format with GeoidToTiles.
+//
+// For the format of gtx files, see
+// https://vdatum.noaa.gov/docs/gtx_info.html#dev_gtx_binary
+//
+// The gtx grid must cover the globe with equal spacing 1/n degrees in
+// latitude and longitude: nlat = 180 * n + 1 rows from the south pole to the
+// north pole and nlong = 360 * n (or 360 * n + 1) columns starting at a west
+// edge which is a multiple of the spacing.  The rows are reordered from north
+// to south and the columns rotated to start at longitude 0 as required by
+// Geoid.  The heights are quantized as offset + scale * pixel where pixel is
+// an unsigned 16-bit integer; the default offset and scale, -108 m and 3 mm,
+// are those of the standard geoid files.
+
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cmath>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main(int argc, const char* const argv[]) {
+  // 1 = input gtx file (e.g., egm2008-1.gtx)
+  // 2 = output pgm file (e.g., egm2008-1.pgm)
+  // 3, 4 = offset and scale (optional, default -108 0.003)
+  if (argc != 3 && argc != 5) {
+    cerr << "Usage: " << argv[0]
+         << " input.gtx output.pgm [offset scale]\n";
+    return 1;
+  }
+  try {
+    string infile(argv[1]), outfile(argv[2]);
+    double
+      offset = argc == 5 ? Utility::val<double>(string(argv[3])) : -108,
+      scale = argc == 5 ? Utility::val<double>(string(argv[4])) : 0.003;
+    if (!(scale > 0))
+      throw GeographicErr("Scale must be positive");
+    ifstream in(infile.c_str(), ios::binary);
+    if (!in.good())
+      throw GeographicErr("File not readable " + infile);
+    double transform[4];
+    int sizes[2];
+    Utility::readarray<double, double, true>(in, transform, 4);
+    Utility::readarray<int, int, true>(in, sizes, 2);
+    double
+      latorg = transform[0], lonorg = transform[1],
+      dlat = transform[2], dlon = transform[3];
+    int nlat = sizes[0], nlon = sizes[1];
+    // The number of intervals per degree
+    int ndeg = int(floor(1 / dlat + 0.5));
+    if (!(ndeg > 0 &&
+          // Allow for the grid spacing having been written as a float
+          fabs(dlat * ndeg - 1) < 1e-6 && fabs(dlon * ndeg - 1) < 1e-6 &&
+          fabs(latorg + 90) < 1e-6 * dlat &&
+          nlat == 180 * ndeg + 1 &&
+          (nlon == 360 * ndeg || nlon == 360 * ndeg + 1)))
+      throw GeographicErr("Grid in " + infile + " is not global");
+    // The column of the gtx file with longitude 0
+    double x0 = -lonorg / dlon;
+    int
+      width = 360 * ndeg, height = nlat,
+      ix0 = int(floor(x0 + 0.5));
+    if (!(fabs(x0 - ix0) < 1e-6))
+      throw GeographicErr("Longitude 0 is not on the grid in " + infile);
+    ix0 = ((ix0 % width) + width) % width;
+    vector<float> row(nlon);
+    vector<unsigned short> data(size_t(width) * size_t(height));
+    for (int ilat = 0; ilat < nlat; ++ilat) {
+      Utility::readarray<float, float, true>(in, row);
+      // Geoid stores the rows from north to south
+      unsigned short* p = &data[size_t(nlat - 1 - ilat) * size_t(width)];
+      for (int ix = 0; ix < width; ++ix) {
+        double
+          h = row[(ix + ix0) % width],
+          v = floor((h - offset) / scale + 0.5);
+        if (!(v >= 0 && v <= 0xffff))
+          throw GeographicErr("Height " + Utility::str(h) +
+                              " out of range in " + infile);
+        p[ix] = (unsigned short)(v);
+      }
+    }
+    ofstream out(outfile.c_str(), ios::binary);
+    if (!out.good())
+      throw GeographicErr("File not writable " + outfile);
+    out << "P5\n"
+        << "# Geoid file in PGM format for the GeographicLib::Geoid class\n"
+        << "# Description Converted from " << infile << "\n"
+        << "# Offset " << Utility::str(offset) << "\n"
+        << "# Scale " << Utility::str(scale) << "\n"
+        << "# Origin 90N 0E\n"
+        << "# AREA_OR_POINT Point\n"
+        << width << " " << height << "\n" << 0xffffu << "\n";
+    Utility::writearray<unsigned short, unsigned short, true>(out, data);
+    if (!out.good())
+      throw GeographicErr("Error writing " + outfile);
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,115 @@
+// Convert a geoid pgm file into the tiled format recognized by Geoid.
+//
+// The tiled file consists of
+//   "TP5\n"
+//   the header lines of the pgm file following the "P5" line, with an
+//     additional comment "# TileSize N" before the raster size line
+//   ntiles + 1 tile offsets (big-endian 8-byte unsigned) relative to the end
+//     of the offset table; tile k occupies [offset[k], offset[k+1])
+//   the compressed tiles
+// The tiles are N x N blocks of pixels (smaller on the east and south edges)
+// in row-major order.  Within a tile, each pixel is stored as the
+// difference from the prediction left + above - aboveleft (with missing
+// neighbors treated as 0 and the prediction reducing to left or above on the
+// first row or column), zigzag encoded, as a sequence of 7-bit groups,
+// least significant first, with the high bit set on all but the last.
+
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <GeographicLib/Utility.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main(int argc, const char* const argv[]) {
+  // 1 = input pgm file (e.g., egm2008-1.pgm)
+  // 2 = output tiled file (e.g., egm2008-1.tpgm)
+  // 3 = tile size (optional, default 64)
+  if (argc != 3 && argc != 4) {
+    cerr << "Usage: " << argv[0] << " input.pgm output.tpgm [tilesize]\n";
+    return 1;
+  }
+  try {
+    string infile(argv[1]), outfile(argv[2]);
+    int tilesize = argc == 4 ? Utility::val<int>(string(argv[3])) : 64;
+    if (tilesize <= 0)
+      throw GeographicErr("Tile size must be positive");
+    ifstream in(infile.c_str(), ios::binary);
+    if (!in.good())
+      throw GeographicErr("File not readable " + infile);
+    string s;
+    if (!(getline(in, s) && s == "P5"))
+      throw GeographicErr("File not in PGM format " + infile);
+    ostringstream header;
+    header << "TP5\n";
+    int width = 0, height = 0;
+    while (getline(in, s)) {
+      if (s.empty() || s[0] == '#') {
+        header << s << "\n";
+        continue;
+      }
+      istringstream is(s);
+      if (!(is >> width >> height))
+        throw GeographicErr("Error reading raster size " + infile);
+      // The comments must precede the raster size
+      header << "# TileSize " << tilesize << "\n" << s << "\n";
+      break;
+    }
+    unsigned maxval;
+    if (!(in >> maxval) || !(maxval == 0xffffu || maxval == 0xffffffffu))
+      throw GeographicErr("Error reading maxval " + infile);
+    in.get();                   // The whitespace after maxval
+    header << maxval << "\n";
+    const bool wide = maxval != 0xffffu;
+    // Read the whole raster
+    vector<unsigned> data(size_t(width) * size_t(height));
+    if (wide)
+      Utility::readarray<unsigned, unsigned, true>(in, data);
+    else
+      Utility::readarray<unsigned short, unsigned, true>(in, data);
+    int
+      ntx = (width + tilesize - 1) / tilesize,
+      nty = (height + tilesize - 1) / tilesize;
+    vector<unsigned long long> offset(1, 0);
+    offset.reserve(size_t(ntx) * size_t(nty) + 1);
+    vector<unsigned char> tiles;
+    for (int ty = 0; ty < nty; ++ty)
+      for (int tx = 0; tx < ntx; ++tx) {
+        int
+          x0 = tx * tilesize, y0 = ty * tilesize,
+          nx = min(tilesize, width - x0), ny = min(tilesize, height - y0);
+        for (int iy = 0; iy < ny; ++iy)
+          for (int ix = 0; ix < nx; ++ix) {
+            const unsigned* p = &data[size_t(y0 + iy) * width + (x0 + ix)];
+            long long
+              l = ix ? p[-1] : 0,
+              a = iy ? p[-width] : 0,
+              pred = ix && iy ? l + a - p[-width - 1] : l + a,
+              r = (long long)(*p) - pred;
+            unsigned long long u =
+              ((unsigned long long)(r) << 1) ^ (unsigned long long)(r >> 63);
+            for (; u >= 0x80U; u >>= 7)
+              tiles.push_back((unsigned char)(u | 0x80U));
+            tiles.push_back((unsigned char)(u));
+          }
+        offset.push_back(tiles.size());
+      }
+    ofstream out(outfile.c_str(), ios::binary);
+    if (!out.good())
+      throw GeographicErr("File not writable " + outfile);
+    out << header.str();
+    Utility::writearray<unsigned long long, unsigned long long, true>
+      (out, offset);
+    out.write(reinterpret_cast<const char*>(tiles.data()), tiles.size());
+    if (!out.good())
+      throw GeographicErr("Error writing " + outfile);
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
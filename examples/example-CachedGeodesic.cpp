@@ -0,0 +1,36 @@
+// Example of using the GeographicLib::CachedGeodesic class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/CachedGeodesic.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // A cache using 1 MiB
+    CachedGeodesic cached(geod, 1 << 20);
+    // Distances between JFK, LHR, and NRT, each computed several times
+    double
+      lat[] = {40.6, 51.6, 35.8},
+      lon[] = {-73.8, -0.5, 140.4};
+    for (int k = 0; k < 5; ++k)
+      for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+          double s12;
+          cached.Inverse(lat[i], lon[i], lat[j], lon[j], s12);
+          if (k == 0) cout << i << " " << j << " " << s12 << "\n";
+        }
+    cout << cached.Hits() << " hits, " << cached.Misses() << " misses, "
+         << cached.Bypasses() << " bypasses\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
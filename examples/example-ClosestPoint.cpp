@@ -0,0 +1,37 @@
+// Example of using the GeographicLib::ClosestPoint class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // A route from London to Paris to Madrid to Lisbon
+    double
+      lat[] = {51.5, 48.9, 40.4, 38.7},
+      lon[] = {-0.1,  2.4, -3.7, -9.1};
+    ClosestPoint route(geod, 4, lat, lon);
+    // Find the closest points on the route to Brussels, Bordeaux, and Rabat
+    double
+      tlat[] = {50.8, 44.8, 34.0},
+      tlon[] = { 4.4, -0.6, -6.8};
+    int seg[3];
+    double along[3], cross[3];
+    route.Find(3, tlat, tlon, seg, along, cross);
+    cout << fixed << setprecision(0);
+    for (int i = 0; i < 3; ++i)
+      cout << seg[i] << " " << along[i] << " " << cross[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::DoubleDouble class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <sstream>
+#include <GeographicLib/DoubleDouble.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    typedef DoubleDouble dd;
+    // 1/3 with twice the precision of a double
+    dd x = dd(1) / 3;
+    cout << setprecision(32) << x << "\n"
+         << x.hi() << " + " << x.lo() << "\n";
+    // pi = 4 * atan(1) and a check with sincos
+    dd pi = 4 * atan(dd(1)), s, c;
+    dd::sincos(pi / 6, s, c);
+    cout << pi << "\n" << s << " " << c * c << "\n";
+    // Reading a number
+    istringstream str("2.718281828459045235360287471352662");
+    dd e;
+    str >> e;
+    cout << e - exp(dd(1)) << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
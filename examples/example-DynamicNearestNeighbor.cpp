@@ -0,0 +1,73 @@
+// Example of using the GeographicLib::DynamicNearestNeighbor class.  Track a
+// set of ships which enter and leave the set and, for a few ports, print the
+// distance to the nearest ship.
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <random>
+#include <GeographicLib/DynamicNearestNeighbor.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+// A structure to hold a geographic coordinate.
+struct pos {
+  double _lat, _lon;
+  pos(double lat = 0, double lon = 0) : _lat(lat), _lon(lon) {}
+};
+
+// A class to compute the distance between 2 positions.
+class DistanceCalculator {
+private:
+  Geodesic _geod;
+public:
+  explicit DistanceCalculator(const Geodesic& geod) : _geod(geod) {}
+  double operator() (const pos& a, const pos& b) const {
+    double d;
+    _geod.Inverse(a._lat, a._lon, b._lat, b._lon, d);
+    if ( !(d >= 0) )
+      // Catch illegal positions which result in d = NaN
+      throw GeographicErr("distance doesn't satisfy d >= 0");
+    return d;
+  }
+  // Cheap bounds on the distance used to avoid most calls to the function
+  // above.
+  void operator() (const pos& a, const pos& b,
+                   double& dmin, double& dmax) const {
+    _geod.DistanceBounds(a._lat, a._lon, b._lat, b._lon, dmin, dmax);
+  }
+};
+
+int main() {
+  try {
+    DistanceCalculator distance(Geodesic::WGS84());
+    mt19937 rand(42);
+    uniform_real_distribution<double>
+      rlat(-60, 60), rlon(-180, 180);
+    // Start with 10000 ships
+    vector<pos> ships(10000);
+    for (auto& s : ships) s = pos(rlat(rand), rlon(rand));
+    DynamicNearestNeighbor<double, pos, DistanceCalculator>
+      fleet(ships, distance);
+    // 5000 ships leave and 5000 others arrive
+    for (int i = 0; i < 5000; ++i) {
+      fleet.Remove(2 * i);
+      fleet.Insert(pos(rlat(rand), rlon(rand)));
+    }
+    // Find the ships nearest to Rotterdam, Singapore, and Santos
+    vector<pos> ports{pos(51.9, 4.1), pos(1.3, 103.8), pos(-24.0, -46.3)};
+    vector<int> ind;
+    for (const auto& p : ports) {
+      double d = fleet.Search(distance, p, ind);
+      const pos& s = fleet.Point(ind[0]);
+      cout << ind[0] << " " << s._lat << " " << s._lon << " "
+           << int(d/1000) << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,57 @@
+// Example of using the GeographicLib::EqualAreaGrid class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include <GeographicLib/EqualAreaGrid.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    const EqualAreaGrid& grid = EqualAreaGrid::WGS84();
+    // Alternatively: EqualAreaGrid grid(Constants::WGS84_a(),
+    //                                   Constants::WGS84_f());
+    {
+      // Sample forward calculation
+      double lat = 40.6, lon = -73.8; // JFK Airport
+      int level = 12;
+      unsigned long long id = grid.Forward(lat, lon, level);
+      cout << id << " " << grid.Level(id) << " "
+           << grid.CellArea(level) << "\n";
+      // The corners of the cell
+      vector<double> lats, lons;
+      grid.Boundary(id, lats, lons);
+      cout << fixed << setprecision(6);
+      for (size_t i = 0; i < lats.size(); ++i)
+        cout << lats[i] << " " << lons[i] << "\n";
+    }
+    {
+      // Bin some points into cells and count the points in each cell at two
+      // levels
+      vector<double> lat = {40.6, 40.61, 40.62, 51.6, 51.61, -33.9};
+      vector<double> lon = {-73.8, -73.79, -73.78, -0.4, -0.41, 151.2};
+      vector<unsigned long long> id(lat.size());
+      grid.Forward(lat.size(), lat.data(), lon.data(), 12, id.data());
+      sort(id.begin(), id.end());
+      for (int shift = 0; shift <= 10; shift += 10) {
+        for (size_t i = 0; i < id.size();) {
+          size_t j = i;
+          while (j < id.size() && id[j] >> shift == id[i] >> shift) ++j;
+          double clat, clon;
+          grid.Reverse(id[i] >> shift, clat, clon);
+          cout << (id[i] >> shift) << " " << clat << " " << clon << " "
+               << j - i << "\n";
+          i = j;
+        }
+      }
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
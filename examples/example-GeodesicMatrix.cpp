@@ -0,0 +1,41 @@
+// Example of using the GeographicLib::GeodesicMatrix class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicMatrix.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // Distances and azimuths from 3 airports to 2 others
+    double
+      lat1[] = {40.640, 51.471, 35.553}, // JFK, LHR, HND
+      lon1[] = {-73.779, -0.461, 139.781},
+      lat2[] = {1.359, -33.946},         // SIN, SYD
+      lon2[] = {103.989, 151.177};
+    GeodesicMatrix mat(geod, 3, lat1, lon1, 2, lat2, lon2);
+    size_t n = mat.Rows() * mat.Columns();
+    vector<double> s12(n), azi1(n), azi2(n);
+    mat.GenMatrix(Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                  s12.data(), azi1.data(), azi2.data());
+    cout << fixed << setprecision(3);
+    for (size_t i = 0; i < mat.Rows(); ++i)
+      for (size_t j = 0; j < mat.Columns(); ++j) {
+        size_t k = i * mat.Columns() + j;
+        cout << i << " " << j << " "
+             << s12[k] << " " << azi1[k] << " " << azi2[k] << "\n";
+      }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::GeodesicOrigin class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicOrigin.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // Distances and azimuths from JFK to several other airports
+    GeodesicOrigin jfk = geod.Origin(40.640, -73.779);
+    double
+      lat2[] = {51.471, 35.553, 1.359, -33.946}, // LHR, HND, SIN, SYD
+      lon2[] = {-0.461, 139.781, 103.989, 151.177};
+    cout << fixed << setprecision(3);
+    for (int i = 0; i < 4; ++i) {
+      double s12, azi1, azi2;
+      jfk.Inverse(lat2[i], lon2[i], s12, azi1, azi2);
+      cout << i << " " << s12 << " " << azi1 << " " << azi2 << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,34 @@
+// Example of using the GeographicLib::GeodesicStart class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/GeodesicStart.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // Build the table (this takes about 0.1 s)
+    GeodesicStart start(geod);
+    {
+      // Sample inverse calculation, JFK to LHR
+      double
+        lat1 = 40.6, lon1 = -73.8, // JFK Airport
+        lat2 = 51.6, lon2 = -0.5;  // LHR Airport
+      double s12, azi1, azi2;
+      start.Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2);
+      cout << fixed << setprecision(3)
+           << s12 << " " << azi1 << " " << azi2 << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
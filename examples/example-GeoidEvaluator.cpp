@@ -0,0 +1,35 @@
+// Example of using the GeographicLib::GeoidEvaluator class
+// This requires that the egm96-5 geoid model be installed; see
+// https://geographiclib.sourceforge.io/C++/doc/geoid.html#geoidinst
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GeoidEvaluator.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // A thread safe Geoid which maps the data file into memory.  This can
+    // be shared by all the threads.
+    const Geoid egm96("egm96-5", "", true, true, true);
+    // Each thread should use its own GeoidEvaluator.
+    GeoidEvaluator eval(egm96);
+    // Convert heights above egm96 to heights above the ellipsoid along a
+    // short track; the points lie in the same grid cell, so the
+    // interpolation coefficients are only computed once.
+    double lat = 42, lon = -75, height_above_geoid = 20;
+    for (int i = 0; i < 4; ++i) {
+      double height_above_ellipsoid =
+        eval.ConvertHeight(lat + i * 0.01, lon, height_above_geoid,
+                           Geoid::GEOIDTOELLIPSOID);
+      cout << height_above_ellipsoid << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
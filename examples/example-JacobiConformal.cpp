@@ -0,0 +1,32 @@
+// Example of using the GeographicLib::JacobiConformal class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/JacobiConformal.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // The triaxial ellipsoid for the Martian moon Phobos (km)
+    JacobiConformal jc(13.0, 11.4, 9.1);
+    cout << fixed << setprecision(6)
+         << "Quadrants: " << jc.x() << " " << jc.y() << "\n";
+    // Project a graticule of ellipsoidal longitudes omg and latitudes bet
+    // (degrees) with a single call
+    const int n = 7;
+    double omg[n], bet[n], x[n], y[n];
+    for (int i = 0; i < n; ++i) {
+      omg[i] = 30 * i - 90; bet[i] = 15 * i - 45;
+    }
+    jc.Forward(n, omg, bet, x, y);
+    for (int i = 0; i < n; ++i)
+      cout << omg[i] << " " << bet[i] << " " << x[i] << " " << y[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
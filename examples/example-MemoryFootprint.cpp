@@ -0,0 +1,32 @@
+// Example of using the GeographicLib::MemoryFootprint class
+// This requires that the egm96-5 geoid model and the egm96 gravity model be
+// installed; see
+// https://geographiclib.sourceforge.io/C++/doc/geoid.html#geoidinst
+// https://geographiclib.sourceforge.io/C++/doc/gravity.html#gravityinst
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MemoryFootprint.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geoid egm96("egm96-5");
+    GravityModel grav("egm96");
+    // Cache the geoid heights for Europe
+    egm96.CacheArea(35, -10, 70, 40);
+    MemoryFootprint g = egm96.MemoryUsage(), m = grav.MemoryUsage(),
+      p = MemoryFootprint::Process();
+    cout << "geoid   " << g.heap << " " << g.mapped << " " << g.cache << "\n"
+         << "gravity " << m.heap << " " << m.mapped << " " << m.cache << "\n"
+         << "total   " << p.Total() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
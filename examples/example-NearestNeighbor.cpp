@@ -48,6 +48,12 @@ public:
       throw GeographicErr("distance doesn't satisfy d >= 0");
     return d;
   }
+  // Cheap bounds on the distance used to avoid most calls to the function
+  // above.
+  void operator() (const pos& a, const pos& b,
+                   double& dmin, double& dmax) const {
+    _geod.DistanceBounds(a._lat, a._lon, b._lat, b._lon, dmin, dmax);
+  }
 };
 
 int main() {
@@ -114,7 +120,7 @@ int main() {
     while (is >> sa >> sb) {
       ++count;
       DMS::DecodeLatLon(sa, sb, lat, lon);
-      d = pointset.Search(locs, distance, pos(lat, lon), k);
+      d = pointset.Search(locs, distance, distance, pos(lat, lon), k);
       if (k.size() != 1)
           throw GeographicErr("unexpected number of results");
       cout << k[0] << " " << d << "\n";
@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::PointInPolygon class
+
+#include <iostream>
+#include <exception>
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // A fence with vertices at London, New York, Rio de Janeiro, and
+    // Johannesburg
+    double
+      lat[] = { 52,  41, -23, -26},
+      lon[] = {  0, -74, -43,  28};
+    PointInPolygon fence(geod, 4, lat, lon);
+    // Test Dakar, Lagos, Reykjavik, and Cape Town
+    double
+      tlat[] = {14.7, 6.5, 64.1, -33.9},
+      tlon[] = {-17.5, 3.4, -21.9, 18.4};
+    for (int i = 0; i < 4; ++i)
+      cout << i << " " << fence.Contains(tlat[i], tlon[i]) << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,38 @@
+// Example of using the GeographicLib::PolygonJoin class
+
+#include <iostream>
+#include <exception>
+#include <cstddef>
+#include <GeographicLib/PolygonJoin.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    // Two polygons: a fence with vertices at London, New York, Rio de
+    // Janeiro, and Johannesburg and a triangle with vertices at Tokyo,
+    // Sydney, and Honolulu (which straddles the antimeridian)
+    double
+      lat[] = { 52,  41, -23, -26,  35.7, -33.9,  21.3},
+      lon[] = {  0, -74, -43,  28, 139.7, 151.2, -157.9};
+    size_t start[] = {0, 4, 7};
+    PolygonJoin join(geod, 2, start, lat, lon);
+    // Find the polygons containing Dakar, Reykjavik, Guam, and Lima
+    double
+      tlat[] = {14.7, 64.1, 13.4, -12.0},
+      tlon[] = {-17.5, -21.9, 144.8, -77.0};
+    int poly[4];
+    join.Find(4, tlat, tlon, poly);
+    for (int i = 0; i < 4; ++i)
+      cout << i << " " << poly[i] << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,42 @@
+// Example of using the GeographicLib::PolylineSimplifier class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <cmath>
+#include <GeographicLib/PolylineSimplifier.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    PolylineSimplifier simp(geod);
+    // A track of 1001 points heading east along 40N with a 500 m wiggle
+    // every 0.1 degrees
+    const int n = 1001;
+    vector<double> lat(n), lon(n);
+    for (int i = 0; i < n; ++i) {
+      lon[i] = 0.01 * i;
+      lat[i] = 40 + 0.0045 * sin(Math::pi() * i / 5);
+    }
+    vector<size_t> keep;
+    // Keep the wiggles, which exceed 100 m
+    simp.DouglasPeucker(n, lat.data(), lon.data(), 100, keep);
+    cout << keep.size() << "\n";
+    // Remove them by allowing 1 km
+    simp.DouglasPeucker(n, lat.data(), lon.data(), 1000, keep);
+    cout << keep.size() << "\n";
+    // Remove the vertices with triangle area less than 1 km^2
+    simp.Visvalingam(n, lat.data(), lon.data(), 1e6, keep);
+    cout << keep.size() << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,52 @@
+// Example of using the GeographicLib::ProjectionPipeline class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/ProjectionPipeline.hpp>
+#include <GeographicLib/LambertConformalConic.hpp>
+#include <GeographicLib/LocalCartesian.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    typedef ProjectionPipeline::System System;
+    // Convert from UTM zone 18 north to a Lambert conformal conic projection
+    // with standard parallels at 40d58' and 39d56' (the US Pennsylvania
+    // south state plane system), central meridian 77d45'W
+    LambertConformalConic
+      lcc(Constants::WGS84_a(), Constants::WGS84_f(),
+          40 + 58/60.0, 39 + 56/60.0, 1);
+    ProjectionPipeline
+      utm2lcc(System::UTMUPS(18, true),
+              System::LambertConformalConic(lcc, -(77 + 45/60.0)));
+    {
+      double
+        x[] = {585320.0, 600000.0, 410570.0},
+        y[] = {4511660.0, 4400000.0, 4520830.0};
+      // Convert in place
+      utm2lcc.Transform(3, x, y, nullptr, x, y);
+      cout << fixed << setprecision(2);
+      for (int i = 0; i < 3; ++i)
+        cout << x[i] << " " << y[i] << "\n";
+    }
+    {
+      // Geocentric to local cartesian coordinates centered on JFK; this
+      // uses a rotation and translation in cartesian coordinates.
+      LocalCartesian jfk(40.640, -73.779, 0);
+      ProjectionPipeline
+        geo2loc(System::Geocentric(Geocentric::WGS84()),
+                System::LocalCartesian(jfk));
+      double X = 1301e3, Y = -4643e3, Z = 4134e3, x, y, z;
+      geo2loc.Transform(X, Y, Z, x, y, z);
+      cout << x << " " << y << " " << z << "\n";
+    }
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,33 @@
+// Example of using the GeographicLib::StridedArray class
+
+#include <iostream>
+#include <exception>
+#include <vector>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/StridedArray.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    // A point cloud with geocentric coordinates and an intensity per point
+    struct point { double x, y, z; unsigned short intensity; };
+    vector<point> pts = {
+      {  302e3, 5636e3, 2980e3, 17 },
+      { 4201e3,  168e3, 4780e3, 42 },
+    };
+    const size_t st = sizeof(point);
+    StridedArray<double>
+      x(&pts[0].x, st), y(&pts[0].y, st), z(&pts[0].z, st);
+    // Convert the coordinates to latitude, longitude, and height in place
+    const Geocentric& earth = Geocentric::WGS84();
+    earth.Reverse(pts.size(), x, y, z, x, y, z);
+    for (const point& p : pts)
+      cout << p.x << " " << p.y << " " << p.z << " " << p.intensity << "\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
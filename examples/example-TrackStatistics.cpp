@@ -0,0 +1,37 @@
+// Example of using the GeographicLib::TrackStatistics class
+
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <GeographicLib/TrackStatistics.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Constants.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+int main() {
+  try {
+    Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+    // Alternatively: const Geodesic& geod = Geodesic::WGS84();
+    TrackStatistics track(geod);
+    // A flight from JFK to LHR reported in two chunks; times in seconds
+    double
+      lat1[] = {40.6, 45.0, 50.0}, lon1[] = {-73.8, -65.0, -50.0},
+      time1[] = {0, 3000, 7000},
+      lat2[] = {53.0, 51.5}, lon2[] = {-20.0, -0.5},
+      time2[] = {15000, 21000};
+    double speed[3];
+    track.Add(3, lat1, lon1, time1, nullptr, nullptr, speed);
+    track.Add(2, lat2, lon2, time2, nullptr, nullptr, speed);
+    cout << fixed << setprecision(1)
+         << track.Length() / 1000 << " km "
+         << track.Duration() / 3600 << " h "
+         << track.MeanSpeed() * 3.6 << " km/h "
+         << track.MaxSpeed() * 3.6 << " km/h\n";
+  }
+  catch (const exception& e) {
+    cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -4,7 +4,7 @@
 #include <iomanip>
 #include <exception>
 #include <GeographicLib/Utility.hpp>
-#include "JacobiConformal.hpp"
+#include <GeographicLib/JacobiConformal.hpp>
 
 using namespace std;
 using namespace GeographicLib;
@@ -24,7 +24,7 @@ int main() {
     //    a/(a-b) = 91449 +/- 60
     // which gives: a = 6378171.36, b = 6378101.61, c = 6356751.84
     Math::real a = 6378137+35, b = 6378137-35, c = 6356752;
-    experimental::JacobiConformal jc(a, b, c, a-b, b-c);
+    JacobiConformal jc(a, b, c, a-b, b-c);
     cout  << fixed << setprecision(1)
           << "Ellipsoid parameters: a = "
           << a << ", b = " << b << ", c = " << c << "\n"
@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_ACCUMULATOR_HPP)
 #define GEOGRAPHICLIB_ACCUMULATOR_HPP 1
 
+#include <cfloat>
 #include <GeographicLib/Constants.hpp>
 
 namespace GeographicLib {
@@ -129,6 +130,59 @@ namespace GeographicLib {
      * @param[in] y set \e sum += \e y.
      **********************************************************************/
     Accumulator& operator+=(T y) { Add(y); return *this; }
+    /**
+     * Add an array of numbers to the accumulator.
+     *
+     * @param[in] n the number of elements of \e x.
+     * @param[in] x the array of numbers to be added to the sum.
+     * @return a reference to the accumulator.
+     *
+     * The numbers are summed in several independent lanes, each of which
+     * carries an error-free sum and a compensation term (the algorithm
+     * Sum2 of T. Ogita, S. M. Rump, and S. Oishi,
+     * <a href="https://doi.org/10.1137/030601818">Accurate sum and dot
+     * product</a>, SIAM J. Sci. Comp. 26(6), 1955--1988 (2005)); the lanes
+     * are merged into the accumulator at the end.  The inner loop is free of
+     * branches and function calls so that it can be vectorized.  The result
+     * is as accurate as if the sum were computed with twice the precision of
+     * \e T, but it is not necessarily identical to the result of adding the
+     * elements one at a time.  If \e T does not have IEEE arithmetic with
+     * the results of each operation rounded to \e T (e.g., with x87
+     * extended precision) or if the library was built to give reproducible
+     * results (Math::reproducible), the elements are added one at a time.
+     **********************************************************************/
+    Accumulator& Add(size_t n, const T x[]) {
+      const int lanes = 4;
+      size_t i = 0;
+      if (std::numeric_limits<T>::is_iec559 && FLT_EVAL_METHOD == 0 &&
+          !Math::reproducible) {
+        T s[lanes], c[lanes];
+        for (int l = 0; l < lanes; ++l) s[l] = c[l] = 0;
+        for (; i + lanes <= n; i += lanes)
+          for (int l = 0; l < lanes; ++l) {
+            // Math::sum without the volatile declarations and the test for
+            // zero
+            T y = x[i + l], u = s[l] + y, up = u - y, vpp = u - up;
+            c[l] += (s[l] - up) + (y - vpp);
+            s[l] = u;
+          }
+        for (int l = 0; l < lanes; ++l) { Add(c[l]); Add(s[l]); }
+      }
+      for (; i < n; ++i)
+        Add(x[i]);
+      return *this;
+    }
+    /**
+     * Add another accumulator to the accumulator.
+     *
+     * @param[in] a the accumulator whose sum will be added.
+     *
+     * This provides a way to combine partial sums, e.g., those accumulated
+     * by separate threads.  The less significant part of \e a is added
+     * first.
+     **********************************************************************/
+    Accumulator& operator+=(const Accumulator& a)
+    { Add(a._t); Add(a._s); return *this; }
     /**
      * Subtract a number from the accumulator.
      *
@@ -18,6 +18,7 @@
 #if !defined(GEOGRAPHICLIB_AUXANGLE_HPP)
 #define GEOGRAPHICLIB_AUXANGLE_HPP 1
 
+#include <vector>
 #include <GeographicLib/Math.hpp>
 
 namespace GeographicLib {
@@ -200,6 +201,102 @@ namespace GeographicLib {
     static AuxAngle NaN();
   };
 
+  /**
+   * \brief An array of AuxAngle objects.
+   *
+   * This holds \e n angles with the \e y and \e x components stored in
+   * separate contiguous arrays.  This is the form taken by the array version
+   * of AuxLatitude::Convert which converts all the angles with loops which
+   * the compiler can vectorize.  As with AuxAngle, the components need not
+   * be normalized; this allows a chain of conversions to be carried out
+   * without normalizing the intermediate results.  AuxAngleArray::normalize
+   * can be called at the end of the chain, if need be; this isn't necessary
+   * if the result is only needed in degrees.
+   *
+   * The default copy constructor and assignment operators work with this
+   * class.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT AuxAngleArray {
+  private:
+    typedef Math::real real;
+    std::vector<real> _y, _x;
+  public:
+    /**
+     * Constructor for an array of zero angles.
+     *
+     * @param[in] n the number of angles (default 0).
+     **********************************************************************/
+    explicit AuxAngleArray(size_t n = 0) : _y(n, 0), _x(n, 1) {}
+    /**
+     * Constructor from the components.
+     *
+     * @param[in] n the number of angles.
+     * @param[in] y an array of \e n \e y components.
+     * @param[in] x an array of \e n \e x components.
+     **********************************************************************/
+    AuxAngleArray(size_t n, const real y[], const real x[])
+      : _y(y, y + n), _x(x, x + n) {}
+    /**
+     * @return the number of angles.
+     **********************************************************************/
+    size_t size() const { return _y.size(); }
+    /**
+     * Change the number of angles.
+     *
+     * @param[in] n the new number of angles; any added angles are zero.
+     **********************************************************************/
+    void resize(size_t n) { _y.resize(n, 0); _x.resize(n, 1); }
+    /**
+     * @return a pointer to the array of \e y components.
+     **********************************************************************/
+    const Math::real* y() const { return _y.data(); }
+    /**
+     * @return a pointer to the array of \e x components.
+     **********************************************************************/
+    const Math::real* x() const { return _x.data(); }
+    /**
+     * @return a pointer to the array of \e y components.  This allows the
+     *   components to be altered.
+     **********************************************************************/
+    Math::real* y() { return _y.data(); }
+    /**
+     * @return a pointer to the array of \e x components.  This allows the
+     *   components to be altered.
+     **********************************************************************/
+    Math::real* x() { return _x.data(); }
+    /**
+     * @param[in] i the index of an angle.
+     * @return angle \e i as an AuxAngle.
+     **********************************************************************/
+    AuxAngle operator[](size_t i) const { return AuxAngle(_y[i], _x[i]); }
+    /**
+     * Set an angle.
+     *
+     * @param[in] i the index of an angle.
+     * @param[in] p the new value of angle \e i.
+     **********************************************************************/
+    void set(size_t i, const AuxAngle& p) { _y[i] = p.y(); _x[i] = p.x(); }
+    /**
+     * Convert the angles to degrees.
+     *
+     * @param[out] d an array of \e n angles in degrees.
+     **********************************************************************/
+    void degrees(real d[]) const;
+    /**
+     * Normalize the angles in place; this is equivalent to calling
+     * AuxAngle::normalize on each angle.
+     **********************************************************************/
+    void normalize();
+    /**
+     * Construct and return an AuxAngleArray specified as angles in degrees.
+     *
+     * @param[in] n the number of angles.
+     * @param[in] d an array of \e n angles in degrees.
+     * @return the corresponding AuxAngleArray.
+     **********************************************************************/
+    static AuxAngleArray degrees(size_t n, const real d[]);
+  };
+
   inline AuxAngle AuxAngle::degrees(real d) {
     real y, x;
     Math::sincosd(d, y, x);
@@ -237,6 +334,18 @@ namespace GeographicLib {
     using std::asinh; return asinh( tan() ) / Math::degree();
   }
 
+  inline void AuxAngleArray::degrees(real d[]) const {
+    for (size_t i = 0; i < size(); ++i)
+      d[i] = Math::atan2d(_y[i], _x[i]);
+  }
+
+  inline AuxAngleArray AuxAngleArray::degrees(size_t n, const real d[]) {
+    AuxAngleArray a(n);
+    for (size_t i = 0; i < n; ++i)
+      Math::sincosd(d[i], a._y[i], a._x[i]);
+    return a;
+  }
+
 } // namespace GeographicLib
 
 #endif  // GEOGRAPHICLIB_AUXANGLE_HPP
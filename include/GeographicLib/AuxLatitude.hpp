@@ -174,9 +174,10 @@ namespace GeographicLib {
      * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
      *   positive.
      *
-     * \note the constructor does not precompute the coefficients for the
-     * Fourier series for the series conversions.  These are computed and saved
-     * when first needed.
+     * \note the constructor precomputes the coefficients for the Fourier
+     * series for all the series conversions.  The object is not modified
+     * thereafter, so a single AuxLatitude (e.g., AuxLatitude::WGS84()) can be
+     * shared between threads without locking.
      **********************************************************************/
     AuxLatitude(real a, real f);
     /**
@@ -207,11 +208,10 @@ namespace GeographicLib {
      *   series [default false].
      * @return the output auxiliary latitude \e eta as an AuxAngle.
      *
-     * With \e exact = false, the Fourier coefficients for a specific \e auxin
-     * and \e auxout are computed and saved on the first call; the saved
-     * coefficients are used on subsequent calls.  The series method is
-     * accurate for abs(\e f) &le; 1/150; for other \e f, the exact method
-     * should be used.
+     * With \e exact = false, the Fourier series with the coefficients
+     * computed by the constructor is used.  The series method is accurate
+     * for abs(\e f) &le; 1/150; for other \e f, the exact method should be
+     * used.
      **********************************************************************/
     AuxAngle Convert(int auxin, int auxout, const AuxAngle& zeta,
                      bool exact = false) const;
@@ -227,14 +227,65 @@ namespace GeographicLib {
      *   series [default false].
      * @return the output auxiliary latitude \e eta in degrees.
      *
-     * With \e exact = false, the Fourier coefficients for a specific \e auxin
-     * and \e auxout are computed and saved on the first call; the saved
-     * coefficients are used on subsequent calls.  The series method is
-     * accurate for abs(\e f) &le; 1/150; for other \e f, the exact method
-     * should be used.
+     * With \e exact = false, the Fourier series with the coefficients
+     * computed by the constructor is used.  The series method is accurate
+     * for abs(\e f) &le; 1/150; for other \e f, the exact method should be
+     * used.
      **********************************************************************/
     Math::real Convert(int auxin, int auxout, real zeta, bool exact = false)
       const;
+    /**
+     * Convert an array of auxiliary latitudes specified in degrees.
+     *
+     * @param[in] auxin an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e zeta.
+     * @param[in] auxout an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e eta.
+     * @param[in] n the number of latitudes.
+     * @param[in] zeta the array of input auxiliary latitudes in degrees.
+     * @param[out] eta the array of output auxiliary latitudes in degrees.
+     * @param[in] exact if true use the exact equations instead of the Taylor
+     *   series [default false].
+     *
+     * This is equivalent to setting <i>eta</i>[<i>i</i>] = Convert(\e auxin,
+     * \e auxout, <i>zeta</i>[<i>i</i>], \e exact) for \e i in [0, \e n);
+     * \e eta may be the same array as \e zeta.  With \e exact = false, the
+     * result is computed directly as &zeta; + &Delta;&zeta;(&zeta;), where
+     * &Delta;&zeta; is the Fourier series; this avoids the conversions to and
+     * from AuxAngle and the Clenshaw summation is carried out for a block of
+     * latitudes at a time in loops which the compiler can vectorize.  The
+     * results agree with the scalar version to within roundoff.  With \e
+     * exact = true, the scalar version is called for each latitude.
+     **********************************************************************/
+    void Convert(int auxin, int auxout, size_t n,
+                 const real zeta[], real eta[], bool exact = false) const;
+    /**
+     * Convert an array of auxiliary latitudes specified as an AuxAngleArray.
+     *
+     * @param[in] auxin an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e zeta.
+     * @param[in] auxout an AuxLatitude::aux indicating the type of
+     *   auxiliary latitude \e eta.
+     * @param[in] zeta the input auxiliary latitudes.
+     * @param[out] eta the output auxiliary latitudes.
+     * @param[in] exact if true use the exact equations instead of the Taylor
+     *   series [default false].
+     *
+     * This is equivalent to setting \e eta[<i>i</i>] = Convert(\e auxin,
+     * \e auxout, \e zeta[<i>i</i>], \e exact), except that the results
+     * aren't normalized; \e eta may be the same object as \e zeta.  With \e
+     * exact = false, sin(2&zeta;) and cos(2&zeta;) are found from the
+     * unnormalized components, the Clenshaw summation is carried out for a
+     * block of latitudes at a time, and the components are rotated by the
+     * result; so \e eta has the same magnitude as \e zeta.  With \e exact =
+     * true, the conversions between &phi;, &beta;, and &theta; just scale the
+     * \e y components.  Thus a chain of conversions, e.g., &phi; &rarr;
+     * &beta; &rarr; &mu;, can be carried out without normalizing the
+     * intermediate results.  The results agree with the scalar version to
+     * within roundoff.
+     **********************************************************************/
+    void Convert(int auxin, int auxout, const AuxAngleArray& zeta,
+                 AuxAngleArray& eta, bool exact = false) const;
     /**
      * Convert geographic latitude to an auxiliary latitude \e eta.
      *
@@ -374,7 +425,7 @@ namespace GeographicLib {
     // Ellipsoid parameters
     real _a, _b, _f, _fm1, _e2, _e2m1, _e12, _e12p1, _n, _e, _e1, _n2, _q;
     // To hold computed Fourier coefficients
-    mutable real _c[Lmax * AUXNUMBER * AUXNUMBER];
+    real _c[Lmax * AUXNUMBER * AUXNUMBER];
     // 1d index into AUXNUMBER x AUXNUMBER data
     static int ind(int auxout, int auxin) {
       return (auxout >= 0 && auxout < AUXNUMBER &&
@@ -390,7 +441,9 @@ namespace GeographicLib {
       return isinf(tphi) ? copysign(real(1), tphi) : tphi / sc(tphi);
     }
     // Populate [_c[Lmax * k], _c[Lmax * (k + 1)])
-    void fillcoeff(int auxin, int auxout, int k) const;
+    void fillcoeff(int auxin, int auxout, int k);
+    // Populate all of _c
+    void fillcoeff();
     // the function atanh(e * sphi)/e; works for e^2 = 0 and e^2 < 0
     real atanhee(real tphi) const;
     /// \endcond
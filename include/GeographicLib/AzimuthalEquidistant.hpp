@@ -116,6 +116,57 @@ namespace GeographicLib {
       Reverse(lat0, lon0, x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] azi array of azimuths of the geodesics at the points
+     *   (degrees); this may be null.
+     * @param[out] rk array of reciprocals of the azimuthal scales at the
+     *   points; this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to AzimuthalEquidistant::Forward.  The inverse
+     * geodesic problems are solved with a GeodesicOrigin for the center
+     * point, so that the quantities depending on the center are computed
+     * once.
+     **********************************************************************/
+    void Forward(real lat0, real lon0, size_t n,
+                 const real lat[], const real lon[],
+                 real x[], real y[],
+                 real azi[] = nullptr, real rk[] = nullptr) const;
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] lat0 latitude of center point of projection (degrees).
+     * @param[in] lon0 longitude of center point of projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] azi array of azimuths of the geodesics at the points
+     *   (degrees); this may be null.
+     * @param[out] rk array of reciprocals of the azimuthal scales at the
+     *   points; this may be null.
+     *
+     * Each array holds \e n elements.  This is equivalent to \e n calls to
+     * AzimuthalEquidistant::Reverse (each point requires the solution of
+     * a direct geodesic problem with a different azimuth at the center); it
+     * is provided for symmetry with AzimuthalEquidistant::Forward.
+     **********************************************************************/
+    void Reverse(real lat0, real lon0, size_t n,
+                 const real x[], const real y[],
+                 real lat[], real lon[],
+                 real azi[] = nullptr, real rk[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
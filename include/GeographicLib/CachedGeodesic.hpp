@@ -0,0 +1,265 @@
+/**
+ * \file CachedGeodesic.hpp
+ * \brief Header for GeographicLib::CachedGeodesic class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CACHEDGEODESIC_HPP)
+#define GEOGRAPHICLIB_CACHEDGEODESIC_HPP 1
+
+#include <list>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/MemoryFootprint.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Inverse geodesic calculations with a cache of the results
+   *
+   * This wraps a Geodesic object and remembers the solutions to the inverse
+   * problems it has been asked to solve, so that a repeated request for the
+   * same pair of points (with the same \e outmask) returns the previous
+   * result instead of solving the problem again.  This helps applications,
+   * such as routing engines, which compute the distances between the same
+   * pairs of points many times.  A lookup in the cache costs a small
+   * fraction of the time to solve the inverse problem.
+   *
+   * The results are held in a least-recently-used (LRU) cache whose total
+   * size is bounded by a byte budget given to the constructor.  In order
+   * that several threads can use the cache at once, it is split into shards
+   * each with its own lock; a pair of points belongs to a shard determined
+   * by a hash of its coordinates.  A problem is only added to the cache the
+   * second time that it is seen; problems which are only asked once then
+   * don't evict useful results.  In order to recognize the second request,
+   * each shard records the hashes of the recent problems which haven't been
+   * added in a fixed-size table, so that this admission filter may
+   * occasionally admit a problem seen once or fail to admit one seen twice.
+   *
+   * Optionally, the coordinates can be rounded to multiples of a quantum
+   * before they are used (as the key for the cache and for solving the
+   * problem).  With a positive quantum, the endpoints which are nearly the
+   * same share a cache entry; the results are those for the rounded
+   * endpoints.  With the default quantum of zero, the coordinates are used
+   * unchanged and the results are identical to those returned by
+   * Geodesic::GenInverse.  Problems with coordinates which are not finite
+   * bypass the cache.
+   *
+   * Example of use:
+   * \include example-CachedGeodesic.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT CachedGeodesic {
+  private:
+    typedef Math::real real;
+    class key {
+    public:
+      real lat1, lon1, lat2, lon2;
+      unsigned outmask;
+      bool operator==(const key& k) const;
+      size_t hash() const;
+    };
+    class keyhash {
+    public:
+      size_t operator()(const key& k) const { return k.hash(); }
+    };
+    class entry {
+    public:
+      key k;
+      // a12, s12, azi1, azi2, m12, M12, M21, S12
+      real v[8];
+    };
+    typedef std::list<entry> lrulist;
+    class shard {
+    public:
+      std::mutex lock;
+      // Most recently used entry first
+      lrulist lru;
+      std::unordered_map<key, lrulist::iterator, keyhash> index;
+      // The hashes of recent problems which haven't been admitted
+      std::vector<size_t> seen;
+      unsigned long long hits, misses, bypasses;
+      shard() : hits(0), misses(0), bypasses(0) {}
+    };
+    Geodesic _geod;
+    size_t _capacity;
+    real _quantum;
+    // shard isn't copyable (because of its mutex), so hold the shards by
+    // pointer.
+    std::vector<std::unique_ptr<shard>> _shards;
+    real quantize(real x) const;
+  public:
+
+    /**
+     * Constructor for CachedGeodesic.
+     *
+     * @param[in] geod the Geodesic object used to solve the problems.
+     * @param[in] budget the approximate maximum number of bytes used by the
+     *   cache (default 16 MiB).
+     * @param[in] nshards the number of shards of the cache (default 16).
+     * @param[in] quantum the coordinates are rounded to multiples of this
+     *   value (degrees); 0 (the default) means they aren't rounded.
+     * @exception GeographicErr if \e nshards isn't positive or \e quantum
+     *   is negative or not finite.
+     *
+     * The number of entries in each shard is \e budget divided by \e nshards
+     * times the number of bytes used by an entry (about 200 bytes with
+     * doubles on a 64-bit system), with at least one entry per shard.
+     **********************************************************************/
+    explicit CachedGeodesic(const Geodesic& geod,
+                            size_t budget = size_t(16) << 20,
+                            int nshards = 16, real quantum = 0);
+
+    /** \name Inverse geodesic problem.
+     **********************************************************************/
+    ///@{
+    /**
+     * The general inverse geodesic calculation.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * The arguments are the same as for Geodesic::GenInverse.  The cache is
+     * keyed on the (possibly rounded) coordinates and on the output
+     * components of \e outmask.  This may be called by several threads at
+     * once.
+     **********************************************************************/
+    Math::real GenInverse(real lat1, real lon1, real lat2, real lon2,
+                          unsigned outmask,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12) const;
+
+    /**
+     * Solve the inverse geodesic problem for the distance.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     **********************************************************************/
+    Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
+                       real& s12) const {
+      real t;
+      return GenInverse(lat1, lon1, lat2, lon2, Geodesic::DISTANCE,
+                        s12, t, t, t, t, t, t);
+    }
+
+    /**
+     * Solve the inverse geodesic problem for the distance and azimuths.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     **********************************************************************/
+    Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
+                       real& s12, real& azi1, real& azi2) const {
+      real t;
+      return GenInverse(lat1, lon1, lat2, lon2,
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                        s12, azi1, azi2, t, t, t, t);
+    }
+    ///@}
+
+    /** \name Managing the cache
+     **********************************************************************/
+    ///@{
+    /**
+     * Remove all the entries from the cache and reset the statistics.
+     **********************************************************************/
+    void Clear();
+
+    /**
+     * @return the number of problems whose results were taken from the
+     *   cache.
+     **********************************************************************/
+    unsigned long long Hits() const;
+
+    /**
+     * @return the number of problems which were solved and added to the
+     *   cache.
+     **********************************************************************/
+    unsigned long long Misses() const;
+
+    /**
+     * @return the number of problems which were solved without being added
+     *   to the cache (because they were being seen for the first time or
+     *   their coordinates weren't finite).
+     **********************************************************************/
+    unsigned long long Bypasses() const;
+
+    /**
+     * @return the number of entries in the cache.
+     **********************************************************************/
+    size_t Size() const;
+
+    /**
+     * @return the maximum number of entries in the cache.
+     **********************************************************************/
+    size_t Capacity() const { return _capacity * _shards.size(); }
+
+    /**
+     * @return the memory used by the object.
+     *
+     * All the memory is counted as \e cache: the entries (as estimated for
+     * the \e budget argument of the constructor), the buckets of the hash
+     * tables, and the tables of the problems seen once.
+     **********************************************************************/
+    MemoryFootprint MemoryUsage() const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the Geodesic object used to solve the problems.
+     **********************************************************************/
+    const Geodesic& GeodesicObject() const { return _geod; }
+
+    /**
+     * @return the quantum used for rounding the coordinates (degrees).
+     **********************************************************************/
+    Math::real Quantum() const { return _quantum; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_CACHEDGEODESIC_HPP
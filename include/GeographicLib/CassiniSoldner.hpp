@@ -73,6 +73,14 @@ namespace GeographicLib {
     GeodesicLine _meridian;
     real _sbet0, _cbet0;
     static const unsigned maxit_ = 10;
+    // The number of points handled together by the batch functions
+    static const size_t block_ = 256;
+    // The part of Forward for a single point which doesn't involve the
+    // meridian; return the arc length along the meridian from the center to
+    // the foot of the perpendicular (degrees).  The scale is only computed if
+    // scalep.
+    real Perpendicular(real lat, real lon, real& x, real& azi,
+                       bool scalep, real& rk) const;
 
   public:
 
@@ -164,6 +172,55 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, azi, rk);
     }
 
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] azi array of azimuths of the easting direction at the
+     *   points (degrees); this may be null.
+     * @param[out] rk array of reciprocals of the azimuthal northing scales at
+     *   the points; this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to CassiniSoldner::Forward.  The points are
+     * processed in blocks; for each block the perpendicular geodesics are
+     * found first and then the positions on the central meridian are found
+     * together.  If \e rk is null, the geodesic scales (the most expensive
+     * part of the perpendicular geodesic) are not computed.  The routine does
+     * nothing if the origin has not been set.
+     **********************************************************************/
+    void Forward(size_t n, const real lat[], const real lon[],
+                 real x[], real y[],
+                 real azi[] = nullptr, real rk[] = nullptr) const;
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] azi array of azimuths of the easting direction at the
+     *   points (degrees); this may be null.
+     * @param[out] rk array of reciprocals of the azimuthal northing scales at
+     *   the points; this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to CassiniSoldner::Reverse.  The feet of the
+     * perpendiculars on the central meridian are found for a block of points
+     * with GeodesicLine::GenPositions before the direct geodesic problems are
+     * solved.  If \e rk is null, the geodesic scales are not computed.  The
+     * routine does nothing if the origin has not been set.
+     **********************************************************************/
+    void Reverse(size_t n, const real x[], const real y[],
+                 real lat[], real lon[],
+                 real azi[] = nullptr, real rk[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
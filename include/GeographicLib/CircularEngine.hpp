@@ -184,6 +184,38 @@ namespace GeographicLib {
       Math::sincosd(lon, sinlon, coslon);
       return (*this)(sinlon, coslon, gradx, grady, gradz);
     }
+
+    /**
+     * Evaluate the sum and, optionally, its gradient at uniformly spaced
+     * longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] n the number of longitudes.
+     * @param[out] v array of the values of the sum.
+     * @param[out] gradx (optional) array of the \e x components of the
+     *   gradient.
+     * @param[out] grady (optional) array of the \e y components of the
+     *   gradient.
+     * @param[out] gradz (optional) array of the \e z components of the
+     *   gradient.
+     * @exception std::bad_alloc if the memory for the FFT can't be
+     *   allocated.
+     *
+     * The sum is evaluated at longitudes \e lon0 + \e i \e dlon for \e i
+     * in [0, \e n).  The gradient is computed if \e gradx, \e grady, and \e
+     * gradz are all non-null and the CircularEngine object was created with
+     * this capability.  If \e q 360&deg;/\e dlon is an integer \e P for
+     * some \e q &le; 64 (e.g., \e dlon = 1/4&deg; or 0.7&deg;) and \e n is
+     * large enough, the sum over order is performed with an FFT of length
+     * \e P; this reduces the cost of evaluating the sum at all the points
+     * from <i>O</i>(\e n \e M) to <i>O</i>(\e M + \e P log \e P).  Otherwise
+     * (or at the poles when the gradient is needed) the sum is evaluated for
+     * each point with operator()().  The results agree to within roundoff.
+     **********************************************************************/
+    void Grid(real lon0, real dlon, size_t n, real v[],
+              real gradx[] = nullptr, real grady[] = nullptr,
+              real gradz[] = nullptr) const;
   };
 
 } // namespace GeographicLib
@@ -0,0 +1,260 @@
+/**
+ * \file ClosestPoint.hpp
+ * \brief Header for GeographicLib::ClosestPoint class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_CLOSESTPOINT_HPP)
+#define GEOGRAPHICLIB_CLOSESTPOINT_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/NearestNeighbor.hpp>
+#include <vector>
+#include <cmath>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief The closest point on a geodesic polyline
+   *
+   * Given a polyline whose segments are geodesics, this class finds, for a
+   * query point, the closest point on the polyline and returns the
+   * along-track distance (the distance along the polyline from its first
+   * vertex to the closest point) and the cross-track distance (the geodesic
+   * distance from the closest point to the query point).  A typical
+   * application is map matching GPS fixes to road geometry.  A single
+   * geodesic segment is a polyline with 2 vertices.
+   *
+   * The closest point on a segment is found by Newton's method applied to
+   * the derivative of <i>s</i><sup>2</sup>/2, where \e s is the distance
+   * from the point at distance \e t along the segment to the query point,
+   * using the reduced length and geodesic scale to give the second
+   * derivative (this is the interception problem solved in
+   * develop/ClosestApproach.cpp):
+   * - <i>g</i>(<i>t</i>) = &minus;<i>s</i> cos&gamma;,
+   * - <i>g</i>'(<i>t</i>) = cos<sup>2</sup>&gamma; + (<i>M</i><sub>12</sub>
+   *   <i>s</i> / <i>m</i><sub>12</sub>) sin<sup>2</sup>&gamma;,
+   * .
+   * where &gamma; is the angle between the segment and the geodesic to the
+   * query point.  In the planar limit, <i>g</i> is linear in \e t and a
+   * single step of Newton's method gives the solution; thus only a few
+   * iterations are needed (each costing a Geodesic::GenInverse and a
+   * GeodesicLine::GenPosition).  The solution is restricted to the segment;
+   * if the foot of the perpendicular lies beyond an end of the segment, the
+   * end is returned.  If the segment is long (more than about 1/4 of a
+   * meridian), the distance along the segment may have several minima; the
+   * one found is the one nearest the starting point of the iteration.
+   *
+   * For a polyline with many segments, the segments are split into pieces
+   * of comparable length and the midpoints of the pieces are entered, as
+   * geocentric coordinates, into a NearestNeighbor tree using the chord
+   * distance.  Because the chord is no longer than the geodesic distance,
+   * the chord distance from the query point to a midpoint minus the half
+   * length of its piece is a lower bound on the distance to the piece.
+   * The segment of the nearest midpoint gives an initial estimate of the
+   * distance \e d to the polyline; the pieces whose midpoints are within
+   * \e d + (the maximum half length) are then found with
+   * NearestNeighbor::RangeSearch and the segments of those whose lower
+   * bounds are less than the current \e d are tested in order of the lower
+   * bounds.
+   *
+   * Example of use:
+   * \include example-ClosestPoint.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT ClosestPoint {
+  private:
+    typedef Math::real real;
+    static const int maxit_ = 10;
+    // The maximum number of pieces into which a segment is split
+    static const int maxpieces_ = 1000;
+    // The index is only used to select candidate segments, so it is held in
+    // double precision (NearestNeighbor needs a trivially copyable dist_t).
+    class pos {
+    public:
+      double x, y, z;
+    };
+    class chord {
+    public:
+      double operator()(const pos& a, const pos& b) const {
+        using std::sqrt;
+        double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return sqrt(dx * dx + dy * dy + dz * dz);
+      }
+    };
+    Geodesic _geod;
+    Geocentric _earth;
+    std::vector<GeodesicLine> _segs;
+    // The distance along the polyline to the start of each segment
+    std::vector<real> _start;
+    // For each piece, its midpoint, its half length, the distance of its
+    // midpoint along its segment, and its segment.
+    std::vector<pos> _mid;
+    std::vector<double> _half;
+    std::vector<real> _smid;
+    std::vector<int> _pseg;
+    double _maxhalf;
+    NearestNeighbor<double, pos, chord> _tree;
+    pos Position(real lat, real lon) const;
+    class Workspace;
+    void Find(real lat, real lon, Workspace& work, int& seg, real& along,
+              real& cross, real& latc, real& lonc) const;
+  public:
+
+    /**
+     * Constructor for ClosestPoint.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] n the number of vertices of the polyline.
+     * @param[in] lat an array of \e n latitudes of the vertices (degrees).
+     * @param[in] lon an array of \e n longitudes of the vertices (degrees).
+     * @exception GeographicErr if \e n < 2 or a latitude is not in
+     *   [&minus;90&deg;, 90&deg;].
+     * @exception std::bad_alloc if memory for the polyline and its index
+     *   can't be allocated.
+     *
+     * The polyline has \e n &minus; 1 segments, numbered 0, 1, ..., each
+     * being the shortest geodesic between consecutive vertices.  To close a
+     * polygon, repeat the first vertex at the end.
+     **********************************************************************/
+    ClosestPoint(const Geodesic& geod,
+                 size_t n, const real lat[], const real lon[]);
+
+    /** \name Finding the closest point
+     **********************************************************************/
+    ///@{
+    /**
+     * Find the closest point on the polyline.
+     *
+     * @param[in] lat latitude of the query point (degrees).
+     * @param[in] lon longitude of the query point (degrees).
+     * @param[out] seg the index of the segment containing the closest point.
+     * @param[out] along the along-track distance (meters).
+     * @param[out] cross the cross-track distance (meters).
+     * @param[out] latc latitude of the closest point (degrees).
+     * @param[out] lonc longitude of the closest point (degrees).
+     *
+     * \e along is the distance along the polyline from its first vertex to
+     * the closest point.  |\e cross| is the geodesic distance from the
+     * closest point to the query point; \e cross is positive if the query
+     * point lies to the right of the polyline (looking in the direction of
+     * increasing \e along).  If \e lat or \e lon is NaN, \e seg is set to
+     * &minus;1 and the other results are NaN.
+     *
+     * This may be called by several threads at once.
+     **********************************************************************/
+    void Find(real lat, real lon, int& seg, real& along, real& cross,
+              real& latc, real& lonc) const;
+
+    /**
+     * Find the closest point on the polyline omitting its position.
+     *
+     * @param[in] lat latitude of the query point (degrees).
+     * @param[in] lon longitude of the query point (degrees).
+     * @param[out] seg the index of the segment containing the closest point.
+     * @param[out] along the along-track distance (meters).
+     * @param[out] cross the cross-track distance (meters).
+     **********************************************************************/
+    void Find(real lat, real lon, int& seg, real& along, real& cross) const {
+      real latc, lonc;
+      Find(lat, lon, seg, along, cross, latc, lonc);
+    }
+
+    /**
+     * Find the closest points on the polyline for many query points.
+     *
+     * @param[in] n the number of query points.
+     * @param[in] lat an array of \e n latitudes of the points (degrees).
+     * @param[in] lon an array of \e n longitudes of the points (degrees).
+     * @param[out] seg an array of \e n segment indices.
+     * @param[out] along an array of \e n along-track distances (meters).
+     * @param[out] cross an array of \e n cross-track distances (meters).
+     * @param[out] latc an optional array of \e n latitudes of the closest
+     *   points (degrees).
+     * @param[out] lonc an optional array of \e n longitudes of the closest
+     *   points (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are the same as for \e n calls to Find(real, real, int&,
+     * real&, real&, real&, real&) const; the scratch space for the searches
+     * is allocated once per task.  \e latc and \e lonc may be null.  If \e
+     * nthreads > 1, the points are handed out in chunks to that many tasks
+     * which are run with Executor::Batch.
+     **********************************************************************/
+    void Find(size_t n, const real lat[], const real lon[],
+              int seg[], real along[], real cross[],
+              real latc[] = nullptr, real lonc[] = nullptr,
+              int nthreads = 1) const;
+    ///@}
+
+    /**
+     * Find the closest point on a single geodesic segment.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] line the segment; this must have been constructed with
+     *   Geodesic::InverseLine or had its distance set with
+     *   GeodesicLine::SetDistance and must include the capabilities
+     *   Geodesic::LATITUDE, Geodesic::LONGITUDE, Geodesic::AZIMUTH, and
+     *   Geodesic::DISTANCE_IN.
+     * @param[in] lat latitude of the query point (degrees).
+     * @param[in] lon longitude of the query point (degrees).
+     * @param[in] s0 the starting distance along the segment for the
+     *   iteration (meters).
+     * @param[out] s the distance along the segment to the closest point
+     *   (meters).
+     * @param[out] cross the cross-track distance (meters).
+     * @param[out] latc latitude of the closest point (degrees).
+     * @param[out] lonc longitude of the closest point (degrees).
+     *
+     * This is the kernel used by Find; \e s lies in [0, \e line.Distance()]
+     * and the sign of \e cross is as in Find.  |\e cross| is the distance
+     * from a point on the segment to the query point and so is never less
+     * than the true minimum distance (it may exceed it for long segments
+     * where the iteration converges to a local minimum).
+     **********************************************************************/
+    static void ClosestOnSegment(const Geodesic& geod, const GeodesicLine& line,
+                                 real lat, real lon, real s0,
+                                 real& s, real& cross,
+                                 real& latc, real& lonc);
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of segments of the polyline.
+     **********************************************************************/
+    int NumSegments() const { return int(_segs.size()); }
+
+    /**
+     * @return the length of the polyline (meters).
+     **********************************************************************/
+    Math::real Length() const
+    { return _start.back() + _segs.back().Distance(); }
+
+    /**
+     * @param[in] k the index of a segment.
+     * @return a reference to the GeodesicLine for segment \e k.
+     **********************************************************************/
+    const GeodesicLine& Segment(int k) const { return _segs[k]; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_CLOSESTPOINT_HPP
@@ -101,6 +101,15 @@ namespace GeographicLib {
    * Define constants specifying the WGS84 ellipsoid, the UTM and UPS
    * projections, and various unit conversions.
    *
+   * The global instantiations for the WGS84 ellipsoid, e.g.,
+   * Geodesic::WGS84(), Rhumb::WGS84(), and TransverseMercator::UTM(), are
+   * constructed the first time the function is called (this is thread safe)
+   * which takes a few tens of microseconds.  Subsequent calls merely check a
+   * guard variable and return the reference; to avoid even this small
+   * overhead in a critical loop, save the reference in a local variable
+   * outside the loop.  If the latency of the first call matters, call the
+   * function during the initialization of your program.
+   *
    * Example of use:
    * \include example-Constants.cpp
    **********************************************************************/
@@ -54,10 +54,8 @@ namespace GeographicLib {
      * should be understood as the conventional measure of angle (either in
      * radians or in degrees).
      *
-     * The Fourier coefficients for a specific \e auxin and \e auxout are
-     * computed and saved on the first call; the saved coefficients are used on
-     * subsequent calls.  The series method is accurate for abs(\e f) &le;
-     * 1/150.
+     * The Fourier coefficients are computed by the constructor.  The series
+     * method is accurate for abs(\e f) &le; 1/150.
      **********************************************************************/
     Math::real DConvert(int auxin, int auxout,
                         const AuxAngle& zeta1, const AuxAngle& zeta2) const;
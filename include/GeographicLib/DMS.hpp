@@ -90,15 +90,23 @@ namespace GeographicLib {
 
   private:
     typedef Math::real real;
-    // Replace all occurrences of pat by c.  If c is NULL remove pat.
-    static void replace(std::string& s, const std::string& pat, char c);
+    // Set t to s with the alternative symbols replaced by their ASCII
+    // equivalents; return false if there are none.
+    static bool Normalize(const std::string& s, std::string& t);
     static const char* const hemispheres_;
     static const char* const signs_;
     static const char* const digits_;
     static const char* const dmsindicators_;
     static const char* const components_[3];
     static Math::real NumMatch(const std::string& s);
-    static Math::real InternalDecode(const std::string& dmsa, flag& ind);
+    static Math::real InternalDecode(const std::string& dmsa,
+                                     std::string::size_type beg,
+                                     std::string::size_type end, flag& ind);
+    // Size of the internal buffers for encoding
+    static const int maxlen_ = 96;
+    // Encode into buf with snprintf semantics; return -1 if not possible
+    static int EncodeFast(char buf[], int len, real angle, component trailing,
+                          unsigned prec, flag ind, char dmssep);
     DMS() = delete;             // Disable constructor
 
   public:
@@ -277,6 +285,28 @@ namespace GeographicLib {
                              real& lat, real& lon,
                              bool longfirst = false);
 
+    /**
+     * Convert columns of pairs of strings to latitudes and longitudes.
+     *
+     * @param[in] n the number of pairs.
+     * @param[in] dmsa an array of \e n first strings.
+     * @param[in] dmsb an array of \e n second strings.
+     * @param[out] lat an array of \e n latitudes (degrees).
+     * @param[out] lon an array of \e n longitudes (degrees).
+     * @param[in] longfirst if true assume longitude is given before latitude
+     *   in the absence of hemisphere designators (default false).
+     * @exception GeographicErr if any pair of strings cannot be decoded; the
+     *   message gives the index of the offending pair.
+     *
+     * This is equivalent to calling the previous version of DecodeLatLon for
+     * each pair.  If an exception is thrown, the elements of \e lat and \e
+     * lon preceding the offending pair have been set.
+     **********************************************************************/
+    static void DecodeLatLon(size_t n,
+                             const std::string dmsa[], const std::string dmsb[],
+                             real lat[], real lon[],
+                             bool longfirst = false);
+
     /**
      * Convert a string to an angle in degrees.
      *
@@ -335,6 +365,61 @@ namespace GeographicLib {
     static std::string Encode(real angle, component trailing, unsigned prec,
                               flag ind = NONE, char dmssep = char(0));
 
+    /**
+     * Convert angle (in degrees) into a DMS string (using d, ', and &quot;)
+     * writing the result into a buffer.
+     *
+     * @param[out] buf the buffer for the result.
+     * @param[in] len the size of \e buf.
+     * @param[in] angle input angle (degrees)
+     * @param[in] trailing DMS::component value indicating the trailing units
+     *   of the string (this component is given as a decimal number if
+     *   necessary).
+     * @param[in] prec the number of digits after the decimal point for the
+     *   trailing component.
+     * @param[in] ind DMS::flag value indicating additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character
+     *   (instead of d, ', &quot; delimiters).
+     * @return the length of the formatted string.
+     *
+     * This produces the same string as the previous version of Encode.  The
+     * semantics follow those of snprintf: at most \e len &minus; 1 characters
+     * are written to \e buf followed by a null character and the return value
+     * is the length of the full string (excluding the null); so the result
+     * has been truncated if the return value is not less than \e len.  With
+     * GEOGRAPHICLIB_PRECISION &le; 3, no memory is allocated.
+     **********************************************************************/
+    static int Encode(char buf[], int len, real angle, component trailing,
+                      unsigned prec, flag ind = NONE, char dmssep = char(0));
+
+    /**
+     * Convert an array of angles (in degrees) into DMS strings (using d, ',
+     * and &quot;) writing the results into a buffer.
+     *
+     * @param[in] n the number of angles.
+     * @param[in] angle an array of \e n angles (degrees).
+     * @param[in] trailing DMS::component value indicating the trailing units
+     *   of the strings.
+     * @param[in] prec the number of digits after the decimal point for the
+     *   trailing component.
+     * @param[out] buf the buffer for the results, this should have at least \e
+     *   n &times; \e width elements.
+     * @param[in] width the stride for the results.
+     * @param[in] ind DMS::flag value indicating additional formatting.
+     * @param[in] dmssep if non-null, use as the DMS separator character
+     *   (instead of d, ', &quot; delimiters).
+     * @exception GeographicErr if \e width is too small for a result.
+     *
+     * The <i>i</i>th result, as a null-terminated string, is written to \e buf
+     * + \e i \e width.  \e width must be large enough to hold the longest
+     * result together with its trailing null; for example, with \e ind =
+     * DMS::LONGITUDE, \e trailing = DMS::SECOND, and no \e dmssep, the
+     * strings have a length of 11 + \e prec (plus 1 if \e prec > 0).
+     **********************************************************************/
+    static void Encode(size_t n, const real angle[], component trailing,
+                       unsigned prec, char buf[], int width,
+                       flag ind = NONE, char dmssep = char(0));
+
     /**
      * Convert angle into a DMS string (using d, ', and &quot;) selecting the
      * trailing component based on the precision.
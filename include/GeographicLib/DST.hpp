@@ -12,14 +12,10 @@
 
 #include <GeographicLib/Constants.hpp>
 
+#include <complex>
 #include <functional>
 #include <memory>
 
-/// \cond SKIP
-template<typename scalar_t>
-class kissfft;
-/// \endcond
-
 namespace GeographicLib {
 
   /**
@@ -55,21 +51,29 @@ namespace GeographicLib {
    * Example of use:
    * \include example-DST.cpp
    *
-   * \note The FFTW package https://www.fftw.org/ can also be used.  However
-   * this is a more complicated dependency, its CMake support is broken, and it
-   * doesn't work with mpreals (GEOGRAPHICLIB_PRECISION = 5).
+   * \note The FFTW package https://www.fftw.org/ can also be used by
+   * configuring with cmake -D GEOGRAPHICLIB_FFT=fftw (Intel's MKL can be used
+   * via its FFTW3 interface by setting FFTW_INCLUDE_DIR and FFTW_LIBRARY
+   * appropriately).  However this is a more complicated dependency and it
+   * only works with GEOGRAPHICLIB_PRECISION = 1, 2, or 3, so kissfft is the
+   * default.  The choice of FFT package is internal to the library and the
+   * results agree to roundoff.
    **********************************************************************/
 
   class DST {
   private:
     typedef Math::real real;
     int _NN;
-    typedef kissfft<real> fft_t;
+    // A wrapper for the FFT package selected at build time
+    class fft_t;
     std::shared_ptr<fft_t> _fft;
-    // Implement DST-III (centerp = false) or DST-IV (centerp = true)
-    void fft_transform(real data[], real F[], bool centerp) const;
+    // Implement DST-III (centerp = false) or DST-IV (centerp = true); data
+    // has 4 N elements and ctemp has 2 N + 1 elements.
+    void fft_transform(real data[], real F[], bool centerp,
+                       std::complex<real> ctemp[]) const;
     // Add another N terms to F
-    void fft_transform2(real data[], real F[]) const;
+    void fft_transform2(real data[], real F[],
+                        std::complex<real> ctemp[]) const;
   public:
     /**
      * Constructor specifying the number of points to use.
@@ -124,6 +128,71 @@ namespace GeographicLib {
     void GEOGRAPHICLIB_EXPORT refine(std::function<real(real)> f, real F[])
       const;
 
+    /**
+     * The size of the workspace needed by transform and refine.
+     *
+     * @return the number of elements of type Math::real needed for the
+     *   workspace, 8\e N + 2.
+     **********************************************************************/
+    int WorkSize() const { return 8 * _NN + 2; }
+
+    /**
+     * Determine first \e N terms in the Fourier series using a supplied
+     * workspace.
+     *
+     * @param[in] f the function used for evaluation.
+     * @param[out] F the first \e N coefficients of the Fourier series.
+     * @param[out] work a workspace of at least WorkSize() elements.
+     *
+     * This is the same as the two-argument version of transform except that
+     * no memory is allocated.  (If \e f is a large function object, pass it
+     * with std::cref to avoid an allocation in the construction of the
+     * std::function.)
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT transform(std::function<real(real)> f, real F[],
+                                        real work[]) const;
+
+    /**
+     * Refine the Fourier series by doubling the number of points sampled using
+     * a supplied workspace.
+     *
+     * @param[in] f the function used for evaluation.
+     * @param[inout] F on input the first \e N coefficents of the Fourier
+     *   series; on output the refined transform based on 2\e N points, i.e.,
+     *   the first 2\e N coefficents.
+     * @param[out] work a workspace of at least WorkSize() elements.
+     *
+     * This is the same as the two-argument version of refine except that no
+     * memory is allocated.
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT refine(std::function<real(real)> f, real F[],
+                                     real work[]) const;
+
+    /**
+     * Determine the first \e N terms in the Fourier series for several
+     * functions given their samples.
+     *
+     * @param[in] count the number of functions.
+     * @param[in] samples an array of \e count &times; \e N samples; element
+     *   [\e k \e N + \e j] is the value of the <i>k</i>th function at
+     *   \f$ \sigma = (j + 1) \pi / (2 N) \f$ for integer \f$ j \in [0, N)
+     *   \f$.
+     * @param[out] F an array of \e count &times; \e N elements; on output
+     *   elements [\e k \e N, (\e k + 1) \e N) contain the coefficients for
+     *   the <i>k</i>th function.
+     * @param[out] work a workspace of at least WorkSize() elements; if this is
+     *   omitted, a workspace is allocated once for all the transforms.
+     *
+     * This gives the same results as calling transform \e count times;
+     * however the FFT plan and the workspace are shared between the
+     * transforms and the caller is free to generate the samples in bulk
+     * (e.g., vectorized over the functions).  \e samples and \e F may be the
+     * same array.
+     **********************************************************************/
+    void GEOGRAPHICLIB_EXPORT transform_many(int count, const real samples[],
+                                             real F[], real work[] = nullptr)
+      const;
+
     /**
      * Evaluate the Fourier sum given the sine and cosine of the angle
      *
@@ -0,0 +1,594 @@
+/**
+ * \file DoubleDouble.hpp
+ * \brief Header for GeographicLib::DoubleDouble class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+// Math.hpp includes DoubleDouble.hpp if GEOGRAPHICLIB_PRECISION = 6.  Place
+// this include outside DoubleDouble.hpp's include guard so that the macros in
+// Constants.hpp are defined and Math.hpp is included first.
+#include <GeographicLib/Constants.hpp>
+
+#if !defined(GEOGRAPHICLIB_DOUBLEDOUBLE_HPP)
+#define GEOGRAPHICLIB_DOUBLEDOUBLE_HPP 1
+
+#include <cmath>
+#include <limits>
+#include <iosfwd>
+#include <ios>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Double-double floating point numbers
+   *
+   * A DoubleDouble represents a number as the unevaluated sum of two doubles,
+   * \e hi + \e lo, with |\e lo| &le; ulp(\e hi)/2.  This gives 106 bits of
+   * precision (about 32 decimal digits) with the exponent range of a double.
+   * The arithmetic operations are carried out with the error-free
+   * transformations for the sum and the product of two doubles (as in
+   * Math::sum) and the elementary functions are computed by reducing the
+   * argument and summing a short Taylor series or by one Newton iteration
+   * starting from the double result.
+   *
+   * This is used as the real type for GeographicLib when it is compiled with
+   * GEOGRAPHICLIB_PRECISION = 6.  This offers a fast alternative to quad
+   * precision (GEOGRAPHICLIB_PRECISION = 4) for generating high precision test
+   * data: the basic operations cost 5&ndash;20 times as much as those for
+   * doubles.  Here are the limitations:
+   * - The results of the arithmetic operations are not correctly rounded;
+   *   the relative errors are bounded by a few times 2<sup>&minus;106</sup>
+   *   and numeric_limits<DoubleDouble>::epsilon() is taken to be
+   *   2<sup>&minus;104</sup>.  Most of the elementary functions are
+   *   accurate to about 2<sup>&minus;103</sup>; the relative error in pow(\e
+   *   x, \e y) is proportional to |\e y log \e x|.
+   * - Numbers smaller than about 10<sup>&minus;292</sup> (for which the low
+   *   part underflows) have less precision.
+   * - The trigonometric functions of large arguments (|\e x| &gt;
+   *   2<sup>50</sup>) are inaccurate.
+   * - The double arithmetic needs to be IEEE 754 compliant; in particular,
+   *   intermediate results must not be held in extended precision (as on
+   *   x86 systems using the x87 floating point unit) and the compiler mustn't
+   *   contract multiplications and additions into fused multiply-adds
+   *   (which is the default for g++ with -std=c++11 but not with
+   *   -std=gnu++11).
+   *
+   * The mathematical functions are defined as friends and so are found by
+   * argument-dependent lookup; thus they don't hide the standard functions
+   * for doubles in the GeographicLib namespace.  Conversions from the
+   * arithmetic types are implicit and conversions to them are explicit.
+   * Formatted input and output respect the precision and the fixed,
+   * scientific, showpos, showpoint, and uppercase flags of the stream.
+   *
+   * Example of use:
+   * \include example-DoubleDouble.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT DoubleDouble {
+  private:
+    double _hi, _lo;
+    // The error-free transformations.  Return s = round(a + b) and set e
+    // so that a + b = s + e; quicktwosum requires |a| >= |b|.
+    static double twosum(double a, double b, double& e) {
+      double s = a + b, bb = s - a;
+      e = (a - (s - bb)) + (b - bb);
+      return s;
+    }
+    static double quicktwosum(double a, double b, double& e) {
+      double s = a + b;
+      e = b - (s - a);
+      return s;
+    }
+    // Return p = round(a * b) and set e so that a * b = p + e.
+    static double twoprod(double a, double b, double& e) {
+      double p = a * b;
+#if defined(FP_FAST_FMA)
+      e = std::fma(a, b, -p);
+#else
+      if (std::fabs(p) > 1e300) {
+        // The partial products can overflow, so scale the larger factor by
+        // 2^-28 and scale the error back.
+        const double s = 3.7252902984619140625e-09; // 2^-28
+        if (std::fabs(a) >= std::fabs(b)) a *= s; else b *= s;
+        e = dekker(a, b, p * s) * 268435456.0;  // 2^28
+      } else
+        e = dekker(a, b, p);
+#endif
+      return p;
+    }
+    // The error in p = round(a * b) computed with Dekker's algorithm
+    static double dekker(double a, double b, double p) {
+      double ah, al, bh, bl;
+      split(a, ah, al); split(b, bh, bl);
+      return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    }
+    // Dekker's split of a into 26-bit halves, a = hi + lo.
+    static void split(double a, double& hi, double& lo) {
+      // 2^27 + 1 and the threshold for overflow of splitter * a
+      const double splitter = 134217729.0, thresh = 6.69692879491417e+299;
+      if (std::fabs(a) > thresh) {
+        a *= 3.7252902984619140625e-09; // 2^-28
+        double t = splitter * a;
+        hi = t - (t - a); lo = a - hi;
+        hi *= 268435456.0; lo *= 268435456.0; // 2^28
+      } else {
+        double t = splitter * a;
+        hi = t - (t - a); lo = a - hi;
+      }
+    }
+    // Set from an integer
+    void setint(long long x) {
+      // Split into 32-bit pieces which are exactly representable
+      long long h = x / 4294967296LL, l = x - h * 4294967296LL;
+      _hi = twosum(double(h) * 4294967296.0, double(l), _lo);
+    }
+    void setint(unsigned long long x) {
+      unsigned long long h = x >> 32, l = x & 0xffffffffULL;
+      _hi = twosum(double(h) * 4294967296.0, double(l), _lo);
+    }
+    template<typename T> void setint(T x, std::true_type /*signed*/) {
+      if (sizeof(T) <= 4) { _hi = double(x); _lo = 0; }
+      else setint((long long)x);
+    }
+    template<typename T> void setint(T x, std::false_type /*unsigned*/) {
+      if (sizeof(T) <= 4) { _hi = double(x); _lo = 0; }
+      else setint((unsigned long long)x);
+    }
+    long long toint() const;
+    static DoubleDouble add(const DoubleDouble& a, const DoubleDouble& b) {
+      double s2, s1 = twosum(a._hi, b._hi, s2);
+      if (!std::isfinite(s1)) return s1;
+      double t2, t1 = twosum(a._lo, b._lo, t2);
+      s2 += t1; s1 = quicktwosum(s1, s2, s2);
+      s2 += t2; s1 = quicktwosum(s1, s2, s2);
+      // An exact 0 is -0 only if both a and b are -0.
+      return s1 != 0 ? DoubleDouble(s1, s2) :
+        DoubleDouble(a._hi == 0 && b._hi == 0 ? a._hi + b._hi : 0.0);
+    }
+    static DoubleDouble add(const DoubleDouble& a, double b) {
+      double s2, s1 = twosum(a._hi, b, s2);
+      if (!std::isfinite(s1)) return s1;
+      s2 += a._lo; s1 = quicktwosum(s1, s2, s2);
+      return s1 != 0 ? DoubleDouble(s1, s2) :
+        DoubleDouble(a._hi == 0 && b == 0 ? a._hi + b : 0.0);
+    }
+    static DoubleDouble mul(const DoubleDouble& a, const DoubleDouble& b) {
+      double p2, p1 = twoprod(a._hi, b._hi, p2);
+      if (!(std::isfinite(p1) && p1 != 0)) return p1;
+      p2 += a._hi * b._lo + a._lo * b._hi;
+      p1 = quicktwosum(p1, p2, p2);
+      return DoubleDouble(p1, p2);
+    }
+    static DoubleDouble mul(const DoubleDouble& a, double b) {
+      double p2, p1 = twoprod(a._hi, b, p2);
+      if (!(std::isfinite(p1) && p1 != 0)) return p1;
+      p2 += a._lo * b;
+      p1 = quicktwosum(p1, p2, p2);
+      return DoubleDouble(p1, p2);
+    }
+    static DoubleDouble div(const DoubleDouble& a, const DoubleDouble& b) {
+      double q1 = a._hi / b._hi;
+      if (!(std::isfinite(q1) && q1 != 0)) return q1;
+      DoubleDouble r = add(a, -mul(b, q1));
+      double q2 = r._hi / b._hi;
+      r = add(r, -mul(b, q2));
+      double q3 = r._hi / b._hi;
+      q1 = quicktwosum(q1, q2, q2);
+      return add(DoubleDouble(q1, q2), q3);
+    }
+    static DoubleDouble div(const DoubleDouble& a, double b) {
+      double q1 = a._hi / b;
+      if (!(std::isfinite(q1) && q1 != 0)) return q1;
+      double p2, p1 = twoprod(q1, b, p2), e, s = twosum(a._hi, -p1, e);
+      e -= p2; e += a._lo;
+      double q2 = (s + e) / b;
+      q1 = quicktwosum(q1, q2, q2);
+      return DoubleDouble(q1, q2);
+    }
+  public:
+
+    /** \name Constructors
+     **********************************************************************/
+    ///@{
+    /**
+     * The default constructor leaves the value uninitialized (as for a
+     * double); value initialization sets it to 0.
+     **********************************************************************/
+    DoubleDouble() = default;
+
+    /**
+     * Constructor from a double.
+     *
+     * @param[in] x
+     **********************************************************************/
+    constexpr DoubleDouble(double x) : _hi(x), _lo(0) {}
+
+    /**
+     * Constructor from the high and low parts.
+     *
+     * @param[in] hi
+     * @param[in] lo
+     *
+     * The value is \e hi + \e lo; this \e must satisfy |\e lo| &le;
+     * ulp(\e hi)/2, e.g., \e hi = round(\e hi + \e lo).  Use
+     * DoubleDouble(hi) + lo if this condition might not hold.
+     **********************************************************************/
+    constexpr DoubleDouble(double hi, double lo) : _hi(hi), _lo(lo) {}
+
+    /**
+     * Constructor from a float.
+     *
+     * @param[in] x
+     **********************************************************************/
+    constexpr DoubleDouble(float x) : _hi(x), _lo(0) {}
+
+    /**
+     * Constructor from a long double.
+     *
+     * @param[in] x
+     **********************************************************************/
+    DoubleDouble(long double x)
+      : _hi(double(x)), _lo(double(x - (long double)(_hi))) {}
+
+    /**
+     * Constructor from an integer or an enum.
+     *
+     * @tparam T the type of the argument.
+     * @param[in] x
+     *
+     * This is exact for 64-bit integers.
+     **********************************************************************/
+    template<typename T, typename std::enable_if<std::is_integral<T>::value ||
+                                                 std::is_enum<T>::value,
+                                                 int>::type = 0>
+    DoubleDouble(T x) {
+      typedef typename std::conditional<std::is_enum<T>::value,
+                                        long long, T>::type I;
+      setint(I(x), std::integral_constant<bool, std::is_signed<I>::value>());
+    }
+    ///@}
+
+    /** \name Conversions and the components
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the value rounded to a double.
+     **********************************************************************/
+    explicit operator double() const { return _hi; }
+
+    /**
+     * @return the value rounded to a float.
+     **********************************************************************/
+    explicit operator float() const { return float(_hi); }
+
+    /**
+     * @return the value rounded to a long double.
+     **********************************************************************/
+    explicit operator long double() const
+    { return (long double)(_hi) + (long double)(_lo); }
+
+    /**
+     * @return whether the value is nonzero.
+     **********************************************************************/
+    explicit operator bool() const { return _hi != 0; }
+
+    /**
+     * @tparam T an integer type.
+     * @return the value truncated to an integer.
+     **********************************************************************/
+    template<typename T,
+             typename std::enable_if<std::is_integral<T>::value &&
+                                     !std::is_same<T, bool>::value,
+                                     int>::type = 0>
+    explicit operator T() const { return T(toint()); }
+
+    /**
+     * @return the high part of the number.
+     **********************************************************************/
+    constexpr double hi() const { return _hi; }
+
+    /**
+     * @return the low part of the number.
+     **********************************************************************/
+    constexpr double lo() const { return _lo; }
+    ///@}
+
+    /** \name Arithmetic
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    DoubleDouble operator+() const { return *this; }
+    DoubleDouble operator-() const { return DoubleDouble(-_hi, -_lo); }
+    DoubleDouble& operator+=(const DoubleDouble& b)
+    { return *this = add(*this, b); }
+    DoubleDouble& operator+=(double b) { return *this = add(*this, b); }
+    DoubleDouble& operator-=(const DoubleDouble& b)
+    { return *this = add(*this, -b); }
+    DoubleDouble& operator-=(double b) { return *this = add(*this, -b); }
+    DoubleDouble& operator*=(const DoubleDouble& b)
+    { return *this = mul(*this, b); }
+    DoubleDouble& operator*=(double b) { return *this = mul(*this, b); }
+    DoubleDouble& operator/=(const DoubleDouble& b)
+    { return *this = div(*this, b); }
+    DoubleDouble& operator/=(double b) { return *this = div(*this, b); }
+    DoubleDouble& operator++() { return *this += 1.0; }
+    DoubleDouble& operator--() { return *this -= 1.0; }
+    DoubleDouble operator++(int) { DoubleDouble t = *this; ++*this; return t; }
+    DoubleDouble operator--(int) { DoubleDouble t = *this; --*this; return t; }
+
+    friend DoubleDouble operator+(const DoubleDouble& a, const DoubleDouble& b)
+    { return add(a, b); }
+    friend DoubleDouble operator+(const DoubleDouble& a, double b)
+    { return add(a, b); }
+    friend DoubleDouble operator+(double a, const DoubleDouble& b)
+    { return add(b, a); }
+    friend DoubleDouble operator-(const DoubleDouble& a, const DoubleDouble& b)
+    { return add(a, -b); }
+    friend DoubleDouble operator-(const DoubleDouble& a, double b)
+    { return add(a, -b); }
+    friend DoubleDouble operator-(double a, const DoubleDouble& b)
+    { return add(-b, a); }
+    friend DoubleDouble operator*(const DoubleDouble& a, const DoubleDouble& b)
+    { return mul(a, b); }
+    friend DoubleDouble operator*(const DoubleDouble& a, double b)
+    { return mul(a, b); }
+    friend DoubleDouble operator*(double a, const DoubleDouble& b)
+    { return mul(b, a); }
+    friend DoubleDouble operator/(const DoubleDouble& a, const DoubleDouble& b)
+    { return div(a, b); }
+    friend DoubleDouble operator/(const DoubleDouble& a, double b)
+    { return div(a, b); }
+    friend DoubleDouble operator/(double a, const DoubleDouble& b)
+    { return div(DoubleDouble(a), b); }
+
+    friend bool operator==(const DoubleDouble& a, const DoubleDouble& b)
+    { return a._hi == b._hi && a._lo == b._lo; }
+    friend bool operator!=(const DoubleDouble& a, const DoubleDouble& b)
+    { return !(a == b); }
+    friend bool operator<(const DoubleDouble& a, const DoubleDouble& b)
+    { return a._hi < b._hi || (a._hi == b._hi && a._lo < b._lo); }
+    friend bool operator>(const DoubleDouble& a, const DoubleDouble& b)
+    { return b < a; }
+    friend bool operator<=(const DoubleDouble& a, const DoubleDouble& b)
+    { return a._hi < b._hi || (a._hi == b._hi && a._lo <= b._lo); }
+    friend bool operator>=(const DoubleDouble& a, const DoubleDouble& b)
+    { return b <= a; }
+    /// \endcond
+    ///@}
+
+    /** \name Mathematical functions
+     *
+     * These have the same semantics as the corresponding functions in
+     * &lt;cmath&gt;.  The functions of two arguments also accept a mixture
+     * of DoubleDouble and arithmetic types.
+     **********************************************************************/
+    ///@{
+    /// \cond SKIP
+    friend bool signbit(const DoubleDouble& x) { return std::signbit(x._hi); }
+    friend bool isnan(const DoubleDouble& x) { return std::isnan(x._hi); }
+    friend bool isinf(const DoubleDouble& x) { return std::isinf(x._hi); }
+    friend bool isfinite(const DoubleDouble& x)
+    { return std::isfinite(x._hi); }
+    friend DoubleDouble fabs(const DoubleDouble& x)
+    { return std::signbit(x._hi) ? -x : x; }
+    friend DoubleDouble abs(const DoubleDouble& x) { return fabs(x); }
+    friend DoubleDouble copysign(const DoubleDouble& x, const DoubleDouble& y)
+    { return std::signbit(x._hi) == std::signbit(y._hi) ? x : -x; }
+    friend DoubleDouble fmax(const DoubleDouble& x, const DoubleDouble& y)
+    { return isnan(x) ? y : (isnan(y) ? x : (x < y ? y : x)); }
+    friend DoubleDouble fmin(const DoubleDouble& x, const DoubleDouble& y)
+    { return isnan(x) ? y : (isnan(y) ? x : (y < x ? y : x)); }
+    friend DoubleDouble fma(const DoubleDouble& x, const DoubleDouble& y,
+                            const DoubleDouble& z)
+    { return x * y + z; }
+    friend DoubleDouble ldexp(const DoubleDouble& x, int e) {
+      double h = std::ldexp(x._hi, e);
+      return std::isfinite(h) ? DoubleDouble(h, std::ldexp(x._lo, e)) :
+        DoubleDouble(h);
+    }
+    friend DoubleDouble frexp(const DoubleDouble& x, int* e) {
+      double h = std::frexp(x._hi, e);
+      DoubleDouble y(h, std::ldexp(x._lo, -*e));
+      // Fix up the case where the result is just less than 1/2
+      if (std::fabs(h) == 0.5 && h * y._lo < 0) { y = ldexp(y, 1); --*e; }
+      return y;
+    }
+    friend DoubleDouble floor(const DoubleDouble& x) {
+      double h = std::floor(x._hi);
+      return h != x._hi ? DoubleDouble(h) :
+        (x._lo == 0 ? x : add(DoubleDouble(h), std::floor(x._lo)));
+    }
+    friend DoubleDouble ceil(const DoubleDouble& x) {
+      double h = std::ceil(x._hi);
+      return h != x._hi ? DoubleDouble(h) :
+        (x._lo == 0 ? x : add(DoubleDouble(h), std::ceil(x._lo)));
+    }
+    friend DoubleDouble trunc(const DoubleDouble& x)
+    { return std::signbit(x._hi) ? ceil(x) : floor(x); }
+    friend DoubleDouble round(const DoubleDouble& x) {
+      // Round half away from zero; the fractional part is exact.
+      DoubleDouble a = fabs(x), r = floor(a);
+      if (a - r >= 0.5) r += 1.0;
+      return copysign(r, x);
+    }
+    friend DoubleDouble nearbyint(const DoubleDouble& x) {
+      // Round half to even
+      DoubleDouble r = floor(x), d = x - r;
+      if (d > 0.5 ||
+          (d == 0.5 &&
+           std::fmod(std::fmod(r._hi, 2.0) + std::fmod(r._lo, 2.0), 2.0) != 0))
+        r += 1.0;
+      return r == 0 ? copysign(r, x) : r;
+    }
+    friend DoubleDouble rint(const DoubleDouble& x) { return nearbyint(x); }
+    friend long lround(const DoubleDouble& x) { return long(round(x)); }
+    friend DoubleDouble sqrt(const DoubleDouble& x) {
+      if (!(x._hi > 0 && std::isfinite(x._hi))) return std::sqrt(x._hi);
+      // One Newton iteration starting with the double result (Karp's trick)
+      double r = 1 / std::sqrt(x._hi), s = x._hi * r, e, p = twoprod(s, s, e);
+      return add(DoubleDouble(s), (x - DoubleDouble(p, e))._hi * (r / 2));
+    }
+    friend DoubleDouble hypot(const DoubleDouble& x, const DoubleDouble& y) {
+      if (isinf(x) || isinf(y)) return std::numeric_limits<double>::infinity();
+      DoubleDouble ax = fabs(x), ay = fabs(y);
+      if (isnan(ax) || isnan(ay)) return ax + ay;
+      if (ax < ay) std::swap(ax, ay);
+      if (ax == 0) return ax;
+      // Scale by a power of 2 to avoid overflow and underflow
+      int e; std::frexp(ax._hi, &e);
+      ax = ldexp(ax, -e); ay = ldexp(ay, -e);
+      return ldexp(sqrt(ax * ax + ay * ay), e);
+    }
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cbrt(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble exp(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble expm1(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble exp2(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log1p(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log2(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble log10(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble pow(const DoubleDouble& x,
+                                                 const DoubleDouble& y);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble sin(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cos(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble tan(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble asin(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble acos(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atan(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atan2(const DoubleDouble& y,
+                                                   const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble sinh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble cosh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble tanh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble asinh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble acosh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble atanh(const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble remquo(const DoubleDouble& x,
+                                                    const DoubleDouble& y,
+                                                    int* q);
+    friend DoubleDouble remainder(const DoubleDouble& x, const DoubleDouble& y)
+    { int q; return remquo(x, y, &q); }
+    friend GEOGRAPHICLIB_EXPORT DoubleDouble fmod(const DoubleDouble& x,
+                                                  const DoubleDouble& y);
+    /// \endcond
+    ///@}
+
+    /**
+     * Compute the sine and cosine of a number.
+     *
+     * @param[in] x the argument (radians).
+     * @param[out] sinx sin(\e x).
+     * @param[out] cosx cos(\e x).
+     *
+     * This is faster than computing sin(\e x) and cos(\e x) separately.
+     **********************************************************************/
+    static void sincos(const DoubleDouble& x,
+                       DoubleDouble& sinx, DoubleDouble& cosx);
+
+    /** \name Input and output
+     **********************************************************************/
+    ///@{
+    /**
+     * Convert a string to a DoubleDouble.
+     *
+     * @param[in] s the string.
+     * @param[out] n the number of characters of \e s used.
+     * @return the value.
+     *
+     * \e s consists of an optional sign, some digits optionally containing a
+     * decimal point, and an optional exponent (e or E followed by an integer);
+     * alternatively, it can be "nan", "inf", or "infinity" (in any case)
+     * optionally preceded by a sign.  Leading white space is not skipped.  The
+     * conversion stops at the first character which doesn't fit this syntax;
+     * if no characters are used, \e n = 0 and NaN is returned.
+     **********************************************************************/
+    static DoubleDouble parse(const std::string& s, std::size_t& n);
+
+    /**
+     * Convert a DoubleDouble to a string.
+     *
+     * @param[in] x the value.
+     * @param[in] prec the precision.
+     * @param[in] flags the format flags (a combination of the
+     *   std::ios_base::floatfield, std::ios_base::showpos,
+     *   std::ios_base::showpoint, and std::ios_base::uppercase flags).
+     * @return the string.
+     *
+     * This follows the conventions for printing doubles with an ostream.
+     * Only the first 34 significant digits are computed (and the last couple
+     * of these may be inaccurate); any additional digits are printed as 0.
+     **********************************************************************/
+    static std::string str(const DoubleDouble& x, int prec,
+                           std::ios_base::fmtflags flags);
+
+    /// \cond SKIP
+    friend GEOGRAPHICLIB_EXPORT std::ostream&
+    operator<<(std::ostream& os, const DoubleDouble& x);
+    friend GEOGRAPHICLIB_EXPORT std::istream&
+    operator>>(std::istream& is, DoubleDouble& x);
+    /// \endcond
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+namespace std {
+
+  /**
+   * \brief The properties of DoubleDouble
+   **********************************************************************/
+  template<> class numeric_limits<GeographicLib::DoubleDouble> {
+  private:
+    typedef GeographicLib::DoubleDouble T;
+  public:
+    /// \cond SKIP
+    static constexpr bool is_specialized = true;
+    static constexpr T min() noexcept
+    { return T(2.0041683600089728e-292); } // 2^-969
+    static constexpr T max() noexcept
+    { return T(1.79769313486231570815e+308, 9.97920154767359795037e+291); }
+    static constexpr T lowest() noexcept
+    { return T(-1.79769313486231570815e+308, -9.97920154767359795037e+291); }
+    static constexpr int digits = 106;
+    static constexpr int digits10 = 31;
+    static constexpr int max_digits10 = 33;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr int radix = 2;
+    static constexpr T epsilon() noexcept
+    { return T(4.93038065763132378382e-32); } // 2^-104
+    static constexpr T round_error() noexcept { return T(0.5); }
+    static constexpr int min_exponent = -968;
+    static constexpr int min_exponent10 = -291;
+    static constexpr int max_exponent = 1024;
+    static constexpr int max_exponent10 = 308;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr float_denorm_style has_denorm = denorm_absent;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr T infinity() noexcept
+    { return T(numeric_limits<double>::infinity()); }
+    static constexpr T quiet_NaN() noexcept
+    { return T(numeric_limits<double>::quiet_NaN()); }
+    static constexpr T signaling_NaN() noexcept
+    { return T(numeric_limits<double>::quiet_NaN()); }
+    static constexpr T denorm_min() noexcept { return min(); }
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+    static constexpr float_round_style round_style = round_to_nearest;
+    /// \endcond
+  };
+
+} // namespace std
+
+#endif  // GEOGRAPHICLIB_DOUBLEDOUBLE_HPP
@@ -0,0 +1,597 @@
+/**
+ * \file DynamicNearestNeighbor.hpp
+ * \brief Header for GeographicLib::DynamicNearestNeighbor class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_DYNAMICNEARESTNEIGHBOR_HPP)
+#define GEOGRAPHICLIB_DYNAMICNEARESTNEIGHBOR_HPP 1
+
+#include <algorithm>            // for sort
+#include <vector>
+#include <queue>                // for priority_queue
+#include <utility>              // for move + pair
+#include <limits>
+#include <string>
+#include <chrono>
+#include <future>
+#include <GeographicLib/NearestNeighbor.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Nearest-neighbor calculations with a changing set of points
+   *
+   * This class solves the nearest-neighbor problem, as NearestNeighbor does,
+   * for a set of points to which points may be added and from which points
+   * may be removed.  It uses the "logarithmic method" of
+   * - J. L. Bentley and J. B. Saxe,
+   *   <a href="https://doi.org/10.1016/0196-6774(80)90015-2">
+   *   Decomposable searching problems I: Static-to-dynamic
+   *   transformation</a>, J. Algorithms 1, 301--358 (1980).
+   * .
+   * Newly inserted points are held in a small buffer which is searched
+   * linearly.  When the buffer is full, its points are made into a
+   * NearestNeighbor tree; and trees of similar sizes are merged, so that
+   * there are O(log \e N) trees whose sizes roughly double.  Removed points
+   * are marked as such and are skipped by the searches; a tree is rebuilt
+   * when more than half of its points have been removed.  Merges which
+   * involve at least \e bgsize points are carried out on a background
+   * thread; the existing trees continue to be used for searches until the
+   * merge is complete.  Thus, each point is included in O(log \e N) builds
+   * of trees and the cost of an insertion is O(log<sup>2</sup> \e N)
+   * distance calculations (amortized).  A search is made on the buffer and
+   * on each tree in turn with the \e k closest points found so far limiting
+   * the search of the next tree; the cost is roughly O(log<sup>2</sup> \e
+   * N).
+   *
+   * The template parameters are the same as for NearestNeighbor and the
+   * same conditions on the distance function apply.  Unlike NearestNeighbor,
+   * this class stores the points and the distance function; each point is
+   * identified by the non-negative integer "id" returned by Insert().  The
+   * ids of removed points are reused for later insertions.
+   *
+   * Insert(), Remove(), and Wait() must not be called at the same time as
+   * any other member function.  However, several threads can call Search()
+   * at once.  Because the trees may be built on a background thread, \e
+   * dist must be safe to call from several threads, unless \e bgsize =
+   * std::numeric_limits<int>::max().  A pending background merge is
+   * incorporated in the next call to Insert() or Remove() after it is
+   * complete (or by Wait()); the destructor waits until any pending merge is
+   * complete.
+   *
+   * \note This is also a "header-only" implementation.
+   *
+   * Example of use:
+   * \include example-DynamicNearestNeighbor.cpp
+   **********************************************************************/
+  template<typename dist_t, typename pos_t, class distfun_t>
+  class DynamicNearestNeighbor {
+    typedef NearestNeighbor<dist_t, pos_t, distfun_t> tree_t;
+    typedef std::pair<dist_t, int> item;
+    // A static set of points with its tree
+    struct level {
+      std::vector<pos_t> pts;
+      std::vector<int> ids;     // the ids of the points
+      tree_t tree;
+      int dead;                 // the number of points which are removed
+      bool busy;                // whether a merge is pending
+      level() : dead(0), busy(false) {}
+      int live() const { return int(ids.size()) - dead; }
+    };
+  public:
+
+    /**
+     * Constructor for DynamicNearestNeighbor with an empty set of points.
+     *
+     * @param[in] dist the distance function object.
+     * @param[in] bucket the size of the buckets at the leaf nodes of the
+     *   trees; this must lie in [0, 2 + 4*sizeof(dist_t)/sizeof(int)]
+     *   (default 4).
+     * @param[in] buffer the size of the buffer of inserted points (default
+     *   64).
+     * @param[in] bgsize the minimum number of points in a merge for it to be
+     *   carried out on a background thread (default 65536).
+     * @exception GeographicErr if the value of \e bucket is out of bounds or
+     *   if \e buffer is not positive.
+     *
+     * The choice of \e buffer is a tradeoff between the cost of searching the
+     * buffer linearly and the cost of building many small trees.  Set \e
+     * bgsize = std::numeric_limits<int>::max() to carry out all the merges
+     * in the calling thread.
+     **********************************************************************/
+    DynamicNearestNeighbor(const distfun_t& dist, int bucket = 4,
+                           int buffer = 64, int bgsize = 1 << 16)
+      : _dist(dist)
+      , _bucket(bucket)
+      , _buffersize(buffer)
+      , _bgsize(bgsize)
+      , _numpoints(0)
+    {
+      check();
+    }
+
+    /**
+     * Constructor for DynamicNearestNeighbor with an initial set of points.
+     *
+     * @param[in] pts a vector of points to include in the set; these are
+     *   given the ids 0, 1, &hellip;, pts.size() &minus; 1.
+     * @param[in] dist the distance function object.
+     * @param[in] bucket the size of the buckets at the leaf nodes of the
+     *   trees (default 4).
+     * @param[in] buffer the size of the buffer of inserted points (default
+     *   64).
+     * @param[in] bgsize the minimum number of points in a merge for it to be
+     *   carried out on a background thread (default 65536).
+     * @param[in] nthreads the number of threads to use in building the tree
+     *   for \e pts (default 1).
+     * @exception GeographicErr if the value of \e bucket is out of bounds, if
+     *   \e buffer is not positive, or the size of \e pts is too big for an
+     *   int.
+     * @exception std::bad_alloc if memory for the tree can't be allocated.
+     *
+     * The points are put into a single tree; this is much faster than
+     * inserting them one at a time.
+     **********************************************************************/
+    DynamicNearestNeighbor(const std::vector<pos_t>& pts,
+                           const distfun_t& dist, int bucket = 4,
+                           int buffer = 64, int bgsize = 1 << 16,
+                           int nthreads = 1)
+      : DynamicNearestNeighbor(dist, bucket, buffer, bgsize)
+    {
+      if (pts.empty()) return;
+      if (pts.size() > size_t(std::numeric_limits<int>::max()))
+        throw GeographicLib::GeographicErr("pts array too big");
+      int n = int(pts.size());
+      std::vector<int> ids(n);
+      for (int i = 0; i < n; ++i) ids[i] = i;
+      _where.assign(n, 0);
+      _local.resize(n);
+      _alive.assign(n, 1);
+      _levels.resize(1);
+      install(0, build(pts, ids, _dist, _bucket, nthreads));
+      _numpoints = n;
+    }
+
+    /**
+     * Add a point to the set.
+     *
+     * @param[in] pt the point to add.
+     * @exception GeographicErr if there are too many points for an int.
+     * @exception std::bad_alloc if memory can't be allocated.
+     * @return the id of the point.
+     *
+     * \e pt may coincide with a point already in the set.  Any exception
+     * thrown while building a tree on a background thread is rethrown by
+     * this function.
+     **********************************************************************/
+    int Insert(const pos_t& pt) {
+      poll();
+      int id;
+      if (_free.empty()) {
+        if (_where.size() >= size_t(std::numeric_limits<int>::max()))
+          throw GeographicLib::GeographicErr("Too many points");
+        id = int(_where.size());
+        _where.push_back(-1);
+        _local.push_back(0);
+        _alive.push_back(0);
+      } else {
+        id = _free.back();
+        _free.pop_back();
+      }
+      _where[id] = -1;
+      _local[id] = int(_buf.size());
+      _alive[id] = 1;
+      _buf.push_back(pt);
+      _bufids.push_back(id);
+      ++_numpoints;
+      if (int(_buf.size()) >= _buffersize)
+        flush();
+      return id;
+    }
+
+    /**
+     * Remove a point from the set.
+     *
+     * @param[in] id the id of the point.
+     * @exception GeographicErr if \e id isn't in the set.
+     *
+     * Following this call, \e id may be returned by Insert() for a new point.
+     **********************************************************************/
+    void Remove(int id) {
+      poll();
+      if (!Contains(id))
+        throw GeographicLib::GeographicErr("Point " + std::to_string(id)
+                                           + " not in set");
+      _alive[id] = 0;
+      --_numpoints;
+      int w = _where[id];
+      if (w < 0) {
+        // Move the last point in the buffer into the vacated slot
+        int j = _local[id], last = _bufids.back();
+        _buf[j] = _buf.back(); _bufids[j] = last; _local[last] = j;
+        _buf.pop_back(); _bufids.pop_back();
+        _free.push_back(id);
+      } else {
+        level& lv = _levels[w];
+        ++lv.dead;
+        if (!lv.busy && 2 * lv.dead > int(lv.ids.size()))
+          rebalance();
+      }
+    }
+
+    /**
+     * Search the DynamicNearestNeighbor.
+     *
+     * @param[in] query the query point.
+     * @param[out] ind a vector of the ids of the closest points found.
+     * @param[in] k the number of points to search for (default = 1).
+     * @param[in] maxdist only return points with distances of \e maxdist or
+     *   less from \e query (default is the maximum \e dist_t).
+     * @param[in] mindist only return points with distances of more than
+     *   \e mindist from \e query (default = &minus;1).
+     * @param[in] exhaustive whether to do an exhaustive search (default true).
+     * @param[in] tol the tolerance on the results (default 0).
+     * @param[in] eps the relative tolerance on the results (default 0).
+     * @return the distance to the closest point found (&minus;1 if no points
+     *   are found).
+     *
+     * The arguments and the results are the same as for
+     * NearestNeighbor::Search, except that \e ind holds the ids of the
+     * points.  With \e tol > 0 or \e eps > 0, the tolerances are applied
+     * separately to the search of each tree.  The search does not update any
+     * statistics and so several threads can call this function at once.
+     **********************************************************************/
+    dist_t Search(const pos_t& query,
+                  std::vector<int>& ind,
+                  int k = 1,
+                  dist_t maxdist = std::numeric_limits<dist_t>::max(),
+                  dist_t mindist = -1,
+                  bool exhaustive = true,
+                  dist_t tol = 0,
+                  dist_t eps = 0) const {
+      return search<false>(typename tree_t::nobounds(), query, ind,
+                           k, maxdist, mindist, exhaustive, tol, eps);
+    }
+
+    /**
+     * Search the DynamicNearestNeighbor using bounds on the distances.
+     *
+     * @tparam boundfun_t the type of the function object for the bounds.
+     * @param[in] bound a function object which bounds the distances.
+     * @param[in] query the query point.
+     * @param[out] ind a vector of the ids of the closest points found.
+     * @param[in] k the number of points to search for (default = 1).
+     * @param[in] maxdist only return points with distances of \e maxdist or
+     *   less from \e query (default is the maximum \e dist_t).
+     * @param[in] mindist only return points with distances of more than
+     *   \e mindist from \e query (default = &minus;1).
+     * @param[in] exhaustive whether to do an exhaustive search (default true).
+     * @param[in] tol the tolerance on the results (default 0).
+     * @param[in] eps the relative tolerance on the results (default 0).
+     * @return the distance to the closest point found (&minus;1 if no points
+     *   are found).
+     *
+     * This is the same as Search(), except that \e bound is used, as in the
+     * corresponding overload of NearestNeighbor::Search, to avoid computing
+     * distances (\e bound must then be safe to call from several threads).
+     **********************************************************************/
+    template<class boundfun_t>
+    dist_t Search(const boundfun_t& bound,
+                  const pos_t& query,
+                  std::vector<int>& ind,
+                  int k = 1,
+                  dist_t maxdist = std::numeric_limits<dist_t>::max(),
+                  dist_t mindist = -1,
+                  bool exhaustive = true,
+                  dist_t tol = 0,
+                  dist_t eps = 0) const {
+      return search<true>(bound, query, ind,
+                          k, maxdist, mindist, exhaustive, tol, eps);
+    }
+
+    /**
+     * Wait for any pending merges to complete.
+     *
+     * @exception std::bad_alloc if memory for a tree can't be allocated.
+     *
+     * On return, the set is held in trees each of which is at least twice
+     * as big as the next smaller one (together with the buffer).
+     **********************************************************************/
+    void Wait() {
+      while (_job.valid()) {
+        _job.wait();
+        finish();
+      }
+    }
+
+    /**
+     * @return the number of points in the set.
+     **********************************************************************/
+    int NumPoints() const { return _numpoints; }
+
+    /**
+     * @param[in] id a point id.
+     * @return whether \e id is in the set.
+     **********************************************************************/
+    bool Contains(int id) const {
+      return id >= 0 && size_t(id) < _alive.size() && _alive[id];
+    }
+
+    /**
+     * @param[in] id the id of a point in the set.
+     * @return the point.
+     *
+     * The result is undefined if \e id isn't in the set.
+     **********************************************************************/
+    const pos_t& Point(int id) const {
+      int w = _where[id];
+      return w < 0 ? _buf[_local[id]] : _levels[w].pts[_local[id]];
+    }
+
+    /**
+     * @return the number of trees.
+     **********************************************************************/
+    int NumTrees() const { return int(_order.size()); }
+
+    /**
+     * @return the memory used by the object; \e heap is the memory used by
+     *   the copies of the points, the trees, and the tables of ids.  This
+     *   counts sizeof(\e pos_t) for each point and doesn't include the
+     *   result of a pending merge.
+     **********************************************************************/
+    MemoryFootprint MemoryUsage() const {
+      typedef MemoryFootprint m;
+      size_t heap = m::Bytes(_buf) + m::Bytes(_bufids) + m::Bytes(_levels) +
+        m::Bytes(_order) + m::Bytes(_where) + m::Bytes(_local) +
+        m::Bytes(_alive) + m::Bytes(_free) +
+        m::Bytes(_jobsrc) + m::Bytes(_jobfree);
+      for (const auto& l : _levels)
+        heap += m::Bytes(l.pts) + m::Bytes(l.ids) + l.tree.MemoryUsage().heap;
+      return m(heap);
+    }
+
+  private:
+    distfun_t _dist;
+    int _bucket, _buffersize, _bgsize, _numpoints;
+    // The buffer of inserted points and their ids
+    std::vector<pos_t> _buf;
+    std::vector<int> _bufids;
+    // The trees; an empty level is available for reuse.  _order lists the
+    // nonempty levels, largest first.
+    std::vector<level> _levels;
+    std::vector<int> _order;
+    // For each id: the level holding the point (-1 for the buffer), its
+    // index in the level or buffer, and whether it is in the set.
+    std::vector<int> _where, _local;
+    std::vector<char> _alive;
+    // The ids available for reuse
+    std::vector<int> _free;
+    // The pending merge: the result, the levels being merged, and the ids of
+    // the removed points in these levels
+    std::future<level> _job;
+    std::vector<int> _jobsrc, _jobfree;
+
+    // The implementation of Search
+    template<bool boundp, class boundfun_t>
+    dist_t search(const boundfun_t& bound, const pos_t& query,
+                  std::vector<int>& ind, int k,
+                  dist_t maxdist, dist_t mindist,
+                  bool exhaustive, dist_t tol, dist_t eps) const {
+      std::priority_queue<item> results;
+      // distance to the kth closest point so far
+      auto tau = [&results, k, maxdist]() -> dist_t {
+        return int(results.size()) == k ? results.top().first : maxdist;
+      };
+      auto done = [&results, k, exhaustive, tol, &tau]() -> bool {
+        return int(results.size()) == k && (!exhaustive || tau() <= tol);
+      };
+      auto add = [&results, k](dist_t d, int id) -> void {
+        if (int(results.size()) == k) results.pop();
+        results.push(std::make_pair(d, id));
+      };
+      if (k > 0 && maxdist > mindist) {
+        for (size_t i = 0; i < _buf.size() && !done(); ++i) {
+          if (boundp) {
+            dist_t dmin = 0, dmax = 0;
+            bound(_buf[i], query, dmin, dmax);
+            if (dmin > tau() || dmax <= mindist) continue;
+          }
+          dist_t d = _dist(_buf[i], query);
+          if (d > mindist && d <= tau()) add(d, _bufids[i]);
+        }
+        std::vector<int> ind1;
+        std::vector<dist_t> dist1;
+        for (int w : _order) {
+          if (done()) break;
+          const level& lv = _levels[w];
+          int c;
+          lv.tree.template search<boundp>
+            (lv.pts, _dist, bound, query,
+             ind1, &dist1, exhaustive ? k : k - int(results.size()),
+             tau(), mindist, exhaustive, tol, eps, 0, c,
+             [this, &lv](int i) -> bool { return !_alive[lv.ids[i]]; });
+          for (size_t j = 0; j < ind1.size(); ++j)
+            if (dist1[j] <= tau()) add(dist1[j], lv.ids[ind1[j]]);
+        }
+      }
+      dist_t d = -1;
+      ind.resize(results.size());
+      for (int i = int(ind.size()); i--;) {
+        ind[i] = results.top().second;
+        if (i == 0) d = results.top().first;
+        results.pop();
+      }
+      return d;
+    }
+
+    void check() const {
+      // Let NearestNeighbor check bucket
+      tree_t().Initialize(std::vector<pos_t>(), _dist, _bucket);
+      if (!(_buffersize > 0))
+        throw GeographicLib::GeographicErr("buffer must be positive");
+    }
+
+    // Build a level from a set of points; this may be run in the background
+    // and so only uses its arguments.
+    static level build(const std::vector<pos_t>& pts,
+                       const std::vector<int>& ids,
+                       const distfun_t& dist, int bucket, int nthreads = 1) {
+      level lv;
+      if (pts.empty()) return lv;
+      lv.tree.Initialize(pts, dist, bucket, nthreads);
+      // Store the points in the order in which they are stored in the tree
+      std::vector<int> perm;
+      lv.tree.Reorder(perm);
+      lv.pts.reserve(perm.size());
+      lv.ids.reserve(perm.size());
+      for (int i : perm) {
+        lv.pts.push_back(pts[i]);
+        lv.ids.push_back(ids[i]);
+      }
+      return lv;
+    }
+
+    // Gather the points in the set from the levels src (and the buffer if
+    // bufp) into pts and ids; add the ids of the removed points to freed.
+    void gather(const std::vector<int>& src, bool bufp,
+                std::vector<pos_t>& pts, std::vector<int>& ids,
+                std::vector<int>& freed) const {
+      if (bufp) {
+        pts.insert(pts.end(), _buf.begin(), _buf.end());
+        ids.insert(ids.end(), _bufids.begin(), _bufids.end());
+      }
+      for (int w : src) {
+        const level& lv = _levels[w];
+        for (size_t i = 0; i < lv.ids.size(); ++i) {
+          if (_alive[lv.ids[i]]) {
+            pts.push_back(lv.pts[i]);
+            ids.push_back(lv.ids[i]);
+          } else
+            freed.push_back(lv.ids[i]);
+        }
+      }
+    }
+
+    // Replace level w by lv, updating the locations of its points
+    void install(int w, level&& lv) {
+      lv.dead = 0;
+      for (size_t i = 0; i < lv.ids.size(); ++i) {
+        int id = lv.ids[i];
+        _where[id] = w;
+        _local[id] = int(i);
+        if (!_alive[id]) ++lv.dead;
+      }
+      _levels[w] = std::move(lv);
+      _order.clear();
+      for (int v = 0; v < int(_levels.size()); ++v)
+        if (!_levels[v].ids.empty()) _order.push_back(v);
+      std::sort(_order.begin(), _order.end(), [this](int a, int b) -> bool {
+          return _levels[a].ids.size() > _levels[b].ids.size();
+        });
+    }
+
+    // An empty level
+    int vacant() {
+      for (int w = 0; w < int(_levels.size()); ++w)
+        if (_levels[w].ids.empty() && !_levels[w].busy) return w;
+      _levels.emplace_back();
+      return int(_levels.size()) - 1;
+    }
+
+    // Replace the levels src by a single level holding their points (in the
+    // background if the merge is big enough)
+    void merge(const std::vector<int>& src, bool background) {
+      std::vector<pos_t> pts;
+      std::vector<int> ids, freed;
+      gather(src, false, pts, ids, freed);
+      if (background) {
+        for (int w : src) _levels[w].busy = true;
+        _jobsrc = src;
+        _jobfree.swap(freed);
+        _job = std::async(std::launch::async, &DynamicNearestNeighbor::build,
+                          std::move(pts), std::move(ids), _dist, _bucket, 1);
+      } else {
+        level lv = build(pts, ids, _dist, _bucket);
+        for (int w : src) _levels[w] = level();
+        install(src[0], std::move(lv));
+        _free.insert(_free.end(), freed.begin(), freed.end());
+      }
+    }
+
+    // Merge pairs of levels whose sizes are within a factor of 2 and rebuild
+    // levels where more than half the points have been removed.
+    void rebalance() {
+      while (true) {
+        std::vector<int> idle;
+        for (int w : _order)
+          if (!_levels[w].busy) idle.push_back(w);
+        std::sort(idle.begin(), idle.end(), [this](int a, int b) -> bool {
+            return _levels[a].live() < _levels[b].live();
+          });
+        std::vector<int> src;
+        bool background = false;
+        // Can a merge of n points be done now?  If so, where?
+        auto feasible = [this, &background](int n) -> bool {
+          background = n >= _bgsize;
+          return !(background && _job.valid());
+        };
+        for (size_t i = 0; i + 1 < idle.size() && src.empty(); ++i) {
+          const level &a = _levels[idle[i]], &b = _levels[idle[i + 1]];
+          if (b.live() <= 2 * a.live() && feasible(a.live() + b.live()))
+            src = {idle[i], idle[i + 1]};
+        }
+        for (size_t i = 0; i < idle.size() && src.empty(); ++i) {
+          const level& a = _levels[idle[i]];
+          if (2 * a.dead > int(a.ids.size()) && feasible(a.live()))
+            src = {idle[i]};
+        }
+        if (src.empty()) break;
+        merge(src, background);
+      }
+    }
+
+    // Turn the buffer into a level
+    void flush() {
+      std::vector<pos_t> pts;
+      std::vector<int> ids, freed;
+      gather(std::vector<int>(), true, pts, ids, freed);
+      int w = vacant();
+      install(w, build(pts, ids, _dist, _bucket));
+      _buf.clear();
+      _bufids.clear();
+      rebalance();
+    }
+
+    // Incorporate the result of the pending merge
+    void finish() {
+      level lv;
+      try {
+        lv = _job.get();
+      } catch (...) {
+        for (int w : _jobsrc) _levels[w].busy = false;
+        _jobsrc.clear(); _jobfree.clear();
+        throw;
+      }
+      for (int w : _jobsrc) _levels[w] = level();
+      install(_jobsrc[0], std::move(lv));
+      _free.insert(_free.end(), _jobfree.begin(), _jobfree.end());
+      _jobsrc.clear(); _jobfree.clear();
+      rebalance();
+    }
+
+    // Incorporate the result of the pending merge if it's ready
+    void poll() {
+      if (_job.valid() &&
+          _job.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        finish();
+    }
+
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_DYNAMICNEARESTNEIGHBOR_HPP
@@ -36,6 +36,11 @@ namespace GeographicLib {
     real _a, _f,_b, _e2, _e12, _n;
     AuxLatitude _aux;
     real _rm, _c2;
+    // Can the series be used by the batch conversions?
+    bool _series;
+    // Convert an array of latitudes with LatFix applied to the input
+    void Convert(int auxin, int auxout, size_t n,
+                 const real zeta[], real eta[]) const;
 
   public:
     /** \name Constructor
@@ -308,6 +313,126 @@ namespace GeographicLib {
     Math::real InverseIsometricLatitude(real psi) const;
     ///@}
 
+    /** \name Latitude conversions for many points.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Array version of Ellipsoid::RectifyingLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] mu array of rectifying latitudes (degrees).
+     *
+     * Each array holds \e n elements; the output array may be the same as the
+     * input array.  If |\e f| &le; 1/150, the array versions of the
+     * conversions involving the rectifying, conformal, or authalic latitudes
+     * use the Fourier series computed by the constructor of AuxLatitude;
+     * these are summed for blocks of latitudes in loops which the compiler
+     * can vectorize (see the array version of AuxLatitude::Convert).  The
+     * results then agree with the scalar functions to within roundoff.
+     * Otherwise, and for the parametric and geocentric latitudes, the scalar
+     * functions are called for each latitude.
+     **********************************************************************/
+    void RectifyingLatitude(size_t n, const real phi[], real mu[]) const;
+
+    /**
+     * Array version of Ellipsoid::InverseRectifyingLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] mu array of rectifying latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     **********************************************************************/
+    void InverseRectifyingLatitude(size_t n, const real mu[], real phi[]) const;
+
+    /**
+     * Array version of Ellipsoid::AuthalicLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] xi array of authalic latitudes (degrees).
+     **********************************************************************/
+    void AuthalicLatitude(size_t n, const real phi[], real xi[]) const;
+
+    /**
+     * Array version of Ellipsoid::InverseAuthalicLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] xi array of authalic latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     **********************************************************************/
+    void InverseAuthalicLatitude(size_t n, const real xi[], real phi[]) const;
+
+    /**
+     * Array version of Ellipsoid::ConformalLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] chi array of conformal latitudes (degrees).
+     **********************************************************************/
+    void ConformalLatitude(size_t n, const real phi[], real chi[]) const;
+
+    /**
+     * Array version of Ellipsoid::InverseConformalLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] chi array of conformal latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     **********************************************************************/
+    void InverseConformalLatitude(size_t n, const real chi[], real phi[]) const;
+
+    /**
+     * Array version of Ellipsoid::ParametricLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] beta array of parametric latitudes (degrees).
+     **********************************************************************/
+    void ParametricLatitude(size_t n, const real phi[], real beta[]) const;
+
+    /**
+     * Array version of Ellipsoid::InverseParametricLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] beta array of parametric latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     **********************************************************************/
+    void InverseParametricLatitude(size_t n, const real beta[], real phi[])
+      const;
+
+    /**
+     * Array version of Ellipsoid::GeocentricLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] theta array of geocentric latitudes (degrees).
+     **********************************************************************/
+    void GeocentricLatitude(size_t n, const real phi[], real theta[]) const;
+
+    /**
+     * Array version of Ellipsoid::InverseGeocentricLatitude.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] theta array of geocentric latitudes (degrees).
+     * @param[out] phi array of geographic latitudes (degrees).
+     **********************************************************************/
+    void InverseGeocentricLatitude(size_t n, const real theta[], real phi[])
+      const;
+
+    /**
+     * Array version of Ellipsoid::MeridianDistance.
+     *
+     * @param[in] n the number of latitudes.
+     * @param[in] phi array of geographic latitudes (degrees).
+     * @param[out] s array of distances along a meridian from the equator
+     *   (meters).
+     *
+     * This is computed from the array version of
+     * Ellipsoid::RectifyingLatitude.
+     **********************************************************************/
+    void MeridianDistance(size_t n, const real phi[], real s[]) const;
+    ///@}
+
     /** \name Other quantities.
      **********************************************************************/
     ///@{
@@ -67,6 +67,23 @@ namespace GeographicLib {
     enum { num_ = 13 }; // Max depth required for sncndn; probably 5 is enough.
     real _k2, _kp2, _alpha2, _alphap2, _eps;
     real _kKc, _eEc, _dDc, _pPic, _gGc, _hHc;
+    // The descending Landen sequence used by sncndn, which depends only on
+    // the modulus; _landl is the number of terms in _landm and _landn.
+    real _landm[num_], _landn[num_], _landc, _landd;
+    unsigned _landl;
+    void LandenInit();
+    // The number of points handled together by the batch versions of RF,
+    // RD, RJ, and RG
+    static const int blocksize_ = 4;
+    template<int n>
+    static void RFBlock(const real x[], const real y[], const real z[],
+                        real F[]);
+    template<int n>
+    static void RDBlock(const real x[], const real y[], const real z[],
+                        real D[]);
+    template<int n>
+    static void RJBlock(const real x[], const real y[], const real z[],
+                        const real p[], real J[]);
   public:
     /** \name Constructor
      **********************************************************************/
@@ -88,6 +105,7 @@ namespace GeographicLib {
      * D(&phi;, \e k).
      **********************************************************************/
     EllipticFunction(real k2 = 0, real alpha2 = 0)
+      : _k2(Math::NaN())
       { Reset(k2, alpha2); }
 
     /**
@@ -110,6 +128,7 @@ namespace GeographicLib {
      * \e k is very close to unity.
      **********************************************************************/
     EllipticFunction(real k2, real alpha2, real kp2, real alphap2)
+      : _k2(Math::NaN())
       { Reset(k2, alpha2, kp2, alphap2); }
 
     /**
@@ -144,6 +163,9 @@ namespace GeographicLib {
      * = 1.  (No checking is done that these conditions are met.)  This
      * constructor is provided to enable accuracy to be maintained, e.g., when
      * is very small.
+     *
+     * If the arguments are the same as the current values, the complete
+     * integrals are not recomputed.
      **********************************************************************/
     void Reset(real k2, real alpha2, real kp2, real alphap2);
 
@@ -294,6 +316,30 @@ namespace GeographicLib {
      **********************************************************************/
     Math::real E(real phi) const;
 
+    /**
+     * The incomplete integrals of the first kind for several arguments.
+     *
+     * @param[in] n the number of points.
+     * @param[in] phi an array of \e n values of &phi;.
+     * @param[out] F an array of \e n values of \e F(&phi;, \e k).
+     *
+     * The results are the same as calling FF(real) \e n times.  \e phi and
+     * \e F may be the same array.
+     **********************************************************************/
+    void FF(size_t n, const real phi[], real F[]) const;
+
+    /**
+     * The incomplete integrals of the second kind for several arguments.
+     *
+     * @param[in] n the number of points.
+     * @param[in] phi an array of \e n values of &phi;.
+     * @param[out] E an array of \e n values of \e E(&phi;, \e k).
+     *
+     * The results are the same as calling E(real) \e n times.  \e phi and
+     * \e E may be the same array.
+     **********************************************************************/
+    void E(size_t n, const real phi[], real E[]) const;
+
     /**
      * The incomplete integral of the second kind with the argument given in
      * degrees.
@@ -575,6 +621,21 @@ namespace GeographicLib {
      **********************************************************************/
     void sncndn(real x, real& sn, real& cn, real& dn) const;
 
+    /**
+     * The Jacobi elliptic functions for several arguments.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x an array of \e n arguments.
+     * @param[out] sn an array of \e n values of sn(\e x, \e k).
+     * @param[out] cn an array of \e n values of cn(\e x, \e k).
+     * @param[out] dn an array of \e n values of dn(\e x, \e k).
+     *
+     * The results are the same as calling sncndn(real, real&, real&, real&)
+     * \e n times.
+     **********************************************************************/
+    void sncndn(size_t n, const real x[], real sn[], real cn[], real dn[])
+      const;
+
     /**
      * The &Delta; amplitude function.
      *
@@ -707,6 +768,69 @@ namespace GeographicLib {
      * \e y can be 0.
      **********************************************************************/
     static real RD(real x, real y, real z);
+
+    /**
+     * Batch version of RF(real, real, real).
+     *
+     * @param[in] n the number of points.
+     * @param[in] x an array of \e n values of \e x.
+     * @param[in] y an array of \e n values of \e y.
+     * @param[in] z an array of \e n values of \e z.
+     * @param[out] F an array of \e n values of
+     *   <i>R</i><sub><i>F</i></sub>(\e x, \e y, \e z).
+     *
+     * The results are the same as calling the scalar version \e n times.
+     * The duplication steps of several points are carried out together
+     * which allows more of the arithmetic to proceed in parallel.
+     **********************************************************************/
+    static void RF(size_t n, const real x[], const real y[], const real z[],
+                   real F[]);
+
+    /**
+     * Batch version of RG(real, real, real).
+     *
+     * @param[in] n the number of points.
+     * @param[in] x an array of \e n values of \e x.
+     * @param[in] y an array of \e n values of \e y.
+     * @param[in] z an array of \e n values of \e z.
+     * @param[out] G an array of \e n values of
+     *   <i>R</i><sub><i>G</i></sub>(\e x, \e y, \e z).
+     *
+     * The results are the same as calling the scalar version \e n times.
+     **********************************************************************/
+    static void RG(size_t n, const real x[], const real y[], const real z[],
+                   real G[]);
+
+    /**
+     * Batch version of RJ(real, real, real, real).
+     *
+     * @param[in] n the number of points.
+     * @param[in] x an array of \e n values of \e x.
+     * @param[in] y an array of \e n values of \e y.
+     * @param[in] z an array of \e n values of \e z.
+     * @param[in] p an array of \e n values of \e p.
+     * @param[out] J an array of \e n values of
+     *   <i>R</i><sub><i>J</i></sub>(\e x, \e y, \e z, \e p).
+     *
+     * The results are the same as calling the scalar version \e n times.
+     **********************************************************************/
+    static void RJ(size_t n, const real x[], const real y[], const real z[],
+                   const real p[], real J[]);
+
+    /**
+     * Batch version of RD(real, real, real).
+     *
+     * @param[in] n the number of points.
+     * @param[in] x an array of \e n values of \e x.
+     * @param[in] y an array of \e n values of \e y.
+     * @param[in] z an array of \e n values of \e z.
+     * @param[out] D an array of \e n values of
+     *   <i>R</i><sub><i>D</i></sub>(\e x, \e y, \e z).
+     *
+     * The results are the same as calling the scalar version \e n times.
+     **********************************************************************/
+    static void RD(size_t n, const real x[], const real y[], const real z[],
+                   real D[]);
     ///@}
 
   };
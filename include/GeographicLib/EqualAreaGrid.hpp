@@ -0,0 +1,361 @@
+/**
+ * \file EqualAreaGrid.hpp
+ * \brief Header for GeographicLib::EqualAreaGrid class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_EQUALAREAGRID_HPP)
+#define GEOGRAPHICLIB_EQUALAREAGRID_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/AuxLatitude.hpp>
+#include <GeographicLib/Geohash.hpp>
+#include <vector>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief A hierarchical grid of equal-area cells on the ellipsoid
+   *
+   * This divides the ellipsoid into cells of equal area using the HEALPix
+   * scheme (Hierarchical Equal Area isoLatitude Pixelization) applied to the
+   * authalic sphere:
+   * - K. M. G&oacute;rski, E. Hivon, A. J. Banday, B. D. Wandelt, F. K.
+   *   Hansen, M. Reinecke, and M. Bartelmann,
+   *   <a href="https://doi.org/10.1086/427976">
+   *   HEALPix: A Framework for High-Resolution Discretization and Fast
+   *   Analysis of Data Distributed on the Sphere</a>,
+   *   Astrophys.&nbsp;J. 622(2), 759&ndash;771 (2005).
+   * .
+   * The geographic latitude &phi; is converted to the authalic latitude
+   * &xi; with AuxLatitude; since the mapping (&phi;, &lambda;) &rarr; (&xi;,
+   * &lambda;) preserves area (up to a constant factor), the equal-area
+   * cells on the authalic sphere map to equal-area cells on the ellipsoid.
+   *
+   * At level 0 there are 12 base cells (4 around each pole and 4 on the
+   * equator).  Each cell at level \e l is divided into 4 cells at level \e l
+   * + 1; thus there are 12 &times; 4<sup><i>l</i></sup> cells at level \e l,
+   * each of area 4&pi;<i>R</i><sub><i>q</i></sub><sup>2</sup> / (12 &times;
+   * 4<sup><i>l</i></sup>), where <i>R</i><sub><i>q</i></sub> is the authalic
+   * radius.  The boundaries of the cells are not geodesics.  The maximum
+   * level is 29, at which the cells on the WGS84 ellipsoid are about 12 mm
+   * across.
+   *
+   * A cell is identified by a 64-bit integer
+   * <i>id</i> = 4 &times; 4<sup><i>l</i></sup> + \e p, where \e l is the level
+   * and \e p is the index of the cell in the HEALPix "nested" numbering at
+   * that level (also known as the NUNIQ scheme).  This has the following
+   * properties:
+   * - each cell at every level is given a distinct \e id in [4,
+   *   2<sup>62</sup>); 0 is used to indicate an invalid cell;
+   * - the parent of cell \e id is \e id / 4 and its children are 4 \e id +
+   *   \e k for \e k in [0, 4);
+   * - the descendants of cell \e id at level \e l + \e d are the cells in
+   *   the contiguous range [\e id &times; 4<sup><i>d</i></sup>, (\e id + 1)
+   *   &times; 4<sup><i>d</i></sup>);
+   * - the cells at a given level are arranged along a space-filling curve,
+   *   so cells close in \e id are close on the ellipsoid.
+   * .
+   * Thus aggregating data into cells is a matter of computing the cell ids
+   * of the points with Forward() at the finest level needed, sorting the
+   * ids, and reducing runs of equal ids; coarser aggregates are obtained by
+   * shifting the ids right by a multiple of 2 bits.
+   *
+   * The authalic latitude is found with the Fourier series in AuxLatitude
+   * (for |\e f| &le; 1/150) or with the exact relations (otherwise).
+   *
+   * Example of use:
+   * \include example-EqualAreaGrid.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT EqualAreaGrid {
+  private:
+    typedef Math::real real;
+    static const int maxlevel_ = 29;
+    static const int jrll_[12], jpll_[12];
+    AuxLatitude _aux;
+    real _a, _f;
+    bool _exact;
+    static void CheckLevel(int level);
+    static void CheckLatitude(real lat);
+    // The id of the cell at level containing the point with authalic
+    // latitude xi, specified by z = sin(xi) and c = cos(xi), and longitude
+    // lon (degrees).
+    static unsigned long long Index(real z, real c, real lon, int level);
+    // Split id into level, face, and the coordinates ix, iy within the face
+    static void Decode(unsigned long long id, int& level, int& face,
+                       unsigned long long& ix, unsigned long long& iy);
+    static unsigned long long Encode(int level, int face,
+                                     unsigned long long ix,
+                                     unsigned long long iy) {
+      return (4ULL << 2*level) + ((unsigned long long)(face) << 2*level) +
+        Geohash::Spread(ix) + (Geohash::Spread(iy) << 1);
+    }
+    // The point with face coordinates (x, y) in [0, 1] as sin and cos of the
+    // authalic latitude and the longitude (degrees)
+    static void Location(int face, real x, real y,
+                         real& z, real& c, real& lon);
+
+  public:
+
+    /**
+     * Constructor for an ellipsoid with
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.  Setting \e f = 0 gives a sphere.
+     *   Negative \e f gives a prolate ellipsoid.
+     * @exception GeographicErr if \e a or (1 &minus; \e f) \e a is not
+     *   positive.
+     **********************************************************************/
+    EqualAreaGrid(real a, real f);
+
+    /** \name Conversions between points and cells
+     **********************************************************************/
+    ///@{
+    /**
+     * Find the cell containing a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] level the level of the cell, in [0, 29].
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;] or \e level is out of range.
+     * @return the id of the cell.
+     *
+     * If \e lat or \e lon is NaN, the returned id is 0.
+     **********************************************************************/
+    unsigned long long Forward(real lat, real lon, int level) const;
+
+    /**
+     * Find the cells containing many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] level the level of the cells, in [0, 29].
+     * @param[out] id array of the ids of the cells.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception GeographicErr if any of \e lat is not in [&minus;90&deg;,
+     *   90&deg;] or \e level is out of range.
+     *
+     * Each array holds \e n elements.  The latitudes are converted in blocks
+     * with the array version of AuxLatitude::Convert, whose loops the
+     * compiler can vectorize, and the cell ids are then computed with integer
+     * arithmetic.  The results are the same as for Forward(real, real, int)
+     * except, possibly, for points within roundoff of a cell boundary.  If \e
+     * nthreads > 1, the points are handed out in chunks to that many tasks
+     * which are run with Executor::Batch.
+     **********************************************************************/
+    void Forward(size_t n, const real lat[], const real lon[], int level,
+                 unsigned long long id[], int nthreads = 1) const;
+
+    /**
+     * Find the center of a cell.
+     *
+     * @param[in] id the id of the cell.
+     * @param[out] lat latitude of the center of the cell (degrees).
+     * @param[out] lon longitude of the center of the cell (degrees).
+     *
+     * The center of the cell is the center of the cell in the HEALPix
+     * coordinates on the face of the base cell.  If \e id is invalid, \e lat
+     * and \e lon are set to NaN.
+     **********************************************************************/
+    void Reverse(unsigned long long id, real& lat, real& lon) const;
+
+    /**
+     * Find the centers of many cells.
+     *
+     * @param[in] n the number of cells.
+     * @param[in] id array of the ids of the cells.
+     * @param[out] lat array of latitudes of the centers (degrees).
+     * @param[out] lon array of longitudes of the centers (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * Each array holds \e n elements.  This is the inverse of
+     * Forward(size_t, const real[], const real[], int, unsigned long long[],
+     * int) const and it uses the array version of AuxLatitude::Convert in the
+     * same way.
+     **********************************************************************/
+    void Reverse(size_t n, const unsigned long long id[],
+                 real lat[], real lon[], int nthreads = 1) const;
+
+    /**
+     * Find the boundary of a cell.
+     *
+     * @param[in] id the id of the cell.
+     * @param[in] step the number of points to return along each edge of the
+     *   cell (default 1).
+     * @param[out] lat the latitudes of the points on the boundary (degrees).
+     * @param[out] lon the longitudes of the points on the boundary (degrees).
+     * @exception GeographicErr if \e id is invalid or \e step is not
+     *   positive.
+     * @exception std::bad_alloc if memory for \e lat or \e lon can't be
+     *   allocated.
+     *
+     * On return, \e lat and \e lon hold 4 \e step points traversing the
+     * boundary counter-clockwise starting at the northern vertex (in the
+     * order north, west, south, east); with \e step = 1, these are the 4
+     * vertices.  The edges of a cell are not geodesics; use \e step > 1 to
+     * sample intermediate points.  The longitudes are in [&minus;180&deg;,
+     * 180&deg;]; the longitudes of the vertices at the poles are arbitrary.
+     **********************************************************************/
+    void Boundary(unsigned long long id, int step,
+                  std::vector<real>& lat, std::vector<real>& lon) const;
+
+    /**
+     * Find the vertices of a cell.
+     *
+     * @param[in] id the id of the cell.
+     * @param[out] lat the latitudes of the vertices (degrees).
+     * @param[out] lon the longitudes of the vertices (degrees).
+     * @exception GeographicErr if \e id is invalid.
+     * @exception std::bad_alloc if memory for \e lat or \e lon can't be
+     *   allocated.
+     **********************************************************************/
+    void Boundary(unsigned long long id,
+                  std::vector<real>& lat, std::vector<real>& lon) const
+    { Boundary(id, 1, lat, lon); }
+    ///@}
+
+    /** \name Operations on cell ids
+     **********************************************************************/
+    ///@{
+    /**
+     * Check a cell id.
+     *
+     * @param[in] id the id of a cell.
+     * @return whether \e id is a valid cell id.
+     *
+     * The valid ids are those in [4, 2<sup>62</sup>).
+     **********************************************************************/
+    static bool Valid(unsigned long long id)
+    { return id >= 4ULL && id < (1ULL << (2*maxlevel_ + 4)); }
+
+    /**
+     * The level of a cell.
+     *
+     * @param[in] id the id of a cell.
+     * @exception GeographicErr if \e id is invalid.
+     * @return the level of the cell, in [0, 29].
+     **********************************************************************/
+    static int Level(unsigned long long id);
+
+    /**
+     * The ancestor of a cell at a given level.
+     *
+     * @param[in] id the id of a cell.
+     * @param[in] level the level of the ancestor, in [0, Level(\e id)].
+     * @exception GeographicErr if \e id is invalid or \e level is out of
+     *   range.
+     * @return the id of the cell at \e level containing cell \e id.
+     *
+     * The result is \e id &gt;&gt; (2 (Level(\e id) &minus; \e level)).
+     **********************************************************************/
+    static unsigned long long Parent(unsigned long long id, int level);
+
+    /**
+     * The parent of a cell.
+     *
+     * @param[in] id the id of a cell.
+     * @exception GeographicErr if \e id is invalid or its level is 0.
+     * @return the id of the cell at the next coarser level containing cell \e
+     *   id.
+     **********************************************************************/
+    static unsigned long long Parent(unsigned long long id)
+    { return Parent(id, Level(id) - 1); }
+
+    /**
+     * The children of a cell.
+     *
+     * @param[in] id the id of a cell.
+     * @param[out] children the ids of the 4 cells at the next finer level
+     *   into which cell \e id is divided.
+     * @exception GeographicErr if \e id is invalid or its level is 29.
+     **********************************************************************/
+    static void Children(unsigned long long id, unsigned long long children[4]);
+
+    /**
+     * The neighbors of a cell.
+     *
+     * @param[in] id the id of a cell.
+     * @param[out] neighbors the ids of the cells at the same level sharing an
+     *   edge or a vertex with cell \e id.
+     * @exception GeographicErr if \e id is invalid.
+     * @exception std::bad_alloc if memory for \e neighbors can't be
+     *   allocated.
+     *
+     * A cell usually has 8 neighbors, which are returned in the order
+     * south-west, west, north-west, north, north-east, east, south-east, and
+     * south, where the directions refer to the edges and vertices of the
+     * cell in the order used by Boundary().  At levels > 0, the 24 cells
+     * with a vertex at one of the 8 points where only 3 base cells meet
+     * (at latitudes &plusmn;&xi;<sub>0</sub> where sin&xi;<sub>0</sub> = 2/3)
+     * have just 7 neighbors; the missing direction is skipped.  At level 0,
+     * each base cell has 6 neighbors.
+     **********************************************************************/
+    static void Neighbors(unsigned long long id,
+                          std::vector<unsigned long long>& neighbors);
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * The area of a cell.
+     *
+     * @param[in] level the level of the cell, in [0, 29].
+     * @exception GeographicErr if \e level is out of range.
+     * @return the area of each cell at \e level (meters<sup>2</sup>).
+     **********************************************************************/
+    Math::real CellArea(int level) const;
+
+    /**
+     * The number of cells at a level.
+     *
+     * @param[in] level the level, in [0, 29].
+     * @exception GeographicErr if \e level is out of range.
+     * @return 12 &times; 4<sup><i>level</i></sup>.
+     **********************************************************************/
+    static unsigned long long NumCells(int level);
+
+    /**
+     * @return the maximum level, 29.
+     **********************************************************************/
+    static int MaxLevel() { return maxlevel_; }
+
+    /**
+     * @return \e a the equatorial radius of the ellipsoid (meters).  This is
+     *   the value used in the constructor.
+     **********************************************************************/
+    Math::real EquatorialRadius() const { return _a; }
+
+    /**
+     * @return \e f the flattening of the ellipsoid.  This is the value used
+     *   in the constructor.
+     **********************************************************************/
+    Math::real Flattening() const { return _f; }
+    ///@}
+
+    /**
+     * A global instantiation of EqualAreaGrid with the parameters for the
+     * WGS84 ellipsoid.
+     **********************************************************************/
+    static const EqualAreaGrid& WGS84();
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_EQUALAREAGRID_HPP
@@ -0,0 +1,250 @@
+/**
+ * \file Executor.hpp
+ * \brief Header for GeographicLib::Executor class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_EXECUTOR_HPP)
+#define GEOGRAPHICLIB_EXECUTOR_HPP 1
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <GeographicLib/Constants.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Run the tasks of the multithreaded batch routines
+   *
+   * The multithreaded routines of the library (e.g.,
+   * GeodesicExact::InverseBatch, the Geoid constructor, GravityModel::Grid,
+   * NearestNeighbor::Initialize, PointInPolygon::Contains, and
+   * PolygonAreaT::Rings) split their work into at most \e nthreads tasks
+   * and run these with Executor::Batch on the default executor, which
+   * decides which threads run the tasks.  The built-in default starts \e n
+   * &minus; 1 threads for each call to Run and joins them before returning;
+   * replace it with Executor::SetDefault to have the tasks run by a
+   * ThreadPool or by a threading system managed by the application, so that
+   * the library doesn't start any threads of its own.  FunctionExecutor
+   * adapts such a system, e.g., a TBB arena:
+   * \code
+   *   tbb::task_arena arena(8);
+   *   GeographicLib::FunctionExecutor tbbexec
+   *     ([&arena](int n, const std::function<void(int)>& task) -> void {
+   *        arena.execute([&]() -> void { tbb::parallel_for(0, n, task); });
+   *      }, arena.max_concurrency());
+   *   GeographicLib::Executor::SetDefault(&tbbexec);
+   * \endcode
+   * or OpenMP:
+   * \code
+   *   GeographicLib::FunctionExecutor ompexec
+   *     ([](int n, const std::function<void(int)>& task) -> void {
+   *   #pragma omp parallel for schedule(dynamic)
+   *        for (int i = 0; i < n; ++i) task(i);
+   *      }, omp_get_max_threads());
+   * \endcode
+   *
+   * The library calls Run via Executor::Batch which catches the exceptions
+   * thrown by the tasks and rethrows the first of these in the calling
+   * thread; so Run is never given a task which throws.  The tasks are
+   * independent of one another and Run may execute them in any order and
+   * with any degree of concurrency, including sequentially in the calling
+   * thread.  The \e nthreads argument of a batch routine bounds the number
+   * of tasks into which it splits its work; the routine uses the default
+   * executor regardless.
+   *
+   * Two facilities start threads which outlive the call starting them and
+   * so can't use an executor: Geoid::LoadAsync and the background merges in
+   * DynamicNearestNeighbor (these are avoided by not calling
+   * Geoid::LoadAsync and by setting \e bgsize to the maximum integer,
+   * respectively).
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT Executor {
+  public:
+    /**
+     * The destructor.
+     **********************************************************************/
+    virtual ~Executor() {}
+
+    /**
+     * Run a set of tasks.
+     *
+     * @param[in] n the number of tasks.
+     * @param[in] task the function to call with the arguments 0, 1, ...,
+     *   \e n &minus; 1.
+     *
+     * This returns when all the tasks have completed.  The tasks may be run
+     * concurrently and in any order.  If \e n &le; 0, this does nothing.
+     **********************************************************************/
+    virtual void Run(int n, const std::function<void(int)>& task) = 0;
+
+    /**
+     * @return the number of tasks that this executor can run at once.
+     **********************************************************************/
+    virtual int Concurrency() const = 0;
+
+    /**
+     * @return the executor used by the library's batch routines.
+     *
+     * This is the executor set by SetDefault or, if none has been set, an
+     * executor which starts \e n &minus; 1 threads for each call to Run and
+     * runs the first task in the calling thread.
+     **********************************************************************/
+    static Executor* Default();
+
+    /**
+     * Set the executor used by the library's batch routines.
+     *
+     * @param[in] executor a pointer to the executor; if this is null, the
+     *   built-in default is restored.
+     * @return the executor which was previously the default.
+     *
+     * The library doesn't take ownership of \e executor; it must remain in
+     * existence until it is replaced as the default and any batch routines
+     * using it have returned.
+     **********************************************************************/
+    static Executor* SetDefault(Executor* executor);
+
+    /**
+     * Run a set of tasks with the default executor.
+     *
+     * @param[in] n the number of tasks.
+     * @param[in] task the function to call with the arguments 0, 1, ...,
+     *   \e n &minus; 1.
+     *
+     * If \e n = 1, the task is run directly in the calling thread.
+     * Otherwise the tasks are passed to Default()->Run.  Any exception
+     * thrown by a task is caught and the first such exception (in the order
+     * of the task numbers) is rethrown when all the tasks have completed.
+     * This is how the library's batch routines run their tasks.
+     **********************************************************************/
+    static void Batch(int n, const std::function<void(int)>& task);
+  };
+
+  /**
+   * \brief A pool of threads for running the tasks of an Executor
+   *
+   * The worker threads are started by the constructor and are joined by the
+   * destructor.  Each call to Run queues a job; idle workers (and the
+   * thread which called Run) claim the tasks of the queued jobs one at a
+   * time in order, so that the tasks are balanced dynamically over the
+   * threads.  The first exception thrown by a task is rethrown by Run when
+   * all the tasks have completed.  Run may be called by several threads at
+   * once and may be called by the tasks themselves; since the calling
+   * thread runs any tasks of its job which haven't been claimed, this can't
+   * deadlock.
+   *
+   * Example of use:
+   * \code
+   *   GeographicLib::ThreadPool pool;
+   *   GeographicLib::Executor::SetDefault(&pool);
+   *   ... calls to the batch routines ...
+   *   GeographicLib::Executor::SetDefault(nullptr);
+   * \endcode
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT ThreadPool : public Executor {
+  private:
+    struct job {
+      const std::function<void(int)>* task;
+      int n, next, pending;
+      std::exception_ptr err;
+    };
+    std::vector<std::thread> _workers;
+    std::deque<job*> _jobs;
+    std::mutex _lock;
+    std::condition_variable _work, _done;
+    bool _stop;
+    // Claim the next task of the front job (with _lock held and the queue
+    // not empty)
+    void claim(job*& j, int& i);
+    void execute(job* j, int i);
+    void worker();
+    // Tell the workers to finish and join them
+    void stop();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+  public:
+    /**
+     * Constructor for ThreadPool.
+     *
+     * @param[in] nthreads the number of threads which run the tasks,
+     *   including the thread calling Run; 0 (the default) means the number
+     *   of threads supported by the hardware.
+     * @exception std::system_error if a thread can't be created.
+     *
+     * \e nthreads &minus; 1 worker threads are started.
+     **********************************************************************/
+    explicit ThreadPool(int nthreads = 0);
+
+    /**
+     * The destructor waits for the worker threads to finish their current
+     * tasks and joins them.  Run must not be active when the pool is
+     * destroyed.
+     **********************************************************************/
+    ~ThreadPool();
+
+    void Run(int n, const std::function<void(int)>& task) override;
+
+    int Concurrency() const override { return int(_workers.size()) + 1; }
+  };
+
+  /**
+   * \brief An Executor which calls a function supplied by the caller
+   *
+   * This adapts a threading system managed by the caller, such as TBB or
+   * OpenMP, for use as an Executor; see Executor for examples.
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT FunctionExecutor : public Executor {
+  public:
+    /**
+     * The type of the function which runs the tasks; it is called with the
+     * arguments of Executor::Run.
+     **********************************************************************/
+    typedef std::function<void(int, const std::function<void(int)>&)> runner;
+  private:
+    runner _run;
+    int _concurrency;
+  public:
+    /**
+     * Constructor for FunctionExecutor.
+     *
+     * @param[in] run the function which runs the tasks.
+     * @param[in] concurrency the number of tasks which \e run can run at
+     *   once.
+     **********************************************************************/
+    FunctionExecutor(const runner& run, int concurrency)
+      : _run(run)
+      , _concurrency(concurrency > 1 ? concurrency : 1)
+    {}
+
+    void Run(int n, const std::function<void(int)>& task) override {
+      if (n == 1)
+        task(0);
+      else if (n > 1)
+        _run(n, task);
+    }
+
+    int Concurrency() const override { return _concurrency; }
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_EXECUTOR_HPP
@@ -56,9 +56,22 @@ namespace GeographicLib {
       maxlen_ = baselen_ + maxprec_
     };
     GARS() = delete;            // Disable constructor
+    // The number of integer GARS with precision prec
+    static unsigned long long NumCodes(int prec) {
+      return 1ULL * mult1_ * mult1_ * Math::td * Math::hd *
+        (prec <= 0 ? 1 : (prec == 1 ? mult2_ * mult2_ :
+                          mult2_ * mult2_ * mult3_ * mult3_));
+    }
 
   public:
 
+    /**
+     * The maximum length of a GARS string (not counting the terminating
+     * null).  A char buffer of GARS::MAXLENGTH + 1 characters can hold any
+     * result returned by the char[] versions of GARS::Forward.
+     **********************************************************************/
+    enum { MAXLENGTH = maxlen_ };
+
     /**
      * Convert from geographic coordinates to GARS.
      *
@@ -79,6 +92,86 @@ namespace GeographicLib {
      **********************************************************************/
     static void Forward(real lat, real lon, int prec, std::string& gars);
 
+    /**
+     * Convert from geographic coordinates to GARS in a char buffer.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] prec the precision of the resulting GARS.
+     * @param[out] gars a buffer of at least GARS::MAXLENGTH + 1 characters
+     *   which receives the null-terminated GARS string.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @return the length of the GARS string.
+     *
+     * This is the same as the std::string version of GARS::Forward, except
+     * that no memory is allocated.
+     **********************************************************************/
+    static int Forward(real lat, real lon, int prec, char gars[]);
+
+    /**
+     * Convert many points from geographic coordinates to GARS in a char
+     *   buffer.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] prec the precision of the resulting GARS.
+     * @param[out] gars a char buffer of at least \e n &times; \e stride
+     *   characters; the null-terminated GARS string for point \e i starts at
+     *   \e gars + \e i &times; \e stride.
+     * @param[in] stride the spacing of the strings in \e gars.
+     * @exception GeographicErr if \e stride is less than GARS::MAXLENGTH + 1.
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;]; the results for the preceding points have then been stored.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[], int prec,
+                        char gars[], size_t stride);
+
+    /**
+     * Convert from geographic coordinates to an integer GARS.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] prec the precision of the GARS.
+     * @param[out] code the integer GARS.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     *
+     * The integer GARS packs the fields of the string GARS, most significant
+     * first: \e code = \e ilon &times; 360 + \e ilat, for \e prec = 0,
+     * where \e ilon in [0, 720) is one less than the number given by the
+     * first 3 digits and \e ilat in [0, 360) is the number given by the
+     * letters; for \e prec = 1 and 2, this is multiplied by 4 and 9 and one
+     * less than the 6th and 7th characters is added.  Thus 006AG39 is ((5
+     * &times; 360 + 6) &times; 4 + 2) &times; 9 + 8.  Internally, \e prec is
+     * first put in the range [0, 2].  Integer GARS with the same \e prec may
+     * be compared and sorted in the same way as the corresponding strings;
+     * they are less than 720 &times; 360 &times; 36 < 2<sup>24</sup>.
+     *
+     * If \e lat or \e lon is NaN, the returned \e code is ~0ULL (all bits
+     * set), which is not a legal code for any \e prec.
+     **********************************************************************/
+    static void Forward(real lat, real lon, int prec, unsigned long long& code);
+
+    /**
+     * Convert many points from geographic coordinates to integer GARS.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] prec the precision of the GARS.
+     * @param[out] code array of integer GARS.
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;]; the results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.  The
+     * points are processed in blocks with a loop without branches, which the
+     * compiler can vectorize.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[], int prec,
+                        unsigned long long code[]);
+
     /**
      * Convert from GARS to geographic coordinates.
      *
@@ -102,6 +195,42 @@ namespace GeographicLib {
     static void Reverse(const std::string& gars, real& lat, real& lon,
                         int& prec, bool centerp = true);
 
+    /**
+     * Convert from an integer GARS to geographic coordinates.
+     *
+     * @param[in] code the integer GARS.
+     * @param[in] prec the precision of the GARS.
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[in] centerp if true (the default) return the center of the
+     *   GARS, otherwise return the south-west corner.
+     * @exception GeographicErr if \e code is too large for \e prec.
+     *
+     * Internally, \e prec is first put in the range [0, 2].  If \e code is
+     * ~0ULL, then \e lat and \e lon are set to NaN.  The results are the same
+     * as those given by the string version of GARS::Reverse.
+     **********************************************************************/
+    static void Reverse(unsigned long long code, int prec,
+                        real& lat, real& lon, bool centerp = true);
+
+    /**
+     * Convert many integer GARS to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] code array of integer GARS.
+     * @param[in] prec the precision of the GARS.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[in] centerp if true (the default) return the centers of the
+     *   GARS, otherwise return the south-west corners.
+     * @exception GeographicErr if any \e code is too large for \e prec; the
+     *   results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.
+     **********************************************************************/
+    static void Reverse(size_t n, const unsigned long long code[], int prec,
+                        real lat[], real lon[], bool centerp = true);
+
     /**
      * The angular resolution of a GARS.
      *
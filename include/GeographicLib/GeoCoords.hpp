@@ -32,6 +32,14 @@ namespace GeographicLib {
    * The mutable state consists of the UTM or UPS coordinates for a alternate
    * zone.  A method SetAltZone is provided to set the alternate UPS/UTM zone.
    *
+   * If the position is given by latitude and longitude with the standard
+   * zone, the UTM/UPS projection is deferred until a method which needs it
+   * (e.g., Easting or MGRSRepresentation) is called.  Thus a bulk conversion
+   * from geographic coordinates to, e.g., DMSRepresentation does not pay for
+   * the projection.  Because this fills in the mutable state, a const
+   * GeoCoords object should not be accessed simultaneously from several
+   * threads (as is already the case with SetAltZone).
+   *
    * Methods are provided to return the geographic coordinates, the input UTM
    * or UPS coordinates (and associated meridian convergence and scale), or
    * alternate UTM or UPS coordinates (and their associated meridian
@@ -49,19 +57,31 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT GeoCoords {
   private:
     typedef Math::real real;
-    real _lat, _long, _easting, _northing, _gamma, _k;
+    real _lat, _long;
+    // The longitude as given, used for a deferred call to UTMUPS::Forward.
+    real _long0;
+    mutable real _easting, _northing, _gamma, _k;
     bool _northp;
     int _zone;                  // See UTMUPS::zonespec
     mutable real _alt_easting, _alt_northing, _alt_gamma, _alt_k;
     mutable int _alt_zone;
+    // Are the UTM/UPS coordinates, resp. the alternate coordinates, still to
+    // be computed?
+    mutable bool _utmpending, _altpending;
 
+    void UTMUPSSync() const { if (_utmpending) ComputeUTMUPS(); }
+    void AltSync() const { if (_altpending) { UTMUPSSync(); CopyToAlt(); } }
+    void ComputeUTMUPS() const;
     void CopyToAlt() const {
       _alt_easting = _easting;
       _alt_northing = _northing;
       _alt_gamma = _gamma;
       _alt_k = _k;
       _alt_zone = _zone;
+      _altpending = false;
     }
+    // Set _lat, _long, _zone, and _northp and defer the rest of the work
+    void SetLazy(real latitude, real longitude);
     static void UTMUPSString(int zone, bool northp,
                              real easting, real northing,
                              int prec, bool abbrev, std::string& utm);
@@ -77,12 +97,14 @@ namespace GeographicLib {
     GeoCoords()
       : _lat(Math::NaN())
       , _long(Math::NaN())
+      , _long0(Math::NaN())
       , _easting(Math::NaN())
       , _northing(Math::NaN())
       , _gamma(Math::NaN())
       , _k(Math::NaN())
       , _northp(false)
       , _zone(UTMUPS::INVALID)
+      , _utmpending(false)
     { CopyToAlt(); }
 
     /**
@@ -236,11 +258,17 @@ namespace GeographicLib {
      * @exception GeographicErr if \e zone cannot be used for this location.
      **********************************************************************/
     void Reset(real latitude, real longitude, int zone = UTMUPS::STANDARD) {
+      if (zone == UTMUPS::STANDARD) {
+        SetLazy(latitude, longitude);
+        _long = Math::AngNormalize(longitude);
+        return;
+      }
       UTMUPS::Forward(latitude, longitude,
                       _zone, _northp, _easting, _northing, _gamma, _k,
                       zone);
       _lat = latitude;
-      _long = Math::AngNormalize(longitude);
+      _long = _long0 = Math::AngNormalize(longitude);
+      _utmpending = false;
       CopyToAlt();
     }
 
@@ -258,10 +286,12 @@ namespace GeographicLib {
     void Reset(int zone, bool northp, real easting, real northing) {
       UTMUPS::Reverse(zone, northp, easting, northing,
                       _lat, _long, _gamma, _k);
+      _long0 = _long;
       _zone = zone;
       _northp = northp;
       _easting = easting;
       _northing = northing;
+      _utmpending = false;
       FixHemisphere();
       CopyToAlt();
     }
@@ -283,22 +313,22 @@ namespace GeographicLib {
     /**
      * @return easting (meters)
      **********************************************************************/
-    Math::real Easting() const { return _easting; }
+    Math::real Easting() const { UTMUPSSync(); return _easting; }
 
     /**
      * @return northing (meters)
      **********************************************************************/
-    Math::real Northing() const { return _northing; }
+    Math::real Northing() const { UTMUPSSync(); return _northing; }
 
     /**
      * @return meridian convergence (degrees) for the UTM/UPS projection.
      **********************************************************************/
-    Math::real Convergence() const { return _gamma; }
+    Math::real Convergence() const { UTMUPSSync(); return _gamma; }
 
     /**
      * @return scale for the UTM/UPS projection.
      **********************************************************************/
-    Math::real Scale() const { return _k; }
+    Math::real Scale() const { UTMUPSSync(); return _k; }
 
     /**
      * @return hemisphere (false means south, true means north).
@@ -337,40 +367,41 @@ namespace GeographicLib {
         return;
       zone = UTMUPS::StandardZone(_lat, _long, zone);
       if (zone == _zone)
-        CopyToAlt();
+        _altpending = true;
       else {
         bool northp;
         UTMUPS::Forward(_lat, _long,
                         _alt_zone, northp,
                         _alt_easting, _alt_northing, _alt_gamma, _alt_k,
                         zone);
+        _altpending = false;
       }
     }
 
     /**
      * @return current alternate zone (return 0 for UPS).
      **********************************************************************/
-    int AltZone() const { return _alt_zone; }
+    int AltZone() const { return _altpending ? _zone : _alt_zone; }
 
     /**
      * @return easting (meters) for alternate zone.
      **********************************************************************/
-    Math::real AltEasting() const { return _alt_easting; }
+    Math::real AltEasting() const { AltSync(); return _alt_easting; }
 
     /**
      * @return northing (meters) for alternate zone.
      **********************************************************************/
-    Math::real AltNorthing() const { return _alt_northing; }
+    Math::real AltNorthing() const { AltSync(); return _alt_northing; }
 
     /**
      * @return meridian convergence (degrees) for alternate zone.
      **********************************************************************/
-    Math::real AltConvergence() const { return _alt_gamma; }
+    Math::real AltConvergence() const { AltSync(); return _alt_gamma; }
 
     /**
      * @return scale for alternate zone.
      **********************************************************************/
-    Math::real AltScale() const { return _alt_k; }
+    Math::real AltScale() const { AltSync(); return _alt_k; }
     ///@}
 
     /** \name String representations of the GeoCoords object
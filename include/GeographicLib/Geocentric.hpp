@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedArray.hpp>
 
 namespace GeographicLib {
 
@@ -98,6 +99,11 @@ namespace GeographicLib {
                     real M[dim2_]) const;
     void IntReverse(real X, real Y, real Z, real& lat, real& lon, real& h,
                     real M[dim2_]) const;
+    // The number of points handled together by the batch version of Reverse
+    static const int blocksize_ = 8;
+    template<int n>
+    void ReverseBlock(const real X[], const real Y[], const real Z[],
+                      real lat[], real lon[], real h[], real M[]) const;
 
   public:
 
@@ -234,6 +240,102 @@ namespace GeographicLib {
         IntReverse(X, Y, Z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert many points from geodetic to geocentric coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] h array of heights of the points above the ellipsoid
+     *   (meters).
+     * @param[out] X array of geocentric coordinates (meters).
+     * @param[out] Y array of geocentric coordinates (meters).
+     * @param[out] Z array of geocentric coordinates (meters).
+     * @param[out] M array of 9 \e n elements which receives the rotation
+     *   matrices (each in row-major order); this may be null.
+     *
+     * The arrays \e lat, \e lon, \e h, \e X, \e Y, and \e Z hold \e n
+     * elements.  The results are identical to those returned by \e n calls
+     * to Geocentric::Forward.
+     **********************************************************************/
+    void Forward(size_t n, const real lat[], const real lon[], const real h[],
+                 real X[], real Y[], real Z[], real M[] = nullptr) const;
+
+    /**
+     * Convert many points from geocentric to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the points above the ellipsoid
+     *   (meters).
+     * @param[out] M array of 9 \e n elements which receives the rotation
+     *   matrices (each in row-major order); this may be null.
+     *
+     * The arrays \e X, \e Y, \e Z, \e lat, \e lon, and \e h hold \e n
+     * elements.  For an oblate ellipsoid, the points are processed in small
+     * blocks.  Within a block, the common case of a point outside the evolute
+     * of the ellipsoid (this includes all points more than about 43 km from
+     * the center of the earth for WGS84) is computed without branches and
+     * with sqrt in place of hypot; the remaining points are handled by the
+     * general algorithm used by Geocentric::Reverse.  The results agree with
+     * Geocentric::Reverse to within a few ulps.  For spheres and prolate
+     * ellipsoids, this is equivalent to calling Geocentric::Reverse for each
+     * point.
+     **********************************************************************/
+    void Reverse(size_t n, const real X[], const real Y[], const real Z[],
+                 real lat[], real lon[], real h[], real M[] = nullptr) const;
+
+    /**
+     * Convert many points from geodetic to geocentric coordinates given
+     * strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[in] h strided array of heights of the points above the
+     *   ellipsoid (meters).
+     * @param[out] X strided array of geocentric coordinates (meters).
+     * @param[out] Y strided array of geocentric coordinates (meters).
+     * @param[out] Z strided array of geocentric coordinates (meters).
+     *
+     * This is the same as the previous version of Geocentric::Forward
+     * (without the rotation matrices) except that the elements of each
+     * array are StridedArray::stride() bytes apart.  The outputs may
+     * overlay the inputs, e.g., to convert the coordinates of an array of
+     * records in place.
+     **********************************************************************/
+    void Forward(size_t n, StridedArray<const real> lat,
+                 StridedArray<const real> lon, StridedArray<const real> h,
+                 StridedArray<real> X, StridedArray<real> Y,
+                 StridedArray<real> Z) const;
+
+    /**
+     * Convert many points from geocentric to geodetic coordinates given
+     * strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X strided array of geocentric coordinates (meters).
+     * @param[in] Y strided array of geocentric coordinates (meters).
+     * @param[in] Z strided array of geocentric coordinates (meters).
+     * @param[out] lat strided array of latitudes of the points (degrees).
+     * @param[out] lon strided array of longitudes of the points (degrees).
+     * @param[out] h strided array of heights of the points above the
+     *   ellipsoid (meters).
+     *
+     * This gives the same results as the previous version of
+     * Geocentric::Reverse (without the rotation matrices); each block of
+     * points is copied to contiguous arrays.  The outputs may overlay the
+     * inputs.
+     **********************************************************************/
+    void Reverse(size_t n, StridedArray<const real> X,
+                 StridedArray<const real> Y, StridedArray<const real> Z,
+                 StridedArray<real> lat, StridedArray<real> lon,
+                 StridedArray<real> h) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
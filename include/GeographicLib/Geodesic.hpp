@@ -11,12 +11,18 @@
 #define GEOGRAPHICLIB_GEODESIC_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedArray.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
 
 #if !defined(GEOGRAPHICLIB_GEODESIC_ORDER)
 /**
  * The order of the expansions used by Geodesic.
- * GEOGRAPHICLIB_GEODESIC_ORDER can be set to any integer in [3, 8].
+ * GEOGRAPHICLIB_GEODESIC_ORDER can be set to any integer in [3, 8].  The
+ * default depends on GEOGRAPHICLIB_PRECISION, e.g., 3 for floats and 6 for
+ * doubles.  This determines the layout of the Geodesic class, so it must be
+ * the same when compiling the library and client code; with cmake builds
+ * this is ensured by setting the cmake variable
+ * GEOGRAPHICLIB_GEODESIC_ORDER which records the value in Config.h.
  **********************************************************************/
 #  define GEOGRAPHICLIB_GEODESIC_ORDER \
   (GEOGRAPHICLIB_PRECISION == 2 ? 6 : \
@@ -27,6 +33,8 @@
 namespace GeographicLib {
 
   class GeodesicLine;
+  class GeodesicOrigin;
+  class GeodesicStart;
 
   /**
    * \brief %Geodesic calculations
@@ -176,6 +184,9 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
     friend class GeodesicLine;
+    friend class GeodesicMatrix;
+    friend class GeodesicOrigin;
+    friend class GeodesicStart;
     static const int nA1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
     static const int nC1_ = GEOGRAPHICLIB_GEODESIC_ORDER;
     static const int nC1p_ = GEOGRAPHICLIB_GEODESIC_ORDER;
@@ -229,17 +240,45 @@ namespace GeographicLib {
                       real& salp1, real& calp1,
                       real& salp2, real& calp2, real& dnm,
                       real Ca[]) const;
-    real Lambda12(real sbet1, real cbet1, real dn1,
-                  real sbet2, real cbet2, real dn2,
+    real Lambda12(real sbet1, real cbet1, real sbet2, real cbet2,
                   real salp1, real calp1, real slam120, real clam120,
                   real& salp2, real& calp2, real& sig12,
                   real& ssig1, real& csig1, real& ssig2, real& csig2,
-                  real& eps, real& domg12,
-                  bool diffp, real& dlam12, real Ca[]) const;
+                  real& eps, real& domg12, real Ca[]) const;
+    // The derivative of Lambda12 with respect to alp1 given some of the
+    // values computed by Lambda12.
+    real dLambda12(real sbet1, real cbet1, real dn1, real cbet2, real dn2,
+                   real calp2, real sig12,
+                   real ssig1, real csig1, real ssig2, real csig2,
+                   real eps, real Ca[]) const;
     real GenInverse(real lat1, real lon1, real lat2, real lon2,
                     unsigned outmask, real& s12,
                     real& salp1, real& calp1, real& salp2, real& calp2,
                     real& m12, real& M12, real& M21, real& S12) const;
+    // The parts of the inverse calculation depending only on the latitude of
+    // a point; lat is replaced by its rounded value.  IntInverse is
+    // GenInverse (for _exact = false) with these precomputed.  If warm, then
+    // salp1, calp1, salp2, calp2 are also inputs giving a starting guess.
+    // Otherwise, if start is not null, it corrects the starting guess given
+    // by InverseStart.
+    void InversePoint(real& lat, real& sbet, real& cbet, real& dn) const;
+    real IntInverse(real lat1, real sbet1, real cbet1, real dn1, real lon1,
+                    real lat2, real sbet2, real cbet2, real dn2, real lon2,
+                    unsigned outmask, real& s12,
+                    real& salp1, real& calp1, real& salp2, real& calp2,
+                    real& m12, real& M12, real& M21, real& S12,
+                    bool warm = false,
+                    const GeodesicStart* start = nullptr) const;
+    // The body of IntInverse.  If fixedp, outmask is replaced by fixedmask
+    // so that the compiler can drop the calculations which aren't needed;
+    // IntInverse dispatches the common cases to these specializations.
+    template<bool fixedp, unsigned fixedmask>
+    real IntInverseT(real lat1, real sbet1, real cbet1, real dn1, real lon1,
+                     real lat2, real sbet2, real cbet2, real dn2, real lon2,
+                     unsigned outmask, real& s12,
+                     real& salp1, real& calp1, real& salp2, real& calp2,
+                     real& m12, real& M12, real& M21, real& S12,
+                     bool warm, const GeodesicStart* start) const;
 
     // These are Maxima generated functions to provide series approximations to
     // the integrals for the ellipsoidal geodesic.
@@ -650,6 +689,104 @@ namespace GeographicLib {
                          real& S12) const;
     ///@}
 
+    /** \name Batch version of direct geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve many direct geodesic problems with a single call.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) if \e arcmode is false
+     *   or arc lengths (degrees) if \e arcmode is true.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The input arrays each hold \e n elements.  The meaning of \e arcmode
+     * and \e outmask is the same as for Geodesic::GenDirect.  Each output
+     * array selected by \e outmask must hold \e n elements; the output
+     * arrays which are not selected are not referenced and may be null.  The
+     * arc lengths are stored in \e a12 provided it is not null.  The results
+     * are identical to those returned by \e n calls to Geodesic::GenDirect.
+     *
+     * Geodesic::GenDirect constructs a GeodesicLine for each problem; here a
+     * single GeodesicLine is reinitialized for each problem, which avoids
+     * the cost of constructing and destroying the object, and the
+     * capabilities are determined once for the batch.  If consecutive
+     * problems have the same \e lat1, \e lon1, and \e azi1 (e.g., when
+     * sampling points along rays from a set of origins), the GeodesicLine is
+     * reused; this roughly halves the cost of each such problem.  If the
+     * exact algorithms are used, this calls GeodesicExact::DirectBatch.  If
+     * \e nthreads > 1, the problems are handed out in chunks to that many
+     * tasks which are run with Executor::Batch.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const real lat1[], const real lon1[], const real azi1[],
+                     bool arcmode, const real s12_a12[], unsigned outmask,
+                     real lat2[], real lon2[], real azi2[],
+                     real s12[], real m12[], real M12[], real M21[],
+                     real S12[], real a12[] = nullptr, int nthreads = 1) const;
+
+    /**
+     * Solve many direct geodesic problems given strided arrays.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 strided array of latitudes of point 1 (degrees).
+     * @param[in] lon1 strided array of longitudes of point 1 (degrees).
+     * @param[in] azi1 strided array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 strided array of distances (meters) or arc lengths
+     *   (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 strided array of latitudes of point 2 (degrees).
+     * @param[out] lon2 strided array of longitudes of point 2 (degrees).
+     * @param[out] azi2 strided array of azimuths at point 2 (degrees).
+     * @param[out] s12 strided array of distances (meters).
+     * @param[out] m12 strided array of reduced lengths (meters).
+     * @param[out] M12 strided array of geodesic scales of point 2 relative
+     *   to point 1.
+     * @param[out] M21 strided array of geodesic scales of point 1 relative
+     *   to point 2.
+     * @param[out] S12 strided array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 strided array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the same as the previous function except that the elements of
+     * each array are StridedArray::stride() bytes apart, so that the fields
+     * of an array of records can be used directly.  The outputs must not
+     * overlay the inputs.
+     **********************************************************************/
+    void DirectBatch(size_t n, StridedArray<const real> lat1,
+                     StridedArray<const real> lon1,
+                     StridedArray<const real> azi1,
+                     bool arcmode, StridedArray<const real> s12_a12,
+                     unsigned outmask,
+                     StridedArray<real> lat2, StridedArray<real> lon2,
+                     StridedArray<real> azi2, StridedArray<real> s12,
+                     StridedArray<real> m12, StridedArray<real> M12,
+                     StridedArray<real> M21, StridedArray<real> S12,
+                     StridedArray<real> a12 = nullptr, int nthreads = 1)
+      const;
+    ///@}
+
     /** \name Inverse geodesic problem.
      **********************************************************************/
     ///@{
@@ -811,6 +948,242 @@ namespace GeographicLib {
                           real& m12, real& M12, real& M21, real& S12) const;
     ///@}
 
+    /** \name Inverse geodesic solution with a starting guess.
+     **********************************************************************/
+    ///@{
+    /**
+     * The general inverse geodesic calculation starting from the solution of
+     * a nearby problem.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[in,out] azi1 on input, the azimuth at point 1 for a nearby
+     *   problem; on output, the azimuth at point 1 (degrees).
+     * @param[in,out] azi2 on input, the (forward) azimuth at point 2 for a
+     *   nearby problem; on output, the (forward) azimuth at point 2
+     *   (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This is the same as Geodesic::GenInverse, except that the azimuths
+     * returned by a previous call for nearby points are used as the starting
+     * guess in the solution of the inverse problem.  The azimuths are always
+     * returned (regardless of \e outmask) so that a series of calls for a
+     * slowly varying pair of points, e.g., consecutive samples on a track,
+     * can chain the azimuths.  This typically saves one or two iterations of
+     * Newton's method.  A poor guess is harmless, because the root is
+     * bracketed in the iteration; however, for the first call of a series,
+     * use Geodesic::GenInverse to obtain the azimuths.
+     *
+     * The results agree with Geodesic::GenInverse to within roundoff.  The
+     * starting guess is not used for geodesics which are very short (less
+     * than about 0.2 m for WGS84) or which lie along a meridian or along the
+     * equator; in these cases, no iteration is needed.  It is also
+     * ignored if the Geodesic object was constructed with \e exact = true.
+     **********************************************************************/
+    Math::real WarmInverse(real lat1, real lon1, real lat2, real lon2,
+                           unsigned outmask,
+                           real& s12, real& azi1, real& azi2,
+                           real& m12, real& M12, real& M21, real& S12) const;
+    ///@}
+
+    /** \name Batch version of inverse geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve many inverse geodesic problems with a single call.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The input arrays each hold \e n elements, problem \e i being from
+     * (<i>lat1</i>[<i>i</i>], <i>lon1</i>[<i>i</i>]) to
+     * (<i>lat2</i>[<i>i</i>], <i>lon2</i>[<i>i</i>]).  The meaning of \e
+     * outmask is the same as for Geodesic::GenInverse.  Each output array
+     * selected by \e outmask must hold \e n elements; the output arrays
+     * which are not selected are not referenced and may be null.  The arc
+     * lengths are stored in \e a12 provided it is not null.  The results
+     * are identical to those returned by \e n calls to
+     * Geodesic::GenInverse.
+     *
+     * This saves the overhead of the overloaded Geodesic::Inverse wrappers
+     * and of sorting out the outmask for each problem.  If \e nthreads > 1,
+     * the problems are handed out in chunks to that many tasks which are run
+     * with Executor::Batch; the results don't depend on \e nthreads.  This
+     * allows large offline computations, e.g., the distances between all
+     * pairs of a set of sites, to use all the cores of a machine (or the
+     * threads of an application's Executor).
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real s12[], real azi1[], real azi2[],
+                      real m12[], real M12[], real M21[], real S12[],
+                      real a12[] = nullptr, int nthreads = 1) const;
+
+    /**
+     * Solve many inverse geodesic problems given strided arrays.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 strided array of latitudes of point 1 (degrees).
+     * @param[in] lon1 strided array of longitudes of point 1 (degrees).
+     * @param[in] lat2 strided array of latitudes of point 2 (degrees).
+     * @param[in] lon2 strided array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 strided array of distances (meters).
+     * @param[out] azi1 strided array of azimuths at point 1 (degrees).
+     * @param[out] azi2 strided array of azimuths at point 2 (degrees).
+     * @param[out] m12 strided array of reduced lengths (meters).
+     * @param[out] M12 strided array of geodesic scales of point 2 relative
+     *   to point 1.
+     * @param[out] M21 strided array of geodesic scales of point 1 relative
+     *   to point 2.
+     * @param[out] S12 strided array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 strided array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the same as the previous function except that the elements of
+     * each array are StridedArray::stride() bytes apart.  Each problem's
+     * outputs are written after its inputs are read; so the outputs may
+     * overlay the inputs.
+     **********************************************************************/
+    void InverseBatch(size_t n, StridedArray<const real> lat1,
+                      StridedArray<const real> lon1,
+                      StridedArray<const real> lat2,
+                      StridedArray<const real> lon2,
+                      unsigned outmask,
+                      StridedArray<real> s12, StridedArray<real> azi1,
+                      StridedArray<real> azi2, StridedArray<real> m12,
+                      StridedArray<real> M12, StridedArray<real> M21,
+                      StridedArray<real> S12,
+                      StridedArray<real> a12 = nullptr, int nthreads = 1)
+      const;
+    ///@}
+
+    /** \name Bounds on the geodesic distance.
+     **********************************************************************/
+    ///@{
+    /**
+     * Cheap lower and upper bounds on the length of the shortest geodesic.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12min a lower bound on the distance between point 1 and
+     *   point 2 (meters).
+     * @param[out] s12max an upper bound on the distance between point 1 and
+     *   point 2 (meters).
+     *
+     * The ellipsoid is the image of a unit sphere under the linear map which
+     * scales the equatorial plane by \e a and the axis by \e b; the point at
+     * latitude &phi; on the ellipsoid is the image of the point at the
+     * reduced latitude &beta; on the sphere.  The scale of this map lies
+     * between min(\e a, \e b) and max(\e a, \e b), so the geodesic distance
+     * is bounded by these radii times the great-circle distance between the
+     * two points on the sphere.  The bounds are widened slightly to allow for
+     * roundoff in the solution of the inverse problem, so that \e s12min
+     * &le; \e s12 &le; \e s12max holds for the distance \e s12 returned by
+     * Geodesic::Inverse.  The width of the interval is about |\e f| \e s12,
+     * and computing the bounds costs about as much as a single evaluation of
+     * a spherical distance, i.e., much less than Geodesic::Inverse.  The
+     * bounds are suitable for pruning a search, e.g., using the overload of
+     * NearestNeighbor::Search which accepts a bounds function.
+     **********************************************************************/
+    void DistanceBounds(real lat1, real lon1, real lat2, real lon2,
+                        real& s12min, real& s12max) const;
+    ///@}
+
+    /** \name Approximate geodesic distance.
+     **********************************************************************/
+    ///@{
+    /**
+     * An approximate distance using the Andoyer-Lambert formula.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @return an approximation to the distance between point 1 and point 2
+     *   (meters).
+     *
+     * This is Lambert's closed-form correction to the great-circle distance
+     * between the points on the auxiliary sphere which is accurate to first
+     * order in \e f; see H. S. Andoyer, Formule donnant la longueur de la
+     * g&eacute;od&eacute;sique, Bull. G&eacute;od. 5, 364 (1932) and W. M.
+     * Lambert, The distance between two widely separated points on the
+     * surface of the earth, J. Wash. Acad. Sci. 32, 125 (1942).  There's no
+     * iteration and no data dependent branching and the cost is roughly a
+     * tenth of that of Geodesic::Inverse.  For the WGS84 ellipsoid, the
+     * error, estimated by comparing with Geodesic::Inverse for random
+     * pairs of points, is less than
+     * - 1.5 m for distances up to 1000 km,
+     * - 7 m for distances up to 5000 km,
+     * - 14 m for distances up to 10000 km,
+     * - 60 m for distances up to 15000 km;
+     * .
+     * and the relative error for short distances is less than 1.5
+     * &times; 10<sup>&minus;6</sup>.  The formula breaks down for nearly
+     * antipodal points (where the shortest geodesic isn't close to the
+     * great circle on the auxiliary sphere) and the error can then be tens
+     * of kilometers.  The errors scale as <i>f</i><sup>2</sup>.  This is
+     * suitable for ranking candidates, e.g., before computing accurate
+     * distances for the nearest few with Geodesic::Inverse.
+     **********************************************************************/
+    Math::real DistanceApprox(real lat1, real lon1, real lat2, real lon2)
+      const;
+
+    /**
+     * Many approximate distances with a single call.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] s12 array of approximate distances (meters).
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to Geodesic::DistanceApprox.  The loop contains
+     * no branches, so that, apart from the calls to Math::sincosd, it can be
+     * vectorized by the compiler.  \e s12 may overlay one of the inputs.
+     **********************************************************************/
+    void DistanceApproxBatch(size_t n,
+                             const real lat1[], const real lon1[],
+                             const real lat2[], const real lon2[],
+                             real s12[]) const;
+    ///@}
+
     /** \name Interface to GeodesicLine.
      **********************************************************************/
     ///@{
@@ -954,6 +1327,24 @@ namespace GeographicLib {
                                unsigned caps = ALL) const;
     ///@}
 
+    /** \name Interface to GeodesicOrigin.
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Set up to solve inverse problems starting at a fixed point.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @return a GeodesicOrigin object.
+     *
+     * This is useful for solving the inverse problem between one point and
+     * many others; see GeodesicOrigin for details.  \e lat1 should be in the
+     * range [&minus;90&deg;, 90&deg;].
+     **********************************************************************/
+    GeodesicOrigin Origin(real lat1, real lon1) const;
+    ///@}
+
     /** \name Inspector functions.
      **********************************************************************/
     ///@{
@@ -989,9 +1380,32 @@ namespace GeographicLib {
     /**
      * A global instantiation of Geodesic with the parameters for the WGS84
      * ellipsoid.
+     *
+     * \see Constants for the cost of the first and subsequent calls.
      **********************************************************************/
     static const Geodesic& WGS84();
 
+    /**
+     * A shared instantiation of Geodesic for an arbitrary ellipsoid.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @param[in] exact if true use exact formulation (default false).
+     * @exception GeographicErr if the constructor throws an exception.
+     * @return a reference to the shared instance with these parameters.
+     *
+     * The instance is constructed the first time this function is called
+     * with a particular set of parameters and is returned by subsequent
+     * calls with the same parameters; it persists until the end of the
+     * program.  Thus a program using several ellipsoids need not construct
+     * a new Geodesic (computing its coefficients) for each calculation.  This
+     * is thread safe and, once the instance has been constructed, a lookup
+     * doesn't take a lock; see Registry for details.  However the lookup
+     * searches linearly through the instances constructed so far, so this
+     * is intended for a modest number of distinct ellipsoids.
+     **********************************************************************/
+    static const Geodesic& Get(real a, real f, bool exact = false);
+
   };
 
 } // namespace GeographicLib
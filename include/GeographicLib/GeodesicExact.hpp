@@ -11,8 +11,10 @@
 #define GEOGRAPHICLIB_GEODESICEXACT_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedArray.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
 #include <GeographicLib/DST.hpp>
+#include <vector>
 
 namespace GeographicLib {
 
@@ -90,6 +92,8 @@ namespace GeographicLib {
     GeodesicExact() {};         // Do nothing; used with exact = false.
 
     static const unsigned maxit1_ = 20;
+    // The smallest transform used by C4coeffs
+    static const int nC4min_ = 24;
     unsigned maxit2_;
     real tiny_, tol0_, tol1_, tol2_, tolb_, xthresh_;
 
@@ -111,6 +115,9 @@ namespace GeographicLib {
     real _a, _f, _f1, _e2, _ep2, _n, _b, _c2, _etol2;
     int _nC4;
     DST _fft;
+    // For large |n|, a ladder of DSTs with _nC4/2^k points (in increasing
+    // order) used by C4coeffs to refine the transform only as far as needed.
+    std::vector<DST> _fftx;
 
     void Lengths(const EllipticFunction& E,
                  real sig12,
@@ -130,13 +137,22 @@ namespace GeographicLib {
                   real salp1, real calp1, real slam120, real clam120,
                   real& salp2, real& calp2, real& sig12,
                   real& ssig1, real& csig1, real& ssig2, real& csig2,
-                  EllipticFunction& E,
-                  real& domg12, bool diffp, real& dlam12) const;
+                  EllipticFunction& E, real& domg12) const;
+    // The derivative of Lambda12 with respect to alp1 given some of the
+    // values computed by Lambda12.
+    real dLambda12(real sbet1, real cbet1, real dn1, real cbet2, real dn2,
+                   real calp2, real sig12,
+                   real ssig1, real csig1, real ssig2, real csig2,
+                   const EllipticFunction& E) const;
     real GenInverse(real lat1, real lon1, real lat2, real lon2,
                     unsigned outmask, real& s12,
                     real& salp1, real& calp1, real& salp2, real& calp2,
                     real& m12, real& M12, real& M21, real& S12) const;
 
+    // Set C4a to the Fourier coefficients of I4 for k2 and return their
+    // number, at most _nC4.  work has at least _fft.WorkSize() elements.
+    int C4coeffs(real k2, real C4a[], real work[]) const;
+
     class I4Integrand {
     private:
       real X, tX, tdX, sX, sX1, sXX1, asinhsX, _k2;
@@ -698,6 +714,188 @@ namespace GeographicLib {
                           real& m12, real& M12, real& M21, real& S12) const;
     ///@}
 
+    /** \name Batch version of direct geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve many direct geodesic problems with a single call.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] azi1 array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 array of distances (meters) if \e arcmode is false
+     *   or arc lengths (degrees) if \e arcmode is true.
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes of point 2 (degrees).
+     * @param[out] lon2 array of longitudes of point 2 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] s12 array of distances (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the analog of Geodesic::DirectBatch.  The input arrays each
+     * hold \e n elements; the output arrays selected by \e outmask must hold
+     * \e n elements and the others may be null.  The arc lengths are stored
+     * in \e a12 provided it is not null.  The results are identical to those
+     * returned by \e n calls to GeodesicExact::GenDirect.
+     *
+     * Each task reinitializes a single GeodesicLineExact for its problems.
+     * If consecutive problems have the same \e lat1, \e lon1, and \e azi1,
+     * the line is reused.  Otherwise, if they have the same value of
+     * <i>k</i><sup>2</sup> =
+     * <i>e</i>'<sup>2</sup> cos<sup>2</sup>&alpha;<sub>0</sub> (e.g., rays
+     * with the same azimuth from points on a parallel), the complete
+     * elliptic integrals and the coefficients of the area integral (found
+     * with a discrete sine transform) are reused; these dominate the cost of
+     * setting up the line.  If \e nthreads > 1, the problems are handed out
+     * in chunks to that many tasks which are run with Executor::Batch.
+     **********************************************************************/
+    void DirectBatch(size_t n,
+                     const real lat1[], const real lon1[], const real azi1[],
+                     bool arcmode, const real s12_a12[], unsigned outmask,
+                     real lat2[], real lon2[], real azi2[],
+                     real s12[], real m12[], real M12[], real M21[],
+                     real S12[], real a12[] = nullptr, int nthreads = 1) const;
+
+    /**
+     * Solve many direct geodesic problems given strided arrays.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 strided array of latitudes of point 1 (degrees).
+     * @param[in] lon1 strided array of longitudes of point 1 (degrees).
+     * @param[in] azi1 strided array of azimuths at point 1 (degrees).
+     * @param[in] arcmode boolean flag determining the meaning of \e s12_a12.
+     * @param[in] s12_a12 strided array of distances (meters) or arc lengths
+     *   (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 strided array of latitudes of point 2 (degrees).
+     * @param[out] lon2 strided array of longitudes of point 2 (degrees).
+     * @param[out] azi2 strided array of azimuths at point 2 (degrees).
+     * @param[out] s12 strided array of distances (meters).
+     * @param[out] m12 strided array of reduced lengths (meters).
+     * @param[out] M12 strided array of geodesic scales of point 2 relative
+     *   to point 1.
+     * @param[out] M21 strided array of geodesic scales of point 1 relative
+     *   to point 2.
+     * @param[out] S12 strided array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 strided array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the same as the previous function except that the elements of
+     * each array are StridedArray::stride() bytes apart, so that the fields
+     * of an array of records can be used directly.  The outputs must not
+     * overlay the inputs.
+     **********************************************************************/
+    void DirectBatch(size_t n, StridedArray<const real> lat1,
+                     StridedArray<const real> lon1,
+                     StridedArray<const real> azi1,
+                     bool arcmode, StridedArray<const real> s12_a12,
+                     unsigned outmask,
+                     StridedArray<real> lat2, StridedArray<real> lon2,
+                     StridedArray<real> azi2, StridedArray<real> s12,
+                     StridedArray<real> m12, StridedArray<real> M12,
+                     StridedArray<real> M21, StridedArray<real> S12,
+                     StridedArray<real> a12 = nullptr, int nthreads = 1)
+      const;
+    ///@}
+
+    /** \name Batch version of inverse geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve many inverse geodesic problems with a single call.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 array of latitudes of point 1 (degrees).
+     * @param[in] lon1 array of longitudes of point 1 (degrees).
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the analog of Geodesic::InverseBatch.  The input arrays each
+     * hold \e n elements; the output arrays selected by \e outmask must hold
+     * \e n elements and the others may be null.  The arc lengths are stored
+     * in \e a12 provided it is not null.  The results are identical to those
+     * returned by \e n calls to GeodesicExact::GenInverse.
+     *
+     * The problems are divided among \e nthreads threads.  These share the
+     * discrete sine transforms set up by the constructor for the area
+     * calculation, which is the most expensive part of the calculation for
+     * ellipsoids with large flattening.
+     **********************************************************************/
+    void InverseBatch(size_t n,
+                      const real lat1[], const real lon1[],
+                      const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real s12[], real azi1[], real azi2[],
+                      real m12[], real M12[], real M21[], real S12[],
+                      real a12[] = nullptr, int nthreads = 1) const;
+
+    /**
+     * Solve many inverse geodesic problems given strided arrays.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat1 strided array of latitudes of point 1 (degrees).
+     * @param[in] lon1 strided array of longitudes of point 1 (degrees).
+     * @param[in] lat2 strided array of latitudes of point 2 (degrees).
+     * @param[in] lon2 strided array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of GeodesicExact::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 strided array of distances (meters).
+     * @param[out] azi1 strided array of azimuths at point 1 (degrees).
+     * @param[out] azi2 strided array of azimuths at point 2 (degrees).
+     * @param[out] m12 strided array of reduced lengths (meters).
+     * @param[out] M12 strided array of geodesic scales of point 2 relative
+     *   to point 1.
+     * @param[out] M21 strided array of geodesic scales of point 1 relative
+     *   to point 2.
+     * @param[out] S12 strided array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 strided array of arc lengths (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is the same as the previous function except that the elements of
+     * each array are StridedArray::stride() bytes apart.  Each problem's
+     * outputs are written after its inputs are read; so the outputs may
+     * overlay the inputs.
+     **********************************************************************/
+    void InverseBatch(size_t n, StridedArray<const real> lat1,
+                      StridedArray<const real> lon1,
+                      StridedArray<const real> lat2,
+                      StridedArray<const real> lon2,
+                      unsigned outmask,
+                      StridedArray<real> s12, StridedArray<real> azi1,
+                      StridedArray<real> azi2, StridedArray<real> m12,
+                      StridedArray<real> M12, StridedArray<real> M21,
+                      StridedArray<real> S12,
+                      StridedArray<real> a12 = nullptr, int nthreads = 1) const;
+    ///@}
+
     /** \name Interface to GeodesicLineExact.
      **********************************************************************/
     ///@{
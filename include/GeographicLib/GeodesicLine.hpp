@@ -10,6 +10,7 @@
 #if !defined(GEOGRAPHICLIB_GEODESICLINE_HPP)
 #define GEOGRAPHICLIB_GEODESICLINE_HPP 1
 
+#include <vector>
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicLineExact.hpp>
@@ -103,6 +104,16 @@ namespace GeographicLib {
                  real lat1, real lon1,
                  real azi1, real salp1, real calp1,
                  unsigned caps, bool arcmode, real s13_a13);
+    // GenPosition with the sine and cosine of a12 (if arcmode) or tau12 (if
+    // not) supplied as s and c.
+    Math::real IntPosition(bool arcmode, real s12_a12, real s, real c,
+                           unsigned outmask,
+                           real& lat2, real& lon2, real& azi2,
+                           real& s12, real& m12, real& M12, real& M21,
+                           real& S12) const;
+    // Element i of an output array, or t if the array is null.
+    static real& Slot(real a[], size_t i, real& t)
+    { return a ? a[i] : t; }
 
     enum captype {
       CAP_NONE = Geodesic::CAP_NONE,
@@ -252,6 +263,88 @@ namespace GeographicLib {
     GeodesicLine() : _caps(0U) {}
     ///@}
 
+    /** \name Compact representation
+     **********************************************************************/
+    ///@{
+
+    /**
+     * \brief A compact representation of a GeodesicLine
+     *
+     * A GeodesicLine holds the coefficients of the series for the requested
+     * capabilities together with many derived quantities; this takes over a
+     * kilobyte.  A Compact object (obtained with GeodesicLine::Compress)
+     * holds just the quantities which define the line, i.e., point 1, the
+     * azimuth there, the distance and arc length to point 3, and the
+     * capabilities, in 8 numbers.  The GeodesicLine is reconstructed on
+     * demand with GeodesicLine::GeodesicLine(const Geodesic&, const
+     * Compact&); this has the cost of constructing a GeodesicLine with
+     * Geodesic::Line, i.e., a small fraction of the cost of solving an
+     * inverse geodesic problem.  The ellipsoid isn't stored; so a large
+     * collection of lines on one ellipsoid can be stored as a vector of
+     * Compact objects together with a single Geodesic object.
+     **********************************************************************/
+    class Compact {
+    private:
+      friend class GeodesicLine;
+      real _lat1, _lon1, _azi1, _salp1, _calp1, _a13, _s13;
+      unsigned _caps;
+    public:
+      /**
+       * A default constructor; this corresponds to an uninitialized
+       * GeodesicLine.
+       **********************************************************************/
+      Compact() : _caps(0U) {}
+      /**
+       * @return true if the object has been initialized.
+       **********************************************************************/
+      bool Init() const { return _caps != 0U; }
+      /**
+       * @return \e lat1 the latitude of point 1 (degrees).
+       **********************************************************************/
+      Math::real Latitude() const { return Init() ? _lat1 : Math::NaN(); }
+      /**
+       * @return \e lon1 the longitude of point 1 (degrees).
+       **********************************************************************/
+      Math::real Longitude() const { return Init() ? _lon1 : Math::NaN(); }
+      /**
+       * @return \e azi1 the azimuth (degrees) of the geodesic line at point
+       *   1.
+       **********************************************************************/
+      Math::real Azimuth() const { return Init() ? _azi1 : Math::NaN(); }
+      /**
+       * @return \e s13, the distance to point 3 (meters).
+       **********************************************************************/
+      Math::real Distance() const { return Init() ? _s13 : Math::NaN(); }
+      /**
+       * @return \e a13, the arc length to point 3 (degrees).
+       **********************************************************************/
+      Math::real Arc() const { return Init() ? _a13 : Math::NaN(); }
+      /**
+       * @return \e caps the computational capabilities of the line.
+       **********************************************************************/
+      unsigned Capabilities() const { return _caps; }
+    };
+
+    /**
+     * @return the compact representation of this line.
+     **********************************************************************/
+    Compact Compress() const;
+
+    /**
+     * Reconstruct a GeodesicLine from its compact representation.
+     *
+     * @param[in] g A Geodesic object used to compute the necessary
+     *   information about the GeodesicLine; this should be the same (i.e.,
+     *   have the same \e a, \e f, and \e exact) as the Geodesic object
+     *   used to construct the line which was compressed.
+     * @param[in] line the compact representation of the line.
+     *
+     * The resulting GeodesicLine gives identical results to the line which
+     * was compressed.
+     **********************************************************************/
+    GeodesicLine(const Geodesic& g, const Compact& line);
+    ///@}
+
     /** \name Position in terms of distance
      **********************************************************************/
     ///@{
@@ -557,6 +650,365 @@ namespace GeographicLib {
                            real& S12) const;
     ///@}
 
+    /** \name Positions of many points
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Compute the positions of many points on the geodesic.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of the
+     *   elements of \e s12_a12.
+     * @param[in] n the number of points.
+     * @param[in] s12_a12 array of distances (meters) or arc lengths (degrees)
+     *   from point 1 to the points.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[out] s12 array of distances from point 1 (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of the points relative to
+     *   point 1 (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to the
+     *   points (dimensionless).
+     * @param[out] S12 array of areas under the geodesic
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths from point 1 (degrees).
+     *
+     * Element \e i of each output array is set to the corresponding result
+     * of GeodesicLine::GenPosition(\e arcmode, \e s12_a12[\e i], \e outmask,
+     * ...); the results are identical.  The output arrays which are not
+     * needed may be null.
+     **********************************************************************/
+    void GenPositions(bool arcmode, size_t n, const real s12_a12[],
+                      unsigned outmask,
+                      real lat2[], real lon2[], real azi2[],
+                      real s12[], real m12[], real M12[], real M21[],
+                      real S12[], real a12[] = nullptr) const;
+
+    /**
+     * Compute the latitudes and longitudes of many points on the geodesic.
+     *
+     * @param[in] n the number of points.
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     *
+     * This is equivalent to GeodesicLine::GenPositions(false, \e n, \e s12,
+     * GeodesicLine::LATITUDE | GeodesicLine::LONGITUDE, \e lat2, \e lon2,
+     * ...).
+     **********************************************************************/
+    void Positions(size_t n, const real s12[], real lat2[], real lon2[])
+      const {
+      GenPositions(false, n, s12, LATITUDE | LONGITUDE, lat2, lon2,
+                   nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    }
+
+    /**
+     * Compute the positions of equally spaced points on the geodesic.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of \e s0_a0
+     *   and \e ds_da.
+     * @param[in] s0_a0 the distance (meters) or arc length (degrees) from
+     *   point 1 to the first point.
+     * @param[in] ds_da the spacing of the points (meters or degrees).
+     * @param[in] n the number of points.
+     * @param[in] outmask a bitor'ed combination of GeodesicLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[out] s12 array of distances from point 1 (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of the points relative to
+     *   point 1 (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to the
+     *   points (dimensionless).
+     * @param[out] S12 array of areas under the geodesic
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths from point 1 (degrees).
+     *
+     * This is equivalent to GeodesicLine::GenPositions with \e s12_a12[\e i]
+     * = \e s0_a0 + \e i \e ds_da.  However, the sine and cosine of the
+     * (scaled) distance are advanced from one point to the next with the
+     * angle-addition formulas which saves one evaluation of sin and cos per
+     * point.  The results differ from those of GeodesicLine::GenPositions by
+     * a few ulps.
+     **********************************************************************/
+    void GenPositionsUniform(bool arcmode, real s0_a0, real ds_da, size_t n,
+                             unsigned outmask,
+                             real lat2[], real lon2[], real azi2[],
+                             real s12[], real m12[], real M12[], real M21[],
+                             real S12[], real a12[] = nullptr) const;
+
+    /**
+     * Densify the geodesic from point 1 to point 3.
+     *
+     * @param[in] ds the maximum spacing of the points (meters).
+     * @param[out] lat the latitudes of the points (degrees).
+     * @param[out] lon the longitudes of the points (degrees).
+     * @param[in] unroll if true, unroll the longitudes (see
+     *   GeodesicLine::LONG_UNROLL); otherwise reduce them to the range
+     *   [&minus;180&deg;, 180&deg;].
+     * @return the number of points.
+     *
+     * Point 3 must have been set, e.g., by GeodesicLine::SetDistance or by
+     * creating the line with Geodesic::InverseLine or Geodesic::DirectLine.
+     * The points are equally spaced in distance with a spacing not
+     * exceeding \e ds and include point 1 and point 3; they are computed
+     * with GeodesicLine::GenPositionsUniform.  If \e ds is not positive, the
+     * distance to point 3 is not finite, or the GeodesicLine object was not
+     * constructed with \e caps |= GeodesicLine::DISTANCE_IN |
+     * GeodesicLine::LONGITUDE, no points are returned.
+     **********************************************************************/
+    size_t Densify(real ds, std::vector<real>& lat, std::vector<real>& lon,
+                   bool unroll = false) const;
+
+    /**
+     * \brief Step along a geodesic in equal increments
+     *
+     * This returns the positions of the points at \e s0_a0 + \e i \e
+     * ds_da for \e i = 0, 1, 2, ..., one per call to Stepper::GenNext, in
+     * the same way as GeodesicLine::GenPositionsUniform.  The sine and
+     * cosine of the (scaled) distance are advanced by the angle-addition
+     * formulas and recomputed directly every 16 steps.  Thus the results are
+     * identical to those of GeodesicLine::GenPositionsUniform and differ
+     * from those of GeodesicLine::GenPosition by a few ulps.  This is useful
+     * when the number of points isn't known in advance, e.g., for
+     * simulating a ground track.
+     *
+     * The GeodesicLine must outlive the Stepper.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT Stepper {
+    private:
+      typedef Math::real real;
+      const GeodesicLine* _line;
+      bool _arcmode;
+      real _x0, _dx, _scale, _sd, _cd, _s, _c;
+      unsigned long long _i;
+    public:
+      /**
+       * Constructor for stepping in distance.
+       *
+       * @param[in] line the GeodesicLine, which should have been constructed
+       *   with \e caps |= GeodesicLine::DISTANCE_IN.
+       * @param[in] ds the step (meters); it can be negative.
+       * @param[in] s0 (optional) the distance from point 1 to the first point
+       *   (meters), default 0.
+       **********************************************************************/
+      Stepper(const GeodesicLine& line, real ds, real s0 = 0)
+        : Stepper(line, false, s0, ds) {}
+
+      /**
+       * The general constructor.
+       *
+       * @param[in] line the GeodesicLine.
+       * @param[in] arcmode boolean flag determining the meaning of \e s0_a0
+       *   and \e ds_da.
+       * @param[in] s0_a0 the distance (meters) or arc length (degrees) from
+       *   point 1 to the first point.
+       * @param[in] ds_da the step (meters or degrees).
+       **********************************************************************/
+      Stepper(const GeodesicLine& line, bool arcmode, real s0_a0, real ds_da);
+
+      /**
+       * Compute the position of the next point and advance the Stepper.
+       *
+       * @param[in] outmask a bitor'ed combination of GeodesicLine::mask
+       *   values specifying which of the following parameters should be set.
+       * @param[out] lat2 latitude of the point (degrees).
+       * @param[out] lon2 longitude of the point (degrees).
+       * @param[out] azi2 (forward) azimuth at the point (degrees).
+       * @param[out] s12 distance from point 1 (meters).
+       * @param[out] m12 reduced length of the geodesic (meters).
+       * @param[out] M12 geodesic scale of the point relative to point 1
+       *   (dimensionless).
+       * @param[out] M21 geodesic scale of point 1 relative to the point
+       *   (dimensionless).
+       * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+       * @return \e a12 arc length from point 1 (degrees).
+       *
+       * The arguments are as for GeodesicLine::GenPosition.
+       **********************************************************************/
+      Math::real GenNext(unsigned outmask,
+                         real& lat2, real& lon2, real& azi2,
+                         real& s12, real& m12, real& M12, real& M21,
+                         real& S12);
+
+      /**
+       * Compute the latitude and longitude of the next point and advance the
+       * Stepper.
+       *
+       * @param[out] lat2 latitude of the point (degrees).
+       * @param[out] lon2 longitude of the point (degrees).
+       * @param[in] unroll (optional) if true, unroll the longitude (see
+       *   GeodesicLine::LONG_UNROLL), default false.
+       * @return \e a12 arc length from point 1 (degrees).
+       **********************************************************************/
+      Math::real Next(real& lat2, real& lon2, bool unroll = false) {
+        real t;
+        return GenNext(LATITUDE | LONGITUDE | (unroll ? LONG_UNROLL : NONE),
+                       lat2, lon2, t, t, t, t, t, t);
+      }
+
+      /**
+       * @return the number of points computed so far.
+       **********************************************************************/
+      unsigned long long Count() const { return _i; }
+
+      /**
+       * @return the distance (meters) or arc length (degrees) from point 1
+       *   to the next point.
+       **********************************************************************/
+      Math::real Current() const { return _x0 + real(_i) * _dx; }
+    };
+    ///@}
+
+    /** \name Crossings of parallels and meridians
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Find where the geodesic crosses a parallel.
+     *
+     * @param[in] lat the latitude of the parallel (degrees).
+     * @param[out] a12 the arc lengths from point 1 to the crossings
+     *   (degrees).
+     * @return the number of crossings.
+     *
+     * The crossings between point 1 and point 3 (inclusive) are returned in
+     * order along the geodesic starting at point 1; point 3 must have been
+     * set.  On the auxiliary sphere, sin&beta; = cos&alpha;<sub>0</sub>
+     * sin&sigma;, so the crossings are found directly from the parametric
+     * latitude of the parallel, without iteration.  The positions of the
+     * crossings are then given by GeodesicLine::ArcPosition.  A geodesic
+     * which just touches the parallel at a vertex gives a single crossing.
+     * No crossings are returned for an equatorial geodesic (or if \e lat is
+     * not finite).
+     **********************************************************************/
+    size_t LatitudeCrossing(real lat, std::vector<real>& a12) const;
+
+    /**
+     * Find where the geodesic crosses a meridian.
+     *
+     * @param[in] lon the longitude of the meridian (degrees).
+     * @param[out] a12 the arc lengths from point 1 to the crossings
+     *   (degrees).
+     * @return the number of crossings.
+     *
+     * The crossings between point 1 and point 3 (inclusive) are returned in
+     * order along the geodesic starting at point 1; point 3 must have been
+     * set and the GeodesicLine object must have been constructed with \e
+     * caps |= GeodesicLine::LONGITUDE.  All the crossings of \e lon + 360\e
+     * k, for integer \e k, by the unrolled longitude are found.  Each
+     * crossing is found by Newton's method with the longitude &omega; on the
+     * auxiliary sphere as the independent variable; because
+     * d&lambda;/d&omega; = (1 &minus; <i>e</i><sup>2</sup>
+     * cos<sup>2</sup>&beta;)<sup>1/2</sup> lies in [\e b/\e a, 1], this
+     * converges in 2 or 3 iterations.  Each iteration takes one evaluation
+     * of the longitude with GeodesicLine::GenPosition.  No crossings are
+     * returned for a meridional geodesic (or if \e lon is not finite).
+     **********************************************************************/
+    size_t LongitudeCrossing(real lon, std::vector<real>& a12) const;
+    ///@}
+
+    /** \name Bounds of a segment
+     **********************************************************************/
+    ///@{
+
+    /**
+     * \brief The bounds of a segment of a geodesic
+     *
+     * This is returned by GeodesicLine::Bounds and gives a latitude-longitude
+     * box and a geodesic circle (a cap) which contain the segment.  These
+     * may be used to prefilter the segments in a spatial index.
+     **********************************************************************/
+    class SegmentBounds {
+    public:
+      /**
+       * The minimum latitude (degrees).
+       **********************************************************************/
+      real latmin;
+      /**
+       * The maximum latitude (degrees).
+       **********************************************************************/
+      real latmax;
+      /**
+       * The west edge of the box (degrees); this lies in [&minus;180&deg;,
+       * 180&deg;].
+       **********************************************************************/
+      real lonmin;
+      /**
+       * The east edge of the box (degrees); \e lonmax &minus; \e lonmin lies
+       * in [0&deg;, 360&deg;], so \e lonmax exceeds 180&deg; if the box
+       * straddles the antimeridian.
+       **********************************************************************/
+      real lonmax;
+      /**
+       * The latitude of the center of the cap (degrees).
+       **********************************************************************/
+      real lat0;
+      /**
+       * The longitude of the center of the cap (degrees); this lies in
+       * [&minus;180&deg;, 180&deg;].
+       **********************************************************************/
+      real lon0;
+      /**
+       * The radius of the cap (meters).
+       **********************************************************************/
+      real radius;
+    };
+
+    /**
+     * Find the bounds of a segment of the geodesic.
+     *
+     * @param[in] s1 the distance from point 1 to the start of the segment
+     *   (meters).
+     * @param[in] s2 the distance from point 1 to the end of the segment
+     *   (meters).
+     * @return the bounds of the segment.
+     *
+     * The latitude range is set by the ends of the segment and by the
+     * vertices (the points of maximum and minimum latitude of the geodesic)
+     * which lie within the segment.  The unrolled longitude is a monotonic
+     * function of the distance so the longitude range is set by the ends of
+     * the segment.  (A meridional geodesic which passes over a pole gives a
+     * box 180&deg; wide.)  Thus the box is the smallest one containing the
+     * segment.
+     *
+     * The cap is centered at the midpoint of the segment and its radius is
+     * half the length of the segment; since the distance along the geodesic
+     * is not less than the shortest distance, the cap contains the segment.
+     * If the segment is a shortest path, this is the smallest cap
+     * containing the segment, since it just contains the two ends.
+     *
+     * This requires three evaluations of the position on the geodesic; the
+     * GeodesicLine object must have been constructed with \e caps |=
+     * GeodesicLine::DISTANCE_IN | GeodesicLine::LONGITUDE, otherwise the
+     * elements of the result are NaNs.
+     **********************************************************************/
+    SegmentBounds Bounds(real s1, real s2) const;
+
+    /**
+     * Find the bounds of the edges of a polyline.
+     *
+     * @param[in] g the Geodesic object specifying the ellipsoid.
+     * @param[in] n the number of vertices of the polyline.
+     * @param[in] lat array of the latitudes of the vertices (degrees).
+     * @param[in] lon array of the longitudes of the vertices (degrees).
+     * @param[out] bounds array of \e n &minus; 1 bounds.
+     *
+     * Element \e i of \e bounds is set to the bounds of the shortest
+     * geodesic from vertex \e i to vertex \e i + 1 found by
+     * GeodesicLine::Bounds.
+     **********************************************************************/
+    static void Bounds(const Geodesic& g, size_t n,
+                       const real lat[], const real lon[],
+                       SegmentBounds bounds[]);
+    ///@}
+
     /** \name Setting point 3
      **********************************************************************/
     ///@{
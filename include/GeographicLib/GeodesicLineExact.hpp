@@ -58,10 +58,16 @@ namespace GeographicLib {
     EllipticFunction _eE;
     unsigned _caps;
 
+    // If reuse, the object was last initialized with the same g; then the
+    // elliptic integrals and the C4 coefficients are kept if they depend on
+    // the same k2.
     void LineInit(const GeodesicExact& g,
                   real lat1, real lon1,
                   real azi1, real salp1, real calp1,
-                  unsigned caps);
+                  unsigned caps, bool reuse = false);
+    // Element i of an output array, or t if the array is null.
+    static real& Slot(real a[], size_t i, real& t)
+    { return a ? a[i] : t; }
     GeodesicLineExact(const GeodesicExact& g,
                       real lat1, real lon1,
                       real azi1, real salp1, real calp1,
@@ -514,6 +520,70 @@ namespace GeographicLib {
                            real& S12) const;
     ///@}
 
+    /** \name Positions of many points
+     **********************************************************************/
+    ///@{
+
+    /**
+     * Compute the positions of many points on the geodesic.
+     *
+     * @param[in] arcmode boolean flag determining the meaning of the
+     *   elements of \e s12_a12.
+     * @param[in] n the number of points.
+     * @param[in] s12_a12 array of distances (meters) or arc lengths (degrees)
+     *   from point 1 to the points.
+     * @param[in] outmask a bitor'ed combination of GeodesicLineExact::mask
+     *   values specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] azi2 array of (forward) azimuths (degrees).
+     * @param[out] s12 array of distances from point 1 (meters).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of the points relative to
+     *   point 1 (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to the
+     *   points (dimensionless).
+     * @param[out] S12 array of areas under the geodesic
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths from point 1 (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * Element \e i of each output array is set to the corresponding result
+     * of GeodesicLineExact::GenPosition(\e arcmode, \e s12_a12[\e i], \e
+     * outmask, ...); the results are identical.  The output arrays which are
+     * not needed may be null.  All the points share the elliptic integrals
+     * and the coefficients of the area integral set up when the line was
+     * constructed.  If \e nthreads > 1, the points are handed out in chunks
+     * to that many tasks which are run with Executor::Batch.
+     **********************************************************************/
+    void GenPositions(bool arcmode, size_t n, const real s12_a12[],
+                      unsigned outmask,
+                      real lat2[], real lon2[], real azi2[],
+                      real s12[], real m12[], real M12[], real M21[],
+                      real S12[], real a12[] = nullptr,
+                      int nthreads = 1) const;
+
+    /**
+     * Compute the latitudes and longitudes of many points on the geodesic.
+     *
+     * @param[in] n the number of points.
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is equivalent to GeodesicLineExact::GenPositions(false, \e n, \e
+     * s12, GeodesicLineExact::LATITUDE | GeodesicLineExact::LONGITUDE, \e
+     * lat2, \e lon2, ...).
+     **********************************************************************/
+    void Positions(size_t n, const real s12[], real lat2[], real lon2[],
+                   int nthreads = 1) const {
+      GenPositions(false, n, s12, LATITUDE | LONGITUDE, lat2, lon2,
+                   nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                   nullptr, nthreads);
+    }
+    ///@}
+
     /** \name Setting point 3
      **********************************************************************/
     ///@{
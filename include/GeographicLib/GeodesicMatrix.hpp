@@ -0,0 +1,256 @@
+/**
+ * \file GeodesicMatrix.hpp
+ * \brief Header for GeographicLib::GeodesicMatrix class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICMATRIX_HPP)
+#define GEOGRAPHICLIB_GEODESICMATRIX_HPP 1
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <GeographicLib/Geodesic.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Many-to-many geodesic calculations
+   *
+   * Solve the inverse geodesic problem between every point in one set (the
+   * rows) and every point in another set (the columns).  The results are
+   * stored as matrices in row-major order; thus the result for row \e i and
+   * column \e j is in element <i>i</i> \e ncols + \e j.
+   *
+   * The constructor computes the quantities which depend only on the
+   * latitude of each point (the rounded latitude and the corresponding
+   * reduced latitude) once.  Each inverse problem then starts with these
+   * precomputed quantities, which typically saves 5&ndash;10% of the cost
+   * compared to calling Geodesic::Inverse for each pair.  In addition, the
+   * columns are processed in blocks small enough to remain in cache while
+   * all the rows are processed.
+   *
+   * The results are identical to those returned by Geodesic::GenInverse.  If
+   * the Geodesic object was constructed with \e exact = true, the
+   * calculations are delegated to GeodesicExact and there is no
+   * precomputation.
+   *
+   * GeodesicMatrix::GenRows computes a range of rows of the matrices.  It is
+   * \e const and writes to disjoint parts of the output arrays, so the rows
+   * can be divided among several threads.
+   *
+   * GeodesicMatrix::WriteDistances writes the distance matrix to a binary
+   * file a tile of rows at a time, so that matrices too big for memory can
+   * be computed; the file records the rows completed so that an interrupted
+   * run can be resumed.
+   *
+   * Example of use:
+   * \include example-GeodesicMatrix.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicMatrix {
+  private:
+    typedef Math::real real;
+    // Data stored for each point: lat, sbet, cbet, dn, lon
+    static const size_t stride_ = 5;
+    // The number of columns processed as a block
+    static const size_t block_ = 256;
+    Geodesic _geod;
+    size_t _nrows, _ncols;
+    std::vector<real> _rows, _cols;
+    // The size of the header of the files written by WriteDistances
+    static const size_t header_ = 64;
+    void Points(size_t n, const real lat[], const real lon[],
+                std::vector<real>& pts) const;
+    // The inverse problem between two of the stored points
+    void Pair(const real* p1, const real* p2, unsigned outmask,
+              real& s12, real& salp1, real& calp1,
+              real& salp2, real& calp2) const;
+    // The index of the first element of row i in a distance file
+    static size_t RowStart(size_t ncols, size_t i, bool symmetric) {
+      return symmetric ? i * ncols - i * (i - 1) / 2 : i * ncols;
+    }
+  public:
+
+    /**
+     * Bit masks for the format of the files written by
+     * GeodesicMatrix::WriteDistances.
+     **********************************************************************/
+    enum format {
+      /**
+       * Store the distances as doubles.
+       * @hideinitializer
+       **********************************************************************/
+      FLOAT64   = 0U,
+      /**
+       * Store the distances as floats.
+       * @hideinitializer
+       **********************************************************************/
+      FLOAT32   = 1U,
+      /**
+       * Store only the upper triangle (including the diagonal) of the
+       * matrix.
+       * @hideinitializer
+       **********************************************************************/
+      SYMMETRIC = 2U,
+    };
+
+    /**
+     * Constructor for GeodesicMatrix.
+     *
+     * @param[in] geod the Geodesic object to use for the calculations.
+     * @param[in] nrows the number of points in the first set.
+     * @param[in] lat1 array of the latitudes of the first set (degrees).
+     * @param[in] lon1 array of the longitudes of the first set (degrees).
+     * @param[in] ncols the number of points in the second set.
+     * @param[in] lat2 array of the latitudes of the second set (degrees).
+     * @param[in] lon2 array of the longitudes of the second set (degrees).
+     *
+     * The point data is copied, so the input arrays are not referenced after
+     * the constructor returns.
+     **********************************************************************/
+    GeodesicMatrix(const Geodesic& geod,
+                   size_t nrows, const real lat1[], const real lon1[],
+                   size_t ncols, const real lat2[], const real lon2[]);
+
+    /**
+     * Compute the matrices for a range of rows.
+     *
+     * @param[in] row0 the first row to compute.
+     * @param[in] row1 one past the last row to compute.
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 matrix of distances (meters).
+     * @param[out] azi1 matrix of azimuths at the row points (degrees).
+     * @param[out] azi2 matrix of (forward) azimuths at the column points
+     *   (degrees).
+     *
+     * The Geodesic::mask values possible for \e outmask are
+     * - \e outmask |= Geodesic::DISTANCE for the distance \e s12;
+     * - \e outmask |= Geodesic::AZIMUTH for the azimuths \e azi1 and \e
+     *   azi2.
+     * .
+     * Each output array selected by \e outmask must hold the full
+     * GeodesicMatrix::Rows() &times; GeodesicMatrix::Columns() matrix;
+     * only the elements in rows [\e row0, \e row1) are set.  The arrays
+     * which are not selected are not referenced and may be null.  \e row1 is
+     * clamped to GeodesicMatrix::Rows().
+     **********************************************************************/
+    void GenRows(size_t row0, size_t row1, unsigned outmask,
+                 real s12[], real azi1[], real azi2[]) const;
+
+    /**
+     * Compute the full matrices.
+     *
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 matrix of distances (meters).
+     * @param[out] azi1 matrix of azimuths at the row points (degrees).
+     * @param[out] azi2 matrix of (forward) azimuths at the column points
+     *   (degrees).
+     *
+     * This is equivalent to GenRows(0, Rows(), outmask, s12, azi1, azi2).
+     **********************************************************************/
+    void GenMatrix(unsigned outmask,
+                   real s12[], real azi1[], real azi2[]) const
+    { GenRows(0, _nrows, outmask, s12, azi1, azi2); }
+
+    /**
+     * Compute the distance matrix.
+     *
+     * @param[out] s12 matrix of distances (meters).
+     **********************************************************************/
+    void Distances(real s12[]) const
+    { GenMatrix(Geodesic::DISTANCE, s12, nullptr, nullptr); }
+
+    /**
+     * Write the distance matrix to a file.
+     *
+     * @param[in] filename the name of the file.
+     * @param[in] format a bitor'ed combination of GeodesicMatrix::format
+     *   values (default GeodesicMatrix::FLOAT64).
+     * @param[in] resume if true and \e filename exists, continue the
+     *   calculation recorded in the file (default false).
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @param[in] tilerows the number of rows computed and written at a
+     *   time; the default, 0, gives tiles of about 8 &times;
+     *   2<sup>20</sup> elements.
+     * @exception GeographicErr if \e resume is true and \e filename exists
+     *   but wasn't written for a matrix of this size and format.
+     * @exception GeographicErr if GeodesicMatrix::SYMMETRIC is specified but
+     *   the row and column points differ.
+     * @exception GeographicErr if the file can't be written.
+     * @exception std::bad_alloc if the memory for a tile can't be allocated.
+     *
+     * The file consists of a header of 64 bytes followed by the distances
+     * (meters) in the native byte order.  The header consists of 8 unsigned
+     * 64-bit integers: the characters "GEODMAT1", the number of rows, the
+     * number of columns, the format, the number of rows which have been
+     * written, and 3 zeros.  The distances are stored in row-major order;
+     * with GeodesicMatrix::SYMMETRIC, only the elements with \e j &ge; \e i
+     * are stored, so that row \e i holds Columns() &minus; \e i elements.
+     * Use GeodesicMatrix::FileIndex to find an element.  The file is
+     * flushed and the header updated after each tile is written; thus, if
+     * the calculation is interrupted, calling WriteDistances again with \e
+     * resume = true starts with the first tile which wasn't completed.  If
+     * the file was completed, this does nothing.  The rows of each tile are
+     * divided among \e nthreads tasks which are run with Executor::Batch.
+     *
+     * With GeodesicMatrix::SYMMETRIC, the distance for \e j < \e i is
+     * taken to be that for the pair swapped; this is consistent with the
+     * distances returned by Geodesic::Inverse to within roundoff.  This
+     * halves the time and the size of the file for the distances between
+     * all the pairs of a single set of points.
+     **********************************************************************/
+    void WriteDistances(const std::string& filename,
+                        unsigned format = FLOAT64, bool resume = false,
+                        int nthreads = 1, size_t tilerows = 0) const;
+
+    /**
+     * The index of an element of a file written by
+     * GeodesicMatrix::WriteDistances.
+     *
+     * @param[in] ncols the number of columns.
+     * @param[in] i the row.
+     * @param[in] j the column.
+     * @param[in] symmetric whether the file was written with
+     *   GeodesicMatrix::SYMMETRIC.
+     * @return the index of the element for (\e i, \e j) counting from the
+     *   first distance in the file.
+     *
+     * If \e symmetric is true and \e j < \e i, the index of the element for
+     * (\e j, \e i) is returned.  The byte offset of the element in the file
+     * is 64 plus the index times the size of the elements.
+     **********************************************************************/
+    static size_t FileIndex(size_t ncols, size_t i, size_t j,
+                            bool symmetric) {
+      if (symmetric && j < i) std::swap(i, j);
+      return RowStart(ncols, i, symmetric) + (symmetric ? j - i : j);
+    }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of rows (points in the first set).
+     **********************************************************************/
+    size_t Rows() const { return _nrows; }
+
+    /**
+     * @return the number of columns (points in the second set).
+     **********************************************************************/
+    size_t Columns() const { return _ncols; }
+
+    /**
+     * @return the Geodesic object used in the calculations.
+     **********************************************************************/
+    const Geodesic& GeodesicObject() const { return _geod; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICMATRIX_HPP
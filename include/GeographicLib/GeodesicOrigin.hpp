@@ -0,0 +1,203 @@
+/**
+ * \file GeodesicOrigin.hpp
+ * \brief Header for GeographicLib::GeodesicOrigin class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICORIGIN_HPP)
+#define GEOGRAPHICLIB_GEODESICORIGIN_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Inverse geodesic problems from a fixed point
+   *
+   * GeodesicOrigin solves a series of inverse geodesic problems which all
+   * start at the same point 1 (\e lat1, \e lon1).  This point is specified in
+   * the constructor; alternatively, the Geodesic::Origin method can be used
+   * to create a GeodesicOrigin.  The quantities which depend only on point 1
+   * (the rounded latitude and the reduced latitude) are computed once, and
+   * GeodesicOrigin::Inverse then solves the problem for point 2.
+   *
+   * The results are identical to those returned by Geodesic::Inverse.  Most
+   * of the work in solving the inverse problem depends on both points
+   * (through the azimuth at point 1); the saving from caching point 1 is
+   * therefore only a few percent.
+   *
+   * The default copy constructor and assignment operators work with this
+   * class.  Similarly, a vector can be used to hold GeodesicOrigin objects.
+   *
+   * Example of use:
+   * \include example-GeodesicOrigin.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicOrigin {
+  private:
+    typedef Math::real real;
+    Geodesic _geod;
+    real _lat1, _lon1, _latr1, _sbet1, _cbet1, _dn1;
+  public:
+
+    /**
+     * Constructor for a GeodesicOrigin.
+     *
+     * @param[in] g A Geodesic object used to compute the necessary
+     *   information about the GeodesicOrigin.
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     *
+     * \e lat1 should be in the range [&minus;90&deg;, 90&deg;].
+     **********************************************************************/
+    GeodesicOrigin(const Geodesic& g, real lat1, real lon1);
+
+    /** \name Inverse geodesic problem from point 1.
+     **********************************************************************/
+    ///@{
+    /**
+     * Solve the inverse geodesic problem from point 1 to point 2.
+     *
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * This is the analog of Geodesic::Inverse with the first point fixed.
+     * The arguments have the same meaning.
+     **********************************************************************/
+    Math::real Inverse(real lat2, real lon2,
+                       real& s12, real& azi1, real& azi2, real& m12,
+                       real& M12, real& M21, real& S12) const {
+      return GenInverse(lat2, lon2,
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH |
+                        Geodesic::REDUCEDLENGTH | Geodesic::GEODESICSCALE |
+                        Geodesic::AREA,
+                        s12, azi1, azi2, m12, M12, M21, S12);
+    }
+
+    /**
+     * See the documentation for GeodesicOrigin::Inverse.
+     **********************************************************************/
+    Math::real Inverse(real lat2, real lon2, real& s12) const {
+      real t;
+      return GenInverse(lat2, lon2,
+                        Geodesic::DISTANCE,
+                        s12, t, t, t, t, t, t);
+    }
+
+    /**
+     * See the documentation for GeodesicOrigin::Inverse.
+     **********************************************************************/
+    Math::real Inverse(real lat2, real lon2, real& azi1, real& azi2) const {
+      real t;
+      return GenInverse(lat2, lon2,
+                        Geodesic::AZIMUTH,
+                        t, azi1, azi2, t, t, t, t);
+    }
+
+    /**
+     * See the documentation for GeodesicOrigin::Inverse.
+     **********************************************************************/
+    Math::real Inverse(real lat2, real lon2,
+                       real& s12, real& azi1, real& azi2) const {
+      real t;
+      return GenInverse(lat2, lon2,
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                        s12, azi1, azi2, t, t, t, t);
+    }
+    ///@}
+
+    /** \name General version of inverse geodesic solution.
+     **********************************************************************/
+    ///@{
+    /**
+     * The general inverse geodesic calculation from point 1.
+     * GeodesicOrigin::Inverse is defined in terms of this function.
+     *
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * The meaning of \e outmask is the same as for Geodesic::GenInverse.
+     **********************************************************************/
+    Math::real GenInverse(real lat2, real lon2, unsigned outmask,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12) const;
+
+    /**
+     * Solve many inverse geodesic problems from point 1.
+     *
+     * @param[in] n the number of problems.
+     * @param[in] lat2 array of latitudes of point 2 (degrees).
+     * @param[in] lon2 array of longitudes of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 array of distances (meters).
+     * @param[out] azi1 array of azimuths at point 1 (degrees).
+     * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+     * @param[out] m12 array of reduced lengths (meters).
+     * @param[out] M12 array of geodesic scales of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 array of geodesic scales of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 array of areas under the geodesics
+     *   (meters<sup>2</sup>).
+     * @param[out] a12 array of arc lengths (degrees).
+     *
+     * This is the analog of Geodesic::InverseBatch with the first point
+     * fixed.  The arguments have the same meaning.
+     **********************************************************************/
+    void InverseBatch(size_t n, const real lat2[], const real lon2[],
+                      unsigned outmask,
+                      real s12[], real azi1[], real azi2[],
+                      real m12[], real M12[], real M21[], real S12[],
+                      real a12[] = nullptr) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e lat1 the latitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Latitude() const { return _lat1; }
+
+    /**
+     * @return \e lon1 the longitude of point 1 (degrees).
+     **********************************************************************/
+    Math::real Longitude() const { return _lon1; }
+
+    /**
+     * @return the Geodesic object used in the calculations.
+     **********************************************************************/
+    const Geodesic& GeodesicObject() const { return _geod; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEODESICORIGIN_HPP
@@ -0,0 +1,179 @@
+/**
+ * \file GeodesicStart.hpp
+ * \brief Header for GeographicLib::GeodesicStart class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEODESICSTART_HPP)
+#define GEOGRAPHICLIB_GEODESICSTART_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Inverse geodesic problems with a tabulated starting guess
+   *
+   * Geodesic::Inverse finds the azimuth &alpha;<sub>1</sub> at point 1 by
+   * Newton's method starting from an approximate solution given by an
+   * internal function, InverseStart.  Newton's method then typically takes 3
+   * iterations for the WGS84 ellipsoid.  GeodesicStart tabulates the error
+   * in the starting guess as a function of the latitudes of the two points
+   * and their longitude difference (reduced to the canonical configuration
+   * &minus;90&deg; &le; \e lat1 &le; 0, \e lat1 &le; \e lat2 &le; &minus;\e
+   * lat1, 0 &le; \e lon12 &le; 180&deg;) and uses trilinear interpolation
+   * in the table to correct the starting guess.  This reduces the typical
+   * number of iterations to 2.  Because the rest of the calculation is
+   * unchanged, the time saved is only about 5%.  The results agree with
+   * those of Geodesic::Inverse to within roundoff.
+   *
+   * The table is built by the constructor.  With the default \e n = 32, it
+   * has (\e n + 1)<sup>2</sup> (2\e n + 1) = 70785 entries, occupies
+   * 283 kB, and takes about 0.1 s to compute.  So GeodesicStart is only
+   * worthwhile if a large number of inverse problems are solved for a
+   * particular ellipsoid.  The correction is skipped (so that InverseStart's
+   * guess is used) in cells of the table where the error in the starting
+   * guess varies by more than 1&deg;.  These include the cells next to the
+   * antipodal point where InverseStart switches to the astroid solution;
+   * thus the table doesn't help in this region.
+   *
+   * If the Geodesic object uses the exact formulation, the table isn't
+   * built and the calculations are delegated to Geodesic.
+   *
+   * The default copy constructor and assignment operators work with this
+   * class.
+   *
+   * Example of use:
+   * \include example-GeodesicStart.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeodesicStart {
+  private:
+    typedef Math::real real;
+    friend class Geodesic;
+    Geodesic _geod;
+    int _n;
+    // The corrections to the azimuth (radians) at the nodes (lat1, lat2,
+    // lon12) = (-90*i/n, lat1*(1-2*j/n), 90*k/n) for i, j in [0, n] and k in
+    // [0, 2*n] with k varying fastest
+    std::vector<float> _delta;
+    // Correct the starting guess salp1, calp1 for the problem in canonical
+    // form
+    void Correct(real lat1, real lat2, real lon12,
+                 real& salp1, real& calp1) const;
+  public:
+
+    /**
+     * Constructor for a GeodesicStart.
+     *
+     * @param[in] g the Geodesic object used to solve the problems.
+     * @param[in] n the number of intervals in the table in each latitude
+     *   (default 32); 2\e n intervals are used for the longitude difference.
+     * @exception GeographicErr if \e n isn't positive.
+     * @exception std::bad_alloc if the memory for the table can't be
+     *   allocated.
+     **********************************************************************/
+    explicit GeodesicStart(const Geodesic& g, int n = 32);
+
+    /** \name Inverse geodesic problem.
+     **********************************************************************/
+    ///@{
+    /**
+     * The general inverse geodesic calculation.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[in] outmask a bitor'ed combination of Geodesic::mask values
+     *   specifying which of the following parameters should be set.
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @param[out] m12 reduced length of geodesic (meters).
+     * @param[out] M12 geodesic scale of point 2 relative to point 1
+     *   (dimensionless).
+     * @param[out] M21 geodesic scale of point 1 relative to point 2
+     *   (dimensionless).
+     * @param[out] S12 area under the geodesic (meters<sup>2</sup>).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     *
+     * The arguments are the same as for Geodesic::GenInverse.
+     **********************************************************************/
+    Math::real GenInverse(real lat1, real lon1, real lat2, real lon2,
+                          unsigned outmask,
+                          real& s12, real& azi1, real& azi2,
+                          real& m12, real& M12, real& M21, real& S12) const;
+
+    /**
+     * Solve the inverse geodesic problem for the distance.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     **********************************************************************/
+    Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
+                       real& s12) const {
+      real t;
+      return GenInverse(lat1, lon1, lat2, lon2,
+                        Geodesic::DISTANCE,
+                        s12, t, t, t, t, t, t);
+    }
+
+    /**
+     * Solve the inverse geodesic problem for the distance and azimuths.
+     *
+     * @param[in] lat1 latitude of point 1 (degrees).
+     * @param[in] lon1 longitude of point 1 (degrees).
+     * @param[in] lat2 latitude of point 2 (degrees).
+     * @param[in] lon2 longitude of point 2 (degrees).
+     * @param[out] s12 distance between point 1 and point 2 (meters).
+     * @param[out] azi1 azimuth at point 1 (degrees).
+     * @param[out] azi2 (forward) azimuth at point 2 (degrees).
+     * @return \e a12 arc length of between point 1 and point 2 (degrees).
+     **********************************************************************/
+    Math::real Inverse(real lat1, real lon1, real lat2, real lon2,
+                       real& s12, real& azi1, real& azi2) const {
+      real t;
+      return GenInverse(lat1, lon1, lat2, lon2,
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                        s12, azi1, azi2, t, t, t, t);
+    }
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the Geodesic object used to solve the problems.
+     **********************************************************************/
+    const Geodesic& GeodesicObject() const { return _geod; }
+
+    /**
+     * @return \e n the number of intervals in the table in each latitude.
+     **********************************************************************/
+    int Intervals() const { return _n; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_GEODESICSTART_HPP
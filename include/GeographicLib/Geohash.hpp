@@ -11,6 +11,8 @@
 #define GEOGRAPHICLIB_GEOHASH_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <utility>
+#include <vector>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs string
@@ -20,6 +22,8 @@
 
 namespace GeographicLib {
 
+  class Geodesic;
+
   /**
    * \brief Conversions for geohashes
    *
@@ -39,12 +43,55 @@ namespace GeographicLib {
 
   class GEOGRAPHICLIB_EXPORT Geohash {
   private:
+    friend class EqualAreaGrid; // EqualAreaGrid uses Spread and Compact
     typedef Math::real real;
     static const int maxlen_ = 18;
+    // The maximum length of a geohash held in an unsigned long long
+    static const int maxintlen_ = 12;
     static const unsigned long long mask_ = 1ULL << 45;
     static const char* const lcdigits_;
     static const char* const ucdigits_;
     Geohash() = delete;         // Disable constructor
+    static bool Scale(real lat, real lon,
+                      unsigned long long& ulon, unsigned long long& ulat);
+    static void Unscale(unsigned long long ulon, unsigned long long ulat,
+                        int len, bool centerp, real& lat, real& lon);
+    static unsigned long long Encode(unsigned long long ulon,
+                                     unsigned long long ulat, int len);
+    static void Decode(unsigned long long code, int len,
+                       unsigned long long& ulon, unsigned long long& ulat);
+    static bool CheckCode(unsigned long long code, int len);
+    // Find the bounds of a geohash cell
+    static void Bounds(unsigned long long code, int len,
+                       real& lats, real& latn, real& lonw, real& lone);
+    // Append the ranges of codes of length len loosely covering a region.
+    // test(lats, latn, lonw, lone) returns 0 if the cell is disjoint from the
+    // region, 2 if the cell lies within the region, and 1 otherwise.
+    template<class Test>
+    static void Cover(const Test& test, unsigned long long code, int clen,
+                      int len,
+                      std::vector<std::pair<unsigned long long,
+                      unsigned long long>>& ranges);
+    // Spread the low 32 bits of x to the even bits of the result
+    static unsigned long long Spread(unsigned long long x) {
+      x &= 0xffffffffULL;
+      x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+      x = (x | (x <<  8)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x <<  4)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x <<  2)) & 0x3333333333333333ULL;
+      x = (x | (x <<  1)) & 0x5555555555555555ULL;
+      return x;
+    }
+    // The inverse of Spread: gather the even bits of x
+    static unsigned long long Compact(unsigned long long x) {
+      x &= 0x5555555555555555ULL;
+      x = (x | (x >>  1)) & 0x3333333333333333ULL;
+      x = (x | (x >>  2)) & 0x0f0f0f0f0f0f0f0fULL;
+      x = (x | (x >>  4)) & 0x00ff00ff00ff00ffULL;
+      x = (x | (x >>  8)) & 0x0000ffff0000ffffULL;
+      x = (x | (x >> 16)) & 0x00000000ffffffffULL;
+      return x;
+    }
 
   public:
 
@@ -88,6 +135,188 @@ namespace GeographicLib {
     static void Reverse(const std::string& geohash, real& lat, real& lon,
                         int& len, bool centerp = true);
 
+    /**
+     * Convert from geographic coordinates to an integer geohash.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] len the length of the geohash.
+     * @param[out] code the integer geohash.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     *
+     * The integer geohash consists of the 5 \e len bits encoded by the
+     * characters of the string geohash, most significant first.  Thus
+     * character \e i of the string geohash is lcdigits[(\e code >> 5 (\e len
+     * &minus; 1 &minus; \e i)) & 31], where lcdigits =
+     * "0123456789bcdefghjkmnpqrstuvwxyz".  Internally, \e len is first put in
+     * the range [0, 12].  (\e len = 12 provides approximately 20 mm
+     * precision.)  Integer geohashes with the same \e len may be compared
+     * and sorted in the same way as the corresponding strings.
+     *
+     * If \e lat or \e lon is NaN, the returned \e code is ~0ULL (all bits
+     * set), which is not a legal code for any \e len.
+     **********************************************************************/
+    static void Forward(real lat, real lon, int len, unsigned long long& code);
+
+    /**
+     * Convert from an integer geohash to geographic coordinates.
+     *
+     * @param[in] code the integer geohash.
+     * @param[in] len the length of the geohash.
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[in] centerp if true (the default) return the center of the
+     *   geohash location, otherwise return the south-west corner.
+     * @exception GeographicErr if \e code has more than 5 \e len bits.
+     *
+     * Internally, \e len is first put in the range [0, 12].  If \e code is
+     * ~0ULL, then \e lat and \e lon are set to NaN.
+     **********************************************************************/
+    static void Reverse(unsigned long long code, int len,
+                        real& lat, real& lon, bool centerp = true);
+
+    /**
+     * Convert many points from geographic coordinates to integer geohashes.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] len the length of the geohashes.
+     * @param[out] code array of integer geohashes.
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;]; the results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[], int len,
+                        unsigned long long code[]);
+
+    /**
+     * Convert many integer geohashes to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] code array of integer geohashes.
+     * @param[in] len the length of the geohashes.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[in] centerp if true (the default) return the centers of the
+     *   geohash locations, otherwise return the south-west corners.
+     * @exception GeographicErr if any \e code has more than 5 \e len bits;
+     *   the results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.
+     **********************************************************************/
+    static void Reverse(size_t n, const unsigned long long code[], int len,
+                        real lat[], real lon[], bool centerp = true);
+
+    /**
+     * Find an order for many points which keeps nearby points together.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[out] perm array of \e n indices; on return, the points in order
+     *   are (<i>lat</i>[<i>perm</i>[0]], <i>lon</i>[<i>perm</i>[0]]),
+     *   (<i>lat</i>[<i>perm</i>[1]], <i>lon</i>[<i>perm</i>[1]]), &hellip;.
+     * @exception std::bad_alloc if the memory for the keys can't be
+     *   allocated.
+     *
+     * The points are sorted on 64-bit integer geohashes, i.e., along the
+     * Morton (Z-order) curve in longitude and latitude, with a radix sort
+     * whose cost is proportional to \e n.  Points with the same key keep
+     * their relative order; invalid points (with NaNs or |\e lat| >
+     * 90&deg;) are placed at the end.  Processing a batch of randomly
+     * ordered points in this order and scattering the results back via \e
+     * perm improves the locality of data accessed per point, e.g., the
+     * cache of a Geoid, the tiles of elevation data, or the records of a
+     * database keyed by position.  (Geoid::Heights and the batch functions
+     * of GravityModel already group their points, by cell and by circle of
+     * latitude respectively; and NearestNeighbor::QueryOrder plays the same
+     * role for a NearestNeighbor search.)
+     **********************************************************************/
+    static void Order(size_t n, const real lat[], const real lon[],
+                      size_t perm[]);
+
+    /**
+     * Find the neighbors of an integer geohash.
+     *
+     * @param[in] code the integer geohash.
+     * @param[in] len the length of the geohash.
+     * @param[out] neighbors an array of length 8 which receives the integer
+     *   geohashes of the neighboring cells to the N, NE, E, SE, S, SW, W, and
+     *   NW.
+     * @exception GeographicErr if \e code has more than 5 \e len bits.
+     *
+     * Internally, \e len is first put in the range [0, 12].  The neighbors
+     * wrap around in longitude.  Neighbors beyond a pole do not exist and
+     * are returned as ~0ULL; ~0ULL is also returned for all the neighbors if
+     * \e code is ~0ULL.
+     **********************************************************************/
+    static void Neighbors(unsigned long long code, int len,
+                          unsigned long long neighbors[]);
+
+    /**
+     * Cover a latitude-longitude box with ranges of integer geohashes.
+     *
+     * @param[in] lat1 the southern boundary of the box (degrees).
+     * @param[in] lon1 the western boundary of the box (degrees).
+     * @param[in] lat2 the northern boundary of the box (degrees).
+     * @param[in] lon2 the eastern boundary of the box (degrees).
+     * @param[in] len the length of the geohashes.
+     * @param[out] ranges the sorted set of half-open ranges [\e first, \e
+     *   second) of integer geohashes of length \e len.
+     * @exception GeographicErr if \e lat1 or \e lat2 is not in
+     *   [&minus;90&deg;, 90&deg;].
+     *
+     * Every point in the box encodes (with Geohash::Forward) to a code in one
+     * of the returned ranges.  The ranges consist of whole geohash cells,
+     * where the cells lying entirely within the box are represented by the
+     * shortest possible prefix.  Adjacent ranges are merged, so each range
+     * corresponds to a single key-range scan in a database sorted by
+     * integer geohash (or equivalently by geohash string).  Internally, \e
+     * len is first put in the range [0, 12].
+     *
+     * The box extends east from \e lon1 to \e lon2, so that, for example,
+     * \e lon1 = 170&deg; and \e lon2 = &minus;170&deg; specifies a box of
+     * width 20&deg; straddling the antimeridian.  If \e lon2 &minus; \e
+     * lon1 &ge; 360&deg;, all longitudes are included.  If \e lat1 > \e
+     * lat2, the box is empty.
+     *
+     * The number of cells examined is proportional to the perimeter of the
+     * box measured in units of the cell size for \e len, so \e len
+     * should not be much larger than the value needed to resolve the box.
+     **********************************************************************/
+    static void CoverBox(real lat1, real lon1, real lat2, real lon2, int len,
+                         std::vector<std::pair<unsigned long long,
+                         unsigned long long>>& ranges);
+
+    /**
+     * Cover a geodesic circle with ranges of integer geohashes.
+     *
+     * @param[in] geod the Geodesic object used to measure distances.
+     * @param[in] lat0 latitude of the center of the circle (degrees).
+     * @param[in] lon0 longitude of the center of the circle (degrees).
+     * @param[in] r the radius of the circle (meters).
+     * @param[in] len the length of the geohashes.
+     * @param[out] ranges the sorted set of half-open ranges [\e first, \e
+     *   second) of integer geohashes of length \e len.
+     * @exception GeographicErr if \e lat0 is not in [&minus;90&deg;,
+     *   90&deg;] or if \e r is negative or not finite.
+     *
+     * Every point whose geodesic distance from the center is no more than \e
+     * r lies in one of the returned ranges.  The ranges are constructed and
+     * returned as for CoverBox.  The tests for whether a cell intersects the
+     * circle are slightly conservative, so occasionally a cell which lies
+     * just outside the circle is included.  Each cell examined requires a
+     * few geodesic calculations, so this is considerably slower than
+     * CoverBox.
+     **********************************************************************/
+    static void CoverCircle(const Geodesic& geod, real lat0, real lon0, real r,
+                            int len,
+                            std::vector<std::pair<unsigned long long,
+                            unsigned long long>>& ranges);
+
     /**
      * The latitude resolution of a geohash.
      *
@@ -2,7 +2,7 @@
  * \file Geoid.hpp
  * \brief Header for GeographicLib::Geoid class
  *
- * Copyright (c) Charles Karney (2009-2022) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2009-2023) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
@@ -11,8 +11,14 @@
 #define GEOGRAPHICLIB_GEOID_HPP 1
 
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <fstream>
+#include <memory>
+#include <future>
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedArray.hpp>
+#include <GeographicLib/MemoryFootprint.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector and constant conditional expressions
@@ -70,7 +76,8 @@ namespace GeographicLib {
    * threadsafe parameter to true in the constructor.  This causes the
    * constructor to read all the data into memory and to turn off the
    * single-cell caching which results in a Geoid object which \e is thread
-   * safe.
+   * safe.  Each thread can then use its own GeoidEvaluator to restore the
+   * benefit of the single-cell cache.
    *
    * Example of use:
    * \include example-Geoid.cpp
@@ -82,6 +89,7 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT Geoid {
   private:
     typedef Math::real real;
+    friend class GeoidEvaluator;
 #if GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH != 4
     typedef unsigned short pixel_t;
     static const unsigned pixel_size_ = 2;
@@ -110,20 +118,114 @@ namespace GeographicLib {
     int _width, _height;
     unsigned long long _datastart, _swidth;
     bool _threadsafe;
-    // Area cache
-    mutable std::vector< std::vector<pixel_t> > _data;
+    // The memory mapped file (or null)
+    const unsigned char* _map;
+    unsigned long long _mapsize;
+    // Tiled data file and the offsets of the compressed tiles relative to
+    // _tilestart.
+    bool _tiled;
+    unsigned long long _tilestart;
+    std::vector<unsigned long long> _tileoffset;
+    // The block size (the tile size for a tiled file) and the number of
+    // blocks in each direction
+    int _blocksize, _nbx, _nby;
+    // Block cache, most recently used first
+    mutable bool _blocked;
+    typedef std::list< std::pair< int, std::vector<pixel_t> > > blocklist;
+    mutable blocklist _blocklru;
+    mutable std::unordered_map<int, blocklist::iterator> _blockmap;
+    mutable size_t _blockbytes, _blockbudget;
+    mutable unsigned long long _blockhits, _blockmisses;
+    // The last block used
+    mutable int _lastblock;
+    mutable const pixel_t* _lastdata;
+    // The default block cache size for a tiled file
+    static const size_t blockbudget_ = size_t(16) << 20;
+    // The block size for a pgm file
+    static const int pgmblock_ = 64;
+    // Track mode: the read-ahead distance in cells (0 if off), the last cell
+    // used (_trackx < 0 if none), the file descriptor used for the advice,
+    // and a ring of the blocks advised recently
+    mutable int _trackahead, _trackx, _tracky, _trackfd;
+    static const int trackring_ = 16;
+    mutable int _trackring[trackring_], _tracknext;
+    // Extrapolate the motion to cell ix, iy and advise the blocks ahead
+    void track(int ix, int iy) const;
+    // Ask the system to read block k in the background
+    void adviseblock(int k) const;
+    void TrackClear() const;
+    // Area cache, a single block of _ysize rows of _xsize pixels allocated by
+    // AreaAlloc; _datalen is the length of the block if it was obtained with
+    // mmap to use huge pages (otherwise 0).  The pixels are in row-major
+    // order.  A tiled layout (8 x 8 tiles) would put the 4 x 4 stencil for
+    // cubic interpolation into one or two cache lines instead of 4; but with
+    // random queries over the 1' grid this gave no measurable speedup (the
+    // loads of the 4 rows are independent and overlap), so the simpler
+    // layout is used.
+    mutable pixel_t* _data;
+    mutable size_t _datalen;
     mutable bool _cache;
     // NE corner and extent of cache
     mutable int _xoffset, _yoffset, _xsize, _ysize;
     // Cell cache
     mutable int _ix, _iy;
-    mutable real _v00, _v01, _v10, _v11;
+    // The interpolation coefficients for cell _ix, _iy
     mutable real _t[nterms_];
-    void filepos(int ix, int iy) const {
-      _file.seekg(std::streamoff
+    // Coefficient cache, the interpolation coefficients for a rectangle of
+    // cells stored as real or, if _coeffsingle, as float
+    mutable bool _coeffcache, _coeffsingle;
+    // NE cell and extent of the coefficient cache
+    mutable int _cxoffset, _cyoffset, _cxsize, _cysize;
+    mutable std::vector<real> _coeffs;
+    mutable std::vector<float> _coeffsf;
+    // Set t from the coefficient cache; return false if the cell isn't there
+    bool cachedcoeffs(int ix, int iy, real t[]) const;
+    void AreaAlloc(size_t n) const;
+    void AreaClear() const;
+    void CoeffClear() const;
+    void filepos(std::istream& file, int ix, int iy) const {
+      file.seekg(std::streamoff
                   (_datastart +
                    pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix))));
     }
+    // Read n pixels in row iy starting at column ix using file (if the data
+    // is neither mapped nor tiled)
+    void readrow(int ix, int iy, pixel_t row[], int n,
+                 std::istream& file) const;
+    void readrow(int ix, int iy, pixel_t row[], int n) const
+    { readrow(ix, iy, row, n, _file); }
+    // Read block k from the file (decoding a tile if necessary)
+    void readblock(int k, std::vector<pixel_t>& block) const;
+    // Return block k, reading it if necessary
+    const pixel_t* getblock(int k) const;
+    // Add block k to the cache without counting a hit or a miss
+    void prefetchblock(int k) const;
+    // Prefetch the blocks adjacent to cell ix, iy if it's near an edge
+    void prefetch(int ix, int iy) const;
+    void BlockClear() const;
+    void BlockTrim(size_t maxbytes) const;
+    pixel_t blockval(int ix, int iy) const {
+      int bx = ix / _blocksize, by = iy / _blocksize, k = by * _nbx + bx;
+      const pixel_t* b;
+      if (k == _lastblock) {
+        ++_blockhits;
+        b = _lastdata;
+      } else
+        b = getblock(k);
+      return b[(iy - by * _blocksize) * std::min(_blocksize,
+                                                 _width - bx * _blocksize)
+               + (ix - bx * _blocksize)];
+    }
+    void MapFile();
+    void UnmapFile();
+    real mapval(int ix, int iy) const {
+      const unsigned char* p = _map + _datastart +
+        pixel_size_ * (unsigned(iy)*_swidth + unsigned(ix));
+      unsigned r = (unsigned(p[0]) << 8) | unsigned(p[1]);
+      if (pixel_size_ == 4)
+        r = (r << 16) | (unsigned(p[2]) << 8) | unsigned(p[3]);
+      return real(r);
+    }
     real rawval(int ix, int iy) const {
       if (ix < 0)
         ix += _width;
@@ -132,15 +234,20 @@ namespace GeographicLib {
       if (_cache && iy >= _yoffset && iy < _yoffset + _ysize &&
           ((ix >= _xoffset && ix < _xoffset + _xsize) ||
            (ix + _width >= _xoffset && ix + _width < _xoffset + _xsize))) {
-        return real(_data[iy - _yoffset]
-                    [ix >= _xoffset ? ix - _xoffset : ix + _width - _xoffset]);
+        return real(_data[size_t(iy - _yoffset) * size_t(_xsize) +
+                          (ix >= _xoffset ? ix - _xoffset :
+                           ix + _width - _xoffset)]);
       } else {
         if (iy < 0 || iy >= _height) {
           iy = iy < 0 ? -iy : 2 * (_height - 1) - iy;
           ix += (ix < _width/2 ? 1 : -1) * _width/2;
         }
+        if (_map)
+          return mapval(ix, iy);
+        if (_blocked)
+          return real(blockval(ix, iy));
         try {
-          filepos(ix, iy);
+          filepos(_file, ix, iy);
           // initial values to suppress warnings in case get fails
           char a = 0, b = 0;
           _file.get(a);
@@ -166,7 +273,19 @@ namespace GeographicLib {
         }
       }
     }
+    // Find the cell containing lat, lon; return false if lat or lon is nan
+    bool cell(real lat, real lon, int& ix, int& iy, real& fx, real& fy) const;
+    // Compute the interpolation coefficients for a cell; t[0..3] are the
+    // corner values for bilinear interpolation, t[0..nterms_) are the
+    // coefficients of the cubic fit.
+    void cellcoeffs(int ix, int iy, real t[]) const;
+    real cellheight(const real t[], real fx, real fy) const;
+    // The height together with its gradient (northerly and easterly
+    // components) at latitude lat
+    real cellheight(const real t[], real fx, real fy, real lat,
+                    real& gradn, real& grade) const;
     real height(real lat, real lon) const;
+    real height(real lat, real lon, real& gradn, real& grade) const;
     Geoid(const Geoid&) = delete;            // copy constructor not allowed
     Geoid& operator=(const Geoid&) = delete; // copy assignment not allowed
   public:
@@ -204,20 +323,86 @@ namespace GeographicLib {
      *   true (the default) means cubic.
      * @param[in] threadsafe (optional), if true, construct a thread safe
      *   object.  The default is false
+     * @param[in] mapped (optional), if true, access the data file by mapping
+     *   it into memory.  The default is false.
+     * @param[in] nthreads (optional) the number of threads used to read the
+     *   data into memory if \e threadsafe is true (and \e mapped is false).
+     *   The default is 1.
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt.
-     * @exception GeographicErr if \e threadsafe is true but the memory
-     *   necessary for caching the data can't be allocated.
+     * @exception GeographicErr if \e threadsafe is true (and \e mapped is
+     *   false) but the memory necessary for caching the data can't be
+     *   allocated.
+     * @exception GeographicErr if \e mapped is true but the data file cannot
+     *   be mapped into memory (or this is not supported on this system or
+     *   the data file is tiled).
      *
-     * The data file is formed by appending ".pgm" to the name.  If \e path is
+     * The data file is formed by appending ".pgm" to the name.  If this file
+     * doesn't exist, the tiled version of the data formed by appending
+     * ".tpgm" to the name is used instead; see \ref geoidformat.  If \e path is
      * specified (and is non-empty), then the file is loaded from directory, \e
      * path.  Otherwise the path is given by DefaultGeoidPath().  If the \e
      * threadsafe parameter is true, the data set is read into memory, the data
      * file is closed, and single-cell caching is turned off; this results in a
      * Geoid object which \e is thread safe.
+     *
+     * If \e mapped is true, the data file is mapped into the address space
+     * of the process (using mmap on Unix systems and MapViewOfFile on Windows
+     * systems) and the file is closed.  The geoid heights are then computed
+     * by indexing directly into the mapped data; only the pages of the data
+     * file which are referenced are read from disk and these are shared via
+     * the operating system's page cache with other processes using the same
+     * file.  This gives fast construction even for the 1' grid.  If \e
+     * threadsafe is also true, the data is \e not read into memory and only
+     * the single-cell caching is turned off; the resulting object is thread
+     * safe and uses little memory.  If \e threadsafe is false,
+     * Geoid::CacheArea can be used as before.
+     *
+     * Reading the data for the 1' grid takes a few seconds.  Specifying \e
+     * nthreads > 1 lets several threads read different parts of the data
+     * file at once; this helps if the file is on a solid state drive or is
+     * in the operating system's page cache.  (A tiled data file is always
+     * read with a single thread.)  See also Geoid::LoadAsync.
      **********************************************************************/
     explicit Geoid(const std::string& name, const std::string& path = "",
-                   bool cubic = true, bool threadsafe = false);
+                   bool cubic = true, bool threadsafe = false,
+                   bool mapped = false, int nthreads = 1);
+
+    /**
+     * Construct a thread safe geoid in the background.
+     *
+     * @param[in] name the name of the geoid.
+     * @param[in] path (optional) directory for data file.
+     * @param[in] cubic (optional) interpolation method; false means bilinear,
+     *   true (the default) means cubic.
+     * @param[in] nthreads (optional) the number of threads used to read the
+     *   data.  The default is 1.
+     * @return a future holding the Geoid.
+     *
+     * This starts a thread which constructs the Geoid with \e threadsafe =
+     * true and returns immediately.  The caller can then carry on (e.g., by
+     * answering requests with a coarser geoid) and should check whether the
+     * Geoid is ready with the future's wait_for method before calling get.
+     * Any exception thrown by the constructor is rethrown by get.
+     *
+     * Example of use:
+     * \code
+     * std::future<std::unique_ptr<Geoid>> load =
+     *   Geoid::LoadAsync("egm2008-1", "", true, 4);
+     * Geoid coarse("egm2008-5", "", true, true);
+     * // ... serve requests with coarse until
+     * //   load.wait_for(std::chrono::seconds(0)) == std::future_status::ready
+     * std::unique_ptr<Geoid> fine = load.get();
+     * \endcode
+     **********************************************************************/
+    static std::future<std::unique_ptr<Geoid>>
+    LoadAsync(const std::string& name, const std::string& path = "",
+              bool cubic = true, int nthreads = 1);
+
+    /**
+     * The destructor unmaps the data file if necessary.
+     **********************************************************************/
+    ~Geoid();
 
     /**
      * Set up a cache.
@@ -228,6 +413,8 @@ namespace GeographicLib {
      * @param[in] north latitude (degrees) of the north edge of the cached
      *   area.
      * @param[in] east longitude (degrees) of the east edge of the cached area.
+     * @param[in] nthreads (optional) the number of threads used to read the
+     *   data.  The default is 1.
      * @exception GeographicErr if the memory necessary for caching the data
      *   can't be allocated (in this case, you will have no cache and can try
      *   again with a smaller area).
@@ -239,12 +426,29 @@ namespace GeographicLib {
      * \e east is always interpreted as being east of \e west, if necessary by
      * adding 360&deg; to its value.  \e south and \e north should be in
      * the range [&minus;90&deg;, 90&deg;].
+     *
+     * The cache is a single block of memory.  On Linux systems, a cache of 2
+     * MB or more is aligned to 2 MB and the system is asked to back it with
+     * transparent huge pages (with madvise); this reduces the TLB misses for
+     * queries scattered over a large cache (e.g., the 450 MB needed by
+     * Geoid::CacheAll for the 1' grid).  This is a hint and it is ignored if
+     * transparent huge pages are disabled.
+     *
+     * If \e nthreads > 1, the rows of the area are divided among that many
+     * tasks (run with Executor::Batch), each of which reads its rows with
+     * its own stream, so that the tasks don't share a file position.  This
+     * helps if the file is on a solid state drive or is in the operating
+     * system's page cache.  Each task is given at least 64 rows.  A tiled
+     * data file is always read by a single task.
      **********************************************************************/
-    void CacheArea(real south, real west, real north, real east) const;
+    void CacheArea(real south, real west, real north, real east,
+                   int nthreads = 1) const;
 
     /**
      * Cache all the data.
      *
+     * @param[in] nthreads (optional) the number of threads used to read the
+     *   data (see Geoid::CacheArea).  The default is 1.
      * @exception GeographicErr if the memory necessary for caching the data
      *   can't be allocated (in this case, you will have no cache and can try
      *   again with a smaller area).
@@ -255,8 +459,50 @@ namespace GeographicLib {
      * or coarser.  For a 1' grid, the required RAM is 450MB; a 2.5' grid needs
      * 72MB; and a 5' grid needs 18MB.
      **********************************************************************/
-    void CacheAll() const { CacheArea(real(-Math::qd), real(0),
-                                      real( Math::qd), real(Math::td)); }
+    void CacheAll(int nthreads = 1) const {
+      CacheArea(real(-Math::qd), real(0), real(Math::qd), real(Math::td),
+                nthreads);
+    }
+
+    /**
+     * Set up a cache of the interpolation coefficients.
+     *
+     * @param[in] south latitude (degrees) of the south edge of the cached
+     *   area.
+     * @param[in] west longitude (degrees) of the west edge of the cached area.
+     * @param[in] north latitude (degrees) of the north edge of the cached
+     *   area.
+     * @param[in] east longitude (degrees) of the east edge of the cached area.
+     * @param[in] single if true, store the coefficients as floats (default
+     *   false).
+     * @exception GeographicErr if the memory necessary for caching the
+     *   coefficients can't be allocated (in this case, you will have no
+     *   coefficient cache and can try again with a smaller area).
+     * @exception GeographicErr if there's a problem reading the data.
+     * @exception GeographicErr if this is called on a threadsafe Geoid.
+     *
+     * This computes the interpolation coefficients (10 for cubic
+     * interpolation, 4 for bilinear interpolation) for each grid cell in the
+     * specified area, which is interpreted as for Geoid::CacheArea.  The
+     * height at a point in this area is then given by a single evaluation of
+     * the interpolating polynomial, without having to read the surrounding
+     * data and fit the polynomial.  This benefits queries which jump from
+     * cell to cell, which otherwise make no use of the single-cell cache.
+     * The results are identical to those without the coefficient cache,
+     * unless \e single is true; in this case, the additional error is about
+     * 2<sup>&minus;24</sup> times the range of the heights in the data file
+     * (12 &mu;m for the standard 16-bit geoid files).
+     *
+     * The cache takes 80 bytes per cell (40 bytes if \e single is true) for
+     * cubic interpolation, compared with 2 bytes per cell for the data
+     * cache; e.g., caching the coefficients for a 10&deg; &times; 10&deg;
+     * area takes 29 MB for a 1' grid and 0.13 MB for a 15' grid.  If the
+     * data for the area isn't cached or mapped into memory, it is cached
+     * temporarily while the coefficients are computed.  Geoid::CacheClear
+     * clears this cache together with the data cache.
+     **********************************************************************/
+    void CacheCoeffs(real south, real west, real north, real east,
+                     bool single = false) const;
 
     /**
      * Clear the cache.  This never throws an error.  (This does nothing with a
@@ -264,6 +510,50 @@ namespace GeographicLib {
      **********************************************************************/
     void CacheClear() const;
 
+    /**
+     * Set the maximum memory used by the block cache.
+     *
+     * @param[in] maxbytes the maximum memory (bytes).
+     *
+     * The block cache holds square blocks of the geoid grid (64 &times; 64
+     * pixels for a pgm file; the tiles for a tiled file) as they are
+     * needed, discarding the least recently used blocks to keep the memory
+     * used to no more than \e maxbytes.  Unlike the area cache which holds
+     * a single rectangle, this serves queries scattered over several
+     * regions.  When a cell near the edge of a block is used, the adjacent
+     * blocks are read in anticipation.  The area cache, if set, takes
+     * precedence over the block cache.
+     *
+     * For a pgm file, the block cache is disabled by default and is
+     * disabled by setting \e maxbytes = 0.  For a tiled file, the block
+     * cache is always used (and at least one block is held); its default
+     * size is 16 MB.  This also resets the counts returned by
+     * Geoid::BlockCacheHits and Geoid::BlockCacheMisses.  This does nothing
+     * with a thread safe Geoid or if the data file is mapped into memory.
+     **********************************************************************/
+    void SetBlockCacheSize(size_t maxbytes) const;
+
+    /**
+     * Set the track mode.
+     *
+     * @param[in] ahead the distance (in grid cells) to read ahead; 0 turns
+     *   track mode off.
+     *
+     * In track mode, the geoid heights are assumed to be requested at
+     * successive points along a track (e.g., of a vehicle).  When the track
+     * moves to a new cell, its direction is estimated from the previous cell
+     * and the operating system is asked to read the blocks (see
+     * Geoid::SetBlockCacheSize) covering the next \e ahead cells in this
+     * direction into its page cache, using posix_fadvise or, if the data file
+     * is mapped, madvise.  Because this reading happens in the background,
+     * the data is usually in memory when the track reaches these cells, and
+     * the queries don't wait for the disk.  A jump of more than \e ahead
+     * cells is not treated as motion along the track.  This does nothing
+     * with a thread safe Geoid or on systems without these calls (e.g.,
+     * Windows).
+     **********************************************************************/
+    void SetTrackMode(int ahead) const;
+
     ///@}
 
     /** \name Compute geoid heights
@@ -285,6 +575,40 @@ namespace GeographicLib {
       return height(lat, lon);
     }
 
+    /**
+     * Compute the geoid height and its gradient at a point
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] gradn northerly component of the gradient of the geoid
+     *   height (dimensionless).
+     * @param[out] grade easterly component of the gradient of the geoid
+     *   height (dimensionless).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if (\e lat, \e lon) is within a successfully cached
+     *   area.
+     * @return the height of the geoid above the ellipsoid (meters).
+     *
+     * The gradient is found by differentiating the interpolating polynomial
+     * for the grid cell containing the point; so it costs little more than
+     * the height itself.  It is the rate of change of the height with
+     * distance (measured on the WGS84 ellipsoid) to the north and east;
+     * thus &minus;\e gradn and &minus;\e grade approximate the
+     * components of the deflection of the vertical (radians) implied by the
+     * geoid model.  Because the interpolant is fit separately to each cell,
+     * the gradient is discontinuous at cell boundaries and its errors are
+     * larger, relative to the size of the gradient, than those of the
+     * height.  The results for the components of the deflection are only a
+     * crude approximation to those given by the full gravity model (e.g.,
+     * with GravityModel::Disturbance); they are best used for grids with
+     * fine resolution.  Near the poles, \e grade is computed using
+     * cos(\e lat) &ge; &epsilon;<sup>1/2</sup>; at a pole, the
+     * components depend on the longitude.  The height returned is
+     * identical to that returned by the two-argument version.
+     **********************************************************************/
+    Math::real operator()(real lat, real lon, real& gradn, real& grade) const
+    { return height(lat, lon, gradn, grade); }
+
     /**
      * Convert a height above the geoid to a height above the ellipsoid and
      * vice versa.
@@ -306,6 +630,103 @@ namespace GeographicLib {
       return h + real(d) * height(lat, lon);
     }
 
+    /**
+     * Compute the geoid heights at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if all the points are within a successfully cached
+     *   area.
+     *
+     * The results are the same as calling Geoid::operator()() for each
+     * point.  However, the points are processed in the order of the grid
+     * cells containing them so that the interpolation coefficients for each
+     * cell are computed only once and the data is accessed sequentially.
+     * This makes the cost nearly independent of the order of the points.
+     * The single-cell cache is neither used nor altered; thus this function
+     * may be called by several threads at once on a thread safe Geoid.
+     **********************************************************************/
+    void Heights(size_t n, const real lat[], const real lon[], real h[]) const;
+
+    /**
+     * Compute the geoid heights and their gradients at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the geoid above the ellipsoid
+     *   (meters).
+     * @param[out] gradn array of the northerly components of the gradient
+     *   (dimensionless).
+     * @param[out] grade array of the easterly components of the gradient
+     *   (dimensionless).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens if all the points are within a successfully cached
+     *   area.
+     *
+     * This is the same as the four-argument version of Geoid::Heights
+     * except that the gradients are also computed, as for the four-argument
+     * version of Geoid::operator()().
+     **********************************************************************/
+    void Heights(size_t n, const real lat[], const real lon[], real h[],
+                 real gradn[], real grade[]) const;
+
+    /**
+     * Compute the geoid heights at many points given strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[out] h strided array of heights of the geoid above the
+     *   ellipsoid (meters).
+     * @param[out] gradn strided array of the northerly components of the
+     *   gradient; this may be null.
+     * @param[out] grade strided array of the easterly components of the
+     *   gradient; this must be null if \e gradn is.
+     * @exception GeographicErr if there's a problem reading the data.
+     *
+     * This is the same as the previous versions of Geoid::Heights except
+     * that the elements of each array are StridedArray::stride() bytes
+     * apart, so that the fields of an array of records can be used
+     * directly.
+     **********************************************************************/
+    void Heights(size_t n, StridedArray<const real> lat,
+                 StridedArray<const real> lon, StridedArray<real> h,
+                 StridedArray<real> gradn = nullptr,
+                 StridedArray<real> grade = nullptr) const;
+
+    /**
+     * Convert the heights of many points between the geoid and the
+     * ellipsoid in place.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[in,out] h strided array of heights of the points (meters).
+     * @param[in] d a Geoid::convertflag specifying the direction of the
+     *   conversion.
+     * @exception GeographicErr if there's a problem reading the data.
+     *
+     * This replaces each \e h[\e i] by the result of Geoid::ConvertHeight;
+     * the geoid heights are found with Geoid::Heights.  For example, the
+     * ellipsoidal heights of the points in an array of LAS records can be
+     * converted to orthometric heights with \code
+     struct point { double x, y, z; unsigned short intensity; };
+     std::vector<point> pts(...);
+     StridedArray<const double> lat(&pts[0].y, sizeof(point)),
+                                lon(&pts[0].x, sizeof(point));
+     StridedArray<double> h(&pts[0].z, sizeof(point));
+     geoid.ConvertHeights(pts.size(), lat, lon, h, Geoid::ELLIPSOIDTOGEOID);
+     \endcode
+     **********************************************************************/
+    void ConvertHeights(size_t n, StridedArray<const real> lat,
+                        StridedArray<const real> lon, StridedArray<real> h,
+                        convertflag d) const;
+
     ///@}
 
     /** \name Inspector functions
@@ -383,11 +804,58 @@ namespace GeographicLib {
      **********************************************************************/
     bool ThreadSafe() const { return _threadsafe; }
 
+    /**
+     * @return true if the data file is mapped into memory.
+     **********************************************************************/
+    bool Mapped() const { return _map != nullptr; }
+
+    /**
+     * @return true if the data file is tiled.
+     **********************************************************************/
+    bool Tiled() const { return _tiled; }
+
+    /**
+     * @return the maximum memory used by the block cache (bytes).
+     **********************************************************************/
+    size_t BlockCacheSize() const { return _blocked ? _blockbudget : 0; }
+
+    /**
+     * @return the memory used by the object.
+     *
+     * \e heap is the table of tile offsets of a tiled file, \e mapped is
+     * the size of the mapped data file (0 if it isn't mapped), and \e cache
+     * is the memory held by the area cache, the block cache, and the
+     * coefficient cache.  The result is only consistent if no other thread
+     * is changing the caches.
+     **********************************************************************/
+    MemoryFootprint MemoryUsage() const;
+
+    /**
+     * @return the number of pixel lookups satisfied by the block cache.
+     **********************************************************************/
+    unsigned long long BlockCacheHits() const { return _blockhits; }
+
+    /**
+     * @return the number of pixel lookups which required a block to be read.
+     **********************************************************************/
+    unsigned long long BlockCacheMisses() const { return _blockmisses; }
+
+    /**
+     * @return the read-ahead distance (in grid cells) for track mode; 0 if
+     *   track mode is off.
+     **********************************************************************/
+    int TrackMode() const { return _trackahead; }
+
     /**
      * @return true if a data cache is active.
      **********************************************************************/
     bool Cache() const { return _cache; }
 
+    /**
+     * @return true if a coefficient cache is active.
+     **********************************************************************/
+    bool CoeffCache() const { return _coeffcache; }
+
     /**
      * @return west edge of the cached area; the cache includes this edge.
      **********************************************************************/
@@ -0,0 +1,118 @@
+/**
+ * \file GeoidEvaluator.hpp
+ * \brief Header for GeographicLib::GeoidEvaluator class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_GEOIDEVALUATOR_HPP)
+#define GEOGRAPHICLIB_GEOIDEVALUATOR_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geoid.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Evaluate geoid heights with a private single-cell cache
+   *
+   * A thread safe Geoid (one constructed with \e threadsafe = true) turns
+   * off its single-cell cache, so that successive evaluations in the same
+   * grid cell recompute the interpolation coefficients.  A GeoidEvaluator
+   * refers to a Geoid for the data and holds its own single-cell cache.
+   * Thus several threads can share one thread safe Geoid (which holds or
+   * maps the data once) with each thread using its own GeoidEvaluator
+   * (which is small) and still benefit from the single-cell cache.
+   *
+   * The results are identical to those returned by Geoid::operator()().
+   * The Geoid must outlive the GeoidEvaluators which refer to it.  A
+   * GeoidEvaluator can also be used with a Geoid which is not thread safe;
+   * in this case, the usual restrictions on sharing the Geoid between
+   * threads apply.
+   *
+   * The default copy constructor and assignment operators work with this
+   * class; a copy refers to the same Geoid.
+   *
+   * Example of use:
+   * \include example-GeoidEvaluator.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT GeoidEvaluator {
+  private:
+    typedef Math::real real;
+    static const unsigned nterms_ = Geoid::nterms_;
+    const Geoid* _geoid;
+    // The cell cache
+    int _ix, _iy;
+    real _t[nterms_];
+  public:
+
+    /**
+     * Constructor for a GeoidEvaluator.
+     *
+     * @param[in] geoid the Geoid object supplying the data.
+     **********************************************************************/
+    explicit GeoidEvaluator(const Geoid& geoid);
+
+    /**
+     * Compute the geoid height at a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens with a thread safe Geoid.
+     * @return the height of the geoid above the ellipsoid (meters).
+     *
+     * The latitude should be in [&minus;90&deg;, 90&deg;].
+     **********************************************************************/
+    Math::real operator()(real lat, real lon);
+
+    /**
+     * Compute the geoid height and its gradient at a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] gradn northerly component of the gradient of the geoid
+     *   height (dimensionless).
+     * @param[out] grade easterly component of the gradient of the geoid
+     *   height (dimensionless).
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens with a thread safe Geoid.
+     * @return the height of the geoid above the ellipsoid (meters).
+     *
+     * This is the analog of the four-argument version of
+     * Geoid::operator()().
+     **********************************************************************/
+    Math::real operator()(real lat, real lon, real& gradn, real& grade);
+
+    /**
+     * Convert a height above the geoid to a height above the ellipsoid and
+     * vice versa.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h height of the point (meters).
+     * @param[in] d a Geoid::convertflag specifying the direction of the
+     *   conversion.
+     * @exception GeographicErr if there's a problem reading the data; this
+     *   never happens with a thread safe Geoid.
+     * @return converted height (meters).
+     *
+     * This is the analog of Geoid::ConvertHeight.
+     **********************************************************************/
+    Math::real ConvertHeight(real lat, real lon, real h,
+                             Geoid::convertflag d) {
+      return h + real(d) * (*this)(lat, lon);
+    }
+
+    /**
+     * @return the Geoid object used in the calculations.
+     **********************************************************************/
+    const Geoid& GeoidObject() const { return *_geoid; }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_GEOIDEVALUATOR_HPP
@@ -49,12 +49,33 @@ namespace GeographicLib {
       base_ = 10,               // Base for minutes
       baselen_ = 4,
       maxprec_ = 11,            // approximately equivalent to MGRS class
-      maxlen_ = baselen_ + 2 * maxprec_
+      maxlen_ = baselen_ + 2 * maxprec_,
+      maxintprec_ = 7,          // so that integer georefs fit in 64 bits
+      numlontile_ = 24,         // The number of longitude tiles
+      numlattile_ = 12          // The number of latitude tiles
     };
     Georef() = delete;          // Disable constructor
+    // The precision used for integer georefs
+    static int IntPrecision(int prec) {
+      prec = (std::max)(-1, (std::min)(int(maxintprec_), prec));
+      return prec == 1 ? 2 : prec;
+    }
+    // The number of values of each minutes field of an integer georef
+    static long long MinutesBase(int prec) {
+      long long m = 6;
+      for (int i = 1; i < prec; ++i) m *= base_;
+      return m;
+    }
 
   public:
 
+    /**
+     * The maximum length of a georef string (not counting the terminating
+     * null).  A char buffer of Georef::MAXLENGTH + 1 characters can hold any
+     * result returned by the char[] versions of Georef::Forward.
+     **********************************************************************/
+    enum { MAXLENGTH = maxlen_ };
+
     /**
      * Convert from geographic coordinates to georef.
      *
@@ -81,6 +102,92 @@ namespace GeographicLib {
      **********************************************************************/
     static void Forward(real lat, real lon, int prec, std::string& georef);
 
+    /**
+     * Convert from geographic coordinates to georef in a char buffer.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] prec the precision of the resulting georef.
+     * @param[out] georef a buffer of at least Georef::MAXLENGTH + 1
+     *   characters which receives the null-terminated georef string.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     * @return the length of the georef string.
+     *
+     * This is the same as the std::string version of Georef::Forward, except
+     * that no memory is allocated.
+     **********************************************************************/
+    static int Forward(real lat, real lon, int prec, char georef[]);
+
+    /**
+     * Convert many points from geographic coordinates to georef in a char
+     *   buffer.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] prec the precision of the resulting georef.
+     * @param[out] georef a char buffer of at least \e n &times; \e stride
+     *   characters; the null-terminated georef string for point \e i starts
+     *   at \e georef + \e i &times; \e stride.
+     * @param[in] stride the spacing of the strings in \e georef.
+     * @exception GeographicErr if \e stride is too small to hold a georef
+     *   string with precision \e prec (including the terminating null); \e
+     *   stride = Georef::MAXLENGTH + 1 suffices for all \e prec.
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;]; the results for the preceding points have then been stored.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[], int prec,
+                        char georef[], size_t stride);
+
+    /**
+     * Convert from geographic coordinates to an integer georef.
+     *
+     * @param[in] lat latitude of point (degrees).
+     * @param[in] lon longitude of point (degrees).
+     * @param[in] prec the precision of the georef.
+     * @param[out] code the integer georef.
+     * @exception GeographicErr if \e lat is not in [&minus;90&deg;,
+     *   90&deg;].
+     *
+     * The integer georef packs the fields of the string georef, most
+     * significant first.  For \e prec = &minus;1, \e code = 12 \e t<sub>x</sub>
+     * + \e t<sub>y</sub>, where \e t<sub>x</sub> in [0, 24) and \e
+     * t<sub>y</sub> in [0, 12) are the indices of the two tile letters; for
+     * \e prec = 0, this is multiplied by 15<sup>2</sup> and 15 \e
+     * d<sub>x</sub> + \e d<sub>y</sub> is added, where \e d<sub>x</sub> and
+     * \e d<sub>y</sub> in [0, 15) are the indices of the degree letters; for
+     * \e prec &ge; 2, this is multiplied by <i>M</i><sup>2</sup> and \e M \e
+     * x + \e y is added, where \e x and \e y in [0, \e M) are the numbers
+     * given by the longitude and latitude digits and \e M = 6 &times;
+     * 10<sup><i>prec</i>&minus;1</sup>.  Internally, \e prec is first put in
+     * the range [&minus;1, 7] (so that \e code fits in 64 bits) and \e prec
+     * = 1 is treated as \e prec = 2.  Integer georefs with the same \e prec
+     * may be compared and sorted in the same way as the corresponding
+     * strings.
+     *
+     * If \e lat or \e lon is NaN, the returned \e code is ~0ULL (all bits
+     * set), which is not a legal code for any \e prec.
+     **********************************************************************/
+    static void Forward(real lat, real lon, int prec, unsigned long long& code);
+
+    /**
+     * Convert many points from geographic coordinates to integer georefs.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes (degrees).
+     * @param[in] lon array of longitudes (degrees).
+     * @param[in] prec the precision of the georefs.
+     * @param[out] code array of integer georefs.
+     * @exception GeographicErr if any \e lat is not in [&minus;90&deg;,
+     *   90&deg;]; the results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.  The
+     * points are processed in blocks with a loop without branches.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[], int prec,
+                        unsigned long long code[]);
+
     /**
      * Convert from Georef to geographic coordinates.
      *
@@ -110,6 +217,43 @@ namespace GeographicLib {
     static void Reverse(const std::string& georef, real& lat, real& lon,
                         int& prec, bool centerp = true);
 
+    /**
+     * Convert from an integer georef to geographic coordinates.
+     *
+     * @param[in] code the integer georef.
+     * @param[in] prec the precision of the georef.
+     * @param[out] lat latitude of point (degrees).
+     * @param[out] lon longitude of point (degrees).
+     * @param[in] centerp if true (the default) return the center of the
+     *   georef, otherwise return the south-west corner.
+     * @exception GeographicErr if \e code is illegal for \e prec.
+     *
+     * \e prec is interpreted as in the integer version of Georef::Forward.
+     * If \e code is ~0ULL, then \e lat and \e lon are set to NaN.  The
+     * results are the same as those given by the string version of
+     * Georef::Reverse.
+     **********************************************************************/
+    static void Reverse(unsigned long long code, int prec,
+                        real& lat, real& lon, bool centerp = true);
+
+    /**
+     * Convert many integer georefs to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] code array of integer georefs.
+     * @param[in] prec the precision of the georefs.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[in] centerp if true (the default) return the centers of the
+     *   georefs, otherwise return the south-west corners.
+     * @exception GeographicErr if any \e code is illegal for \e prec; the
+     *   results for the preceding points have then been stored.
+     *
+     * This is equivalent to calling the scalar version for each point.
+     **********************************************************************/
+    static void Reverse(size_t n, const unsigned long long code[], int prec,
+                        real lat[], real lon[], bool centerp = true);
+
     /**
      * The angular resolution of a Georef.
      *
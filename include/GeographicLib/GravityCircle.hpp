@@ -74,6 +74,17 @@ namespace GeographicLib {
     Math::real InternalT(real slam, real clam,
                          real& deltaX, real& deltaY, real& deltaZ,
                          bool gradp, bool correct) const;
+    // Complete the calculations of V (or W if rotp) and T given the results
+    // of the corresponding CircularEngine and the spherical anomaly given T
+    // and the disturbance.
+    Math::real FinishV(real slam, real clam, real Vres,
+                       real& GX, real& GY, real& GZ, bool rotp) const;
+    Math::real FinishT(real slam, real clam, real T,
+                       real& deltaX, real& deltaY, real& deltaZ,
+                       bool gradp, bool correct) const;
+    void FinishAnomaly(real slam, real clam, real T,
+                       real deltax, real deltay, real deltaz,
+                       real& Dg01, real& xi, real& eta) const;
   public:
     /**
      * A default constructor for the normal gravity.  This sets up an
@@ -149,6 +160,43 @@ namespace GeographicLib {
     void SphericalAnomaly(real lon, real& Dg01, real& xi, real& eta)
       const;
 
+    /**
+     * Evaluate a quantity at uniformly spaced longitudes.
+     *
+     * @param[in] what the quantity to compute, one of GravityModel::GRAVITY,
+     *   GravityModel::DISTURBANCE, GravityModel::DISTURBING_POTENTIAL,
+     *   GravityModel::GEOID_HEIGHT, or GravityModel::SPHERICAL_ANOMALY.
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] n the number of longitudes.
+     * @param[out] out1 array of the first component of the result.
+     * @param[out] out2 (optional) array of the second component.
+     * @param[out] out3 (optional) array of the third component.
+     * @exception GeographicErr if \e what is not one of the allowed values.
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * The quantity is evaluated at longitudes \e lon0 + \e i \e dlon for
+     * \e i in [0, \e n).  The components are
+     * - GravityModel::GRAVITY: \e gx, \e gy, \e gz as returned by Gravity;
+     * - GravityModel::DISTURBANCE: \e deltax, \e deltay, \e deltaz as
+     *   returned by Disturbance;
+     * - GravityModel::DISTURBING_POTENTIAL: \e T as returned by T(real);
+     * - GravityModel::GEOID_HEIGHT: \e N as returned by GeoidHeight;
+     * - GravityModel::SPHERICAL_ANOMALY: \e Dg01, \e xi, \e eta as returned
+     *   by SphericalAnomaly.
+     * .
+     * Null arrays are not set.  The sums over order are evaluated with
+     * CircularEngine::Grid; if 360&deg;/\e dlon is a simple fraction (see
+     * that function), this uses an FFT which is much faster than evaluating
+     * the points individually.  The results agree with those for the
+     * individual points to within roundoff.  If the GravityCircle was not
+     * constructed with the capabilities needed for \e what, the results are
+     * NaNs.
+     **********************************************************************/
+    void Grid(unsigned what, real lon0, real dlon, size_t n,
+              real out1[], real out2[] = nullptr, real out3[] = nullptr)
+      const;
+
     /**
      * Evaluate the components of the acceleration due to gravity and the
      * centrifugal acceleration in geocentric coordinates.
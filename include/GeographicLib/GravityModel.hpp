@@ -11,9 +11,15 @@
 #define GEOGRAPHICLIB_GRAVITYMODEL_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/MemoryFootprint.hpp>
 #include <GeographicLib/NormalGravity.hpp>
 #include <GeographicLib/SphericalHarmonic.hpp>
 #include <GeographicLib/SphericalHarmonic1.hpp>
+#include <iosfwd>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector
@@ -91,14 +97,62 @@ namespace GeographicLib {
     SphericalHarmonic::normalization _norm;
     NormalGravity _earth;
     std::vector<real> _cCx, _sSx, _cCC, _cCS, _zonal;
+    // The coefficients of the model stored as floats (if compact)
+    std::vector<float> _cCf, _sSf;
+    real _compacterr;
+    // The mapped coefficient file (if mapped)
+    char* _map;
+    size_t _mapsize;
     real _dzonal0;              // A left over contribution to _zonal.
     SphericalHarmonic _gravitational;
     SphericalHarmonic1 _disturbing;
     SphericalHarmonic _correction;
+    // The minimum number of points on a circle for which a GravityCircle is
+    // used by the batch functions
+    static const size_t mincircle_ = 2;
+    // The number of rows whose circles are constructed together by Grid
+    static const size_t gridrows_ = 8;
+    // The circle cache, GravityCircle objects with all the capabilities
+    // indexed by latitude and height, most recently used first.
+    typedef std::pair<real, real> circlekey;
+    typedef std::list< std::pair< circlekey,
+                                  std::shared_ptr<const GravityCircle> > >
+    circlelist;
+    mutable std::mutex _circlelock;
+    mutable circlelist _circlelru;
+    mutable std::map<circlekey, circlelist::iterator> _circlemap;
+    mutable size_t _circlebytes;
+    size_t _circlebudget;
+    mutable unsigned long long _circlehits, _circlemisses;
+    // The accuracy for the truncated evaluations (0 for no truncation) and
+    // the degree variances of the model, computed on first use.
+    real _accuracy;
+    mutable std::once_flag _degvarflag;
+    mutable std::vector<real> _degvar;
+    // The degree to which the sums are truncated for the accuracy.
+    int TruncationDegreeR(real R, real accuracy) const;
+    int Truncation(real R) const;
+    // The approximate memory used by a cached circle
+    size_t CircleBytes() const;
+    // Return the circle for lat and h from the cache, constructing it if
+    // necessary; null if the circle cache is off or lat or h is not finite.
+    std::shared_ptr<const GravityCircle> CachedCircle(real lat, real h) const;
     void ReadMetadata(const std::string& name);
+    void MapFile(const std::string& filename, size_t size);
+    void UnmapFile();
+    // Group the points by latitude and height and call f(i, c) for each
+    // point, where c is (a pointer to) a GravityCircle with capabilities
+    // caps for the point's circle or null.
+    template<class F>
+    void Batch(size_t n, const real lat[], const real h[], unsigned caps,
+               F f) const;
     Math::real InternalT(real X, real Y, real Z,
                          real& deltaX, real& deltaY, real& deltaZ,
                          bool gradp, bool correct) const;
+    // Construct the circles for n latitudes at height h together; a single
+    // circle is constructed using nthreads threads.
+    void Circles(size_t n, const real lat[], real h, unsigned caps,
+                 GravityCircle circ[], int nthreads = 1) const;
     GravityModel(const GravityModel&) = delete; // copy constructor not allowed
     // nor copy assignment
     GravityModel& operator=(const GravityModel&) = delete;
@@ -171,6 +225,10 @@ namespace GeographicLib {
      *   model this value.
      * @param[in] Mmax (optional) if non-negative, truncate the order of the
      *   model this value.
+     * @param[in] compact (optional) if true, store the coefficients of the
+     *   model as floats (default false).
+     * @param[in] mapped (optional) if true, map the coefficient file into
+     *   memory instead of reading it (default false).
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt, or if \e Mmax > \e Nmax.
      * @exception std::bad_alloc if the memory necessary for storing the model
@@ -189,10 +247,37 @@ namespace GeographicLib {
      * If \e Nmax &ge; 0 and \e Mmax < 0, then \e Mmax is set to \e Nmax.
      * After the model is loaded, the maximum degree and order of the model can
      * be found by the Degree() and Order() methods.
+     *
+     * If \e compact = true, the coefficients of the model are rounded to
+     * floats, which halves the memory needed to hold them; e.g., for egm2008
+     * this drops from 37 MB to 19 MB.  The small correction model and the
+     * normal zonal terms are still stored as reals.  The resulting rms error
+     * in the geoid height is given by CompactError(); for egm2008 this is a
+     * fraction of a millimeter.  Truncating the model with \e Nmax and \e
+     * Mmax is another way to reduce the memory footprint (at the cost of
+     * losing the short wavelength variations of the field).
+     *
+     * If \e mapped = true, the coefficient file is mapped into the address
+     * space of the process (using mmap on Unix systems and MapViewOfFile on
+     * Windows systems) and the spherical harmonic sums use the coefficients
+     * in place.  Construction is then nearly instantaneous, even for egm2008,
+     * and the pages of the file are shared via the operating system's page
+     * cache with other processes using the same model.  (The page holding the
+     * degree 0 term is modified and so is copied for each process.)  This
+     * requires a little-endian machine with GEOGRAPHICLIB_PRECISION = 2.
+     * Truncating the model with \e Nmax and \e Mmax works as before, but the
+     * whole file remains mapped.  \e mapped is ignored if \e compact =
+     * true.
      **********************************************************************/
     explicit GravityModel(const std::string& name,
                           const std::string& path = "",
-                          int Nmax = -1, int Mmax = -1);
+                          int Nmax = -1, int Mmax = -1,
+                          bool compact = false, bool mapped = false);
+
+    /**
+     * The destructor unmaps the coefficient file if necessary.
+     **********************************************************************/
+    ~GravityModel();
     ///@}
 
     /** \name Compute gravity in geodetic coordinates
@@ -318,6 +403,36 @@ namespace GeographicLib {
     Math::real V(real X, real Y, real Z,
                  real& GX, real& GY, real& GZ) const;
 
+    /**
+     * Evaluate the gravity gradient tensor in geocentric coordinates.
+     *
+     * @param[in] X geocentric coordinate of point (meters).
+     * @param[in] Y geocentric coordinate of point (meters).
+     * @param[in] Z geocentric coordinate of point (meters).
+     * @param[out] gX the \e X component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gY the \e Y component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gZ the \e Z component of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] Gamma the 6 independent components of the gravity gradient
+     *   tensor, the second derivatives of \e W, in the order \e XX, \e XY,
+     *   \e XZ, \e YY, \e YZ, \e ZZ (s<sup>&minus;2</sup>).
+     * @return \e W = \e V + &Phi; the sum of the gravitational and
+     *   centrifugal potentials (m<sup>2</sup> s<sup>&minus;2</sup>).
+     *
+     * This is the same as GravityModel::W, except that the second
+     * derivatives are found as well.  These are accumulated in the same
+     * summation as the acceleration (see SphericalEngine::Hessian) so that
+     * this costs only about 30% more than GravityModel::W.  The centrifugal
+     * potential contributes &omega;<sup>2</sup> to the \e XX and \e YY
+     * components.  Multiply by 10<sup>9</sup> to convert the components to
+     * E&ouml;tv&ouml;s units.
+     **********************************************************************/
+    Math::real GravityGradient(real X, real Y, real Z,
+                               real& gX, real& gY, real& gZ,
+                               real Gamma[]) const;
+
     /**
      * Evaluate the components of the gravity disturbance in geocentric
      * coordinates.
@@ -431,10 +546,324 @@ namespace GeographicLib {
     GravityCircle Circle(real lat, real h, unsigned caps = ALL) const;
     ///@}
 
+    /** \name Compute gravity at many points
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the gravity at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] gx array of easterly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gy array of northerly components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gz array of upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] W array of the sums of the gravitational and centrifugal
+     *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>); this may be null.
+     *
+     * This is equivalent to calling GravityModel::Gravity for each point.
+     * However, the points which share the same \e lat and \e h (e.g., the
+     * rows of a grid) are grouped and computed with a GravityCircle.  For a
+     * grid with many points in each row, the cost per point is then
+     * proportional to the degree of the model instead of its square; this
+     * is a speed up of several hundred for EGM2008.  The points need not be
+     * in any particular order.  The results can differ from those of
+     * GravityModel::Gravity because of roundoff.
+     **********************************************************************/
+    void GravityBatch(size_t n,
+                      const real lat[], const real lon[], const real h[],
+                      real gx[], real gy[], real gz[], real W[] = nullptr)
+      const;
+
+    /**
+     * Evaluate the gravity disturbance vector at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] deltax array of easterly components of the disturbance
+     *   vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltay array of northerly components of the disturbance
+     *   vector (m s<sup>&minus;2</sup>).
+     * @param[out] deltaz array of upward components of the disturbance
+     *   vector (m s<sup>&minus;2</sup>).
+     * @param[out] T array of disturbing potentials
+     *   (m<sup>2</sup> s<sup>&minus;2</sup>); this may be null.
+     *
+     * This is the batch version of GravityModel::Disturbance; see
+     * GravityModel::GravityBatch for details.
+     **********************************************************************/
+    void DisturbanceBatch(size_t n,
+                          const real lat[], const real lon[], const real h[],
+                          real deltax[], real deltay[], real deltaz[],
+                          real T[] = nullptr) const;
+
+    /**
+     * Evaluate the geoid height at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[out] N array of heights of the geoid above the
+     *   ReferenceEllipsoid() (meters).
+     *
+     * This is the batch version of GravityModel::GeoidHeight; see
+     * GravityModel::GravityBatch for details.
+     **********************************************************************/
+    void GeoidHeightBatch(size_t n, const real lat[], const real lon[],
+                          real N[]) const;
+
+    /**
+     * Evaluate the components of the gravity anomaly vector using the
+     * spherical approximation at many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] lon array of geographic longitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] Dg01 array of gravity anomalies (m s<sup>&minus;2</sup>).
+     * @param[out] xi array of northerly components of the deflection of the
+     *   vertical (degrees).
+     * @param[out] eta array of easterly components of the deflection of the
+     *   vertical (degrees).
+     *
+     * This is the batch version of GravityModel::SphericalAnomaly; see
+     * GravityModel::GravityBatch for details.
+     **********************************************************************/
+    void SphericalAnomalyBatch(size_t n, const real lat[], const real lon[],
+                               const real h[],
+                               real Dg01[], real xi[], real eta[]) const;
+
+    /**
+     * Evaluate a quantity on a regular grid of latitudes and longitudes.
+     *
+     * @param[in] lat0 the first latitude (degrees).
+     * @param[in] dlat the latitude spacing (degrees).
+     * @param[in] nlat the number of latitudes.
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[in] what the quantity to compute, one of GravityModel::GRAVITY,
+     *   GravityModel::DISTURBANCE, GravityModel::DISTURBING_POTENTIAL,
+     *   GravityModel::GEOID_HEIGHT, or GravityModel::SPHERICAL_ANOMALY.
+     * @param[out] out1 array of the first component of the result.
+     * @param[out] out2 (optional) array of the second component.
+     * @param[out] out3 (optional) array of the third component.
+     * @exception GeographicErr if \e what is not one of the allowed values.
+     * @exception std::bad_alloc if the memory for the GravityCircle objects
+     *   can't be allocated.
+     *
+     * The grid points are at latitudes \e lat0 + \e i \e dlat for \e i in
+     * [0, \e nlat) and longitudes \e lon0 + \e j \e dlon for \e j in [0, \e
+     * nlon); the results are stored in row-major order, so the result for
+     * (\e i, \e j) is in element <i>i</i> \e nlon + \e j of the output
+     * arrays, which must each hold \e nlat &times; \e nlon elements (or be
+     * null).  The components of the results are given in GravityCircle::Grid;
+     * \e h is ignored for GravityModel::GEOID_HEIGHT.
+     *
+     * A GravityCircle is constructed for each row and the row is evaluated
+     * with GravityCircle::Grid; the circles for blocks of adjacent rows are
+     * constructed together (see SphericalEngine::Circles) so that the
+     * coefficients are read once per block instead of once per row.  If
+     * 360&deg;/\e dlon is a simple fraction, the sum over order is evaluated
+     * with an FFT.  The cost of a row is then dominated by the
+     * <i>O</i>(<i>N</i><sup>2</sup>) construction of the circle (\e N is the
+     * degree of the model) instead of the <i>O</i>(<i>N</i> \e nlon) cost of
+     * summing over order at each point.  The blocks of rows are divided
+     * among Threads() threads.
+     **********************************************************************/
+    void Grid(real lat0, real dlat, size_t nlat,
+              real lon0, real dlon, size_t nlon, real h,
+              unsigned what,
+              real out1[], real out2[] = nullptr, real out3[] = nullptr) const;
+
+    /**
+     * Write a global grid of geoid heights in the PGM format read by Geoid.
+     *
+     * @param[out] os the output stream, which should be opened in binary
+     *   mode.
+     * @param[in] ndeg the number of grid intervals per degree, e.g., 12 for
+     *   a 5' grid or 60 for a 1' grid.
+     * @param[in] offset the offset of the heights (meters), default
+     *   &minus;108 m.
+     * @param[in] scale the quantization of the heights (meters), default 3
+     *   mm.
+     * @exception GeographicErr if \e ndeg or \e scale isn't positive, if a
+     *   height can't be represented with \e offset and \e scale, or if
+     *   there's an error writing to \e os.
+     * @exception std::bad_alloc if the memory for the rows can't be
+     *   allocated.
+     *
+     * The grid has 180 \e ndeg + 1 rows of 360 \e ndeg points; the rows are
+     * written from north to south and each row starts at longitude 0, as
+     * required by Geoid.  The height is stored as \e offset + \e scale
+     * &times; \e pixel, where \e pixel is a big-endian unsigned integer of
+     * the width given by GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH.  The heights
+     * are computed with GravityModel::Grid in blocks of rows, which are
+     * divided among Threads() threads, and written as each block is
+     * finished.  Thus the rows are constructed with GravityCircle and summed
+     * over order with an FFT and only a few rows are held in memory.  The
+     * header includes the \e Offset and \e Scale needed by Geoid; the
+     * interpolation errors are not computed (so Geoid::MaxError and
+     * Geoid::RMSError return &minus;1).  The output can be converted into
+     * the tiled format with the GeoidToTiles example.
+     **********************************************************************/
+    void GeoidPGM(std::ostream& os, int ndeg,
+                  real offset = -108, real scale = real(0.003)) const;
+    ///@}
+
+    /**
+     * Set the number of threads used for each evaluation.
+     *
+     * @param[in] nthreads the number of threads (default 1).
+     *
+     * With \e nthreads &gt; 1, each spherical harmonic sum evaluated by the
+     * functions computing the field at a single point is divided among up
+     * to \e nthreads threads (see SphericalEngine::Value).  This reduces the
+     * latency of a single evaluation for a high-degree model, e.g., EGM2008;
+     * it does not help when many points are needed (instead use
+     * GravityModel::Circle, the batch functions, or separate threads for
+     * different points).  GravityModel::Circle divides the orders of the
+     * inner sums among the threads (see SphericalEngine::Circle) and
+     * GravityModel::Grid uses \e nthreads threads to evaluate the rows of
+     * the grid.  This does not change the thread safety of GravityModel;
+     * however, it should not be called while other threads are using the
+     * object.
+     **********************************************************************/
+    void SetThreads(int nthreads);
+
+    /**
+     * Set the maximum memory used by the circle cache.
+     *
+     * @param[in] maxbytes the maximum memory (bytes); 0 (the default) turns
+     *   off the cache.
+     *
+     * The circle cache holds GravityCircle objects for the latitudes and
+     * heights of recent queries, discarding the least recently used ones to
+     * keep the memory used to no more than \e maxbytes.  When the cache is
+     * on, the functions computing the field at a single point given by \e
+     * lat, \e lon, and \e h (GravityModel::Gravity, GravityModel::Disturbance,
+     * GravityModel::GeoidHeight, and GravityModel::SphericalAnomaly) and the
+     * batch functions get the circle for \e lat and \e h from the cache
+     * (creating it if necessary) and evaluate the field with it.  This
+     * benefits workloads which query the same few circles repeatedly, e.g.,
+     * repeated scans along the rows of a raster.  The cost of a query on a
+     * cached circle is proportional to the degree \e N of the model instead
+     * of \e N<sup>2</sup>.  However, a miss costs a few times as much as a
+     * point evaluation.  The keys must match exactly (no quantization is
+     * done).  The results can differ from those without the cache because
+     * of roundoff.  Each circle for EGM2008 takes about 240 kB.
+     *
+     * The cache may be used by several threads at once.  This also resets
+     * the counts returned by GravityModel::CircleCacheHits and
+     * GravityModel::CircleCacheMisses.  It should not be called while other
+     * threads are using the object.
+     **********************************************************************/
+    void SetCircleCacheSize(size_t maxbytes);
+
+    /**
+     * Truncate the spherical harmonic sums to give a requested accuracy.
+     *
+     * @param[in] accuracy the accuracy of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>); 0 (the default) turns off the truncation.
+     * @exception GeographicErr if \e accuracy is negative or not finite.
+     *
+     * With \e accuracy &gt; 0, the harmonic sums for the gravitational
+     * potential and the disturbing potential are truncated at the degree
+     * given by GravityModel::TruncationDegree for the radius of each point
+     * (or circle).  Because the contributions of the high degree terms are
+     * attenuated by (\e a/\e r)<sup>\e n</sup>, this is a large saving
+     * for points well above the earth, e.g., at satellite altitudes; at the
+     * surface of the earth, the full model is typically needed for
+     * accuracies smaller than 10<sup>&minus;5</sup> m s<sup>&minus;2</sup>
+     * (1 mGal).  All the functions computing the field (including
+     * GravityModel::Circle, the batch functions, the potentials, and the
+     * geoid height) are truncated at the same degree.  The correction to
+     * the geoid height is not truncated.  This also clears the circle
+     * cache.  It should not be called while other threads are using the
+     * object.
+     **********************************************************************/
+    void SetAccuracy(real accuracy);
+
+    /**
+     * The degree needed to achieve a given accuracy.
+     *
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[in] accuracy the accuracy of the gravity disturbance
+     *   (m s<sup>&minus;2</sup>).
+     * @return the smallest degree \e N for which the RMS of the omitted
+     *   terms of the gravity disturbance does not exceed \e accuracy.
+     *
+     * The RMS is estimated from the degree variances of the coefficients,
+     * &sigma;<sub>\e n</sub><sup>2</sup> = &sum;<sub>\e m</sub>
+     * (\e C<sub>\e nm</sub><sup>2</sup> + \e S<sub>\e nm</sub><sup>2</sup>)
+     * (fully normalized), as
+     * (\e GM/\e r<sup>2</sup>) [&sum;<sub>\e n &gt; \e N</sub>
+     * (\e n + 1)(2\e n + 1) (\e a/\e r)<sup>2\e n</sup>
+     * &sigma;<sub>\e n</sub><sup>2</sup>]<sup>1/2</sup>.
+     * This is the RMS over a sphere of radius \e r; individual points may
+     * have errors several times larger.  Here \e r is the
+     * polar radius of the reference ellipsoid plus \e h, which gives a
+     * conservative estimate.  The result does not exceed Degree().  The
+     * degree variances are computed on the first call to this function or
+     * GravityModel::SetAccuracy (taking a few milliseconds for EGM2008).
+     **********************************************************************/
+    int TruncationDegree(real h, real accuracy) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
 
+    /**
+     * @return the number of threads used for each evaluation.
+     **********************************************************************/
+    int Threads() const { return _gravitational.Threads(); }
+
+    /**
+     * @return the maximum memory used by the circle cache (bytes); 0 if the
+     *   cache is off.
+     **********************************************************************/
+    size_t CircleCacheSize() const { return _circlebudget; }
+
+    /**
+     * @return the memory used by the object.
+     *
+     * \e heap is the coefficients of the model held in memory (0 for the
+     * coefficients of a mapped model), \e mapped is the size of the mapped
+     * coefficient file, and \e cache is the memory held by the circle cache.
+     * The memory used by the table of square roots, which is shared by all
+     * the models, is given by MemoryFootprint::Shared.
+     **********************************************************************/
+    MemoryFootprint MemoryUsage() const;
+
+    /**
+     * @return the accuracy used to truncate the sums
+     *   (m s<sup>&minus;2</sup>); 0 if they're not truncated.
+     **********************************************************************/
+    Math::real Accuracy() const { return _accuracy; }
+
+    /**
+     * @return the number of queries for which the circle was in the cache.
+     **********************************************************************/
+    unsigned long long CircleCacheHits() const {
+      std::lock_guard<std::mutex> g(_circlelock);
+      return _circlehits;
+    }
+
+    /**
+     * @return the number of queries for which the circle was constructed.
+     **********************************************************************/
+    unsigned long long CircleCacheMisses() const {
+      std::lock_guard<std::mutex> g(_circlelock);
+      return _circlemisses;
+    }
+
     /**
      * @return the NormalGravity object for the reference ellipsoid.
      **********************************************************************/
@@ -508,6 +937,27 @@ namespace GeographicLib {
      * @return \e Mmax the maximum order of the components of the model.
      **********************************************************************/
     int Order() const { return _mmx; }
+
+    /**
+     * @return true if the coefficients of the model are stored as floats.
+     **********************************************************************/
+    bool Compact() const { return !_cCf.empty(); }
+
+    /**
+     * @return the rms error in the geoid height (meters) resulting from
+     *   storing the coefficients as floats.
+     *
+     * This is the root-mean-square over the sphere of radius
+     * ModelRadius() of the change in the disturbing potential divided by
+     * the normal gravity there; it is 0 unless the model was constructed
+     * with \e compact = true.
+     **********************************************************************/
+    Math::real CompactError() const { return _compacterr; }
+
+    /**
+     * @return true if the coefficient file is mapped into memory.
+     **********************************************************************/
+    bool Mapped() const { return _map != nullptr; }
     ///@}
 
     /**
@@ -0,0 +1,369 @@
+/**
+ * \file Instrument.hpp
+ * \brief Header for GeographicLib::Instrument class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_INSTRUMENT_HPP)
+#define GEOGRAPHICLIB_INSTRUMENT_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+
+#if !defined(GEOGRAPHICLIB_INSTRUMENT)
+/**
+ * Whether the iterative solvers record their iteration counts with
+ * Instrument::Record.  This is set by the cmake option
+ * GEOGRAPHICLIB_INSTRUMENT (default OFF) and is recorded in Config.h.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_INSTRUMENT 0
+#endif
+
+#if GEOGRAPHICLIB_INSTRUMENT
+/**
+ * Record a call to the iterative solver \e s (one of the Instrument::solver
+ * enums, without the qualification) which took \e n iterations; \e f is
+ * true if the solver fell back to bisection or failed to converge.  This
+ * expands to nothing unless GEOGRAPHICLIB_INSTRUMENT is set.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_INSTRUMENT_RECORD(s, n, f)                      \
+  GeographicLib::Instrument::Record(GeographicLib::Instrument::s,       \
+                                    unsigned(n), bool(f))
+#else
+#  define GEOGRAPHICLIB_INSTRUMENT_RECORD(s, n, f)                      \
+  do { (void)(n); (void)(f); } while (false)
+#endif
+
+#if !defined(GEOGRAPHICLIB_TRACE)
+/**
+ * Whether the library marks the beginning and end of its expensive phases
+ * (loading models, summing spherical harmonics, etc.) with calls to the
+ * function set by Instrument::SetTracer.  This is set by the cmake option
+ * GEOGRAPHICLIB_TRACE (default OFF) and is recorded in Config.h.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_TRACE 0
+#endif
+
+#if GEOGRAPHICLIB_TRACE
+/**
+ * Trace the rest of the enclosing block as phase \e p (one of the
+ * Instrument::phase enums, without the qualification).  This expands to
+ * nothing unless GEOGRAPHICLIB_TRACE is set.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_TRACE_SCOPE(p)                                  \
+  GeographicLib::Instrument::Scope                                      \
+  geographiclib_trace_scope_(GeographicLib::Instrument::p)
+#else
+#  define GEOGRAPHICLIB_TRACE_SCOPE(p) do {} while (false)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Counters for the iterative solvers
+   *
+   * Several classes solve for their results iteratively, e.g., the solution
+   * of the inverse geodesic problem in Geodesic and GeodesicExact by Newton's
+   * method (with a fallback to bisection) and the inverse projections in
+   * Gnomonic, AlbersEqualArea, and TransverseMercatorExact.  If the library
+   * is compiled with GEOGRAPHICLIB_INSTRUMENT = 1 (the cmake option
+   * GEOGRAPHICLIB_INSTRUMENT), each call to these solvers records the number
+   * of iterations in counters private to the calling thread, so that the cost
+   * of recording is a few increments with no synchronization.  Instrument::
+   * Snapshot sums the counters over all the threads (including threads which
+   * have exited).  This allows slow calls to be attributed to particular
+   * convergence behavior.  If GEOGRAPHICLIB_INSTRUMENT = 0 (the default),
+   * nothing is recorded and the counters remain zero.
+   *
+   * Independently, if the library is compiled with GEOGRAPHICLIB_TRACE = 1
+   * (the cmake option GEOGRAPHICLIB_TRACE), the expensive phases listed in
+   * Instrument::phase are bracketed by calls to a user-supplied function
+   * set with Instrument::SetTracer.  This function can forward the events
+   * to a profiler, e.g., by calling \c __itt_task_begin and \c
+   * __itt_task_end (Intel ITT), by starting and ending a zone (Tracy), or
+   * by writing trace events (Perfetto), so that time spent inside the
+   * library can be attributed to these phases.  If GEOGRAPHICLIB_TRACE = 0
+   * (the default), the phases are not marked and there's no cost.
+   *
+   * Example of use:
+   * \code
+   *   Instrument::Reset();
+   *   ... calls to Geodesic::Inverse, etc. ...
+   *   Instrument::Counts c = Instrument::Snapshot(Instrument::GEODESIC);
+   *   std::cout << c.calls << " " << c.iterations << " "
+   *             << c.fallbacks << "\n";
+   * \endcode
+   *
+   * Example of tracing:
+   * \code
+   *   void mytracer(Instrument::phase p, bool begin) {
+   *     std::cerr << (begin ? "begin " : "end ")
+   *               << Instrument::Name(p) << "\n";
+   *   }
+   *   ...
+   *   Instrument::SetTracer(mytracer);
+   *   GravityModel g("egm96");     // traced as GRAVITYMODEL_LOAD
+   * \endcode
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT Instrument {
+  public:
+    /**
+     * The instrumented solvers.
+     **********************************************************************/
+    enum solver {
+      /**
+       * The solution for &alpha;<sub>1</sub> in Geodesic::Inverse, etc.
+       * @hideinitializer
+       **********************************************************************/
+      GEODESIC = 0,
+      /**
+       * The solution for &alpha;<sub>1</sub> in GeodesicExact::Inverse,
+       * etc.
+       * @hideinitializer
+       **********************************************************************/
+      GEODESICEXACT,
+      /**
+       * Newton's method in Gnomonic::Reverse.
+       * @hideinitializer
+       **********************************************************************/
+      GNOMONIC,
+      /**
+       * Newton's method for the latitude in AlbersEqualArea::Reverse.
+       * @hideinitializer
+       **********************************************************************/
+      ALBERSEQUALAREA,
+      /**
+       * Newton's method in TransverseMercatorExact::Forward.
+       * @hideinitializer
+       **********************************************************************/
+      TMEXACT_ZETAINV,
+      /**
+       * Newton's method in TransverseMercatorExact::Reverse.
+       * @hideinitializer
+       **********************************************************************/
+      TMEXACT_SIGMAINV,
+      /**
+       * The basic algorithm used by Intersect.
+       * @hideinitializer
+       **********************************************************************/
+      INTERSECT,
+      /**
+       * The number of solvers.
+       * @hideinitializer
+       **********************************************************************/
+      NUMSOLVERS,
+    };
+
+    /**
+     * The traced phases.
+     **********************************************************************/
+    enum phase {
+      /**
+       * Reading the data file in the Geoid constructor.
+       * @hideinitializer
+       **********************************************************************/
+      GEOID_LOAD = 0,
+      /**
+       * Reading the data for an area into memory with Geoid::CacheArea and
+       * Geoid::CacheAll.
+       * @hideinitializer
+       **********************************************************************/
+      GEOID_CACHE,
+      /**
+       * Reading the metadata and coefficients in the GravityModel
+       * constructor.
+       * @hideinitializer
+       **********************************************************************/
+      GRAVITYMODEL_LOAD,
+      /**
+       * Reading the metadata and coefficients in the MagneticModel
+       * constructor.
+       * @hideinitializer
+       **********************************************************************/
+      MAGNETICMODEL_LOAD,
+      /**
+       * Summing a spherical harmonic series at a point (or, for the batch
+       * functions, a block of points) in SphericalEngine; this underlies
+       * SphericalHarmonic, GravityModel, MagneticModel, etc.
+       * @hideinitializer
+       **********************************************************************/
+      SPHERICAL_SUM,
+      /**
+       * Setting up a CircularEngine in SphericalEngine::Circle and
+       * SphericalEngine::Circles.
+       * @hideinitializer
+       **********************************************************************/
+      SPHERICAL_CIRCLE,
+      /**
+       * The iterative solution for &alpha;<sub>1</sub> (which calls
+       * Lambda12) in Geodesic::Inverse, etc.
+       * @hideinitializer
+       **********************************************************************/
+      GEODESIC_ITERATE,
+      /**
+       * The iterative solution for &alpha;<sub>1</sub> in
+       * GeodesicExact::Inverse, etc.
+       * @hideinitializer
+       **********************************************************************/
+      GEODESICEXACT_ITERATE,
+      /**
+       * The number of phases.
+       * @hideinitializer
+       **********************************************************************/
+      NUMPHASES,
+    };
+
+    /**
+     * The type of the function which receives the trace events; \e p is
+     * the phase and \e begin is true (resp. false) at the beginning (resp.
+     * end) of the phase.
+     **********************************************************************/
+    typedef void (*tracer)(phase p, bool begin);
+
+    /**
+     * \brief Trace the lifetime of this object as a phase.
+     *
+     * This is used via the GEOGRAPHICLIB_TRACE_SCOPE macro.  The tracer is
+     * fetched once, so that the beginning and end events are delivered to
+     * the same function even if Instrument::SetTracer is called in
+     * between.
+     **********************************************************************/
+    class Scope {
+    private:
+      phase _p;
+      tracer _t;
+    public:
+      /**
+       * Constructor, which reports the beginning of the phase.
+       *
+       * @param[in] p the phase.
+       **********************************************************************/
+      explicit Scope(phase p) : _p(p), _t(Tracer()) { if (_t) _t(_p, true); }
+      /**
+       * Destructor, which reports the end of the phase.
+       **********************************************************************/
+      ~Scope() { if (_t) _t(_p, false); }
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+    };
+
+    /**
+     * The number of bins in the histogram of iteration counts; the last bin
+     * counts all calls with at least NBINS &minus; 1 iterations.
+     **********************************************************************/
+    enum { NBINS = 32 };
+
+    /**
+     * The counters for one solver.
+     **********************************************************************/
+    struct Counts {
+      /**
+       * The number of calls.
+       **********************************************************************/
+      unsigned long long calls;
+      /**
+       * The total number of iterations.
+       **********************************************************************/
+      unsigned long long iterations;
+      /**
+       * The number of calls which fell back to bisection (Geodesic and
+       * GeodesicExact) or which exhausted the iteration limit without
+       * converging (the others).
+       **********************************************************************/
+      unsigned long long fallbacks;
+      /**
+       * <i>hist</i>[\e k] is the number of calls with \e k iterations.
+       **********************************************************************/
+      unsigned long long hist[NBINS];
+    };
+
+    /**
+     * Record a call to an iterative solver.
+     *
+     * @param[in] s the solver.
+     * @param[in] iterations the number of iterations.
+     * @param[in] fallback whether the solver fell back to bisection or failed
+     *   to converge.
+     *
+     * This is called by the solvers (via the GEOGRAPHICLIB_INSTRUMENT_RECORD
+     * macro) if the library is compiled with GEOGRAPHICLIB_INSTRUMENT = 1.
+     * The counters belong to the calling thread.
+     **********************************************************************/
+    static void Record(solver s, unsigned iterations, bool fallback);
+
+    /**
+     * Sum the counters for a solver over all threads.
+     *
+     * @param[in] s the solver.
+     * @return the counters for \e s.
+     *
+     * The counters of other threads are read without stopping them; so the
+     * result is only a consistent snapshot if the other threads are idle.
+     **********************************************************************/
+    static Counts Snapshot(solver s);
+
+    /**
+     * Sum the counters for all the solvers over all threads.
+     *
+     * @param[out] counts an array of Instrument::NUMSOLVERS elements; element
+     *   \e s holds the counters for solver \e s.
+     **********************************************************************/
+    static void Snapshot(Counts counts[]);
+
+    /**
+     * Set all the counters to zero.
+     *
+     * Calls made concurrently by other threads may be lost.
+     **********************************************************************/
+    static void Reset();
+
+    /**
+     * @param[in] s the solver.
+     * @return the name of solver \e s, e.g., "Geodesic".
+     **********************************************************************/
+    static const char* Name(solver s);
+
+    /**
+     * @return whether the library was compiled with
+     *   GEOGRAPHICLIB_INSTRUMENT = 1 (so that the counters are updated).
+     **********************************************************************/
+    static bool Enabled();
+
+    /**
+     * Set the function which receives the trace events.
+     *
+     * @param[in] t the function (nullptr turns off tracing, which is the
+     *   initial state).
+     *
+     * The function is called by the thread executing the phase; so it must
+     * be thread-safe if the library is called from several threads.  It
+     * should not throw an exception.  This has no effect unless the
+     * library is compiled with GEOGRAPHICLIB_TRACE = 1.
+     **********************************************************************/
+    static void SetTracer(tracer t);
+
+    /**
+     * @return the function which receives the trace events (nullptr if
+     *   tracing is off).
+     **********************************************************************/
+    static tracer Tracer();
+
+    /**
+     * @param[in] p the phase.
+     * @return the name of phase \e p, e.g., "GravityModel::load".
+     **********************************************************************/
+    static const char* Name(phase p);
+
+    /**
+     * @return whether the library was compiled with GEOGRAPHICLIB_TRACE =
+     *   1 (so that the phases are traced).
+     **********************************************************************/
+    static bool TraceEnabled();
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_INSTRUMENT_HPP
@@ -12,6 +12,8 @@
 
 #include <vector>
 #include <set>
+#include <utility>
+#include <atomic>
 #include <GeographicLib/Math.hpp>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicLine.hpp>
@@ -44,6 +46,14 @@ namespace GeographicLib {
    * point of intersection, then \e c is set to +1, if they are parallel, and
    * &minus;1, if they are antiparallel.
    *
+   * The member functions are const and an Intersect object may be used by
+   * several threads at once; the diagnostic counters, Intersect::NumInverse,
+   * etc., are updated atomically.  The constructor computes various
+   * distances characterizing the ellipsoid which require several geodesic
+   * calculations; these are cached (for the process) so that constructing
+   * an Intersect object for an ellipsoid which has been seen before is
+   * cheap.
+   *
    * Example of use:
    * \include example-Intersect.cpp
    *
@@ -172,10 +182,42 @@ namespace GeographicLib {
     // Segment intersecton
     XPoint SegmentInt(const GeodesicLine& lineX, const GeodesicLine& lineY,
                       int& segmode) const;
-    // All intersectons
-    std::vector<XPoint>
-    AllInt0(const GeodesicLine& lineX, const GeodesicLine& lineY,
-           Math::real maxdist, const XPoint& p0) const;
+    // The cap enclosing the normals of a segment: q[0..2] = unit normal at
+    // the midpoint, q[3..4] = cos and sin of the radius
+    void SegmentCap(const GeodesicLine& line, Math::real q[]) const;
+    // Do the caps qi and qj overlap?
+    static bool CapsOverlap(const Math::real qi[], const Math::real qj[]) {
+      // The pair overlaps if sum of the radii is at least pi or the angle
+      // between the centers doesn't exceed the sum.
+      return !(qi[3] + qj[3] > 0) ||
+        qi[0] * qj[0] + qi[1] * qj[1] + qi[2] * qj[2] >=
+        qi[3] * qj[3] - qi[4] * qj[4];
+    }
+    // Candidate pairs of segments for Segments given the cap for each segment
+    static void SegmentCandidates(const std::vector<Math::real>& caps,
+                                  std::vector<std::pair<size_t, size_t>>&
+                                  cand);
+  public:
+    /**
+     * \brief Scratch space for Intersect::All
+     *
+     * The overloads of Intersect::All which take an AllScratch object keep
+     * their working arrays in it.  Once these have grown to the size needed
+     * for the typical query, reusing the object makes Intersect::All
+     * perform no allocations (provided the output iterators don't).  An
+     * AllScratch object may only be used by one thread at a time.
+     **********************************************************************/
+    class AllScratch {
+    private:
+      friend class Intersect;
+      std::vector<XPoint> _start, _r, _c, _added;
+      std::vector<char> _skip;
+    };
+  private:
+    // All intersectons; the results, sorted on the distance from p0, are
+    // in s._r
+    void AllInt0(const GeodesicLine& lineX, const GeodesicLine& lineY,
+                 Math::real maxdist, const XPoint& p0, AllScratch& s) const;
     std::vector<Point>
     AllInternal(const GeodesicLine& lineX, const GeodesicLine& lineY,
                 Math::real maxdist, const Point& p0,
@@ -203,7 +245,23 @@ namespace GeographicLib {
       return (p.x < 0 ? -1 : p.x <= sx ? 0 : 1) * 3
         + (p.y < 0 ? -1 : p.y <= sy ? 0 : 1);
     }
-    mutable long long _cnt0, _cnt1, _cnt2, _cnt3, _cnt4;
+    // A counter which may be incremented by several threads at once; the
+    // order of the updates doesn't matter, so relaxed ordering suffices.
+    class counter {
+    private:
+      std::atomic<long long> _n;
+    public:
+      explicit counter(long long n = 0) : _n(n) {}
+      counter(const counter& c) : _n(c()) {}
+      counter& operator=(const counter& c) { _n = c(); return *this; }
+      counter& operator=(long long n) { _n = n; return *this; }
+      void operator++() { _n.fetch_add(1, std::memory_order_relaxed); }
+      void operator+=(const counter& c)
+      { _n.fetch_add(c(), std::memory_order_relaxed); }
+      long long operator()() const
+      { return _n.load(std::memory_order_relaxed); }
+    };
+    mutable counter _cnt0, _cnt1, _cnt2, _cnt3, _cnt4;
   public:
     /** \name Constructor
      **********************************************************************/
@@ -485,6 +543,178 @@ namespace GeographicLib {
     std::vector<Point> All(const GeodesicLine& lineX, const GeodesicLine& lineY,
                            Math::real maxdist, const Point& p0 = Point(0, 0))
       const;
+     /**
+     * Find all intersections within a certain distance using caller-owned
+     *   scratch space.
+     *
+     * @tparam PointIt an output iterator for Intersect::Point.
+     * @tparam IntIt an output iterator for int.
+     * @param[in] lineX geodesic \e X.
+     * @param[in] lineY geodesic \e Y.
+     * @param[in] maxdist the maximum distance for the returned intersections
+     *   (meters).
+     * @param[in,out] scratch the scratch space.
+     * @param[out] plist an iterator which receives the intersections.
+     * @param[out] clist an iterator which receives the coincidence
+     *   indicators.
+     * @param[in] p0 an optional offset for the starting points (meters),
+     *   default = [0,0].
+     * @return the final value of \e plist.
+     *
+     * This gives the same results as the version of Intersect::All which
+     * returns the vector of coincidences; the intersections and the
+     * coincidence indicators are written, in order of the distance from \e
+     * p0, to \e plist and \e clist.  With a reused \e scratch and
+     * iterators which write into preallocated storage, no memory is
+     * allocated.
+     **********************************************************************/
+    template<class PointIt, class IntIt>
+    PointIt All(const GeodesicLine& lineX, const GeodesicLine& lineY,
+                Math::real maxdist, AllScratch& scratch,
+                PointIt plist, IntIt clist,
+                const Point& p0 = Point(0, 0)) const {
+      using std::fmax;
+      AllInt0(lineX, lineY, fmax(real(0), maxdist), XPoint(p0), scratch);
+      for (const XPoint& q : scratch._r) {
+        *plist++ = q.data();
+        *clist++ = q.c;
+      }
+      return plist;
+    }
+    /**
+     * Find all intersections within a certain distance using caller-owned
+     *   scratch space.  Don't return the coincidences.
+     *
+     * @tparam PointIt an output iterator for Intersect::Point.
+     * @param[in] lineX geodesic \e X.
+     * @param[in] lineY geodesic \e Y.
+     * @param[in] maxdist the maximum distance for the returned intersections
+     *   (meters).
+     * @param[in,out] scratch the scratch space.
+     * @param[out] plist an iterator which receives the intersections.
+     * @param[in] p0 an optional offset for the starting points (meters),
+     *   default = [0,0].
+     * @return the final value of \e plist.
+     **********************************************************************/
+    template<class PointIt>
+    PointIt All(const GeodesicLine& lineX, const GeodesicLine& lineY,
+                Math::real maxdist, AllScratch& scratch, PointIt plist,
+                const Point& p0 = Point(0, 0)) const {
+      using std::fmax;
+      AllInt0(lineX, lineY, fmax(real(0), maxdist), XPoint(p0), scratch);
+      for (const XPoint& q : scratch._r)
+        *plist++ = q.data();
+      return plist;
+    }
+    ///@}
+
+    /** \name Intersections among many segments
+     **********************************************************************/
+    ///@{
+    /**
+     * Find all the pairs of intersecting segments among a set of geodesic
+     *   segments, each specified by a GeodesicLine.
+     *
+     * @param[in] lines a vector of the segments.
+     * @param[out] ij the indices (\e i, \e j), with \e i < \e j, into \e
+     *   lines of the pairs of segments which intersect.
+     * @param[out] c optional pointer to a vector of coincidence indicators.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @return \e plist the intersection points; element \e k is the
+     *   intersection of segments \e X = \e lines[\e ij[\e k].first] and \e Y
+     *   = \e lines[\e ij[\e k].second].
+     *
+     * This is equivalent to calling Intersect::Segment for every pair of
+     * segments and retaining the results with \e segmode = 0; the returned
+     * results are sorted on (\e i, \e j).  However, Intersect::Segment is
+     * only called for those pairs which pass a cheap conservative test: each
+     * segment is enclosed in a spherical cap (in the space of the geodetic
+     * normals) centered at its midpoint and pairs whose caps don't overlap are
+     * skipped.  The overlapping caps are found by bucketing the caps in a
+     * uniform grid of cells, sized according to the typical segment length,
+     * so that the cost of this step is roughly proportional to the number of
+     * segments plus the number of candidate pairs (instead of the square of
+     * the number of segments).  If \e nthreads > 1, the surviving pairs are
+     * solved on that many threads, each using a private copy of this object.
+     * The diagnostic counters (Intersect::NumInverse, etc.) are incremented by
+     * the aggregate counts for the batch; so their change over the call
+     * measures the cost of the batch.
+     *
+     * \note The elements of \e lines should be created with minimum
+     * capabilities Intersect::LineCaps and they must represent shortest
+     * geodesics, e.g., they can be created by Geodesic::InverseLine.
+     **********************************************************************/
+    std::vector<Point>
+    Segments(const std::vector<GeodesicLine>& lines,
+             std::vector<std::pair<size_t, size_t>>& ij,
+             std::vector<int>* c = nullptr, int nthreads = 1) const;
+    /**
+     * Find all the pairs of intersecting segments among a set of geodesic
+     *   segments, each specified by its endpoints.
+     *
+     * @param[in] n the number of segments.
+     * @param[in] lat1 an array of \e n latitudes of the first points of the
+     *   segments (degrees).
+     * @param[in] lon1 an array of \e n longitudes of the first points of the
+     *   segments (degrees).
+     * @param[in] lat2 an array of \e n latitudes of the second points of the
+     *   segments (degrees).
+     * @param[in] lon2 an array of \e n longitudes of the second points of the
+     *   segments (degrees).
+     * @param[out] ij the indices (\e i, \e j), with \e i < \e j, of the
+     *   pairs of segments which intersect.
+     * @param[out] c optional pointer to a vector of coincidence indicators.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @return \e plist the intersection points.
+     *
+     * The GeodesicLine for each segment is constructed once with
+     * Geodesic::InverseLine and the previous definition of
+     * Intersect::Segments is called.
+     *
+     * \warning The results are only well defined if there's a \e unique
+     * shortest geodesic between the endpoints of each segment.
+     **********************************************************************/
+    std::vector<Point>
+    Segments(size_t n,
+             const Math::real lat1[], const Math::real lon1[],
+             const Math::real lat2[], const Math::real lon2[],
+             std::vector<std::pair<size_t, size_t>>& ij,
+             std::vector<int>* c = nullptr, int nthreads = 1) const;
+
+    /**
+     * Find the intersections of one geodesic segment with each of a set of
+     *   geodesic segments, each specified by a GeodesicLine.
+     *
+     * @param[in] lineX segment \e X.
+     * @param[in] lines a vector of the segments \e Y.
+     * @param[out] idx the indices into \e lines of the segments which
+     *   intersect \e X, in increasing order.
+     * @param[out] c optional pointer to a vector of coincidence indicators.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @return \e plist the intersection points; element \e k is the
+     *   intersection of \e X and \e Y = \e lines[\e idx[\e k]].
+     *
+     * This is equivalent to calling Intersect::Segment(\e lineX, \e Y, \e
+     * segmode) for each segment \e Y and retaining the results with \e
+     * segmode = 0.  However, \e X and \e Y are first enclosed in spherical
+     * caps as in Intersect::Segments and Intersect::Segment is only called
+     * for the segments whose caps overlap that of \e X.  If \e nthreads > 1,
+     * these segments are divided among that many threads, each using a
+     * private copy of this object.  The diagnostic counters are incremented
+     * by the aggregate counts for the call.  This is intended for checking a
+     * new segment against many existing ones, e.g., \e lines can be
+     * constructed once and reused for many segments \e X.
+     *
+     * \note \e lineX and the elements of \e lines should be created with
+     * minimum capabilities Intersect::LineCaps and they must represent
+     * shortest geodesics, e.g., they can be created by
+     * Geodesic::InverseLine.
+     **********************************************************************/
+    std::vector<Point>
+    SegmentFan(const GeodesicLine& lineX,
+               const std::vector<GeodesicLine>& lines,
+               std::vector<size_t>& idx,
+               std::vector<int>* c = nullptr, int nthreads = 1) const;
     ///@}
 
     /** \name Diagnostic counters
@@ -498,9 +728,11 @@ namespace GeographicLib {
      * metric for the overall cost. This counter is set to zero by the
      * constructor.
      *
-     * \warning The counter is a mutable variable and so is not thread safe.
+     * \note The counter is updated atomically; if the Intersect object is
+     * used by several threads at once, this is the total for all the
+     * threads.
      **********************************************************************/
-    long long NumInverse() const { return _cnt0; }
+    long long NumInverse() const { return _cnt0(); }
     /**
      * @return the cumulative number of invocations of **b**.
      *
@@ -508,9 +740,11 @@ namespace GeographicLib {
      * which is used by all the intersection methods.  This counter is set to
      * zero by the constructor.
      *
-     * \warning The counter is a mutable variable and so is not thread safe.
+     * \note The counter is updated atomically; if the Intersect object is
+     * used by several threads at once, this is the total for all the
+     * threads.
      **********************************************************************/
-    long long NumBasic() const { return _cnt1; }
+    long long NumBasic() const { return _cnt1(); }
     /**
      * @return the number of times intersection point was changed in
      *   Intersect::Closest and Intersect::Next.
@@ -522,18 +756,22 @@ namespace GeographicLib {
      * \note This counter is also incremented by Intersect::Segment, which
      * calls Intersect::Closest.
      *
-     * \warning The counter is a mutable variable and so is not thread safe.
+     * \note The counter is updated atomically; if the Intersect object is
+     * used by several threads at once, this is the total for all the
+     * threads.
      **********************************************************************/
-    long long NumChange() const { return _cnt2; }
+    long long NumChange() const { return _cnt2(); }
     /**
      * @return the number of times a corner point is checked in
      *   Intersect::Segment.
      *
      * This counter is set to zero by the constructor.
      *
-     * \warning The counter is a mutable variable and so is not thread safe.
+     * \note The counter is updated atomically; if the Intersect object is
+     * used by several threads at once, this is the total for all the
+     * threads.
      **********************************************************************/
-    long long NumCorner() const { return _cnt3; }
+    long long NumCorner() const { return _cnt3(); }
     /**
      * @return the number of times a corner point is returned by
      *   Intersect::Segment.
@@ -544,9 +782,11 @@ namespace GeographicLib {
      * intersection that overrides the intersection closest to the midpoints of
      * the segments; i.e., NumCorner() always returns 0.
      *
-     * \warning The counter is a mutable variable and so is not thread safe.
+     * \note The counter is updated atomically; if the Intersect object is
+     * used by several threads at once, this is the total for all the
+     * threads.
      **********************************************************************/
-    long long NumOverride() const { return _cnt4; }
+    long long NumOverride() const { return _cnt4(); }
     ///@}
 
     /** \name Insepctor function
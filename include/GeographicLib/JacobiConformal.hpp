@@ -1,11 +1,8 @@
 /**
  * \file JacobiConformal.hpp
- * \brief Header for GeographicLib::experimental::JacobiConformal class
+ * \brief Header for GeographicLib::JacobiConformal class
  *
- * \note This is just sample code.  It is not part of GeographicLib
- * itself.
- *
- * Copyright (c) Charles Karney (2014-2023) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2014-2024) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
@@ -13,16 +10,14 @@
 #if !defined(GEOGRAPHICLIB_JACOBICONFORMAL_HPP)
 #define GEOGRAPHICLIB_JACOBICONFORMAL_HPP 1
 
+#include <GeographicLib/Constants.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
 
 namespace GeographicLib {
-namespace experimental {
+
   /**
    * \brief Jacobi's conformal projection of a triaxial ellipsoid
    *
-   * <b>NOTE:</b> This is just sample code.  It is not part of GeographicLib
-   * itself.
-   *
    * This is a conformal projection of the ellipsoid to a plane in which
    * the grid lines are straight; see Jacobi,
    * <a href="https://books.google.com/books?id=ryEOAAAAQAAJ&pg=PA212">
@@ -40,11 +35,22 @@ namespace experimental {
    * points, \f$\left|\omega\right| = \left|\beta\right| = \frac12\pi\f$, lie
    * on middle principal ellipse in the plane \f$X=0\f$.
    *
+   * The two EllipticFunction objects (which hold the complete integrals)
+   * are set up by the constructor; thereafter each coordinate costs one
+   * evaluation of an incomplete elliptic integral of the third kind.  Many
+   * points can be projected with a single call to Forward(size_t, const
+   * real[], const real[], real[], real[], int) const, which may use several
+   * threads.
+   *
    * For more information on this projection, see \ref jacobi.
+   *
+   * Example of use:
+   * \include example-JacobiConformal.cpp
    **********************************************************************/
-  class JacobiConformal {
+  class GEOGRAPHICLIB_EXPORT JacobiConformal {
+  private:
     typedef Math::real real;
-    real _a, _b, _c, _ab2, _bc2, _ac2;
+    real _a, _b, _c, _ab2, _bc2, _ac2, _xscale, _yscale;
     EllipticFunction _ex, _ey;
     static void norm(real& x, real& y) {
       using std::hypot;
@@ -57,28 +63,15 @@ namespace experimental {
      * @param[in] a the largest semi-axis.
      * @param[in] b the middle semi-axis.
      * @param[in] c the smallest semi-axis.
+     * @exception GeographicErr if the axes are not in order or if \e a =
+     *   \e c.
      *
      * The semi-axes must satisfy \e a &ge; \e b &ge; \e c > 0 and \e a >
      * \e c.  This form of the constructor cannot be used to specify a
      * sphere (use the next constructor).
      **********************************************************************/
-    JacobiConformal(real a, real b, real c)
-      : _a(a), _b(b), _c(c)
-      , _ab2((_a - _b) * (_a + _b))
-      , _bc2((_b - _c) * (_b + _c))
-      , _ac2((_a - _c) * (_a + _c))
-      , _ex(_ab2 / _ac2 * Math::sq(_c / _b), -_ab2 / Math::sq(_b),
-            _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
-      , _ey(_bc2 / _ac2 * Math::sq(_a / _b), +_bc2 / Math::sq(_b),
-            _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
-    {
-      using std::isfinite;
-      if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0))
-        throw GeographicErr("JacobiConformal: axes are not in order");
-      if (!(_a > _c))
-        throw GeographicErr
-          ("JacobiConformal: use alternate constructor for sphere");
-    }
+    JacobiConformal(real a, real b, real c);
+
     /**
      * Alternate constructor for a triaxial ellipsoid.
      *
@@ -87,35 +80,24 @@ namespace experimental {
      * @param[in] c the smallest semi-axis.
      * @param[in] ab the relative magnitude of \e a &minus; \e b.
      * @param[in] bc the relative magnitude of \e b &minus; \e c.
+     * @exception GeographicErr if the axes are not in order or if \e ab and
+     *   \e bc are not as specified.
      *
      * This form can be used to specify a sphere.  The semi-axes must
      * satisfy \e a &ge; \e b &ge; c > 0.  The ratio \e ab : \e bc must equal
      * (<i>a</i>&minus;<i>b</i>) : (<i>b</i>&minus;<i>c</i>) with \e ab
      * &ge; 0, \e bc &ge; 0, and \e ab + \e bc > 0.
      **********************************************************************/
-    JacobiConformal(real a, real b, real c, real ab, real bc)
-      : _a(a), _b(b), _c(c)
-      , _ab2(ab * (_a + _b))
-      , _bc2(bc * (_b + _c))
-      , _ac2(_ab2 + _bc2)
-      , _ex(_ab2 / _ac2 * Math::sq(_c / _b),
-            -(_a - _b) * (_a + _b) / Math::sq(_b),
-            _bc2 / _ac2 * Math::sq(_a / _b), Math::sq(_a / _b))
-      , _ey(_bc2 / _ac2 * Math::sq(_a / _b),
-            +(_b - _c) * (_b + _c) / Math::sq(_b),
-            _ab2 / _ac2 * Math::sq(_c / _b), Math::sq(_c / _b))
-    {
-      using std::isfinite;
-      if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0 &&
-            ab >= 0 && bc >= 0))
-        throw GeographicErr("JacobiConformal: axes are not in order");
-      if (!(ab + bc > 0 && isfinite(_ac2)))
-        throw GeographicErr("JacobiConformal: ab + bc must be positive");
-    }
+    JacobiConformal(real a, real b, real c, real ab, real bc);
+
+    /** \name The projection
+     **********************************************************************/
+    ///@{
     /**
      * @return the quadrant length in the \e x direction.
      **********************************************************************/
-    Math::real x() const { return Math::sq(_a / _b) * _ex.Pi(); }
+    Math::real x() const { return _xscale * _ex.Pi(); }
+
     /**
      * The \e x projection.
      *
@@ -123,11 +105,8 @@ namespace experimental {
      * @param[in] comg cos(&omega;).
      * @return \e x.
      **********************************************************************/
-    Math::real x(real somg, real comg) const {
-      real somg1 = _b * somg, comg1 = _a * comg; norm(somg1, comg1);
-      return Math::sq(_a / _b)
-        * _ex.Pi(somg1, comg1, _ex.Delta(somg1, comg1));
-    }
+    Math::real x(real somg, real comg) const;
+
     /**
      * The \e x projection.
      *
@@ -141,10 +120,12 @@ namespace experimental {
       Math::sincosd(omg, somg, comg);
       return x(somg, comg) / Math::degree();
     }
+
     /**
      * @return the quadrant length in the \e y direction.
      **********************************************************************/
-    Math::real y() const { return Math::sq(_c / _b) * _ey.Pi(); }
+    Math::real y() const { return _yscale * _ey.Pi(); }
+
     /**
      * The \e y projection.
      *
@@ -152,11 +133,8 @@ namespace experimental {
      * @param[in] cbet cos(&beta;).
      * @return \e y.
      **********************************************************************/
-    Math::real y(real sbet, real cbet) const {
-      real sbet1 = _b * sbet, cbet1 = _c * cbet; norm(sbet1, cbet1);
-      return Math::sq(_c / _b)
-        * _ey.Pi(sbet1, cbet1, _ey.Delta(sbet1, cbet1));
-    }
+    Math::real y(real sbet, real cbet) const;
+
     /**
      * The \e y projection.
      *
@@ -170,9 +148,59 @@ namespace experimental {
       Math::sincosd(bet, sbet, cbet);
       return y(sbet, cbet) / Math::degree();
     }
+
+    /**
+     * Forward projection of a point.
+     *
+     * @param[in] omg &omega; (in degrees).
+     * @param[in] bet &beta; (in degrees).
+     * @param[out] x \e x (in degrees).
+     * @param[out] y \e y (in degrees).
+     **********************************************************************/
+    void Forward(real omg, real bet, real& x, real& y) const {
+      x = this->x(omg); y = this->y(bet);
+    }
+
+    /**
+     * Forward projection of many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] omg an array of \e n values of &omega; (in degrees).
+     * @param[in] bet an array of \e n values of &beta; (in degrees).
+     * @param[out] x an array of \e n values of \e x (in degrees).
+     * @param[out] y an array of \e n values of \e y (in degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The results are identical to those of \e n calls to Forward(real,
+     * real, real&, real&) const.  Either of \e x and \e y may be null, in
+     * which case that coordinate is skipped (and the corresponding input
+     * array is not referenced).  If \e nthreads > 1, the points are handed
+     * out in chunks to that many tasks which are run with Executor::Batch.
+     **********************************************************************/
+    void Forward(size_t n, const real omg[], const real bet[],
+                 real x[], real y[], int nthreads = 1) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return \e a the largest semi-axis.
+     **********************************************************************/
+    Math::real a() const { return _a; }
+
+    /**
+     * @return \e b the middle semi-axis.
+     **********************************************************************/
+    Math::real b() const { return _b; }
+
+    /**
+     * @return \e c the smallest semi-axis.
+     **********************************************************************/
+    Math::real c() const { return _c; }
+    ///@}
   };
 
-} // namespace experimental
 } // namespace GeographicLib
 
 #endif  // GEOGRAPHICLIB_JACOBICONFORMAL_HPP
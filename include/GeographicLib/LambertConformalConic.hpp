@@ -140,6 +140,15 @@ namespace GeographicLib {
       return t != 0 ? Math::eatanhe(t / d, _es) / t : _e2 / d;
     }
     void Init(real sphi1, real cphi1, real sphi2, real cphi2, real k1);
+    // The number of points handled together by the batch functions
+    static const int blocksize_ = 16;
+    // Forward for a single point; gamma and k may be null
+    void ForwardPoint(real lon0, real lat, real lon,
+                      real& x, real& y, real* gamma, real* k) const;
+    // Reverse for a block of n points
+    template<int n>
+    void ReverseBlock(real lon0, const real x[], const real y[],
+                      real lat[], real lon[], real gamma[], real k[]) const;
   public:
 
     /**
@@ -263,22 +272,68 @@ namespace GeographicLib {
     /**
      * LambertConformalConic::Forward without returning the convergence and
      * scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     void Forward(real lon0, real lat, real lon,
-                 real& x, real& y) const {
-      real gamma, k;
-      Forward(lon0, lat, lon, x, y, gamma, k);
-    }
+                 real& x, real& y) const
+    { ForwardPoint(lon0, lat, lon, x, y, nullptr, nullptr); }
 
     /**
      * LambertConformalConic::Reverse without returning the convergence and
      * scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     void Reverse(real lon0, real x, real y,
-                 real& lat, real& lon) const {
-      real gamma, k;
-      Reverse(lon0, x, y, lat, lon, gamma, k);
-    }
+                 real& lat, real& lon) const;
+
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to LambertConformalConic::Forward.  (The forward
+     * projection entails no iteration; this is provided for symmetry with
+     * LambertConformalConic::Reverse.)
+     **********************************************************************/
+    void Forward(real lon0, size_t n, const real lat[], const real lon[],
+                 real x[], real y[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] lon0 central meridian longitude (degrees).
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to LambertConformalConic::Reverse.  The points
+     * are processed in small blocks with the Newton iterations for the
+     * latitude (in Math::tauf) carried out in lockstep for all the points in a
+     * block.
+     **********************************************************************/
+    void Reverse(real lon0, size_t n, const real x[], const real y[],
+                 real lat[], real lon[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
 
     /** \name Inspector functions
      **********************************************************************/
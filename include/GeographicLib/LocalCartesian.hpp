@@ -38,6 +38,7 @@ namespace GeographicLib {
   class GEOGRAPHICLIB_EXPORT LocalCartesian {
   private:
     typedef Math::real real;
+    friend class ProjectionPipeline; // ProjectionPipeline uses the rotation
     static const size_t dim_ = 3;
     static const size_t dim2_ = dim_ * dim_;
     Geocentric _earth;
@@ -48,6 +49,9 @@ namespace GeographicLib {
     void IntReverse(real x, real y, real z, real& lat, real& lon, real& h,
                     real M[dim2_]) const;
     void MatrixMultiply(real M[dim2_]) const;
+    // The geocentric coordinates and rotation matrix for an origin
+    void Origin(real lat0, real lon0, real h0,
+                real& x0, real& y0, real& z0, real r[dim2_]) const;
   public:
 
     /**
@@ -85,7 +89,11 @@ namespace GeographicLib {
      * @param[in] lon0 longitude at origin (degrees).
      * @param[in] h0 height above ellipsoid at origin (meters); default 0.
      *
-     * \e lat0 should be in the range [&minus;90&deg;, 90&deg;].
+     * \e lat0 should be in the range [&minus;90&deg;, 90&deg;].  This
+     * costs about the same as one call to Geocentric::Forward; so, e.g., a
+     * moving platform can reset the origin often.  For points referred to
+     * many different origins, use the versions of LocalCartesian::Forward
+     * and LocalCartesian::Reverse which take an origin for each point.
      **********************************************************************/
     void Reset(real lat0, real lon0, real h0 = 0);
 
@@ -199,6 +207,152 @@ namespace GeographicLib {
         IntReverse(x, y, z, lat, lon, h, NULL);
     }
 
+    /**
+     * Convert many points from geodetic to local cartesian coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] h array of heights of the points above the ellipsoid
+     *   (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     * @param[out] M array of 9 \e n elements which receives the rotation
+     *   matrices (each in row-major order); this may be null.
+     *
+     * The arrays \e lat, \e lon, \e h, \e x, \e y, and \e z hold \e n
+     * elements.  The results are identical to those returned by \e n calls
+     * to LocalCartesian::Forward.  See that function for the definition of
+     * the rotation matrix.
+     **********************************************************************/
+    void Forward(size_t n, const real lat[], const real lon[], const real h[],
+                 real x[], real y[], real z[], real M[] = nullptr) const;
+
+    /**
+     * Convert many points from local cartesian to geodetic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the points above the ellipsoid
+     *   (meters).
+     * @param[out] M array of 9 \e n elements which receives the rotation
+     *   matrices (each in row-major order); this may be null.
+     *
+     * The arrays \e x, \e y, \e z, \e lat, \e lon, and \e h hold \e n
+     * elements.  The results are identical to those returned by \e n calls
+     * to LocalCartesian::Reverse.  See that function for the definition of
+     * the rotation matrix.
+     **********************************************************************/
+    void Reverse(size_t n, const real x[], const real y[], const real z[],
+                 real lat[], real lon[], real h[], real M[] = nullptr) const;
+
+    /**
+     * Convert many points from geodetic to local cartesian coordinates given
+     * strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[in] h strided array of heights of the points above the
+     *   ellipsoid (meters).
+     * @param[out] x strided array of local cartesian coordinates (meters).
+     * @param[out] y strided array of local cartesian coordinates (meters).
+     * @param[out] z strided array of local cartesian coordinates (meters).
+     *
+     * This is the same as the previous version of LocalCartesian::Forward
+     * (without the rotation matrices) except that the elements of each
+     * array are StridedArray::stride() bytes apart.  The outputs may
+     * overlay the inputs.
+     **********************************************************************/
+    void Forward(size_t n, StridedArray<const real> lat,
+                 StridedArray<const real> lon, StridedArray<const real> h,
+                 StridedArray<real> x, StridedArray<real> y,
+                 StridedArray<real> z) const;
+
+    /**
+     * Convert many points from local cartesian to geodetic coordinates given
+     * strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x strided array of local cartesian coordinates (meters).
+     * @param[in] y strided array of local cartesian coordinates (meters).
+     * @param[in] z strided array of local cartesian coordinates (meters).
+     * @param[out] lat strided array of latitudes of the points (degrees).
+     * @param[out] lon strided array of longitudes of the points (degrees).
+     * @param[out] h strided array of heights of the points above the
+     *   ellipsoid (meters).
+     *
+     * This is the same as the previous version of LocalCartesian::Reverse
+     * (without the rotation matrices) except that the elements of each
+     * array are StridedArray::stride() bytes apart.  The outputs may
+     * overlay the inputs.
+     **********************************************************************/
+    void Reverse(size_t n, StridedArray<const real> x,
+                 StridedArray<const real> y, StridedArray<const real> z,
+                 StridedArray<real> lat, StridedArray<real> lon,
+                 StridedArray<real> h) const;
+
+    /**
+     * Convert many points from geodetic to local cartesian coordinates each
+     * with its own origin.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat0 array of latitudes of the origins (degrees).
+     * @param[in] lon0 array of longitudes of the origins (degrees).
+     * @param[in] h0 array of heights of the origins above the ellipsoid
+     *   (meters).
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[in] h array of heights of the points above the ellipsoid
+     *   (meters).
+     * @param[out] x array of local cartesian coordinates (meters).
+     * @param[out] y array of local cartesian coordinates (meters).
+     * @param[out] z array of local cartesian coordinates (meters).
+     *
+     * Point \e i is converted to the local cartesian system with origin
+     * (<i>lat0</i>[<i>i</i>], <i>lon0</i>[<i>i</i>], <i>h0</i>[<i>i</i>]).
+     * The results are identical to those obtained by resetting the origin
+     * of a LocalCartesian object with the same ellipsoid for each point
+     * and calling LocalCartesian::Forward; the origin of this object is not
+     * used or changed.  The origin is only set up when it differs from the
+     * previous point's; so, e.g., the samples of a vehicle's sensor which
+     * are stamped with the origin current at the time cost the same as
+     * with a single origin.  The outputs may overlay the inputs.
+     **********************************************************************/
+    void Forward(size_t n,
+                 const real lat0[], const real lon0[], const real h0[],
+                 const real lat[], const real lon[], const real h[],
+                 real x[], real y[], real z[]) const;
+
+    /**
+     * Convert many points from local cartesian to geodetic coordinates each
+     * with its own origin.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat0 array of latitudes of the origins (degrees).
+     * @param[in] lon0 array of longitudes of the origins (degrees).
+     * @param[in] h0 array of heights of the origins above the ellipsoid
+     *   (meters).
+     * @param[in] x array of local cartesian coordinates (meters).
+     * @param[in] y array of local cartesian coordinates (meters).
+     * @param[in] z array of local cartesian coordinates (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] h array of heights of the points above the ellipsoid
+     *   (meters).
+     *
+     * This is the inverse of the previous function.
+     **********************************************************************/
+    void Reverse(size_t n,
+                 const real lat0[], const real lon0[], const real h0[],
+                 const real x[], const real y[], const real z[],
+                 real lat[], real lon[], real h[]) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -103,6 +103,10 @@ namespace GeographicLib {
     };
     static void CheckCoords(bool utmp, bool& northp, real& x, real& y);
     static int UTMRow(int iband, int icol, int irow);
+    // The value of a decimal digit, or -1 if c isn't a digit; this is
+    // equivalent to Utility::lookup(digits_, c) but it avoids the search.
+    static int Digit(char c)
+    { return c >= '0' && c <= '9' ? int(c - '0') : -1; }
 
     friend class UTMUPS;        // UTMUPS::StandardZone calls LatitudeBand
     // Return latitude band number [-10, 10) for the given latitude (degrees).
@@ -156,9 +160,21 @@ namespace GeographicLib {
       utmNshift_ = (maxutmSrow_ - minutmNrow_) * tile_
     };
     MGRS() = delete;            // Disable constructor
+    static real BandLatitude(int zone, bool northp, real x, real y);
+    static void Reverse(const char* mgrs, int len,
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp);
 
   public:
 
+    /**
+     * The maximum length of an MGRS string (not counting the terminating
+     * null).  This is attained with \e prec = 11 for a UTM coordinate.  A
+     * char buffer of MGRS::MAXLENGTH + 1 characters can hold any result
+     * returned by the char[] versions of MGRS::Forward.
+     **********************************************************************/
+    enum { MAXLENGTH = 2 + 3 + 2 * maxprec_ };
+
     /**
      * Convert UTM or UPS coordinate to an MGRS coordinate.
      *
@@ -267,6 +283,75 @@ namespace GeographicLib {
     static void Forward(int zone, bool northp, real x, real y, real lat,
                         int prec, std::string& mgrs);
 
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate in a char buffer.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a buffer of at least MGRS::MAXLENGTH + 1 characters
+     *   which receives the null-terminated MGRS string.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @return the length of the MGRS string.
+     *
+     * This is the same as the std::string version of this function except
+     * that no memory is allocated.  If an error is thrown, then \e mgrs is
+     * unchanged.
+     **********************************************************************/
+    static int Forward(int zone, bool northp, real x, real y,
+                       int prec, char mgrs[]);
+
+    /**
+     * Convert UTM or UPS coordinate to an MGRS coordinate in a char buffer
+     * when the latitude is known.
+     *
+     * @param[in] zone UTM zone (zero means UPS).
+     * @param[in] northp hemisphere (true means north, false means south).
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] lat latitude (degrees).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a buffer of at least MGRS::MAXLENGTH + 1 characters
+     *   which receives the null-terminated MGRS string.
+     * @exception GeographicErr if \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     * @exception GeographicErr if \e lat is inconsistent with the given UTM
+     *   coordinates.
+     * @return the length of the MGRS string.
+     **********************************************************************/
+    static int Forward(int zone, bool northp, real x, real y, real lat,
+                       int prec, char mgrs[]);
+
+    /**
+     * Convert many UTM or UPS coordinates to MGRS coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] zone array of UTM zones (zero means UPS).
+     * @param[in] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] mgrs a char buffer of at least \e n &times; \e stride
+     *   characters; the null-terminated MGRS string for point \e i starts at
+     *   \e mgrs + \e i &times; \e stride.
+     * @param[in] stride the spacing of the strings in \e mgrs.
+     * @exception GeographicErr if \e stride is too small to hold an MGRS
+     *   string with precision \e prec (including the terminating null); \e
+     *   stride = MGRS::MAXLENGTH + 1 suffices for all \e prec.
+     * @exception GeographicErr if any \e zone, \e x, or \e y is outside its
+     *   allowed range.
+     *
+     * If an error is thrown for point \e i, the results for the preceding
+     * points have been stored.
+     **********************************************************************/
+    static void Forward(size_t n, const int zone[], const bool northp[],
+                        const real x[], const real y[],
+                        int prec, char mgrs[], size_t stride);
+
     /**
      * Convert a MGRS coordinate to UTM or UPS coordinates.
      *
@@ -316,6 +401,80 @@ namespace GeographicLib {
                         int& zone, bool& northp, real& x, real& y,
                         int& prec, bool centerp = true);
 
+    /**
+     * Convert a null-terminated MGRS coordinate to UTM or UPS coordinates.
+     *
+     * @param[in] mgrs null-terminated MGRS string.
+     * @param[out] zone UTM zone (zero means UPS).
+     * @param[out] northp hemisphere (true means north, false means south).
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the MGRS square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e mgrs is illegal.
+     *
+     * This is the same as the std::string version of this function except
+     * that no memory is allocated (unless an exception is thrown).
+     **********************************************************************/
+    static void Reverse(const char mgrs[],
+                        int& zone, bool& northp, real& x, real& y,
+                        int& prec, bool centerp = true);
+
+    /**
+     * Convert many MGRS coordinates to UTM or UPS coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] mgrs a char buffer holding null-terminated MGRS strings; the
+     *   string for point \e i starts at \e mgrs + \e i &times; \e stride.
+     * @param[in] stride the spacing of the strings in \e mgrs.
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec array of precisions relative to 100 km.
+     * @param[in] centerp if true (default), return centers of the MGRS
+     *   squares, else return SW (lower left) corners.
+     * @exception GeographicErr if any \e mgrs string is illegal.
+     *
+     * A string which fills its slot entirely (i.e., has no terminating null
+     * within \e stride characters) is taken to be \e stride characters
+     * long.  If an error is thrown for point \e i, the results for the
+     * preceding points have been stored.
+     **********************************************************************/
+    static void Reverse(size_t n, const char mgrs[], size_t stride,
+                        int zone[], bool northp[], real x[], real y[],
+                        int prec[], bool centerp = true);
+
+    /**
+     * Convert many MGRS coordinates to geographic coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] mgrs a char buffer holding null-terminated MGRS strings; the
+     *   string for point \e i starts at \e mgrs + \e i &times; \e stride.
+     * @param[in] stride the spacing of the strings in \e mgrs.
+     * @param[out] lat array of latitudes (degrees).
+     * @param[out] lon array of longitudes (degrees).
+     * @param[out] prec array of precisions relative to 100 km; this may be
+     *   null.
+     * @param[in] centerp if true (default), return centers of the MGRS
+     *   squares, else return SW (lower left) corners.
+     * @exception GeographicErr if any \e mgrs string is illegal or if
+     *   UTMUPS::Reverse would throw an exception for any of the resulting
+     *   UTM/UPS coordinates.
+     *
+     * The results are the same as those given by the previous function
+     * followed by UTMUPS::Reverse (which is how GeoCoords converts an MGRS
+     * string).  The strings are decoded in blocks; the points in each block
+     * are converted with the batch version of UTMUPS::Reverse, which groups
+     * them by UTM zone.  If an error is thrown, the results for the points
+     * in the preceding blocks have been stored.
+     **********************************************************************/
+    static void Reverse(size_t n, const char mgrs[], size_t stride,
+                        real lat[], real lon[], int prec[] = nullptr,
+                        bool centerp = true);
+
     /**
      * Split a MGRS grid reference into its components.
      *
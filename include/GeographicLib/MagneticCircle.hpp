@@ -38,14 +38,20 @@ namespace GeographicLib {
   private:
     typedef Math::real real;
 
-    real _a, _f, _lat, _h, _t, _cphi, _sphi, _t1, _dt0;
-    bool _interpolate, _constterm;
-    CircularEngine _circ0, _circ1, _circ2;
+    real _a, _f, _lat, _h, _t, _cphi, _sphi, _t0, _dt0;
+    // The circle handles the time intervals _n0 thru _n1 of a model with
+    // _nmodels epochs
+    int _nmodels, _n0, _n1;
+    bool _constterm;
+    // The circles for the epochs _n0 thru _n1 + 1 (the last is the secular
+    // variation if _n1 + 1 == _nmodels) followed, if _constterm, by the
+    // circle for the constant terms
+    std::vector<CircularEngine> _circ;
 
     MagneticCircle(real a, real f, real lat, real h, real t,
-                   real cphi, real sphi, real t1, real dt0,
-                   bool interpolate,
-                   const CircularEngine& circ0, const CircularEngine& circ1)
+                   real cphi, real sphi, real t0, real dt0,
+                   int nmodels, int n0, int n1, bool constterm,
+                   std::vector<CircularEngine>&& circ)
       : _a(a)
       , _f(f)
       , _lat(Math::LatFix(lat))
@@ -53,43 +59,31 @@ namespace GeographicLib {
       , _t(t)
       , _cphi(cphi)
       , _sphi(sphi)
-      , _t1(t1)
+      , _t0(t0)
       , _dt0(dt0)
-      , _interpolate(interpolate)
-      , _constterm(false)
-      , _circ0(circ0)
-      , _circ1(circ1)
+      , _nmodels(nmodels)
+      , _n0(n0)
+      , _n1(n1)
+      , _constterm(constterm)
+      , _circ(std::move(circ))
     {}
 
-    MagneticCircle(real a, real f, real lat, real h, real t,
-                   real cphi, real sphi, real t1, real dt0,
-                   bool interpolate,
-                   const CircularEngine& circ0, const CircularEngine& circ1,
-                   const CircularEngine& circ2)
-      : _a(a)
-      , _f(f)
-      , _lat(lat)
-      , _h(h)
-      , _t(t)
-      , _cphi(cphi)
-      , _sphi(sphi)
-      , _t1(t1)
-      , _dt0(dt0)
-      , _interpolate(interpolate)
-      , _constterm(true)
-      , _circ0(circ0)
-      , _circ1(circ1)
-      , _circ2(circ2)
-    {}
+    // The interval n containing t and the time t1 since its start
+    void Interval(real t, int& n, real& t1) const;
 
-    void Field(real lon, bool diffp,
+    void Field(real t, real lon, bool diffp,
                real& Bx, real& By, real& Bz,
                real& Bxt, real& Byt, real& Bzt) const;
 
-    void FieldGeocentric(real slam, real clam,
+    void FieldGeocentric(int n, real t1, real slam, real clam,
                          real& BX, real& BY, real& BZ,
                          real& BXt, real& BYt, real& BZt) const;
 
+    void Combine(int n, real t1,
+                 real& BX, real& BY, real& BZ,
+                 real& BXt, real& BYt, real& BZt,
+                 real BXc, real BYc, real BZc) const;
+
     friend class MagneticModel; // MagneticModel calls the private constructor
 
   public:
@@ -117,7 +111,7 @@ namespace GeographicLib {
      **********************************************************************/
     void operator()(real lon, real& Bx, real& By, real& Bz) const {
       real dummy;
-      Field(lon, false, Bx, By, Bz, dummy, dummy, dummy);
+      Field(_t, lon, false, Bx, By, Bz, dummy, dummy, dummy);
     }
 
     /**
@@ -136,7 +130,56 @@ namespace GeographicLib {
      **********************************************************************/
     void operator()(real lon, real& Bx, real& By, real& Bz,
                     real& Bxt, real& Byt, real& Bzt) const {
-      Field(lon, true, Bx, By, Bz, Bxt, Byt, Bzt);
+      Field(_t, lon, true, Bx, By, Bz, Bxt, Byt, Bzt);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field at a particular time
+     * and longitude.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @exception GeographicErr if \e t lies outside the time intervals
+     *   covered by the circle.
+     *
+     * The circle holds the inner sums for the main field at each epoch (and
+     * for the secular variation) separately, so the field at other times is
+     * found without constructing a new circle.  A circle made by
+     * MagneticModel::Circle(real lat, real h) covers all times.  One made
+     * by MagneticModel::Circle(real t, real lat, real h) covers the times
+     * lying in the same interval between epochs of the model as its own
+     * time (for a model with a single epoch, this is all times).
+     **********************************************************************/
+    void operator()(real t, real lon, real& Bx, real& By, real& Bz) const {
+      real dummy;
+      Field(t, lon, false, Bx, By, Bz, dummy, dummy, dummy);
+    }
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives at a particular time and longitude.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] Bx the easterly component of the magnetic field (nanotesla).
+     * @param[out] By the northerly component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz the vertical (up) component of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bxt the rate of change of \e Bx (nT/yr).
+     * @param[out] Byt the rate of change of \e By (nT/yr).
+     * @param[out] Bzt the rate of change of \e Bz (nT/yr).
+     * @exception GeographicErr if \e t lies outside the time intervals
+     *   covered by the circle.
+     **********************************************************************/
+    void operator()(real t, real lon, real& Bx, real& By, real& Bz,
+                    real& Bxt, real& Byt, real& Bzt) const {
+      Field(t, lon, true, Bx, By, Bz, Bxt, Byt, Bzt);
     }
 
     /**
@@ -153,6 +196,55 @@ namespace GeographicLib {
      **********************************************************************/
     void FieldGeocentric(real lon, real& BX, real& BY, real& BZ,
                          real& BXt, real& BYt, real& BZt) const;
+
+    /**
+     * Evaluate the components of the geomagnetic field and their time
+     * derivatives at a particular time and longitude.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] BX the \e X component of the magnetic field (nT).
+     * @param[out] BY the \e Y component of the magnetic field (nT).
+     * @param[out] BZ the \e Z component of the magnetic field (nT).
+     * @param[out] BXt the rate of change of \e BX (nT/yr).
+     * @param[out] BYt the rate of change of \e BY (nT/yr).
+     * @param[out] BZt the rate of change of \e BZ (nT/yr).
+     * @exception GeographicErr if \e t lies outside the time intervals
+     *   covered by the circle.
+     **********************************************************************/
+    void FieldGeocentric(real t, real lon, real& BX, real& BY, real& BZ,
+                         real& BXt, real& BYt, real& BZt) const;
+
+    /**
+     * Evaluate the components of the geomagnetic field and, optionally,
+     * their time derivatives at uniformly spaced longitudes.
+     *
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] n the number of longitudes.
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[out] Bxt (optional) array of the rates of change of \e Bx
+     *   (nT/yr).
+     * @param[out] Byt (optional) array of the rates of change of \e By
+     *   (nT/yr).
+     * @param[out] Bzt (optional) array of the rates of change of \e Bz
+     *   (nT/yr).
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * The field is evaluated at longitudes \e lon0 + \e i \e dlon for \e
+     * i in [0, \e n).  The rates of change are computed only if \e Bxt, \e
+     * Byt, and \e Bzt are all non-null.  The sums over order are evaluated
+     * with CircularEngine::Grid.
+     **********************************************************************/
+    void Grid(real lon0, real dlon, size_t n,
+              real Bx[], real By[], real Bz[],
+              real Bxt[] = nullptr, real Byt[] = nullptr,
+              real Bzt[] = nullptr) const;
     ///@}
 
     /** \name Inspector functions
@@ -186,7 +278,8 @@ namespace GeographicLib {
     Math::real Height() const
     { return Init() ? _h : Math::NaN(); }
     /**
-     * @return the time (fractional years).
+     * @return the time (fractional years).  This is NaN for a circle made by
+     *   MagneticModel::Circle(real lat, real h).
      **********************************************************************/
     Math::real Time() const
     { return Init() ? _t : Math::NaN(); }
@@ -11,8 +11,14 @@
 #define GEOGRAPHICLIB_MAGNETICMODEL_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/MemoryFootprint.hpp>
 #include <GeographicLib/Geocentric.hpp>
 #include <GeographicLib/SphericalHarmonic.hpp>
+#include <list>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <mutex>
 
 #if defined(_MSC_VER)
 // Squelch warnings about dll vs vector
@@ -83,11 +89,54 @@ namespace GeographicLib {
     Geocentric _earth;
     std::vector< std::vector<real> > _gG;
     std::vector< std::vector<real> > _hH;
+    // The coefficients stored as floats (if compact)
+    std::vector< std::vector<float> > _gGf;
+    std::vector< std::vector<float> > _hHf;
+    real _compacterr;
+    // The mapped coefficient file (if mapped)
+    const char* _map;
+    size_t _mapsize;
     std::vector<SphericalHarmonic> _harm;
     void Field(real t, real lat, real lon, real h, bool diffp,
                real& Bx, real& By, real& Bz,
                real& Bxt, real& Byt, real& Bzt) const;
     void ReadMetadata(const std::string& name);
+    // The index of the model used for time t
+    int Interval(real t) const;
+    // Combine the geocentric sums for models n and n + 1 and the constant
+    // terms into the field and its rate of change at time t
+    void Combine(real t, int n,
+                 const real B[], const real Bt[], const real Bc[],
+                 real& BX, real& BY, real& BZ,
+                 real& BXt, real& BYt, real& BZt) const;
+    // The geocentric field at time t (without its rate of change) found
+    // with a single spherical harmonic sum over the blended coefficients of
+    // the models bracketing t and the constant terms
+    void BlendGeocentric(real t, real X, real Y, real Z,
+                         real& BX, real& BY, real& BZ) const;
+    void MapFile(const std::string& filename, size_t size);
+    void UnmapFile();
+    // The circle cache, MagneticCircle objects indexed by time, latitude,
+    // and height, most recently used first.
+    typedef std::tuple<real, real, real> circlekey;
+    typedef std::list< std::pair< circlekey,
+                                  std::shared_ptr<const MagneticCircle> > >
+    circlelist;
+    mutable std::mutex _circlelock;
+    mutable circlelist _circlelru;
+    mutable std::map<circlekey, circlelist::iterator> _circlemap;
+    mutable size_t _circlebytes;
+    size_t _circlebudget;
+    mutable unsigned long long _circlehits, _circlemisses;
+    // The approximate memory used by a cached circle
+    size_t CircleBytes() const;
+    // Return the circle for t, lat, and h from the cache, constructing it if
+    // necessary; null if the circle cache is off or t, lat, or h is not
+    // finite.
+    std::shared_ptr<const MagneticCircle>
+    CachedCircle(real t, real lat, real h) const;
+    // A circle for the time intervals n0 thru n1
+    MagneticCircle Circle(real t, real lat, real h, int n0, int n1) const;
     // copy constructor not allowed
     MagneticModel(const MagneticModel&) = delete;
     // nor copy assignment
@@ -108,6 +157,10 @@ namespace GeographicLib {
      *   model this value.
      * @param[in] Mmax (optional) if non-negative, truncate the order of the
      *   model this value.
+     * @param[in] compact (optional) if true, store the coefficients of the
+     *   model as floats (default false).
+     * @param[in] mapped (optional) if true, map the coefficient file into
+     *   memory instead of reading it (default false).
      * @exception GeographicErr if the data file cannot be found, is
      *   unreadable, or is corrupt, or if \e Mmax > \e Nmax.
      * @exception std::bad_alloc if the memory necessary for storing the model
@@ -131,11 +184,29 @@ namespace GeographicLib {
      * If \e Nmax &ge; 0 and \e Mmax < 0, then \e Mmax is set to \e Nmax.
      * After the model is loaded, the maximum degree and order of the model can
      * be found by the Degree() and Order() methods.
+     *
+     * If \e compact = true, the coefficients of the model are rounded to
+     * floats, which halves the memory needed to hold them.  This is only
+     * worthwhile for high degree models, such as emm2017.  The resulting rms
+     * error in the field is given by CompactError().
+     *
+     * If \e mapped = true, the coefficient file is mapped into the address
+     * space of the process (using mmap on Unix systems and MapViewOfFile on
+     * Windows systems) and the spherical harmonic sums use the coefficients
+     * in place; see GravityModel::GravityModel for details.  This requires a
+     * little-endian machine with GEOGRAPHICLIB_PRECISION = 2.  \e mapped is
+     * ignored if \e compact = true.
      **********************************************************************/
     explicit MagneticModel(const std::string& name,
                            const std::string& path = "",
                            const Geocentric& earth = Geocentric::WGS84(),
-                           int Nmax = -1, int Mmax = -1);
+                           int Nmax = -1, int Mmax = -1,
+                           bool compact = false, bool mapped = false);
+
+    /**
+     * The destructor unmaps the coefficient file if necessary.
+     **********************************************************************/
+    ~MagneticModel();
     ///@}
 
     /** \name Compute the magnetic field
@@ -189,6 +260,42 @@ namespace GeographicLib {
       Field(t, lat, lon, h, true, Bx, By, Bz, Bxt, Byt, Bzt);
     }
 
+    /**
+     * Evaluate the components of the geomagnetic field at a fixed position
+     * for many times.
+     *
+     * @param[in] n the number of times.
+     * @param[in] t array of times (fractional years).
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @param[out] Bx array of the easterly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] By array of the northerly components of the magnetic field
+     *   (nanotesla).
+     * @param[out] Bz array of the vertical (up) components of the magnetic
+     *   field (nanotesla).
+     * @param[out] Bxt (optional) array of the rates of change of \e Bx
+     *   (nT/yr).
+     * @param[out] Byt (optional) array of the rates of change of \e By
+     *   (nT/yr).
+     * @param[out] Bzt (optional) array of the rates of change of \e Bz
+     *   (nT/yr).
+     *
+     * The results are the same as calling operator()() for each time.
+     * However, the field is linear in time within each model interval, so
+     * each spherical harmonic sum is evaluated just once for the position;
+     * thereafter, each time only requires a few multiplications.  The rates
+     * of change are only computed if \e Bxt, \e Byt, and \e Bzt are all
+     * non-null.  For a moving platform, the position can typically be held
+     * fixed over a short window of times (e.g., a few seconds at 100 Hz)
+     * since the field varies slowly with position.
+     **********************************************************************/
+    void TimeBatch(size_t n, const real t[], real lat, real lon, real h,
+                   real Bx[], real By[], real Bz[],
+                   real Bxt[] = nullptr, real Byt[] = nullptr,
+                   real Bzt[] = nullptr) const;
+
     /**
      * Create a MagneticCircle object to allow the geomagnetic field at many
      * points with constant \e lat, \e h, and \e t and varying \e lon to be
@@ -209,9 +316,74 @@ namespace GeographicLib {
      *
      * Use Utility::fractionalyear to convert a date of the form yyyy-mm or
      * yyyy-mm-dd into a fractional year.
+     *
+     * The MagneticCircle can also compute the field at other times in the
+     * same interval between the epochs of the model as \e t, see
+     * MagneticCircle::operator()(real t, real lon, real& Bx, real& By, real&
+     * Bz) const.
      **********************************************************************/
     MagneticCircle Circle(real t, real lat, real h) const;
 
+    /**
+     * Create a MagneticCircle object to allow the geomagnetic field at many
+     * points with constant \e lat and \e h and varying \e t and \e lon to
+     * be computed efficiently.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] h the height of the point above the ellipsoid (meters).
+     * @exception std::bad_alloc if the memory necessary for creating a
+     *   MagneticCircle can't be allocated.
+     * @return a MagneticCircle object whose MagneticCircle::operator()(real
+     *   t, real lon) member function computes the field at particular values
+     *   of \e t and \e lon.
+     *
+     * The circle holds the inner sums for all the epochs of the model, so
+     * that it can be used for any time (e.g., for a track which stays on a
+     * circle of latitude for a long period).  For a model with \e n
+     * epochs, this costs about (\e n + 1)/2 times as much as the circle for a
+     * single time; for a model with a single epoch, such as WMM, it's the
+     * same.  MagneticCircle::Time()
+     * returns NaN for this circle and the member functions which don't take
+     * a time argument return NaNs.
+     **********************************************************************/
+    MagneticCircle Circle(real lat, real h) const;
+
+    /**
+     * Compute the declination, inclination, and total intensity of the
+     * geomagnetic field on a regular grid of latitudes and longitudes.
+     *
+     * @param[in] t the time (fractional years).
+     * @param[in] h the height above the ellipsoid (meters).
+     * @param[in] lat0 the first latitude (degrees).
+     * @param[in] dlat the latitude spacing (degrees).
+     * @param[in] nlat the number of latitudes.
+     * @param[in] lon0 the first longitude (degrees).
+     * @param[in] dlon the longitude spacing (degrees).
+     * @param[in] nlon the number of longitudes.
+     * @param[out] D array of the declinations of the field (degrees east of
+     *   north).
+     * @param[out] I array of the inclinations of the field (degrees down
+     *   from horizontal).
+     * @param[out] F array of the total intensities of the field (nT).
+     * @exception std::bad_alloc if the memory for the MagneticCircle objects
+     *   can't be allocated.
+     *
+     * The grid points are at latitudes \e lat0 + \e i \e dlat for \e i in
+     * [0, \e nlat) and longitudes \e lon0 + \e j \e dlon for \e j in [0, \e
+     * nlon); the results are stored in row-major order, so the result for
+     * (\e i, \e j) is in element <i>i</i> \e nlon + \e j of the output
+     * arrays, which must each hold \e nlat &times; \e nlon elements (or be
+     * null).  A MagneticCircle is constructed for each row (so the
+     * latitude-dependent part of the sums is computed once per row) and the
+     * row is evaluated with MagneticCircle::Grid.  The rows are divided among
+     * Threads() threads.  The results agree with those of operator()()
+     * followed by FieldComponents() to within roundoff.
+     **********************************************************************/
+    void Grid(real t, real h,
+              real lat0, real dlat, size_t nlat,
+              real lon0, real dlon, size_t nlon,
+              real D[], real I[], real F[]) const;
+
     /**
      * Compute the magnetic field in geocentric coordinate.
      *
@@ -280,6 +452,46 @@ namespace GeographicLib {
                                 real& Ht, real& Ft, real& Dt, real& It);
     ///@}
 
+    /**
+     * Set the number of threads used for each evaluation.
+     *
+     * @param[in] nthreads the number of threads (default 1).
+     *
+     * With \e nthreads &gt; 1, each spherical harmonic sum evaluated for a
+     * single point is divided among up to \e nthreads threads (see
+     * SphericalEngine::Value); this only helps for high-degree models.
+     * MagneticModel::Grid uses \e nthreads threads to evaluate the rows of
+     * the grid.  This should not be called while other threads are using the
+     * object.
+     **********************************************************************/
+    void SetThreads(int nthreads);
+
+    /**
+     * Set the maximum memory used by the circle cache.
+     *
+     * @param[in] maxbytes the maximum memory (bytes); 0 (the default) turns
+     *   off the cache.
+     *
+     * The circle cache holds MagneticCircle objects for the times,
+     * latitudes, and heights of recent queries, discarding the least
+     * recently used ones to keep the memory used to no more than \e
+     * maxbytes.  When the cache is on, MagneticModel::operator()() gets the
+     * circle for \e t, \e lat, and \e h from the cache (creating it if
+     * necessary) and evaluates the field with it.  This benefits workloads
+     * which query the same few circles repeatedly.  The cost of a query on a
+     * cached circle is proportional to the degree \e N of the model instead
+     * of \e N<sup>2</sup>.  However, a miss costs a few times as much as a
+     * point evaluation.  The keys must match exactly (no quantization is
+     * done).  The results can differ from those without the cache because
+     * of roundoff.
+     *
+     * The cache may be used by several threads at once.  This also resets
+     * the counts returned by MagneticModel::CircleCacheHits and
+     * MagneticModel::CircleCacheMisses.  It should not be called while other
+     * threads are using the object.
+     **********************************************************************/
+    void SetCircleCacheSize(size_t maxbytes);
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -377,6 +589,66 @@ namespace GeographicLib {
      * @return \e Mmax the maximum order of the components of the model.
      **********************************************************************/
     int Order() const { return _mmx; }
+
+    /**
+     * @return true if the coefficients of the model are stored as floats.
+     **********************************************************************/
+    bool Compact() const { return !_gGf.empty(); }
+
+    /**
+     * @return the rms error in the magnetic field (nT) resulting from
+     *   storing the coefficients as floats.
+     *
+     * This is the largest, over the component models, of the
+     * root-mean-square error in the field over the sphere of radius
+     * ModelRadius(); the error for the secular variation terms is in nT per
+     * year.  It is 0 unless the model was constructed with \e compact =
+     * true.
+     **********************************************************************/
+    Math::real CompactError() const { return _compacterr; }
+
+    /**
+     * @return true if the coefficient file is mapped into memory.
+     **********************************************************************/
+    bool Mapped() const { return _map != nullptr; }
+
+    /**
+     * @return the number of threads used for each evaluation.
+     **********************************************************************/
+    int Threads() const { return _harm.empty() ? 1 : _harm[0].Threads(); }
+
+    /**
+     * @return the maximum memory used by the circle cache (bytes); 0 if the
+     *   cache is off.
+     **********************************************************************/
+    size_t CircleCacheSize() const { return _circlebudget; }
+
+    /**
+     * @return the memory used by the object.
+     *
+     * \e heap is the coefficients of the model held in memory (0 for the
+     * coefficients of a mapped model), \e mapped is the size of the mapped
+     * coefficient file, and \e cache is the memory held by the circle cache.
+     * The memory used by the table of square roots, which is shared by all
+     * the models, is given by MemoryFootprint::Shared.
+     **********************************************************************/
+    MemoryFootprint MemoryUsage() const;
+
+    /**
+     * @return the number of queries for which the circle was in the cache.
+     **********************************************************************/
+    unsigned long long CircleCacheHits() const {
+      std::lock_guard<std::mutex> g(_circlelock);
+      return _circlehits;
+    }
+
+    /**
+     * @return the number of queries for which the circle was constructed.
+     **********************************************************************/
+    unsigned long long CircleCacheMisses() const {
+      std::lock_guard<std::mutex> g(_circlelock);
+      return _circlemisses;
+    }
     ///@}
 
     /**
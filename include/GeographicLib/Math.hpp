@@ -22,15 +22,25 @@
 #  define GEOGRAPHICLIB_HAVE_LONG_DOUBLE 0
 #endif
 
+#if !defined(GEOGRAPHICLIB_REPRODUCIBLE)
+/**
+ * Whether the library was built to give bitwise reproducible results.  This
+ * is set by the cmake option GEOGRAPHICLIB_REPRODUCIBLE (default OFF) and is
+ * recorded in Config.h.  See Math::reproducible.
+ **********************************************************************/
+#  define GEOGRAPHICLIB_REPRODUCIBLE 0
+#endif
+
 #if !defined(GEOGRAPHICLIB_PRECISION)
 /**
  * The precision of floating point numbers used in %GeographicLib.  1 means
  * float (single precision); 2 (the default) means double; 3 means long double;
- * 4 is reserved for quadruple precision.  Nearly all the testing has been
- * carried out with doubles and that's the recommended configuration.  In order
- * for long double to be used, GEOGRAPHICLIB_HAVE_LONG_DOUBLE needs to be
- * defined.  Note that with Microsoft Visual Studio, long double is the same as
- * double.
+ * 4 is reserved for quadruple precision; 5 means arbitrary precision (using
+ * MPFR); 6 means double-double (using DoubleDouble).  Nearly all the testing
+ * has been carried out with doubles and that's the recommended
+ * configuration.  In order for long double to be used,
+ * GEOGRAPHICLIB_HAVE_LONG_DOUBLE needs to be defined.  Note that with
+ * Microsoft Visual Studio, long double is the same as double.
  **********************************************************************/
 #  define GEOGRAPHICLIB_PRECISION 2
 #endif
@@ -39,6 +49,16 @@
 #include <algorithm>
 #include <limits>
 
+#if !defined(GEOGRAPHICLIB_FMA)
+/**
+ * Whether Math::muladd uses a fused multiply-add.  This is set by the cmake
+ * option GEOGRAPHICLIB_FMA (default OFF) and is recorded in Config.h.  It
+ * should only be turned on when compiling for a processor with an FMA
+ * instruction (e.g., aarch64 or x86-64 with -march=haswell).
+ **********************************************************************/
+#  define GEOGRAPHICLIB_FMA 0
+#endif
+
 #if GEOGRAPHICLIB_PRECISION == 4
 #include <memory>
 #include <boost/version.hpp>
@@ -46,6 +66,8 @@
 #include <boost/math/special_functions.hpp>
 #elif GEOGRAPHICLIB_PRECISION == 5
 #include <mpreal.h>
+#elif GEOGRAPHICLIB_PRECISION == 6
+#include <GeographicLib/DoubleDouble.hpp>
 #endif
 
 #if GEOGRAPHICLIB_PRECISION > 3
@@ -106,6 +128,8 @@ namespace GeographicLib {
     typedef boost::multiprecision::float128 real;
 #elif GEOGRAPHICLIB_PRECISION == 5
     typedef mpfr::mpreal real;
+#elif GEOGRAPHICLIB_PRECISION == 6
+    typedef DoubleDouble real;
 #else
     typedef double real;
 #endif
@@ -176,6 +200,38 @@ namespace GeographicLib {
      **********************************************************************/
     static const bool bigendian = GEOGRAPHICLIB_WORDS_BIGENDIAN;
 
+    /**
+     * true if the library was built with GEOGRAPHICLIB_REPRODUCIBLE.
+     *
+     * In this case, the multi-threaded and batch functions give results
+     * which are bitwise identical to those of the corresponding scalar
+     * functions, regardless of the number of threads and the way the input
+     * is split into batches:
+     * - the compiler is told not to contract multiplications and additions
+     *   into fused multiply-adds (std::fma is only used where its exact
+     *   result is needed);
+     * - Accumulator::Add(size_t, const T[]) adds the elements one at a time;
+     * - SphericalEngine evaluates each sum with a single thread (the batch
+     *   functions still divide the points between threads);
+     * - TrackStatistics adds the segment lengths in order, so that the
+     *   length doesn't depend on how the track is split into chunks.
+     * .
+     * Most of the other batch functions (e.g., Geodesic::InverseBatch and
+     * PolygonAreaT::AddPoints) give the scalar results in any case.  The
+     * exceptions are the batch functions of GravityModel and MagneticModel
+     * which, by design, evaluate the points sharing a circle with a
+     * GravityCircle or MagneticCircle; their results depend only on the
+     * input (and on whether the circle cache is enabled), but they differ
+     * from those of the point functions by roundoff.  The
+     * results are reproducible across machines provided that they use IEEE
+     * arithmetic without extended precision, the same compiler, and the same
+     * implementation of the math library (the elementary functions are not
+     * correctly rounded).  Code which calls the inline functions of the
+     * library should also be compiled without contractions, e.g., with
+     * -ffp-contract=off for g++ and clang.
+     **********************************************************************/
+    static const bool reproducible = GEOGRAPHICLIB_REPRODUCIBLE;
+
     /**
      * @tparam T the type of the returned value.
      * @return &pi;.
@@ -246,6 +302,31 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T sum(T u, T v, T& t);
 
+    /**
+     * Multiply and add.
+     *
+     * @tparam T the type of the arguments and returned value.
+     * @param[in] x
+     * @param[in] y
+     * @param[in] z
+     * @return \e x \e y + \e z.
+     *
+     * If GEOGRAPHICLIB_FMA is set, this uses std::fma, which rounds the
+     * result once; otherwise the product is rounded before the addition.
+     * The series evaluations (polyval, estrin, clenshaw, and the sums in
+     * SphericalEngine, TransverseMercator, etc.) use this function, so that
+     * they take advantage of fused multiply-adds where the hardware provides
+     * them.  Without GEOGRAPHICLIB_FMA, the results are identical to those
+     * of the unfused expressions.
+     **********************************************************************/
+    template<typename T> static T muladd(T x, T y, T z) {
+#if GEOGRAPHICLIB_FMA
+      using std::fma; return fma(x, y, z);
+#else
+      return x * y + z;
+#endif
+    }
+
     /**
      * Evaluate a polynomial.
      *
@@ -259,17 +340,82 @@ namespace GeographicLib {
      * Evaluate &sum;<sub><i>n</i>=0..<i>N</i></sub>
      * <i>p</i><sub><i>n</i></sub> <i>x</i><sup><i>N</i>&minus;<i>n</i></sup>.
      * Return 0 if \e N &lt; 0.  Return <i>p</i><sub>0</sub>, if \e N = 0 (even
-     * if \e x is infinite or a nan).  The evaluation uses Horner's method.
+     * if \e x is infinite or a nan).  The evaluation uses Horner's method
+     * with muladd.
      **********************************************************************/
     template<typename T> static T polyval(int N, const T p[], T x) {
-      // This used to employ Math::fma; but that's too slow and it seemed not
-      // to improve the accuracy noticeably.  This might change when there's
-      // direct hardware support for fma.
+      // Math::fma used to be called here; but, without hardware support,
+      // this was too slow.  muladd only fuses the operations when this is
+      // fast.
       T y = N < 0 ? 0 : *p++;
-      while (--N >= 0) y = y * x + *p++;
+      while (--N >= 0) y = muladd(y, x, *p++);
       return y;
     }
 
+    /**
+     * Evaluate a polynomial with Estrin's scheme.
+     *
+     * @tparam T the type of the arguments and returned value.
+     * @param[in] N the order of the polynomial.
+     * @param[in] p the coefficient array (of size \e N + 1) with
+     *   <i>p</i><sub>0</sub> being coefficient of <i>x</i><sup><i>N</i></sup>.
+     * @param[in] x the variable.
+     * @return the value of the polynomial.
+     *
+     * This is the same as polyval except that the polynomial is split into
+     * \e H(\e x) <i>x</i><sup><i>m</i></sup> + \e L(\e x), where \e m is
+     * the largest power of 2 not exceeding \e N, and \e H and \e L are
+     * evaluated recursively.  The two halves are independent; so the
+     * latency is proportional to log \e N instead of \e N.  This helps for
+     * polynomials of high order whose evaluation isn't overlapped with other
+     * work (for short polynomials Horner's method is as fast).  The roundoff
+     * errors are comparable to those of Horner's method, but the results
+     * are not identical.
+     **********************************************************************/
+    template<typename T> static T estrin(int N, const T p[], T x) {
+      if (N <= 0) return N < 0 ? 0 : p[0];
+      int m = 1; T xm = x;
+      while (2 * m <= N) { m *= 2; xm *= xm; }
+      // p[0..N-m] are the coefficients of H and p[N-m+1..N] those of L
+      return muladd(estrin(N - m, p, x), xm, estrin(m - 1, p + N - m + 1, x));
+    }
+
+    /**
+     * Clenshaw summation of a Fourier series.
+     *
+     * @tparam T the type of the arguments and returned value.
+     * @param[in] n the number of terms.
+     * @param[in] x 2 cos &theta;.
+     * @param[in] c the array of \e n coefficients.
+     * @param[out] y1 <i>b</i><sub>1</sub>.
+     * @return <i>b</i><sub>0</sub>.
+     *
+     * This carries out the recursion <i>b</i><sub><i>k</i></sub> = \e x
+     * <i>b</i><sub><i>k</i>+1</sub> &minus; <i>b</i><sub><i>k</i>+2</sub> +
+     * <i>c</i><sub><i>k</i></sub> for \e k = \e n &minus; 1 down to 0 with
+     * <i>b</i><sub><i>n</i></sub> = <i>b</i><sub><i>n</i>+1</sub> = 0.  The
+     * sums &sum;<sub><i>k</i>=0..<i>n</i>&minus;1</sub>
+     * <i>c</i><sub><i>k</i></sub> sin((\e k + \e j) &theta;) and
+     * &sum;<sub><i>k</i>=0..<i>n</i>&minus;1</sub>
+     * <i>c</i><sub><i>k</i></sub> cos((\e k + \e j) &theta;) are given by
+     * <i>b</i><sub>0</sub> sin(\e j &theta;) &minus; <i>b</i><sub>1</sub>
+     * sin((\e j &minus; 1) &theta;) and <i>b</i><sub>0</sub> cos(\e j
+     * &theta;) &minus; <i>b</i><sub>1</sub> cos((\e j &minus; 1) &theta;).
+     * The loop is unrolled twice, so that the accumulators don't need to be
+     * swapped.  This is used by Geodesic, AuxLatitude, and DST.
+     **********************************************************************/
+    template<typename T> static T clenshaw(int n, T x, const T c[], T& y1) {
+      c += n;                   // Point to one beyond last element
+      T y0 = n & 1 ? *--c : 0;
+      y1 = 0;
+      // Now n is even
+      for (n /= 2; n--;) {
+        y1 = muladd(x, y0, -y1) + *--c;
+        y0 = muladd(x, y1, -y0) + *--c;
+      }
+      return y0;
+    }
+
     /**
      * Normalize an angle.
      *
@@ -282,6 +428,25 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T AngNormalize(T x);
 
+    /**
+     * Normalize many angles.
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of angles.
+     * @param[in] x array of angles in degrees.
+     * @param[out] y array of the angles reduced to the range [&minus;180&deg;,
+     *   180&deg;].
+     *
+     * Each array holds \e n elements; \e y may be the same array as \e x.
+     * The results are identical to those returned by \e n calls to
+     * Math::AngNormalize.  The exact reduction is carried out with arithmetic
+     * operations (instead of a call to remainder) in loops which the compiler
+     * can vectorize; the scalar function is only called for very large
+     * angles (and for infinities and NaNs).
+     **********************************************************************/
+    template<typename T>
+    static void AngNormalize(std::size_t n, const T x[], T y[]);
+
     /**
      * Normalize a latitude.
      *
@@ -327,6 +492,26 @@ namespace GeographicLib {
     template<typename T> static T AngDiff(T x, T y)
     { T e; return AngDiff(x, y, e); }
 
+    /**
+     * The exact differences of many pairs of angles reduced to
+     * [&minus;180&deg;, 180&deg;].
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of pairs of angles.
+     * @param[in] x array of the first angles in degrees.
+     * @param[in] y array of the second angles in degrees.
+     * @param[out] d array of the truncated values of \e y &minus; \e x.
+     * @param[out] e array of the error terms in degrees; this may be null.
+     *
+     * Each array holds \e n elements; \e d may be the same array as \e x or
+     * \e y.  The results are identical to those returned by \e n calls to
+     * Math::AngDiff.  See Math::AngNormalize for the treatment of the
+     * arrays.
+     **********************************************************************/
+    template<typename T>
+    static void AngDiff(std::size_t n, const T x[], const T y[],
+                        T d[], T e[] = nullptr);
+
     /**
      * Coarsen a value close to zero.
      *
@@ -358,6 +543,27 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static void sincosd(T x, T& sinx, T& cosx);
 
+    /**
+     * Evaluate the sine and cosine function for many arguments in degrees
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of arguments.
+     * @param[in] x array of arguments in degrees.
+     * @param[out] sinx array of sin(<i>x</i>).
+     * @param[out] cosx array of cos(<i>x</i>).
+     *
+     * Each array holds \e n elements; \e sinx or \e cosx may be the same array
+     * as \e x.  The results are identical to those returned by \e n calls to
+     * Math::sincosd.  The arguments are processed in small blocks; the exact
+     * reduction of the arguments to [&minus;45&deg;, 45&deg;] and the
+     * mapping to the correct quadrant are carried out with arithmetic
+     * operations and selections in loops which the compiler can vectorize;
+     * the scalar function is only called for very large arguments (and for
+     * infinities and NaNs).
+     **********************************************************************/
+    template<typename T>
+    static void sincosd(std::size_t n, const T x[], T sinx[], T cosx[]);
+
     /**
      * Evaluate the sine and cosine with reduced argument plus correction
      *
@@ -423,6 +629,25 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T atan2d(T y, T x);
 
+    /**
+     * Evaluate the atan2 function with the result in degrees for many
+     * arguments
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of arguments.
+     * @param[in] y array of the first arguments.
+     * @param[in] x array of the second arguments.
+     * @param[out] z array of atan2(<i>y</i>, <i>x</i>) in degrees.
+     *
+     * Each array holds \e n elements; \e z may be the same array as \e y or
+     * \e x.  The results are identical to those returned by \e n calls to
+     * Math::atan2d.  The rearrangement of the arguments and the mapping of the
+     * result to the correct quadrant are carried out with selections in loops
+     * which the compiler can vectorize.
+     **********************************************************************/
+    template<typename T>
+    static void atan2d(std::size_t n, const T y[], const T x[], T z[]);
+
     /**
      * Evaluate the atan function with the result in degrees
      *
@@ -484,6 +709,25 @@ namespace GeographicLib {
      **********************************************************************/
     template<typename T> static T tauf(T taup, T es);
 
+    /**
+     * tan&phi; in terms of tan&chi; for many values
+     *
+     * @tparam T the type of the arguments.
+     * @param[in] n the number of values.
+     * @param[in] taup array of &tau;&prime; = tan&chi;
+     * @param[in] es the signed eccentricity = sign(<i>e</i><sup>2</sup>)
+     *   sqrt(|<i>e</i><sup>2</sup>|)
+     * @param[out] tau array of &tau; = tan&phi;
+     *
+     * Each array holds \e n elements; \e tau may be the same array as \e
+     * taup.  The results are identical to those returned by \e n calls to
+     * Math::tauf.  The values are processed in small blocks with the Newton
+     * iterations carried out in lockstep for all the values in a block; a value
+     * drops out of the iteration once it has converged.
+     **********************************************************************/
+    template<typename T>
+    static void tauf(std::size_t n, const T taup[], T es, T tau[]);
+
     /**
      * The NaN (not a number)
      *
@@ -0,0 +1,157 @@
+/**
+ * \file MemoryFootprint.hpp
+ * \brief Header for GeographicLib::MemoryFootprint class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_MEMORYFOOTPRINT_HPP)
+#define GEOGRAPHICLIB_MEMORYFOOTPRINT_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief The memory used by an object
+   *
+   * This is returned by the MemoryUsage member functions of the classes
+   * which hold a lot of data, e.g., Geoid, GravityModel, MagneticModel,
+   * NearestNeighbor, and CachedGeodesic.  The memory is split into three
+   * parts:
+   * - \e heap, the memory allocated for data which the object needs for
+   *   its lifetime (e.g., the coefficients of a GravityModel or the tree of
+   *   a NearestNeighbor);
+   * - \e mapped, the size of the files mapped into the address space (which
+   *   the system pages in on demand and which may be shared with other
+   *   processes);
+   * - \e cache, the memory held by caches which can be cleared or resized
+   *   (e.g., Geoid::CacheArea and GravityModel::SetCircleCacheSize).
+   * .
+   * The sizes are in bytes and exclude the fixed size of the object itself
+   * (given by \c sizeof); they are estimates which ignore the overhead of
+   * the heap allocator.  The usage of several objects is found by adding
+   * their MemoryFootprint objects.
+   *
+   * The constructors of Geoid, GravityModel, and MagneticModel register the
+   * objects, so that MemoryFootprint::Process can add the usages of all the
+   * live instances to the memory used by the library's shared tables.  This
+   * allows a program to check the memory used by the library against a
+   * budget and, e.g., reduce the sizes of the caches when it's exceeded.
+   *
+   * Example of use:
+   * \include example-MemoryFootprint.cpp
+   **********************************************************************/
+  class GEOGRAPHICLIB_EXPORT MemoryFootprint {
+  public:
+    /**
+     * The memory allocated on the heap (bytes).
+     **********************************************************************/
+    size_t heap;
+    /**
+     * The size of the mapped files (bytes).
+     **********************************************************************/
+    size_t mapped;
+    /**
+     * The memory held by caches (bytes).
+     **********************************************************************/
+    size_t cache;
+
+    /**
+     * Constructor.
+     *
+     * @param[in] heap the memory allocated on the heap (default 0).
+     * @param[in] mapped the size of the mapped files (default 0).
+     * @param[in] cache the memory held by caches (default 0).
+     **********************************************************************/
+    MemoryFootprint(size_t heap = 0, size_t mapped = 0, size_t cache = 0)
+      : heap(heap), mapped(mapped), cache(cache) {}
+
+    /**
+     * @return the total memory, \e heap + \e mapped + \e cache (bytes).
+     **********************************************************************/
+    size_t Total() const { return heap + mapped + cache; }
+
+    /**
+     * Add the memory used by another object.
+     *
+     * @param[in] m the memory used by the other object.
+     * @return a reference to this object.
+     **********************************************************************/
+    MemoryFootprint& operator+=(const MemoryFootprint& m) {
+      heap += m.heap; mapped += m.mapped; cache += m.cache;
+      return *this;
+    }
+
+    /**
+     * Add the memory used by two objects.
+     *
+     * @param[in] m the memory used by the other object.
+     * @return the sum.
+     **********************************************************************/
+    MemoryFootprint operator+(const MemoryFootprint& m) const {
+      MemoryFootprint t(*this); t += m; return t;
+    }
+
+    /**
+     * @tparam T the type of the elements of the vector.
+     * @param[in] v a vector.
+     * @return the memory allocated for the elements of \e v (bytes).
+     **********************************************************************/
+    template<typename T>
+    static size_t Bytes(const std::vector<T>& v)
+    { return v.capacity() * sizeof(T); }
+
+    /**
+     * @return the memory used by the tables shared by all the objects
+     *   (currently the tables of square roots and of the coefficients of
+     *   the Legendre recursion used by SphericalEngine, see
+     *   SphericalEngine::RootTableBytes and
+     *   SphericalEngine::LegendreTableBytes); this is counted as \e heap.
+     **********************************************************************/
+    static MemoryFootprint Shared();
+
+    /**
+     * @return the sum of Shared() and the memory used by all the live
+     *   Geoid, GravityModel, and MagneticModel objects.
+     *
+     * This locks the registry of objects while it calls the MemoryUsage
+     * function of each object; the result for a Geoid is only accurate if
+     * its cache isn't being changed by another thread.
+     **********************************************************************/
+    static MemoryFootprint Process();
+
+    /**
+     * The type of the function which reports the memory used by a
+     * registered object.
+     **********************************************************************/
+    typedef MemoryFootprint (*reporter)(const void* obj);
+
+    /**
+     * Register an object with MemoryFootprint::Process.
+     *
+     * @param[in] obj a pointer to the object.
+     * @param[in] f the function which returns the memory used by \e obj.
+     *
+     * This is called by the constructors of the registered classes; it's
+     * not intended to be called directly.  \e obj must be unregistered (with
+     * Unregister) before it's destroyed.
+     **********************************************************************/
+    static void Register(const void* obj, reporter f);
+
+    /**
+     * Unregister an object.
+     *
+     * @param[in] obj a pointer to the object.
+     *
+     * This is called by the destructors of the registered classes.
+     **********************************************************************/
+    static void Unregister(const void* obj);
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_MEMORYFOOTPRINT_HPP
@@ -103,9 +103,17 @@ namespace GeographicLib {
     static real atan5series(real x);
     static real Qf(real x, bool alt);
     static real Hf(real x, bool alt);
+    // Qf and Hf together; this shares the evaluation of atanzz or
+    // atan5series.  The results are the same as those of Qf and Hf.
+    static void QHf(real x, bool alt, real& Q, real& H);
     static real QH3f(real x, bool alt);
     real Jn(int n) const;
     void Initialize(real a, real GM, real omega, real f_J2, bool geometricp);
+    // The number of points handled together by V0Block
+    static const int blocksize_ = 32;
+    // Evaluate V0 for m <= blocksize_ points
+    void V0Block(int m, const real X[], const real Y[], const real Z[],
+                 real V[], real GammaX[], real GammaY[], real GammaZ[]) const;
   public:
 
     /** \name Setting up the normal gravity
@@ -256,6 +264,98 @@ namespace GeographicLib {
     Math::real Phi(real X, real Y, real& fX, real& fY) const;
     ///@}
 
+    /** \name Compute the gravity for many points
+     **********************************************************************/
+    ///@{
+    /**
+     * Evaluate the gravity on the surface of the ellipsoid for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[out] gamma array of the accelerations due to gravity, positive
+     *   downwards (m s<sup>&minus;2</sup>).
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to NormalGravity::SurfaceGravity.
+     **********************************************************************/
+    void SurfaceGravityBatch(size_t n, const real lat[], real gamma[]) const;
+
+    /**
+     * Evaluate the gravity at many points above (or below) the ellipsoid.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of geographic latitudes (degrees).
+     * @param[in] h array of heights above the ellipsoid (meters).
+     * @param[out] gammay array of the northerly components of the
+     *   acceleration (m s<sup>&minus;2</sup>).
+     * @param[out] gammaz array of the upward components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] U array of the normal potentials (m<sup>2</sup>
+     *   s<sup>&minus;2</sup>); this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to NormalGravity::Gravity.  See
+     * NormalGravity::V0Batch for how the points are processed.
+     **********************************************************************/
+    void GravityBatch(size_t n, const real lat[], const real h[],
+                      real gammay[], real gammaz[], real U[] = nullptr) const;
+
+    /**
+     * Evaluate the acceleration due to gravity and the centrifugal
+     * acceleration in geocentric coordinates for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] gammaX array of the \e X components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gammaY array of the \e Y components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] gammaZ array of the \e Z components of the acceleration
+     *   (m s<sup>&minus;2</sup>).
+     * @param[out] U array of the sums of the gravitational and centrifugal
+     *   potentials (m<sup>2</sup> s<sup>&minus;2</sup>); this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to NormalGravity::U.  See NormalGravity::V0Batch
+     * for how the points are processed.
+     **********************************************************************/
+    void UBatch(size_t n, const real X[], const real Y[], const real Z[],
+                real gammaX[], real gammaY[], real gammaZ[],
+                real U[] = nullptr) const;
+
+    /**
+     * Evaluate the acceleration due to the gravitational force in geocentric
+     * coordinates for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] X array of geocentric coordinates (meters).
+     * @param[in] Y array of geocentric coordinates (meters).
+     * @param[in] Z array of geocentric coordinates (meters).
+     * @param[out] GammaX array of the \e X components of the acceleration
+     *   due to the gravitational force (m s<sup>&minus;2</sup>).
+     * @param[out] GammaY array of the \e Y components of the acceleration
+     *   due to the gravitational force (m s<sup>&minus;2</sup>).
+     * @param[out] GammaZ array of the \e Z components of the acceleration
+     *   due to the gravitational force (m s<sup>&minus;2</sup>).
+     * @param[out] V0 array of the gravitational potentials (m<sup>2</sup>
+     *   s<sup>&minus;2</sup>); this may be null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to NormalGravity::V0.  The points are processed
+     * in small blocks.  For each block, the ellipsoidal coordinates of the
+     * points are found first, then the transcendental functions of the
+     * ellipsoidal coordinates are evaluated, and finally these are combined to
+     * give the potential and the acceleration; the first and last steps are
+     * free of function calls (apart from sqrt and hypot) and so may be
+     * vectorized by the compiler.
+     **********************************************************************/
+    void V0Batch(size_t n, const real X[], const real Y[], const real Z[],
+                 real GammaX[], real GammaY[], real GammaZ[],
+                 real V0[] = nullptr) const;
+    ///@}
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -61,11 +61,23 @@ namespace GeographicLib {
       // Maximum precision is um
       maxprec_ = 5 + 6
     };
+    // The number of points handled together by the batch Reverse
+    static const size_t block_ = 256;
     static real computenorthoffset();
     static void CheckCoords(real x, real y);
+    static void GridReference(const char* gridref, int len,
+                              real& x, real& y, int& prec, bool centerp);
     OSGB() = delete;            // Disable constructor
   public:
 
+    /**
+     * The maximum length of a grid reference (not counting the terminating
+     * null).  This is attained with \e prec = 11.  A char buffer of
+     * OSGB::MAXLENGTH + 1 characters can hold any result returned by the
+     * char[] versions of OSGB::GridReference.
+     **********************************************************************/
+    enum { MAXLENGTH = 2 + 2 * maxprec_ };
+
     /**
      * Forward projection, from geographic to OSGB coordinates.
      *
@@ -122,6 +134,48 @@ namespace GeographicLib {
       Reverse(x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to OSGB::Forward.  The points are projected with
+     * the batch version of TransverseMercator::Forward.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[],
+                        real x[], real y[],
+                        real gamma[] = nullptr, real k[] = nullptr);
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to OSGB::Reverse.  The points are projected with
+     * the batch version of TransverseMercator::Reverse.
+     **********************************************************************/
+    static void Reverse(size_t n, const real x[], const real y[],
+                        real lat[], real lon[],
+                        real gamma[] = nullptr, real k[] = nullptr);
+
     /**
      * Convert OSGB coordinates to a grid reference.
      *
@@ -153,6 +207,47 @@ namespace GeographicLib {
      **********************************************************************/
     static void GridReference(real x, real y, int prec, std::string& gridref);
 
+    /**
+     * Convert OSGB coordinates to a grid reference in a char buffer.
+     *
+     * @param[in] x easting of point (meters).
+     * @param[in] y northing of point (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref a buffer of at least OSGB::MAXLENGTH + 1 characters
+     *   which receives the null-terminated National Grid reference.
+     * @exception GeographicErr if \e prec, \e x, or \e y is outside its
+     *   allowed range.
+     * @return the length of the grid reference.
+     *
+     * This is the same as the std::string version of this function except
+     * that no memory is allocated.  If an error is thrown, then \e gridref is
+     * unchanged.
+     **********************************************************************/
+    static int GridReference(real x, real y, int prec, char gridref[]);
+
+    /**
+     * Convert many OSGB coordinates to grid references.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings (meters).
+     * @param[in] y array of northings (meters).
+     * @param[in] prec precision relative to 100 km.
+     * @param[out] gridref a char buffer of at least \e n &times; \e stride
+     *   characters; the null-terminated grid reference for point \e i starts
+     *   at \e gridref + \e i &times; \e stride.
+     * @param[in] stride the spacing of the grid references in \e gridref.
+     * @exception GeographicErr if \e stride is too small to hold a grid
+     *   reference with precision \e prec (including the terminating null); \e
+     *   stride = OSGB::MAXLENGTH + 1 suffices for all \e prec.
+     * @exception GeographicErr if \e prec or any \e x or \e y is outside its
+     *   allowed range.
+     *
+     * If an error is thrown for point \e i, the results for the preceding
+     * points have been stored.
+     **********************************************************************/
+    static void GridReference(size_t n, const real x[], const real y[],
+                              int prec, char gridref[], size_t stride);
+
     /**
      * Convert OSGB grid reference to coordinates.
      *
@@ -174,6 +269,48 @@ namespace GeographicLib {
                               real& x, real& y, int& prec,
                               bool centerp = true);
 
+    /**
+     * Convert a null-terminated OSGB grid reference to coordinates.
+     *
+     * @param[in] gridref null-terminated National Grid reference.
+     * @param[out] x easting of point (meters).
+     * @param[out] y northing of point (meters).
+     * @param[out] prec precision relative to 100 km.
+     * @param[in] centerp if true (default), return center of the grid square,
+     *   else return SW (lower left) corner.
+     * @exception GeographicErr if \e gridref is illegal.
+     *
+     * This is the same as the std::string version of this function except
+     * that no memory is allocated (unless an exception is thrown).
+     **********************************************************************/
+    static void GridReference(const char gridref[],
+                              real& x, real& y, int& prec,
+                              bool centerp = true);
+
+    /**
+     * Convert many OSGB grid references to coordinates.
+     *
+     * @param[in] n the number of points.
+     * @param[in] gridref a char buffer holding null-terminated grid
+     *   references; the one for point \e i starts at \e gridref + \e i
+     *   &times; \e stride.
+     * @param[in] stride the spacing of the grid references in \e gridref.
+     * @param[out] x array of eastings (meters).
+     * @param[out] y array of northings (meters).
+     * @param[out] prec array of precisions relative to 100 km.
+     * @param[in] centerp if true (default), return centers of the grid
+     *   squares, else return SW (lower left) corners.
+     * @exception GeographicErr if any \e gridref is illegal.
+     *
+     * A grid reference which fills its slot entirely (i.e., has no
+     * terminating null within \e stride characters) is taken to be \e stride
+     * characters long.  If an error is thrown for point \e i, the results for
+     * the preceding points have been stored.
+     **********************************************************************/
+    static void GridReference(size_t n, const char gridref[], size_t stride,
+                              real x[], real y[], int prec[],
+                              bool centerp = true);
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
@@ -0,0 +1,188 @@
+/**
+ * \file PointInPolygon.hpp
+ * \brief Header for GeographicLib::PointInPolygon class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POINTINPOLYGON_HPP)
+#define GEOGRAPHICLIB_POINTINPOLYGON_HPP 1
+
+#include <vector>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/Intersect.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Point-in-polygon tests for a geodesic polygon
+   *
+   * This class determines whether points lie inside a fixed polygon whose
+   * edges are geodesics.  The polygon is specified in the constructor by its
+   * vertices and its interior is taken to be the smaller of the two regions
+   * of the ellipsoid bounded by the edges; this is the region whose area is
+   * returned by PolygonAreaT::Compute with \e sign = true.  The polygon may
+   * encircle a pole.  Points on the boundary may be reported as inside or
+   * outside.
+   *
+   * A point is inside if the meridian from the point to the north pole
+   * crosses the boundary an odd number of times, with this result inverted
+   * if the north pole is inside; the status of the north pole is found in
+   * the constructor from the area of the polygon and the net change of
+   * longitude around it.  In order to count the crossings quickly, the edges
+   * are split into pieces spanning at most 5&deg; of arc and the range of
+   * longitudes is divided into slabs at the longitudes of the ends of the
+   * pieces; each slab records the pieces which cross it.  A query finds its
+   * slab by a binary search and, for each of the \e k pieces crossing it,
+   * compares its latitude with the range of latitudes of the piece.  Only if
+   * the latitude lies within this range is the crossing point of the piece
+   * and the meridian found, using Intersect::Closest.  The cost of a query is
+   * therefore O(log \e E + \e k) where \e E is the number of edges.  The
+   * memory required is proportional to the total number of crossings of the
+   * slabs by the pieces; this is roughly \e E times the number of times a
+   * typical meridian crosses the boundary.
+   *
+   * Example of use:
+   * \include example-PointInPolygon.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT PointInPolygon {
+  private:
+    typedef Math::real real;
+    // The maximum arc length of a piece of an edge (degrees)
+    static const int maxarc_ = 5;
+    class piece {
+    public:
+      real lon1,                // longitude of the first end
+        lon12,                  // longitude difference across the piece
+        latmin, latmax,         // range of latitudes on the piece
+        x1, x2;                 // distances of the ends along the edge
+      size_t edge;              // index of the edge
+    };
+    Geodesic _geod;
+    Intersect _inter;
+    std::vector<GeodesicLine> _edges;
+    std::vector<piece> _pieces;
+    // The longitudes of the boundaries of the slabs in [-180,180) and,
+    // in CSR format, the pieces crossing each slab; so slab j spans
+    // [_slabs[j], _slabs[j+1]) and is crossed by the pieces
+    // _slabpieces[_slabstart[j]], ..., _slabpieces[_slabstart[j+1]-1].
+    std::vector<real> _slabs;
+    std::vector<size_t> _slabstart, _slabpieces;
+    real _area;
+    // The bounding box of the polygon
+    real _latmin, _latmax, _lonmin, _lonmax;
+    bool _north, _south;        // Are the poles inside?
+    // The longitude reduced to [-180, 180)
+    static real Key(real lon) {
+      lon = Math::AngNormalize(lon);
+      return lon == Math::hd ? -Math::hd : lon;
+    }
+    bool Contains(real lat, real lon, const Intersect& inter) const;
+    friend class PolygonJoin;   // PolygonJoin calls the private Contains
+  public:
+
+    /**
+     * Constructor for PointInPolygon.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] n the number of vertices.
+     * @param[in] lat an array of \e n latitudes of the vertices (degrees).
+     * @param[in] lon an array of \e n longitudes of the vertices (degrees).
+     *
+     * The edges join consecutive vertices with the last vertex joined to the
+     * first; the polygon need not be explicitly closed.  The vertices may be
+     * given in either clockwise or counter-clockwise order.  The latitudes
+     * should be in the range [&minus;90&deg;, 90&deg;] and each edge should
+     * be the unique shortest geodesic between its vertices.  The edges
+     * shouldn't intersect one another.
+     *
+     * \note If |<i>f</i>| > 1/50, then the Geodesic object should be
+     * constructed with \e exact = true (see Intersect::Intersect).
+     **********************************************************************/
+    PointInPolygon(const Geodesic& geod,
+                   size_t n, const real lat[], const real lon[]);
+
+    /** \name Point-in-polygon tests
+     **********************************************************************/
+    ///@{
+    /**
+     * Test whether a point is inside the polygon.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @return whether the point is inside the polygon.
+     *
+     * \e lat should be in the range [&minus;90&deg;, 90&deg;]; false is
+     * returned if \e lat is a NaN.
+     *
+     * This may be called by several threads at once; however they then
+     * contend for the diagnostic counters of a shared Intersect object and
+     * the next definition of PointInPolygon::Contains is more efficient for
+     * testing many points with several threads.
+     **********************************************************************/
+    bool Contains(real lat, real lon) const
+    { return Contains(lat, lon, _inter); }
+
+    /**
+     * Test whether many points are inside the polygon.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat an array of \e n latitudes of the points (degrees).
+     * @param[in] lon an array of \e n longitudes of the points (degrees).
+     * @param[out] inside an array of \e n results.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is equivalent to calling PointInPolygon::Contains for each point.
+     * If \e nthreads > 1, the points are split into that many contiguous
+     * blocks, each of which is processed on its own thread using a private
+     * copy of the Intersect object.
+     **********************************************************************/
+    void Contains(size_t n, const real lat[], const real lon[],
+                  bool inside[], int nthreads = 1) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of edges of the polygon.
+     **********************************************************************/
+    size_t NumEdges() const { return _edges.size(); }
+
+    /**
+     * @return the area of the interior of the polygon (meters<sup>2</sup>).
+     **********************************************************************/
+    Math::real Area() const { return _area; }
+
+    /**
+     * Find a bounding box for the polygon.
+     *
+     * @param[out] latmin the minimum latitude of the polygon (degrees).
+     * @param[out] latmax the maximum latitude of the polygon (degrees).
+     * @param[out] lonmin the western edge of the box (degrees).
+     * @param[out] lonmax the eastern edge of the box (degrees).
+     *
+     * All the points inside the polygon have latitudes in [\e latmin, \e
+     * latmax] and longitudes in [\e lonmin, \e lonmax] (modulo
+     * 360&deg;).  The latitude range accounts for the vertices of the
+     * geodesic edges.  \e lonmin is in [&minus;180&deg;, 180&deg;) and \e
+     * lonmax &minus; \e lonmin is in [0&deg;, 360&deg;]; thus \e lonmax
+     * may exceed 180&deg; if the polygon straddles the antimeridian.  If the
+     * polygon contains a pole, the longitude range is [&minus;180&deg;,
+     * 180&deg;].
+     **********************************************************************/
+    void Bounds(real& latmin, real& latmax, real& lonmin, real& lonmax)
+      const {
+      latmin = _latmin; latmax = _latmax; lonmin = _lonmin; lonmax = _lonmax;
+    }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_POINTINPOLYGON_HPP
@@ -38,6 +38,13 @@ namespace GeographicLib {
     typedef Math::real real;
     real _a, _f, _e2, _es, _e2m, _c;
     real _k0;
+    // The number of points handled together by the batch Reverse
+    static const size_t block_ = 256;
+    // Forward and Reverse for a single point; gamma and k may be null
+    void ForwardPoint(bool northp, real lat, real lon,
+                      real& x, real& y, real* gamma, real* k) const;
+    void ReversePoint(bool northp, real x, real y,
+                      real& lat, real& lon, real* gamma, real* k) const;
   public:
 
     /**
@@ -102,21 +109,69 @@ namespace GeographicLib {
 
     /**
      * PolarStereographic::Forward without returning the convergence and scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     void Forward(bool northp, real lat, real lon,
-                 real& x, real& y) const {
-      real gamma, k;
-      Forward(northp, lat, lon, x, y, gamma, k);
-    }
+                 real& x, real& y) const
+    { ForwardPoint(northp, lat, lon, x, y, nullptr, nullptr); }
 
     /**
      * PolarStereographic::Reverse without returning the convergence and scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     void Reverse(bool northp, real x, real y,
-                 real& lat, real& lon) const {
-      real gamma, k;
-      Reverse(northp, x, y, lat, lon, gamma, k);
-    }
+                 real& lat, real& lon) const
+    { ReversePoint(northp, x, y, lat, lon, nullptr, nullptr); }
+
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to PolarStereographic::Forward.  The forward
+     * projection is given in closed form; this function is provided for
+     * symmetry with PolarStereographic::Reverse.
+     **********************************************************************/
+    void Forward(bool northp, size_t n, const real lat[], const real lon[],
+                 real x[], real y[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] northp the pole which is the center of projection (true means
+     *   north, false means south).
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to PolarStereographic::Reverse.  The latitudes
+     * are found with the batch version of Math::tauf so that the Newton
+     * iterations are carried out in lockstep for blocks of points.
+     **********************************************************************/
+    void Reverse(bool northp, size_t n, const real x[], const real y[],
+                 real lat[], real lon[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
 
     /** \name Inspector functions
      **********************************************************************/
@@ -116,6 +116,8 @@ namespace GeographicLib {
     }
     template<typename T>
     void AreaReduce(T& area, int crossings, bool reverse, bool sign) const;
+    void Ring(size_t n, const real lat[], const real lon[],
+              bool reverse, bool sign, real& perimeter, real& area) const;
   public:
 
     /**
@@ -155,6 +157,58 @@ namespace GeographicLib {
      **********************************************************************/
     void AddPoint(real lat, real lon);
 
+    /**
+     * Add an array of points to the polygon or polyline.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat the array of latitudes of the points (degrees).
+     * @param[in] lon the array of longitudes of the points (degrees).
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * This is equivalent to calling PolygonAreaT::AddPoint for each point
+     * and the results are identical.  The geodesic problems for the edges
+     * are solved for blocks of points with the edges of a block divided
+     * among \e nthreads threads; the contributions of the edges are then
+     * accumulated in order.  Thus the results are also independent of \e
+     * nthreads.
+     **********************************************************************/
+    void AddPoints(size_t n, const real lat[], const real lon[],
+                   int nthreads = 1);
+
+    /**
+     * Compute the perimeters and areas of many polygons or polylines.
+     *
+     * @param[in] nrings the number of polygons (or polylines).
+     * @param[in] offsets the array of \e nrings + 1 offsets into \e lat and
+     *   \e lon of the vertices of the polygons.
+     * @param[in] lat the array of latitudes of the vertices (degrees).
+     * @param[in] lon the array of longitudes of the vertices (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the array of the \e nrings perimeters of the
+     *   polygons or lengths of the polylines (meters).
+     * @param[out] area the array of the \e nrings areas of the polygons
+     *   (meters<sup>2</sup>); only set if \e polyline is false in the
+     *   constructor.
+     * @param[in] nthreads the number of threads to use (default 1).
+     *
+     * The vertices of polygon \e k are those with indices in
+     * [<i>offsets</i>[<i>k</i>], <i>offsets</i>[<i>k</i>+1]), as in the
+     * "flattened" layout used for multipolygons; the first vertex should not
+     * be repeated at the end.  The results for each polygon are identical to
+     * those obtained by adding its vertices to a new PolygonAreaT with
+     * PolygonAreaT::AddPoint and calling PolygonAreaT::Compute.  This object
+     * is not modified (it only supplies the geodesic object and the polyline
+     * flag).  The polygons are divided among \e nthreads threads.
+     **********************************************************************/
+    void Rings(size_t nrings, const size_t offsets[],
+               const real lat[], const real lon[],
+               bool reverse, bool sign,
+               real perimeter[], real area[], int nthreads = 1) const;
+
     /**
      * Add an edge to the polygon or polyline.
      *
@@ -213,6 +267,37 @@ namespace GeographicLib {
     unsigned TestPoint(real lat, real lon, bool reverse, bool sign,
                        real& perimeter, real& area) const;
 
+    /**
+     * Return the results for many tentative final points; the data for the
+     * points is not saved.
+     *
+     * @param[in] n the number of test points.
+     * @param[in] lat the array of latitudes of the test points (degrees).
+     * @param[in] lon the array of longitudes of the test points (degrees).
+     * @param[in] reverse if true then clockwise (instead of counter-clockwise)
+     *   traversal counts as a positive area.
+     * @param[in] sign if true then return a signed result for the area if
+     *   the polygon is traversed in the "wrong" direction instead of returning
+     *   the area for the rest of the earth.
+     * @param[out] perimeter the array of the approximate perimeters (meters).
+     * @param[out] area the array of the approximate areas
+     *   (meters<sup>2</sup>); only set if polyline is false in the
+     *   constructor (otherwise it may be null).
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @return the number of points including the test point.
+     *
+     * This is equivalent to calling PolygonAreaT::TestPoint for each of the
+     * \e n test points and the results are identical.  This lets you
+     * evaluate many candidate points at once, e.g., the suggestions for
+     * snapping the next vertex of a polygon being edited.  The sums for the
+     * current polygon are computed once and the geodesic problems for the
+     * test points are divided among \e nthreads threads.
+     **********************************************************************/
+    unsigned TestPoints(size_t n, const real lat[], const real lon[],
+                        bool reverse, bool sign,
+                        real perimeter[], real area[], int nthreads = 1)
+      const;
+
     /**
      * Return the results assuming a tentative final test point is added via an
      * azimuth and distance; however, the data for the test point is not saved.
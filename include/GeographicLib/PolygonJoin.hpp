@@ -0,0 +1,187 @@
+/**
+ * \file PolygonJoin.hpp
+ * \brief Header for GeographicLib::PolygonJoin class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POLYGONJOIN_HPP)
+#define GEOGRAPHICLIB_POLYGONJOIN_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/PointInPolygon.hpp>
+#include <vector>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+// Squelch warnings about dll vs vector
+#  pragma warning (push)
+#  pragma warning (disable: 4251)
+#endif
+
+namespace GeographicLib {
+
+  /**
+   * \brief Find which of many geodesic polygons contain points
+   *
+   * This class joins points against a fixed set of polygons whose edges are
+   * geodesics, e.g., administrative boundaries; for each point it finds the
+   * polygon containing it.  Each polygon is represented by a PointInPolygon
+   * object, so that the containment test is exactly that of
+   * PointInPolygon::Contains (and consistent with the area returned by
+   * PolygonAreaT::Compute).
+   *
+   * The bounding boxes of the polygons, PointInPolygon::Bounds, are entered
+   * into a uniform grid in latitude and longitude, with the cell size set
+   * from the median size of the boxes.  A query looks up the cell
+   * containing the point and tests the polygons entered in that cell whose
+   * bounding boxes contain the point.  Polygons whose boxes cover more than
+   * 256 cells (e.g., polygons containing a pole) are kept in a separate list
+   * which is checked for every point.
+   *
+   * The batch version of Find() sorts the points by grid cell (with a
+   * counting sort), so that the points in a cell are processed together and
+   * the edges of the candidate polygons stay in cache; the points are then
+   * handed out in chunks to several threads.
+   *
+   * Example of use:
+   * \include example-PolygonJoin.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT PolygonJoin {
+  private:
+    typedef Math::real real;
+    // The maximum number of rows of the grid and the maximum number of cells
+    // covered by a polygon which is entered into the grid
+    static const int maxrows_ = 1024, maxcells_ = 256;
+    Geodesic _geod;
+    Intersect _inter;
+    std::vector<PointInPolygon> _polys;
+    // The bounding boxes of the polygons as latmin, latmax, lonmin, lonmax
+    std::vector<real> _bounds;
+    // The grid has _nrows rows of _ncols = 2 * _nrows cells each of size _h
+    // degrees.  The polygons entered into cell k are, in CSR format,
+    // _cellpolys[_cellstart[k]], ..., _cellpolys[_cellstart[k+1]-1] (in
+    // increasing order).  _large lists the other polygons.
+    int _nrows, _ncols;
+    real _h;
+    std::vector<size_t> _cellstart;
+    std::vector<int> _cellpolys, _large;
+    // The row and column of the cell containing a point
+    int Row(real lat) const {
+      return std::min(_nrows - 1, std::max(0, int((lat + Math::qd) / _h)));
+    }
+    int Col(real lon) const {
+      return std::min(_ncols - 1, std::max(0, int((lon + Math::hd) / _h)));
+    }
+    // The grid cell of a point, or -1 if lat or lon is invalid
+    long long Cell(real lat, real lon) const;
+    bool InBox(int k, real lat, real lon) const;
+    int Find(real lat, real lon, long long cell, const Intersect& inter)
+      const;
+  public:
+
+    /**
+     * Constructor for PolygonJoin.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     * @param[in] npolys the number of polygons.
+     * @param[in] start an array of \e npolys + 1 offsets; polygon \e k has
+     *   the vertices with indices in [<i>start</i>[<i>k</i>],
+     *   <i>start</i>[<i>k</i>+1]).
+     * @param[in] lat an array of the latitudes of the vertices (degrees).
+     * @param[in] lon an array of the longitudes of the vertices (degrees).
+     * @exception GeographicErr if \e npolys is too large or \e start is
+     *   not nondecreasing.
+     * @exception std::bad_alloc if the memory for the polygons and the grid
+     *   can't be allocated.
+     *
+     * The requirements on the vertices of each polygon are the same as for
+     * PointInPolygon::PointInPolygon.  The polygons are numbered 0, 1, ...,
+     * \e npolys &minus; 1 in the order given.
+     **********************************************************************/
+    PolygonJoin(const Geodesic& geod, size_t npolys, const size_t start[],
+                const real lat[], const real lon[]);
+
+    /** \name Finding the polygons containing points
+     **********************************************************************/
+    ///@{
+    /**
+     * Find the polygon containing a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @return the index of the polygon containing the point or &minus;1 if
+     *   there's none.
+     *
+     * If the point lies in several (overlapping) polygons, the smallest
+     * index is returned.  &minus;1 is returned if \e lat or \e lon is NaN.
+     * Points on the boundaries of polygons may be assigned to either
+     * polygon.
+     **********************************************************************/
+    int Find(real lat, real lon) const
+    { return Find(lat, lon, Cell(lat, lon), _inter); }
+
+    /**
+     * Find all the polygons containing a point.
+     *
+     * @param[in] lat latitude of the point (degrees).
+     * @param[in] lon longitude of the point (degrees).
+     * @param[out] polys the indices of the polygons containing the point in
+     *   increasing order.
+     * @exception std::bad_alloc if memory for \e polys can't be allocated.
+     **********************************************************************/
+    void FindAll(real lat, real lon, std::vector<int>& polys) const;
+
+    /**
+     * Find the polygons containing many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat an array of \e n latitudes of the points (degrees).
+     * @param[in] lon an array of \e n longitudes of the points (degrees).
+     * @param[out] poly an array of \e n results, each as returned by
+     *   Find(real, real) const.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * The points are processed in the order of the grid cells containing
+     * them; this requires temporary storage of about 16 \e n bytes, so very
+     * large numbers of points should be passed in blocks of, say,
+     * 10<sup>7</sup> points.  If \e nthreads > 1, the sorted points are handed
+     * out in chunks to that many tasks, which are run with Executor::Batch,
+     * each with its own copy of the Intersect object.
+     **********************************************************************/
+    void Find(size_t n, const real lat[], const real lon[], int poly[],
+              int nthreads = 1) const;
+    ///@}
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of polygons.
+     **********************************************************************/
+    int NumPolygons() const { return int(_polys.size()); }
+
+    /**
+     * @param[in] k the index of a polygon.
+     * @return a reference to the PointInPolygon object for polygon \e k.
+     **********************************************************************/
+    const PointInPolygon& Polygon(int k) const { return _polys[k]; }
+
+    /**
+     * @return the size of the cells of the grid (degrees).
+     **********************************************************************/
+    Math::real CellSize() const { return _h; }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // GEOGRAPHICLIB_POLYGONJOIN_HPP
@@ -0,0 +1,121 @@
+/**
+ * \file PolylineSimplifier.hpp
+ * \brief Header for GeographicLib::PolylineSimplifier class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_POLYLINESIMPLIFIER_HPP)
+#define GEOGRAPHICLIB_POLYLINESIMPLIFIER_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <vector>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Simplify geodesic polylines
+   *
+   * This class reduces the number of vertices of a polyline whose segments
+   * are geodesics, e.g., a GPS track, with either of two classic algorithms
+   * carried out with geodesic calculations instead of in a projection:
+   * - Douglas&ndash;Peucker, DouglasPeucker(), which keeps the vertex
+   *   furthest from the segment joining the ends of a section of the
+   *   polyline if its distance exceeds a tolerance and then treats the two
+   *   halves recursively.  The distance is the cross-track distance to the
+   *   geodesic segment as found by ClosestPoint::ClosestOnSegment.  This
+   *   guarantees that each removed vertex lies within the tolerance of the
+   *   segment of the simplified polyline which replaces it.  (The distances
+   *   found are the distances to actual points on the segment; so the
+   *   guarantee holds even if the iteration converges to a local minimum.)
+   * - Visvalingam&ndash;Whyatt, Visvalingam(), which repeatedly removes the
+   *   vertex whose triangle with its neighbors has the smallest area, as
+   *   given by PolygonAreaT::Compute, until all the remaining triangles have
+   *   areas no smaller than a threshold.  The effective area of a vertex is
+   *   not allowed to decrease when a neighbor is removed, so that the result
+   *   is that of repeatedly removing the least significant vertex.
+   * .
+   * The first and last vertices are always kept; so a closed ring
+   * (with the first vertex repeated at its end) stays closed.
+   *
+   * Douglas&ndash;Peucker is applied in rounds: in each round the distances
+   * of all the vertices in the unresolved sections are computed in a single
+   * batch (which may be split among several threads) and then each section
+   * is either resolved or split in two.  The result is the same as for the
+   * recursive formulation and does not depend on the number of threads.
+   *
+   * Example of use:
+   * \include example-PolylineSimplifier.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT PolylineSimplifier {
+  private:
+    typedef Math::real real;
+    Geodesic _geod;
+  public:
+
+    /**
+     * Constructor for PolylineSimplifier.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     **********************************************************************/
+    explicit PolylineSimplifier(const Geodesic& geod) : _geod(geod) {}
+
+    /**
+     * Simplify a polyline with the Douglas&ndash;Peucker algorithm.
+     *
+     * @param[in] n the number of vertices.
+     * @param[in] lat an array of \e n latitudes of the vertices (degrees).
+     * @param[in] lon an array of \e n longitudes of the vertices (degrees).
+     * @param[in] tol the tolerance (meters).
+     * @param[out] keep the indices of the vertices kept, in increasing order.
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception GeographicErr if a latitude is not in [&minus;90&deg;,
+     *   90&deg;] or \e tol is negative or NaN.
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * Every vertex not in \e keep lies within \e tol of the geodesic segment
+     * joining the kept vertices on either side of it.  \e tol = 0 removes
+     * only the vertices which lie exactly on the segments.  If \e nthreads >
+     * 1, the distance calculations in each round are split among that many
+     * tasks which are run with Executor::Batch.
+     **********************************************************************/
+    void DouglasPeucker(size_t n, const real lat[], const real lon[],
+                        real tol, std::vector<size_t>& keep,
+                        int nthreads = 1) const;
+
+    /**
+     * Simplify a polyline with the Visvalingam&ndash;Whyatt algorithm.
+     *
+     * @param[in] n the number of vertices.
+     * @param[in] lat an array of \e n latitudes of the vertices (degrees).
+     * @param[in] lon an array of \e n longitudes of the vertices (degrees).
+     * @param[in] area the threshold area (meters<sup>2</sup>).
+     * @param[out] keep the indices of the vertices kept, in increasing order.
+     * @param[in] nthreads the number of threads to use for computing the
+     *   initial areas (default 1).
+     * @exception GeographicErr if a latitude is not in [&minus;90&deg;,
+     *   90&deg;] or \e area is negative or NaN.
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * The vertices with effective areas less than \e area are removed.  The
+     * removals are inherently sequential; however the initial areas, which
+     * account for about a third of the geodesic calculations, are computed
+     * in a batch which may be split among \e nthreads tasks.
+     **********************************************************************/
+    void Visvalingam(size_t n, const real lat[], const real lon[],
+                     real area, std::vector<size_t>& keep,
+                     int nthreads = 1) const;
+
+    /**
+     * @return a reference to the Geodesic object used.
+     **********************************************************************/
+    const Geodesic& GeodesicObject() const { return _geod; }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_POLYLINESIMPLIFIER_HPP
@@ -0,0 +1,277 @@
+/**
+ * \file ProjectionPipeline.hpp
+ * \brief Header for GeographicLib::ProjectionPipeline class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_PROJECTIONPIPELINE_HPP)
+#define GEOGRAPHICLIB_PROJECTIONPIPELINE_HPP 1
+
+#include <memory>
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/PolarStereographic.hpp>
+#include <GeographicLib/LambertConformalConic.hpp>
+#include <GeographicLib/AlbersEqualArea.hpp>
+#include <GeographicLib/LocalCartesian.hpp>
+#include <GeographicLib/Geocentric.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Conversions between two coordinate systems
+   *
+   * Convert coordinates from one system (e.g., UTM zone 33 north) to another
+   * (e.g., a particular LambertConformalConic projection or LocalCartesian
+   * system) with a single call.  The systems are described by
+   * ProjectionPipeline::System objects and the conversion is set up once by
+   * the constructor, which selects the most direct path between the two
+   * systems:
+   * - identical systems: the coordinates are copied;
+   * - two UTM/UPS systems: UTMUPS::Transfer is used, so that a change of
+   *   hemisphere in the same UTM zone involves no projection;
+   * - Geocentric and LocalCartesian systems on the same ellipsoid: the
+   *   conversion is a precomputed rotation and translation in cartesian
+   *   coordinates (no geodetic coordinates are computed);
+   * - otherwise, the coordinates are converted to geographic coordinates
+   *   with the input system and from geographic coordinates with the output
+   *   system.
+   *
+   * Each system has three coordinates.  For geographic coordinates these are
+   * the latitude, longitude (degrees), and height (meters); for Geocentric
+   * and LocalCartesian, they are the cartesian coordinates (meters); for the
+   * map projections, they are easting and northing (meters) and the height,
+   * which is passed through unchanged.  No change of datum is made; if the
+   * two systems use different ellipsoids, the geographic coordinates are
+   * taken to be the same in both.
+   *
+   * ProjectionPipeline::Transform converts many points, processing them in
+   * small blocks with the batch functions of the underlying classes
+   * (TransverseMercator::Forward, LocalCartesian::Reverse, etc.), so the
+   * intermediate geographic coordinates stay in cache.  A System holds a
+   * copy of the projection object it is constructed with; so the object
+   * need not outlive the System.  The functions are \e const and so may be
+   * called from several threads.
+   *
+   * Example of use:
+   * \include example-ProjectionPipeline.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT ProjectionPipeline {
+  private:
+    typedef Math::real real;
+    // The number of points handled together by the batch function
+    static const size_t block_ = 256;
+    enum path {
+      COPY,
+      TRANSFER,
+      AFFINE,
+      GENERAL,
+    };
+  public:
+
+    /**
+     * \brief A coordinate system for ProjectionPipeline
+     *
+     * Create a System with one of the static functions
+     * ProjectionPipeline::System::Geographic,
+     * ProjectionPipeline::System::UTMUPS, etc.
+     **********************************************************************/
+    class GEOGRAPHICLIB_EXPORT System {
+    private:
+      friend class ProjectionPipeline;
+      enum kind {
+        GEOGRAPHIC,
+        UTMUPSZONE,
+        TRANSVERSEMERCATOR,
+        POLARSTEREOGRAPHIC,
+        LAMBERTCONFORMALCONIC,
+        ALBERSEQUALAREA,
+        LOCALCARTESIAN,
+        GEOCENTRIC,
+      };
+      kind _kind;
+      int _zone;
+      bool _northp;
+      real _lon0;
+      std::shared_ptr<const GeographicLib::TransverseMercator> _tm;
+      std::shared_ptr<const GeographicLib::PolarStereographic> _ps;
+      std::shared_ptr<const GeographicLib::LambertConformalConic> _lcc;
+      std::shared_ptr<const GeographicLib::AlbersEqualArea> _aea;
+      std::shared_ptr<const GeographicLib::LocalCartesian> _lc;
+      std::shared_ptr<const GeographicLib::Geocentric> _geo;
+      System(kind k)
+        : _kind(k), _zone(0), _northp(false), _lon0(0) {}
+      // Is it the Geocentric or LocalCartesian system?
+      bool Cartesian() const
+      { return _kind == LOCALCARTESIAN || _kind == GEOCENTRIC; }
+      // The ellipsoid for a cartesian system
+      void Ellipsoid(real& a, real& f) const;
+      bool Same(const System& s) const;
+      void Reverse(real x, real y, real z,
+                   real& lat, real& lon, real& h) const;
+      void Forward(real lat, real lon, real h,
+                   real& x, real& y, real& z) const;
+      void Reverse(size_t n, const real x[], const real y[], const real z[],
+                   real lat[], real lon[], real h[]) const;
+      void Forward(size_t n, const real lat[], const real lon[],
+                   const real h[], real x[], real y[], real z[]) const;
+    public:
+      /**
+       * @return geographic coordinates (latitude, longitude, height).
+       **********************************************************************/
+      static System Geographic();
+
+      /**
+       * @param[in] zone the UTM zone (1 to 60) or 0 for UPS.
+       * @param[in] northp hemisphere (true means north, false means south).
+       * @exception GeographicErr if \e zone is not in [0, 60].
+       * @return UTM or UPS coordinates in a given zone and hemisphere.
+       *
+       * On output, the points must lie within UTMUPS::Forward's limits for
+       * the zone (e.g., within 9&deg; of the central meridian for UTM) or
+       * else an exception is thrown.
+       **********************************************************************/
+      static System UTMUPS(int zone, bool northp);
+
+      /**
+       * @param[in] tm the TransverseMercator object.
+       * @param[in] lon0 the central meridian (degrees).
+       * @return transverse Mercator coordinates.
+       **********************************************************************/
+      static System
+      TransverseMercator(const GeographicLib::TransverseMercator& tm,
+                         real lon0);
+
+      /**
+       * @param[in] ps the PolarStereographic object.
+       * @param[in] northp the pole (true means north, false means south).
+       * @return polar stereographic coordinates.
+       **********************************************************************/
+      static System
+      PolarStereographic(const GeographicLib::PolarStereographic& ps,
+                         bool northp);
+
+      /**
+       * @param[in] lcc the LambertConformalConic object.
+       * @param[in] lon0 the central meridian (degrees).
+       * @return Lambert conformal conic coordinates.
+       **********************************************************************/
+      static System
+      LambertConformalConic(const GeographicLib::LambertConformalConic& lcc,
+                            real lon0);
+
+      /**
+       * @param[in] aea the AlbersEqualArea object.
+       * @param[in] lon0 the central meridian (degrees).
+       * @return Albers equal area coordinates.
+       **********************************************************************/
+      static System
+      AlbersEqualArea(const GeographicLib::AlbersEqualArea& aea, real lon0);
+
+      /**
+       * @param[in] lc the LocalCartesian object (which includes the origin).
+       * @return local cartesian coordinates.
+       **********************************************************************/
+      static System
+      LocalCartesian(const GeographicLib::LocalCartesian& lc);
+
+      /**
+       * @param[in] earth the Geocentric object.
+       * @return geocentric coordinates.
+       **********************************************************************/
+      static System
+      Geocentric(const GeographicLib::Geocentric& earth);
+    };
+
+  private:
+    System _in, _out;
+    path _path;
+    // For AFFINE: out = _t + _r . in
+    real _t[3], _r[9];
+    // The conversion to geocentric coordinates for a cartesian system,
+    // X = t + R . x
+    static void ToGeocentric(const System& s, real t[3], real R[9]);
+    // Do the (cartesian) input and output systems use the same ellipsoid?
+    bool SameEllipsoid() const;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] in the input coordinate system.
+     * @param[in] out the output coordinate system.
+     **********************************************************************/
+    ProjectionPipeline(const System& in, const System& out);
+
+    /**
+     * Convert a point.
+     *
+     * @param[in] x the first input coordinate.
+     * @param[in] y the second input coordinate.
+     * @param[in] z the third input coordinate.
+     * @param[out] X the first output coordinate.
+     * @param[out] Y the second output coordinate.
+     * @param[out] Z the third output coordinate.
+     * @exception GeographicErr if the point cannot be represented in the
+     *   output UTM/UPS system.
+     *
+     * See the description of ProjectionPipeline for the meaning of the
+     * coordinates.
+     **********************************************************************/
+    void Transform(real x, real y, real z, real& X, real& Y, real& Z) const;
+
+    /**
+     * Convert a point without the third coordinate.
+     *
+     * @param[in] x the first input coordinate.
+     * @param[in] y the second input coordinate.
+     * @param[out] X the first output coordinate.
+     * @param[out] Y the second output coordinate.
+     * @exception GeographicErr if the point cannot be represented in the
+     *   output UTM/UPS system.
+     *
+     * The third input coordinate is taken to be 0.  This is appropriate for
+     * conversions between geographic coordinates and map projections; for
+     * cartesian systems, it's preferable to supply all three coordinates.
+     **********************************************************************/
+    void Transform(real x, real y, real& X, real& Y) const {
+      real Z;
+      Transform(x, y, real(0), X, Y, Z);
+    }
+
+    /**
+     * Convert many points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of the first input coordinates.
+     * @param[in] y array of the second input coordinates.
+     * @param[in] z array of the third input coordinates; this may be null in
+     *   which case these are taken to be 0.
+     * @param[out] X array of the first output coordinates.
+     * @param[out] Y array of the second output coordinates.
+     * @param[out] Z array of the third output coordinates; this may be null.
+     * @exception GeographicErr if any point cannot be represented in the
+     *   output UTM/UPS system; in this case, the contents of the output
+     *   arrays are unspecified.
+     *
+     * Each array holds \e n elements.  The output arrays may be the same as
+     * the corresponding input arrays.  The points are processed in blocks of
+     * a few hundred points.
+     **********************************************************************/
+    void Transform(size_t n, const real x[], const real y[], const real z[],
+                   real X[], real Y[], real Z[] = nullptr) const;
+
+    /**
+     * @return a pipeline for the reverse conversion.
+     **********************************************************************/
+    ProjectionPipeline Inverse() const
+    { return ProjectionPipeline(_out, _in); }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_PROJECTIONPIPELINE_HPP
@@ -0,0 +1,127 @@
+/**
+ * \file Registry.hpp
+ * \brief Header for GeographicLib::Registry class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_REGISTRY_HPP)
+#define GEOGRAPHICLIB_REGISTRY_HPP 1
+
+#include <atomic>
+#include <mutex>
+#include <cmath>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A registry of shared instances of a class
+   *
+   * @tparam T the class of the instances.
+   *
+   * This holds one instance of \e T for each set of parameters with which
+   * Registry::Get has been called.  It implements Geodesic::Get, Rhumb::Get,
+   * and TransverseMercator::Get, which return shared instances for an
+   * arbitrary ellipsoid; it's not intended to be used directly.  The
+   * parameters are three real numbers and an integer of flags (a
+   * class needing fewer parameters sets the others to fixed values); pairs of
+   * NaNs are treated as equal.
+   *
+   * The instances are kept in a singly linked list which is only ever added
+   * to.  A lookup of an instance which is already present walks the list
+   * without locking; only the construction of a new instance is serialized
+   * with a mutex.  The instances are destroyed when the registry is
+   * destroyed (at the end of the program for the registries used by the
+   * library).  Because the list is searched linearly, the registry is meant
+   * for a modest number (up to a few hundred) of distinct parameter sets.
+   **********************************************************************/
+  template<class T>
+  class Registry {
+  private:
+    typedef Math::real real;
+    struct entry {
+      real a, b, c;
+      int flags;
+      const T* obj;
+      entry* next;
+    };
+    std::atomic<entry*> _head;
+    std::mutex _lock;
+    static bool same(real x, real y) {
+      using std::isnan;
+      return x == y || (isnan(x) && isnan(y));
+    }
+    static const entry* find(const entry* e, real a, real b, real c,
+                             int flags) {
+      for (; e; e = e->next)
+        if (e->flags == flags && same(e->a, a) && same(e->b, b) &&
+            same(e->c, c))
+          return e;
+      return nullptr;
+    }
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+  public:
+    /**
+     * Constructor for an empty Registry.
+     **********************************************************************/
+    Registry() : _head(nullptr) {}
+
+    /**
+     * The destructor deletes the instances in the registry.
+     **********************************************************************/
+    ~Registry() {
+      for (entry* e = _head.load(); e;) {
+        entry* n = e->next;
+        delete e->obj;
+        delete e;
+        e = n;
+      }
+    }
+
+    /**
+     * Look up or construct an instance.
+     *
+     * @tparam F the type of \e make.
+     * @param[in] a the first parameter.
+     * @param[in] b the second parameter.
+     * @param[in] c the third parameter.
+     * @param[in] flags the integer parameter.
+     * @param[in] make a function, called with no arguments, returning a
+     *   pointer to a new instance for these parameters.
+     * @exception any exceptions thrown by \e make; nothing is then added to
+     *   the registry.
+     * @return a reference to the instance for these parameters.
+     *
+     * \e make is only called the first time a set of parameters is seen.
+     * This may be called by several threads at once.
+     **********************************************************************/
+    template<class F>
+    const T& Get(real a, real b, real c, int flags, const F& make) {
+      const entry* e = find(_head.load(std::memory_order_acquire),
+                            a, b, c, flags);
+      if (e) return *e->obj;
+      std::lock_guard<std::mutex> g(_lock);
+      entry* head = _head.load(std::memory_order_relaxed);
+      e = find(head, a, b, c, flags);
+      if (e) return *e->obj;
+      entry* n = new entry;
+      try {
+        n->obj = make();
+      }
+      catch (...) {
+        delete n;
+        throw;
+      }
+      n->a = a; n->b = b; n->c = c; n->flags = flags; n->next = head;
+      _head.store(n, std::memory_order_release);
+      return *n->obj;
+    }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_REGISTRY_HPP
@@ -96,6 +96,10 @@ namespace GeographicLib {
     };
 
     real MeanSinXi(const AuxAngle& chix, const AuxAngle& chiy) const;
+    // The same given also the geographic and parametric latitudes
+    real MeanSinXi(const AuxAngle& chix, const AuxAngle& chiy,
+                   const AuxAngle& phix, const AuxAngle& phiy,
+                   const AuxAngle& betax, const AuxAngle& betay) const;
 
     // The following two functions (with lots of ignored arguments) mimic the
     // interface to the corresponding Geodesic function.  These are needed by
@@ -111,6 +115,11 @@ namespace GeographicLib {
                     real&, real& , real& , real& , real& S12) const {
       GenInverse(lat1, lon1, lat2, lon2, outmask, s12, azi12, S12);
     }
+    // The inverse problem given the auxiliary latitudes phi and chi.
+    void IntInverse(const AuxAngle& phi1, const AuxAngle& chi1, real lon1,
+                    const AuxAngle& phi2, const AuxAngle& chi2, real lon2,
+                    unsigned outmask,
+                    real& s12, real& azi12, real& S12) const;
 
   public:
     /**
@@ -303,6 +312,39 @@ namespace GeographicLib {
                     unsigned outmask,
                     real& s12, real& azi12, real& S12) const;
 
+    /**
+     * Solve the inverse rhumb problem between every point in one set and
+     * every point in another set.
+     *
+     * @param[in] nrows the number of points in the first set.
+     * @param[in] lat1 array of latitudes of the first set (degrees).
+     * @param[in] lon1 array of longitudes of the first set (degrees).
+     * @param[in] ncols the number of points in the second set.
+     * @param[in] lat2 array of latitudes of the second set (degrees).
+     * @param[in] lon2 array of longitudes of the second set (degrees).
+     * @param[in] outmask a bitor'ed combination of Rhumb::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] s12 matrix of rhumb distances (meters).
+     * @param[out] azi12 matrix of azimuths of the rhumb lines (degrees).
+     * @param[out] S12 matrix of areas under the rhumb lines
+     *   (meters<sup>2</sup>).
+     *
+     * The result for the line from point \e i of the first set to point \e
+     * j of the second set is in element <i>i</i> \e ncols + \e j of the
+     * output arrays.  Each output array selected by \e outmask must hold \e
+     * nrows &times; \e ncols elements; the arrays which are not selected are
+     * not referenced and may be null.  The results are identical to those
+     * returned by Rhumb::GenInverse.  The conformal latitude of each point
+     * is computed once; only the divided differences needed for the distance
+     * and area are computed for each pair.  To find the rhumb lines between
+     * all the pairs of a single set of waypoints, pass the same arrays for
+     * both sets.
+     **********************************************************************/
+    void InverseMatrix(size_t nrows, const real lat1[], const real lon1[],
+                       size_t ncols, const real lat2[], const real lon2[],
+                       unsigned outmask,
+                       real s12[], real azi12[], real S12[]) const;
+
     /**
      * Typedef for the class for computing multiple points on a rhumb line.
      **********************************************************************/
@@ -356,8 +398,31 @@ namespace GeographicLib {
     /**
      * A global instantiation of Rhumb with the parameters for the WGS84
      * ellipsoid.
+     *
+     * \see Constants for the cost of the first and subsequent calls.
      **********************************************************************/
     static const Rhumb& WGS84();
+
+    /**
+     * A shared instantiation of Rhumb for an arbitrary ellipsoid.
+     *
+     * @param[in] a equatorial radius (meters).
+     * @param[in] f flattening of ellipsoid.
+     * @param[in] exact if true use exact formulation (default false).
+     * @exception GeographicErr if the constructor throws an exception.
+     * @return a reference to the shared instance with these parameters.
+     *
+     * The instance is constructed the first time this function is called
+     * with a particular set of parameters and is returned by subsequent
+     * calls with the same parameters; it persists until the end of the
+     * program.  Thus a program using several ellipsoids need not construct
+     * a new Rhumb (computing its coefficients) for each calculation.  This
+     * is thread safe and, once the instance has been constructed, a lookup
+     * doesn't take a lock; see Registry for details.  However the lookup
+     * searches linearly through the instances constructed so far, so this
+     * is intended for a modest number of distinct ellipsoids.
+     **********************************************************************/
+    static const Rhumb& Get(real a, real f, bool exact = false);
   };
 
   /**
@@ -507,6 +572,32 @@ namespace GeographicLib {
     void GenPosition(real s12, unsigned outmask,
                      real& lat2, real& lon2, real& S12) const;
 
+    /**
+     * Compute the positions of many points on the rhumb line.
+     *
+     * @param[in] n the number of points.
+     * @param[in] s12 array of distances from point 1 (meters).
+     * @param[in] outmask a bitor'ed combination of RhumbLine::mask values
+     *   specifying which of the following arrays should be set.
+     * @param[out] lat2 array of latitudes (degrees).
+     * @param[out] lon2 array of longitudes (degrees).
+     * @param[out] S12 array of areas under the rhumb line
+     *   (meters<sup>2</sup>).
+     *
+     * This is equivalent to calling RhumbLine::GenPosition for each element
+     * of \e s12 (the results agree to within roundoff); the arrays which are
+     * not selected by \e outmask are not referenced and may be null.  The
+     * conversions of the rectifying latitudes to geographic, conformal, and
+     * (for the area) parametric latitudes are done for blocks of points with
+     * the array version of AuxLatitude::Convert, which the compiler can
+     * vectorize, and the terms for point 1 are computed once.  This reduces
+     * the cost of densifying a rhumb line (e.g., for plotting) by about a
+     * third.  With an exact Rhumb object, RhumbLine::GenPosition is called
+     * for each point.
+     **********************************************************************/
+    void Positions(size_t n, const real s12[], unsigned outmask,
+                   real lat2[], real lon2[], real S12[] = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
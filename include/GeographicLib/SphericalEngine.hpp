@@ -43,7 +43,7 @@ namespace GeographicLib {
     // CircularEngine needs access to sqrttable, scale
     friend class CircularEngine;
     // Return the table of the square roots of integers
-    static std::vector<real>& sqrttable();
+    static const std::vector<real>& sqrttable();
     // An internal scaling of the coefficients to avoid overflow in
     // intermediate calculations.
     static real scale() {
@@ -99,13 +99,18 @@ namespace GeographicLib {
     class GEOGRAPHICLIB_EXPORT coeff {
     private:
       int _nNx, _nmx, _mmx;
-      std::vector<real>::const_iterator _cCnm;
-      std::vector<real>::const_iterator _sSnm;
+      const real* _cCnm;
+      const real* _sSnm;
+      // The coefficients if they are stored as floats (else null)
+      const float* _cCf;
+      const float* _sSf;
     public:
       /**
        * A default constructor
        **********************************************************************/
-      coeff() : _nNx(-1) , _nmx(-1) , _mmx(-1) {}
+      coeff() : _nNx(-1) , _nmx(-1) , _mmx(-1)
+              , _cCnm(nullptr), _sSnm(nullptr)
+              , _cCf(nullptr), _sSf(nullptr) {}
       /**
        * The general constructor.
        *
@@ -127,8 +132,10 @@ namespace GeographicLib {
         : _nNx(N)
         , _nmx(nmx)
         , _mmx(mmx)
-        , _cCnm(C.begin())
-        , _sSnm(S.begin())
+        , _cCnm(C.data())
+        , _sSnm(S.data())
+        , _cCf(nullptr)
+        , _sSf(nullptr)
       {
         if (!((_nNx >= _nmx && _nmx >= _mmx && _mmx >= 0) ||
               // If mmx = -1 then the sums are empty so require nmx = -1 also.
@@ -157,8 +164,10 @@ namespace GeographicLib {
         : _nNx(N)
         , _nmx(N)
         , _mmx(N)
-        , _cCnm(C.begin())
-        , _sSnm(S.begin())
+        , _cCnm(C.data())
+        , _sSnm(S.data())
+        , _cCf(nullptr)
+        , _sSf(nullptr)
       {
         if (!(_nNx >= -1))
           throw GeographicErr("Bad indices for coeff");
@@ -167,6 +176,82 @@ namespace GeographicLib {
           throw GeographicErr("Arrays too small in coeff");
         SphericalEngine::RootTable(_nmx);
       }
+      /**
+       * The constructor for coefficients held in arrays.
+       *
+       * @param[in] C an array of coefficients for the cosine terms.
+       * @param[in] S an array of coefficients for the sine terms.
+       * @param[in] N the degree giving storage layout for \e C and \e S.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @exception GeographicErr if \e N, \e nmx, and \e mmx do not satisfy
+       *   \e N &ge; \e nmx &ge; \e mmx &ge; &minus;1.
+       * @exception std::bad_alloc if the memory for the square root table
+       *   can't be allocated.
+       *
+       * This is used, for example, to refer to coefficients in a memory
+       * mapped file; see mapcoeffs.  The caller is responsible for ensuring
+       * that \e C and \e S are big enough to hold the coefficients.
+       **********************************************************************/
+      coeff(const real C[], const real S[], int N, int nmx, int mmx)
+        : _nNx(N)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _cCnm(C)
+        , _sSnm(S)
+        , _cCf(nullptr)
+        , _sSf(nullptr)
+      {
+        if (!((_nNx >= _nmx && _nmx >= _mmx && _mmx >= 0) ||
+              (_nmx == -1 && _mmx == -1)))
+          throw GeographicErr("Bad indices for coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * The constructor for coefficients stored as floats.
+       *
+       * @param[in] C an array of coefficients for the cosine terms.
+       * @param[in] Csize the size of \e C.
+       * @param[in] S an array of coefficients for the sine terms.
+       * @param[in] Ssize the size of \e S.
+       * @param[in] N the degree giving storage layout for \e C and \e S.
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @exception GeographicErr if \e N, \e nmx, and \e mmx do not satisfy
+       *   \e N &ge; \e nmx &ge; \e mmx &ge; &minus;1.
+       * @exception GeographicErr if \e C or \e S is not big enough to hold the
+       *   coefficients.
+       * @exception std::bad_alloc if the memory for the square root table
+       *   can't be allocated.
+       *
+       * This halves the memory needed to hold the coefficients (compared to
+       * doubles) at the cost of rounding them to a relative precision of
+       * 6 &times; 10<sup>&minus;8</sup>.  The arrays are used in place and
+       * should not be altered or destroyed during the lifetime of the coeff
+       * object.
+       **********************************************************************/
+      coeff(const float C[], size_t Csize, const float S[], size_t Ssize,
+            int N, int nmx, int mmx)
+        : _nNx(N)
+        , _nmx(nmx)
+        , _mmx(mmx)
+        , _cCnm(nullptr)
+        , _sSnm(nullptr)
+        , _cCf(C)
+        , _sSf(S)
+      {
+        if (!((_nNx >= _nmx && _nmx >= _mmx && _mmx >= 0) ||
+              (_nmx == -1 && _mmx == -1)))
+          throw GeographicErr("Bad indices for coeff");
+        if (!(index(_nmx, _mmx) < int(Csize) &&
+              index(_nmx, _mmx) < int(Ssize) + (_nNx + 1)))
+          throw GeographicErr("Arrays too small in coeff");
+        SphericalEngine::RootTable(_nmx);
+      }
+      /**
+       * @return true if the coefficients are stored as floats.
+       **********************************************************************/
+      bool Compact() const { return _cCf != nullptr; }
       /**
        * @return \e N the degree giving storage layout for \e C and \e S.
        **********************************************************************/
@@ -179,6 +264,25 @@ namespace GeographicLib {
        * @return \e mmx the maximum order to be used.
        **********************************************************************/
       int mmx() const { return _mmx; }
+      /**
+       * A coeff object for the same coefficients with the sums truncated.
+       *
+       * @param[in] nmx the maximum degree to be used.
+       * @param[in] mmx the maximum order to be used.
+       * @return the truncated coeff object.
+       *
+       * The limits of the returned object are \e nmx and \e mmx, reduced if
+       * necessary so that they do not exceed nmx() and mmx() and so that the
+       * order does not exceed the degree.  \e nmx = &minus;1 gives an empty
+       * sum.  The coefficients are not copied.
+       **********************************************************************/
+      coeff Truncate(int nmx, int mmx) const {
+        coeff c(*this);
+        c._nmx = (std::max)(-1, (std::min)(nmx, _nmx));
+        c._mmx = (std::max)(-1, (std::min)((std::min)(mmx, _mmx), c._nmx));
+        if (c._mmx < 0) c._nmx = c._mmx = -1;
+        return c;
+      }
       /**
        * The one-dimensional index into \e C and \e S.
        *
@@ -194,14 +298,18 @@ namespace GeographicLib {
        * @param[in] k the one-dimensional index.
        * @return the value of the \e C coefficient.
        **********************************************************************/
-      Math::real Cv(int k) const { return *(_cCnm + k); }
+      Math::real Cv(int k) const
+      { return _cCf ? real(_cCf[k]) : *(_cCnm + k); }
       /**
        * An element of \e S.
        *
        * @param[in] k the one-dimensional index.
        * @return the value of the \e S coefficient.
        **********************************************************************/
-      Math::real Sv(int k) const { return *(_sSnm + (k - (_nNx + 1))); }
+      Math::real Sv(int k) const {
+        return _sSf ? real(_sSf[k - (_nNx + 1)]) :
+          *(_sSnm + (k - (_nNx + 1)));
+      }
       /**
        * An element of \e C with checking.
        *
@@ -213,7 +321,7 @@ namespace GeographicLib {
        *   and \e m are in range else 0.
        **********************************************************************/
       Math::real Cv(int k, int n, int m, real f) const
-      { return m > _mmx || n > _nmx ? 0 : *(_cCnm + k) * f; }
+      { return m > _mmx || n > _nmx ? 0 : Cv(k) * f; }
       /**
        * An element of \e S with checking.
        *
@@ -225,7 +333,7 @@ namespace GeographicLib {
        *   and \e m are in range else 0.
        **********************************************************************/
       Math::real Sv(int k, int n, int m, real f) const
-      { return m > _mmx || n > _nmx ? 0 : *(_sSnm + (k - (_nNx + 1))) * f; }
+      { return m > _mmx || n > _nmx ? 0 : Sv(k) * f; }
 
       /**
        * The size of the coefficient vector for the cosine terms.
@@ -277,6 +385,57 @@ namespace GeographicLib {
       static void readcoeffs(std::istream& stream, int& N, int& M,
                              std::vector<real>& C, std::vector<real>& S,
                              bool truncate = false);
+
+      /**
+       * Drop the trailing zero coefficients.
+       *
+       * @param[in,out] N The maximum degree of the coefficients.
+       * @param[in,out] M The maximum order of the coefficients.
+       * @param[in,out] C The vector of cosine coefficients.
+       * @param[in,out] S The vector of sine coefficients.
+       *
+       * On return \e N and \e M are the largest degree and order of the
+       * nonzero coefficients (&minus;1 if they are all zero) and \e C and \e
+       * S hold the coefficients in column major order for the new \e N and
+       * \e M; the memory for the dropped coefficients is released.  The sums
+       * are unchanged.  This is applied to the coefficients read by
+       * MagneticModel and to the corrections read by GravityModel (unless
+       * they are mapped) since these are often padded with zeros, e.g., the
+       * early epochs of IGRF use degree 10 and are stored with degree 13.
+       * The cost of a correction or an additional set of coefficients in the
+       * sums computed by SphericalEngine is proportional to its size.
+       **********************************************************************/
+      static void Trim(int& N, int& M,
+                       std::vector<real>& C, std::vector<real>& S);
+
+      /**
+       * Refer to coefficients in a memory mapped file.
+       *
+       * @param[in] data the start of the mapped file.
+       * @param[in] size the size of the mapped file.
+       * @param[in,out] pos the offset in \e data of the coefficients; on
+       *   return this is the offset of the data following the coefficients.
+       * @param[in,out] N The maximum degree of the coefficients.
+       * @param[in,out] M The maximum order of the coefficients.
+       * @param[in] truncate if false (the default) then \e N and \e M are
+       *   determined by the values in the data; otherwise, the input values of
+       *   \e N and \e M are used to truncate the coefficients at the given
+       *   degree and order.
+       * @exception GeographicErr if \e N and \e M do not satisfy \e N &ge;
+       *   \e M &ge; &minus;1.
+       * @exception GeographicErr if the data is too short or misaligned, or
+       *   if the machine is big-endian or GEOGRAPHICLIB_PRECISION is not 2.
+       * @return a coeff object referring to the coefficients in \e data.
+       *
+       * The data has the format described in readcoeffs.  Instead of copying
+       * the coefficients, the returned coeff object points directly into \e
+       * data, which should not be unmapped during the lifetime of the coeff
+       * object.  The storage layout is that of the data, so truncation only
+       * sets coeff::nmx() and coeff::mmx() and does not reduce the memory
+       * referenced.
+       **********************************************************************/
+      static coeff mapcoeffs(const char* data, size_t size, size_t& pos,
+                             int& N, int& M, bool truncate = false);
     };
 
     /**
@@ -313,6 +472,129 @@ namespace GeographicLib {
                               real x, real y, real z, real a,
                               real& gradx, real& grady, real& gradz);
 
+    /**
+     * Evaluate a spherical harmonic sum and its gradient using several
+     * threads.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] gradx the \e x component of the gradient.
+     * @param[out] grady the \e y component of the gradient.
+     * @param[out] gradz the \e z component of the gradient.
+     * @param[in] nthreads the maximum number of threads to use.
+     * @exception std::system_error if a thread can't be created.
+     * @result the spherical harmonic sum.
+     *
+     * The orders \e m are divided into \e nthreads ranges with equal
+     * numbers of terms.  Each thread evaluates the inner sums for its range
+     * and sums over \e m down to 0 with the inner sums for lower orders set
+     * to zero.  Because the Clenshaw sum is linear in the inner sums, adding
+     * the results of the threads gives the full sum (the result differs from
+     * that of the single-threaded version only by roundoff).  Fewer threads
+     * are used if the sum is too small to benefit (fewer than about 20000
+     * terms per thread); in particular, with \e nthreads = 1 this is the same
+     * as the previous function.  If Math::reproducible, one thread is
+     * always used so that the result doesn't depend on \e nthreads.
+     * SphericalEngine::RootTable should have been called beforehand (this is
+     * done by the constructors of SphericalHarmonic, etc.).
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static Math::real Value(const coeff c[], const real f[],
+                              real x, real y, real z, real a,
+                              real& gradx, real& grady, real& gradz,
+                              int nthreads);
+
+    /**
+     * Evaluate a spherical harmonic sum and its gradient at many points.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] num the number of points.
+     * @param[in] x array of the \e x components of the cartesian positions.
+     * @param[in] y array of the \e y components of the cartesian positions.
+     * @param[in] z array of the \e z components of the cartesian positions.
+     * @param[in] a the normalizing radius.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * This gives the same results as calling SphericalEngine::Value for each
+     * point (aside from roundoff).  The gradient arrays are not referenced
+     * (and may be null) if \e gradp is false.  The points are processed in
+     * groups of 2, 4, or 8 (depending on the SIMD capabilities of the target
+     * machine).  The coefficients and the recurrence factors are loaded once
+     * for each group and the arithmetic for the points in a group is written
+     * so that the compiler can vectorize it.  This function never throws an
+     * exception.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Values(const coeff c[], const real f[], size_t num,
+                         const real x[], const real y[], const real z[],
+                         real a, real v[],
+                         real gradx[], real grady[], real gradz[]);
+
+    /**
+     * Evaluate a spherical harmonic sum, its gradient, and its Hessian.
+     *
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] x the \e x component of the cartesian position.
+     * @param[in] y the \e y component of the cartesian position.
+     * @param[in] z the \e z component of the cartesian position.
+     * @param[in] a the normalizing radius.
+     * @param[out] gradx the \e x component of the gradient.
+     * @param[out] grady the \e y component of the gradient.
+     * @param[out] gradz the \e z component of the gradient.
+     * @param[out] hess the 6 independent components of the Hessian (the
+     *   matrix of second derivatives) in the order \e xx, \e xy, \e xz, \e
+     *   yy, \e yz, \e zz.
+     * @result the spherical harmonic sum.
+     *
+     * This is the same as SphericalEngine::Value with \e gradp = true,
+     * except that the sums for the second derivatives are accumulated in the
+     * same Clenshaw summation.  This costs about 30% more than evaluating
+     * the gradient (instead of the 6 or more additional evaluations needed
+     * to find the Hessian by finite differences).  This function never
+     * throws an exception.
+     **********************************************************************/
+    template<normalization norm, int L>
+      static Math::real Hessian(const coeff c[], const real f[],
+                                real x, real y, real z, real a,
+                                real& gradx, real& grady, real& gradz,
+                                real hess[]);
+
+  private:
+    // The minimum number of terms evaluated by each thread in Value
+    static const long long minwork_ = 20000;
+    // Contribution of orders m0 thru m1 to the sum; if hessp, also set the 6
+    // components of the Hessian
+    template<bool gradp, normalization norm, int L, bool hessp = false>
+      static real ValueRange(const coeff c[], const real f[],
+                             real x, real y, real z, real a, int m0, int m1,
+                             real& gradx, real& grady, real& gradz,
+                             real hess[] = nullptr);
+    // Set the inner sums for orders m0 thru m1 in circ; q = a/r and t and u
+    // are the cosine and sine of the colatitude.
+    template<bool gradp, normalization norm, int L>
+      static void CircleRange(const coeff c[], const real f[],
+                              real q, real t, real u, int m0, int m1,
+                              CircularEngine& circ);
+
+  public:
+
     /**
      * Create a CircularEngine object
      *
@@ -339,6 +621,64 @@ namespace GeographicLib {
     template<bool gradp, normalization norm, int L>
       static CircularEngine Circle(const coeff c[], const real f[],
                                    real p, real z, real a);
+
+    /**
+     * Create a CircularEngine object using several threads.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] p the radius of the circle.
+     * @param[in] z the height of the circle.
+     * @param[in] a the normalizing radius.
+     * @param[in] nthreads the maximum number of threads to use.
+     * @exception std::bad_alloc if the memory for the CircularEngine can't be
+     *   allocated.
+     * @exception std::system_error if a thread can't be created.
+     * @result the CircularEngine object.
+     *
+     * The inner sums for the orders \e m are independent; so the orders are
+     * divided into \e nthreads ranges with equal numbers of terms (as in the
+     * threaded version of SphericalEngine::Value) and each thread computes
+     * the sums for its range.  The result is identical to that of the
+     * previous function for any \e nthreads (so this is done even if
+     * Math::reproducible).  Fewer threads are used if the sum is too small
+     * to benefit.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static CircularEngine Circle(const coeff c[], const real f[],
+                                   real p, real z, real a, int nthreads);
+
+    /**
+     * Create CircularEngine objects for many circles.
+     *
+     * @tparam gradp should the gradient be calculated.
+     * @tparam norm the normalization for the associated Legendre polynomials.
+     * @tparam L the number of terms in the coefficients.
+     * @param[in] c an array of coeff objects.
+     * @param[in] f array of coefficient multipliers.  f[0] should be 1.
+     * @param[in] num the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles.
+     * @param[in] a the normalizing radius.
+     * @param[out] circ array of the CircularEngine objects.
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * This gives the same results as calling SphericalEngine::Circle for
+     * each circle (aside from roundoff).  As with SphericalEngine::Values,
+     * the circles are processed in groups so that the coefficients are
+     * loaded once for each group and the arithmetic can be vectorized.
+     * Since the <i>O</i>(<i>N</i><sup>2</sup>) construction of the circles
+     * usually dominates the cost of evaluating a grid, this provides a
+     * useful speed up for SphericalHarmonic::Circles and GravityModel::Grid.
+     **********************************************************************/
+    template<bool gradp, normalization norm, int L>
+      static void Circles(const coeff c[], const real f[], size_t num,
+                          const real p[], const real z[], real a,
+                          CircularEngine circ[]);
     /**
      * Check that the static table of square roots is big enough and enlarge it
      * if necessary.
@@ -348,12 +688,14 @@ namespace GeographicLib {
      *   be allocated.
      *
      * Typically, there's no need for an end-user to call this routine, because
-     * the constructors for SphericalEngine::coeff do so.  However, since this
-     * updates a static table, there's a possible race condition in a
-     * multi-threaded environment.  Because this routine does nothing if the
-     * table is already large enough, one way to avoid race conditions is to
-     * call this routine at program start up (when it's still single threaded),
-     * supplying the largest degree that your program will use.  E.g., \code
+     * the constructors for SphericalEngine::coeff do so.  This routine is
+     * thread safe: the table is enlarged by publishing a larger copy
+     * atomically and the old copies are retained, so that SphericalEngine
+     * may be used in other threads while models of different degrees are
+     * being constructed.  Reading the table requires no lock.  Calling this
+     * routine at program start up, with the largest degree that your program
+     * will use, avoids the (small) cost of enlarging the table later.  E.g.,
+     * \code
      GeographicLib::SphericalEngine::RootTable(2190);
      \endcode
      * suffices to accommodate extant magnetic and gravity models.
@@ -369,10 +711,63 @@ namespace GeographicLib {
      * \warning It's safest not to call this routine at all.  (The space used
      * by the table is modest.)
      **********************************************************************/
-    static void ClearRootTable() {
-      std::vector<real> temp(0);
-      sqrttable().swap(temp);
-    }
+    static void ClearRootTable();
+
+    /**
+     * @return the memory used by the tables of square roots (bytes).
+     *
+     * This includes the smaller copies which are retained when the table is
+     * enlarged by RootTable.
+     **********************************************************************/
+    static size_t RootTableBytes();
+
+    /**
+     * Precompute the coefficients of the Legendre recursion used to
+     * construct circles.
+     *
+     * @param[in] N the maximum degree.
+     * @param[in] norm the normalization.
+     * @exception GeographicErr if \e norm is not supported.
+     * @exception std::bad_alloc if the memory for the table can't be
+     *   allocated.
+     *
+     * The Clenshaw summation for each term of a CircularEngine needs two
+     * coefficients for each degree \e n and order \e m; these depend only
+     * on \e n, \e m, and the normalization and take two divisions to
+     * compute from the table of square roots.  This routine stores them in
+     * a table for all degrees up to \e N.  SphericalEngine::Circle and
+     * SphericalEngine::Circles then use the table for all sums with
+     * normalization \e norm and maximum degree at most \e N.  Thus the
+     * table is shared between models, e.g., calling
+     * \code
+     GeographicLib::SphericalEngine::LegendreTable
+       (2190, GeographicLib::SphericalEngine::FULL);
+     GeographicLib::SphericalEngine::LegendreTable
+       (720, GeographicLib::SphericalEngine::SCHMIDT);
+     \endcode
+     * speeds up GravityModel::Circle (and GravityModel::Grid) and
+     * MagneticModel::Circle for all the models whose degrees don't exceed
+     * these limits.  The results are unchanged.  The table holds
+     * (\e N + 1)(\e N + 2) reals, i.e., the same number as the coefficients
+     * of a model of degree \e N, which is 38 MB for \e N = 2190 (with
+     * doubles).  So it's not built unless this routine is called.  The table
+     * is published and replaced in the same way as the table of square roots
+     * (see SphericalEngine::RootTable); so this routine is thread safe.
+     **********************************************************************/
+    static void LegendreTable(int N, normalization norm);
+
+    /**
+     * Clear the tables set by SphericalEngine::LegendreTable and release the
+     * memory.  This must not be called while another thread is constructing
+     * a circle.
+     **********************************************************************/
+    static void ClearLegendreTables();
+
+    /**
+     * @return the memory used by the tables set by
+     *   SphericalEngine::LegendreTable (bytes).
+     **********************************************************************/
+    static size_t LegendreTableBytes();
   };
 
 } // namespace GeographicLib
@@ -125,6 +125,7 @@ namespace GeographicLib {
     SphericalEngine::coeff _c[1];
     real _a;
     unsigned _norm;
+    int _nthreads;
 
   public:
     /**
@@ -171,6 +172,7 @@ namespace GeographicLib {
                       int N, real a, unsigned norm = FULL)
       : _a(a)
       , _norm(norm)
+      , _nthreads(1)
     { _c[0] = SphericalEngine::coeff(C, S, N); }
 
     /**
@@ -203,14 +205,37 @@ namespace GeographicLib {
                       real a, unsigned norm = FULL)
       : _a(a)
       , _norm(norm)
+      , _nthreads(1)
     { _c[0] = SphericalEngine::coeff(C, S, N, nmx, mmx); }
 
+    /**
+     * Constructor with the coefficients given by a SphericalEngine::coeff
+     * object.
+     *
+     * @param[in] c the coefficients.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic::FULL (the default) or
+     *   SphericalHarmonic::SCHMIDT.
+     *
+     * This allows the coefficients to be stored as floats; see
+     * SphericalEngine::coeff.  The arrays referenced by \e c should not be
+     * altered or destroyed during the lifetime of a SphericalHarmonic object.
+     **********************************************************************/
+    SphericalHarmonic(const SphericalEngine::coeff& c,
+                      real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm)
+      , _nthreads(1)
+    { _c[0] = c; }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
      * then be reset with the default copy assignment operator.
      **********************************************************************/
-    SphericalHarmonic() {}
+    SphericalHarmonic() : _nthreads(1) {}
 
     /**
      * Compute the spherical harmonic sum.
@@ -230,12 +255,12 @@ namespace GeographicLib {
       switch (_norm) {
       case FULL:
         v = SphericalEngine::Value<false, SphericalEngine::FULL, 1>
-          (_c, f, x, y, z, _a, dummy, dummy, dummy);
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         v = SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
-          (_c, f, x, y, z, _a, dummy, dummy, dummy);
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, _nthreads);
         break;
       }
       return v;
@@ -264,17 +289,101 @@ namespace GeographicLib {
       switch (_norm) {
       case FULL:
         v = SphericalEngine::Value<true, SphericalEngine::FULL, 1>
-          (_c, f, x, y, z, _a, gradx, grady, gradz);
+          (_c, f, x, y, z, _a, gradx, grady, gradz, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         v = SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
-          (_c, f, x, y, z, _a, gradx, grady, gradz);
+          (_c, f, x, y, z, _a, gradx, grady, gradz, _nthreads);
         break;
       }
       return v;
     }
 
+    /**
+     * Compute a spherical harmonic sum, its gradient, and its Hessian.
+     *
+     * @param[in] x cartesian coordinate.
+     * @param[in] y cartesian coordinate.
+     * @param[in] z cartesian coordinate.
+     * @param[out] gradx \e x component of the gradient
+     * @param[out] grady \e y component of the gradient
+     * @param[out] gradz \e z component of the gradient
+     * @param[out] hess the 6 independent components of the Hessian in the
+     *   order \e xx, \e xy, \e xz, \e yy, \e yz, \e zz.
+     * @return \e V the spherical harmonic sum.
+     *
+     * This is the same as the previous function, except that the second
+     * derivatives of the sum are computed as well; see
+     * SphericalEngine::Hessian.  SphericalHarmonic::SetThreads has no effect
+     * on this function.  This routine requires constant memory and thus
+     * never throws an exception.
+     **********************************************************************/
+    Math::real Hessian(real x, real y, real z,
+                       real& gradx, real& grady, real& gradz,
+                       real hess[]) const {
+      real f[] = {1};
+      real v = 0;
+      switch (_norm) {
+      case FULL:
+        v = SphericalEngine::Hessian<SphericalEngine::FULL, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        v = SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 1>
+          (_c, f, x, y, z, _a, gradx, grady, gradz, hess);
+        break;
+      }
+      return v;
+    }
+
+    /**
+     * Compute the spherical harmonic sum and optionally its gradient at many
+     * points.
+     *
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * The gradients are computed only if \e gradx is not null, in which case
+     * \e grady and \e gradz must also be non-null.  This gives the same
+     * results as calling operator()() for each point (aside from roundoff)
+     * at a lower cost per point because several points are processed
+     * together; see SphericalEngine::Values.  SphericalHarmonic::SetThreads
+     * has no effect on this function.  This routine never throws an
+     * exception.
+     **********************************************************************/
+    void Values(size_t n, const real x[], const real y[], const real z[],
+                real v[], real gradx[] = nullptr, real grady[] = nullptr,
+                real gradz[] = nullptr) const {
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        if (gradx)
+          SphericalEngine::Values<true, SphericalEngine::FULL, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::Values<false, SphericalEngine::FULL, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradx)
+          SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude.
@@ -331,21 +440,85 @@ namespace GeographicLib {
       case FULL:
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, _nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, _nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, _nthreads);
         break;
       }
     }
 
+    /**
+     * Create CircularEngine objects for many circles of latitude.
+     *
+     * @param[in] n the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles above the equatorial
+     *   plane.
+     * @param[in] gradp if true the returned objects will be able to compute
+     *   the gradient of the sum.
+     * @param[out] circ array of the \e n CircularEngine objects.
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * This gives the same results as calling SphericalHarmonic::Circle for each
+     * circle (aside from roundoff) at a lower cost per circle because
+     * several circles are processed together; see SphericalEngine::Circles.
+     **********************************************************************/
+    void Circles(size_t n, const real p[], const real z[], bool gradp,
+                 CircularEngine circ[]) const {
+      if (n == 1) {
+        // A single circle can use several threads
+        circ[0] = Circle(p[0], z[0], gradp);
+        return;
+      }
+      real f[] = {1};
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::FULL, 1>
+            (_c, f, n, p, z, _a, circ);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::FULL, 1>
+            (_c, f, n, p, z, _a, circ);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, p, z, _a, circ);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 1>
+            (_c, f, n, p, z, _a, circ);
+        break;
+      }
+    }
+
+    /**
+     * Set the number of threads used to evaluate the sum.
+     *
+     * @param[in] nthreads the number of threads (default 1).
+     *
+     * With \e nthreads &gt; 1, operator()() divides the orders \e m of the
+     * sum among up to \e nthreads threads; see SphericalEngine::Value.  This
+     * reduces the latency of a single evaluation of a high-degree sum.
+     * Circle (and Circles for a single circle) also divides the orders among
+     * the threads; see SphericalEngine::Circle.
+     **********************************************************************/
+    void SetThreads(int nthreads) { _nthreads = (std::max)(1, nthreads); }
+
+    /**
+     * @return the number of threads used to evaluate the sum.
+     **********************************************************************/
+    int Threads() const { return _nthreads; }
+
     /**
      * @return the zeroth SphericalEngine::coeff object.
      **********************************************************************/
@@ -56,6 +56,7 @@ namespace GeographicLib {
     SphericalEngine::coeff _c[2];
     real _a;
     unsigned _norm;
+    int _nthreads;
 
   public:
     /**
@@ -93,7 +94,8 @@ namespace GeographicLib {
                        int N1,
                        real a, unsigned norm = FULL)
       : _a(a)
-      , _norm(norm) {
+      , _norm(norm)
+      , _nthreads(1) {
       if (!(N1 <= N))
         throw GeographicErr("N1 cannot be larger that N");
       _c[0] = SphericalEngine::coeff(C, S, N);
@@ -139,7 +141,8 @@ namespace GeographicLib {
                        int N1, int nmx1, int mmx1,
                        real a, unsigned norm = FULL)
       : _a(a)
-      , _norm(norm) {
+      , _norm(norm)
+      , _nthreads(1) {
       if (!(nmx1 <= nmx))
         throw GeographicErr("nmx1 cannot be larger that nmx");
       if (!(mmx1 <= mmx))
@@ -148,12 +151,47 @@ namespace GeographicLib {
       _c[1] = SphericalEngine::coeff(C1, S1, N1, nmx1, mmx1);
     }
 
+    /**
+     * Constructor with the coefficients given by SphericalEngine::coeff
+     * objects.
+     *
+     * @param[in] c the coefficients <i>C</i><sub><i>nm</i></sub> and
+     *   <i>S</i><sub><i>nm</i></sub>.
+     * @param[in] c1 the coefficients <i>C'</i><sub><i>nm</i></sub> and
+     *   <i>S'</i><sub><i>nm</i></sub>.
+     * @param[in] a the reference radius appearing in the definition of the
+     *   sum.
+     * @param[in] norm the normalization for the associated Legendre
+     *   polynomials, either SphericalHarmonic1::FULL (the default) or
+     *   SphericalHarmonic1::SCHMIDT.
+     * @exception GeographicErr if the maximum degree or order of \e c1
+     *   exceeds that of \e c.
+     *
+     * This allows the coefficients to be stored as floats; see
+     * SphericalEngine::coeff.  The arrays referenced by \e c and \e c1 should
+     * not be altered or destroyed during the lifetime of a SphericalHarmonic1
+     * object.
+     **********************************************************************/
+    SphericalHarmonic1(const SphericalEngine::coeff& c,
+                       const SphericalEngine::coeff& c1,
+                       real a, unsigned norm = FULL)
+      : _a(a)
+      , _norm(norm)
+      , _nthreads(1) {
+      if (!(c1.nmx() <= c.nmx()))
+        throw GeographicErr("nmx1 cannot be larger that nmx");
+      if (!(c1.mmx() <= c.mmx()))
+        throw GeographicErr("mmx1 cannot be larger that mmx");
+      _c[0] = c;
+      _c[1] = c1;
+    }
+
     /**
      * A default constructor so that the object can be created when the
      * constructor for another object is initialized.  This default object can
      * then be reset with the default copy assignment operator.
      **********************************************************************/
-    SphericalHarmonic1() {}
+    SphericalHarmonic1() : _nthreads(1) {}
 
     /**
      * Compute a spherical harmonic sum with a correction term.
@@ -174,12 +212,12 @@ namespace GeographicLib {
       switch (_norm) {
       case FULL:
         v = SphericalEngine::Value<false, SphericalEngine::FULL, 2>
-          (_c, f, x, y, z, _a, dummy, dummy, dummy);
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         v = SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 2>
-          (_c, f, x, y, z, _a, dummy, dummy, dummy);
+          (_c, f, x, y, z, _a, dummy, dummy, dummy, _nthreads);
         break;
       }
       return v;
@@ -210,17 +248,66 @@ namespace GeographicLib {
       switch (_norm) {
       case FULL:
         v = SphericalEngine::Value<true, SphericalEngine::FULL, 2>
-          (_c, f, x, y, z, _a, gradx, grady, gradz);
+          (_c, f, x, y, z, _a, gradx, grady, gradz, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         v = SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
-          (_c, f, x, y, z, _a, gradx, grady, gradz);
+          (_c, f, x, y, z, _a, gradx, grady, gradz, _nthreads);
         break;
       }
       return v;
     }
 
+    /**
+     * Compute the spherical harmonic sum and optionally its gradient at many
+     * points.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] n the number of points.
+     * @param[in] x array of cartesian coordinates.
+     * @param[in] y array of cartesian coordinates.
+     * @param[in] z array of cartesian coordinates.
+     * @param[out] v array of the spherical harmonic sums.
+     * @param[out] gradx array of the \e x components of the gradients.
+     * @param[out] grady array of the \e y components of the gradients.
+     * @param[out] gradz array of the \e z components of the gradients.
+     *
+     * The gradients are computed only if \e gradx is not null, in which case
+     * \e grady and \e gradz must also be non-null.  This gives the same
+     * results as calling operator()() for each point (aside from roundoff)
+     * at a lower cost per point because several points are processed
+     * together; see SphericalEngine::Values.  The two coefficient sets are
+     * combined as they are loaded, so the cost is little more than for
+     * SphericalHarmonic::Values.  SphericalHarmonic1::SetThreads has no
+     * effect on this function.  This routine never throws an exception.
+     **********************************************************************/
+    void Values(real tau, size_t n,
+                const real x[], const real y[], const real z[],
+                real v[], real gradx[] = nullptr, real grady[] = nullptr,
+                real gradz[] = nullptr) const {
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        if (gradx)
+          SphericalEngine::Values<true, SphericalEngine::FULL, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::Values<false, SphericalEngine::FULL, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradx)
+          SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        else
+          SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, x, y, z, _a, v, gradx, grady, gradz);
+        break;
+      }
+    }
+
     /**
      * Create a CircularEngine to allow the efficient evaluation of several
      * points on a circle of latitude at a fixed value of \e tau.
@@ -251,21 +338,86 @@ namespace GeographicLib {
       case FULL:
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, _nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, _nthreads);
         break;
       case SCHMIDT:
       default:                  // To avoid compiler warnings
         return gradp ?
           SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a) :
+          (_c, f, p, z, _a, _nthreads) :
           SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
-          (_c, f, p, z, _a);
+          (_c, f, p, z, _a, _nthreads);
         break;
       }
     }
 
+    /**
+     * Create CircularEngine objects for many circles of latitude.
+     *
+     * @param[in] tau multiplier for correction coefficients \e C' and \e S'.
+     * @param[in] n the number of circles.
+     * @param[in] p array of the radii of the circles.
+     * @param[in] z array of the heights of the circles above the equatorial
+     *   plane.
+     * @param[in] gradp if true the returned objects will be able to compute
+     *   the gradient of the sum.
+     * @param[out] circ array of the \e n CircularEngine objects.
+     * @exception std::bad_alloc if the memory for the CircularEngine objects
+     *   can't be allocated.
+     *
+     * This gives the same results as calling SphericalHarmonic1::Circle for
+     * each circle (aside from roundoff) at a lower cost per circle because
+     * several circles are processed together; see SphericalEngine::Circles.
+     **********************************************************************/
+    void Circles(real tau, size_t n, const real p[], const real z[], bool gradp,
+                 CircularEngine circ[]) const {
+      if (n == 1) {
+        // A single circle can use several threads
+        circ[0] = Circle(tau, p[0], z[0], gradp);
+        return;
+      }
+      real f[] = {1, tau};
+      switch (_norm) {
+      case FULL:
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::FULL, 2>
+            (_c, f, n, p, z, _a, circ);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::FULL, 2>
+            (_c, f, n, p, z, _a, circ);
+        break;
+      case SCHMIDT:
+      default:                  // To avoid compiler warnings
+        if (gradp)
+          SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, p, z, _a, circ);
+        else
+          SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 2>
+            (_c, f, n, p, z, _a, circ);
+        break;
+      }
+    }
+
+    /**
+     * Set the number of threads used to evaluate the sum.
+     *
+     * @param[in] nthreads the number of threads (default 1).
+     *
+     * With \e nthreads &gt; 1, operator()() divides the orders \e m of the
+     * sum among up to \e nthreads threads; see SphericalEngine::Value.  This
+     * reduces the latency of a single evaluation of a high-degree sum.
+     * Circle (and Circles for a single circle) also divides the orders among
+     * the threads; see SphericalEngine::Circle.
+     **********************************************************************/
+    void SetThreads(int nthreads) { _nthreads = (std::max)(1, nthreads); }
+
+    /**
+     * @return the number of threads used to evaluate the sum.
+     **********************************************************************/
+    int Threads() const { return _nthreads; }
+
     /**
      * @return the zeroth SphericalEngine::coeff object.
      **********************************************************************/
@@ -0,0 +1,124 @@
+/**
+ * \file StridedArray.hpp
+ * \brief Header for GeographicLib::StridedArray class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_STRIDEDARRAY_HPP)
+#define GEOGRAPHICLIB_STRIDEDARRAY_HPP 1
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <GeographicLib/Constants.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief A view of an array whose elements are a fixed number of bytes
+   *   apart
+   *
+   * The batch functions of Geodesic, GeodesicExact, Geoid, Geocentric,
+   * LocalCartesian, UTMUPS, and TransverseMercator have overloads which
+   * accept StridedArray arguments in place of the arrays.  This allows the
+   * fields of an array of records (e.g., the points of a point cloud) to be
+   * read and written in place without first copying them into separate
+   * arrays.  The stride is given in bytes and may be negative.  A
+   * StridedArray constructed from a pointer has a stride of sizeof(\e T),
+   * and one constructed from nullptr is null; the batch functions don't
+   * reference null optional outputs.  The elements are accessed in place,
+   * so the pointer and the stride must be multiples of alignof(\e T); this
+   * is the case for the fields of an ordinary (i.e., not packed) struct.
+   * The fields of packed records must be copied to separate arrays first.
+   *
+   * @tparam T the type of the elements; this is const for inputs.
+   *
+   * Example of use:
+   * \include example-StridedArray.cpp
+   **********************************************************************/
+  template<typename T>
+  class StridedArray {
+  private:
+    typedef typename std::conditional<std::is_const<T>::value,
+                                      const char, char>::type byte;
+    byte* _p;
+    std::ptrdiff_t _stride;
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param[in] p a pointer to the first element (default null).
+     * @param[in] stride the number of bytes from one element to the next
+     *   (default sizeof(\e T)).
+     * @exception GeographicErr if \e p or \e stride is not a multiple of
+     *   alignof(\e T).
+     **********************************************************************/
+    StridedArray(T* p = nullptr, std::ptrdiff_t stride = sizeof(T))
+      : _p(reinterpret_cast<byte*>(p))
+      , _stride(stride)
+    {
+      if (reinterpret_cast<std::uintptr_t>(p) % alignof(T) != 0 ||
+          stride % std::ptrdiff_t(alignof(T)) != 0)
+        throw GeographicErr("StridedArray: misaligned pointer or stride");
+    }
+
+    /**
+     * Constructor for a null array.
+     **********************************************************************/
+    StridedArray(std::nullptr_t)
+      : _p(nullptr)
+      , _stride(sizeof(T))
+    {}
+
+    /**
+     * Conversion of a view of non-const elements to one of const elements.
+     *
+     * @tparam U the non-const element type.
+     * @param[in] a the view.
+     **********************************************************************/
+    template<typename U,
+             typename = typename std::enable_if
+             <std::is_same<const U, T>::value &&
+              !std::is_same<U, T>::value>::type>
+    StridedArray(const StridedArray<U>& a)
+      : _p(reinterpret_cast<byte*>(a.data()))
+      , _stride(a.stride())
+    {}
+
+    /**
+     * @param[in] i the index.
+     * @return a reference to element \e i.
+     **********************************************************************/
+    T& operator[](size_t i) const
+    { return *reinterpret_cast<T*>(_p + std::ptrdiff_t(i) * _stride); }
+
+    /**
+     * @param[in] i the index.
+     * @return the view starting at element \e i.
+     **********************************************************************/
+    StridedArray operator+(size_t i) const
+    { return _p ? StridedArray(&(*this)[i], _stride) : *this; }
+
+    /**
+     * @return a pointer to the first element.
+     **********************************************************************/
+    T* data() const { return reinterpret_cast<T*>(_p); }
+
+    /**
+     * @return the number of bytes from one element to the next.
+     **********************************************************************/
+    std::ptrdiff_t stride() const { return _stride; }
+
+    /**
+     * @return true if the view is not null.
+     **********************************************************************/
+    explicit operator bool() const { return _p != nullptr; }
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_STRIDEDARRAY_HPP
@@ -0,0 +1,147 @@
+/**
+ * \file TrackStatistics.hpp
+ * \brief Header for GeographicLib::TrackStatistics class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TRACKSTATISTICS_HPP)
+#define GEOGRAPHICLIB_TRACKSTATISTICS_HPP 1
+
+#include <GeographicLib/Constants.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Accumulator.hpp>
+
+namespace GeographicLib {
+
+  /**
+   * \brief Streaming statistics of a geodesic track
+   *
+   * This class consumes the vertices of a track, e.g., GPS fixes, in chunks
+   * of arbitrary size and accumulates the length of the track (whose
+   * segments are geodesics), its duration, and its maximum speed.
+   * Optionally, it returns the length, azimuth, and speed of each segment.
+   * This is intended for summarizing large volumes of telemetry where
+   * PolygonAreaT (with \e polyline = true) would be fed one point at a time.
+   *
+   * The segments of a chunk are divided into blocks of 16384 segments which
+   * are solved with Geodesic::InverseBatch; the blocks may be handed out to
+   * several threads.  The length of each block is accumulated in its own
+   * Accumulator and these partial sums are added in order; thus the results
+   * do not depend on the number of threads.  The segment joining the last
+   * vertex of one chunk to the first vertex of the next is included, so
+   * that (apart from roundoff in the accumulated length) the results do not
+   * depend on how the track is split into chunks.  If the library was built
+   * to give reproducible results (Math::reproducible), the segment lengths
+   * are added one at a time in order and the length is then identical to
+   * that obtained by adding the vertices one at a time.
+   *
+   * Example of use:
+   * \include example-TrackStatistics.cpp
+   **********************************************************************/
+
+  class GEOGRAPHICLIB_EXPORT TrackStatistics {
+  private:
+    typedef Math::real real;
+    // The number of segments in a block
+    static const size_t nb_ = 16384;
+    Geodesic _geod;
+    size_t _num;
+    real _lat1, _lon1, _time1, _time0, _maxspeed;
+    Accumulator<> _length;
+  public:
+
+    /**
+     * Constructor for TrackStatistics.
+     *
+     * @param[in] geod the Geodesic object to use for geodesic calculations.
+     **********************************************************************/
+    explicit TrackStatistics(const Geodesic& geod)
+      : _geod(geod)
+    { Clear(); }
+
+    /**
+     * Clear the track, allowing a new track to be started.
+     **********************************************************************/
+    void Clear() {
+      _num = 0;
+      _lat1 = _lon1 = _time1 = _time0 = _maxspeed = Math::NaN();
+      _length = 0;
+    }
+
+    /**
+     * Add a chunk of vertices to the track.
+     *
+     * @param[in] n the number of vertices.
+     * @param[in] lat an array of \e n latitudes (degrees).
+     * @param[in] lon an array of \e n longitudes (degrees).
+     * @param[in] time an optional array of \e n times (seconds).
+     * @param[out] s12 an optional array of \e n segment lengths (meters).
+     * @param[out] azi an optional array of \e n segment azimuths (degrees).
+     * @param[out] speed an optional array of \e n segment speeds
+     *   (meters/second).
+     * @param[in] nthreads the number of threads to use (default 1).
+     * @exception std::bad_alloc if the temporary arrays can't be allocated.
+     *
+     * Element \e i of the output arrays refers to the segment ending at
+     * vertex \e i; for \e i = 0 this is the segment from the last vertex
+     * of the previous chunk.  \e azi is the azimuth at the start of the
+     * segment.  The first vertex of the track has no segment; for it \e s12
+     * = 0 and \e azi and \e speed are NaN.  The speed is NaN if \e time is
+     * null or if the time difference is not positive.  The arrays \e time,
+     * \e s12, \e azi, and \e speed may be null.  If \e nthreads > 1, the
+     * blocks are handed out to that many tasks which are run with
+     * Executor::Batch.
+     **********************************************************************/
+    void Add(size_t n, const real lat[], const real lon[],
+             const real time[] = nullptr,
+             real s12[] = nullptr, real azi[] = nullptr,
+             real speed[] = nullptr, int nthreads = 1);
+
+    /**
+     * Add a vertex to the track.
+     *
+     * @param[in] lat the latitude (degrees).
+     * @param[in] lon the longitude (degrees).
+     * @param[in] time the time (seconds); default NaN.
+     **********************************************************************/
+    void AddPoint(real lat, real lon, real time = Math::NaN())
+    { Add(1, &lat, &lon, &time); }
+
+    /** \name Inspector functions
+     **********************************************************************/
+    ///@{
+    /**
+     * @return the number of vertices added.
+     **********************************************************************/
+    size_t Count() const { return _num; }
+
+    /**
+     * @return the length of the track (meters).
+     **********************************************************************/
+    Math::real Length() const { return _length(); }
+
+    /**
+     * @return the difference between the times of the last and first
+     *   vertices (seconds); this is NaN if either time is missing.
+     **********************************************************************/
+    Math::real Duration() const { return _time1 - _time0; }
+
+    /**
+     * @return the maximum speed over the segments (meters/second); this is
+     *   NaN if no speed has been computed.
+     **********************************************************************/
+    Math::real MaxSpeed() const { return _maxspeed; }
+
+    /**
+     * @return the mean speed, Length() / Duration() (meters/second).
+     **********************************************************************/
+    Math::real MeanSpeed() const { return Length() / Duration(); }
+    ///@}
+  };
+
+} // namespace GeographicLib
+
+#endif  // GEOGRAPHICLIB_TRACKSTATISTICS_HPP
@@ -12,6 +12,7 @@
 
 #include <GeographicLib/Constants.hpp>
 #include <GeographicLib/EllipticFunction.hpp>
+#include <GeographicLib/StridedArray.hpp>
 
 namespace GeographicLib {
 
@@ -93,6 +94,14 @@ namespace GeographicLib {
     real _a, _f, _k0, _mu, _mv, _e;
     bool _extendp;
     EllipticFunction _eEu, _eEv;
+    // Fourier series giving the starting guesses for zetainv and sigmainv
+    // in the region near the central meridian, see SeriesInit.  Element [0]
+    // is unused.
+    static const int nser_ = 8;
+    bool _serp;
+    real _serlim, _zetc[nser_ + 1], _sigc[nser_ + 1];
+    void SeriesInit();
+    static void SinSeries(const real c[], real x, real y, real& sx, real& sy);
 
     void zeta(real u, real snu, real cnu, real dnu,
               real v, real snv, real cnv, real dnv,
@@ -227,6 +236,102 @@ namespace GeographicLib {
       Reverse(lon0, x, y, lat, lon, gamma, k);
     }
 
+    /**
+     * Forward projection for many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to TransverseMercatorExact::Forward.  The
+     * elliptic function data (the complete integrals and the Landen sequence
+     * for the Jacobi elliptic functions), which depends only on the
+     * ellipsoid, is computed once in the constructor and is shared by all the
+     * points.
+     **********************************************************************/
+    void Forward(real lon0, size_t n, const real lat[], const real lon[],
+                 real x[], real y[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Reverse projection for many points.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     *
+     * Each array holds \e n elements.  The results are identical to those
+     * returned by \e n calls to TransverseMercatorExact::Reverse.
+     **********************************************************************/
+    void Reverse(real lon0, size_t n, const real x[], const real y[],
+                 real lat[], real lon[],
+                 real gamma[] = nullptr, real k[] = nullptr) const;
+
+    /**
+     * Forward projection for many points given strided arrays.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[out] x strided array of eastings of the points (meters).
+     * @param[out] y strided array of northings of the points (meters).
+     * @param[out] gamma strided array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k strided array of scales of projection at the points;
+     *   this may be null.
+     *
+     * This is the same as the previous version of
+     * TransverseMercatorExact::Forward except that the elements of each array
+     * are StridedArray::stride() bytes apart.  The outputs may overlay the
+     * inputs.
+     **********************************************************************/
+    void Forward(real lon0, size_t n, StridedArray<const real> lat,
+                 StridedArray<const real> lon,
+                 StridedArray<real> x, StridedArray<real> y,
+                 StridedArray<real> gamma = nullptr,
+                 StridedArray<real> k = nullptr) const;
+
+    /**
+     * Reverse projection for many points given strided arrays.
+     *
+     * @param[in] lon0 central meridian of the projection (degrees).
+     * @param[in] n the number of points.
+     * @param[in] x strided array of eastings of the points (meters).
+     * @param[in] y strided array of northings of the points (meters).
+     * @param[out] lat strided array of latitudes of the points (degrees).
+     * @param[out] lon strided array of longitudes of the points (degrees).
+     * @param[out] gamma strided array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k strided array of scales of projection at the points;
+     *   this may be null.
+     *
+     * This is the same as the previous version of
+     * TransverseMercatorExact::Reverse except that the elements of each array
+     * are StridedArray::stride() bytes apart.  The outputs may overlay the
+     * inputs.
+     **********************************************************************/
+    void Reverse(real lon0, size_t n, StridedArray<const real> x,
+                 StridedArray<const real> y,
+                 StridedArray<real> lat, StridedArray<real> lon,
+                 StridedArray<real> gamma = nullptr,
+                 StridedArray<real> k = nullptr) const;
+
     /** \name Inspector functions
      **********************************************************************/
     ///@{
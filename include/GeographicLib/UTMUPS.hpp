@@ -11,6 +11,7 @@
 #define GEOGRAPHICLIB_UTMUPS_HPP 1
 
 #include <GeographicLib/Constants.hpp>
+#include <GeographicLib/StridedArray.hpp>
 
 namespace GeographicLib {
 
@@ -93,6 +94,14 @@ namespace GeographicLib {
     // throwp = false, return bool instead.
     static bool CheckCoords(bool utmp, bool northp, real x, real y,
                             bool msgrlimits = false, bool throwp = true);
+    // Forward and Reverse for a single point; gamma and k may be null
+    static void ForwardPoint(real lat, real lon,
+                             int& zone, bool& northp, real& x, real& y,
+                             real* gamma, real* k,
+                             int setzone, bool mgrslimits);
+    static void ReversePoint(int zone, bool northp, real x, real y,
+                             real& lat, real& lon, real* gamma, real* k,
+                             bool mgrslimits);
     UTMUPS() = delete;          // Disable constructor
 
   public:
@@ -263,24 +272,129 @@ namespace GeographicLib {
                         real& lat, real& lon, real& gamma, real& k,
                         bool mgrslimits = false);
 
+    /**
+     * Forward projection for many points, from geographic to UTM/UPS.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat array of latitudes of the points (degrees).
+     * @param[in] lon array of longitudes of the points (degrees).
+     * @param[out] zone array of UTM zones (zero means UPS).
+     * @param[out] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[out] x array of eastings of the points (meters).
+     * @param[out] y array of northings of the points (meters).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if UTMUPS::Forward would throw an exception
+     *   for any of the points; in this case, the contents of the output
+     *   arrays are unspecified.
+     *
+     * Each array holds \e n elements and the results are identical to those
+     * returned by \e n calls to UTMUPS::Forward.  The points are sorted by
+     * zone and the points for each UTM zone are projected with the batch
+     * version of TransverseMercator::Forward before the results are put
+     * back into the original order.  If \e gamma and \e k are both null, the
+     * calculation of the convergence and scale for UTM is skipped.
+     **********************************************************************/
+    static void Forward(size_t n, const real lat[], const real lon[],
+                        int zone[], bool northp[], real x[], real y[],
+                        real gamma[] = nullptr, real k[] = nullptr,
+                        int setzone = STANDARD, bool mgrslimits = false);
+
+    /**
+     * Forward projection for many points given strided arrays.
+     *
+     * @param[in] n the number of points.
+     * @param[in] lat strided array of latitudes of the points (degrees).
+     * @param[in] lon strided array of longitudes of the points (degrees).
+     * @param[out] zone strided array of UTM zones (zero means UPS).
+     * @param[out] northp strided array of hemispheres (true means north,
+     *   false means south).
+     * @param[out] x strided array of eastings of the points (meters).
+     * @param[out] y strided array of northings of the points (meters).
+     * @param[out] gamma strided array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k strided array of scales of projection at the points;
+     *   this may be null.
+     * @param[in] setzone zone override (optional).
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if UTMUPS::Forward would throw an exception
+     *   for any of the points.
+     *
+     * This is the same as the previous function except that the elements of
+     * each array are StridedArray::stride() bytes apart.  The inputs are read
+     * more than once; so the outputs must not overlay them.
+     **********************************************************************/
+    static void Forward(size_t n, StridedArray<const real> lat,
+                        StridedArray<const real> lon,
+                        StridedArray<int> zone, StridedArray<bool> northp,
+                        StridedArray<real> x, StridedArray<real> y,
+                        StridedArray<real> gamma = nullptr,
+                        StridedArray<real> k = nullptr,
+                        int setzone = STANDARD, bool mgrslimits = false);
+
+    /**
+     * Reverse projection for many points, from UTM/UPS to geographic.
+     *
+     * @param[in] n the number of points.
+     * @param[in] zone array of UTM zones (zero means UPS).
+     * @param[in] northp array of hemispheres (true means north, false means
+     *   south).
+     * @param[in] x array of eastings of the points (meters).
+     * @param[in] y array of northings of the points (meters).
+     * @param[out] lat array of latitudes of the points (degrees).
+     * @param[out] lon array of longitudes of the points (degrees).
+     * @param[out] gamma array of meridian convergences at the points
+     *   (degrees); this may be null.
+     * @param[out] k array of scales of projection at the points; this may be
+     *   null.
+     * @param[in] mgrslimits if true enforce the stricter MGRS limits on the
+     *   coordinates (default = false).
+     * @exception GeographicErr if UTMUPS::Reverse would throw an exception
+     *   for any of the points; in this case, the contents of the output
+     *   arrays are unspecified.
+     *
+     * Each array holds \e n elements and the results are identical to those
+     * returned by \e n calls to UTMUPS::Reverse.  The points are sorted by
+     * zone and the points for each UTM zone are unprojected with the batch
+     * version of TransverseMercator::Reverse before the results are put
+     * back into the original order.  If \e gamma and \e k are both null,
+     * the calculation of the convergence and scale for UTM is skipped.  The
+     * inputs are read more than once; so the outputs must not overlay them.
+     **********************************************************************/
+    static void Reverse(size_t n, const int zone[], const bool northp[],
+                        const real x[], const real y[],
+                        real lat[], real lon[],
+                        real gamma[] = nullptr, real k[] = nullptr,
+                        bool mgrslimits = false);
+
     /**
      * UTMUPS::Forward without returning convergence and scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     static void Forward(real lat, real lon,
                         int& zone, bool& northp, real& x, real& y,
                         int setzone = STANDARD, bool mgrslimits = false) {
-      real gamma, k;
-      Forward(lat, lon, zone, northp, x, y, gamma, k, setzone, mgrslimits);
+      ForwardPoint(lat, lon, zone, northp, x, y, nullptr, nullptr,
+                   setzone, mgrslimits);
     }
 
     /**
      * UTMUPS::Reverse without returning convergence and scale.
+     * The parts of the calculation needed only for the convergence and scale
+     * are skipped.
      **********************************************************************/
     static void Reverse(int zone, bool northp, real x, real y,
-                        real& lat, real& lon, bool mgrslimits = false) {
-      real gamma, k;
-      Reverse(zone, northp, x, y, lat, lon, gamma, k, mgrslimits);
-    }
+                        real& lat, real& lon, bool mgrslimits = false)
+    { ReversePoint(zone, northp, x, y, lat, lon, nullptr, nullptr,
+                   mgrslimits); }
 
     /**
      * Transfer UTM/UPS coordinated from one zone to another.
@@ -319,6 +433,41 @@ namespace GeographicLib {
                          int zoneout, bool northpout, real& xout, real& yout,
                          int& zone);
 
+    /**
+     * Transfer many points to a single zone.
+     *
+     * @param[in] n the number of points.
+     * @param[in] zonein array of the UTM zones for \e xin and \e yin (or zero
+     *   for UPS).
+     * @param[in] northpin array of hemispheres for \e xin and \e yin.
+     * @param[in] xin array of eastings of the points (meters).
+     * @param[in] yin array of northings of the points (meters).
+     * @param[in] zoneout the requested UTM zone for \e xout and \e yout (or
+     *   zero for UPS).
+     * @param[in] northpout hemisphere for \e xout output and \e yout.
+     * @param[out] xout array of eastings of the points (meters).
+     * @param[out] yout array of northings of the points (meters).
+     * @param[out] zone array of the actual UTM zones for \e xout and \e yout.
+     * @exception GeographicErr if UTMUPS::Transfer would throw an exception
+     *   for any of the points; in this case, the contents of the output
+     *   arrays are unspecified.
+     *
+     * Each array holds \e n elements and the results are identical to those
+     * returned by \e n calls to UTMUPS::Transfer.  The points which go
+     * between two UTM zones (\e zoneout is a UTM zone or UTMUPS::MATCH) are
+     * sorted by \e zonein; the points for each input zone are converted with
+     * the batch versions of TransverseMercator::Reverse and
+     * TransverseMercator::Forward, with the fixed central meridians of the
+     * input and output zones, before the results are put back into the
+     * original order.  The others, including those already in \e zoneout,
+     * are handled by the scalar version.  (\e xout, \e yout) can be the same
+     * arrays as (\e xin, \e yin).
+     **********************************************************************/
+    static void Transfer(size_t n, const int zonein[], const bool northpin[],
+                         const real xin[], const real yin[],
+                         int zoneout, bool northpout,
+                         real xout[], real yout[], int zone[]);
+
     /**
      * Decode a UTM/UPS zone string.
      *
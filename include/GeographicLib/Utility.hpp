@@ -17,6 +17,7 @@
 #include <cctype>
 #include <ctime>
 #include <cstring>
+#include <type_traits>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions and unsafe gmtime
@@ -46,6 +47,49 @@ namespace GeographicLib {
     static bool gregorian(int s) {
       return s >= 639799;       // 1752-09-14
     }
+    // Fast conversions of plain decimal numbers bypassing the stream classes
+    // (and the allocation of temporary strings); these return false if the
+    // conversion needs to be handled by the general stream-based code.
+    static bool fastval(const std::string& s, float& x);
+    static bool fastval(const std::string& s, double& x);
+    static bool fastval(const std::string& s, long double& x);
+    template<typename T> static bool fastval(const std::string&, T&)
+    { return false; }
+    static bool faststr(double x, int p, std::string& s);
+    static bool faststr(long double x, int p, std::string& s);
+    // Swap the bytes of the elements of an array in place.  For 2- and 4-byte
+    // integers, the swaps are written with shifts so that the compiler can
+    // vectorize the loop.
+    template<typename T> static void swabarray(T array[], size_t num) {
+      swabarray(array, num,
+                std::integral_constant<int, std::is_integral<T>::value ?
+                int(sizeof(T)) : 0>());
+    }
+    template<typename T, int N>
+    static void swabarray(T array[], size_t num, std::integral_constant<int, N>)
+    {
+      for (size_t i = 0; i < num; ++i)
+        array[i] = Math::swab<T>(array[i]);
+    }
+    template<typename T>
+    static void swabarray(T array[], size_t num, std::integral_constant<int, 2>)
+    {
+      typedef typename std::make_unsigned<T>::type U;
+      for (size_t i = 0; i < num; ++i) {
+        U x = U(array[i]);
+        array[i] = T(U((x >> 8) | (x << 8)));
+      }
+    }
+    template<typename T>
+    static void swabarray(T array[], size_t num, std::integral_constant<int, 4>)
+    {
+      typedef typename std::make_unsigned<T>::type U;
+      for (size_t i = 0; i < num; ++i) {
+        U x = U(array[i]);
+        array[i] = T(U((x >> 24) | ((x >> 8) & U(0xff00U)) |
+                       ((x << 8) & U(0xff0000U)) | (x << 24)));
+      }
+    }
   public:
 
     /**
@@ -226,6 +270,7 @@ namespace GeographicLib {
       // If T is bool, then the specialization val<bool>() defined below is
       // used.
       T x;
+      if (fastval(s, x)) return x;
       std::string errmsg, t(trim(s));
       do {                     // Executed once (provides the ability to break)
         std::istringstream is(t);
@@ -328,10 +373,8 @@ namespace GeographicLib {
           str.read(reinterpret_cast<char*>(array), num * sizeof(ExtT));
           if (!str.good())
             throw GeographicErr("Failure reading data");
-          if (bigendp != Math::bigendian) { // endian mismatch -> swap bytes
-            for (size_t i = num; i--;)
-              array[i] = Math::swab<IntT>(array[i]);
-          }
+          if (bigendp != Math::bigendian) // endian mismatch -> swap bytes
+            swabarray(array, num);
         }
       else
 #endif
@@ -568,6 +611,12 @@ namespace GeographicLib {
     if (!isfinite(x))
       return x < 0 ? std::string("-inf") :
         (x > 0 ? std::string("inf") : std::string("nan"));
+#if GEOGRAPHICLIB_PRECISION <= 3
+    {
+      std::string r;
+      if (faststr(x, p, r)) return r;
+    }
+#endif
     std::ostringstream s;
 #if GEOGRAPHICLIB_PRECISION == 4
     // boost-quadmath treats precision == 0 as "use as many digits as
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/AlbersEqualArea.hpp>
+#include <GeographicLib/Instrument.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional and enum-float expressions
@@ -330,25 +331,41 @@ namespace GeographicLib {
             ( (1 - es1) / es2m1a + Datanhee(1, -sphi) ) );
   }
 
-  Math::real AlbersEqualArea::tphif(real txi) const {
-    real
-      tphi = txi,
-      stol = tol_ * fmax(real(1), fabs(txi));
+  template<int n>
+  void AlbersEqualArea::tphif(const real txi[], real tphi[]) const {
+    // The Newton iterations for the n points are carried out in lockstep.
+    // Each point drops out once it has converged; so its result is the same
+    // as for a solution on its own.
+    real stol[n];
+    bool active[n];
+    int iter[n];
+    for (int j = 0; j < n; ++j) {
+      tphi[j] = txi[j];
+      stol[j] = tol_ * fmax(real(1), fabs(txi[j]));
+      active[j] = true;
+      iter[j] = numit_;
+    }
     // CHECK: min iterations = 1, max iterations = 2; mean = 1.99
-    for (int i = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
-      // dtxi/dtphi = (scxi/scphi)^3 * 2*(1-e^2)/(qZ*(1-e^2*sphi^2)^2)
-      real
-        txia = txif(tphi),
-        tphi2 = Math::_sq(tphi),
-        scphi2 = 1 + tphi2,
-        scterm = scphi2/(1 + Math::_sq(txia)),
-        dtphi = (txi - txia) * scterm * sqrt(scterm) *
-        _qx * Math::_sq(1 - _e2 * tphi2 / scphi2);
-      tphi += dtphi;
-      if (!(fabs(dtphi) >= stol))
-        break;
+    for (int i = 0, m = n; m > 0 && (i < numit_ || GEOGRAPHICLIB_PANIC);
+         ++i) {
+      for (int j = 0; j < n; ++j) {
+        if (!active[j]) continue;
+        // dtxi/dtphi = (scxi/scphi)^3 * 2*(1-e^2)/(qZ*(1-e^2*sphi^2)^2)
+        real
+          txia = txif(tphi[j]),
+          tphi2 = Math::_sq(tphi[j]),
+          scphi2 = 1 + tphi2,
+          scterm = scphi2/(1 + Math::_sq(txia)),
+          dtphi = (txi[j] - txia) * scterm * sqrt(scterm) *
+          _qx * Math::_sq(1 - _e2 * tphi2 / scphi2);
+        tphi[j] += dtphi;
+        if (!(fabs(dtphi) >= stol[j])) {
+          active[j] = false; iter[j] = i + 1; --m;
+        }
+      }
     }
-    return tphi;
+    for (int j = 0; j < n; ++j)
+      GEOGRAPHICLIB_INSTRUMENT_RECORD(ALBERSEQUALAREA, iter[j], active[j]);
   }
 
   // return atanh(sqrt(x))/sqrt(x) - 1 = x/3 + x^2/5 + x^3/7 + ...
@@ -494,6 +511,12 @@ namespace GeographicLib {
 
   void AlbersEqualArea::Forward(real lon0, real lat, real lon,
                                 real& x, real& y, real& gamma, real& k) const {
+    ForwardPoint(lon0, lat, lon, x, y, &gamma, &k);
+  }
+
+  void AlbersEqualArea::ForwardPoint(real lon0, real lat, real lon,
+                                     real& x, real& y,
+                                     real* gamma, real* k) const {
     lon = Math::AngDiff(lon0, lon);
     lat *= _sign;
     real sphi, cphi;
@@ -512,31 +535,85 @@ namespace GeographicLib {
           (ctheta < 0 ? 1 - ctheta : Math::_sq(stheta)/(1 + ctheta)) / _n0 :
           0)
          - drho * ctheta) / _k0;
-    k = _k0 * (t != 0 ? t * hyp(_fm * tphi) / _a : 1);
     y *= _sign;
-    gamma = _sign * theta / Math::degree();
+    if (k) *k = _k0 * (t != 0 ? t * hyp(_fm * tphi) / _a : 1);
+    if (gamma) *gamma = _sign * theta / Math::degree();
+  }
+
+  void AlbersEqualArea::Forward(real lon0, size_t n,
+                                const real lat[], const real lon[],
+                                real x[], real y[],
+                                real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i)
+      ForwardPoint(lon0, lat[i], lon[i], x[i], y[i],
+                   gamma ? gamma + i : nullptr, k ? k + i : nullptr);
   }
 
   void AlbersEqualArea::Reverse(real lon0, real x, real y,
                                 real& lat, real& lon,
                                 real& gamma, real& k) const {
-    y *= _sign;
-    real
-      nx = _k0 * _n0 * x, ny = _k0 * _n0 * y, y1 =  _nrho0 - ny,
-      den = hypot(nx, y1) + _nrho0, // 0 implies origin with polar aspect
-      drho = den != 0 ? (_k0*x*nx - 2*_k0*y*_nrho0 + _k0*y*ny) / den : 0,
-      // dsxia = scxi0 * dsxi
-      dsxia = - _scxi0 * (2 * _nrho0 + _n0 * drho) * drho /
-              (Math::_sq(_a) * _qZ),
-      txi = (_txi0 + dsxia) / sqrt(fmax(1 - dsxia * (2*_txi0 + dsxia), epsx2_)),
-      tphi = tphif(txi),
-      theta = atan2(nx, y1),
-      lam = _n0 != 0 ? theta / (_k2 * _n0) : x / (y1 * _k0);
-    gamma = _sign * theta / Math::degree();
-    lat = Math::atand(_sign * tphi);
-    lon = lam / Math::degree();
-    lon = Math::AngNormalize(lon + Math::AngNormalize(lon0));
-    k = _k0 * (den != 0 ? (_nrho0 + _n0 * drho) * hyp(_fm * tphi) / _a : 1);
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, &gamma, &k);
+  }
+
+  void AlbersEqualArea::Reverse(real lon0, real x, real y,
+                                real& lat, real& lon) const {
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, nullptr, nullptr);
+  }
+
+  void AlbersEqualArea::Reverse(real lon0, size_t n,
+                                const real x[], const real y[],
+                                real lat[], real lon[],
+                                real gamma[], real k[]) const {
+    const int b = blocksize_;
+    size_t i = 0;
+    for (; i + b <= n; i += b)
+      ReverseBlock<b>(lon0, x + i, y + i, lat + i, lon + i,
+                      gamma ? gamma + i : nullptr, k ? k + i : nullptr);
+    if (i < n) {
+      // Pad the last partial block
+      int m = int(n - i);
+      real xx[b], yx[b], latx[b], lonx[b], gammax[b], kx[b];
+      fill(xx, xx + b, real(0)); fill(yx, yx + b, real(0));
+      copy(x + i, x + n, xx); copy(y + i, y + n, yx);
+      ReverseBlock<b>(lon0, xx, yx, latx, lonx, gammax, kx);
+      copy(latx, latx + m, lat + i); copy(lonx, lonx + m, lon + i);
+      if (gamma) copy(gammax, gammax + m, gamma + i);
+      if (k) copy(kx, kx + m, k + i);
+    }
+  }
+
+  template<int n>
+  void AlbersEqualArea::ReverseBlock(real lon0,
+                                     const real x[], const real y[],
+                                     real lat[], real lon[],
+                                     real gamma[], real k[]) const {
+    real nx[n], y1[n], den[n], drho[n], txi[n], tphi[n];
+    for (int i = 0; i < n; ++i) {
+      real yi = y[i] * _sign, ny = _k0 * _n0 * yi;
+      nx[i] = _k0 * _n0 * x[i]; y1[i] =  _nrho0 - ny;
+      den[i] = hypot(nx[i], y1[i]) + _nrho0; // 0 implies origin, polar aspect
+      drho[i] = den[i] != 0 ?
+        (_k0*x[i]*nx[i] - 2*_k0*yi*_nrho0 + _k0*yi*ny) / den[i] : 0;
+      real
+        // dsxia = scxi0 * dsxi
+        dsxia = - _scxi0 * (2 * _nrho0 + _n0 * drho[i]) * drho[i] /
+                (Math::_sq(_a) * _qZ);
+      txi[i] = (_txi0 + dsxia) /
+        sqrt(fmax(1 - dsxia * (2*_txi0 + dsxia), epsx2_));
+    }
+    tphif<n>(txi, tphi);
+    for (int i = 0; i < n; ++i) {
+      real
+        theta = atan2(nx[i], y1[i]),
+        lam = _n0 != 0 ? theta / (_k2 * _n0) : x[i] / (y1[i] * _k0);
+      if (gamma) gamma[i] = _sign * theta / Math::degree();
+      lat[i] = Math::atand(_sign * tphi[i]);
+      lon[i] = lam / Math::degree();
+      lon[i] = Math::AngNormalize(lon[i] + Math::AngNormalize(lon0));
+      if (k) k[i] = _k0 *
+               (den[i] != 0 ?
+                (_nrho0 + _n0 * drho[i]) * hyp(_fm * tphi[i]) / _a : 1);
+    }
   }
 
   void AlbersEqualArea::SetScale(real lat, real k) {
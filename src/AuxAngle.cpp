@@ -58,4 +58,9 @@ namespace GeographicLib {
     return *this;
   }
 
+  void AuxAngleArray::normalize() {
+    for (size_t i = 0; i < size(); ++i)
+      set(i, (*this)[i].normalized());
+  }
+
 } // namespace GeographicLib
@@ -51,8 +51,7 @@ namespace GeographicLib {
       throw GeographicErr("Equatorial radius is not positive");
     if (!(isfinite(_b) && _b > 0))
       throw GeographicErr("Polar semi-axis is not positive");
-    fill(_c, _c + Lmax * AUXNUMBER * AUXNUMBER,
-         numeric_limits<real>::quiet_NaN());
+    fillcoeff();
   }
 
   /// \cond SKIP
@@ -78,8 +77,7 @@ namespace GeographicLib {
       throw GeographicErr("Equatorial radius is not positive");
     if (!(isfinite(_b) && _b > 0))
       throw GeographicErr("Polar semi-axis is not positive");
-    fill(_c, _c + Lmax * AUXNUMBER * AUXNUMBER,
-         numeric_limits<real>::quiet_NaN());
+    fillcoeff();
   }
   /// \endcond
 
@@ -303,7 +301,6 @@ namespace GeographicLib {
 
   AuxAngle AuxLatitude::Convert(int auxin, int auxout, const AuxAngle& zeta,
                                 bool exact) const {
-    using std::isnan;           // Needed for Centos 7, ubuntu 14
     int k = ind(auxout, auxin);
     if (k < 0) return AuxAngle::NaN();
     if (auxin == auxout) return zeta;
@@ -314,7 +311,6 @@ namespace GeographicLib {
       else
         return ToAuxiliary(auxout, FromAuxiliary(auxin, zeta));
     } else {
-      if ( isnan(_c[Lmax * (k + 1) - 1]) ) fillcoeff(auxin, auxout, k);
       AuxAngle zetan(zeta.normalized());
       real d = Clenshaw(true, zetan.y(), zetan.x(), _c + Lmax * k, Lmax);
       zetan += AuxAngle::radians(d);
@@ -329,6 +325,91 @@ namespace GeographicLib {
     return Math::td * m + Convert(auxin, auxout, zetaa, exact).degrees();
   }
 
+  void AuxLatitude::Convert(int auxin, int auxout, size_t n,
+                            const real zeta[], real eta[], bool exact) const {
+    int k = ind(auxout, auxin);
+    if (k < 0 || auxin == auxout || exact) {
+      for (size_t i = 0; i < n; ++i)
+        eta[i] = k < 0 ? numeric_limits<real>::quiet_NaN() :
+          (auxin == auxout ? zeta[i] : Convert(auxin, auxout, zeta[i], true));
+      return;
+    }
+    const real* c = _c + Lmax * k;
+    // Process the latitudes in blocks; within a block, the loops are over the
+    // latitudes so that they can be vectorized.
+    const size_t nb = 16;
+    real x[nb], y[nb], u0[nb], u1[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = min(nb, n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        // Reduce 2*zeta to [-180, 180]; the subtraction is exact.
+        real z = 2 * zeta[i0 + j];
+        z = (z - Math::td * round(z / Math::td)) * Math::degree();
+        y[j] = sin(z); x[j] = 2 * cos(z); // sin(2*zeta), 2*cos(2*zeta)
+        u0[j] = u1[j] = 0;
+      }
+      for (int l = Lmax; l > 0;) {
+        real cl = c[--l];
+        for (size_t j = 0; j < m; ++j) {
+          real t = Math::muladd(x[j], u0[j], -u1[j]) + cl;
+          u1[j] = u0[j]; u0[j] = t;
+        }
+      }
+      for (size_t j = 0; j < m; ++j)
+        eta[i0 + j] = zeta[i0 + j] + y[j] * u0[j] / Math::degree();
+    }
+  }
+
+  void AuxLatitude::Convert(int auxin, int auxout, const AuxAngleArray& zeta,
+                            AuxAngleArray& eta, bool exact) const {
+    size_t n = zeta.size();
+    eta.resize(n);
+    const real* zy = zeta.y(), * zx = zeta.x();
+    real* ey = eta.y(), * ex = eta.x();
+    int k = ind(auxout, auxin);
+    if (k < 0 || auxin == auxout || exact) {
+      if (k >= 0 && auxin < 3 && auxout < 3) {
+        real s = real(pow(_fm1, auxout - auxin));
+        for (size_t i = 0; i < n; ++i) {
+          ey[i] = zy[i] * s; ex[i] = zx[i];
+        }
+      } else
+        for (size_t i = 0; i < n; ++i)
+          eta.set(i, Convert(auxin, auxout, zeta[i], exact));
+      return;
+    }
+    const real* c = _c + Lmax * k;
+    const size_t nb = 16;
+    real x[nb], y[nb], u0[nb], u1[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = min(nb, n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        real zy1 = zy[i0 + j], zx1 = zx[i0 + j],
+          r2 = Math::_sq(zy1) + Math::_sq(zx1);
+        y[j] = 2 * zy1 * zx1 / r2;                 // sin(2*zeta)
+        x[j] = 2 * (zx1 - zy1) * (zx1 + zy1) / r2; // 2*cos(2*zeta)
+        u0[j] = u1[j] = 0;
+      }
+      for (int l = Lmax; l > 0;) {
+        real cl = c[--l];
+        for (size_t j = 0; j < m; ++j) {
+          real t = Math::muladd(x[j], u0[j], -u1[j]) + cl;
+          u1[j] = u0[j]; u0[j] = t;
+        }
+      }
+      for (size_t j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        real zy1 = zy[i], zx1 = zx[i], d = y[j] * u0[j];
+        if (isfinite(d)) {
+          real sd = sin(d), cd = cos(d);
+          ey[i] = zy1 * cd + zx1 * sd; ex[i] = zx1 * cd - zy1 * sd;
+        } else
+          // The components are infinite, zero, or overflow when squared.
+          eta.set(i, Convert(auxin, auxout, AuxAngle(zy1, zx1), false));
+      }
+    }
+  }
+
   Math::real AuxLatitude::RectifyingRadius(bool exact) const {
     if (exact) {
       return EllipticFunction::RG(Math::_sq(_a), Math::_sq(_b)) * 4 / Math::pi();
@@ -439,7 +520,13 @@ namespace GeographicLib {
   }
 
   /// \cond SKIP
-  void AuxLatitude::fillcoeff(int auxin, int auxout, int k) const {
+  void AuxLatitude::fillcoeff() {
+    for (int auxout = 0; auxout < AUXNUMBER; ++auxout)
+      for (int auxin = 0; auxin < AUXNUMBER; ++auxin)
+        fillcoeff(auxin, auxout, ind(auxout, auxin));
+  }
+
+  void AuxLatitude::fillcoeff(int auxin, int auxout, int k) {
 #if GEOGRAPHICLIB_AUXLATITUDE_ORDER == 4
     static const real coeffs[] = {
       // C[phi,phi] skipped
@@ -1329,13 +1416,9 @@ namespace GeographicLib {
     // y = sum(c[k] * sin( (2*k+2) * zeta), i, 0, K-1) if  sinp
     // y = sum(c[k] * cos( (2*k+2) * zeta), i, 0, K-1) if !sinp
     // Approx operation count = (K + 5) mult and (2 * K + 2) add
-    int k = K;
-    real u0 = 0, u1 = 0,        // accumulators for sum
-      x = 2 * (czeta - szeta) * (czeta + szeta); // 2 * cos(2*zeta)
-    for (; k > 0;) {
-      real t = x * u0 - u1 + c[--k];
-      u1 = u0; u0 = t;
-    }
+    real u1,                    // accumulators for sum
+      x = 2 * (czeta - szeta) * (czeta + szeta), // 2 * cos(2*zeta)
+      u0 = Math::clenshaw(K, x, c, u1);
     // u0*f0(zeta) - u1*fm1(zeta)
     // f0 = sinp ? sin(2*zeta) : cos(2*zeta)
     // fm1 = sinp ? 0 : 1
@@ -8,6 +8,7 @@
  **********************************************************************/
 
 #include <GeographicLib/AzimuthalEquidistant.hpp>
+#include <GeographicLib/GeodesicOrigin.hpp>
 
 namespace GeographicLib {
 
@@ -38,4 +39,40 @@ namespace GeographicLib {
     rk = !(sig <= eps_) ? m / s : 1;
   }
 
+  void AzimuthalEquidistant::Forward(real lat0, real lon0, size_t n,
+                                     const real lat[], const real lon[],
+                                     real x[], real y[],
+                                     real azi[], real rk[]) const {
+    const GeodesicOrigin orig(_earth, lat0, lon0);
+    // Solve the inverse problems for blocks of points
+    const size_t b = 256;
+    real sig[b], s[b], azi0[b], azi2[b], m[b], t;
+    for (size_t i0 = 0; i0 < n; i0 += b) {
+      size_t k = min(b, n - i0);
+      orig.InverseBatch(k, lat + i0, lon + i0,
+                        Geodesic::DISTANCE | Geodesic::AZIMUTH |
+                        Geodesic::REDUCEDLENGTH,
+                        s, azi0, azi2, m, &t, &t, &t, sig);
+      for (size_t j = 0; j < k; ++j) {
+        size_t i = i0 + j;
+        Math::sincosd(azi0[j], x[i], y[i]);
+        x[i] *= s[j]; y[i] *= s[j];
+        if (azi) azi[i] = azi2[j];
+        if (rk) rk[i] = !(sig[j] <= eps_) ? m[j] / s[j] : 1;
+      }
+    }
+  }
+
+  void AzimuthalEquidistant::Reverse(real lat0, real lon0, size_t n,
+                                     const real x[], const real y[],
+                                     real lat[], real lon[],
+                                     real azi[], real rk[]) const {
+    for (size_t i = 0; i < n; ++i) {
+      real azix, rkx;
+      Reverse(lat0, lon0, x[i], y[i], lat[i], lon[i], azix, rkx);
+      if (azi) azi[i] = azix;
+      if (rk) rk[i] = rkx;
+    }
+  }
+
 } // namespace GeographicLib
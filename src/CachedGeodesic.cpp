@@ -0,0 +1,194 @@
+/**
+ * \file CachedGeodesic.cpp
+ * \brief Implementation for GeographicLib::CachedGeodesic class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/CachedGeodesic.hpp>
+#include <functional>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  bool CachedGeodesic::key::operator==(const key& k) const {
+    // Distinguish +0 and -0 since these can give different results
+    return outmask == k.outmask &&
+      lat1 == k.lat1 && signbit(lat1) == signbit(k.lat1) &&
+      lon1 == k.lon1 && signbit(lon1) == signbit(k.lon1) &&
+      lat2 == k.lat2 && signbit(lat2) == signbit(k.lat2) &&
+      lon2 == k.lon2 && signbit(lon2) == signbit(k.lon2);
+  }
+
+  size_t CachedGeodesic::key::hash() const {
+    std::hash<double> h;
+    size_t r = outmask;
+    // Combine the hashes as in boost::hash_combine
+    r ^= h(double(lat1)) + 0x9e3779b9 + (r << 6) + (r >> 2);
+    r ^= h(double(lon1)) + 0x9e3779b9 + (r << 6) + (r >> 2);
+    r ^= h(double(lat2)) + 0x9e3779b9 + (r << 6) + (r >> 2);
+    r ^= h(double(lon2)) + 0x9e3779b9 + (r << 6) + (r >> 2);
+    return r;
+  }
+
+  CachedGeodesic::CachedGeodesic(const Geodesic& geod, size_t budget,
+                                 int nshards, real quantum)
+    : _geod(geod)
+    , _quantum(quantum)
+  {
+    if (!(nshards > 0))
+      throw GeographicErr("Number of shards must be positive");
+    if (!(isfinite(_quantum) && _quantum >= 0))
+      throw GeographicErr("Quantum must be finite and non-negative");
+    // The approximate size of an entry: the node of the list, the node of
+    // the hash table and its bucket, and the slot in the seen table.
+    const size_t entrysize = sizeof(entry) + 2 * sizeof(void*) +
+      sizeof(key) + sizeof(lrulist::iterator) + 2 * sizeof(void*) +
+      sizeof(void*) + sizeof(size_t);
+    _capacity = max(budget / (entrysize * size_t(nshards)), size_t(1));
+    _shards.reserve(nshards);
+    for (int i = 0; i < nshards; ++i) {
+      _shards.push_back(unique_ptr<shard>(new shard()));
+      _shards.back()->index.reserve(_capacity);
+      _shards.back()->seen.assign(_capacity, 0);
+    }
+  }
+
+  Math::real CachedGeodesic::quantize(real x) const {
+    return _quantum > 0 ? _quantum * round(x / _quantum) : x;
+  }
+
+  Math::real CachedGeodesic::GenInverse(real lat1, real lon1,
+                                        real lat2, real lon2,
+                                        unsigned outmask,
+                                        real& s12, real& azi1, real& azi2,
+                                        real& m12, real& M12, real& M21,
+                                        real& S12) const {
+    // Drop Geodesic::LONG_UNROLL which doesn't affect the inverse problem
+    outmask &= Geodesic::ALL;
+    key k;
+    k.lat1 = quantize(lat1); k.lon1 = quantize(lon1);
+    k.lat2 = quantize(lat2); k.lon2 = quantize(lon2);
+    k.outmask = outmask;
+    entry e;
+    e.k = k;
+    real* v = e.v;
+    bool finite = isfinite(k.lat1) && isfinite(k.lon1) &&
+      isfinite(k.lat2) && isfinite(k.lon2);
+    size_t h = finite ? k.hash() : 0;
+    shard& s = *_shards[h % _shards.size()];
+    bool found = false, admit = false;
+    {
+      lock_guard<mutex> g(s.lock);
+      if (!finite)
+        ++s.bypasses;
+      else {
+        auto p = s.index.find(k);
+        if (p != s.index.end()) {
+          // Move the entry to the front of the list
+          s.lru.splice(s.lru.begin(), s.lru, p->second);
+          copy(p->second->v, p->second->v + 8, v);
+          found = true;
+          ++s.hits;
+        } else {
+          size_t slot = (h / _shards.size()) % s.seen.size();
+          admit = s.seen[slot] == h;
+          if (!admit) {
+            s.seen[slot] = h;
+            ++s.bypasses;
+          }
+        }
+      }
+    }
+    if (!found) {
+      fill(v + 1, v + 8, Math::NaN());
+      v[0] = _geod.GenInverse(k.lat1, k.lon1, k.lat2, k.lon2, outmask,
+                              v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+      if (admit) {
+        lock_guard<mutex> g(s.lock);
+        // Another thread may have added the entry in the meantime
+        if (s.index.find(k) == s.index.end()) {
+          s.lru.push_front(e);
+          s.index[k] = s.lru.begin();
+          if (s.lru.size() > _capacity) {
+            s.index.erase(s.lru.back().k);
+            s.lru.pop_back();
+          }
+        }
+        ++s.misses;
+      }
+    }
+    // The masks include capability bits, so test for all the bits
+    auto want = [outmask](unsigned m) -> bool { return (outmask & m) == m; };
+    if (want(Geodesic::DISTANCE)) s12 = v[1];
+    if (want(Geodesic::AZIMUTH)) { azi1 = v[2]; azi2 = v[3]; }
+    if (want(Geodesic::REDUCEDLENGTH)) m12 = v[4];
+    if (want(Geodesic::GEODESICSCALE)) { M12 = v[5]; M21 = v[6]; }
+    if (want(Geodesic::AREA)) S12 = v[7];
+    return v[0];
+  }
+
+  void CachedGeodesic::Clear() {
+    for (auto& p : _shards) {
+      shard& s = *p;
+      lock_guard<mutex> g(s.lock);
+      s.lru.clear();
+      s.index.clear();
+      fill(s.seen.begin(), s.seen.end(), 0);
+      s.hits = s.misses = s.bypasses = 0;
+    }
+  }
+
+  unsigned long long CachedGeodesic::Hits() const {
+    unsigned long long n = 0;
+    for (auto& p : _shards) {
+      lock_guard<mutex> g(p->lock);
+      n += p->hits;
+    }
+    return n;
+  }
+
+  unsigned long long CachedGeodesic::Misses() const {
+    unsigned long long n = 0;
+    for (auto& p : _shards) {
+      lock_guard<mutex> g(p->lock);
+      n += p->misses;
+    }
+    return n;
+  }
+
+  unsigned long long CachedGeodesic::Bypasses() const {
+    unsigned long long n = 0;
+    for (auto& p : _shards) {
+      lock_guard<mutex> g(p->lock);
+      n += p->bypasses;
+    }
+    return n;
+  }
+
+  size_t CachedGeodesic::Size() const {
+    size_t n = 0;
+    for (auto& p : _shards) {
+      lock_guard<mutex> g(p->lock);
+      n += p->lru.size();
+    }
+    return n;
+  }
+
+  MemoryFootprint CachedGeodesic::MemoryUsage() const {
+    size_t bytes = 0;
+    for (auto& p : _shards) {
+      lock_guard<mutex> g(p->lock);
+      bytes += p->lru.size() * (sizeof(entry) + 2 * sizeof(void*)) +
+        p->index.size() * (sizeof(key) + sizeof(lrulist::iterator) +
+                           2 * sizeof(void*)) +
+        p->index.bucket_count() * sizeof(void*) +
+        MemoryFootprint::Bytes(p->seen);
+    }
+    return MemoryFootprint(0, 0, bytes);
+  }
+
+} // namespace GeographicLib
@@ -36,10 +36,9 @@ namespace GeographicLib {
     Math::norm(_sbet0, _cbet0);
   }
 
-  void CassiniSoldner::Forward(real lat, real lon, real& x, real& y,
-                               real& azi, real& rk) const {
-    if (!Init())
-      return;
+  Math::real CassiniSoldner::Perpendicular(real lat, real lon,
+                                            real& x, real& azi,
+                                            bool scalep, real& rk) const {
     real dlon = Math::AngDiff(LongitudeOrigin(), lon);
     real sig12, s12, azi1, azi2;
     sig12 = _earth.Inverse(lat, -fabs(dlon), lat, fabs(dlon), s12, azi1, azi2);
@@ -62,11 +61,17 @@ namespace GeographicLib {
     }
     x = s12;
     azi = Math::AngNormalize(azi2);
-    GeodesicLine perp(_earth.Line(lat, dlon, azi, Geodesic::GEODESICSCALE));
-    real t;
-    perp.GenPosition(true, -sig12,
-                     Geodesic::GEODESICSCALE,
-                     t, t, t, t, t, t, rk, t);
+    // The equatorial azimuth doesn't depend on the capabilities of the line;
+    // so the coefficients for the scale are only computed if needed.
+    GeodesicLine perp(_earth.Line(lat, dlon, azi,
+                                  scalep ? Geodesic::GEODESICSCALE :
+                                  Geodesic::NONE));
+    if (scalep) {
+      real t;
+      perp.GenPosition(true, -sig12,
+                       Geodesic::GEODESICSCALE,
+                       t, t, t, t, t, t, rk, t);
+    }
 
     real salp0, calp0;
     Math::sincosd(perp.EquatorialAzimuth(), salp0, calp0);
@@ -74,8 +79,15 @@ namespace GeographicLib {
       sbet1 = lat >=0 ? calp0 : -calp0,
       cbet1 = fabs(dlon) <= Math::qd ? fabs(salp0) : -fabs(salp0),
       sbet01 = sbet1 * _cbet0 - cbet1 * _sbet0,
-      cbet01 = cbet1 * _cbet0 + sbet1 * _sbet0,
-      sig01 = atan2(sbet01, cbet01) / Math::degree();
+      cbet01 = cbet1 * _cbet0 + sbet1 * _sbet0;
+    return atan2(sbet01, cbet01) / Math::degree();
+  }
+
+  void CassiniSoldner::Forward(real lat, real lon, real& x, real& y,
+                               real& azi, real& rk) const {
+    if (!Init())
+      return;
+    real sig01 = Perpendicular(lat, lon, x, azi, true, rk), t;
     _meridian.GenPosition(true, sig01,
                           Geodesic::DISTANCE,
                           t, t, t, y, t, t, t, t);
@@ -91,4 +103,59 @@ namespace GeographicLib {
     _earth.Direct(lat1, lon1, azi0 + Math::qd, x, lat, lon, azi, rk, t);
   }
 
+  void CassiniSoldner::Forward(size_t n, const real lat[], const real lon[],
+                               real x[], real y[],
+                               real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    // The arc lengths along the meridian for a block of points.  The input
+    // for a block is read before y is written; so y may be the same as lat
+    // or lon.
+    real sig01[block_], xx[block_];
+    for (size_t i0 = 0; i0 < n; i0 += block_) {
+      size_t k = min(size_t(block_), n - i0);
+      for (size_t j = 0; j < k; ++j) {
+        size_t i = i0 + j;
+        real azix, rkx;
+        sig01[j] = Perpendicular(lat[i], lon[i], xx[j], azix, rk != nullptr,
+                                 rkx);
+        if (azi) azi[i] = azix;
+        if (rk) rk[i] = rkx;
+      }
+      copy(xx, xx + k, x + i0);
+      _meridian.GenPositions(true, k, sig01, Geodesic::DISTANCE,
+                             nullptr, nullptr, nullptr, y + i0,
+                             nullptr, nullptr, nullptr, nullptr);
+    }
+  }
+
+  void CassiniSoldner::Reverse(size_t n, const real x[], const real y[],
+                               real lat[], real lon[],
+                               real azi[], real rk[]) const {
+    if (!Init())
+      return;
+    // The feet of the perpendiculars on the meridian for a block of points
+    real lat1[block_], lon1[block_], azi0[block_];
+    for (size_t i0 = 0; i0 < n; i0 += block_) {
+      size_t k = min(size_t(block_), n - i0);
+      _meridian.GenPositions(false, k, y + i0,
+                             Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                             Geodesic::AZIMUTH,
+                             lat1, lon1, azi0, nullptr,
+                             nullptr, nullptr, nullptr, nullptr);
+      for (size_t j = 0; j < k; ++j) {
+        size_t i = i0 + j;
+        real azix, rkx, t;
+        if (rk)
+          _earth.Direct(lat1[j], lon1[j], azi0[j] + Math::qd, x[i],
+                        lat[i], lon[i], azix, rkx, t);
+        else
+          _earth.Direct(lat1[j], lon1[j], azi0[j] + Math::qd, x[i],
+                        lat[i], lon[i], azix);
+        if (azi) azi[i] = azix;
+        if (rk) rk[i] = rkx;
+      }
+    }
+  }
+
 } // namespace GeographicLib
@@ -8,6 +8,10 @@
  **********************************************************************/
 
 #include <GeographicLib/CircularEngine.hpp>
+#include <complex>
+#include <limits>
+
+#include "kissfft.hh"
 
 namespace GeographicLib {
 
@@ -93,4 +97,102 @@ namespace GeographicLib {
     return vc;
   }
 
+  void CircularEngine::Grid(real lon0, real dlon, size_t n, real v[],
+                            real gradx[], real grady[], real gradz[]) const {
+    bool gradp = _gradp && gradx && grady && gradz;
+    // The points lie on a grid of P equally spaced longitudes if q*360/|dlon|
+    // = P is an integer for some small integer q; point i is then at index
+    // (i*q) mod P on this grid.
+    const int qmax = 64;
+    real P = 0;
+    int q = 0;
+    if (dlon != 0) {
+      for (int qx = 1; qx <= qmax; ++qx) {
+        real p = qx * Math::td / fabs(dlon), Px = round(p);
+        if (fabs(p - Px) <= 4 * numeric_limits<real>::epsilon() * Px) {
+          P = Px; q = qx; break;
+        }
+      }
+    }
+    bool fftp = P >= 1 && P <= real(numeric_limits<int>::max() / qmax) &&
+      // The FFT is only worthwhile if it replaces enough Clenshaw sums
+      real(n) * real(_mM + 1) > 4 * P * ceil(log2(P + 1)) &&
+      // dV/dlambda is divided by u
+      !(gradp && _u == 0);
+    if (!fftp) {
+      for (size_t i = 0; i < n; ++i) {
+        real sl, cl, gx, gy, gz;
+        Math::sincosd(lon0 + real(i) * dlon, sl, cl);
+        v[i] = Value(gradp, sl, cl, gx, gy, gz);
+        if (gradp) { gradx[i] = gx; grady[i] = gy; gradz[i] = gz; }
+      }
+      return;
+    }
+    // The sum is sum(kappa[m] * (wc[m] * cos(m*lambda) + ws[m] *
+    // sin(m*lambda)), m = 0..M), where kappa[m] includes the normalization
+    // of the sectoral Legendre functions and (u*q)^m.  This follows from the
+    // Clenshaw recurrence in Value: kappa[0] = 1, kappa[1] = A[0]/cl, and
+    // kappa[m+1] = kappa[m] * A[m]/(2*cl) for m > 0; here kappa excludes the
+    // overall factor qs.  With lambda = lon0 + j*dlon, the terms for m and m
+    // + P coincide, so the sum is the real part of a DFT of length P.  With
+    // q > 1, successive points advance by q elements of the DFT.
+    typedef complex<real> cpx;
+    const vector<real>& root( SphericalEngine::sqrttable() );
+    int np = int(P), ns = gradp ? 4 : 1;
+    vector<cpx> z(size_t(ns) * np, cpx(0));
+    // Represent kappa as k * 2^e to avoid underflow near the poles
+    const int escale = 256;
+    const real kmin = ldexp(real(1), -escale);
+    real k = 1;
+    int e = 0;
+    for (int m = 0; m <= _mM && k != 0; ++m) {
+      if (m == 1)
+        k *= (_norm == FULL ? root[3] : 1) * _uq;
+      else if (m > 1) {
+        int l = m - 1;
+        k *= (_norm == FULL ? root[2 * l + 3] : root[2 * l + 1]) *
+          root[2] / root[l + 1] * _uq / 2;
+      }
+      if (k < kmin) { k /= kmin; e -= escale; }
+      real sm, cm;
+      Math::sincosd(real(m) * lon0, sm, cm);
+      // kappa * exp(i*m*lon0)
+      cpx f(ldexp(k * cm, e), ldexp(k * sm, e));
+      size_t j = size_t(m % np);
+      // The real part of (wc - i*ws) * exp(i*m*lambda) is the term
+      z[j] += f * cpx(_wc[m], -_ws[m]);
+      if (gradp) {
+        z[np + j] += f * cpx(_wrc[m], -_wrs[m]);
+        z[2*np + j] += f * cpx(_wtc[m], -_wts[m]);
+        z[3*np + j] += f * cpx(m * _ws[m], m * _wc[m]);
+      }
+    }
+    // The inverse FFT sums with exp(+i*2*pi*j*m/P), appropriate for dlon > 0
+    kissfft<real> fft(size_t(np), dlon > 0);
+    vector<cpx> t(np);
+    for (int s = 0; s < ns; ++s) {
+      fft.transform(&z[size_t(s) * np], t.data());
+      for (int j = 0; j < np; ++j)
+        z[size_t(s) * np + j] = t[j];
+    }
+    real qs = _q / SphericalEngine::scale();
+    for (size_t i = 0; i < n; ++i) {
+      size_t j = (i % size_t(np)) * size_t(q) % size_t(np);
+      v[i] = qs * z[j].real();
+      if (gradp) {
+        real
+          // The components of the gradient in circular coordinates; see
+          // Value.
+          vr = - qs / _r * z[np + j].real(),
+          vt =   qs / _r * z[2*np + j].real(),
+          vl =   qs / (_r * _u) * z[3*np + j].real(),
+          sl, cl;
+        Math::sincosd(lon0 + real(i) * dlon, sl, cl);
+        gradx[i] = cl * (_u * vr + _t * vt) - sl * vl;
+        grady[i] = sl * (_u * vr + _t * vt) + cl * vl;
+        gradz[i] =           _t * vr - _u * vt         ;
+      }
+    }
+  }
+
 } // namespace GeographicLib
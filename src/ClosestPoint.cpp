@@ -0,0 +1,193 @@
+/**
+ * \file ClosestPoint.cpp
+ * \brief Implementation for GeographicLib::ClosestPoint class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <utility>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  // Scratch space for Find
+  class ClosestPoint::Workspace {
+  public:
+    vector<int> ind;
+    vector<pair<double, int>> cand;
+    NearestNeighbor<double, pos, chord>::Workspace range;
+  };
+
+  ClosestPoint::ClosestPoint(const Geodesic& geod,
+                             size_t n, const real lat[], const real lon[])
+    : _geod(geod)
+    , _earth(_geod.EquatorialRadius(), _geod.Flattening())
+    , _maxhalf(0)
+  {
+    if (n < 2)
+      throw GeographicErr("A polyline needs at least 2 vertices");
+    for (size_t i = 0; i < n; ++i)
+      if (!(fabs(lat[i]) <= Math::qd))
+        throw GeographicErr("Latitude not in [-" + to_string(Math::qd)
+                            + "d, " + to_string(Math::qd) + "d]");
+    const unsigned caps = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE_IN | Geodesic::DISTANCE;
+    _segs.reserve(n - 1);
+    _start.reserve(n - 1);
+    real start = 0;
+    for (size_t i = 0; i + 1 < n; ++i) {
+      _segs.push_back(_geod.InverseLine(lat[i], lon[i], lat[i + 1], lon[i + 1],
+                                        caps));
+      _start.push_back(start);
+      start += _segs.back().Distance();
+    }
+    // Split the segments into pieces no longer than twice the median length
+    // of the segments.
+    real maxlen;
+    {
+      vector<real> len(_segs.size());
+      for (size_t k = 0; k < _segs.size(); ++k)
+        len[k] = _segs[k].Distance();
+      nth_element(len.begin(), len.begin() + len.size()/2, len.end());
+      maxlen = 2 * len[len.size()/2];
+    }
+    for (size_t k = 0; k < _segs.size(); ++k) {
+      const GeodesicLine& l = _segs[k];
+      real d = l.Distance();
+      int np = maxlen > 0 ?
+        max(1, int(fmin(real(maxpieces_), ceil(d / maxlen)))) : 1;
+      for (int j = 0; j < np; ++j) {
+        real s = (j + real(0.5)) * d / np, latm, lonm;
+        l.Position(s, latm, lonm);
+        _mid.push_back(Position(latm, lonm));
+        _half.push_back(double(d / (2 * np)));
+        _smid.push_back(s);
+        _pseg.push_back(int(k));
+        _maxhalf = fmax(_maxhalf, _half.back());
+      }
+    }
+    _tree.Initialize(_mid, chord());
+  }
+
+  ClosestPoint::pos ClosestPoint::Position(real lat, real lon) const {
+    real x, y, z;
+    _earth.Forward(lat, lon, 0, x, y, z);
+    pos p = {double(x), double(y), double(z)};
+    return p;
+  }
+
+  void ClosestPoint::ClosestOnSegment(const Geodesic& geod,
+                                      const GeodesicLine& l,
+                                      real lat, real lon, real s0,
+                                      real& s, real& cross,
+                                      real& latc, real& lonc) {
+    // Apply Newton's method to g(s) = d(s12^2/2)/ds = -s12 * cos(gam).
+    const real tol = pow(numeric_limits<real>::epsilon(), real(0.75)) *
+      l.EquatorialRadius();
+    const unsigned outmask = Geodesic::DISTANCE | Geodesic::AZIMUTH |
+      Geodesic::REDUCEDLENGTH | Geodesic::GEODESICSCALE;
+    real d = l.Distance();
+    s = fmin(fmax(s0, real(0)), d);
+    for (int i = 0; i < maxit_; ++i) {
+      real azic, s12, azi1, azi2, m12, M12, M21, t;
+      l.GenPosition(false, s,
+                    Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                    Geodesic::AZIMUTH,
+                    latc, lonc, azic, t, t, t, t, t);
+      geod.GenInverse(latc, lonc, lat, lon, outmask,
+                      s12, azi1, azi2, m12, M12, M21, t);
+      // gam is the angle from the segment to the geodesic to the point,
+      // positive if the point is to the right.
+      real sgam, cgam;
+      Math::sincosd(Math::AngDiff(azic, azi1), sgam, cgam);
+      cross = sgam < 0 ? -s12 : s12;
+      real g = -s12 * cgam,
+        dg = cgam * cgam + (m12 != 0 ? M12 * s12 / m12 : 1) * sgam * sgam;
+      // Beyond the conjugate point, dg may be negative; fall back to the
+      // planar step.
+      if (!(dg > 0)) dg = 1;
+      real s1 = fmin(fmax(s - g / dg, real(0)), d);
+      // Stop if converged or if pushed beyond an end of the segment
+      if (!(fabs(s1 - s) > tol) || i == maxit_ - 1) break;
+      s = s1;
+    }
+  }
+
+  void ClosestPoint::Find(real lat, real lon, Workspace& work, int& seg,
+                          real& along, real& cross, real& latc, real& lonc)
+    const {
+    if (isnan(lat) || isnan(lon)) {
+      seg = -1;
+      along = cross = latc = lonc = Math::NaN();
+      return;
+    }
+    pos q = Position(lat, lon);
+    chord dist;
+    int cost;
+    _tree.ConcurrentSearch(_mid, dist, q, work.ind, cost);
+    int p = work.ind[0];
+    real s;
+    ClosestOnSegment(_geod, _segs[_pseg[p]], lat, lon, _smid[p],
+                     s, cross, latc, lonc);
+    seg = _pseg[p];
+    along = s;
+    real best = fabs(cross);
+    double bestd = double(best);
+    // A piece with midpoint distance (chord) c is no closer than c - half.
+    work.cand.clear();
+    _tree.RangeSearch(_mid, dist, q, bestd + _maxhalf,
+                      [this, p, bestd, &work](int i, double c) -> void {
+                        if (i != p && c - _half[i] < bestd)
+                          work.cand.push_back(make_pair(c - _half[i], i));
+                      }, -1, &work.range);
+    sort(work.cand.begin(), work.cand.end());
+    for (const auto& c : work.cand) {
+      if (!(c.first < bestd)) break;
+      int i = c.second;
+      real si, crossi, latci, lonci;
+      ClosestOnSegment(_geod, _segs[_pseg[i]], lat, lon, _smid[i],
+                       si, crossi, latci, lonci);
+      if (fabs(crossi) < best) {
+        best = fabs(crossi); bestd = double(best);
+        seg = _pseg[i]; along = si; cross = crossi;
+        latc = latci; lonc = lonci;
+      }
+    }
+    along += _start[seg];
+  }
+
+  void ClosestPoint::Find(real lat, real lon, int& seg, real& along,
+                          real& cross, real& latc, real& lonc) const {
+    Workspace work;
+    Find(lat, lon, work, seg, along, cross, latc, lonc);
+  }
+
+  void ClosestPoint::Find(size_t n, const real lat[], const real lon[],
+                          int seg[], real along[], real cross[],
+                          real latc[], real lonc[], int nthreads) const {
+    // The points are handed out to the tasks in chunks.
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      Workspace work;
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t i = i0; i < min(n, i0 + chunk); ++i) {
+          real latx, lonx;
+          Find(lat[i], lon[i], work, seg[i], along[i], cross[i], latx, lonx);
+          if (latc) latc[i] = latx;
+          if (lonc) lonc[i] = lonx;
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
+} // namespace GeographicLib
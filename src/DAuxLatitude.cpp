@@ -203,12 +203,9 @@ namespace GeographicLib {
                                     const AuxAngle& zeta1,
                                     const AuxAngle& zeta2)
     const {
-    using std::isnan;           // Needed for Centos 7, ubuntu 14
     int k = base::ind(auxout, auxin);
     if (k < 0) return numeric_limits<real>::quiet_NaN();
     if (auxin == auxout) return 1;
-    if ( isnan(base::_c[base::Lmax * (k + 1) - 1]) )
-      base::fillcoeff(auxin, auxout, k);
     AuxAngle zeta1n(zeta1.normalized()), zeta2n(zeta2.normalized());
     return 1 + DClenshaw(true, zeta2n.radians() - zeta1n.radians(),
                          zeta1n.y(), zeta1n.x(), zeta2n.y(), zeta2n.x(),
@@ -245,8 +242,8 @@ namespace GeographicLib {
       u0a = 0, u0b = 0, u1a = 0, u1b = 0; // accumulators for sum
     for (--k; k >= 0; --k) {
       // temporary real = X . U0 - U1 + c[k] * I
-      real ta = Xa * u0a + D2 * Xb * u0b - u1a + c[k],
-        tb = Xb * u0a +      Xa * u0b - u1b;
+      real ta = Math::muladd(Xa, u0a, D2 * Xb * u0b) - u1a + c[k],
+        tb = Math::muladd(Xb, u0a,      Xa * u0b) - u1b;
       // U1 = U0; U0 = real
       u1a = u0a; u0a = ta;
       u1b = u0b; u0b = tb;
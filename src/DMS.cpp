@@ -9,6 +9,9 @@
 
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <clocale>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional and enum-float expressions
@@ -19,22 +22,167 @@ namespace GeographicLib {
 
   using namespace std;
 
+#if GEOGRAPHICLIB_PRECISION <= 3
+  namespace {
+    // snprintf depends on LC_NUMERIC; only use it if the decimal point is a
+    // period.
+    bool cdecimalpoint() {
+      const char* p = localeconv()->decimal_point;
+      return p[0] == '.' && p[1] == '\0';
+    }
+    // Print x in fixed format with p digits after the decimal point (as
+    // ostream does with std::fixed and std::setprecision(p)).
+    int fixedstr(char buf[], int len, Math::real x, int p) {
+#  if GEOGRAPHICLIB_PRECISION == 2
+      // A fast exact method for nonnegative x with x * 10^p < 2^52.  With P =
+      // 10^p (exact), x * P = hi + lo exactly, where lo is obtained with fma.
+      // Round hi to the nearest integer r; this gives the correctly rounded
+      // result unless hi is half way between two integers in which case the
+      // sign of lo (or round-to-even, if lo = 0) decides.
+      static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18,
+      };
+      if (!signbit(x) && p >= 0 && p <= 18) {
+        double P = pow10[p], hi = x * P;
+        if (hi < 4503599627370496.0) { // 2^52
+          double lo = fma(x, P, -hi), r = nearbyint(hi), d = hi - r;
+          if (d == 0.5 && lo > 0)
+            r += 1;
+          else if (d == -0.5 && lo < 0)
+            r -= 1;
+          unsigned long long m = (unsigned long long)(r);
+          char t[24];           // the digits in reverse order
+          int nt = 0;
+          do {
+            t[nt++] = char('0' + m % 10); m /= 10;
+          } while (m || nt <= p);
+          int n = nt + (p > 0 ? 1 : 0);
+          if (n < len) {
+            char* q = buf;
+            for (int i = nt; i > 0; --i) {
+              if (i == p) *q++ = '.';
+              *q++ = t[i - 1];
+            }
+            *q = '\0';
+            return n;
+          }
+        }
+      }
+      return snprintf(buf, len, "%.*f", p, x);
+#  elif GEOGRAPHICLIB_PRECISION == 3
+      return snprintf(buf, len, "%.*Lf", p, x);
+#  else
+      return snprintf(buf, len, "%.*f", p, double(x));
+#  endif
+    }
+  }
+#endif
+
   const char* const DMS::hemispheres_ = "SNWE";
   const char* const DMS::signs_ = "-+";
   const char* const DMS::digits_ = "0123456789";
   const char* const DMS::dmsindicators_ = "D'\":";
   const char* const DMS::components_[] = {"degrees", "minutes", "seconds"};
 
-  // Replace all occurrences of pat by c.  If c is NULL remove pat.
-  void DMS::replace(std::string& s, const std::string& pat, char c) {
-    string::size_type p = 0;
-    int count = c ? 1 : 0;
-    while (true) {
-      p = s.find(pat, p);
-      if (p == string::npos)
+  // Replace the alternative symbols listed in Decode by their ASCII
+  // equivalents in a single pass.  Return false (with t unset) if there are no
+  // symbols to replace.
+  bool DMS::Normalize(const std::string& s, std::string& t) {
+    static const struct {
+      char pat[4];              // UTF-8 sequence
+      char c;                   // replacement ('\0' means remove)
+    } multi[] = {
+      {"\xc2\xb0",     'd' }, // U+00b0 degree symbol
+      {"\xc2\xba",     'd' }, // U+00ba alt symbol
+      {"\xe2\x81\xb0", 'd' }, // U+2070 sup zero
+      {"\xcb\x9a",     'd' }, // U+02da ring above
+      {"\xe2\x88\x98", 'd' }, // U+2218 compose function
+      {"\xe2\x80\xb2", '\''}, // U+2032 prime
+      {"\xe2\x80\xb5", '\''}, // U+2035 back prime
+      {"\xc2\xb4",     '\''}, // U+00b4 acute accent
+      {"\xe2\x80\x98", '\''}, // U+2018 left single quote
+      {"\xe2\x80\x99", '\''}, // U+2019 right single quote
+      {"\xe2\x80\x9b", '\''}, // U+201b reversed-9 single quote
+      {"\xca\xb9",     '\''}, // U+02b9 modifier letter prime
+      {"\xcb\x8a",     '\''}, // U+02ca modifier acute accent
+      {"\xcb\x8b",     '\''}, // U+02cb modifier grave accent
+      {"\xe2\x80\xb3", '"' }, // U+2033 double prime
+      {"\xe2\x80\xb6", '"' }, // U+2036 reversed double prime
+      {"\xcb\x9d",     '"' }, // U+02dd double acute accent
+      {"\xe2\x80\x9c", '"' }, // U+201c left double quote
+      {"\xe2\x80\x9d", '"' }, // U+201d right double quote
+      {"\xe2\x80\x9f", '"' }, // U+201f reversed-9 double quote
+      {"\xca\xba",     '"' }, // U+02ba modifier double prime
+      {"\xe2\x9e\x95", '+' }, // U+2795 heavy plus
+      {"\xe2\x81\xa4", '+' }, // U+2064 invisible plus
+      {"\xe2\x80\x90", '-' }, // U+2010 dash
+      {"\xe2\x80\x91", '-' }, // U+2011 non-breaking hyphen
+      {"\xe2\x80\x93", '-' }, // U+2013 en dash
+      {"\xe2\x80\x94", '-' }, // U+2014 em dash
+      {"\xe2\x88\x92", '-' }, // U+2212 minus sign
+      {"\xe2\x9e\x96", '-' }, // U+2796 heavy minus
+      {"\xc2\xa0",     '\0'}, // U+00a0 non-breaking space
+      {"\xe2\x80\x87", '\0'}, // U+2007 figure space
+      {"\xe2\x80\x89", '\0'}, // U+2007 thin space
+      {"\xe2\x80\x8a", '\0'}, // U+200a hair space
+      {"\xe2\x80\x8b", '\0'}, // U+200b invisible space
+      {"\xe2\x80\xaf", '\0'}, // U+202f narrow space
+      {"\xe2\x81\xa3", '\0'}, // U+2063 invisible separator
+    };
+    size_t n = s.size(), i = 0;
+    for (; i < n; ++i) {
+      char c = s[i];
+      if ((c & 0x80) || c == '*' || c == '`' || c == '\'')
         break;
-      s.replace(p, pat.length(), count, c);
     }
+    if (i == n) return false;
+    t.assign(s, 0, i);
+    t.reserve(n);
+    while (i < n) {
+      char c = s[i];
+      size_t len = 1;
+      bool keep = true;
+      if ((unsigned char)(c) >= 0xc0) {
+        // The patterns start with a lead byte and continue with continuation
+        // bytes, so they don't overlap each other or the bare symbols below.
+        for (const auto& m : multi) {
+          size_t l = strlen(m.pat);
+          if (s.compare(i, l, m.pat) == 0) {
+            c = m.c; len = l; keep = c != '\0';
+            break;
+          }
+        }
+      } else {
+        switch (c) {
+        case '\xb0':               // 0xb0 bare degree symbol
+        case '\xba':               // 0xba bare alt symbol
+        case '*':                  // GRiD symbol for degree
+          c = 'd'; break;
+        case '`':                  // grave accent
+        case '\xb4':               // 0xb4 bare acute accent
+          c = '\''; break;
+        case '\xa0':               // 0xa0 bare non-breaking space
+          keep = false; break;
+        // Don't implement these alternatives; they are only relevant for
+        // cgi-bin
+        // case '\x91':            // 0x91 ext ASCII left single quote
+        // case '\x92':            // 0x92 ext ASCII right single quote
+        // case '\x93':            // 0x93 ext ASCII left double quote
+        // case '\x94':            // 0x94 ext ASCII right double quote
+        // case '\x96':            // 0x96 ext ASCII en dash
+        // case '\x97':            // 0x97 ext ASCII em dash
+        default: break;
+        }
+      }
+      i += len;
+      if (!keep) continue;
+      if (c == '\'' && !t.empty() && t.back() == '\'')
+        t.back() = '"';         // '' -> "
+      else
+        t.push_back(c);
+    }
+    return true;
   }
 
   Math::real DMS::Decode(const std::string& dms, flag& ind) {
@@ -100,63 +248,10 @@ namespace GeographicLib {
     // « U+00ab    171  c2 ab      left guillemot (for cgi-bin)
     // » U+00bb    187  c2 bb      right guillemot (for cgi-bin)
 
-    string dmsa = dms;
-    replace(dmsa, "\xc2\xb0",     'd' ); // U+00b0 degree symbol
-    replace(dmsa, "\xc2\xba",     'd' ); // U+00ba alt symbol
-    replace(dmsa, "\xe2\x81\xb0", 'd' ); // U+2070 sup zero
-    replace(dmsa, "\xcb\x9a",     'd' ); // U+02da ring above
-    replace(dmsa, "\xe2\x88\x98", 'd' ); // U+2218 compose function
-
-    replace(dmsa, "\xe2\x80\xb2", '\''); // U+2032 prime
-    replace(dmsa, "\xe2\x80\xb5", '\''); // U+2035 back prime
-    replace(dmsa, "\xc2\xb4",     '\''); // U+00b4 acute accent
-    replace(dmsa, "\xe2\x80\x98", '\''); // U+2018 left single quote
-    replace(dmsa, "\xe2\x80\x99", '\''); // U+2019 right single quote
-    replace(dmsa, "\xe2\x80\x9b", '\''); // U+201b reversed-9 single quote
-    replace(dmsa, "\xca\xb9",     '\''); // U+02b9 modifier letter prime
-    replace(dmsa, "\xcb\x8a",     '\''); // U+02ca modifier letter acute accent
-    replace(dmsa, "\xcb\x8b",     '\''); // U+02cb modifier letter grave accent
-
-    replace(dmsa, "\xe2\x80\xb3", '"' ); // U+2033 double prime
-    replace(dmsa, "\xe2\x80\xb6", '"' ); // U+2036 reversed double prime
-    replace(dmsa, "\xcb\x9d",     '"' ); // U+02dd double acute accent
-    replace(dmsa, "\xe2\x80\x9c", '"' ); // U+201c left double quote
-    replace(dmsa, "\xe2\x80\x9d", '"' ); // U+201d right double quote
-    replace(dmsa, "\xe2\x80\x9f", '"' ); // U+201f reversed-9 double quote
-    replace(dmsa, "\xca\xba",     '"' ); // U+02ba modifier letter double prime
-
-    replace(dmsa, "\xe2\x9e\x95", '+' ); // U+2795 heavy plus
-    replace(dmsa, "\xe2\x81\xa4", '+' ); // U+2064 invisible plus
-
-    replace(dmsa, "\xe2\x80\x90", '-' ); // U+2010 dash
-    replace(dmsa, "\xe2\x80\x91", '-' ); // U+2011 non-breaking hyphen
-    replace(dmsa, "\xe2\x80\x93", '-' ); // U+2013 en dash
-    replace(dmsa, "\xe2\x80\x94", '-' ); // U+2014 em dash
-    replace(dmsa, "\xe2\x88\x92", '-' ); // U+2212 minus sign
-    replace(dmsa, "\xe2\x9e\x96", '-' ); // U+2796 heavy minus
-
-    replace(dmsa, "\xc2\xa0",     '\0'); // U+00a0 non-breaking space
-    replace(dmsa, "\xe2\x80\x87", '\0'); // U+2007 figure space
-    replace(dmsa, "\xe2\x80\x89", '\0'); // U+2007 thin space
-    replace(dmsa, "\xe2\x80\x8a", '\0'); // U+200a hair space
-    replace(dmsa, "\xe2\x80\x8b", '\0'); // U+200b invisible space
-    replace(dmsa, "\xe2\x80\xaf", '\0'); // U+202f narrow space
-    replace(dmsa, "\xe2\x81\xa3", '\0'); // U+2063 invisible separator
-
-    replace(dmsa, "\xb0",         'd' ); // 0xb0 bare degree symbol
-    replace(dmsa, "\xba",         'd' ); // 0xba bare alt symbol
-    replace(dmsa, "*",            'd' ); // GRiD symbol for degree
-    replace(dmsa, "`",            '\''); // grave accent
-    replace(dmsa, "\xb4",         '\''); // 0xb4 bare acute accent
-    // Don't implement these alternatives; they are only relevant for cgi-bin
-    // replace(dmsa, "\x91",      '\''); // 0x91 ext ASCII left single quote
-    // replace(dmsa, "\x92",      '\''); // 0x92 ext ASCII right single quote
-    // replace(dmsa, "\x93",      '"' ); // 0x93 ext ASCII left double quote
-    // replace(dmsa, "\x94",      '"' ); // 0x94 ext ASCII right double quote
-    // replace(dmsa, "\x96",      '-' ); // 0x96 ext ASCII en dash
-    // replace(dmsa, "\x97",      '-' ); // 0x97 ext ASCII em dash
-    replace(dmsa, "\xa0",         '\0'); // 0xa0 bare non-breaking space
-    replace(dmsa, "''",           '"' ); // '' -> "
+    // Normalize the string if it contains any of the alternative symbols;
+    // otherwise decode dms directly.
+    string norm;
+    const string& dmsa = Normalize(dms, norm) ? norm : dms;
     string::size_type
       beg = 0,
       end = unsigned(dmsa.size());
@@ -180,7 +275,7 @@ namespace GeographicLib {
       // Find next sign
       pb = min(dmsa.find_first_of(signs_, pa), end);
       flag ind2 = NONE;
-      v += InternalDecode(dmsa.substr(p, pb - p), ind2);
+      v += InternalDecode(dmsa, p, pb, ind2);
       if (ind1 == NONE)
         ind1 = ind2;
       else if (!(ind2 == NONE || ind1 == ind2))
@@ -194,13 +289,16 @@ namespace GeographicLib {
     return v;
   }
 
-  Math::real DMS::InternalDecode(const string& dmsa, flag& ind) {
+  Math::real DMS::InternalDecode(const string& dmsa,
+                                 string::size_type beg0,
+                                 string::size_type end0, flag& ind) {
+    // Decode the piece of dmsa in [beg0, end0)
     string errormsg;
     do {                       // Executed once (provides the ability to break)
       int sign = 1;
       unsigned
-        beg = 0,
-        end = unsigned(dmsa.size());
+        beg = unsigned(beg0),
+        end = unsigned(end0);
       flag ind1 = NONE;
       int k = -1;
       if (end > beg && (k = Utility::lookup(hemispheres_, dmsa[beg])) >= 0) {
@@ -234,7 +332,8 @@ namespace GeographicLib {
         }
       }
       if (end == beg) {
-        errormsg = "Empty or incomplete DMS string " + dmsa;
+        errormsg = "Empty or incomplete DMS string "
+          + dmsa.substr(beg0, end0 - beg0);
         break;
       }
       real ipieces[] = {0, 0, 0};
@@ -288,9 +387,9 @@ namespace GeographicLib {
             break;
           }
           if (digcount > 0) {
-            istringstream s(dmsa.substr(p - intcount - digcount - 1,
-                                        intcount + digcount));
-            s >> fcurrent;
+            fcurrent =
+              Utility::val<real>(dmsa.substr(p - intcount - digcount - 1,
+                                             intcount + digcount));
             icurrent = 0;
           }
           ipieces[k] = icurrent;
@@ -324,9 +423,8 @@ namespace GeographicLib {
           break;
         }
         if (digcount > 0) {
-          istringstream s(dmsa.substr(p - intcount - digcount,
-                                      intcount + digcount));
-          s >> fcurrent;
+          fcurrent = Utility::val<real>(dmsa.substr(p - intcount - digcount,
+                                                    intcount + digcount));
           icurrent = 0;
         }
         ipieces[npiece] = icurrent;
@@ -357,7 +455,7 @@ namespace GeographicLib {
           ( fpieces[1] != 0 ?
             (Math::dm*fpieces[0] + fpieces[1]) / Math::dm : fpieces[0] ) );
     } while (false);
-    real val = Utility::nummatch<real>(dmsa);
+    real val = Utility::nummatch<real>(dmsa.substr(beg0, end0 - beg0));
     if (val == 0)
       throw GeographicErr(errormsg);
     else
@@ -395,6 +493,18 @@ namespace GeographicLib {
     lon = lon1;
   }
 
+  void DMS::DecodeLatLon(size_t n, const string dmsa[], const string dmsb[],
+                         real lat[], real lon[], bool longfirst) {
+    for (size_t i = 0; i < n; ++i) {
+      try {
+        DecodeLatLon(dmsa[i], dmsb[i], lat[i], lon[i], longfirst);
+      }
+      catch (const GeographicErr& e) {
+        throw GeographicErr("Element " + to_string(i) + ": " + e.what());
+      }
+    }
+  }
+
   Math::real DMS::DecodeAngle(const string& angstr) {
     flag ind;
     real ang = Decode(angstr, ind);
@@ -415,6 +525,11 @@ namespace GeographicLib {
 
   string DMS::Encode(real angle, component trailing, unsigned prec, flag ind,
                      char dmssep) {
+    {
+      char buf[maxlen_];
+      int n = EncodeFast(buf, maxlen_, angle, trailing, prec, ind, dmssep);
+      if (n >= 0 && n < maxlen_) return string(buf, n);
+    }
     // Assume check on range of input angle has been made by calling
     // routine (which might be able to offer a better diagnostic).
     if (!isfinite(angle))
@@ -474,6 +589,9 @@ namespace GeographicLib {
       }
       break;
     }
+    // In the common case of a plain number, there's nothing to glue together
+    if (trailing == DEGREE && ind == NONE)
+      return sign < 0 ? '-' + degree : degree;
     // No glue together degree+minute+second with
     // sign + zero-fill + delimiters + hemisphere
     ostringstream str;
@@ -512,4 +630,134 @@ namespace GeographicLib {
     return str.str();
   }
 
+  int DMS::Encode(char buf[], int len, real angle, component trailing,
+                  unsigned prec, flag ind, char dmssep) {
+    int n = EncodeFast(buf, len, angle, trailing, prec, ind, dmssep);
+    if (n >= 0) return n;
+    string s = Encode(angle, trailing, prec, ind, dmssep);
+    if (len > 0) {
+      size_t m = min(s.size(), size_t(len - 1));
+      copy(s.begin(), s.begin() + m, buf);
+      buf[m] = '\0';
+    }
+    return int(s.size());
+  }
+
+  void DMS::Encode(size_t n, const real angle[], component trailing,
+                   unsigned prec, char buf[], int width, flag ind,
+                   char dmssep) {
+    for (size_t i = 0; i < n; ++i) {
+      int k = Encode(buf + i * width, width, angle[i], trailing, prec,
+                     ind, dmssep);
+      if (k >= width)
+        throw GeographicErr("Width " + to_string(width)
+                            + " too small for element " + to_string(i)
+                            + " which needs " + to_string(k + 1));
+    }
+  }
+
+  int DMS::EncodeFast(char buf[], int len, real angle, component trailing,
+                      unsigned prec, flag ind, char dmssep) {
+#if GEOGRAPHICLIB_PRECISION <= 3
+    // This follows the string version of Encode step by step except that the
+    // numbers are formatted with snprintf and the pieces are glued together
+    // directly into buf (mimicking the setfill('0') and setw manipulators).
+    // The result is the same as snprintf, the number of characters needed
+    // (excluding the trailing null); at most len - 1 of these are written to
+    // buf, followed by a null.  -1 is returned if this method can't be used.
+    if (!cdecimalpoint()) return -1;
+    struct writer {
+      char* buf; int len, n;
+      writer(char* b, int l) : buf(b), len(l), n(0) {}
+      void put(char c) { if (n < len - 1) buf[n] = c; ++n; }
+      void put(const char* s, int l) { for (int i = 0; i < l; ++i) put(s[i]); }
+      // Output the concatenation of s1 and s2 zero-filled to width w
+      void pad(int w, const char* s1, int l1, const char* s2 = "", int l2 = 0)
+      { for (w -= l1 + l2; w > 0; --w) put('0'); put(s1, l1); put(s2, l2); }
+      int finish() { if (len > 0) buf[min(n, len - 1)] = '\0'; return n; }
+    } w(buf, len);
+    if (!isfinite(angle)) {
+      w.put(angle < 0 ? "-inf" : (angle > 0 ? "inf" : "nan"),
+            angle < 0 ? 4 : 3);
+      return w.finish();
+    }
+    prec = min(15 + Math::extra_digits() - 2 * unsigned(trailing), prec);
+    real scale = trailing == MINUTE ? Math::dm :
+      (trailing == SECOND ? Math::ds : 1);
+    if (ind == AZIMUTH) {
+      angle = Math::AngNormalize(angle);
+      if (angle < 0)
+        angle += Math::td;
+      else
+        angle = Math::real(0) + angle;
+    }
+    int sign = signbit(angle) ? -1 : 1;
+    angle *= sign;
+    real
+      idegree = trailing == DEGREE ? 0 : floor(angle),
+      fdegree = (angle - idegree) * scale;
+    char s[maxlen_], degree[maxlen_], minute[4], second[4];
+    int ns = fixedstr(s, maxlen_, fdegree, int(prec)),
+      ndegree = 0, nminute = 0, nsecond = 0;
+    if (!(ns > 0 && ns < maxlen_)) return -1;
+    // The fractional part (including the decimal point) of the trailing
+    // component
+    const char* frac = s + ns;
+    if (trailing == DEGREE) {
+      copy(s, s + ns, degree); ndegree = ns;
+    } else {
+      const char* p = strchr(s, '.');
+      if (!p) p = s + ns;
+      long long i = p == s ? 0 : strtoll(s, nullptr, 10);
+      frac = p;
+      auto itoa2 = [](long long j, char t[]) -> int {
+        // j in [0, 60)
+        if (j < 10) { t[0] = char('0' + j); return 1; }
+        t[0] = char('0' + j / 10); t[1] = char('0' + j % 10); return 2;
+      };
+      if (trailing == MINUTE) {
+        nminute = itoa2(i % Math::dm, minute); i /= Math::dm;
+      } else {
+        nsecond = itoa2(i % Math::ms, second); i /= Math::ms;
+        nminute = itoa2(i % Math::dm, minute); i /= Math::dm;
+      }
+      ndegree = fixedstr(degree, maxlen_, i + idegree, 0);
+      if (!(ndegree > 0 && ndegree < maxlen_)) return -1;
+    }
+    int nfrac = int(s + ns - frac);
+    if (prec) ++prec;           // Extra width for decimal point
+    if (ind == NONE && sign < 0)
+      w.put('-');
+    int wdeg = ind != NONE ? 1 + min(int(ind), 2) : 0;
+    switch (trailing) {
+    case DEGREE:
+      w.pad(ind != NONE ? wdeg + int(prec) : 0, degree, ndegree);
+      break;
+    case MINUTE:
+      w.pad(wdeg, degree, ndegree);
+      w.put(dmssep ? dmssep : char(tolower(dmsindicators_[0])));
+      w.pad(2 + int(prec), minute, nminute, frac, nfrac);
+      if (!dmssep)
+        w.put(char(tolower(dmsindicators_[1])));
+      break;
+    default:                    // case SECOND:
+      w.pad(wdeg, degree, ndegree);
+      w.put(dmssep ? dmssep : char(tolower(dmsindicators_[0])));
+      w.pad(2, minute, nminute);
+      w.put(dmssep ? dmssep : char(tolower(dmsindicators_[1])));
+      w.pad(2 + int(prec), second, nsecond, frac, nfrac);
+      if (!dmssep)
+        w.put(char(tolower(dmsindicators_[2])));
+      break;
+    }
+    if (ind != NONE && ind != AZIMUTH)
+      w.put(hemispheres_[(ind == LATITUDE ? 0 : 2) + (sign < 0 ? 0 : 1)]);
+    return w.finish();
+#else
+    (void)buf; (void)len; (void)angle; (void)trailing; (void)prec; (void)ind;
+    (void)dmssep;
+    return -1;
+#endif
+  }
+
 } // namespace GeographicLib
@@ -10,15 +10,82 @@
 #include <GeographicLib/DST.hpp>
 #include <vector>
 
+#if !defined(GEOGRAPHICLIB_DST_FFTW)
+#define GEOGRAPHICLIB_DST_FFTW 0
+#endif
+
+#if GEOGRAPHICLIB_DST_FFTW
+#include <mutex>
+#include <fftw3.h>
+#  if GEOGRAPHICLIB_PRECISION == 1
+#    define GEOGRAPHICLIB_FFTW(x) fftwf_ ## x
+#  elif GEOGRAPHICLIB_PRECISION == 2
+#    define GEOGRAPHICLIB_FFTW(x) fftw_ ## x
+#  elif GEOGRAPHICLIB_PRECISION == 3
+#    define GEOGRAPHICLIB_FFTW(x) fftwl_ ## x
+#  else
+#    error "FFTW requires GEOGRAPHICLIB_PRECISION = 1, 2, or 3"
+#  endif
+#else
 #include "kissfft.hh"
+#endif
 
 namespace GeographicLib {
 
   using namespace std;
 
+#if GEOGRAPHICLIB_DST_FFTW
+  // A wrapper for a real FFTW plan with the same interface as the subset of
+  // kissfft used here.  transform_real(src, dst) with nfft = n takes 2*n real
+  // values in src and puts the transform in dst[0,n] (dst needs n + 1
+  // elements); only dst[1,n) are used by DST.  Only the planner is not thread
+  // safe in FFTW; so the plans are made under a lock.
+  class DST::fft_t {
+  private:
+    typedef GEOGRAPHICLIB_FFTW(complex) cpx_t;
+    GEOGRAPHICLIB_FFTW(plan) _plan;
+    static mutex& planlock() {
+      static mutex m;
+      return m;
+    }
+    void makeplan(size_t nfft) {
+      _plan = nullptr;
+      if (nfft == 0) return;
+      vector<real> in(2 * nfft);
+      vector<complex<real>> out(nfft + 1);
+      lock_guard<mutex> lock(planlock());
+      _plan = GEOGRAPHICLIB_FFTW(plan_dft_r2c_1d)
+        (int(2 * nfft), in.data(), reinterpret_cast<cpx_t*>(out.data()),
+         FFTW_ESTIMATE | FFTW_UNALIGNED);
+    }
+    void destroyplan() {
+      if (!_plan) return;
+      lock_guard<mutex> lock(planlock());
+      GEOGRAPHICLIB_FFTW(destroy_plan)(_plan);
+      _plan = nullptr;
+    }
+  public:
+    fft_t(size_t nfft, bool) { makeplan(nfft); }
+    ~fft_t() { destroyplan(); }
+    fft_t(const fft_t&) = delete;
+    fft_t& operator=(const fft_t&) = delete;
+    void assign(size_t nfft, bool) { destroyplan(); makeplan(nfft); }
+    void transform_real(const real src[], complex<real> dst[]) const {
+      if (_plan)
+        GEOGRAPHICLIB_FFTW(execute_dft_r2c)
+          (_plan, const_cast<real*>(src), reinterpret_cast<cpx_t*>(dst));
+    }
+  };
+#else
+  class DST::fft_t : public kissfft<Math::real> {
+  public:
+    fft_t(size_t nfft, bool inverse) : kissfft<real>(nfft, inverse) {}
+  };
+#endif
+
   DST::DST(int N)
     : _NN(N < 0 ? 0 : N)
-    , _fft(make_shared<fft_t>(fft_t(2 * _NN, false)))
+    , _fft(make_shared<fft_t>(2 * _NN, false))
   {}
 
   void DST::reset(int N) {
@@ -28,7 +95,8 @@ namespace GeographicLib {
     _fft->assign(2 * _NN, false);
   }
 
-  void DST::fft_transform(real data[], real F[], bool centerp) const {
+  void DST::fft_transform(real data[], real F[], bool centerp,
+                          complex<real> ctemp[]) const {
     // Implement DST-III (centerp = false) or DST-IV (centerp = true).
 
     // Elements (0,N], resp. [0,N), of data should be set on input for centerp
@@ -46,8 +114,7 @@ namespace GeographicLib {
       for (int i = 1; i < _NN; ++i) data[_NN+i] = data[_NN-i]; // set [N+1,2*N-1]
       for (int i = 0; i < 2*_NN; ++i) data[2*_NN+i] = -data[i]; // [2*N, 4*N-1]
     }
-    vector<complex<real>> ctemp(2*_NN);
-    _fft->transform_real(data, ctemp.data());
+    _fft->transform_real(data, ctemp);
     if (centerp) {
       real d = -Math::pi()/(4*_NN);
       for (int i = 0, j = 1; i < _NN; ++i, j+=2)
@@ -58,12 +125,13 @@ namespace GeographicLib {
     }
   }
 
-  void DST::fft_transform2(real data[], real F[]) const {
+  void DST::fft_transform2(real data[], real F[],
+                           complex<real> ctemp[]) const {
     // Elements [0,N), of data should be set to the N grid center values and F
     // should have size of at least 2*N.  On input elements [0,N) of F contain
     // the size N transform; on output elements [0,2*N) of F contain the size
     // 2*N transform.
-    fft_transform(data, F+_NN, true);
+    fft_transform(data, F+_NN, true, ctemp);
     // Copy DST-IV order N tx to [0,N) elements of data
     for (int i = 0; i < _NN; ++i) data[i] = F[i+_NN];
     for (int i = _NN; i < 2*_NN; ++i)
@@ -75,19 +143,50 @@ namespace GeographicLib {
   }
 
   void DST::transform(function<real(real)> f, real F[]) const {
-    vector<real> data(4 * _NN);
+    vector<real> work(WorkSize());
+    transform(f, F, work.data());
+  }
+
+  void DST::refine(function<real(real)> f, real F[]) const {
+    vector<real> work(WorkSize());
+    refine(f, F, work.data());
+  }
+
+  void DST::transform(function<real(real)> f, real F[], real work[]) const {
+    // work[0, 4*N) is the data and work[4*N, 8*N+2) holds 2*N+1 complex
+    // numbers.
+    real* data = work;
     real d = Math::pi()/(2 * _NN);
     for (int i = 1; i <= _NN; ++i)
       data[i] = f( i * d );
-    fft_transform(data.data(), F, false);
+    fft_transform(data, F, false,
+                  reinterpret_cast<complex<real>*>(work + 4 * _NN));
   }
 
-  void DST::refine(function<real(real)> f, real F[]) const {
-    vector<real> data(4 * _NN);
+  void DST::refine(function<real(real)> f, real F[], real work[]) const {
+    real* data = work;
     real d = Math::pi()/(4 * _NN);
     for (int i = 0; i < _NN; ++i)
       data[i] = f( (2*i + 1) * d );
-    fft_transform2(data.data(), F);
+    fft_transform2(data, F, reinterpret_cast<complex<real>*>(work + 4 * _NN));
+  }
+
+  void DST::transform_many(int count, const real samples[], real F[],
+                           real work[]) const {
+    if (count <= 0 || _NN == 0) return;
+    vector<real> owork;
+    if (!work) {
+      owork.resize(WorkSize());
+      work = owork.data();
+    }
+    real* data = work;
+    complex<real>* ctemp = reinterpret_cast<complex<real>*>(work + 4 * _NN);
+    for (int k = 0; k < count; ++k) {
+      // Copy the samples first in case samples == F
+      for (int i = 1; i <= _NN; ++i)
+        data[i] = samples[k * _NN + i - 1];
+      fft_transform(data, F + k * _NN, false, ctemp);
+    }
   }
 
   Math::real DST::eval(real sinx, real cosx, const real F[], int N) {
@@ -97,13 +196,7 @@ namespace GeographicLib {
     // Approx operation count = (N + 5) mult and (2 * N + 2) add
     real
       ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
-      y0 = N & 1 ? F[--N] : 0, y1 = 0;          // accumulators for sum
-    // Now N is even
-    while (N > 0) {
-      // Unroll loop x 2, so accumulators return to their original role
-      y1 = ar * y0 - y1 + F[--N];
-      y0 = ar * y1 - y0 + F[--N];
-    }
+      y1, y0 = Math::clenshaw(N, ar, F, y1);  // accumulators for sum
     return sinx * (y0 + y1);    // sin(x) * (y0 + y1)
   }
 
@@ -116,7 +209,7 @@ namespace GeographicLib {
       ar = 2 * (cosx - sinx) * (cosx + sinx), // 2 * cos(2 * x)
       y0 = 0, y1 = 0;                         // accumulators for sum
     for (--N; N >= 0; --N) {
-      real t = ar * y0 - y1 + F[N]/(2*N+1);
+      real t = Math::muladd(ar, y0, -y1) + F[N]/(2*N+1);
       y1 = y0; y0 = t;
     }
     return cosx * (y1 - y0);    // cos(x) * (y1 - y0)
@@ -0,0 +1,628 @@
+/**
+ * \file DoubleDouble.cpp
+ * \brief Implementation for GeographicLib::DoubleDouble class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/DoubleDouble.hpp>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  // Don't use "using namespace std" here; the functions for DoubleDouble
+  // defined in this file hide the standard functions for doubles, so
+  // the latter are always qualified with std::.
+
+  namespace {
+
+    typedef DoubleDouble DD;
+
+    // pi/2 = pio2 + pio2c and log(2) = ln2 + ln2c accurate to about 160 bits
+    constexpr DD pio2(1.5707963267948966, 6.123233995736766e-17);
+    const double pio2c = -1.4973849048591698e-33;
+    constexpr DD ln2(0.69314718055994529, 2.3190468138462996e-17);
+    const double ln2c = 5.7077084384162121e-34;
+    constexpr DD ln10(2.3025850929940459, -2.1707562233822494e-16);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    // Return x - k * (c + cc) where c + cc is an accurate representation of
+    // a constant.  The products of k with the components of c are computed
+    // exactly so that the result is accurate even if there's cancellation.
+    DD reduce(const DD& x, double k, const DD& c, double cc) {
+      if (k == 0) return x;
+      DD p = DD(c.hi()) * k, q = DD(c.lo()) * k;
+      return ((x - p) - q) - cc * k;
+    }
+
+    // The coefficients of the Taylor series and the table of sines and
+    // cosines used for the elementary functions; these are computed by the
+    // constructor (and so only once).
+    class coeffs {
+    public:
+      // expm1(x) = x + x^2/2! + ... + x^nexp/nexp!
+      static const int nexp = 12;
+      // sin(x) = x + x*sum(sinc[k] * x^(2*k+2), k = 0..nsin-1)
+      // cos(x) = 1 + sum(cosc[k] * x^(2*k+2), k = 0..nsin-1)
+      static const int nsin = 5;
+      // The table of sin and cos at the nodes, node[j] ~ j*pi/256 for j =
+      // 0..ntab; the values are for the nodes as represented.
+      static const int ntab = 64;
+      DD invfact[nexp + 1], sinc[nsin], cosc[nsin],
+        node[ntab + 1], sinnode[ntab + 1], cosnode[ntab + 1];
+      coeffs() {
+        double fact = 1;
+        invfact[0] = 1;
+        for (int n = 1; n <= nexp; ++n) {
+          fact *= n;            // exact
+          invfact[n] = DD(1) / fact;
+        }
+        fact = 1;
+        for (int k = 0; k < nsin; ++k) {
+          fact *= 2*k + 2;      // (2*k+2)!
+          cosc[k] = (k % 2 ? 1 : -1) / DD(fact);
+          fact *= 2*k + 3;      // (2*k+3)!
+          sinc[k] = (k % 2 ? 1 : -1) / DD(fact);
+        }
+        DD d = ldexp(pio2, -7);
+        for (int j = 0; j <= ntab; ++j) {
+          node[j] = d * double(j);
+          // Sum the Taylor series for node[j] <= pi/4 to full accuracy
+          DD x = node[j], x2 = x * x, s = x, c = 1, ts = x, tc = 1;
+          for (int k = 1; k < 40; ++k) {
+            tc *= -x2 / double((2*k - 1) * (2*k));
+            ts *= -x2 / double((2*k) * (2*k + 1));
+            c += tc; s += ts;
+            if (fabs(tc) < 1e-40) break;
+          }
+          sinnode[j] = s; cosnode[j] = c;
+        }
+      }
+    };
+
+    const coeffs& coeff() {
+      static const coeffs c;
+      return c;
+    }
+
+    // expm1(x) for |x| <= 0.35
+    DD expm1small(const DD& x) {
+      // Reduce the argument by 2^-k so that |t| < 0.0055, sum the Taylor
+      // series to the t^12 term, and undo the reduction with expm1(2*t) =
+      // expm1(t) * (expm1(t) + 2).  This preserves the relative accuracy
+      // for small x.
+      const int k = 6;
+      const coeffs& c = coeff();
+      DD t = ldexp(x, -k), p = c.invfact[coeffs::nexp];
+      for (int n = coeffs::nexp - 1; n > 0; --n)
+        p = p * t + c.invfact[n];
+      p *= t;
+      for (int i = 0; i < k; ++i)
+        p *= p + 2.0;
+      return p;
+    }
+
+    // log1p(x) for -0.3 < x < 0.42 by one Newton step starting with the
+    // double result for which |log1p(x)| < 0.35
+    DD log1psmall(const DD& x) {
+      DD y = std::log1p(x.hi()), e = expm1small(y);
+      return y - (e - x) / (e + 1.0);
+    }
+
+  }
+
+  /// \cond SKIP
+  long long DoubleDouble::toint() const {
+    DD t = trunc(*this);
+    return (long long)(t._hi) + (long long)(t._lo);
+  }
+  /// \endcond
+
+  DD cbrt(const DD& x) {
+    if (!(isfinite(x) && x != 0)) return std::cbrt(x.hi());
+    // Two Newton steps for y^3 = x; the second correction only needs to be
+    // computed with doubles.
+    DD y = std::cbrt(x.hi()), y2 = y * y;
+    y += (x - y2 * y) / (3.0 * y2);
+    return y + (x - y * y * y).hi() / (3 * y.hi() * y.hi());
+  }
+
+  DD exp(const DD& x) {
+    if (!(x.hi() <= 710)) return x.hi() > 0 ? inf : nan;
+    if (x.hi() < -746) return 0.0;
+    double k = std::floor(x.hi() / ln2.hi() + 0.5);
+    return ldexp(expm1small(reduce(x, k, ln2, ln2c)) + 1.0, int(k));
+  }
+
+  DD expm1(const DD& x) {
+    return fabs(x) <= 0.34 ? expm1small(x) : exp(x) - 1.0;
+  }
+
+  DD exp2(const DD& x) {
+    if (!(fabs(x) < 2200)) return exp(x * ln2);
+    // Split off the integer part (so that the result is exact for integer x)
+    // to avoid amplifying the error in the product with ln2.
+    DD n = nearbyint(x);
+    return ldexp(exp((x - n) * ln2), int(n.hi()));
+  }
+
+  DD log(const DD& x) {
+    if (!(x.hi() > 0 && x.hi() < inf))
+      return x.hi() == 0 ? -inf : (x.hi() == inf ? inf : nan);
+    int e;
+    DD m = frexp(x, &e);
+    if (m < 0.70710678118654752) { m = ldexp(m, 1); --e; }
+    // m in [sqrt(1/2), sqrt(2)) and m - 1 is exact
+    DD y = log1psmall(m - 1.0);
+    return e == 0 ? y : y + (ln2 * double(e) + ln2c * e);
+  }
+
+  DD log1p(const DD& x) {
+    if (fabs(x) < 0.29) return log1psmall(x);
+    return log(x + 1.0);
+  }
+
+  DD log2(const DD& x) {
+    int e;
+    // Return exact results for powers of 2
+    if (x.hi() > 0 && x.hi() < inf && frexp(x, &e) == 0.5) return e - 1;
+    return log(x) / ln2;
+  }
+
+  DD log10(const DD& x) {
+    return log(x) / ln10;
+  }
+
+  DD pow(const DD& x, const DD& y) {
+    if (y == 0) return 1;
+    if (isnan(x) || isnan(y)) return nan;
+    if (isfinite(x) && y == floor(y) && fabs(y) < 2147483648.0) {
+      // Integer powers by repeated squaring
+      long long n = (long long)(fabs(y));
+      DD r = 1, b = x;
+      for (; n; n >>= 1) {
+        if (n & 1) r *= b;
+        if (n > 1) b *= b;
+      }
+      return y < 0 ? 1 / r : r;
+    }
+    if (isinf(y)) {
+      DD ax = fabs(x);
+      return ax == 1 ? DD(1) : ((ax > 1) == (y > 0) ? inf : 0.0);
+    }
+    if (x < 0) return nan;
+    if (x == 0) return y > 0 ? 0.0 : inf;
+    if (isinf(x)) return y > 0 ? inf : 0.0;
+    return exp(y * log(x));
+  }
+
+  void DoubleDouble::sincos(const DD& x, DD& sinx, DD& cosx) {
+    if (!isfinite(x)) { sinx = cosx = nan; return; }
+    if (x == 0) { sinx = x; cosx = 1; return; }
+    const coeffs& c = coeff();
+    // Reduce to |r| <= pi/4 in quadrant q
+    double k = std::floor(x.hi() / pio2.hi() + 0.5);
+    DD r = reduce(x, k, pio2, pio2c);
+    // Reduce further to r = node[j] + u with |u| <= pi/512 approx
+    // (Copy ntab so that std::min and std::max don't take its address.)
+    const int n = coeffs::ntab;
+    int j = int(std::floor(r.hi() * (128 / pio2.hi()) + 0.5));
+    j = std::max(-n, std::min(n, j));
+    DD u = j < 0 ? r + c.node[-j] : r - c.node[j], u2 = u * u,
+      ps = c.sinc[coeffs::nsin - 1], pc = c.cosc[coeffs::nsin - 1];
+    for (int i = coeffs::nsin - 1; i-- > 0;) {
+      ps = ps * u2 + c.sinc[i];
+      pc = pc * u2 + c.cosc[i];
+    }
+    DD s = u + u * u2 * ps, co = 1.0 + u2 * pc;
+    if (j != 0) {
+      DD sa = j < 0 ? -c.sinnode[-j] : c.sinnode[j],
+        ca = c.cosnode[j < 0 ? -j : j],
+        t = sa * co + ca * s;
+      co = ca * co - sa * s;
+      s = t;
+    }
+    double q = std::fmod(k, 4.0);
+    switch (int(q < 0 ? q + 4 : q)) {
+    case 0: sinx =  s; cosx =  co; break;
+    case 1: sinx = co; cosx = -s ; break;
+    case 2: sinx = -s; cosx = -co; break;
+    default: sinx = -co; cosx = s; break;
+    }
+  }
+
+  DD sin(const DD& x) {
+    DD s, c; DD::sincos(x, s, c);
+    return s;
+  }
+
+  DD cos(const DD& x) {
+    DD s, c; DD::sincos(x, s, c);
+    return c;
+  }
+
+  DD tan(const DD& x) {
+    DD s, c; DD::sincos(x, s, c);
+    return s / c;
+  }
+
+  DD atan2(const DD& y, const DD& x) {
+    if (isnan(x) || isnan(y)) return nan;
+    double z = std::atan2(y.hi(), x.hi());
+    if (x == 0 || y == 0 || isinf(x) || isinf(y))
+      // The result is a multiple of pi/4
+      return z == 0 ? DD(z) :
+        ldexp(pio2, -1) * std::floor(z / (pio2.hi() / 2) + 0.5);
+    // Scale x and y to avoid underflow in the correction
+    int e;
+    std::frexp(std::max(std::fabs(x.hi()), std::fabs(y.hi())), &e);
+    DD xs = ldexp(x, -e), ys = ldexp(y, -e), s, c;
+    DD::sincos(DD(z), s, c);
+    // One step of Newton's method; tan(theta - z) = (y*c - x*s)/(x*c + y*s)
+    return z + (ys * c - xs * s) / (xs * c + ys * s);
+  }
+
+  DD atan(const DD& x) { return atan2(x, DD(1)); }
+
+  DD asin(const DD& x) {
+    return fabs(x) > 1 ? DD(nan) : atan2(x, sqrt((1.0 - x) * (1.0 + x)));
+  }
+
+  DD acos(const DD& x) {
+    return fabs(x) > 1 ? DD(nan) : atan2(sqrt((1.0 - x) * (1.0 + x)), x);
+  }
+
+  DD sinh(const DD& x) {
+    DD ax = fabs(x), r;
+    if (ax > 40)
+      r = exp(ax - ln2);
+    else {
+      DD e = expm1(ax);
+      r = ldexp(e + e / (e + 1.0), -1);
+    }
+    return copysign(r, x);
+  }
+
+  DD cosh(const DD& x) {
+    DD ax = fabs(x);
+    if (ax > 40) return exp(ax - ln2);
+    DD e = exp(ax);
+    return ldexp(e + 1 / e, -1);
+  }
+
+  DD tanh(const DD& x) {
+    DD ax = fabs(x), r;
+    if (ax > 40)
+      r = 1;
+    else {
+      DD e = expm1(ldexp(ax, 1));
+      r = e / (e + 2.0);
+    }
+    return copysign(r, x);
+  }
+
+  DD asinh(const DD& x) {
+    DD ax = fabs(x), r;
+    if (ax > 1e20)
+      r = log(ax) + ln2;
+    else
+      r = log1p(ax + ax * ax / (1.0 + hypot(DD(1), ax)));
+    return copysign(r, x);
+  }
+
+  DD acosh(const DD& x) {
+    if (!(x >= 1)) return nan;
+    if (x > 1e20) return log(x) + ln2;
+    DD y = x - 1.0;
+    return log1p(y + sqrt(y * (x + 1.0)));
+  }
+
+  DD atanh(const DD& x) {
+    DD ax = fabs(x);
+    if (!(ax <= 1)) return nan;
+    DD r = ax == 1 ? DD(inf) : ldexp(log1p(2.0 * ax / (1.0 - ax)), -1);
+    return copysign(r, x);
+  }
+
+  DD remquo(const DD& x, const DD& y, int* q) {
+    *q = 0;
+    if (!isfinite(x) || isnan(y) || y == 0) return nan;
+    if (isinf(y)) return x;
+    DD ay = fabs(y), r = fabs(x);
+    unsigned n = 0;
+    // Reduce r to [0, ay) keeping track of the low bits of the quotient; r -
+    // m * ay is exact provided that m * ay is exact, e.g., if m and ay are
+    // representable as doubles.
+    while (r >= ay) {
+      DD m = floor(r / ay);
+      if (m == 0) m = 1;
+      DD t = r - m * ay;
+      while (t < 0) { t += ay; m -= 1.0; }
+      n += unsigned(int(std::fmod(m.hi(), 1073741824.0)) +
+                    int(std::fmod(m.lo(), 1073741824.0)));
+      r = t;
+    }
+    DD r2 = ldexp(r, 1);
+    if (r2 > ay || (r2 == ay && (n & 1U))) { r -= ay; ++n; }
+    n &= 0x3fffffffU;
+    *q = signbit(x) == signbit(y) ? int(n) : -int(n);
+    return r == 0 ? copysign(r, x) : (signbit(x) ? -r : r);
+  }
+
+  DD fmod(const DD& x, const DD& y) {
+    if (!isfinite(x) || isnan(y) || y == 0) return nan;
+    if (isinf(y)) return x;
+    DD ay = fabs(y), r = fabs(x);
+    while (r >= ay) {
+      DD m = floor(r / ay);
+      if (m == 0) m = 1;
+      DD t = r - m * ay;
+      while (t < 0) t += ay;
+      r = t;
+    }
+    return copysign(r, x);
+  }
+
+  namespace {
+
+    // return x * 10^n
+    DD scale10(DD x, int n) {
+      // 10^m for m <= 45 is exact
+      const int mmax = 45;
+      while (n != 0) {
+        int m = std::min(std::abs(n), mmax);
+        DD p = 10.0;
+        for (int i = 1; i < m; ++i) p *= 10.0;
+        if (n > 0) { x *= p; n -= m; } else { x /= p; n += m; }
+      }
+      return x;
+    }
+
+  }
+
+  std::string DoubleDouble::str(const DD& x, int prec,
+                                std::ios_base::fmtflags flags) {
+    typedef std::ios_base io;
+    bool upper = (flags & io::uppercase) != 0,
+      showpoint = (flags & io::showpoint) != 0,
+      fixed = (flags & io::floatfield) == io::fixed,
+      sci = (flags & io::floatfield) == io::scientific;
+    std::string sign(signbit(x) ? "-" : ((flags & io::showpos) ? "+" : ""));
+    if (isnan(x)) return sign + (upper ? "NAN" : "nan");
+    if (isinf(x)) return sign + (upper ? "INF" : "inf");
+    if (prec < 0) prec = 6;
+    if (!fixed && !sci && prec == 0) prec = 1;
+    DD t = fabs(x);
+    // Normalize so that t = x * 10^-e10 is in [1, 10)
+    int e10 = 0;
+    if (t != 0) {
+      e10 = int(std::floor(std::log10(t.hi())));
+      // Avoid overflow of 10^-e10 for subnormal t
+      t = e10 < -300 ? scale10(scale10(t, 300), -e10 - 300) : scale10(t, -e10);
+      if (t >= 10) { t /= 10.0; ++e10; } else if (t < 1) { t *= 10.0; --e10; }
+    }
+    // The number of digits needed and the number computed
+    int nd = fixed ? e10 + 1 + prec : (sci ? prec + 1 : prec),
+      nc = std::min(nd, 34);
+    std::string d;
+    if (nd <= 0) {
+      // Fixed format for a number below the last digit position
+      // (round to nearest, ties to even, so 0.5 -> 0)
+      if (nd == 0 && t > 5) { d = "1"; ++e10; } else e10 = -prec;
+    } else {
+      for (int i = 0; i < nc; ++i) {
+        DD f = floor(t);
+        int k = std::max(0, std::min(9, int(f.hi())));
+        d += char('0' + k);
+        t = (t - double(k)) * 10.0;
+      }
+      // Round to nearest, ties to even
+      if (t > 5 || (t == 5 && (d.back() - '0') % 2 == 1)) {
+        int i = nc - 1;
+        for (; i >= 0 && d[i] == '9'; --i) d[i] = '0';
+        if (i >= 0)
+          ++d[i];
+        else {
+          d.insert(0, 1, '1'); ++e10;
+          // In fixed format, the extra digit is in the integer part
+          if (!fixed) d.erase(d.size() - 1);
+        }
+      }
+      d.append(std::max(0, int(fixed ? e10 + 1 + prec : nd) -
+                        int(d.size())), '0');
+    }
+    if (nd <= 0 && d.empty()) d = std::string(std::max(1, prec), '0');
+    // Now put the pieces together
+    std::string r;
+    bool usefixed = fixed || (!sci && prec > e10 && e10 >= -4);
+    if (usefixed) {
+      int p = fixed ? prec : prec - 1 - e10,
+        lead = e10 < 0 ? -e10 - 1 : 0;
+      std::string ip, fp;
+      if (e10 >= 0) {
+        ip = d.substr(0, e10 + 1);
+        fp = d.substr(e10 + 1);
+      } else {
+        ip = "0";
+        fp = std::string(lead, '0') + d;
+      }
+      fp = fp.substr(0, p);
+      if (nd <= 0 && !(d == "1" && e10 > -prec)) {
+        ip = d == "1" && prec == 0 ? "1" : "0";
+        fp = std::string(prec, '0');
+        if (d == "1" && prec > 0) fp[prec - 1] = '1';
+      }
+      if (!fixed && !showpoint) {
+        std::string::size_type n = fp.find_last_not_of('0');
+        fp = n == std::string::npos ? "" : fp.substr(0, n + 1);
+      }
+      r = ip + (fp.empty() && !showpoint ? "" : "." + fp);
+    } else {
+      std::string fp = d.substr(1, fixed || sci ? prec : prec - 1);
+      if (!sci && !showpoint) {
+        std::string::size_type n = fp.find_last_not_of('0');
+        fp = n == std::string::npos ? "" : fp.substr(0, n + 1);
+      }
+      int ae = std::abs(e10);
+      r = d.substr(0, 1) + (fp.empty() && !showpoint ? "" : "." + fp) +
+        (upper ? 'E' : 'e') + (e10 < 0 ? '-' : '+') +
+        (ae < 10 ? "0" : "") + std::to_string(ae);
+    }
+    return sign + r;
+  }
+
+  DD DoubleDouble::parse(const std::string& s, std::size_t& n) {
+    std::size_t i = 0, len = s.size();
+    n = 0;
+    bool neg = false;
+    if (i < len && (s[i] == '+' || s[i] == '-')) neg = s[i++] == '-';
+    {
+      // Match nan, inf, infinity
+      std::string t;
+      for (std::size_t k = i; k < len && k < i + 8; ++k)
+        t += char(std::tolower(static_cast<unsigned char>(s[k])));
+      if (t.compare(0, 3, "nan") == 0) { n = i + 3; return nan; }
+      if (t.compare(0, 8, "infinity") == 0)
+        { n = i + 8; return neg ? -inf : inf; }
+      if (t.compare(0, 3, "inf") == 0) { n = i + 3; return neg ? -inf : inf; }
+    }
+    // Accumulate up to 34 significant digits in m; the rest only affect the
+    // exponent.
+    DD m = 0;
+    int nsig = 0, e = 0;
+    bool digits = false, point = false;
+    for (; i < len; ++i) {
+      char c = s[i];
+      if (c >= '0' && c <= '9') {
+        digits = true;
+        if (nsig < 34) {
+          m = m * 10.0 + double(c - '0');
+          if (m != 0) ++nsig;
+          if (point) --e;
+        } else if (!point)
+          ++e;
+      } else if (c == '.' && !point)
+        point = true;
+      else
+        break;
+    }
+    if (!digits) return nan;
+    n = i;
+    if (i < len && (s[i] == 'e' || s[i] == 'E')) {
+      std::size_t k = i + 1;
+      bool eneg = false;
+      if (k < len && (s[k] == '+' || s[k] == '-')) eneg = s[k++] == '-';
+      if (k < len && s[k] >= '0' && s[k] <= '9') {
+        int x = 0;
+        for (; k < len && s[k] >= '0' && s[k] <= '9'; ++k)
+          if (x < 100000) x = 10 * x + (s[k] - '0');
+        e += eneg ? -x : x;
+        n = k;
+      }
+    }
+    if (m != 0) {
+      // Avoid premature overflow or underflow of the power of 10
+      if (e > 340 || e < -360)
+        m = e > 0 ? DD(inf) : DD(0);
+      else if (e < -300) {
+        m = scale10(scale10(m, e + 300), -300);
+      } else
+        m = scale10(m, e);
+    }
+    return neg ? -m : m;
+  }
+
+  std::ostream& operator<<(std::ostream& os, const DD& x) {
+    return os << DD::str(x, int(os.precision()), os.flags());
+  }
+
+  std::istream& operator>>(std::istream& is, DD& x) {
+    std::istream::sentry ok(is);
+    if (!ok) return is;
+    // Collect the characters which can form a number
+    std::string s;
+    bool digits = false, point = false, expo = false, word = false;
+    for (;;) {
+      int c = is.peek();
+      if (c == std::char_traits<char>::eof()) break;
+      char ch = char(c), lc = char(std::tolower(c));
+      bool take;
+      if (word) {
+        std::string t = s + lc;
+        if (t[0] == '+' || t[0] == '-') t = t.substr(1);
+        take = std::string("infinity").compare(0, t.size(), t) == 0 ||
+          std::string("nan").compare(0, t.size(), t) == 0;
+      } else if (ch >= '0' && ch <= '9')
+        take = digits = true;
+      else if (ch == '+' || ch == '-')
+        take = s.empty() || (expo && (s.back() == 'e' || s.back() == 'E'));
+      else if (ch == '.')
+        take = !point && !expo && (point = true);
+      else if (lc == 'e' && digits && !expo)
+        take = expo = true;
+      else if ((lc == 'i' || lc == 'n') && !digits && !point)
+        take = word = true;
+      else
+        take = false;
+      if (!take) break;
+      s += word ? lc : ch;
+      is.get();
+    }
+    std::size_t n;
+    DD v = DD::parse(s, n);
+    if (n == 0 || n != s.size()) {
+      x = 0;
+      is.setstate(std::ios_base::failbit);
+    } else if (isinf(v) && !word) {
+      // Overflow is treated as for doubles
+      x = v < 0 ? std::numeric_limits<DD>::lowest() :
+        std::numeric_limits<DD>::max();
+      is.setstate(std::ios_base::failbit);
+    } else
+      x = v;
+    return is;
+  }
+
+} // namespace GeographicLib
+
+// Definitions of the static constexpr members of numeric_limits needed by
+// C++11
+namespace std {
+
+  /// \cond SKIP
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_specialized;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::digits;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::digits10;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::max_digits10;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_signed;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_integer;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_exact;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::radix;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::min_exponent;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::min_exponent10;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::max_exponent;
+  constexpr int numeric_limits<GeographicLib::DoubleDouble>::max_exponent10;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::has_infinity;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::has_quiet_NaN;
+  constexpr bool
+  numeric_limits<GeographicLib::DoubleDouble>::has_signaling_NaN;
+  constexpr float_denorm_style
+  numeric_limits<GeographicLib::DoubleDouble>::has_denorm;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::has_denorm_loss;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_iec559;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_bounded;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::is_modulo;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::traps;
+  constexpr bool numeric_limits<GeographicLib::DoubleDouble>::tinyness_before;
+  constexpr float_round_style
+  numeric_limits<GeographicLib::DoubleDouble>::round_style;
+  /// \endcond
+
+} // namespace std
@@ -30,6 +30,7 @@ namespace GeographicLib {
     , _aux(_a, _f)
     , _rm(_aux.RectifyingRadius(true))
     , _c2(_aux.AuthalicRadiusSquared(true))
+    , _series(fabs(_f) <= 1/real(150))
   {}
   /// \endcond
 
@@ -126,6 +127,70 @@ namespace GeographicLib {
                               true).radians();
   }
 
+  void Ellipsoid::Convert(int auxin, int auxout, size_t n,
+                          const real zeta[], real eta[]) const {
+    // Follow the advice in AuxLatitude: use the series for conversions
+    // involving mu, chi, or xi if abs(f) <= 1/150.
+    if (_series &&
+        (auxin == AuxLatitude::MU || auxin == AuxLatitude::CHI ||
+         auxin == AuxLatitude::XI ||
+         auxout == AuxLatitude::MU || auxout == AuxLatitude::CHI ||
+         auxout == AuxLatitude::XI)) {
+      for (size_t i = 0; i < n; ++i)
+        eta[i] = Math::LatFix(zeta[i]);
+      _aux.Convert(auxin, auxout, n, eta, eta);
+    } else
+      for (size_t i = 0; i < n; ++i)
+        eta[i] = _aux.Convert(auxin, auxout, Math::LatFix(zeta[i]), true);
+  }
+
+  void Ellipsoid::ParametricLatitude(size_t n, const real phi[], real beta[])
+    const
+  { Convert(AuxLatitude::PHI, AuxLatitude::BETA, n, phi, beta); }
+
+  void Ellipsoid::InverseParametricLatitude(size_t n, const real beta[],
+                                            real phi[]) const
+  { Convert(AuxLatitude::BETA, AuxLatitude::PHI, n, beta, phi); }
+
+  void Ellipsoid::GeocentricLatitude(size_t n, const real phi[], real theta[])
+    const
+  { Convert(AuxLatitude::PHI, AuxLatitude::THETA, n, phi, theta); }
+
+  void Ellipsoid::InverseGeocentricLatitude(size_t n, const real theta[],
+                                            real phi[]) const
+  { Convert(AuxLatitude::THETA, AuxLatitude::PHI, n, theta, phi); }
+
+  void Ellipsoid::RectifyingLatitude(size_t n, const real phi[], real mu[])
+    const
+  { Convert(AuxLatitude::PHI, AuxLatitude::MU, n, phi, mu); }
+
+  void Ellipsoid::InverseRectifyingLatitude(size_t n, const real mu[],
+                                            real phi[]) const
+  { Convert(AuxLatitude::MU, AuxLatitude::PHI, n, mu, phi); }
+
+  void Ellipsoid::AuthalicLatitude(size_t n, const real phi[], real xi[])
+    const
+  { Convert(AuxLatitude::PHI, AuxLatitude::XI, n, phi, xi); }
+
+  void Ellipsoid::InverseAuthalicLatitude(size_t n, const real xi[],
+                                          real phi[]) const
+  { Convert(AuxLatitude::XI, AuxLatitude::PHI, n, xi, phi); }
+
+  void Ellipsoid::ConformalLatitude(size_t n, const real phi[], real chi[])
+    const
+  { Convert(AuxLatitude::PHI, AuxLatitude::CHI, n, phi, chi); }
+
+  void Ellipsoid::InverseConformalLatitude(size_t n, const real chi[],
+                                           real phi[]) const
+  { Convert(AuxLatitude::CHI, AuxLatitude::PHI, n, chi, phi); }
+
+  void Ellipsoid::MeridianDistance(size_t n, const real phi[], real s[])
+    const {
+    RectifyingLatitude(n, phi, s);
+    for (size_t i = 0; i < n; ++i)
+      s[i] *= _rm * Math::degree();
+  }
+
   Math::real Ellipsoid::MeridionalCurvatureRadius(real phi) const {
     real v = 1 - _e2 * Math::_sq(Math::sind(Math::LatFix(phi)));
     return _a * (1 - _e2) / (v * sqrt(v));
@@ -223,6 +223,220 @@ namespace GeographicLib {
       (4084080 * mul * An * sqrt(An)) + 3 * s;
   }
 
+  // The batch versions of RF, RD, and RJ run the duplication steps of
+  // blocksize_ points in lock step.  Points which have converged are frozen
+  // so that the results are the same as for the scalar versions.  The
+  // independent chains of square roots in a block can then overlap in the
+  // processor pipeline.
+  template<int n>
+  void EllipticFunction::RFBlock(const real x[], const real y[],
+                                 const real z[], real F[]) {
+    static const real tolRF =
+      pow(3 * numeric_limits<real>::epsilon() * real(0.01), 1/real(8));
+    real A0[n], An[n], Q[n], x0[n], y0[n], z0[n], mul[n];
+    bool act[n];
+    for (int j = 0; j < n; ++j) {
+      A0[j] = An[j] = (x[j] + y[j] + z[j])/3;
+      Q[j] = fmax(fmax(fabs(A0[j]-x[j]), fabs(A0[j]-y[j])),
+                  fabs(A0[j]-z[j])) / tolRF;
+      x0[j] = x[j]; y0[j] = y[j]; z0[j] = z[j];
+      mul[j] = 1;
+    }
+    for (;;) {
+      bool any = false;
+      for (int j = 0; j < n; ++j)
+        any = (act[j] = Q[j] >= mul[j] * fabs(An[j])) || any;
+      if (!any) break;
+      for (int j = 0; j < n; ++j) {
+        if (!act[j]) continue;
+        real lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+          sqrt(z0[j])*sqrt(x0[j]);
+        An[j] = (An[j] + lam)/4;
+        x0[j] = (x0[j] + lam)/4;
+        y0[j] = (y0[j] + lam)/4;
+        z0[j] = (z0[j] + lam)/4;
+        mul[j] *= 4;
+      }
+    }
+    for (int j = 0; j < n; ++j) {
+      real
+        X = (A0[j] - x[j]) / (mul[j] * An[j]),
+        Y = (A0[j] - y[j]) / (mul[j] * An[j]),
+        Z = - (X + Y),
+        E2 = X*Y - Z*Z,
+        E3 = X*Y*Z;
+      F[j] = (E3 * (6930 * E3 + E2 * (15015 * E2 - 16380) + 17160) +
+              E2 * ((10010 - 5775 * E2) * E2 - 24024) + 240240) /
+        (240240 * sqrt(An[j]));
+    }
+  }
+
+  template<int n>
+  void EllipticFunction::RDBlock(const real x[], const real y[],
+                                 const real z[], real D[]) {
+    static const real
+      tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
+                  1/real(8));
+    real A0[n], An[n], Q[n], x0[n], y0[n], z0[n], mul[n], s[n];
+    bool act[n];
+    for (int j = 0; j < n; ++j) {
+      A0[j] = An[j] = (x[j] + y[j] + 3*z[j])/5;
+      Q[j] = fmax(fmax(fabs(A0[j]-x[j]), fabs(A0[j]-y[j])),
+                  fabs(A0[j]-z[j])) / tolRD;
+      x0[j] = x[j]; y0[j] = y[j]; z0[j] = z[j];
+      mul[j] = 1; s[j] = 0;
+    }
+    for (;;) {
+      bool any = false;
+      for (int j = 0; j < n; ++j)
+        any = (act[j] = Q[j] >= mul[j] * fabs(An[j])) || any;
+      if (!any) break;
+      for (int j = 0; j < n; ++j) {
+        if (!act[j]) continue;
+        real lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+          sqrt(z0[j])*sqrt(x0[j]);
+        s[j] += 1/(mul[j] * sqrt(z0[j]) * (z0[j] + lam));
+        An[j] = (An[j] + lam)/4;
+        x0[j] = (x0[j] + lam)/4;
+        y0[j] = (y0[j] + lam)/4;
+        z0[j] = (z0[j] + lam)/4;
+        mul[j] *= 4;
+      }
+    }
+    for (int j = 0; j < n; ++j) {
+      real
+        X = (A0[j] - x[j]) / (mul[j] * An[j]),
+        Y = (A0[j] - y[j]) / (mul[j] * An[j]),
+        Z = -(X + Y) / 3,
+        E2 = X*Y - 6*Z*Z,
+        E3 = (3*X*Y - 8*Z*Z)*Z,
+        E4 = 3 * (X*Y - Z*Z) * Z*Z,
+        E5 = X*Y*Z*Z*Z;
+      D[j] = ((471240 - 540540 * E2) * E5 +
+              (612612 * E2 - 540540 * E3 - 556920) * E4 +
+              E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) + 680680) +
+              E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
+        (4084080 * mul[j] * An[j] * sqrt(An[j])) + 3 * s[j];
+    }
+  }
+
+  template<int n>
+  void EllipticFunction::RJBlock(const real x[], const real y[],
+                                 const real z[], const real p[], real J[]) {
+    static const real
+      tolRD = pow(real(0.2) * (numeric_limits<real>::epsilon() * real(0.01)),
+                  1/real(8));
+    real A0[n], An[n], delta[n], Q[n], x0[n], y0[n], z0[n], p0[n],
+      mul[n], mul3[n], s[n];
+    bool act[n];
+    for (int j = 0; j < n; ++j) {
+      A0[j] = An[j] = (x[j] + y[j] + z[j] + 2*p[j])/5;
+      delta[j] = (p[j]-x[j]) * (p[j]-y[j]) * (p[j]-z[j]);
+      Q[j] = fmax(fmax(fabs(A0[j]-x[j]), fabs(A0[j]-y[j])),
+                  fmax(fabs(A0[j]-z[j]), fabs(A0[j]-p[j]))) / tolRD;
+      x0[j] = x[j]; y0[j] = y[j]; z0[j] = z[j]; p0[j] = p[j];
+      mul[j] = 1; mul3[j] = 1; s[j] = 0;
+    }
+    for (;;) {
+      bool any = false;
+      for (int j = 0; j < n; ++j)
+        any = (act[j] = Q[j] >= mul[j] * fabs(An[j])) || any;
+      if (!any) break;
+      real d0[n], e0[n];
+      for (int j = 0; j < n; ++j) {
+        if (!act[j]) continue;
+        real
+          lam = sqrt(x0[j])*sqrt(y0[j]) + sqrt(y0[j])*sqrt(z0[j]) +
+          sqrt(z0[j])*sqrt(x0[j]);
+        d0[j] = (sqrt(p0[j])+sqrt(x0[j])) * (sqrt(p0[j])+sqrt(y0[j])) *
+          (sqrt(p0[j])+sqrt(z0[j]));
+        e0[j] = delta[j]/(mul3[j] * Math::_sq(d0[j]));
+        An[j] = (An[j] + lam)/4;
+        x0[j] = (x0[j] + lam)/4;
+        y0[j] = (y0[j] + lam)/4;
+        z0[j] = (z0[j] + lam)/4;
+        p0[j] = (p0[j] + lam)/4;
+      }
+      // The calls to RC (which evaluate atan or asinh) are done separately
+      for (int j = 0; j < n; ++j) {
+        if (!act[j]) continue;
+        s[j] += RC(1, 1 + e0[j])/(mul[j] * d0[j]);
+        mul[j] *= 4;
+        mul3[j] *= 64;
+      }
+    }
+    for (int j = 0; j < n; ++j) {
+      real
+        X = (A0[j] - x[j]) / (mul[j] * An[j]),
+        Y = (A0[j] - y[j]) / (mul[j] * An[j]),
+        Z = (A0[j] - z[j]) / (mul[j] * An[j]),
+        P = -(X + Y + Z) / 2,
+        E2 = X*Y + X*Z + Y*Z - 3*P*P,
+        E3 = X*Y*Z + 2*P * (E2 + 2*P*P),
+        E4 = (2*X*Y*Z + P * (E2 + 3*P*P)) * P,
+        E5 = X*Y*Z*P*P;
+      J[j] = ((471240 - 540540 * E2) * E5 +
+              (612612 * E2 - 540540 * E3 - 556920) * E4 +
+              E3 * (306306 * E3 + E2 * (675675 * E2 - 706860) + 680680) +
+              E2 * ((417690 - 255255 * E2) * E2 - 875160) + 4084080) /
+        (4084080 * mul[j] * An[j] * sqrt(An[j])) + 6 * s[j];
+    }
+  }
+
+  void EllipticFunction::RF(size_t n, const real x[], const real y[],
+                            const real z[], real F[]) {
+    size_t i = 0;
+    for (; i + blocksize_ <= n; i += blocksize_)
+      RFBlock<blocksize_>(x + i, y + i, z + i, F + i);
+    for (; i < n; ++i)
+      F[i] = RF(x[i], y[i], z[i]);
+  }
+
+  void EllipticFunction::RD(size_t n, const real x[], const real y[],
+                            const real z[], real D[]) {
+    size_t i = 0;
+    for (; i + blocksize_ <= n; i += blocksize_)
+      RDBlock<blocksize_>(x + i, y + i, z + i, D + i);
+    for (; i < n; ++i)
+      D[i] = RD(x[i], y[i], z[i]);
+  }
+
+  void EllipticFunction::RJ(size_t n, const real x[], const real y[],
+                            const real z[], const real p[], real J[]) {
+    size_t i = 0;
+    for (; i + blocksize_ <= n; i += blocksize_)
+      RJBlock<blocksize_>(x + i, y + i, z + i, p + i, J + i);
+    for (; i < n; ++i)
+      J[i] = RJ(x[i], y[i], z[i], p[i]);
+  }
+
+  void EllipticFunction::RG(size_t n, const real x[], const real y[],
+                            const real z[], real G[]) {
+    size_t i = 0;
+    for (; i + blocksize_ <= n; i += blocksize_) {
+      // Points with a zero argument are handled by the scalar version; feed
+      // dummy arguments to the blocks for these.
+      real xb[blocksize_], yb[blocksize_], zb[blocksize_],
+        F[blocksize_], D[blocksize_];
+      bool zero[blocksize_];
+      for (int j = 0; j < blocksize_; ++j) {
+        zero[j] = x[i+j] == 0 || y[i+j] == 0 || z[i+j] == 0;
+        xb[j] = zero[j] ? 1 : x[i+j];
+        yb[j] = zero[j] ? 1 : y[i+j];
+        zb[j] = zero[j] ? 1 : z[i+j];
+      }
+      RFBlock<blocksize_>(xb, yb, zb, F);
+      RDBlock<blocksize_>(xb, yb, zb, D);
+      for (int j = 0; j < blocksize_; ++j)
+        // Carlson, eq 1.7
+        G[i+j] = zero[j] ? RG(x[i+j], y[i+j], z[i+j]) :
+          (zb[j] * F[j] - (xb[j]-zb[j]) * (yb[j]-zb[j]) * D[j] / 3
+           + sqrt(xb[j] * yb[j] / zb[j])) / 2;
+    }
+    for (; i < n; ++i)
+      G[i] = RG(x[i], y[i], z[i]);
+  }
+
   void EllipticFunction::Reset(real k2, real alpha2,
                                real kp2, real alphap2) {
     // Accept nans here (needed for GeodesicExact)
@@ -234,6 +448,12 @@ namespace GeographicLib {
       throw GeographicErr("Parameter kp2 is not in [0, inf)");
     if (alphap2 < 0)
       throw GeographicErr("Parameter alphap2 is not in [0, inf)");
+    // Skip the computation of the complete integrals if nothing has changed;
+    // the constructors initialize _k2 to NaN so this test fails the first
+    // time.  (This happens, e.g., in the final iterations of the solution of
+    // the inverse problem in GeodesicExact.)
+    if (k2 == _k2 && alpha2 == _alpha2 && kp2 == _kp2 && alphap2 == _alphap2)
+      return;
     _k2 = k2;
     _kp2 = kp2;
     _alpha2 = alpha2;
@@ -307,6 +527,7 @@ namespace GeographicLib {
       _hHc = _kp2 == 1 ? Math::pi()/4 :
         (_kp2 == 0 ? 1 : _kp2 * RD(0, 1, _kp2) / 3);
     }
+    LandenInit();
   }
 
   /*
@@ -317,33 +538,42 @@ namespace GeographicLib {
    *   Numericshe Mathematik 7, 78-90 (1965)
    */
 
-  void EllipticFunction::sncndn(real x, real& sn, real& cn, real& dn) const {
-    // Bulirsch's sncndn routine, p 89.
+  void EllipticFunction::LandenInit() {
+    // The first part of Bulirsch's sncndn routine, p 89, which depends only on
+    // the modulus.
     static const real tolJAC =
       sqrt(numeric_limits<real>::epsilon() * real(0.01));
-    if (_kp2 != 0) {
-      real mc = _kp2, d = 0;
-      if (signbit(_kp2)) {
-        d = 1 - mc;
-        mc /= -d;
-        d = sqrt(d);
-        x *= d;
-      }
-      real c = 0;           // To suppress warning about uninitialized variable
-      real m[num_], n[num_];
-      unsigned l = 0;
-      for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
-        // This converges quadratically.  Max 5 trips
-        m[l] = a;
-        n[l] = mc = sqrt(mc);
-        c = (a + mc) / 2;
-        if (!(fabs(a - mc) > tolJAC * a)) {
-          ++l;
-          break;
-        }
-        mc *= a;
-        a = c;
+    _landc = _landd = 0; _landl = 0;
+    if (_kp2 == 0) return;
+    real mc = _kp2;
+    if (signbit(_kp2)) {
+      _landd = 1 - mc;
+      mc /= -_landd;
+      _landd = sqrt(_landd);
+    }
+    unsigned l = 0;
+    for (real a = 1; l < num_ || GEOGRAPHICLIB_PANIC; ++l) {
+      // This converges quadratically.  Max 5 trips
+      _landm[l] = a;
+      _landn[l] = mc = sqrt(mc);
+      _landc = (a + mc) / 2;
+      if (!(fabs(a - mc) > tolJAC * a)) {
+        ++l;
+        break;
       }
+      mc *= a;
+      a = _landc;
+    }
+    _landl = l;
+  }
+
+  void EllipticFunction::sncndn(real x, real& sn, real& cn, real& dn) const {
+    // Bulirsch's sncndn routine, p 89, using the Landen sequence computed by
+    // LandenInit.
+    if (_kp2 != 0) {
+      if (signbit(_kp2))
+        x *= _landd;
+      real c = _landc;
       x *= c;
       sn = sin(x);
       cn = cos(x);
@@ -351,11 +581,11 @@ namespace GeographicLib {
       if (sn != 0) {
         real a = cn / sn;
         c *= a;
-        while (l--) {
-          real b = m[l];
+        for (unsigned l = _landl; l--;) {
+          real b = _landm[l];
           a *= c;
           c *= dn;
-          dn = (n[l] + a) / (b + a);
+          dn = (_landn[l] + a) / (b + a);
           a = c / b;
         }
         a = 1 / sqrt(c*c + 1);
@@ -363,7 +593,7 @@ namespace GeographicLib {
         cn = c * sn;
         if (signbit(_kp2)) {
           swap(cn, dn);
-          sn /= d;
+          sn /= _landd;
         }
       }
     } else {
@@ -372,6 +602,50 @@ namespace GeographicLib {
     }
   }
 
+  void EllipticFunction::sncndn(size_t n, const real x[],
+                                real sn[], real cn[], real dn[]) const {
+    if (_kp2 == 0 || signbit(_kp2)) {
+      for (size_t i = 0; i < n; ++i)
+        sncndn(x[i], sn[i], cn[i], dn[i]);
+      return;
+    }
+    // Since the Landen sequence is the same for all the points, the ascending
+    // part of the algorithm can be done for a block of points in lock step.
+    const int b = blocksize_;
+    for (size_t i0 = 0; i0 < n; i0 += b) {
+      int m = int(min(size_t(b), n - i0));
+      real a[b], c[b], d[b];
+      for (int j = 0; j < m; ++j) {
+        real xj = x[i0 + j] * _landc;
+        sn[i0 + j] = sin(xj);
+        cn[i0 + j] = cos(xj);
+        // Dummy values for sn = 0 which is treated below
+        a[j] = sn[i0 + j] != 0 ? cn[i0 + j] / sn[i0 + j] : 1;
+        c[j] = _landc * a[j];
+        d[j] = 1;
+      }
+      for (unsigned l = _landl; l--;) {
+        real bl = _landm[l], nl = _landn[l];
+        for (int j = 0; j < m; ++j) {
+          a[j] *= c[j];
+          c[j] *= d[j];
+          d[j] = (nl + a[j]) / (bl + a[j]);
+          a[j] = c[j] / bl;
+        }
+      }
+      for (int j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        if (sn[i] != 0) {
+          real t = 1 / sqrt(c[j]*c[j] + 1);
+          sn[i] = signbit(sn[i]) ? -t : t;
+          cn[i] = c[j] * sn[i];
+          dn[i] = d[j];
+        } else
+          dn[i] = 1;
+      }
+    }
+  }
+
   Math::real EllipticFunction::FF(real sn, real cn, real dn) const {
     // Carlson, eq. 4.5 and
     // https://dlmf.nist.gov/19.25.E5
@@ -508,6 +782,16 @@ namespace GeographicLib {
       (deltaE(sn, cn, dn) + phi) * E() / (Math::pi()/2);
   }
 
+  void EllipticFunction::FF(size_t n, const real phi[], real F[]) const {
+    for (size_t i = 0; i < n; ++i)
+      F[i] = FF(phi[i]);
+  }
+
+  void EllipticFunction::E(size_t n, const real phi[], real E[]) const {
+    for (size_t i = 0; i < n; ++i)
+      E[i] = this->E(phi[i]);
+  }
+
   Math::real EllipticFunction::Ed(real ang) const {
     // ang - Math::AngNormalize(ang) is (nearly) an exact multiple of 360
     real n = round((ang - Math::AngNormalize(ang))/Math::td);
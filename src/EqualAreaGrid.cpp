@@ -0,0 +1,334 @@
+/**
+ * \file EqualAreaGrid.cpp
+ * \brief Implementation for GeographicLib::EqualAreaGrid class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/EqualAreaGrid.hpp>
+#include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  // The ring number (in units of nside) of the southern vertex and the
+  // longitude (in units of 45 degrees) of the center of the base cells
+  const int EqualAreaGrid::jrll_[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+  const int EqualAreaGrid::jpll_[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+
+  EqualAreaGrid::EqualAreaGrid(real a, real f)
+    : _aux(a, f)
+    , _a(a)
+    , _f(f)
+    , _exact(!(fabs(f) <= 1/real(150)))
+  {}
+
+  const EqualAreaGrid& EqualAreaGrid::WGS84() {
+    static const EqualAreaGrid
+      wgs84(Constants::WGS84_a(), Constants::WGS84_f());
+    return wgs84;
+  }
+
+  void EqualAreaGrid::CheckLevel(int level) {
+    if (!(level >= 0 && level <= maxlevel_))
+      throw GeographicErr("Level " + Utility::str(level) + " not in [0, "
+                          + Utility::str(maxlevel_) + "]");
+  }
+
+  void EqualAreaGrid::CheckLatitude(real lat) {
+    if (fabs(lat) > Math::qd)
+      throw GeographicErr("Latitude " + Utility::str(lat)
+                          + "d not in [-" + to_string(Math::qd)
+                          + "d, " + to_string(Math::qd) + "d]");
+  }
+
+  unsigned long long EqualAreaGrid::Index(real z, real c, real lon,
+                                          int level) {
+    // This follows ang2pix_nest in HEALPix with the longitude in degrees and
+    // with sqrt(3 * (1 - |z|)) = c * sqrt(3 / (1 + |z|)) to retain accuracy
+    // near the poles.
+    typedef long long ll;
+    const ll nside = 1LL << level;
+    const real ns = real(nside), za = fabs(z);
+    // The longitude in units of 90 degrees, in [0, 4)
+    real tt = remainder(lon, real(Math::td));
+    if (tt < 0) tt += Math::td;
+    tt /= Math::qd;
+    if (!(tt < 4)) tt = 0;
+    int face;
+    ll ix, iy;
+    if (za <= 2/real(3)) {
+      // Equatorial region
+      real t1 = ns * (real(0.5) + tt), t2 = ns * z * real(0.75);
+      ll jp = ll(t1 - t2), jm = ll(t1 + t2),
+        ifp = jp >> level, ifm = jm >> level;
+      face = ifp == ifm ? int(ifp & 3) + 4 :
+        (ifp < ifm ? int(ifp & 3) : int(ifm & 3) + 8);
+      ix = jm & (nside - 1);
+      iy = nside - (jp & (nside - 1)) - 1;
+    } else {
+      // Polar caps
+      int ntt = min(3, int(tt));
+      real tp = tt - ntt, tmp = ns * c * sqrt(3 / (1 + za));
+      ll jp = min(nside - 1, ll(tp * tmp)),
+        jm = min(nside - 1, ll((1 - tp) * tmp));
+      if (z >= 0) {
+        face = ntt; ix = nside - jm - 1; iy = nside - jp - 1;
+      } else {
+        face = ntt + 8; ix = jp; iy = jm;
+      }
+    }
+    return Encode(level, face,
+                  (unsigned long long)(ix), (unsigned long long)(iy));
+  }
+
+  void EqualAreaGrid::Decode(unsigned long long id, int& level, int& face,
+                             unsigned long long& ix, unsigned long long& iy) {
+    level = Level(id);
+    unsigned long long p = id - (4ULL << 2*level);
+    face = int(p >> 2*level);
+    p &= (1ULL << 2*level) - 1;
+    ix = Geohash::Compact(p); iy = Geohash::Compact(p >> 1);
+  }
+
+  void EqualAreaGrid::Location(int face, real x, real y,
+                               real& z, real& c, real& lon) {
+    // This follows xyf2loc in HEALPix; nr is the number of rings in units of
+    // nside between the point and the nearer pole (or 1 in the equatorial
+    // region).
+    real jr = jrll_[face] - x - y, nr;
+    if (jr < 1 || jr > 3) {
+      nr = jr < 1 ? jr : 4 - jr;
+      real t = nr * nr / 3;
+      z = jr < 1 ? 1 - t : t - 1;
+      c = sqrt(t * (2 - t));
+    } else {
+      nr = 1;
+      z = (2 - jr) * 2 / 3;
+      c = sqrt((1 - z) * (1 + z));
+    }
+    real t = jpll_[face] * nr + x - y;
+    if (t < 0) t += 8;
+    if (t >= 8) t -= 8;
+    lon = Math::AngNormalize(nr > 0 ? Math::qd/2 * t / nr : 0);
+  }
+
+  unsigned long long EqualAreaGrid::Forward(real lat, real lon, int level)
+    const {
+    CheckLevel(level);
+    CheckLatitude(lat);
+    if (isnan(lat) || isnan(lon))
+      return 0ULL;
+    AuxAngle xi = _aux.Convert(AuxLatitude::GEOGRAPHIC, AuxLatitude::AUTHALIC,
+                               AuxAngle::degrees(lat), _exact).normalized();
+    return Index(xi.y(), xi.x(), lon, level);
+  }
+
+  void EqualAreaGrid::Forward(size_t n, const real lat[], const real lon[],
+                              int level, unsigned long long id[],
+                              int nthreads) const {
+    CheckLevel(level);
+    for (size_t i = 0; i < n; ++i)
+      CheckLatitude(lat[i]);
+    // The points are handed out to the tasks in chunks; each chunk is
+    // converted to authalic latitudes with one call to AuxLatitude::Convert.
+    const size_t chunk = 256;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      AuxAngleArray phi, xi;
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;) {
+        size_t m = min(n, i0 + chunk) - i0;
+        phi = AuxAngleArray::degrees(m, lat + i0);
+        _aux.Convert(AuxLatitude::GEOGRAPHIC, AuxLatitude::AUTHALIC,
+                     phi, xi, _exact);
+        xi.normalize();
+        for (size_t k = 0; k < m; ++k) {
+          size_t i = i0 + k;
+          id[i] = isnan(lat[i]) || isnan(lon[i]) ? 0ULL :
+            Index(xi.y()[k], xi.x()[k], lon[i], level);
+        }
+      }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
+  void EqualAreaGrid::Reverse(unsigned long long id, real& lat, real& lon)
+    const {
+    if (!Valid(id)) {
+      lat = lon = Math::NaN();
+      return;
+    }
+    int level, face;
+    unsigned long long ix, iy;
+    Decode(id, level, face, ix, iy);
+    real ns = real(1ULL << level), z, c;
+    Location(face, (ix + real(0.5)) / ns, (iy + real(0.5)) / ns, z, c, lon);
+    lat = _aux.Convert(AuxLatitude::AUTHALIC, AuxLatitude::GEOGRAPHIC,
+                       AuxAngle(z, c), _exact).degrees();
+  }
+
+  void EqualAreaGrid::Reverse(size_t n, const unsigned long long id[],
+                              real lat[], real lon[], int nthreads) const {
+    const size_t chunk = 256;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      AuxAngleArray xi, phi;
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;) {
+        size_t m = min(n, i0 + chunk) - i0;
+        xi.resize(m);
+        for (size_t k = 0; k < m; ++k) {
+          size_t i = i0 + k;
+          if (Valid(id[i])) {
+            int level, face;
+            unsigned long long ix, iy;
+            Decode(id[i], level, face, ix, iy);
+            real ns = real(1ULL << level);
+            Location(face, (ix + real(0.5)) / ns, (iy + real(0.5)) / ns,
+                     xi.y()[k], xi.x()[k], lon[i]);
+          } else {
+            xi.y()[k] = xi.x()[k] = lon[i] = Math::NaN();
+          }
+        }
+        _aux.Convert(AuxLatitude::AUTHALIC, AuxLatitude::GEOGRAPHIC,
+                     xi, phi, _exact);
+        phi.degrees(lat + i0);
+      }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
+  void EqualAreaGrid::Boundary(unsigned long long id, int step,
+                               vector<real>& lat, vector<real>& lon) const {
+    if (!Valid(id))
+      throw GeographicErr("Invalid cell id " + Utility::str(id));
+    if (!(step > 0))
+      throw GeographicErr("Step " + Utility::str(step) + " is not positive");
+    int level, face;
+    unsigned long long ix, iy;
+    Decode(id, level, face, ix, iy);
+    real ns = real(1ULL << level),
+      x0 = ix / ns, y0 = iy / ns, x1 = (ix + 1) / ns, y1 = (iy + 1) / ns,
+      d = 1 / (ns * step);
+    lat.resize(4 * size_t(step));
+    lon.resize(4 * size_t(step));
+    // The northern vertex is at (x1, y1); traverse the edges toward the
+    // west, south and east vertices in turn.
+    for (int k = 0; k < 4 * step; ++k) {
+      int i = k % step;
+      real x, y, z, c;
+      switch (k / step) {
+      case 0: x = x1 - i * d; y = y1; break;
+      case 1: x = x0; y = y1 - i * d; break;
+      case 2: x = x0 + i * d; y = y0; break;
+      default: x = x1; y = y0 + i * d; break;
+      }
+      Location(face, x, y, z, c, lon[k]);
+      lat[k] = _aux.Convert(AuxLatitude::AUTHALIC, AuxLatitude::GEOGRAPHIC,
+                            AuxAngle(z, c), _exact).degrees();
+    }
+  }
+
+  int EqualAreaGrid::Level(unsigned long long id) {
+    if (!Valid(id))
+      throw GeographicErr("Invalid cell id " + Utility::str(id));
+    int level = 0;
+    while (id >= (16ULL << 2*level)) ++level;
+    return level;
+  }
+
+  unsigned long long EqualAreaGrid::Parent(unsigned long long id, int level) {
+    int l = Level(id);
+    if (!(level >= 0 && level <= l))
+      throw GeographicErr("Level " + Utility::str(level) + " not in [0, "
+                          + Utility::str(l) + "]");
+    return id >> 2*(l - level);
+  }
+
+  void EqualAreaGrid::Children(unsigned long long id,
+                               unsigned long long children[4]) {
+    if (Level(id) == maxlevel_)
+      throw GeographicErr("Cell at level " + Utility::str(maxlevel_)
+                          + " has no children");
+    for (int k = 0; k < 4; ++k)
+      children[k] = 4 * id + k;
+  }
+
+  void EqualAreaGrid::Neighbors(unsigned long long id,
+                                vector<unsigned long long>& neighbors) {
+    // This follows neighbors in HEALPix.  The offsets in face coordinates of
+    // the neighbors in the order SW, W, NW, N, NE, E, SE, S.
+    static const int xoffset[8] = {-1, -1,  0,  1,  1,  1,  0, -1};
+    static const int yoffset[8] = { 0,  1,  1,  1,  0, -1, -1, -1};
+    // For a neighbor off the face, nbnum = 4 + dx + 3 * dy, where dx and dy
+    // in {-1, 0, 1} indicate the direction to the adjacent base cell;
+    // facearray[nbnum][face] is that base cell (or -1 if there is none) and
+    // swaparray[nbnum][face/4] gives the transformation of the coordinates
+    // (1 = flip x, 2 = flip y, 4 = swap x and y).
+    static const int facearray[9][12] = {
+      { 8,  9, 10, 11, -1, -1, -1, -1, 10, 11,  8,  9},   // S
+      { 5,  6,  7,  4,  8,  9, 10, 11,  9, 10, 11,  8},   // SE
+      {-1, -1, -1, -1,  5,  6,  7,  4, -1, -1, -1, -1},   // E
+      { 4,  5,  6,  7, 11,  8,  9, 10, 11,  8,  9, 10},   // SW
+      { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11},   // center
+      { 1,  2,  3,  0,  0,  1,  2,  3,  5,  6,  7,  4},   // NE
+      {-1, -1, -1, -1,  7,  4,  5,  6, -1, -1, -1, -1},   // W
+      { 3,  0,  1,  2,  3,  0,  1,  2,  4,  5,  6,  7},   // NW
+      { 2,  3,  0,  1, -1, -1, -1, -1,  0,  1,  2,  3}};  // N
+    static const int swaparray[9][3] = {
+      {0, 0, 3},                // S
+      {0, 0, 6},                // SE
+      {0, 0, 0},                // E
+      {0, 0, 5},                // SW
+      {0, 0, 0},                // center
+      {5, 0, 0},                // NE
+      {0, 0, 0},                // W
+      {6, 0, 0},                // NW
+      {3, 0, 0}};               // N
+    int level, face;
+    unsigned long long ix, iy;
+    Decode(id, level, face, ix, iy);
+    const long long nside = 1LL << level;
+    neighbors.clear();
+    for (int i = 0; i < 8; ++i) {
+      long long x = (long long)(ix) + xoffset[i],
+        y = (long long)(iy) + yoffset[i];
+      int nbnum = 4;
+      if (x < 0) { x += nside; nbnum -= 1; }
+      else if (x >= nside) { x -= nside; nbnum += 1; }
+      if (y < 0) { y += nside; nbnum -= 3; }
+      else if (y >= nside) { y -= nside; nbnum += 3; }
+      int f = facearray[nbnum][face];
+      if (f < 0) continue;
+      int bits = swaparray[nbnum][face / 4];
+      if (bits & 1) x = nside - x - 1;
+      if (bits & 2) y = nside - y - 1;
+      if (bits & 4) swap(x, y);
+      unsigned long long nid = Encode(level, f, (unsigned long long)(x),
+                                      (unsigned long long)(y));
+      // At low levels, a cell can be reached in more than one direction
+      if (nid != id && find(neighbors.begin(), neighbors.end(), nid) ==
+          neighbors.end())
+        neighbors.push_back(nid);
+    }
+  }
+
+  Math::real EqualAreaGrid::CellArea(int level) const {
+    CheckLevel(level);
+    return 4 * Math::pi() * _aux.AuthalicRadiusSquared(_exact) /
+      real(NumCells(level));
+  }
+
+  unsigned long long EqualAreaGrid::NumCells(int level) {
+    CheckLevel(level);
+    return 12ULL << 2*level;
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,178 @@
+/**
+ * \file Executor.cpp
+ * \brief Implementation for GeographicLib::Executor class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+
+    // The built-in default: start n - 1 threads for each call to Run.  This
+    // is how the batch routines ran their tasks before Executor was added.
+    class SpawnExecutor : public Executor {
+    public:
+      void Run(int n, const function<void(int)>& task) override {
+        if (n <= 0) return;
+        vector<thread> threads;
+        threads.reserve(n - 1);
+        for (int i = 1; i < n; ++i)
+          threads.push_back(thread(task, i));
+        task(0);
+        for (auto& t : threads)
+          t.join();
+      }
+      int Concurrency() const override {
+        return max(1, int(thread::hardware_concurrency()));
+      }
+    };
+
+    Executor* spawner() {
+      static SpawnExecutor e;
+      return &e;
+    }
+
+    atomic<Executor*> default_(nullptr);
+
+  } // namespace
+
+  Executor* Executor::Default() {
+    Executor* e = default_.load();
+    return e ? e : spawner();
+  }
+
+  Executor* Executor::SetDefault(Executor* executor) {
+    Executor* e = default_.exchange(executor);
+    return e ? e : spawner();
+  }
+
+  void Executor::Batch(int n, const function<void(int)>& task) {
+    if (n <= 0) return;
+    if (n == 1) {
+      task(0);
+      return;
+    }
+    vector<exception_ptr> err(n);
+    Default()->Run(n, [&task, &err](int i) -> void {
+      try {
+        task(i);
+      }
+      catch (...) {
+        err[i] = current_exception();
+      }
+    });
+    for (auto& e : err)
+      if (e) rethrow_exception(e);
+  }
+
+  ThreadPool::ThreadPool(int nthreads)
+    : _stop(false)
+  {
+    if (nthreads <= 0)
+      nthreads = max(1, int(thread::hardware_concurrency()));
+    _workers.reserve(nthreads - 1);
+    try {
+      for (int i = 1; i < nthreads; ++i)
+        _workers.push_back(thread(&ThreadPool::worker, this));
+    }
+    catch (...) {
+      stop();
+      throw;
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    stop();
+  }
+
+  void ThreadPool::stop() {
+    {
+      lock_guard<mutex> g(_lock);
+      _stop = true;
+    }
+    _work.notify_all();
+    for (auto& t : _workers)
+      t.join();
+    _workers.clear();
+  }
+
+  void ThreadPool::claim(job*& j, int& i) {
+    j = _jobs.front();
+    i = j->next++;
+    // Once its last task is claimed, the job is retired from the queue; the
+    // thread which called Run waits for the claimed tasks to complete.
+    if (j->next == j->n) _jobs.pop_front();
+  }
+
+  void ThreadPool::execute(job* j, int i) {
+    try {
+      (*j->task)(i);
+    }
+    catch (...) {
+      lock_guard<mutex> g(_lock);
+      if (!j->err) j->err = current_exception();
+    }
+    bool last;
+    {
+      lock_guard<mutex> g(_lock);
+      last = --j->pending == 0;
+    }
+    if (last) _done.notify_all();
+  }
+
+  void ThreadPool::worker() {
+    for (;;) {
+      job* j; int i;
+      {
+        unique_lock<mutex> g(_lock);
+        _work.wait(g, [this]() -> bool { return _stop || !_jobs.empty(); });
+        if (_stop) return;
+        claim(j, i);
+      }
+      execute(j, i);
+    }
+  }
+
+  void ThreadPool::Run(int n, const function<void(int)>& task) {
+    if (n <= 0) return;
+    job jb;
+    jb.task = &task; jb.n = n; jb.next = 0; jb.pending = n;
+    if (_workers.empty()) {
+      for (int i = 0; i < n; ++i)
+        execute(&jb, i);
+      if (jb.err) rethrow_exception(jb.err);
+      return;
+    }
+    {
+      lock_guard<mutex> g(_lock);
+      _jobs.push_back(&jb);
+    }
+    _work.notify_all();
+    // Help with the tasks of this job (and of any jobs queued in front of
+    // it) until all of them have been claimed.
+    for (;;) {
+      job* j; int i;
+      {
+        lock_guard<mutex> g(_lock);
+        if (jb.next == n) break;
+        claim(j, i);
+      }
+      execute(j, i);
+    }
+    {
+      unique_lock<mutex> g(_lock);
+      _done.wait(g, [&jb]() -> bool { return jb.pending == 0; });
+    }
+    if (jb.err) rethrow_exception(jb.err);
+  }
+
+} // namespace GeographicLib
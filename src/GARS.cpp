@@ -9,6 +9,7 @@
 
 #include <GeographicLib/GARS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -22,15 +23,15 @@ namespace GeographicLib {
   const char* const GARS::digits_ = "0123456789";
   const char* const GARS::letters_ = "ABCDEFGHJKLMNPQRSTUVWXYZ";
 
-  void GARS::Forward(real lat, real lon, int prec, string& gars) {
+  int GARS::Forward(real lat, real lon, int prec, char gars[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     if (fabs(lat) > Math::qd)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
     if (isnan(lat) || isnan(lon)) {
-      gars = "INVALID";
-      return;
+      strcpy(gars, "INVALID");
+      return int(strlen(gars));
     }
     lon = Math::AngNormalize(lon);
     if (lon == Math::hd) lon = -Math::hd; // lon now in [-180,180)
@@ -42,24 +43,85 @@ namespace GeographicLib {
       ilon = x * mult1_ / m_,
       ilat = y * mult1_ / m_;
     x -= ilon * m_ / mult1_; y -= ilat * m_ / mult1_;
-    char gars1[maxlen_];
     ++ilon;
     for (int c = lonlen_; c--;) {
-      gars1[c] = digits_[ ilon % baselon_]; ilon /= baselon_;
+      gars[c] = digits_[ ilon % baselon_]; ilon /= baselon_;
     }
     for (int c = latlen_; c--;) {
-      gars1[lonlen_ + c] = letters_[ilat % baselat_]; ilat /= baselat_;
+      gars[lonlen_ + c] = letters_[ilat % baselat_]; ilat /= baselat_;
     }
     if (prec > 0) {
       ilon = x / mult3_; ilat = y / mult3_;
-      gars1[baselen_] = digits_[mult2_ * (mult2_ - 1 - ilat) + ilon + 1];
+      gars[baselen_] = digits_[mult2_ * (mult2_ - 1 - ilat) + ilon + 1];
       if (prec > 1) {
         ilon = x % mult3_; ilat = y % mult3_;
-        gars1[baselen_ + 1] = digits_[mult3_ * (mult3_ - 1 - ilat) + ilon + 1];
+        gars[baselen_ + 1] = digits_[mult3_ * (mult3_ - 1 - ilat) + ilon + 1];
       }
     }
-    gars.resize(baselen_ + prec);
-    copy(gars1, gars1 + baselen_ + prec, gars.begin());
+    gars[baselen_ + prec] = '\0';
+    return baselen_ + prec;
+  }
+
+  void GARS::Forward(real lat, real lon, int prec, string& gars) {
+    char gars1[maxlen_ + 1];
+    int len = Forward(lat, lon, prec, gars1);
+    gars.assign(gars1, len);
+  }
+
+  void GARS::Forward(size_t n, const real lat[], const real lon[], int prec,
+                     char gars[], size_t stride) {
+    if (!(stride > size_t(maxlen_)))
+      throw GeographicErr("GARS stride " + Utility::str(stride)
+                          + " less than " + Utility::str(int(maxlen_) + 1));
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], prec, gars + i * stride);
+  }
+
+  void GARS::Forward(real lat, real lon, int prec, unsigned long long& code) {
+    Forward(1, &lat, &lon, prec, &code);
+  }
+
+  void GARS::Forward(size_t n, const real lat[], const real lon[], int prec,
+                     unsigned long long code[]) {
+    prec = max(0, min(int(maxprec_), prec));
+    // Process the points in blocks; the loop over a block has no branches
+    // (the tests on prec are outside the loop) so that it can be vectorized.
+    // The latitudes are checked at the end of each block.
+    const size_t nb = 64;
+    const real latmax = Math::qd * (1 - numeric_limits<real>::epsilon() / 2);
+    const int m1 = m_ / mult1_;
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = min(nb, n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        real lat1 = lat[i0 + j], lon1 = Math::AngNormalize(lon[i0 + j]);
+        bool valid = !(isnan(lat1) || isnan(lon1));
+        // Clamp lat1 (which also replaces NaN by -90) and replace lon1 = NaN
+        // by 0 so that the conversions to int are defined; lat = 90 is moved
+        // into the last cell as in the string version.
+        lat1 = fmin(fmax(lat1, real(-Math::qd)), latmax);
+        lon1 = !valid ? 0 : (lon1 == Math::hd ? -Math::hd : lon1);
+        int
+          x = int(floor(lon1 * m_)) - lonorig_ * m_,
+          y = int(floor(lat1 * m_)) - latorig_ * m_,
+          ilon = x / m1,
+          ilat = y / m1;
+        x -= ilon * m1; y -= ilat * m1;
+        unsigned long long c = (unsigned long long)(ilon) * (mult1_ * Math::hd)
+          + ilat;
+        if (prec > 0)
+          c = c * (mult2_ * mult2_) +
+            mult2_ * (mult2_ - 1 - y / mult3_) + x / mult3_;
+        if (prec > 1)
+          c = c * (mult3_ * mult3_) +
+            mult3_ * (mult3_ - 1 - y % mult3_) + x % mult3_;
+        code[i0 + j] = valid ? c : ~0ULL;
+      }
+      for (size_t j = 0; j < m; ++j)
+        if (fabs(lat[i0 + j]) > Math::qd)
+          throw GeographicErr("Latitude " + Utility::str(lat[i0 + j])
+                              + "d not in [-" + to_string(Math::qd)
+                              + "d, " + to_string(Math::qd) + "d]");
+    }
   }
 
   void GARS::Reverse(const string& gars, real& lat, real& lon,
@@ -127,4 +189,52 @@ namespace GeographicLib {
     prec = prec1;
   }
 
+  void GARS::Reverse(unsigned long long code, int prec,
+                     real& lat, real& lon, bool centerp) {
+    prec = max(0, min(int(maxprec_), prec));
+    if (code == ~0ULL) {
+      lat = lon = Math::NaN();
+      return;
+    }
+    if (!(code < NumCodes(prec)))
+      throw GeographicErr("Integer GARS " + Utility::str(code)
+                          + " too large for precision " + Utility::str(prec));
+    int k1 = 0, k2 = 0;
+    if (prec > 1) {
+      k2 = int(code % (mult3_ * mult3_)); code /= mult3_ * mult3_;
+    }
+    if (prec > 0) {
+      k1 = int(code % (mult2_ * mult2_)); code /= mult2_ * mult2_;
+    }
+    int
+      ilat = int(code % (mult1_ * Math::hd)),
+      ilon = int(code / (mult1_ * Math::hd));
+    // The rest follows the string version of Reverse.
+    real
+      unit = mult1_,
+      lat1 = ilat + latorig_ * unit,
+      lon1 = ilon + lonorig_ * unit;
+    if (prec > 0) {
+      unit *= mult2_;
+      lat1 = mult2_ * lat1 + (mult2_ - 1 - k1 / mult2_);
+      lon1 = mult2_ * lon1 + (k1 % mult2_);
+      if (prec > 1) {
+        unit *= mult3_;
+        lat1 = mult3_ * lat1 + (mult3_ - 1 - k2 / mult3_);
+        lon1 = mult3_ * lon1 + (k2 % mult3_);
+      }
+    }
+    if (centerp) {
+      unit *= 2; lat1 = 2 * lat1 + 1; lon1 = 2 * lon1 + 1;
+    }
+    lat = lat1 / unit;
+    lon = lon1 / unit;
+  }
+
+  void GARS::Reverse(size_t n, const unsigned long long code[], int prec,
+                     real lat[], real lon[], bool centerp) {
+    for (size_t i = 0; i < n; ++i)
+      Reverse(code[i], prec, lat[i], lon[i], centerp);
+  }
+
 } // namespace GeographicLib
@@ -16,26 +16,66 @@ namespace GeographicLib {
 
   using namespace std;
 
+  void GeoCoords::SetLazy(real latitude, real longitude) {
+    // Signal the errors which UTMUPS::Forward would give for the standard
+    // zone now, so that the deferred projection doesn't throw.
+    if (fabs(latitude) > Math::qd)
+      throw GeographicErr("Latitude " + Utility::str(latitude)
+                          + "d not in [-" + to_string(Math::qd)
+                          + "d, " + to_string(Math::qd) + "d]");
+    int zone = UTMUPS::StandardZone(latitude, longitude);
+    if (isinf(longitude) && zone != UTMUPS::INVALID && zone != UTMUPS::UPS)
+      throw GeographicErr("Longitude " + Utility::str(longitude)
+                          + "d more than 60d from center of UTM zone "
+                          + Utility::str(zone));
+    _lat = latitude;
+    _long = _long0 = longitude;
+    _zone = zone;
+    _northp = !(signbit(_lat));
+    _utmpending = _altpending = true;
+  }
+
+  void GeoCoords::ComputeUTMUPS() const {
+    int zone; bool northp;
+    UTMUPS::Forward(_lat, _long0,
+                    zone, northp, _easting, _northing, _gamma, _k);
+    _utmpending = false;
+  }
+
   void GeoCoords::Reset(const std::string& s, bool centerp, bool longfirst) {
-    vector<string> sa;
+    // Locate the (at most 3) space-separated items; only the items used are
+    // copied into strings.
     const char* spaces = " \t\n\v\f\r,"; // Include comma as a space
+    string::size_type beg[3], len[3];
+    unsigned n = 0;
     for (string::size_type pos0 = 0, pos1; pos0 != string::npos;) {
       pos1 = s.find_first_not_of(spaces, pos0);
       if (pos1 == string::npos)
         break;
+      if (n == 3)
+        throw GeographicErr("Coordinate requires 1, 2, or 3 elements");
       pos0 = s.find_first_of(spaces, pos1);
-      sa.push_back(s.substr(pos1, pos0 == string::npos ? pos0 : pos0 - pos1));
+      beg[n] = pos1;
+      len[n++] = pos0 == string::npos ? pos0 : pos0 - pos1;
     }
-    if (sa.size() == 1) {
+    if (n == 1) {
       int prec;
-      MGRS::Reverse(sa[0], _zone, _northp, _easting, _northing, prec, centerp);
+      MGRS::Reverse(s.substr(beg[0], len[0]),
+                    _zone, _northp, _easting, _northing, prec, centerp);
       UTMUPS::Reverse(_zone, _northp, _easting, _northing,
                       _lat, _long, _gamma, _k);
-    } else if (sa.size() == 2) {
-      DMS::DecodeLatLon(sa[0], sa[1], _lat, _long, longfirst);
-      UTMUPS::Forward( _lat, _long,
-                       _zone, _northp, _easting, _northing, _gamma, _k);
-    } else if (sa.size() == 3) {
+      _long0 = _long;
+      _utmpending = false;
+    } else if (n == 2) {
+      real lat, lon;
+      DMS::DecodeLatLon(s.substr(beg[0], len[0]), s.substr(beg[1], len[1]),
+                        lat, lon, longfirst);
+      SetLazy(lat, lon);
+      return;
+    } else if (n == 3) {
+      string sa[3];
+      for (unsigned i = 0; i < 3; ++i)
+        sa[i] = s.substr(beg[i], len[i]);
       unsigned zoneind, coordind;
       if (sa[0].size() > 0 && isalpha(sa[0][sa[0].size() - 1])) {
         zoneind = 0;
@@ -52,6 +92,8 @@ namespace GeographicLib {
         (i ? _northing : _easting) = Utility::val<real>(sa[coordind + i]);
       UTMUPS::Reverse(_zone, _northp, _easting, _northing,
                       _lat, _long, _gamma, _k);
+      _long0 = _long;
+      _utmpending = false;
       FixHemisphere();
     } else
       throw GeographicErr("Coordinate requires 1, 2, or 3 elements");
@@ -77,6 +119,7 @@ namespace GeographicLib {
   string GeoCoords::MGRSRepresentation(int prec) const {
     // Max precision is um
     prec = max(-1, min(6, prec) + 5);
+    UTMUPSSync();
     string mgrs;
     MGRS::Forward(_zone, _northp, _easting, _northing, _lat, prec, mgrs);
     return mgrs;
@@ -85,6 +128,7 @@ namespace GeographicLib {
   string GeoCoords::AltMGRSRepresentation(int prec) const {
     // Max precision is um
     prec = max(-1, min(6, prec) + 5);
+    AltSync();
     string mgrs;
     MGRS::Forward(_alt_zone, _northp, _alt_easting, _alt_northing, _lat, prec,
                   mgrs);
@@ -115,6 +159,7 @@ namespace GeographicLib {
   }
 
   string GeoCoords::UTMUPSRepresentation(int prec, bool abbrev) const {
+    UTMUPSSync();
     string utm;
     UTMUPSString(_zone, _northp, _easting, _northing, prec, abbrev, utm);
     return utm;
@@ -122,6 +167,7 @@ namespace GeographicLib {
 
   string GeoCoords::UTMUPSRepresentation(bool northp, int prec,
                                          bool abbrev) const {
+    UTMUPSSync();
     real e, n;
     int z;
     UTMUPS::Transfer(_zone, _northp, _easting, _northing,
@@ -132,6 +178,7 @@ namespace GeographicLib {
   }
 
   string GeoCoords::AltUTMUPSRepresentation(int prec, bool abbrev) const {
+    AltSync();
     string utm;
     UTMUPSString(_alt_zone, _northp, _alt_easting, _alt_northing, prec,
                  abbrev, utm);
@@ -140,6 +187,7 @@ namespace GeographicLib {
 
   string GeoCoords::AltUTMUPSRepresentation(bool northp, int prec,
                                             bool abbrev) const {
+    AltSync();
     real e, n;
     int z;
     UTMUPS::Transfer(_alt_zone, _northp, _alt_easting, _alt_northing,
@@ -152,6 +152,154 @@ namespace GeographicLib {
       Rotation(sphi, cphi, slam, clam, M);
   }
 
+  template<int n>
+  void Geocentric::ReverseBlock(const real X[], const real Y[], const real Z[],
+                                real lat[], real lon[], real h[],
+                                real M[]) const {
+    // This follows the general case in IntReverse for an oblate ellipsoid,
+    // except that hypot(x, y) is replaced by sqrt(x^2 + y^2).  Overflow and
+    // underflow are avoided by restricting this to points which are not
+    // exceptionally close to or far from the rotation axis.  Points which
+    // fail these tests or which lie inside the evolute are recomputed by
+    // IntReverse.
+    static const real
+      minr2 = numeric_limits<real>::min() / numeric_limits<real>::epsilon();
+    const real maxrad2 = Math::_sq(_maxrad);
+    real slam[n], clam[n], sphi[n], cphi[n];
+    bool slow[n];
+    for (int j = 0; j < n; ++j) {
+      real
+        R2 = Math::_sq(X[j]) + Math::_sq(Y[j]),
+        R = sqrt(R2),
+        p = Math::_sq(R / _a),
+        q = _e2m * Math::_sq(Z[j] / _a),
+        r = (p + q - _e4a) / 6,
+        S = _e4a * p * q / 4,
+        r2 = Math::_sq(r),
+        r3 = r * r2,
+        disc = S * (2 * r3 + S);
+      slam[j] = R != 0 ? Y[j] / R : 0;
+      clam[j] = R != 0 ? X[j] / R : 1;
+      slow[j] = !(R2 + Math::_sq(Z[j]) <= maxrad2 &&
+                  (R2 >= minr2 || (X[j] == 0 && Y[j] == 0)) &&
+                  !(_e4a * q == 0 && r <= 0) && disc >= 0);
+      real T3 = S + r3;
+      T3 += T3 < 0 ? -sqrt(disc) : sqrt(disc);
+      real T = cbrt(T3);
+      real
+        u = r + T + (T != 0 ? r2 / T : 0),
+        v = sqrt(Math::_sq(u) + _e4a * q),
+        uv = u < 0 ? _e4a * q / (v - u) : u + v,
+        w = fmax(real(0), _e2a * (uv - q) / (2 * v)),
+        k = uv / (sqrt(uv + Math::_sq(w)) + w),
+        k2 = k + _e2,
+        d = k * R / k2,
+        zk = Z[j] / k, rk = R / k2,
+        H = sqrt(Math::_sq(zk) + Math::_sq(rk));
+      sphi[j] = zk / H;
+      cphi[j] = rk / H;
+      h[j] = (1 - _e2m / k) * sqrt(Math::_sq(d) + Math::_sq(Z[j]));
+    }
+    for (int j = 0; j < n; ++j) {
+      real* Mj = M ? M + dim2_ * j : NULL;
+      if (slow[j])
+        IntReverse(X[j], Y[j], Z[j], lat[j], lon[j], h[j], Mj);
+      else {
+        lat[j] = Math::atan2d(sphi[j], cphi[j]);
+        lon[j] = Math::atan2d(slam[j], clam[j]);
+        if (Mj)
+          Rotation(sphi[j], cphi[j], slam[j], clam[j], Mj);
+      }
+    }
+  }
+
+  void Geocentric::Forward(size_t n, const real lat[], const real lon[],
+                           const real h[], real X[], real Y[], real Z[],
+                           real M[]) const {
+    if (!Init())
+      return;
+    for (size_t i = 0; i < n; ++i)
+      IntForward(lat[i], lon[i], h[i], X[i], Y[i], Z[i],
+                 M ? M + dim2_ * i : NULL);
+  }
+
+  void Geocentric::Reverse(size_t n, const real X[], const real Y[],
+                           const real Z[], real lat[], real lon[], real h[],
+                           real M[]) const {
+    if (!Init())
+      return;
+    if (!(_f > 0)) {
+      for (size_t i = 0; i < n; ++i)
+        IntReverse(X[i], Y[i], Z[i], lat[i], lon[i], h[i],
+                   M ? M + dim2_ * i : NULL);
+      return;
+    }
+    size_t i = 0;
+    for (; i + blocksize_ <= n; i += blocksize_)
+      ReverseBlock<blocksize_>(X + i, Y + i, Z + i, lat + i, lon + i, h + i,
+                               M ? M + dim2_ * i : NULL);
+    if (i < n) {
+      // Pad the last partial block by repeating the last point so that the
+      // results do not depend on the position of a point in the arrays.
+      real
+        Xt[blocksize_], Yt[blocksize_], Zt[blocksize_],
+        latt[blocksize_], lont[blocksize_], ht[blocksize_],
+        Mt[dim2_ * blocksize_];
+      size_t m = n - i;
+      for (int j = 0; j < blocksize_; ++j) {
+        size_t l = i + min(size_t(j), m - 1);
+        Xt[j] = X[l]; Yt[j] = Y[l]; Zt[j] = Z[l];
+      }
+      ReverseBlock<blocksize_>(Xt, Yt, Zt, latt, lont, ht, M ? Mt : NULL);
+      copy(latt, latt + m, lat + i);
+      copy(lont, lont + m, lon + i);
+      copy(ht, ht + m, h + i);
+      if (M)
+        copy(Mt, Mt + dim2_ * m, M + dim2_ * i);
+    }
+  }
+
+  void Geocentric::Forward(size_t n, StridedArray<const real> lat,
+                           StridedArray<const real> lon,
+                           StridedArray<const real> h,
+                           StridedArray<real> X, StridedArray<real> Y,
+                           StridedArray<real> Z) const {
+    if (!Init())
+      return;
+    for (size_t i = 0; i < n; ++i)
+      IntForward(lat[i], lon[i], h[i], X[i], Y[i], Z[i], NULL);
+  }
+
+  void Geocentric::Reverse(size_t n, StridedArray<const real> X,
+                           StridedArray<const real> Y,
+                           StridedArray<const real> Z,
+                           StridedArray<real> lat, StridedArray<real> lon,
+                           StridedArray<real> h) const {
+    if (!Init())
+      return;
+    if (!(_f > 0)) {
+      for (size_t i = 0; i < n; ++i)
+        IntReverse(X[i], Y[i], Z[i], lat[i], lon[i], h[i], NULL);
+      return;
+    }
+    // Copy each block to contiguous arrays, padding the last one as in the
+    // array version.
+    real
+      Xt[blocksize_], Yt[blocksize_], Zt[blocksize_],
+      latt[blocksize_], lont[blocksize_], ht[blocksize_];
+    for (size_t i = 0; i < n; i += blocksize_) {
+      size_t m = min(size_t(blocksize_), n - i);
+      for (int j = 0; j < blocksize_; ++j) {
+        size_t l = i + min(size_t(j), m - 1);
+        Xt[j] = X[l]; Yt[j] = Y[l]; Zt[j] = Z[l];
+      }
+      ReverseBlock<blocksize_>(Xt, Yt, Zt, latt, lont, ht, NULL);
+      for (size_t j = 0; j < m; ++j) {
+        lat[i + j] = latt[j]; lon[i + j] = lont[j]; h[i + j] = ht[j];
+      }
+    }
+  }
+
   void Geocentric::Rotation(real sphi, real cphi, real slam, real clam,
                             real M[dim2_]) {
     // This rotation matrix is given by the following quaternion operations
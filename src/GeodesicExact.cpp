@@ -28,6 +28,9 @@
 
 #include <GeographicLib/GeodesicExact.hpp>
 #include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/Instrument.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
 #include <vector>
 
 #if defined(_MSC_VER)
@@ -346,7 +349,8 @@ namespace GeographicLib {
       10,10,10,10,10,10,10,10,10,10,11,11,11,11,11,11,11,11,11,11,11,12,12,12,
       12,12,12,13,13,13,13,13,13,13,14,14,14,15,15,15,16,16,17,18,19,20
     };
-#elif GEOGRAPHICLIB_PRECISION == 4
+#elif GEOGRAPHICLIB_PRECISION == 4 || GEOGRAPHICLIB_PRECISION == 6
+    // The quad precision table also serves for double-double (106 bits)
     static const unsigned char narr[2*ndiv+1] = {
       25,24,22,21,20,19,19,18,18,17,17,17,17,16,16,16,15,15,15,15,15,15,15,14,
       14,14,14,14,14,13,13,13,13,13,13,13,13,13,13,13,13,12,12,12,12,12,12,12,
@@ -387,6 +391,42 @@ namespace GeographicLib {
 #endif
     _fft.reset(N);
     _nC4 = N;
+    // For a prolate ellipsoid with large N, most values of k2 need far fewer
+    // terms; so set up the smaller transforms which C4coeffs then refines as
+    // needed.  (This doesn't pay for oblate ellipsoids, since most values of
+    // k2 then require nearly all N terms.)
+    if (_n < 0)
+      for (int M = N/2; M >= nC4min_ && M % 2 == 0; M /= 2)
+        _fftx.insert(_fftx.begin(), DST(M));
+  }
+
+  int GeodesicExact::C4coeffs(real k2, real C4a[], real work[]) const {
+    I4Integrand i4(_ep2, k2);
+    // i4 is passed by reference so that the construction of the
+    // std::function doesn't allocate memory.
+    if (_fftx.empty()) {
+      _fft.transform(cref(i4), C4a, work);
+      return _nC4;
+    }
+    _fftx[0].transform(cref(i4), C4a, work);
+    int N = _fftx[0].N();
+    for (const DST& fft : _fftx) {
+      // The coefficients decrease geometrically until they reach the level
+      // of the roundoff errors in the transform.  Stop when those in the top
+      // half of the series are negligible compared to the leading one or
+      // when they have stopped decreasing, in which case refining the
+      // transform would only add noise.
+      real head = 0, tail = 0, scale = fabs(C4a[0]);
+      for (int l = N/4; l < N/2; ++l)
+        head = fmax(head, fabs(C4a[l]));
+      for (int l = N/2; l < N; ++l)
+        tail = fmax(tail, fabs(C4a[l]));
+      if (tail <= tol0_ * scale || (tail <= tol2_ * scale && 2 * tail >= head))
+        break;
+      fft.refine(cref(i4), C4a, work);
+      N *= 2;
+    }
+    return N;
   }
 
   const GeodesicExact& GeodesicExact::WGS84() {
@@ -624,8 +664,10 @@ namespace GeographicLib {
         // initial values to suppress warnings (if loop is executed 0 times)
         real ssig1 = 0, csig1 = 0, ssig2 = 0, csig2 = 0, domg12 = 0;
         unsigned numit = 0;
+        bool bisected = false;
         // Bracketing range
         real salp1a = tiny_, calp1a = 1, salp1b = tiny_, calp1b = -1;
+        GEOGRAPHICLIB_TRACE_SCOPE(GEODESICEXACT_ITERATE);
         for (bool tripn = false, tripb = false;; ++numit) {
           // 1/4 meridian = 10e6 m and random input.  max err is estimated max
           // error in nm (checking solution of inverse problem by direct
@@ -648,11 +690,10 @@ namespace GeographicLib {
           //     5    2352 6.32 3.44
           //     6    6008 6.30 3.45
           //     7   19024 6.19 3.30
-          real dv;
           real v = Lambda12(sbet1, cbet1, dn1, sbet2, cbet2, dn2, salp1, calp1,
                             slam12, clam12,
                             salp2, calp2, sig12, ssig1, csig1, ssig2, csig2,
-                            E, domg12, numit < maxit1_, dv);
+                            E, domg12);
           if (tripb ||
               // Reversed test to allow escape with NaNs
               !(fabs(v) >= (tripn ? 8 : 1) * tol0_) ||
@@ -664,6 +705,10 @@ namespace GeographicLib {
             { salp1b = salp1; calp1b = calp1; }
           else if (v < 0 && (numit > maxit1_ || calp1/salp1 < calp1a/salp1a))
             { salp1a = salp1; calp1a = calp1; }
+          // As in Geodesic, only compute the derivative if it's needed.
+          real dv = numit < maxit1_ ?
+            dLambda12(sbet1, cbet1, dn1, cbet2, dn2, calp2, sig12,
+                      ssig1, csig1, ssig2, csig2, E) : 0;
           if (numit < maxit1_ && dv > 0) {
             real
               dalp1 = -v/dv;
@@ -694,6 +739,7 @@ namespace GeographicLib {
           // 90deg:
           // the WGS84 test set: mean = 5.21, sd = 3.93, max = 24
           // WGS84 and random input: mean = 4.74, sd = 0.99
+          bisected = true;
           salp1 = (salp1a + salp1b)/2;
           calp1 = (calp1a + calp1b)/2;
           Math::norm(salp1, calp1);
@@ -701,6 +747,7 @@ namespace GeographicLib {
           tripb = (fabs(salp1a - salp1) + (calp1a - calp1) < tolb_ ||
                    fabs(salp1 - salp1b) + (calp1 - calp1b) < tolb_);
         }
+        GEOGRAPHICLIB_INSTRUMENT_RECORD(GEODESICEXACT, numit, bisected);
         {
           real dummy;
           Lengths(E, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
@@ -740,10 +787,15 @@ namespace GeographicLib {
           ssig2 = sbet2, csig2 = calp2 * cbet2;
         Math::norm(ssig1, csig1);
         Math::norm(ssig2, csig2);
-        I4Integrand i4(_ep2, k2);
-        vector<real> C4a(_nC4);
-        _fft.transform(i4, C4a.data());
-        S12 = A4 * DST::integral(ssig1, csig1, ssig2, csig2, C4a.data(), _nC4);
+        // A per-thread workspace, which only needs to be allocated when a
+        // larger size is needed, holds the coefficients and the workspace for
+        // the transform.
+        static thread_local vector<real> work;
+        if (work.size() < size_t(_nC4 + _fft.WorkSize()))
+          work.resize(_nC4 + _fft.WorkSize());
+        real* C4a = work.data();
+        int nC4 = C4coeffs(k2, C4a, C4a + _nC4);
+        S12 = A4 * DST::integral(ssig1, csig1, ssig2, csig2, C4a, nC4);
       } else
         // Avoid problems with indeterminate sig1, sig2 on equator
         S12 = 0;
@@ -816,6 +868,154 @@ namespace GeographicLib {
     return a12;
   }
 
+  void GeodesicExact::DirectBatch(size_t n,
+                                  const real lat1[], const real lon1[],
+                                  const real azi1[],
+                                  bool arcmode, const real s12_a12[],
+                                  unsigned outmask,
+                                  real lat2[], real lon2[], real azi2[],
+                                  real s12[], real m12[], real M12[],
+                                  real M21[], real S12[], real a12[],
+                                  int nthreads) const {
+    DirectBatch(n, StridedArray<const real>(lat1),
+                StridedArray<const real>(lon1), StridedArray<const real>(azi1),
+                arcmode, StridedArray<const real>(s12_a12), outmask,
+                StridedArray<real>(lat2), StridedArray<real>(lon2),
+                StridedArray<real>(azi2), StridedArray<real>(s12),
+                StridedArray<real>(m12), StridedArray<real>(M12),
+                StridedArray<real>(M21), StridedArray<real>(S12),
+                StridedArray<real>(a12), nthreads);
+  }
+
+  void GeodesicExact::DirectBatch(size_t n, StridedArray<const real> lat1,
+                                  StridedArray<const real> lon1,
+                                  StridedArray<const real> azi1,
+                                  bool arcmode,
+                                  StridedArray<const real> s12_a12,
+                                  unsigned outmask,
+                                  StridedArray<real> lat2,
+                                  StridedArray<real> lon2,
+                                  StridedArray<real> azi2,
+                                  StridedArray<real> s12,
+                                  StridedArray<real> m12,
+                                  StridedArray<real> M12,
+                                  StridedArray<real> M21,
+                                  StridedArray<real> S12,
+                                  StridedArray<real> a12,
+                                  int nthreads) const {
+    // Automatically supply DISTANCE_IN if necessary
+    if (!arcmode) outmask |= DISTANCE_IN;
+    const unsigned out = outmask & OUT_MASK;
+    const bool
+      latp = (out & LATITUDE) != 0,
+      lonp = (out & LONGITUDE) != 0,
+      azip = (out & AZIMUTH) != 0,
+      distp = (out & DISTANCE) != 0,
+      redlp = (out & REDUCEDLENGTH) != 0,
+      scalp = (out & GEODESICSCALE) != 0,
+      areap = (out & AREA) != 0;
+    // The problems are handed out to the tasks in chunks.
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      GeodesicLineExact line;
+      // The index of the problem for which line was initialized
+      size_t iline = n;
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t i = i0; i < min(n, i0 + chunk); ++i) {
+          // This follows GeodesicLineExact::GeodesicLineExact(g, lat1, lon1,
+          // azi1, caps) without constructing a new object.  LineInit keeps
+          // the elliptic integrals and the C4 coefficients if k2 is
+          // unchanged.
+          if (!(iline < n && lat1[i] == lat1[iline] &&
+                lon1[i] == lon1[iline] && azi1[i] == azi1[iline])) {
+            real azi = Math::AngNormalize(azi1[i]), salp1, calp1;
+            Math::sincosd(Math::AngRound(azi), salp1, calp1);
+            line.LineInit(*this, lat1[i], lon1[i], azi, salp1, calp1,
+                          outmask, iline < n);
+            iline = i;
+          }
+          real lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x,
+            a12x = line.GenPosition(arcmode, s12_a12[i], outmask,
+                                    lat2x, lon2x, azi2x,
+                                    s12x, m12x, M12x, M21x, S12x);
+          if (latp) lat2[i] = lat2x;
+          if (lonp) lon2[i] = lon2x;
+          if (azip) azi2[i] = azi2x;
+          if (distp) s12[i] = s12x;
+          if (redlp) m12[i] = m12x;
+          if (scalp) { M12[i] = M12x; M21[i] = M21x; }
+          if (areap) S12[i] = S12x;
+          if (a12) a12[i] = a12x;
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
+  void GeodesicExact::InverseBatch(size_t n,
+                                   const real lat1[], const real lon1[],
+                                   const real lat2[], const real lon2[],
+                                   unsigned outmask,
+                                   real s12[], real azi1[], real azi2[],
+                                   real m12[], real M12[], real M21[],
+                                   real S12[], real a12[], int nthreads) const {
+    InverseBatch(n, StridedArray<const real>(lat1),
+                 StridedArray<const real>(lon1),
+                 StridedArray<const real>(lat2),
+                 StridedArray<const real>(lon2), outmask,
+                 StridedArray<real>(s12), StridedArray<real>(azi1),
+                 StridedArray<real>(azi2), StridedArray<real>(m12),
+                 StridedArray<real>(M12), StridedArray<real>(M21),
+                 StridedArray<real>(S12), StridedArray<real>(a12), nthreads);
+  }
+
+  void GeodesicExact::InverseBatch(size_t n, StridedArray<const real> lat1,
+                                   StridedArray<const real> lon1,
+                                   StridedArray<const real> lat2,
+                                   StridedArray<const real> lon2,
+                                   unsigned outmask,
+                                   StridedArray<real> s12,
+                                   StridedArray<real> azi1,
+                                   StridedArray<real> azi2,
+                                   StridedArray<real> m12,
+                                   StridedArray<real> M12,
+                                   StridedArray<real> M21,
+                                   StridedArray<real> S12,
+                                   StridedArray<real> a12,
+                                   int nthreads) const {
+    outmask &= OUT_MASK;
+    const bool
+      distp = (outmask & DISTANCE) != 0,
+      azip = (outmask & AZIMUTH) != 0,
+      redlp = (outmask & REDUCEDLENGTH) != 0,
+      scalp = (outmask & GEODESICSCALE) != 0,
+      areap = (outmask & AREA) != 0;
+    // The problems are handed out to the tasks in chunks.
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t i = i0; i < min(n, i0 + chunk); ++i) {
+          real s12x, salp1, calp1, salp2, calp2, m12x, M12x, M21x, S12x,
+            a12x = GenInverse(lat1[i], lon1[i], lat2[i], lon2[i],
+                              outmask, s12x, salp1, calp1, salp2, calp2,
+                              m12x, M12x, M21x, S12x);
+          if (distp) s12[i] = s12x;
+          if (azip) {
+            azi1[i] = Math::atan2d(salp1, calp1);
+            azi2[i] = Math::atan2d(salp2, calp2);
+          }
+          if (redlp) m12[i] = m12x;
+          if (scalp) { M12[i] = M12x; M21[i] = M21x; }
+          if (areap) S12[i] = S12x;
+          if (a12) a12[i] = a12x;
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
   GeodesicLineExact GeodesicExact::InverseLine(real lat1, real lon1,
                                                real lat2, real lon2,
                                                unsigned caps) const {
@@ -1086,8 +1286,7 @@ namespace GeographicLib {
                                      real& ssig1, real& csig1,
                                      real& ssig2, real& csig2,
                                      EllipticFunction& E,
-                                     real& domg12,
-                                     bool diffp, real& dlam12) const
+                                     real& domg12) const
     {
 
     if (sbet1 == 0 && calp1 == 0)
@@ -1158,21 +1357,25 @@ namespace GeographicLib {
     // domg12 = deta12 + chi12 - omg12
     domg12 = deta12 + atan2(schi12 * comg12 - cchi12 * somg12,
                             cchi12 * comg12 + schi12 * somg12);
-    if (diffp) {
-      if (calp2 == 0)
-        dlam12 = - 2 * _f1 * dn1 / sbet1;
-      else {
-        real dummy;
-        Lengths(E, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
-                cbet1, cbet2, REDUCEDLENGTH,
-                dummy, dlam12, dummy, dummy, dummy);
-        dlam12 *= _f1 / (calp2 * cbet2);
-      }
-    }
 
     return lam12;
   }
 
+  Math::real GeodesicExact::dLambda12(real sbet1, real cbet1, real dn1,
+                                      real cbet2, real dn2,
+                                      real calp2, real sig12,
+                                      real ssig1, real csig1,
+                                      real ssig2, real csig2,
+                                      const EllipticFunction& E) const {
+    if (calp2 == 0)
+      return - 2 * _f1 * dn1 / sbet1;
+    real dlam12, dummy;
+    Lengths(E, sig12, ssig1, csig1, dn1, ssig2, csig2, dn2,
+            cbet1, cbet2, REDUCEDLENGTH,
+            dummy, dlam12, dummy, dummy, dummy);
+    return dlam12 * (_f1 / (calp2 * cbet2));
+  }
+
   Math::real GeodesicExact::I4Integrand::asinhsqrt(real x) {
     // return asinh(sqrt(x))/sqrt(x)
     return x == 0 ? 1 :
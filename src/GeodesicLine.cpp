@@ -2,7 +2,7 @@
  * \file GeodesicLine.cpp
  * \brief Implementation for GeographicLib::GeodesicLine class
  *
- * Copyright (c) Charles Karney (2009-2023) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2009-2024) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  *
@@ -27,6 +27,8 @@
  **********************************************************************/
 
 #include <GeographicLib/GeodesicLine.hpp>
+#include <algorithm>
+#include <functional>
 
 #if defined(_MSC_VER)
 // Squelch warnings about mixing enums
@@ -144,6 +146,26 @@ namespace GeographicLib {
     GenSetDistance(arcmode, s13_a13);
   }
 
+  GeodesicLine::GeodesicLine(const Geodesic& g, const Compact& line)
+    : _caps(0U) {
+    if (!line.Init()) return;
+    LineInit(g, line._lat1, line._lon1, line._azi1, line._salp1, line._calp1,
+             line._caps);
+    _a13 = line._a13;
+    _s13 = line._s13;
+  }
+
+  GeodesicLine::Compact GeodesicLine::Compress() const {
+    Compact line;
+    if (Init()) {
+      line._lat1 = _lat1; line._lon1 = _lon1; line._azi1 = _azi1;
+      line._salp1 = _salp1; line._calp1 = _calp1;
+      line._a13 = _a13; line._s13 = _s13;
+      line._caps = _caps;
+    }
+    return line;
+  }
+
   Math::real GeodesicLine::GenPosition(bool arcmode, real s12_a12,
                                        unsigned outmask,
                                        real& lat2, real& lon2, real& azi2,
@@ -154,6 +176,25 @@ namespace GeographicLib {
       return _lineexact.GenPosition(arcmode, s12_a12, outmask,
                                     lat2, lon2, azi2,
                                     s12, m12, M12, M21, S12);
+    real s, c;
+    if (arcmode)
+      Math::sincosd(s12_a12, s, c);
+    else {
+      real tau12 = s12_a12 / (_b * (1 + _aA1m1));
+      s = sin(tau12); c = cos(tau12);
+    }
+    return IntPosition(arcmode, s12_a12, s, c, outmask,
+                       lat2, lon2, azi2, s12, m12, M12, M21, S12);
+  }
+
+  Math::real GeodesicLine::IntPosition(bool arcmode, real s12_a12,
+                                       real s, real c,
+                                       unsigned outmask,
+                                       real& lat2, real& lon2, real& azi2,
+                                       real& s12, real& m12,
+                                       real& M12, real& M21,
+                                       real& S12) const {
+    // s and c are the sine and cosine of a12 (if arcmode) or of tau12
     outmask &= _caps & OUT_MASK;
     if (!( Init() && (arcmode || (_caps & (OUT_MASK & DISTANCE_IN))) ))
       // Uninitialized or impossible distance calculation requested
@@ -164,13 +205,10 @@ namespace GeographicLib {
     if (arcmode) {
       // Interpret s12_a12 as spherical arc length
       sig12 = s12_a12 * Math::degree();
-      Math::sincosd(s12_a12, ssig12, csig12);
+      ssig12 = s; csig12 = c;
     } else {
       // Interpret s12_a12 as distance
-      real
-        tau12 = s12_a12 / (_b * (1 + _aA1m1)),
-        s = sin(tau12),
-        c = cos(tau12);
+      real tau12 = s12_a12 / (_b * (1 + _aA1m1));
       // tau2 = tau1 + tau12
       B12 = - Geodesic::SinCosSeries(true,
                                      _stau1 * c + _ctau1 * s,
@@ -313,6 +351,234 @@ namespace GeographicLib {
     return arcmode ? s12_a12 : sig12 / Math::degree();
   }
 
+  void GeodesicLine::GenPositions(bool arcmode, size_t n,
+                                  const real s12_a12[], unsigned outmask,
+                                  real lat2[], real lon2[], real azi2[],
+                                  real s12[], real m12[],
+                                  real M12[], real M21[], real S12[],
+                                  real a12[]) const {
+    real t;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = GenPosition(arcmode, s12_a12[i], outmask,
+                              Slot(lat2, i, t), Slot(lon2, i, t),
+                              Slot(azi2, i, t), Slot(s12, i, t),
+                              Slot(m12, i, t), Slot(M12, i, t),
+                              Slot(M21, i, t), Slot(S12, i, t));
+      if (a12) a12[i] = a12x;
+    }
+  }
+
+  void GeodesicLine::GenPositionsUniform(bool arcmode, real s0_a0,
+                                         real ds_da, size_t n,
+                                         unsigned outmask,
+                                         real lat2[], real lon2[],
+                                         real azi2[], real s12[], real m12[],
+                                         real M12[], real M21[], real S12[],
+                                         real a12[]) const {
+    Stepper stepper(*this, arcmode, s0_a0, ds_da);
+    real t;
+    for (size_t i = 0; i < n; ++i) {
+      real a12x = stepper.GenNext(outmask,
+                                  Slot(lat2, i, t), Slot(lon2, i, t),
+                                  Slot(azi2, i, t), Slot(s12, i, t),
+                                  Slot(m12, i, t), Slot(M12, i, t),
+                                  Slot(M21, i, t), Slot(S12, i, t));
+      if (a12) a12[i] = a12x;
+    }
+  }
+
+  GeodesicLine::Stepper::Stepper(const GeodesicLine& line, bool arcmode,
+                                 real s0_a0, real ds_da)
+    : _line(&line)
+    , _arcmode(arcmode)
+    , _x0(s0_a0)
+    , _dx(ds_da)
+    , _scale(arcmode ? 1 : line._b * (1 + line._aA1m1))
+    , _s(0)
+    , _c(1)
+    , _i(0)
+  {
+    if (arcmode)
+      Math::sincosd(ds_da, _sd, _cd);
+    else {
+      _sd = sin(ds_da / _scale); _cd = cos(ds_da / _scale);
+    }
+  }
+
+  Math::real GeodesicLine::Stepper::GenNext(unsigned outmask,
+                                            real& lat2, real& lon2,
+                                            real& azi2, real& s12,
+                                            real& m12, real& M12, real& M21,
+                                            real& S12) {
+    // The sine and cosine of a12 (in arcmode) or of tau12 are advanced from
+    // one point to the next with the angle-addition formulas.  To prevent
+    // the accumulation of roundoff errors, they are recomputed directly
+    // every resync_ points.
+    static const unsigned resync_ = 16;
+    real x = Current(), a12;
+    if (_line->_exact)
+      a12 = _line->_lineexact.GenPosition(_arcmode, x, outmask,
+                                          lat2, lon2, azi2,
+                                          s12, m12, M12, M21, S12);
+    else {
+      if (_i % resync_ == 0) {
+        if (_arcmode)
+          Math::sincosd(x, _s, _c);
+        else {
+          _s = sin(x / _scale); _c = cos(x / _scale);
+        }
+      } else {
+        real s1 = _s * _cd + _c * _sd;
+        _c = _c * _cd - _s * _sd; _s = s1;
+      }
+      a12 = _line->IntPosition(_arcmode, x, _s, _c, outmask,
+                               lat2, lon2, azi2, s12, m12, M12, M21, S12);
+    }
+    ++_i;
+    return a12;
+  }
+
+  size_t GeodesicLine::Densify(real ds, vector<real>& lat, vector<real>& lon,
+                               bool unroll) const {
+    lat.clear(); lon.clear();
+    real s13 = Distance();
+    if (!(ds > 0 && isfinite(s13) && Capabilities(DISTANCE_IN | LONGITUDE)))
+      return 0;
+    real m = fmax(real(1), ceil(fabs(s13) / ds));
+    if (!(m < real(numeric_limits<int>::max())))
+      return 0;
+    size_t n = size_t(m) + 1;
+    lat.resize(n); lon.resize(n);
+    GenPositionsUniform(false, 0, s13 / m, n,
+                        LATITUDE | LONGITUDE | (unroll ? LONG_UNROLL : NONE),
+                        lat.data(), lon.data(), nullptr, nullptr, nullptr,
+                        nullptr, nullptr, nullptr);
+    // Make the last point exactly point 3
+    real t;
+    GenPosition(false, s13,
+                LATITUDE | LONGITUDE | (unroll ? LONG_UNROLL : NONE),
+                lat[n-1], lon[n-1], t, t, t, t, t, t);
+    return n;
+  }
+
+  size_t GeodesicLine::LatitudeCrossing(real lat, vector<real>& a12) const {
+    a12.clear();
+    if (!(Init() && isfinite(_a13) && fabs(lat) <= Math::qd && _calp0 > 0))
+      return 0;
+    real sbet, cbet;
+    Math::sincosd(lat, sbet, cbet); sbet *= _f1; Math::norm(sbet, cbet);
+    // sin(bet) = cos(alp0) * sin(sig)
+    real s = sbet / _calp0;
+    if (!(fabs(s) <= 1))
+      return 0;
+    // Work in degrees.  The crossings are at sig = siga + td * k and sig =
+    // hd - siga + td * k; with |s| = 1 these coincide (modulo td).
+    real sig1 = Math::atan2d(_ssig1, _csig1),
+      siga = Math::atan2d(s, sqrt((1 - s) * (1 + s))),
+      lo = fmin(real(0), _a13) + sig1, hi = fmax(real(0), _a13) + sig1;
+    for (int j = 0; j < (fabs(s) < 1 ? 2 : 1); ++j) {
+      real sig0 = j == 0 ? siga : Math::hd - siga;
+      for (real k = ceil((lo - sig0) / Math::td);
+           k <= floor((hi - sig0) / Math::td); ++k)
+        a12.push_back(sig0 + Math::td * k - sig1);
+    }
+    if (_a13 >= 0)
+      sort(a12.begin(), a12.end());
+    else
+      sort(a12.begin(), a12.end(), greater<real>());
+    return a12.size();
+  }
+
+  size_t GeodesicLine::LongitudeCrossing(real lon, vector<real>& a12) const {
+    a12.clear();
+    if (!(Init() && isfinite(_a13) && isfinite(lon) &&
+          Capabilities(LONGITUDE) && _salp0 != 0))
+      return 0;
+    static const int maxit_ = 10;
+    static const real tol_ = sqrt(numeric_limits<real>::epsilon());
+    real t, lon3;
+    GenPosition(true, _a13, LONGITUDE | LONG_UNROLL,
+                t, lon3, t, t, t, t, t, t);
+    // Work with Omg = E * omg which increases with sig and coincides with it
+    // at multiples of qd, i.e., tan(Omg) = |sin(alp0)| * tan(sig).
+    real E = copysign(real(1), _salp0), salp0 = fabs(_salp0),
+      e2 = _f * (2 - _f),
+      sig1 = Math::atan2d(_ssig1, _csig1),
+      Omg1 = Math::atan2d(E * _somg1, _comg1),
+      // The unrolled longitudes of the meridian are lon + td * k.
+      k0 = ceil((fmin(_lon1, lon3) - lon) / Math::td),
+      k1 = floor((fmax(_lon1, lon3) - lon) / Math::td);
+    // The arc length given Omg12; sig2 is in the same quarter turn as Omg2.
+    auto arc = [E, salp0, sig1, Omg1](real Omg12) -> real {
+      real Omg2 = Omg1 + Omg12, r = remainder(Omg2, real(Math::hd)), sr, cr;
+      Math::sincosd(r, sr, cr);
+      return (Omg2 - r) + Math::atan2d(sr, salp0 * cr) - sig1;
+    };
+    for (real k = k0; k <= k1; ++k) {
+      real lam12 = lon + Math::td * (lon3 >= _lon1 ? k : k0 + k1 - k) - _lon1,
+        // Starting guess lam12 = E * Omg12 * (1 - f * |sin(alp0)|)
+        Omg12 = E * lam12 / (1 - _f * salp0);
+      for (int i = 0; i < maxit_; ++i) {
+        real a = arc(Omg12), lon2;
+        GenPosition(true, a, LONGITUDE | LONG_UNROLL,
+                    t, lon2, t, t, t, t, t, t);
+        // d(lam)/d(omg) = sqrt(1 - e2 * cos(bet)^2)
+        real w = sqrt(1 - e2 * (1 - Math::_sq(_calp0 * Math::sind(a + sig1)))),
+          dOmg = E * (lon2 - _lon1 - lam12) / w;
+        Omg12 -= dOmg;
+        if (!(fabs(dOmg) > tol_)) break;
+      }
+      real a = arc(Omg12);
+      a12.push_back(a);
+    }
+    return a12.size();
+  }
+
+  GeodesicLine::SegmentBounds GeodesicLine::Bounds(real s1, real s2) const {
+    SegmentBounds b;
+    b.latmin = b.latmax = b.lonmin = b.lonmax = b.lat0 = b.lon0 = b.radius =
+      Math::NaN();
+    if (!(Init() && Capabilities(DISTANCE_IN | LONGITUDE)))
+      return b;
+    const unsigned mask = LATITUDE | LONGITUDE | LONG_UNROLL;
+    real lat1, lon1, lat2, lon2, t,
+      a1 = GenPosition(false, s1, mask, lat1, lon1, t, t, t, t, t, t),
+      a2 = GenPosition(false, s2, mask, lat2, lon2, t, t, t, t, t, t),
+      // The northern and southern vertices are at sig = +/-qd + td * k
+      sig1 = Math::atan2d(_ssig1, _csig1),
+      siglo = fmin(a1, a2) + sig1, sighi = fmax(a1, a2) + sig1,
+      latv = Math::atan2d(_calp0, _f1 * fabs(_salp0));
+    b.latmin = fmin(lat1, lat2); b.latmax = fmax(lat1, lat2);
+    if (ceil((siglo - Math::qd) / Math::td) <=
+        floor((sighi - Math::qd) / Math::td))
+      b.latmax = latv;
+    if (ceil((siglo + Math::qd) / Math::td) <=
+        floor((sighi + Math::qd) / Math::td))
+      b.latmin = -latv;
+    // The unrolled longitude is monotonic
+    real dlon = fabs(lon2 - lon1);
+    if (dlon < Math::td) {
+      b.lonmin = Math::AngNormalize(fmin(lon1, lon2));
+      b.lonmax = b.lonmin + dlon;
+    } else {
+      b.lonmin = -Math::hd; b.lonmax = Math::hd;
+    }
+    GenPosition(false, (s1 + s2) / 2, LATITUDE | LONGITUDE,
+                b.lat0, b.lon0, t, t, t, t, t, t);
+    b.radius = fabs(s2 - s1) / 2;
+    return b;
+  }
+
+  void GeodesicLine::Bounds(const Geodesic& g, size_t n,
+                            const real lat[], const real lon[],
+                            SegmentBounds bounds[]) {
+    for (size_t i = 0; i + 1 < n; ++i) {
+      GeodesicLine l = g.InverseLine(lat[i], lon[i], lat[i+1], lon[i+1],
+                                     LATITUDE | LONGITUDE | DISTANCE_IN);
+      bounds[i] = l.Bounds(0, l.Distance());
+    }
+  }
+
   void GeodesicLine::SetDistance(real s13) {
     _s13 = s13;
     real t;
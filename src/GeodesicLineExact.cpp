@@ -27,6 +27,8 @@
  **********************************************************************/
 
 #include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
 
 #if defined(_MSC_VER)
 // Squelch warnings about mixing enums
@@ -40,7 +42,11 @@ namespace GeographicLib {
   void GeodesicLineExact::LineInit(const GeodesicExact& g,
                                    real lat1, real lon1,
                                    real azi1, real salp1, real calp1,
-                                   unsigned caps) {
+                                   unsigned caps, bool reuse) {
+    // The state from the previous initialization which may be reused
+    const unsigned caps0 = reuse ? _caps : 0U;
+    const real k20 = reuse ? _k2 : 0, aA40 = caps0 & CAP_C4 ? _aA4 : 0;
+    const int nC40 = reuse ? _nC4 : 0;
     tiny_ = g.tiny_;
     _lat1 = Math::LatFix(lat1);
     _lon1 = lon1;
@@ -87,7 +93,9 @@ namespace GeographicLib {
     // Math::norm(_schi1, _cchi1); -- don't need to normalize!
 
     _k2 = Math::_sq(_calp0) * g._ep2;
-    _eE.Reset(-_k2, -g._ep2, 1 + _k2, 1 + g._ep2);
+    const bool samek2 = caps0 != 0 && _k2 == k20;
+    if (!samek2)
+      _eE.Reset(-_k2, -g._ep2, 1 + _k2, 1 + g._ep2);
 
     if (_caps & CAP_E) {
       _eE0 = _eE.E() / (Math::pi() / 2);
@@ -116,9 +124,15 @@ namespace GeographicLib {
       if (_aA4 == 0)
         _bB41 = 0;
       else {
-        GeodesicExact::I4Integrand i4(g._ep2, _k2);
-        _cC4a.resize(_nC4);
-        g._fft.transform(i4, _cC4a.data());
+        if (samek2 && aA40 != 0)
+          // The coefficients depend only on k2
+          _nC4 = nC40;
+        else {
+          vector<real> work(g._fft.WorkSize());
+          _cC4a.resize(_nC4);
+          _nC4 = g.C4coeffs(_k2, _cC4a.data(), work.data());
+          _cC4a.resize(_nC4);
+        }
         _bB41 = DST::integral(_ssig1, _csig1, _cC4a.data(), _nC4);
       }
     }
@@ -274,6 +288,31 @@ namespace GeographicLib {
     return arcmode ? s12_a12 : sig12 / Math::degree();
   }
 
+  void GeodesicLineExact::GenPositions(bool arcmode, size_t n,
+                                       const real s12_a12[], unsigned outmask,
+                                       real lat2[], real lon2[], real azi2[],
+                                       real s12[], real m12[],
+                                       real M12[], real M21[], real S12[],
+                                       real a12[], int nthreads) const {
+    // The points are handed out to the tasks in chunks.
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      real t;
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t i = i0; i < min(n, i0 + chunk); ++i) {
+          real a12x = GenPosition(arcmode, s12_a12[i], outmask,
+                                  Slot(lat2, i, t), Slot(lon2, i, t),
+                                  Slot(azi2, i, t), Slot(s12, i, t),
+                                  Slot(m12, i, t), Slot(M12, i, t),
+                                  Slot(M21, i, t), Slot(S12, i, t));
+          if (a12) a12[i] = a12x;
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
   void GeodesicLineExact::SetDistance(real s13) {
     _s13 = s13;
     real t;
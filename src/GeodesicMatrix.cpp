@@ -0,0 +1,166 @@
+/**
+ * \file GeodesicMatrix.cpp
+ * \brief Implementation for GeographicLib::GeodesicMatrix class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicMatrix.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicMatrix::GeodesicMatrix(const Geodesic& geod,
+                                 size_t nrows,
+                                 const real lat1[], const real lon1[],
+                                 size_t ncols,
+                                 const real lat2[], const real lon2[])
+    : _geod(geod)
+    , _nrows(nrows)
+    , _ncols(ncols)
+  {
+    Points(_nrows, lat1, lon1, _rows);
+    Points(_ncols, lat2, lon2, _cols);
+  }
+
+  void GeodesicMatrix::Points(size_t n, const real lat[], const real lon[],
+                              vector<real>& pts) const {
+    pts.resize(n * stride_);
+    for (size_t i = 0; i < n; ++i) {
+      real* p = &pts[i * stride_];
+      p[0] = lat[i]; p[4] = lon[i];
+      if (_geod._exact)
+        p[1] = p[2] = p[3] = 0;
+      else
+        _geod.InversePoint(p[0], p[1], p[2], p[3]);
+    }
+  }
+
+  void GeodesicMatrix::Pair(const real* p1, const real* p2, unsigned outmask,
+                            real& s12, real& salp1, real& calp1,
+                            real& salp2, real& calp2) const {
+    real t;
+    if (_geod._exact)
+      _geod.GenInverse(p1[0], p1[4], p2[0], p2[4],
+                       outmask, s12, salp1, calp1, salp2, calp2,
+                       t, t, t, t);
+    else
+      _geod.IntInverse(p1[0], p1[1], p1[2], p1[3], p1[4],
+                       p2[0], p2[1], p2[2], p2[3], p2[4],
+                       outmask, s12, salp1, calp1, salp2, calp2,
+                       t, t, t, t);
+  }
+
+  void GeodesicMatrix::GenRows(size_t row0, size_t row1, unsigned outmask,
+                               real s12[], real azi1[], real azi2[]) const {
+    outmask &= Geodesic::DISTANCE | Geodesic::AZIMUTH;
+    const bool
+      distp = (outmask & Geodesic::DISTANCE) != 0,
+      azip = (outmask & Geodesic::AZIMUTH) != 0;
+    row1 = min(row1, _nrows);
+    for (size_t col0 = 0; col0 < _ncols; col0 += block_) {
+      size_t col1 = min(col0 + block_, _ncols);
+      for (size_t i = row0; i < row1; ++i) {
+        const real* p1 = &_rows[i * stride_];
+        for (size_t j = col0; j < col1; ++j) {
+          const real* p2 = &_cols[j * stride_];
+          real s12x, salp1, calp1, salp2, calp2;
+          Pair(p1, p2, outmask, s12x, salp1, calp1, salp2, calp2);
+          size_t k = i * _ncols + j;
+          if (distp) s12[k] = s12x;
+          if (azip) {
+            azi1[k] = Math::atan2d(salp1, calp1);
+            azi2[k] = Math::atan2d(salp2, calp2);
+          }
+        }
+      }
+    }
+  }
+
+  void GeodesicMatrix::WriteDistances(const string& filename,
+                                      unsigned format, bool resume,
+                                      int nthreads, size_t tilerows) const {
+    format &= FLOAT32 | SYMMETRIC;
+    const bool single = (format & FLOAT32) != 0,
+      symm = (format & SYMMETRIC) != 0;
+    if (symm && !(_nrows == _ncols && _rows == _cols))
+      throw GeographicErr("Symmetric storage needs the rows and columns "
+                          "to be the same points");
+    const size_t esize = single ? sizeof(float) : sizeof(double);
+    if (tilerows == 0)
+      tilerows = max(size_t(1), (size_t(1) << 23) / max(size_t(1), _ncols));
+    // The header: magic, rows, columns, format, rows done, 3 x reserved
+    const size_t nhdr = header_ / sizeof(uint64_t);
+    uint64_t hdr[nhdr] = {0};
+    const char magic[] = "GEODMAT1";
+    memcpy(&hdr[0], magic, sizeof(uint64_t));
+    hdr[1] = _nrows; hdr[2] = _ncols; hdr[3] = format;
+    size_t done = 0;
+    fstream file;
+    if (resume) {
+      file.open(filename, ios::in | ios::out | ios::binary);
+      if (file.is_open()) {
+        uint64_t fhdr[nhdr];
+        file.read(reinterpret_cast<char*>(fhdr), header_);
+        if (!(file.good() && fhdr[0] == hdr[0] && fhdr[1] == hdr[1] &&
+              fhdr[2] == hdr[2] && fhdr[3] == hdr[3] && fhdr[4] <= _nrows))
+          throw GeographicErr("File " + filename + " doesn't hold a "
+                              "distance matrix with the same size and "
+                              "format");
+        done = size_t(fhdr[4]);
+      }
+    }
+    if (!file.is_open()) {
+      file.open(filename, ios::in | ios::out | ios::binary | ios::trunc);
+      file.write(reinterpret_cast<const char*>(hdr), header_);
+      if (!file.good())
+        throw GeographicErr("Cannot write " + filename);
+    }
+    if (done >= _nrows) return;
+    vector<char> buf;
+    for (size_t row0 = done; row0 < _nrows;) {
+      const size_t row1 = min(_nrows, row0 + tilerows),
+        k0 = RowStart(_ncols, row0, symm);
+      buf.resize((RowStart(_ncols, row1, symm) - k0) * esize);
+      atomic<size_t> next(row0);
+      auto worker = [&](int) -> void {
+        for (size_t i; (i = next.fetch_add(1)) < row1;) {
+          const real* p1 = &_rows[i * stride_];
+          char* out = &buf[(RowStart(_ncols, i, symm) - k0) * esize];
+          for (size_t j = symm ? i : 0; j < _ncols; ++j) {
+            real s12, salp1, calp1, salp2, calp2;
+            Pair(p1, &_cols[j * stride_], Geodesic::DISTANCE,
+                 s12, salp1, calp1, salp2, calp2);
+            if (single) {
+              float x = float(s12); memcpy(out, &x, esize);
+            } else {
+              double x = double(s12); memcpy(out, &x, esize);
+            }
+            out += esize;
+          }
+        }
+      };
+      Executor::Batch(int(min(size_t(max(1, nthreads)), row1 - row0)),
+                      worker);
+      file.seekp(streamoff(header_ + k0 * esize));
+      file.write(buf.data(), streamsize(buf.size()));
+      file.flush();
+      // Only record the tile as done after its data has been written.
+      hdr[4] = row0 = row1;
+      file.seekp(streamoff(4 * sizeof(uint64_t)));
+      file.write(reinterpret_cast<const char*>(&hdr[4]), sizeof(uint64_t));
+      file.flush();
+      if (!file.good())
+        throw GeographicErr("Error writing " + filename);
+    }
+  }
+
+} // namespace GeographicLib
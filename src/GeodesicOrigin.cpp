@@ -0,0 +1,80 @@
+/**
+ * \file GeodesicOrigin.cpp
+ * \brief Implementation for GeographicLib::GeodesicOrigin class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicOrigin.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicOrigin::GeodesicOrigin(const Geodesic& g, real lat1, real lon1)
+    : _geod(g)
+    , _lat1(Math::LatFix(lat1))
+    , _lon1(lon1)
+    , _latr1(lat1)
+  {
+    if (_geod._exact)
+      _sbet1 = _cbet1 = _dn1 = 0;
+    else
+      _geod.InversePoint(_latr1, _sbet1, _cbet1, _dn1);
+  }
+
+  Math::real GeodesicOrigin::GenInverse(real lat2, real lon2,
+                                        unsigned outmask,
+                                        real& s12, real& azi1, real& azi2,
+                                        real& m12, real& M12, real& M21,
+                                        real& S12) const {
+    outmask &= Geodesic::OUT_MASK;
+    real salp1, calp1, salp2, calp2, a12;
+    if (_geod._exact)
+      a12 = _geod.GenInverse(_lat1, _lon1, lat2, lon2,
+                             outmask, s12, salp1, calp1, salp2, calp2,
+                             m12, M12, M21, S12);
+    else {
+      real sbet2, cbet2, dn2;
+      _geod.InversePoint(lat2, sbet2, cbet2, dn2);
+      a12 = _geod.IntInverse(_latr1, _sbet1, _cbet1, _dn1, _lon1,
+                             lat2, sbet2, cbet2, dn2, lon2,
+                             outmask, s12, salp1, calp1, salp2, calp2,
+                             m12, M12, M21, S12);
+    }
+    if (outmask & Geodesic::AZIMUTH) {
+      azi1 = Math::atan2d(salp1, calp1);
+      azi2 = Math::atan2d(salp2, calp2);
+    }
+    return a12;
+  }
+
+  void GeodesicOrigin::InverseBatch(size_t n,
+                                    const real lat2[], const real lon2[],
+                                    unsigned outmask,
+                                    real s12[], real azi1[], real azi2[],
+                                    real m12[], real M12[], real M21[],
+                                    real S12[], real a12[]) const {
+    outmask &= Geodesic::OUT_MASK;
+    const bool
+      distp = (outmask & Geodesic::DISTANCE) != 0,
+      azip = (outmask & Geodesic::AZIMUTH) != 0,
+      redlp = (outmask & Geodesic::REDUCEDLENGTH) != 0,
+      scalp = (outmask & Geodesic::GEODESICSCALE) != 0,
+      areap = (outmask & Geodesic::AREA) != 0;
+    for (size_t i = 0; i < n; ++i) {
+      real s12x, azi1x, azi2x, m12x, M12x, M21x, S12x,
+        a12x = GenInverse(lat2[i], lon2[i], outmask,
+                          s12x, azi1x, azi2x, m12x, M12x, M21x, S12x);
+      if (distp) s12[i] = s12x;
+      if (azip) { azi1[i] = azi1x; azi2[i] = azi2x; }
+      if (redlp) m12[i] = m12x;
+      if (scalp) { M12[i] = M12x; M21[i] = M21x; }
+      if (areap) S12[i] = S12x;
+      if (a12) a12[i] = a12x;
+    }
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,114 @@
+/**
+ * \file GeodesicStart.cpp
+ * \brief Implementation for GeographicLib::GeodesicStart class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeodesicStart.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeodesicStart::GeodesicStart(const Geodesic& g, int n)
+    : _geod(g)
+    , _n(n)
+  {
+    if (!(_n > 0))
+      throw GeographicErr("Number of intervals must be positive");
+    if (_geod._exact) return;
+    _delta.resize(size_t(_n + 1) * (_n + 1) * (2 * _n + 1));
+    real Ca[Geodesic::nC_];
+    size_t l = 0;
+    for (int i = 0; i <= _n; ++i) {
+      real lat1 = -Math::qd * i / _n, sbet1, cbet1, dn1;
+      _geod.InversePoint(lat1, sbet1, cbet1, dn1);
+      for (int j = 0; j <= _n; ++j) {
+        real lat2 = lat1 * (1 - real(2 * j) / _n), sbet2, cbet2, dn2;
+        _geod.InversePoint(lat2, sbet2, cbet2, dn2);
+        for (int k = 0; k <= 2 * _n; ++k, ++l) {
+          real lon12 = Math::qd * k / _n, slam12, clam12,
+            t, salp1, calp1, salp2, calp2, dnm;
+          // The solution of the problem, which is in canonical form ...
+          _geod.IntInverse(lat1, sbet1, cbet1, dn1, 0,
+                           lat2, sbet2, cbet2, dn2, lon12,
+                           0u, t, salp1, calp1, salp2, calp2, t, t, t, t);
+          // ... and InverseStart's guess for it
+          real salp1g, calp1g;
+          Math::sincosd(lon12, slam12, clam12);
+          _geod.InverseStart(sbet1, cbet1, dn1, sbet2, cbet2, dn2,
+                             lon12 * Math::degree(), slam12, clam12,
+                             salp1g, calp1g, salp2, calp2, dnm, Ca);
+          _delta[l] = float(atan2(salp1 * calp1g - calp1 * salp1g,
+                                  calp1 * calp1g + salp1 * salp1g));
+        }
+      }
+    }
+  }
+
+  void GeodesicStart::Correct(real lat1, real lat2, real lon12,
+                              real& salp1, real& calp1) const {
+    // Find the cell of the table containing the problem.  fmax and fmin
+    // replace NaNs by the limits.
+    real
+      u = fmin(fmax(-lat1 / Math::qd * _n, real(0)), real(_n)),
+      v = fmin(fmax(lat1 == 0 ? real(_n) / 2 : (1 - lat2 / lat1) / 2 * _n,
+                    real(0)), real(_n)),
+      w = fmin(fmax(lon12 / Math::qd * _n, real(0)), real(2 * _n));
+    int i = min(int(u), _n - 1), j = min(int(v), _n - 1),
+      k = min(int(w), 2 * _n - 1);
+    u -= i; v -= j; w -= k;
+    const int sj = 2 * _n + 1, si = (_n + 1) * sj;
+    const float* p = &_delta[size_t(i) * si + size_t(j) * sj + k];
+    real lo = p[0], hi = p[0], d = 0;
+    for (int c = 0; c < 8; ++c) {
+      real x = p[(c & 1 ? si : 0) + (c & 2 ? sj : 0) + (c & 4 ? 1 : 0)];
+      lo = fmin(lo, x); hi = fmax(hi, x);
+      d += x * (c & 1 ? u : 1 - u) * (c & 2 ? v : 1 - v) *
+        (c & 4 ? w : 1 - w);
+    }
+    // Don't use the table where the correction isn't smooth.
+    if (!(hi - lo <= Math::degree())) return;
+    // Rotate alp1 by d using the Taylor series for sin(d) and cos(d); d is
+    // small so the normalization takes care of the truncation error.
+    real sd = d * (1 - Math::_sq(d) / 6), cd = 1 - Math::_sq(d) / 2,
+      nsalp1 = salp1 * cd + calp1 * sd;
+    if (nsalp1 > 0) {
+      calp1 = calp1 * cd - salp1 * sd;
+      salp1 = nsalp1;
+      Math::norm(salp1, calp1);
+    }
+  }
+
+  Math::real GeodesicStart::GenInverse(real lat1, real lon1,
+                                       real lat2, real lon2,
+                                       unsigned outmask,
+                                       real& s12, real& azi1, real& azi2,
+                                       real& m12, real& M12, real& M21,
+                                       real& S12) const {
+    outmask &= Geodesic::OUT_MASK;
+    real salp1, calp1, salp2, calp2, a12;
+    if (_geod._exact)
+      a12 = _geod.GenInverse(lat1, lon1, lat2, lon2,
+                             outmask, s12, salp1, calp1, salp2, calp2,
+                             m12, M12, M21, S12);
+    else {
+      real sbet1, cbet1, dn1, sbet2, cbet2, dn2;
+      _geod.InversePoint(lat1, sbet1, cbet1, dn1);
+      _geod.InversePoint(lat2, sbet2, cbet2, dn2);
+      a12 = _geod.IntInverse(lat1, sbet1, cbet1, dn1, lon1,
+                             lat2, sbet2, cbet2, dn2, lon2,
+                             outmask, s12, salp1, calp1, salp2, calp2,
+                             m12, M12, M21, S12, false, this);
+    }
+    if (outmask & Geodesic::AZIMUTH) {
+      azi1 = Math::atan2d(salp1, calp1);
+      azi2 = Math::atan2d(salp2, calp2);
+    }
+    return a12;
+  }
+
+} // namespace GeographicLib
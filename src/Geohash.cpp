@@ -9,6 +9,7 @@
 
 #include <GeographicLib/Geohash.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Geodesic.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -22,7 +23,10 @@ namespace GeographicLib {
   const char* const Geohash::lcdigits_ = "0123456789bcdefghjkmnpqrstuvwxyz";
   const char* const Geohash::ucdigits_ = "0123456789BCDEFGHJKMNPQRSTUVWXYZ";
 
-  void Geohash::Forward(real lat, real lon, int len, string& geohash) {
+  bool Geohash::Scale(real lat, real lon,
+                      unsigned long long& ulon, unsigned long long& ulat) {
+    // Convert lat and lon to 46-bit unsigned integers; return false if either
+    // is NaN.
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     static const real shift = ldexp(real(1), 45);
     static const real loneps = Math::hd / shift;
@@ -31,34 +35,78 @@ namespace GeographicLib {
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
-    if (isnan(lat) || isnan(lon)) {
-      geohash = "invalid";
-      return;
-    }
+    if (isnan(lat) || isnan(lon))
+      return false;
     if (lat == Math::qd) lat -= lateps / 2;
     lon = Math::AngNormalize(lon);
     if (lon == Math::hd) lon = -Math::hd; // lon now in [-180,180)
     // lon/loneps in [-2^45,2^45); lon/loneps + shift in [0,2^46)
     // similarly for lat
-    len = max(0, min(int(maxlen_), len));
+    ulon = (unsigned long long)(floor(lon/loneps) + shift);
+    ulat = (unsigned long long)(floor(lat/lateps) + shift);
+    return true;
+  }
+
+  void Geohash::Unscale(unsigned long long ulon, unsigned long long ulat,
+                        int len, bool centerp, real& lat, real& lon) {
+    // ulon and ulat hold the bits for a geohash of length len
+    static const real shift = ldexp(real(1), 45);
+    static const real loneps = Math::hd / shift;
+    static const real lateps = Math::qd / shift;
+    ulon <<= 1; ulat <<= 1;
+    if (centerp) {
+      ulon += 1;
+      ulat += 1;
+    }
+    int s = 5 * (maxlen_ - len);
+    ulon <<=     (s / 2);
+    ulat <<= s - (s / 2);
+    lon = ulon * loneps - Math::hd;
+    lat = ulat * lateps - Math::qd;
+  }
+
+  unsigned long long Geohash::Encode(unsigned long long ulon,
+                                     unsigned long long ulat, int len) {
+    // Interleave the leading bits of the 46-bit ulon and ulat to give the
+    // code for a geohash of length len <= maxintlen_.  The bits alternate
+    // lon, lat starting with lon.
+    int b = 5 * len, nlon = (b + 1) / 2, nlat = b / 2;
     unsigned long long
-      ulon = (unsigned long long)(floor(lon/loneps) + shift),
-      ulat = (unsigned long long)(floor(lat/lateps) + shift);
+      x = Spread(ulon >> (46 - nlon)),
+      y = Spread(ulat >> (46 - nlat));
+    // The last bit is a longitude bit if b is odd
+    return b & 1 ? x | (y << 1) : (x << 1) | y;
+  }
+
+  void Geohash::Decode(unsigned long long code, int len,
+                       unsigned long long& ulon, unsigned long long& ulat) {
+    // The inverse of Encode, appending the bits to ulon and ulat.
+    int b = 5 * len, nlon = (b + 1) / 2, nlat = b / 2;
+    unsigned long long x = Compact(code), y = Compact(code >> 1);
+    if (!(b & 1)) swap(x, y);
+    ulon = (ulon << nlon) + x;
+    ulat = (ulat << nlat) + y;
+  }
+
+  void Geohash::Forward(real lat, real lon, int len, string& geohash) {
+    unsigned long long ulon, ulat;
+    if (!Scale(lat, lon, ulon, ulat)) {
+      geohash = "invalid";
+      return;
+    }
+    len = max(0, min(int(maxlen_), len));
     char geohash1[maxlen_];
-    unsigned byte = 0;
-    for (unsigned i = 0; i < 5 * unsigned(len);) {
-      if ((i & 1) == 0) {
-        byte = (byte << 1) + unsigned((ulon & mask_) != 0);
-        ulon <<= 1;
-      } else {
-        byte = (byte << 1) + unsigned((ulat & mask_) != 0);
-        ulat <<= 1;
-      }
-      ++i;
-      if (i % 5 == 0) {
-        geohash1[(i/5)-1] = lcdigits_[byte];
-        byte = 0;
+    // Generate the characters maxintlen_ at a time
+    for (int k0 = 0; k0 < len; k0 += maxintlen_) {
+      int k = min(len - k0, int(maxintlen_));
+      unsigned long long code = Encode(ulon, ulat, k);
+      for (int j = k; j--;) {
+        geohash1[k0 + j] = lcdigits_[code & 31U];
+        code >>= 5;
       }
+      // Discard the 5 * maxintlen_ / 2 = 30 bits of ulon and ulat just used
+      ulon = (ulon << (5 * maxintlen_ / 2)) & (2 * mask_ - 1);
+      ulat = (ulat << (5 * maxintlen_ / 2)) & (2 * mask_ - 1);
     }
     geohash.resize(len);
     copy(geohash1, geohash1 + len, geohash.begin());
@@ -66,9 +114,6 @@ namespace GeographicLib {
 
   void Geohash::Reverse(const string& geohash, real& lat, real& lon,
                         int& len, bool centerp) {
-    static const real shift = ldexp(real(1), 45);
-    static const real loneps = Math::hd / shift;
-    static const real lateps = Math::qd / shift;
     int len1 = min(int(maxlen_), int(geohash.length()));
     if (len1 >= 3 &&
         ((toupper(geohash[0]) == 'I' &&
@@ -82,29 +127,292 @@ namespace GeographicLib {
       return;
     }
     unsigned long long ulon = 0, ulat = 0;
-    for (unsigned k = 0, j = 0; k < unsigned(len1); ++k) {
-      int byte = Utility::lookup(ucdigits_, geohash[k]);
-      if (byte < 0)
-        throw GeographicErr("Illegal character in geohash " + geohash);
-      for (unsigned m = 16; m; m >>= 1) {
-        if (j == 0)
-          ulon = (ulon << 1) + unsigned((byte & m) != 0);
-        else
-          ulat = (ulat << 1) + unsigned((byte & m) != 0);
-        j ^= 1;
+    // Decode the characters maxintlen_ at a time
+    for (int k0 = 0; k0 < len1; k0 += maxintlen_) {
+      int k = min(len1 - k0, int(maxintlen_));
+      unsigned long long code = 0;
+      for (int j = 0; j < k; ++j) {
+        int byte = Utility::lookup(ucdigits_, geohash[k0 + j]);
+        if (byte < 0)
+          throw GeographicErr("Illegal character in geohash " + geohash);
+        code = (code << 5) + unsigned(byte);
       }
+      Decode(code, k, ulon, ulat);
     }
-    ulon <<= 1; ulat <<= 1;
-    if (centerp) {
-      ulon += 1;
-      ulat += 1;
-    }
-    int s = 5 * (maxlen_ - len1);
-    ulon <<=     (s / 2);
-    ulat <<= s - (s / 2);
-    lon = ulon * loneps - Math::hd;
-    lat = ulat * lateps - Math::qd;
+    Unscale(ulon, ulat, len1, centerp, lat, lon);
     len = len1;
   }
 
+  void Geohash::Forward(real lat, real lon, int len,
+                        unsigned long long& code) {
+    unsigned long long ulon, ulat;
+    if (!Scale(lat, lon, ulon, ulat)) {
+      code = ~0ULL;
+      return;
+    }
+    code = Encode(ulon, ulat, max(0, min(int(maxintlen_), len)));
+  }
+
+  bool Geohash::CheckCode(unsigned long long code, int len) {
+    // Return false for the invalid code, throw an error if code is too big.
+    if (code >> (5 * len)) {
+      if (code == ~0ULL)
+        return false;
+      throw GeographicErr("Geohash code " + Utility::str(code)
+                          + " has more than " + Utility::str(5 * len)
+                          + " bits");
+    }
+    return true;
+  }
+
+  void Geohash::Reverse(unsigned long long code, int len,
+                        real& lat, real& lon, bool centerp) {
+    len = max(0, min(int(maxintlen_), len));
+    if (!CheckCode(code, len)) {
+      lat = lon = Math::NaN();
+      return;
+    }
+    unsigned long long ulon = 0, ulat = 0;
+    Decode(code, len, ulon, ulat);
+    Unscale(ulon, ulat, len, centerp, lat, lon);
+  }
+
+  void Geohash::Forward(size_t n, const real lat[], const real lon[], int len,
+                        unsigned long long code[]) {
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], len, code[i]);
+  }
+
+  void Geohash::Reverse(size_t n, const unsigned long long code[], int len,
+                        real lat[], real lon[], bool centerp) {
+    for (size_t i = 0; i < n; ++i)
+      Reverse(code[i], len, lat[i], lon[i], centerp);
+  }
+
+  void Geohash::Order(size_t n, const real lat[], const real lon[],
+                      size_t perm[]) {
+    if (n == 0) return;
+    // The Morton keys are the leading 32 bits of ulon and ulat interleaved
+    // starting with lon, i.e., 64-bit geohashes.  Invalid points get the
+    // largest key.
+    vector<unsigned long long> key(n), key1(n);
+    vector<size_t> p(n), p1(n);
+    for (size_t i = 0; i < n; ++i) {
+      unsigned long long ulon, ulat;
+      key[i] = fabs(lat[i]) <= Math::qd && Scale(lat[i], lon[i], ulon, ulat) ?
+        (Spread(ulon >> 14) << 1) | Spread(ulat >> 14) : ~0ULL;
+      p[i] = i;
+    }
+    // LSD radix sort on the bytes of the keys; this is stable.  Skip the
+    // bytes which are the same for all the keys (e.g., the leading bytes
+    // when the points lie in a small region).
+    const int bits = 8, nbins = 1 << bits;
+    size_t count[nbins];
+    for (int shift = 0; shift < 64; shift += bits) {
+      fill(count, count + nbins, size_t(0));
+      for (size_t i = 0; i < n; ++i)
+        ++count[(key[i] >> shift) & (nbins - 1)];
+      if (count[(key[0] >> shift) & (nbins - 1)] == n) continue;
+      for (size_t b = 0, s = 0; b < size_t(nbins); ++b) {
+        size_t c = count[b]; count[b] = s; s += c;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        size_t k = count[(key[i] >> shift) & (nbins - 1)]++;
+        key1[k] = key[i]; p1[k] = p[i];
+      }
+      key.swap(key1); p.swap(p1);
+    }
+    copy(p.begin(), p.end(), perm);
+  }
+
+  void Geohash::Neighbors(unsigned long long code, int len,
+                          unsigned long long neighbors[]) {
+    len = max(0, min(int(maxintlen_), len));
+    if (!CheckCode(code, len)) {
+      fill(neighbors, neighbors + 8, ~0ULL);
+      return;
+    }
+    int b = 5 * len, nlon = (b + 1) / 2, nlat = b / 2;
+    unsigned long long
+      ulon = 0, ulat = 0,
+      mlon = (1ULL << nlon) - 1, nlatcells = 1ULL << nlat;
+    Decode(code, len, ulon, ulat);
+    // Offsets in latitude and longitude for N, NE, E, SE, S, SW, W, NW
+    static const int dlat[] = { 1,  1,  0, -1, -1, -1,  0,  1 };
+    static const int dlon[] = { 0,  1,  1,  1,  0, -1, -1, -1 };
+    for (int i = 0; i < 8; ++i) {
+      unsigned long long
+        // Unsigned arithmetic so ulat + dlat = -1 wraps to a big number
+        ulat1 = ulat + dlat[i],
+        ulon1 = (ulon + dlon[i]) & mlon;
+      neighbors[i] = ulat1 < nlatcells ?
+        Encode(ulon1 << (46 - nlon), ulat1 << (46 - nlat), len) : ~0ULL;
+    }
+  }
+
+  void Geohash::Bounds(unsigned long long code, int len,
+                       real& lats, real& latn, real& lonw, real& lone) {
+    int b = 5 * len, nlon = (b + 1) / 2, nlat = b / 2;
+    unsigned long long ulon = 0, ulat = 0;
+    Decode(code, len, ulon, ulat);
+    real
+      dlon = ldexp(real(Math::td), -nlon),
+      dlat = ldexp(real(Math::hd), -nlat);
+    lonw = ulon * dlon - Math::hd; lone = lonw + dlon;
+    lats = ulat * dlat - Math::qd; latn = lats + dlat;
+  }
+
+  template<class Test>
+  void Geohash::Cover(const Test& test, unsigned long long code, int clen,
+                      int len,
+                      vector<pair<unsigned long long,
+                      unsigned long long>>& ranges) {
+    real lats, latn, lonw, lone;
+    Bounds(code, clen, lats, latn, lonw, lone);
+    int t = test(lats, latn, lonw, lone);
+    if (t == 0) return;
+    if (t == 2 || clen == len) {
+      int s = 5 * (len - clen);
+      unsigned long long first = code << s, second = (code + 1) << s;
+      // The cells are visited in order so only the last range can be
+      // extended.
+      if (!ranges.empty() && ranges.back().second == first)
+        ranges.back().second = second;
+      else
+        ranges.push_back(make_pair(first, second));
+      return;
+    }
+    for (unsigned long long c = code << 5; c < (code + 1) << 5; ++c)
+      Cover(test, c, clen + 1, len, ranges);
+  }
+
+  void Geohash::CoverBox(real lat1, real lon1, real lat2, real lon2, int len,
+                         vector<pair<unsigned long long,
+                         unsigned long long>>& ranges) {
+    if (!(fabs(lat1) <= Math::qd && fabs(lat2) <= Math::qd))
+      throw GeographicErr("Latitudes " + Utility::str(lat1) + "d, "
+                          + Utility::str(lat2) + "d not in [-"
+                          + to_string(Math::qd) + "d, "
+                          + to_string(Math::qd) + "d]");
+    ranges.clear();
+    len = max(0, min(int(maxintlen_), len));
+    if (!(lat1 <= lat2)) return;
+    real
+      // The box extends a distance w east of lon1; w >= td means all
+      // longitudes.
+      w = lon2 - lon1 >= Math::td ? real(Math::td) :
+      Math::AngNormalize(lon2 - lon1);
+    if (w < 0) w += Math::td;
+    lon1 = Math::AngNormalize(lon1);
+    Cover([lat1, lat2, lon1, w]
+          (real lats, real latn, real lonw, real lone) -> int {
+            // Latitude 90d is encoded in the cells with latn = 90d
+            if (!(lats <= lat2 && (lat1 < latn || latn == Math::qd)))
+              return 0;
+            real d = lonw - lon1;
+            if (d < 0) d += Math::td;
+            // Cell spans [d, d + (lone - lonw)) east of lon1
+            if (!(w >= Math::td || d <= w || d + (lone - lonw) > Math::td))
+              return 0;
+            return lat1 <= lats && latn <= lat2 &&
+              (w >= Math::td || d + (lone - lonw) <= w) ? 2 : 1;
+          }, 0ULL, 0, len, ranges);
+  }
+
+  void Geohash::CoverCircle(const Geodesic& geod,
+                            real lat0, real lon0, real r, int len,
+                            vector<pair<unsigned long long,
+                            unsigned long long>>& ranges) {
+    using std::isfinite;        // Needed for Centos 7, ubuntu 14
+    if (!(fabs(lat0) <= Math::qd))
+      throw GeographicErr("Latitude " + Utility::str(lat0)
+                          + "d not in [-" + to_string(Math::qd)
+                          + "d, " + to_string(Math::qd) + "d]");
+    if (!(r >= 0 && isfinite(r)))
+      throw GeographicErr("Radius " + Utility::str(r)
+                          + " is not a finite non-negative number");
+    ranges.clear();
+    len = max(0, min(int(maxintlen_), len));
+    real slat0, clat0;
+    Math::sincosd(lat0, slat0, clat0);
+    // Allow a small margin for roundoff and for the error in finding the
+    // nearest point on a meridian edge when deciding that a cell misses the
+    // circle.
+    real rout = r * (1 + 1/real(1 << 20)) +
+      geod.EquatorialRadius() * numeric_limits<real>::epsilon();
+    auto dist = [&geod, lat0, lon0](real lat, real lon) -> real {
+      real s12;
+      geod.Inverse(lat0, lon0, lat, lon, s12);
+      return s12;
+    };
+    // The point in [lats, latn] nearest to theta, where theta is the angular
+    // position on the great circle containing a meridian, i.e., theta is the
+    // latitude if |theta| <= 90d and theta passes through the poles otherwise.
+    auto clamp = [](real theta, real lats, real latn) -> real {
+      theta = Math::AngNormalize(theta);
+      return theta >= lats && theta <= latn ? theta :
+        (fabs(Math::AngDiff(latn, theta)) <= fabs(Math::AngDiff(lats, theta)) ?
+         latn : lats);
+    };
+    // The distance to the nearest point on the meridian lon between lats and
+    // latn starting with the estimate lat
+    auto mdist = [&geod, &dist, &clamp, lat0, lon0]
+      (real lat, real lon, real lats, real latn) -> real {
+      real s12, azi1, azi2;
+      for (int i = 0; i < 2; ++i) {
+        // The geodesic meets the meridian through the nearest point at right
+        // angles.  Use the spherical right triangle with hypotenuse sig12 and
+        // angle azi2 to estimate the offset to the nearest point.  Two steps
+        // suffice because the error after each step is O(f) times the
+        // previous one.
+        real sig12 = geod.Inverse(lat0, lon0, lat, lon, s12, azi1, azi2),
+          ssig12, csig12, sazi2, cazi2;
+        Math::sincosd(sig12, ssig12, csig12);
+        Math::sincosd(azi2, sazi2, cazi2);
+        real lat1 = clamp(lat - Math::atan2d(ssig12 * cazi2, csig12),
+                          lats, latn);
+        if (lat1 == lat) return s12;
+        lat = lat1;
+      }
+      return min(s12, dist(lat, lon));
+    };
+    Cover([&dist, &mdist, &clamp, lat0, lon0, slat0, clat0, r, rout]
+          (real lats, real latn, real lonw, real lone) -> int {
+            real
+              // Longitude of the center relative to lonw
+              d = Math::AngNormalize(lon0 - lonw),
+              dlon = lone - lonw,
+              dmin;
+            if (d < 0) d += Math::td;
+            if (d <= dlon) {
+              // The nearest point is on the meridian through the center
+              dmin = lat0 >= lats && lat0 <= latn ? 0 :
+                dist(min(latn, max(lats, lat0)), lon0);
+            } else {
+              // The nearest point is on one of the meridian edges; on a
+              // sphere, the foot of the perpendicular from the center to the
+              // meridian is given by tan(lat) = tan(lat0)/cos(lon0 - lonx).
+              dmin = Math::infinity();
+              for (int i = 0; i < 2; ++i) {
+                real lonx = i ? lone : lonw, sdlon, cdlon;
+                Math::sincosd(Math::AngDiff(lonx, lon0), sdlon, cdlon);
+                real latx = clamp(Math::atan2d(slat0, clat0 * cdlon),
+                                  lats, latn);
+                dmin = min(dmin, mdist(latx, lonx, lats, latn));
+              }
+            }
+            if (dmin > rout) return 0;
+            // The farthest point is a corner unless the cell includes the
+            // meridian through the antipode.
+            real da = d + Math::hd;
+            if (da >= Math::td) da -= Math::td;
+            if (da > 0 && da < dlon) return 1;
+            real lat[] = {lats, latn}, lon[] = {lonw, lone};
+            for (int i = 0; i < 4; ++i)
+              if (!(dist(lat[i & 1], lon[i >> 1]) <= r))
+                return 1;
+            return 2;
+          }, 0ULL, 0, len, ranges);
+  }
+
 } // namespace GeographicLib
@@ -2,15 +2,52 @@
  * \file Geoid.cpp
  * \brief Implementation for GeographicLib::Geoid class
  *
- * Copyright (c) Charles Karney (2009-2020) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2009-2023) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
 #include <GeographicLib/Geoid.hpp>
+#include <cstdint>
 // For getenv
 #include <cstdlib>
+#include <mutex>
 #include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/Instrument.hpp>
+
+// For memory mapping the data file
+#if defined(_WIN32)
+#  if !defined(NOMINMAX)
+#    define NOMINMAX 1
+#  endif
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#    define WIN32_LEAN_AND_MEAN 1
+#  endif
+#  include <windows.h>
+#  define GEOGRAPHICLIB_GEOID_MMAP 1
+#  define GEOGRAPHICLIB_GEOID_ADVISE 0
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_GEOID_MMAP 1
+// For the read-ahead in track mode (posix_fadvise isn't available on all
+// systems, e.g., macOS)
+#  define GEOGRAPHICLIB_GEOID_ADVISE 1
+#else
+#  define GEOGRAPHICLIB_GEOID_MMAP 0
+#  define GEOGRAPHICLIB_GEOID_ADVISE 0
+#endif
+
+// For backing the area cache with transparent huge pages (Linux)
+#if defined(MADV_HUGEPAGE) && !defined(GEOGRAPHICLIB_GEOID_HUGEPAGES)
+#  define GEOGRAPHICLIB_GEOID_HUGEPAGES 1
+#endif
+#if !defined(GEOGRAPHICLIB_GEOID_HUGEPAGES)
+#  define GEOGRAPHICLIB_GEOID_HUGEPAGES 0
+#endif
 
 #if !defined(GEOGRAPHICLIB_DATA)
 #  if defined(_WIN32)
@@ -199,7 +236,7 @@ namespace GeographicLib {
   };
 
   Geoid::Geoid(const std::string& name, const std::string& path, bool cubic,
-               bool threadsafe)
+               bool threadsafe, bool mapped, int nthreads)
     : _name(name)
     , _dir(path)
     , _cubic(cubic)
@@ -208,17 +245,48 @@ namespace GeographicLib {
     , _degree( Math::degree() )
     , _eps( sqrt(numeric_limits<real>::epsilon()) )
     , _threadsafe(false)        // Set after cache is read
+    , _map(nullptr)
+    , _mapsize(0)
+    , _tiled(false)
+    , _tilestart(0)
+    , _blocksize(0)
+    , _nbx(0)
+    , _nby(0)
+    , _blocked(false)
+    , _blockbytes(0)
+    , _blockbudget(0)
+    , _blockhits(0)
+    , _blockmisses(0)
+    , _lastblock(-1)
+    , _lastdata(nullptr)
+    , _trackahead(0)
+    , _trackx(-1)
+    , _tracky(-1)
+    , _trackfd(-1)
+    , _tracknext(0)
+    , _data(nullptr)
+    , _datalen(0)
   {
+    GEOGRAPHICLIB_TRACE_SCOPE(GEOID_LOAD);
     static_assert(sizeof(pixel_t) == pixel_size_, "pixel_t has the wrong size");
     if (_dir.empty())
       _dir = DefaultGeoidPath();
     _filename = _dir + "/" + _name + (pixel_size_ != 4 ? ".pgm" : ".pgm4");
     _file.open(_filename.c_str(), ios::binary);
-    if (!(_file.good()))
-      throw GeographicErr("File not readable " + _filename);
+    if (!(_file.good())) {
+      // Fall back to the tiled version of the data
+      string tfilename = _dir + "/" + _name +
+        (pixel_size_ != 4 ? ".tpgm" : ".tpgm4");
+      _file.clear();
+      _file.open(tfilename.c_str(), ios::binary);
+      if (!(_file.good()))
+        throw GeographicErr("File not readable " + _filename);
+      _filename = tfilename;
+    }
     string s;
-    if (!(getline(_file, s) && s == "P5"))
+    if (!(getline(_file, s) && (s == "P5" || s == "TP5")))
       throw GeographicErr("File not in PGM format " + _filename);
+    _tiled = s == "TP5";
     _offset = numeric_limits<real>::max();
     _scale = 0;
     _maxerror = _rmserror = -1;
@@ -243,6 +311,9 @@ namespace GeographicLib {
         } else if (key == "Scale") {
           if (!(is >> _scale))
             throw GeographicErr("Error reading scale " + _filename);
+        } else if (key == "TileSize" && _tiled) {
+          if (!(is >> _blocksize))
+            throw GeographicErr("Error reading tile size " + _filename);
         } else if (key == (_cubic ? "MaxCubicError" : "MaxBilinearError")) {
           // It's not an error if the error can't be read
           is >> _maxerror;
@@ -282,9 +353,37 @@ namespace GeographicLib {
     if (!(_height & 1))
       // This is so that latitude grid includes the equator.
       throw GeographicErr("Raster height is even " + _filename);
+    if (_tiled) {
+      if (_blocksize <= 0)
+        throw GeographicErr("Tile size not set " + _filename);
+      if (mapped)
+        throw GeographicErr("Cannot map tiled file " + _filename);
+      _nbx = (_width + _blocksize - 1) / _blocksize;
+      _nby = (_height + _blocksize - 1) / _blocksize;
+      _blocked = true;
+      _blockbudget = blockbudget_;
+      _tileoffset.resize(size_t(_nbx) * size_t(_nby) + 1);
+      _file.seekg(streamoff(_datastart));
+      try {
+        Utility::readarray<unsigned long long, unsigned long long, true>
+          (_file, _tileoffset);
+      }
+      catch (const exception&) {
+        throw GeographicErr("Error reading tile offsets " + _filename);
+      }
+      _tilestart = (unsigned long long)(_file.tellg());
+      for (size_t k = 1; k < _tileoffset.size(); ++k)
+        if (_tileoffset[k] < _tileoffset[k-1])
+          throw GeographicErr("Tile offsets are not sorted " + _filename);
+    } else {
+      _blocksize = pgmblock_;
+      _nbx = (_width + _blocksize - 1) / _blocksize;
+      _nby = (_height + _blocksize - 1) / _blocksize;
+    }
     _file.seekg(0, ios::end);
     if (!_file.good() ||
-        _datastart + pixel_size_ * _swidth * (unsigned long long)(_height) !=
+        (_tiled ? _tilestart + _tileoffset.back() :
+         _datastart + pixel_size_ * _swidth * (unsigned long long)(_height)) !=
         (unsigned long long)(_file.tellg()))
       // Possibly this test should be "<" because the file contains, e.g., a
       // second image.  However, for now we are more strict.
@@ -292,46 +391,432 @@ namespace GeographicLib {
     _rlonres = _width / real(Math::td);
     _rlatres = (_height - 1) / real(Math::hd);
     _cache = false;
+    _coeffcache = false;
+    _coeffsingle = false;
+    _cxoffset = _cyoffset = _cxsize = _cysize = 0;
     _ix = _width;
     _iy = _height;
     // Ensure that file errors throw exceptions
     _file.exceptions(ifstream::eofbit | ifstream::failbit | ifstream::badbit);
-    if (threadsafe) {
-      CacheAll();
+    if (mapped) {
+      MapFile();
       _file.close();
+    }
+    if (threadsafe) {
+      if (!_map) {
+        CacheArea(real(-Math::qd), real(0), real(Math::qd), real(Math::td),
+                  nthreads);
+        _file.close();
+        // The decoded tiles are no longer needed
+        BlockClear();
+        _blocked = false;
+      }
       _threadsafe = true;
     }
+    MemoryFootprint::Register(this, [](const void* g) {
+      return static_cast<const Geoid*>(g)->MemoryUsage();
+    });
   }
 
-  Math::real Geoid::height(real lat, real lon) const {
+  Geoid::~Geoid() {
+    MemoryFootprint::Unregister(this);
+    SetTrackMode(0);
+    UnmapFile();
+    AreaClear();
+  }
+
+  future<unique_ptr<Geoid>> Geoid::LoadAsync(const std::string& name,
+                                             const std::string& path,
+                                             bool cubic, int nthreads) {
+    return async(launch::async, [name, path, cubic, nthreads]() {
+      return unique_ptr<Geoid>(new Geoid(name, path, cubic, true, false,
+                                         nthreads));
+    });
+  }
+
+  void Geoid::MapFile() {
+    // _file has been checked, so _datastart and _swidth are valid and the
+    // length of the file is known.
+    unsigned long long size =
+      _datastart + pixel_size_ * _swidth * (unsigned long long)(_height);
+    if (size != (unsigned long long)(size_t(size)))
+      throw GeographicErr("File too large to map " + _filename);
+#if GEOGRAPHICLIB_GEOID_MMAP
+#  if defined(_WIN32)
+    HANDLE file = CreateFileA(_filename.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      throw GeographicErr("File not readable " + _filename);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* addr = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) :
+      NULL;
+    // The view keeps the mapping alive after the handles are closed
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!addr)
+      throw GeographicErr("Cannot map file " + _filename);
+#  else
+    int fd = open(_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("File not readable " + _filename);
+    void* addr = mmap(nullptr, size_t(size), PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping remains valid after the file descriptor is closed
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw GeographicErr("Cannot map file " + _filename);
+#  endif
+    _map = static_cast<const unsigned char*>(addr);
+    _mapsize = size;
+#else
+    throw GeographicErr("Memory mapping is not supported on this system");
+#endif
+  }
+
+  void Geoid::UnmapFile() {
+#if GEOGRAPHICLIB_GEOID_MMAP
+    if (_map) {
+#  if defined(_WIN32)
+      UnmapViewOfFile(_map);
+#  else
+      munmap(const_cast<unsigned char*>(_map), size_t(_mapsize));
+#  endif
+    }
+#endif
+    _map = nullptr;
+    _mapsize = 0;
+  }
+
+  void Geoid::readblock(int k, vector<pixel_t>& block) const {
+    int bx = k % _nbx, by = k / _nbx,
+      nx = min(_blocksize, _width - bx * _blocksize),
+      ny = min(_blocksize, _height - by * _blocksize);
+    block.resize(size_t(nx) * size_t(ny));
+    if (!_tiled) {
+      try {
+        for (int iy = 0; iy < ny; ++iy)
+          readrow(bx * _blocksize, by * _blocksize + iy, &block[iy * nx], nx);
+      }
+      catch (const exception& e) {
+        throw GeographicErr("Error reading " + _filename + ": " + e.what());
+      }
+      return;
+    }
+    vector<unsigned char> buf(size_t(_tileoffset[k+1] - _tileoffset[k]));
+    try {
+      _file.seekg(streamoff(_tilestart + _tileoffset[k]));
+      if (!buf.empty())
+        _file.read(reinterpret_cast<char*>(&buf[0]), buf.size());
+    }
+    catch (const exception& e) {
+      throw GeographicErr("Error reading " + _filename + ": " + e.what());
+    }
+    // Each pixel is stored as the zigzag encoded difference from the planar
+    // prediction left + above - aboveleft as a sequence of 7-bit groups,
+    // least significant first, with the high bit set on all but the last.
+    size_t j = 0;
+    for (int iy = 0; iy < ny; ++iy) {
+      for (int ix = 0; ix < nx; ++ix) {
+        unsigned long long u = 0;
+        for (int shift = 0; ; shift += 7) {
+          if (j >= buf.size() || shift > 63)
+            throw GeographicErr("Corrupt tile data " + _filename);
+          unsigned char c = buf[j++];
+          u |= (unsigned long long)(c & 0x7fU) << shift;
+          if (!(c & 0x80U)) break;
+        }
+        long long
+          r = (long long)(u >> 1) ^ -(long long)(u & 1ULL),
+          l = ix ? block[iy * nx + ix - 1] : 0,
+          a = iy ? block[(iy - 1) * nx + ix] : 0,
+          v = r + (ix && iy ? l + a - block[(iy - 1) * nx + ix - 1] :
+                   l + a);
+        if (v < 0 || v > (long long)(pixel_max_))
+          throw GeographicErr("Corrupt tile data " + _filename);
+        block[iy * nx + ix] = pixel_t(v);
+      }
+    }
+    if (j != buf.size())
+      throw GeographicErr("Corrupt tile data " + _filename);
+  }
+
+  void Geoid::prefetchblock(int k) const {
+    if (_blockmap.find(k) != _blockmap.end())
+      return;
+    vector<pixel_t> block;
+    readblock(k, block);
+    size_t bytes = block.size() * sizeof(pixel_t);
+    BlockTrim(_blockbudget - min(bytes, _blockbudget));
+    // Don't let a prefetch displace the block in use
+    if (_blockbytes + bytes > _blockbudget)
+      return;
+    // Insert after the block in use; a prefetched block is less valuable
+    auto p = _blocklru.empty() ? _blocklru.end() : next(_blocklru.begin());
+    p = _blocklru.insert(p, make_pair(k, vector<pixel_t>()));
+    p->second.swap(block);
+    _blockmap[k] = p;
+    _blockbytes += bytes;
+  }
+
+  const Geoid::pixel_t* Geoid::getblock(int k) const {
+    auto p = _blockmap.find(k);
+    if (p != _blockmap.end()) {
+      ++_blockhits;
+      // Move to the front of the list
+      _blocklru.splice(_blocklru.begin(), _blocklru, p->second);
+    } else {
+      ++_blockmisses;
+      vector<pixel_t> block;
+      readblock(k, block);
+      size_t bytes = block.size() * sizeof(pixel_t);
+      // Discard the least recently used blocks to make room
+      BlockTrim(_blockbudget - min(bytes, _blockbudget));
+      if (!_blocklru.empty() && _blockbytes + bytes > _blockbudget)
+        BlockClear();
+      _blocklru.push_front(make_pair(k, vector<pixel_t>()));
+      _blocklru.front().second.swap(block);
+      _blockmap[k] = _blocklru.begin();
+      _blockbytes += bytes;
+    }
+    _lastblock = k;
+    _lastdata = &(_blocklru.front().second[0]);
+    return _lastdata;
+  }
+
+  void Geoid::prefetch(int ix, int iy) const {
+    // Read the adjacent blocks when the cubic stencil comes within margin
+    // of the edge of the block.
+    const int margin = max(3, _blocksize / 8);
+    int bx = ix / _blocksize, by = iy / _blocksize,
+      nx = min(_blocksize, _width - bx * _blocksize),
+      ny = min(_blocksize, _height - by * _blocksize),
+      fx = ix - bx * _blocksize, fy = iy - by * _blocksize,
+      dx = fx < margin ? -1 : (fx >= nx - margin ? 1 : 0),
+      dy = fy < margin ? -1 : (fy >= ny - margin ? 1 : 0);
+    if (dy && !(by + dy >= 0 && by + dy < _nby))
+      dy = 0;
+    if (!(dx || dy))
+      return;
+    // Longitude wraps around
+    int bx1 = (bx + dx + _nbx) % _nbx, by1 = by + dy;
+    if (dx) prefetchblock(by * _nbx + bx1);
+    if (dy) prefetchblock(by1 * _nbx + bx);
+    if (dx && dy) prefetchblock(by1 * _nbx + bx1);
+  }
+
+  void Geoid::BlockTrim(size_t maxbytes) const {
+    // Discard the least recently used blocks leaving at least one
+    while (_blocklru.size() > 1 && _blockbytes > maxbytes) {
+      _blockbytes -= _blocklru.back().second.size() * sizeof(pixel_t);
+      _blockmap.erase(_blocklru.back().first);
+      _blocklru.pop_back();
+    }
+  }
+
+  void Geoid::BlockClear() const {
+    _blocklru.clear();
+    _blockmap.clear();
+    _blockbytes = 0;
+    _lastblock = -1;
+    _lastdata = nullptr;
+  }
+
+  void Geoid::SetBlockCacheSize(size_t maxbytes) const {
+    if (_threadsafe || _map)
+      return;
+    _blockhits = _blockmisses = 0;
+    if (!_tiled) {
+      _blocked = maxbytes > 0;
+      if (!_blocked) {
+        BlockClear();
+        _blockbudget = 0;
+        return;
+      }
+    }
+    _blockbudget = maxbytes;
+    BlockTrim(_blockbudget);
+  }
+
+  void Geoid::SetTrackMode(int ahead) const {
+#if GEOGRAPHICLIB_GEOID_ADVISE
+    if (_threadsafe)
+      return;
+    ahead = max(0, ahead);
+    if (ahead && !_map && _trackfd < 0)
+      _trackfd = open(_filename.c_str(), O_RDONLY);
+    else if (!ahead && _trackfd >= 0) {
+      close(_trackfd);
+      _trackfd = -1;
+    }
+    _trackahead = ahead;
+    TrackClear();
+#else
+    (void)ahead;
+#endif
+  }
+
+  void Geoid::TrackClear() const {
+    _trackx = _tracky = -1;
+    for (int i = 0; i < trackring_; ++i)
+      _trackring[i] = -1;
+    _tracknext = 0;
+  }
+
+  void Geoid::track(int ix, int iy) const {
+    int dx = ix - _trackx, dy = iy - _tracky;
+    bool first = _trackx < 0;
+    _trackx = ix; _tracky = iy;
+    if (first) return;
+    // Longitude wraps around
+    if (dx > _width/2) dx -= _width;
+    else if (dx < -_width/2) dx += _width;
+    int d = max(abs(dx), abs(dy));
+    if (d == 0 || d > _trackahead)
+      return;
+    // Sample the track ahead every half block and advise the blocks covering
+    // the interpolation stencil at each sample point
+    int step = max(1, _blocksize / 2);
+    for (int s = min(step, _trackahead); ; s = min(s + step, _trackahead)) {
+      int px = ix + int(lround(real(s) * dx / d)),
+        py = max(0, min(_height - 1, iy + int(lround(real(s) * dy / d))));
+      int
+        by0 = max(0, py - 1) / _blocksize,
+        by1 = min(_height - 1, py + 2) / _blocksize;
+      for (int by = by0; by <= by1; ++by)
+        for (int x = px - 1; x <= px + 2; x += 3) {
+          int bx = ((x % _width + _width) % _width) / _blocksize,
+            k = by * _nbx + bx;
+          bool seen = false;
+          for (int i = 0; i < trackring_ && !seen; ++i)
+            seen = _trackring[i] == k;
+          if (seen) continue;
+          _trackring[_tracknext] = k;
+          _tracknext = (_tracknext + 1) % trackring_;
+          adviseblock(k);
+        }
+      if (s == _trackahead) break;
+    }
+  }
+
+  void Geoid::adviseblock(int k) const {
+#if GEOGRAPHICLIB_GEOID_ADVISE
+    int bx = k % _nbx, by = k / _nbx,
+      nx = min(_blocksize, _width - bx * _blocksize),
+      ny = min(_blocksize, _height - by * _blocksize);
+    unsigned long long start = 0, end = 0;
+    // Advise the byte range [start, end) of the file
+    auto advise = [this](unsigned long long start, unsigned long long end)
+      -> void {
+      if (end <= start) return;
+      if (_map) {
+        // madvise needs page aligned addresses
+        unsigned long long page = (unsigned long long)(sysconf(_SC_PAGESIZE));
+        start -= start % page;
+        madvise(const_cast<unsigned char*>(_map) + start,
+                size_t(end - start), MADV_WILLNEED);
+      } else if (_trackfd >= 0) {
+#  if defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(_trackfd, off_t(start), off_t(end - start),
+                      POSIX_FADV_WILLNEED);
+#  endif
+      }
+    };
+    if (_tiled) {
+      advise(_tilestart + _tileoffset[k], _tilestart + _tileoffset[k+1]);
+      return;
+    }
+    // The rows of the block, merging contiguous ranges
+    for (int iy = 0; iy < ny; ++iy) {
+      unsigned long long
+        s = _datastart + pixel_size_ *
+        ((unsigned long long)(by * _blocksize + iy) * _swidth +
+         (unsigned long long)(bx * _blocksize)),
+        e = s + pixel_size_ * (unsigned long long)(nx);
+      if (s != end) {
+        advise(start, end);
+        start = s;
+      }
+      end = e;
+    }
+    advise(start, end);
+#else
+    (void)k;
+#endif
+  }
+
+  void Geoid::readrow(int ix, int iy, pixel_t row[], int n,
+                      istream& file) const {
+    if (_map) {
+      for (int i = 0; i < n; ++i)
+        row[i] = pixel_t(mapval(ix + i, iy));
+    } else if (_tiled) {
+      for (int i = 0; i < n; ++i)
+        row[i] = blockval(ix + i, iy);
+    } else {
+      filepos(file, ix, iy);
+      Utility::readarray<pixel_t, pixel_t, true>(file, row, n);
+    }
+  }
+
+  bool Geoid::cell(real lat, real lon, int& ix, int& iy,
+                   real& fx, real& fy) const {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     lat = Math::LatFix(lat);
-    if (isnan(lat) || isnan(lon)) {
-      return Math::NaN();
-    }
+    if (isnan(lat) || isnan(lon))
+      return false;
     lon = Math::AngNormalize(lon);
-    real
-      fx =  lon * _rlonres,
-      fy = -lat * _rlatres;
-    int
-      ix = int(floor(fx)),
-      iy = min((_height - 1)/2 - 1, int(floor(fy)));
+    fx =  lon * _rlonres;
+    fy = -lat * _rlatres;
+    ix = int(floor(fx));
+    iy = min((_height - 1)/2 - 1, int(floor(fy)));
     fx -= ix;
     fy -= iy;
     iy += (_height - 1)/2;
     ix += ix < 0 ? _width : (ix >= _width ? -_width : 0);
-    real v00 = 0, v01 = 0, v10 = 0, v11 = 0;
-    real t[nterms_];
+    return true;
+  }
 
-    if (_threadsafe || !(ix == _ix && iy == _iy)) {
-      if (!_cubic) {
-        v00 = rawval(ix    , iy    );
-        v01 = rawval(ix + 1, iy    );
-        v10 = rawval(ix    , iy + 1);
-        v11 = rawval(ix + 1, iy + 1);
+  bool Geoid::cachedcoeffs(int ix, int iy, real t[]) const {
+    int x = ix - _cxoffset, y = iy - _cyoffset;
+    if (x < 0) x += _width;
+    if (!(x < _cxsize && y >= 0 && y < _cysize))
+      return false;
+    unsigned nc = _cubic ? nterms_ : 4;
+    size_t k = (size_t(y) * size_t(_cxsize) + size_t(x)) * nc;
+    if (_coeffsingle)
+      for (unsigned i = 0; i < nc; ++i)
+        t[i] = real(_coeffsf[k + i]);
+    else
+      for (unsigned i = 0; i < nc; ++i)
+        t[i] = _coeffs[k + i];
+    return true;
+  }
+
+  void Geoid::cellcoeffs(int ix, int iy, real t[]) const {
+    if (_coeffcache && cachedcoeffs(ix, iy, t))
+      return;
+    if (_blocked && !_cache)
+      prefetch(ix, iy);
+    if (!_cubic) {
+      t[0] = rawval(ix    , iy    );
+      t[1] = rawval(ix + 1, iy    );
+      t[2] = rawval(ix    , iy + 1);
+      t[3] = rawval(ix + 1, iy + 1);
+    } else {
+      real v[stencilsize_];
+      int k = 0;
+      if (_cache && ix - 1 >= _xoffset && ix + 2 < _xoffset + _xsize &&
+          iy - 1 >= _yoffset && iy + 2 < _yoffset + _ysize) {
+        // The stencil lies in the area cache; index it directly from the
+        // pixel for ix, iy.  (If ix + 2 >= _width, the cache wraps around
+        // longitude 0 and these are still the right pixels.)
+        const ptrdiff_t s = _xsize;
+        const pixel_t* p = _data + (iy - _yoffset) * s + (ix - _xoffset);
+        for (int j = 0; j < 2; ++j) v[k++] = real(p[j - s]);
+        for (int j = -1; j < 3; ++j) v[k++] = real(p[j]);
+        for (int j = -1; j < 3; ++j) v[k++] = real(p[j + s]);
+        for (int j = 0; j < 2; ++j) v[k++] = real(p[j + 2*s]);
       } else {
-        real v[stencilsize_];
-        int k = 0;
         v[k++] = rawval(ix    , iy - 1);
         v[k++] = rawval(ix + 1, iy - 1);
         v[k++] = rawval(ix - 1, iy    );
@@ -344,72 +829,239 @@ namespace GeographicLib {
         v[k++] = rawval(ix + 2, iy + 1);
         v[k++] = rawval(ix    , iy + 2);
         v[k++] = rawval(ix + 1, iy + 2);
+      }
 
-        const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
-        int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
-        for (unsigned i = 0; i < nterms_; ++i) {
-          t[i] = 0;
-          for (unsigned j = 0; j < stencilsize_; ++j)
-            t[i] += v[j] * c3x[nterms_ * j + i];
-          t[i] /= c0x;
-        }
+      const int* c3x = iy == 0 ? c3n_ : (iy == _height - 2 ? c3s_ : c3_);
+      int c0x = iy == 0 ? c0n_ : (iy == _height - 2 ? c0s_ : c0_);
+      for (unsigned i = 0; i < nterms_; ++i) {
+        t[i] = 0;
+        for (unsigned j = 0; j < stencilsize_; ++j)
+          t[i] += v[j] * c3x[nterms_ * j + i];
+        t[i] /= c0x;
       }
-    } else { // same cell; used cached coefficients
-      if (!_cubic) {
-        v00 = _v00;
-        v01 = _v01;
-        v10 = _v10;
-        v11 = _v11;
-      } else
-        copy(_t, _t + nterms_, t);
     }
+  }
+
+  Math::real Geoid::cellheight(const real t[], real fx, real fy) const {
     if (!_cubic) {
       real
-        a = (1 - fx) * v00 + fx * v01,
-        b = (1 - fx) * v10 + fx * v11,
-        c = (1 - fy) * a + fy * b,
-        h = _offset + _scale * c;
-      if (!_threadsafe) {
-        _ix = ix;
-        _iy = iy;
-        _v00 = v00;
-        _v01 = v01;
-        _v10 = v10;
-        _v11 = v11;
-      }
-      return h;
+        a = (1 - fx) * t[0] + fx * t[1],
+        b = (1 - fx) * t[2] + fx * t[3],
+        c = (1 - fy) * a + fy * b;
+      return _offset + _scale * c;
     } else {
       real h = t[0] + fx * (t[1] + fx * (t[3] + fx * t[6])) +
         fy * (t[2] + fx * (t[4] + fx * t[7]) +
              fy * (t[5] + fx * t[8] + fy * t[9]));
-      h = _offset + _scale * h;
-      if (!_threadsafe) {
-        _ix = ix;
-        _iy = iy;
-        copy(t, t + nterms_, _t);
+      return _offset + _scale * h;
+    }
+  }
+
+  Math::real Geoid::cellheight(const real t[], real fx, real fy, real lat,
+                               real& gradn, real& grade) const {
+    // The derivatives of the interpolant with respect to fx and fy
+    real hx, hy;
+    if (!_cubic) {
+      hx = (1 - fy) * (t[1] - t[0]) + fy * (t[3] - t[2]);
+      hy = (1 - fx) * (t[2] - t[0]) + fx * (t[3] - t[1]);
+    } else {
+      hx = t[1] + fx * (2 * t[3] + 3 * fx * t[6]) +
+        fy * (t[4] + 2 * fx * t[7] + fy * t[8]);
+      hy = t[2] + fx * (t[4] + fx * t[7]) +
+        fy * (2 * t[5] + 2 * fx * t[8] + 3 * fy * t[9]);
+    }
+    // fx = lon * _rlonres and fy = -lat * _rlatres (with lon and lat in
+    // degrees); convert to derivatives with respect to distance using the
+    // radii of curvature of the ellipsoid.
+    real sphi, cphi;
+    Math::sincosd(lat, sphi, cphi);
+    real n = 1 / sqrt(1 - _e2 * Math::_sq(sphi));
+    grade =  _scale * _rlonres * hx / (_degree * _a * n * fmax(cphi, _eps));
+    gradn = -_scale * _rlatres * hy / (_degree * _a * (1 - _e2) * n*n*n);
+    return cellheight(t, fx, fy);
+  }
+
+  Math::real Geoid::height(real lat, real lon) const {
+    int ix, iy;
+    real fx, fy;
+    if (!cell(lat, lon, ix, iy, fx, fy))
+      return Math::NaN();
+    if (_threadsafe) {
+      real t[nterms_];
+      cellcoeffs(ix, iy, t);
+      return cellheight(t, fx, fy);
+    }
+    if (!(ix == _ix && iy == _iy)) {
+      // Not the same cell; update the cached coefficients
+      if (_trackahead) track(ix, iy);
+      cellcoeffs(ix, iy, _t);
+      _ix = ix;
+      _iy = iy;
+    }
+    return cellheight(_t, fx, fy);
+  }
+
+  Math::real Geoid::height(real lat, real lon,
+                           real& gradn, real& grade) const {
+    int ix, iy;
+    real fx, fy;
+    if (!cell(lat, lon, ix, iy, fx, fy)) {
+      gradn = grade = Math::NaN();
+      return Math::NaN();
+    }
+    lat = Math::LatFix(lat);
+    if (_threadsafe) {
+      real t[nterms_];
+      cellcoeffs(ix, iy, t);
+      return cellheight(t, fx, fy, lat, gradn, grade);
+    }
+    if (!(ix == _ix && iy == _iy)) {
+      if (_trackahead) track(ix, iy);
+      cellcoeffs(ix, iy, _t);
+      _ix = ix;
+      _iy = iy;
+    }
+    return cellheight(_t, fx, fy, lat, gradn, grade);
+  }
+
+  void Geoid::Heights(size_t n, const real lat[], const real lon[],
+                      real h[]) const {
+    Heights(n, lat, lon, h, nullptr, nullptr);
+  }
+
+  void Geoid::Heights(size_t n, const real lat[], const real lon[],
+                      real h[], real gradn[], real grade[]) const {
+    Heights(n, StridedArray<const real>(lat), StridedArray<const real>(lon),
+            StridedArray<real>(h), StridedArray<real>(gradn),
+            StridedArray<real>(grade));
+  }
+
+  void Geoid::Heights(size_t n, StridedArray<const real> lat,
+                      StridedArray<const real> lon, StridedArray<real> h,
+                      StridedArray<real> gradn,
+                      StridedArray<real> grade) const {
+    // Sort the points by cell so that the coefficients for each cell are
+    // computed once and the data is accessed in order.
+    vector< pair<long long, size_t> > order;
+    vector<real> fxy(2 * n);
+    order.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      int ix, iy;
+      if (cell(lat[i], lon[i], ix, iy, fxy[2*i], fxy[2*i+1]))
+        order.push_back(make_pair((long long)(iy) * _width + ix, i));
+      else {
+        h[i] = Math::NaN();
+        if (gradn) gradn[i] = grade[i] = Math::NaN();
+      }
+    }
+    sort(order.begin(), order.end());
+    real t[nterms_];
+    long long key = -1;
+    for (size_t k = 0; k < order.size(); ++k) {
+      size_t i = order[k].second;
+      if (order[k].first != key) {
+        key = order[k].first;
+        cellcoeffs(int(key % _width), int(key / _width), t);
       }
-      return h;
+      h[i] = gradn ?
+        cellheight(t, fxy[2*i], fxy[2*i+1], Math::LatFix(lat[i]),
+                   gradn[i], grade[i]) :
+        cellheight(t, fxy[2*i], fxy[2*i+1]);
+    }
+  }
+
+  void Geoid::ConvertHeights(size_t n, StridedArray<const real> lat,
+                             StridedArray<const real> lon,
+                             StridedArray<real> h, convertflag d) const {
+    vector<real> N(n);
+    Heights(n, lat, lon, StridedArray<real>(N.data()));
+    for (size_t i = 0; i < n; ++i)
+      h[i] += real(d) * N[i];
+  }
+
+  void Geoid::AreaAlloc(size_t n) const {
+    // The caller has released any previous block.  In a large cache, random
+    // queries hit many pages; so, where possible, the cache is a mapping of
+    // anonymous memory aligned to 2 MB and the system is asked to back it
+    // with transparent huge pages before the data is read, which cuts the
+    // TLB misses.  This is only a hint and the allocation succeeds even if
+    // huge pages are not available.
+    if (n > numeric_limits<size_t>::max() / sizeof(pixel_t))
+      throw bad_alloc();
+    size_t bytes = n * sizeof(pixel_t);
+#if GEOGRAPHICLIB_GEOID_HUGEPAGES
+    const size_t huge = size_t(2) << 20;
+    if (bytes >= huge && bytes <= numeric_limits<size_t>::max() - 2 * huge) {
+      size_t len = (bytes + huge - 1) / huge * huge;
+      // Map an extra huge page and trim the ends to get the alignment
+      void* addr = mmap(nullptr, len + huge, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr == MAP_FAILED)
+        throw bad_alloc();
+      char *a = static_cast<char*>(addr),
+        *b = a + (huge - reinterpret_cast<uintptr_t>(a) % huge) % huge;
+      if (b > a) munmap(a, size_t(b - a));
+      if (b < a + huge) munmap(b + len, size_t(a + huge - b));
+      madvise(b, len, MADV_HUGEPAGE);
+      _data = reinterpret_cast<pixel_t*>(b);
+      _datalen = len;
+      return;
+    }
+#endif
+    _data = new pixel_t[n];
+    _datalen = 0;
+  }
+
+  MemoryFootprint Geoid::MemoryUsage() const {
+    size_t area = !_data ? 0 : _datalen ? _datalen :
+      size_t(_xsize) * size_t(_ysize) * sizeof(pixel_t);
+    return MemoryFootprint(MemoryFootprint::Bytes(_tileoffset),
+                           _map ? size_t(_mapsize) : 0,
+                           area + _blockbytes +
+                           MemoryFootprint::Bytes(_coeffs) +
+                           MemoryFootprint::Bytes(_coeffsf));
+  }
+
+  void Geoid::AreaClear() const {
+    _cache = false;
+    if (!_data) return;
+#if GEOGRAPHICLIB_GEOID_HUGEPAGES
+    if (_datalen)
+      munmap(_data, _datalen);
+    else
+#endif
+      delete[] _data;
+    _data = nullptr;
+    _datalen = 0;
+  }
+
+  void Geoid::CoeffClear() const {
+    _coeffcache = false;
+    _cxoffset = _cyoffset = _cxsize = _cysize = 0;
+    // The single-cell cache may hold coefficients with a different precision
+    _ix = _width;
+    try {
+      vector<real>().swap(_coeffs);
+      vector<float>().swap(_coeffsf);
+    }
+    catch (const exception&) {
     }
   }
 
   void Geoid::CacheClear() const {
     if (!_threadsafe) {
-      _cache = false;
-      try {
-        _data.clear();
-        // Use swap to release memory back to system
-        vector< vector<pixel_t> >().swap(_data);
-      }
-      catch (const exception&) {
-      }
+      AreaClear();
+      CoeffClear();
     }
   }
 
-  void Geoid::CacheArea(real south, real west, real north, real east) const {
+  void Geoid::CacheArea(real south, real west, real north, real east,
+                        int nthreads) const {
+    GEOGRAPHICLIB_TRACE_SCOPE(GEOID_CACHE);
     if (_threadsafe)
       throw GeographicErr("Attempt to change cache of threadsafe Geoid");
     if (south > north) {
-      CacheClear();
+      AreaClear();
       return;
     }
     south = Math::LatFix(south);
@@ -441,49 +1093,139 @@ namespace GeographicLib {
       ie += iw < 0 ? _width : (iw >= _width ? -_width : 0);
       iw += iw < 0 ? _width : (iw >= _width ? -_width : 0);
     }
-    int oysize = int(_data.size());
+    AreaClear();
     _xsize = ie - iw + 1;
     _ysize = is - in + 1;
     _xoffset = iw;
     _yoffset = in;
 
     try {
-      _data.resize(_ysize, vector<pixel_t>(_xsize));
-      for (int iy = min(oysize, _ysize); iy--;)
-        _data[iy].resize(_xsize);
+      AreaAlloc(size_t(_ysize) * size_t(_xsize));
     }
     catch (const bad_alloc&) {
-      CacheClear();
+      AreaClear();
       throw GeographicErr("Insufficient memory for caching " + _filename);
     }
 
-    try {
-      for (int iy = in; iy <= is; ++iy) {
-        int iy1 = iy, iw1 = iw;
-        if (iy < 0 || iy >= _height) {
-          // Allow points "beyond" the poles to support interpolation
-          iy1 = iy1 < 0 ? -iy1 : 2 * (_height - 1) - iy1;
-          iw1 += _width/2;
-          if (iw1 >= _width)
-            iw1 -= _width;
+    // Task t reads rows [in + ny*t/nt, in + ny*(t+1)/nt).  The tasks other
+    // than 0 use their own streams; tiles are decoded into the block cache
+    // and so a tiled file is read by one task.  Give each task at least 64
+    // rows.
+    const int ny = _ysize,
+      nt = _tiled ? 1 : max(1, min(nthreads, ny / 64));
+    mutex lock;
+    string err;
+    auto worker = [&](int t) -> void {
+      try {
+        ifstream file;
+        if (t > 0 && !_map) {
+          file.open(_filename.c_str(), ios::binary);
+          file.exceptions(ifstream::eofbit | ifstream::failbit |
+                          ifstream::badbit);
         }
-        int xs1 = min(_width - iw1, _xsize);
-        filepos(iw1, iy1);
-        Utility::readarray<pixel_t, pixel_t, true>
-          (_file, &(_data[iy - in][0]), xs1);
-        if (xs1 < _xsize) {
-          // Wrap around longitude = 0
-          filepos(0, iy1);
-          Utility::readarray<pixel_t, pixel_t, true>
-            (_file, &(_data[iy - in][xs1]), _xsize - xs1);
+        istream& f = t > 0 ? file : _file;
+        for (int iy = in + ny * t / nt; iy < in + ny * (t + 1) / nt; ++iy) {
+          int iy1 = iy, iw1 = iw;
+          if (iy < 0 || iy >= _height) {
+            // Allow points "beyond" the poles to support interpolation
+            iy1 = iy1 < 0 ? -iy1 : 2 * (_height - 1) - iy1;
+            iw1 += _width/2;
+            if (iw1 >= _width)
+              iw1 -= _width;
+          }
+          int xs1 = min(_width - iw1, _xsize);
+          pixel_t* row = _data + size_t(iy - in) * size_t(_xsize);
+          readrow(iw1, iy1, row, xs1, f);
+          if (xs1 < _xsize)
+            // Wrap around longitude = 0
+            readrow(0, iy1, row + xs1, _xsize - xs1, f);
         }
       }
-      _cache = true;
+      catch (const exception& e) {
+        lock_guard<mutex> g(lock);
+        if (err.empty()) err = e.what();
+      }
+    };
+    Executor::Batch(nt, worker);
+    if (!err.empty()) {
+      AreaClear();
+      throw GeographicErr("Error filling cache " + err);
+    }
+    _cache = true;
+  }
+
+  void Geoid::CacheCoeffs(real south, real west, real north, real east,
+                          bool single) const {
+    if (_threadsafe)
+      throw GeographicErr("Attempt to change cache of threadsafe Geoid");
+    CoeffClear();
+    if (south > north)
+      return;
+    south = Math::LatFix(south);
+    north = Math::LatFix(north);
+    west = Math::AngNormalize(west); // west in [-180, 180)
+    east = Math::AngNormalize(east);
+    if (east <= west)
+      east += Math::td;         // east - west in (0, 360]
+    // The range of cells
+    int
+      iw = int(floor(west * _rlonres)),
+      ie = int(floor(east * _rlonres)),
+      in = int(floor(-north * _rlatres)) + (_height - 1)/2,
+      is = int(floor(-south * _rlatres)) + (_height - 1)/2;
+    in = max(0, min(_height - 2, in));
+    is = max(0, min(_height - 2, is));
+    if (ie - iw >= _width - 1) {
+      // Include entire longitude range
+      iw = 0;
+      ie = _width - 1;
+    }
+    int xsize = ie - iw + 1, ysize = is - in + 1;
+    iw += iw < 0 ? _width : (iw >= _width ? -_width : 0);
+    unsigned nc = _cubic ? nterms_ : 4;
+    // The data is needed for several overlapping stencils; so, unless it's in
+    // memory already, cache it while the coefficients are computed.
+    bool tempcache = !_map && !_cache;
+    if (tempcache)
+      CacheArea(south, west, north, east);
+    try {
+      size_t num = size_t(xsize) * size_t(ysize) * nc;
+      if (single)
+        _coeffsf.resize(num);
+      else
+        _coeffs.resize(num);
+      real t[nterms_];
+      size_t k = 0;
+      for (int y = 0; y < ysize; ++y)
+        for (int x = 0; x < xsize; ++x, k += nc) {
+          cellcoeffs(iw + x < _width ? iw + x : iw + x - _width, in + y, t);
+          if (single)
+            for (unsigned i = 0; i < nc; ++i)
+              _coeffsf[k + i] = float(t[i]);
+          else
+            for (unsigned i = 0; i < nc; ++i)
+              _coeffs[k + i] = t[i];
+        }
+    }
+    catch (const bad_alloc&) {
+      CoeffClear();
+      if (tempcache) AreaClear();
+      throw GeographicErr("Insufficient memory for caching coefficients "
+                          + _filename);
     }
     catch (const exception& e) {
-      CacheClear();
-      throw GeographicErr(string("Error filling cache ") + e.what());
+      CoeffClear();
+      if (tempcache) AreaClear();
+      throw GeographicErr(string("Error filling coefficient cache ")
+                          + e.what());
     }
+    if (tempcache) AreaClear();
+    _cxoffset = iw;
+    _cyoffset = in;
+    _cxsize = xsize;
+    _cysize = ysize;
+    _coeffsingle = single;
+    _coeffcache = true;
   }
 
   string Geoid::DefaultGeoidPath() {
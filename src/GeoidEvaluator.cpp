@@ -0,0 +1,51 @@
+/**
+ * \file GeoidEvaluator.cpp
+ * \brief Implementation for GeographicLib::GeoidEvaluator class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/GeoidEvaluator.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  GeoidEvaluator::GeoidEvaluator(const Geoid& geoid)
+    : _geoid(&geoid)
+    , _ix(-1)
+    , _iy(-1)
+  {}
+
+  Math::real GeoidEvaluator::operator()(real lat, real lon) {
+    int ix, iy;
+    real fx, fy;
+    if (!_geoid->cell(lat, lon, ix, iy, fx, fy))
+      return Math::NaN();
+    if (!(ix == _ix && iy == _iy)) {
+      _geoid->cellcoeffs(ix, iy, _t);
+      _ix = ix;
+      _iy = iy;
+    }
+    return _geoid->cellheight(_t, fx, fy);
+  }
+
+  Math::real GeoidEvaluator::operator()(real lat, real lon,
+                                        real& gradn, real& grade) {
+    int ix, iy;
+    real fx, fy;
+    if (!_geoid->cell(lat, lon, ix, iy, fx, fy)) {
+      gradn = grade = Math::NaN();
+      return Math::NaN();
+    }
+    if (!(ix == _ix && iy == _iy)) {
+      _geoid->cellcoeffs(ix, iy, _t);
+      _ix = ix;
+      _iy = iy;
+    }
+    return _geoid->cellheight(_t, fx, fy, Math::LatFix(lat), gradn, grade);
+  }
+
+} // namespace GeographicLib
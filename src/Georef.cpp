@@ -9,6 +9,7 @@
 
 #include <GeographicLib/Georef.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -24,17 +25,18 @@ namespace GeographicLib {
   const char* const Georef::lattile_ = "ABCDEFGHJKLM";
   const char* const Georef::degrees_ = "ABCDEFGHJKLMNPQ";
 
-  void Georef::Forward(real lat, real lon, int prec, string& georef) {
+  int Georef::Forward(real lat, real lon, int prec, char georef[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     if (fabs(lat) > Math::qd)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
                           + "d, " + to_string(Math::qd) + "d]");
     if (isnan(lat) || isnan(lon)) {
-      georef = "INVALID";
-      return;
+      strcpy(georef, "INVALID");
+      return int(strlen(georef));
     }
-    lon = Math::AngNormalize(lon); // lon in [-180,180)
+    lon = Math::AngNormalize(lon);
+    if (lon == Math::hd) lon = -Math::hd; // lon now in [-180,180)
     if (lat == Math::qd) lat *= (1 - numeric_limits<real>::epsilon() / 2);
     prec = max(-1, min(int(maxprec_), prec));
     if (prec == 1) ++prec;      // Disallow prec = 1
@@ -47,24 +49,91 @@ namespace GeographicLib {
       x = (long long)(floor(lon * real(m))) - lonorig_ * m,
       y = (long long)(floor(lat * real(m))) - latorig_ * m;
     int ilon = int(x / m); int ilat = int(y / m);
-    char georef1[maxlen_];
-    georef1[0] = lontile_[ilon / tile_];
-    georef1[1] = lattile_[ilat / tile_];
+    georef[0] = lontile_[ilon / tile_];
+    georef[1] = lattile_[ilat / tile_];
     if (prec >= 0) {
-      georef1[2] = degrees_[ilon % tile_];
-      georef1[3] = degrees_[ilat % tile_];
+      georef[2] = degrees_[ilon % tile_];
+      georef[3] = degrees_[ilat % tile_];
       if (prec > 0) {
         x -= m * ilon; y -= m * ilat;
         long long d = (long long)pow(real(base_), maxprec_ - prec);
         x /= d; y /= d;
         for (int c = prec; c--;) {
-          georef1[baselen_ + c       ] = digits_[x % base_]; x /= base_;
-          georef1[baselen_ + c + prec] = digits_[y % base_]; y /= base_;
+          georef[baselen_ + c       ] = digits_[x % base_]; x /= base_;
+          georef[baselen_ + c + prec] = digits_[y % base_]; y /= base_;
         }
       }
     }
-    georef.resize(baselen_ + 2 * prec);
-    copy(georef1, georef1 + baselen_ + 2 * prec, georef.begin());
+    georef[baselen_ + 2 * prec] = '\0';
+    return baselen_ + 2 * prec;
+  }
+
+  void Georef::Forward(real lat, real lon, int prec, string& georef) {
+    char georef1[maxlen_ + 1];
+    int len = Forward(lat, lon, prec, georef1);
+    georef.assign(georef1, len);
+  }
+
+  void Georef::Forward(size_t n, const real lat[], const real lon[], int prec,
+                       char georef[], size_t stride) {
+    prec = max(-1, min(int(maxprec_), prec));
+    if (prec == 1) ++prec;
+    // "INVALID" needs 8 characters
+    int len = max(int(baselen_) + 2 * prec, 7) + 1;
+    if (!(stride >= size_t(len)))
+      throw GeographicErr("Georef stride " + Utility::str(stride)
+                          + " less than " + Utility::str(len));
+    for (size_t i = 0; i < n; ++i)
+      Forward(lat[i], lon[i], prec, georef + i * stride);
+  }
+
+  void Georef::Forward(real lat, real lon, int prec, unsigned long long& code)
+  {
+    Forward(1, &lat, &lon, prec, &code);
+  }
+
+  void Georef::Forward(size_t n, const real lat[], const real lon[], int prec,
+                       unsigned long long code[]) {
+    prec = IntPrecision(prec);
+    // Process the points in blocks; the loop over a block has no branches
+    // (the tests on prec are outside the loop) so that it can be vectorized.
+    // The latitudes are checked at the end of each block.  The arithmetic
+    // follows the string version of Forward.
+    const size_t nb = 64;
+    const real latmax = Math::qd * (1 - numeric_limits<real>::epsilon() / 2);
+    const long long m = 60000000000LL,
+      mb = MinutesBase(prec),
+      d = prec > 0 ? (long long)pow(real(base_), maxprec_ - prec) : 1;
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t nc = min(nb, n - i0);
+      for (size_t j = 0; j < nc; ++j) {
+        real lat1 = lat[i0 + j], lon1 = Math::AngNormalize(lon[i0 + j]);
+        bool valid = !(isnan(lat1) || isnan(lon1));
+        // Clamp lat1 (which also replaces NaN by -90) and replace lon1 = NaN
+        // by 0 so that the conversions to long long are defined; lat = 90 is
+        // moved into the last cell as in the string version.
+        lat1 = fmin(fmax(lat1, real(-Math::qd)), latmax);
+        lon1 = !valid ? 0 : (lon1 == Math::hd ? -Math::hd : lon1);
+        long long
+          x = (long long)(floor(lon1 * real(m))) - lonorig_ * m,
+          y = (long long)(floor(lat1 * real(m))) - latorig_ * m;
+        int ilon = int(x / m), ilat = int(y / m);
+        unsigned long long c = (unsigned long long)(ilon / tile_) * numlattile_
+          + ilat / tile_;
+        if (prec >= 0)
+          c = (c * tile_ + ilon % tile_) * tile_ + ilat % tile_;
+        if (prec > 0) {
+          x = (x - m * ilon) / d; y = (y - m * ilat) / d;
+          c = (c * mb + x) * mb + y;
+        }
+        code[i0 + j] = valid ? c : ~0ULL;
+      }
+      for (size_t j = 0; j < nc; ++j)
+        if (fabs(lat[i0 + j]) > Math::qd)
+          throw GeographicErr("Latitude " + Utility::str(lat[i0 + j])
+                              + "d not in [-" + to_string(Math::qd)
+                              + "d, " + to_string(Math::qd) + "d]");
+    }
   }
 
   void Georef::Reverse(const string& georef, real& lat, real& lon,
@@ -140,4 +209,56 @@ namespace GeographicLib {
     prec = prec1;
   }
 
+  void Georef::Reverse(unsigned long long code, int prec,
+                       real& lat, real& lon, bool centerp) {
+    prec = IntPrecision(prec);
+    if (code == ~0ULL) {
+      lat = lon = Math::NaN();
+      return;
+    }
+    unsigned long long mb = MinutesBase(prec),
+      ncodes = (unsigned long long)(numlontile_ * numlattile_);
+    if (prec >= 0) ncodes *= tile_ * tile_;
+    if (prec > 0) ncodes *= mb * mb;
+    if (!(code < ncodes))
+      throw GeographicErr("Integer georef " + Utility::str(code)
+                          + " too large for precision " + Utility::str(prec));
+    unsigned long long x = 0, y = 0;
+    int ilond = 0, ilatd = 0;
+    if (prec > 0) {
+      y = code % mb; code /= mb;
+      x = code % mb; code /= mb;
+    }
+    if (prec >= 0) {
+      ilatd = int(code % tile_); code /= tile_;
+      ilond = int(code % tile_); code /= tile_;
+    }
+    // The rest follows the string version of Reverse.
+    real
+      lon1 = int(code / numlattile_) + lonorig_ / tile_,
+      lat1 = int(code % numlattile_) + latorig_ / tile_,
+      unit = 1;
+    if (prec >= 0) {
+      unit *= tile_;
+      lon1 = lon1 * tile_ + ilond;
+      lat1 = lat1 * tile_ + ilatd;
+    }
+    if (prec > 0) {
+      unit *= real(mb);
+      lon1 = real(mb) * lon1 + real(x);
+      lat1 = real(mb) * lat1 + real(y);
+    }
+    if (centerp) {
+      unit *= 2; lat1 = 2 * lat1 + 1; lon1 = 2 * lon1 + 1;
+    }
+    lat = (tile_ * lat1) / unit;
+    lon = (tile_ * lon1) / unit;
+  }
+
+  void Georef::Reverse(size_t n, const unsigned long long code[], int prec,
+                       real lat[], real lon[], bool centerp) {
+    for (size_t i = 0; i < n; ++i)
+      Reverse(code[i], prec, lat[i], lon[i], centerp);
+  }
+
 } // namespace GeographicLib
@@ -8,6 +8,8 @@
  **********************************************************************/
 
 #include <GeographicLib/Gnomonic.hpp>
+#include <GeographicLib/GeodesicOrigin.hpp>
+#include <GeographicLib/Instrument.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about potentially uninitialized local variables and
@@ -44,40 +46,120 @@ namespace GeographicLib {
     }
   }
 
+  void Gnomonic::Forward(real lat0, real lon0, size_t n,
+                         const real lat[], const real lon[],
+                         real x[], real y[],
+                         real azi[], real rk[]) const {
+    const GeodesicOrigin orig(_earth, lat0, lon0);
+    // Solve the inverse problems for blocks of points
+    const size_t b = 256;
+    real azi0[b], azi2[b], m[b], M[b], M21[b], t;
+    for (size_t i0 = 0; i0 < n; i0 += b) {
+      size_t k = min(b, n - i0);
+      orig.InverseBatch(k, lat + i0, lon + i0,
+                        Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH |
+                        Geodesic::GEODESICSCALE,
+                        &t, azi0, azi2, m, M, M21, &t);
+      for (size_t j = 0; j < k; ++j) {
+        size_t i = i0 + j;
+        if (azi) azi[i] = azi2[j];
+        if (rk) rk[i] = M[j];
+        if (M[j] <= 0)
+          x[i] = y[i] = Math::NaN();
+        else {
+          real rho = m[j]/M[j];
+          Math::sincosd(azi0[j], x[i], y[i]);
+          x[i] *= rho; y[i] *= rho;
+        }
+      }
+    }
+  }
+
   void Gnomonic::Reverse(real lat0, real lon0, real x, real y,
                          real& lat, real& lon, real& azi, real& rk) const {
-    real
-      azi0 = Math::atan2d(x, y),
-      rho = hypot(x, y),
-      s = _a * atan(rho/_a);
-    bool little = rho <= _a;
-    if (!little)
-      rho = 1/rho;
-    GeodesicLine line(_earth.Line(lat0, lon0, azi0,
-                                  Geodesic::LATITUDE | Geodesic::LONGITUDE |
-                                  Geodesic::AZIMUTH | Geodesic::DISTANCE_IN |
-                                  Geodesic::REDUCEDLENGTH |
-                                  Geodesic::GEODESICSCALE));
-    int count = numit_, trip = 0;
-    real lat1, lon1, azi1, M;
-    while (count-- || GEOGRAPHICLIB_PANIC) {
-      real m, t;
-      line.Position(s, lat1, lon1, azi1, m, M, t);
-      if (trip)
-        break;
-      // If little, solve rho(s) = rho with drho(s)/ds = 1/M^2
-      // else solve 1/rho(s) = 1/rho with d(1/rho(s))/ds = -1/m^2
-      real ds = little ? (m - rho * M) * M : (rho * m - M) * m;
-      s -= ds;
-      // Reversed test to allow escape with NaNs
-      if (!(fabs(ds) >= eps_ * _a))
-        ++trip;
+    ReverseBlock<1>(lat0, lon0, &x, &y, &lat, &lon, &azi, &rk);
+  }
+
+  void Gnomonic::Reverse(real lat0, real lon0, size_t n,
+                         const real x[], const real y[],
+                         real lat[], real lon[],
+                         real azi[], real rk[]) const {
+    const int b = blocksize_;
+    size_t i = 0;
+    for (; i + b <= n; i += b)
+      ReverseBlock<b>(lat0, lon0, x + i, y + i, lat + i, lon + i,
+                      azi ? azi + i : nullptr, rk ? rk + i : nullptr);
+    if (i < n) {
+      // Pad the last partial block
+      int m = int(n - i);
+      real xx[b], yx[b], latx[b], lonx[b], azix[b], rkx[b];
+      fill(xx, xx + b, real(0)); fill(yx, yx + b, real(0));
+      copy(x + i, x + n, xx); copy(y + i, y + n, yx);
+      ReverseBlock<b>(lat0, lon0, xx, yx, latx, lonx, azix, rkx);
+      copy(latx, latx + m, lat + i); copy(lonx, lonx + m, lon + i);
+      if (azi) copy(azix, azix + m, azi + i);
+      if (rk) copy(rkx, rkx + m, rk + i);
+    }
+  }
+
+  template<int n>
+  void Gnomonic::ReverseBlock(real lat0, real lon0,
+                              const real x[], const real y[],
+                              real lat[], real lon[],
+                              real azi[], real rk[]) const {
+    // The Newton iterations for the n points are carried out in lockstep.
+    // Each point drops out once it has converged (after the final call to
+    // Position); so its result is the same as for a solution on its own.
+    GeodesicLine line[n];
+    real rho[n], s[n], lat1[n], lon1[n], azi1[n], M[n];
+    bool little[n], done[n];
+    int trip[n], iter[n];
+    for (int j = 0; j < n; ++j) {
+      real azi0 = Math::atan2d(x[j], y[j]);
+      rho[j] = hypot(x[j], y[j]);
+      s[j] = _a * atan(rho[j]/_a);
+      little[j] = rho[j] <= _a;
+      if (!little[j])
+        rho[j] = 1/rho[j];
+      line[j] = _earth.Line(lat0, lon0, azi0,
+                            Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                            Geodesic::AZIMUTH | Geodesic::DISTANCE_IN |
+                            Geodesic::REDUCEDLENGTH |
+                            Geodesic::GEODESICSCALE);
+      trip[j] = 0; done[j] = false; iter[j] = numit_;
+    }
+    for (int i = 0, m = n; m > 0 && (i < numit_ || GEOGRAPHICLIB_PANIC);
+         ++i) {
+      for (int j = 0; j < n; ++j) {
+        if (done[j]) continue;
+        real mj, t;
+        line[j].Position(s[j], lat1[j], lon1[j], azi1[j], mj, M[j], t);
+        if (trip[j]) {
+          done[j] = true; iter[j] = i; --m;
+          continue;
+        }
+        // If little, solve rho(s) = rho with drho(s)/ds = 1/M^2
+        // else solve 1/rho(s) = 1/rho with d(1/rho(s))/ds = -1/m^2
+        real ds = little[j] ? (mj - rho[j] * M[j]) * M[j] :
+          (rho[j] * mj - M[j]) * mj;
+        s[j] -= ds;
+        // Reversed test to allow escape with NaNs
+        if (!(fabs(ds) >= eps_ * _a))
+          ++trip[j];
+      }
+    }
+    for (int j = 0; j < n; ++j) {
+      GEOGRAPHICLIB_INSTRUMENT_RECORD(GNOMONIC, iter[j], !trip[j]);
+      if (trip[j]) {
+        lat[j] = lat1[j]; lon[j] = lon1[j];
+        if (azi) azi[j] = azi1[j];
+        if (rk) rk[j] = M[j];
+      } else {
+        lat[j] = lon[j] = Math::NaN();
+        if (azi) azi[j] = Math::NaN();
+        if (rk) rk[j] = Math::NaN();
+      }
     }
-    if (trip) {
-      lat = lat1; lon = lon1; azi = azi1; rk = M;
-    } else
-      lat = lon = azi = rk = Math::NaN();
-    return;
   }
 
 } // namespace GeographicLib
@@ -89,22 +89,83 @@ namespace GeographicLib {
     real
       deltax, deltay, deltaz,
       T = InternalT(slam, clam, deltax, deltay, deltaz, true, false);
-    // Rotate cartesian into spherical coordinates
-    real MC[Geocentric::dim2_];
-    Geocentric::Rotation(_spsi, _cpsi, slam, clam, MC);
-    Geocentric::Unrotate(MC, deltax, deltay, deltaz, deltax, deltay, deltaz);
-    // H+M, Eq 2-151c
-    Dg01 = - deltaz - 2 * T * _invR;
-    xi  = -(deltay/_gamma) / Math::degree();
-    eta = -(deltax/_gamma) / Math::degree();
+    FinishAnomaly(slam, clam, T, deltax, deltay, deltaz, Dg01, xi, eta);
+  }
+
+  void GravityCircle::Grid(unsigned what, real lon0, real dlon, size_t n,
+                           real out1[], real out2[], real out3[]) const {
+    bool gradp;
+    const CircularEngine* engine;
+    switch (what) {
+    case GRAVITY:
+      gradp = true; engine = &_gravitational; break;
+    case DISTURBANCE:
+    case SPHERICAL_ANOMALY:
+      gradp = true; engine = &_disturbing; break;
+    case DISTURBING_POTENTIAL:
+    case GEOID_HEIGHT:
+      gradp = false; engine = &_disturbing; break;
+    default:
+      throw GeographicErr("Unsupported quantity for GravityCircle::Grid");
+    }
+    if ((_caps & what) != what) {
+      for (size_t i = 0; i < n; ++i) {
+        if (out1) out1[i] = Math::NaN();
+        if (out2) out2[i] = Math::NaN();
+        if (out3) out3[i] = Math::NaN();
+      }
+      return;
+    }
+    vector<real> v(n), gx(gradp ? n : 0), gy(gradp ? n : 0), gz(gradp ? n : 0),
+      corr(what == GEOID_HEIGHT ? n : 0);
+    engine->Grid(lon0, dlon, n, v.data(),
+                 gradp ? gx.data() : nullptr,
+                 gradp ? gy.data() : nullptr,
+                 gradp ? gz.data() : nullptr);
+    if (what == GEOID_HEIGHT)
+      _correction.Grid(lon0, dlon, n, corr.data());
+    for (size_t i = 0; i < n; ++i) {
+      real slam, clam, M[Geocentric::dim2_],
+        x = gradp ? gx[i] : 0, y = gradp ? gy[i] : 0, z = gradp ? gz[i] : 0;
+      Math::sincosd(lon0 + real(i) * dlon, slam, clam);
+      switch (what) {
+      case GRAVITY:
+        FinishV(slam, clam, v[i], x, y, z, true);
+        Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+        Geocentric::Unrotate(M, x, y, z, x, y, z);
+        break;
+      case DISTURBANCE:
+        FinishT(slam, clam, v[i], x, y, z, true, true);
+        Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+        Geocentric::Unrotate(M, x, y, z, x, y, z);
+        break;
+      case SPHERICAL_ANOMALY: {
+        real T = FinishT(slam, clam, v[i], x, y, z, true, false);
+        FinishAnomaly(slam, clam, T, x, y, z, x, y, z);
+        break;
+      }
+      case DISTURBING_POTENTIAL:
+        x = FinishT(slam, clam, v[i], x, y, z, false, true);
+        break;
+      case GEOID_HEIGHT:
+        x = FinishT(slam, clam, v[i], x, y, z, false, false) / _gamma0 +
+          _corrmult * corr[i];
+        break;
+      }
+      if (out1) out1[i] = x;
+      if (out2) out2[i] = y;
+      if (out3) out3[i] = z;
+    }
   }
 
   Math::real GravityCircle::W(real slam, real clam,
                               real& gX, real& gY, real& gZ) const {
-    real Wres = V(slam, clam, gX, gY, gZ) + _frot * _pPx / 2;
-    gX += _frot * clam;
-    gY += _frot * slam;
-    return Wres;
+    if ((_caps & GRAVITY) != GRAVITY) {
+      gX = gY = gZ = Math::NaN();
+      return Math::NaN();
+    }
+    real Wres = _gravitational(slam, clam, gX, gY, gZ);
+    return FinishV(slam, clam, Wres, gX, gY, gZ, true);
   }
 
   Math::real GravityCircle::V(real slam, real clam,
@@ -113,16 +174,40 @@ namespace GeographicLib {
       GX = GY = GZ = Math::NaN();
       return Math::NaN();
     }
-    real
-      Vres = _gravitational(slam, clam, GX, GY, GZ),
-      f = _gGMmodel / _amodel;
+    real Vres = _gravitational(slam, clam, GX, GY, GZ);
+    return FinishV(slam, clam, Vres, GX, GY, GZ, false);
+  }
+
+  Math::real GravityCircle::FinishV(real slam, real clam, real Vres,
+                                    real& GX, real& GY, real& GZ,
+                                    bool rotp) const {
+    real f = _gGMmodel / _amodel;
     Vres *= f;
     GX *= f;
     GY *= f;
     GZ *= f;
+    if (rotp) {
+      // Include the centrifugal potential and acceleration
+      Vres += _frot * _pPx / 2;
+      GX += _frot * clam;
+      GY += _frot * slam;
+    }
     return Vres;
   }
 
+  void GravityCircle::FinishAnomaly(real slam, real clam, real T,
+                                    real deltax, real deltay, real deltaz,
+                                    real& Dg01, real& xi, real& eta) const {
+    // Rotate cartesian into spherical coordinates
+    real MC[Geocentric::dim2_];
+    Geocentric::Rotation(_spsi, _cpsi, slam, clam, MC);
+    Geocentric::Unrotate(MC, deltax, deltay, deltaz, deltax, deltay, deltaz);
+    // H+M, Eq 2-151c
+    Dg01 = - deltaz - 2 * T * _invR;
+    xi  = -(deltay/_gamma) / Math::degree();
+    eta = -(deltax/_gamma) / Math::degree();
+  }
+
   Math::real GravityCircle::InternalT(real slam, real clam,
                                       real& deltaX, real& deltaY, real& deltaZ,
                                       bool gradp, bool correct) const {
@@ -135,11 +220,17 @@ namespace GeographicLib {
       if ((_caps & DISTURBING_POTENTIAL) != DISTURBING_POTENTIAL)
         return Math::NaN();
     }
-    if (_dzonal0 == 0)
-      correct = false;
     real T = (gradp
               ? _disturbing(slam, clam, deltaX, deltaY, deltaZ)
               : _disturbing(slam, clam));
+    return FinishT(slam, clam, T, deltaX, deltaY, deltaZ, gradp, correct);
+  }
+
+  Math::real GravityCircle::FinishT(real slam, real clam, real T,
+                                    real& deltaX, real& deltaY, real& deltaZ,
+                                    bool gradp, bool correct) const {
+    if (_dzonal0 == 0)
+      correct = false;
     T = (T / _amodel - (correct ? _dzonal0 : 0) * _invR) * _gGMmodel;
     if (gradp) {
       real f = _gGMmodel / _amodel;
@@ -11,9 +11,31 @@
 #include <fstream>
 #include <limits>
 #include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/Geoid.hpp>
 #include <GeographicLib/GravityCircle.hpp>
+#include <GeographicLib/Instrument.hpp>
 #include <GeographicLib/Utility.hpp>
 
+// For memory mapping the coefficient file
+#if defined(_WIN32)
+#  if !defined(NOMINMAX)
+#    define NOMINMAX 1
+#  endif
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#    define WIN32_LEAN_AND_MEAN 1
+#  endif
+#  include <windows.h>
+#  define GEOGRAPHICLIB_GRAVITY_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_GRAVITY_MMAP 1
+#else
+#  define GEOGRAPHICLIB_GRAVITY_MMAP 0
+#endif
+
 #if !defined(GEOGRAPHICLIB_DATA)
 #  if defined(_WIN32)
 #    define GEOGRAPHICLIB_DATA "C:/ProgramData/GeographicLib"
@@ -36,7 +58,7 @@ namespace GeographicLib {
   using namespace std;
 
   GravityModel::GravityModel(const std::string& name, const std::string& path,
-                             int Nmax, int Mmax)
+                             int Nmax, int Mmax, bool compact, bool mapped)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -48,7 +70,16 @@ namespace GeographicLib {
     , _nmx(-1)
     , _mmx(-1)
     , _norm(SphericalHarmonic::FULL)
+    , _compacterr(0)
+    , _map(nullptr)
+    , _mapsize(0)
+    , _circlebytes(0)
+    , _circlebudget(0)
+    , _circlehits(0)
+    , _circlemisses(0)
+    , _accuracy(0)
   {
+    GEOGRAPHICLIB_TRACE_SCOPE(GRAVITYMODEL_LOAD);
     if (_dir.empty())
       _dir = DefaultGravityPath();
     bool truncate = Nmax >= 0 || Mmax >= 0;
@@ -58,7 +89,7 @@ namespace GeographicLib {
       if (Mmax < 0) Mmax = numeric_limits<int>::max();
     }
     ReadMetadata(_name);
-    {
+    try {
       string coeff = _filename + ".cof";
       ifstream coeffstr(coeff.c_str(), ios::binary);
       if (!coeffstr.good())
@@ -72,15 +103,32 @@ namespace GeographicLib {
         throw GeographicErr("ID mismatch: " + _id + " vs " + id);
       int N, M;
       if (truncate) { N = Nmax; M = Mmax; }
-      SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _cCx, _sSx, truncate);
+      SphericalEngine::coeff c;
+      real* c0;                 // The degree 0 term
+      if (mapped && !compact) {
+        size_t pos = size_t(coeffstr.tellg());
+        coeffstr.seekg(0, ios::end);
+        MapFile(coeff, size_t(coeffstr.tellg()));
+        // The coefficients follow the degree and order
+        c0 = reinterpret_cast<real*>(_map + pos + 2 * sizeof(int));
+        c = SphericalEngine::coeff::mapcoeffs(_map, _mapsize, pos,
+                                              N, M, truncate);
+        coeffstr.seekg(streamoff(pos), ios::beg);
+      } else {
+        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _cCx, _sSx,
+                                           truncate);
+        c = SphericalEngine::coeff(_cCx, _sSx, N, N, M);
+        c0 = _cCx.data();
+      }
       if (!(N >= 0 && M >= 0))
         throw GeographicErr("Degree and order must be at least 0");
-      if (_cCx[0] != 0)
+      if (*c0 != 0)
         throw GeographicErr("The degree 0 term should be zero");
-      _cCx[0] = 1;              // Include the 1/r term in the sum
-      _gravitational = SphericalHarmonic(_cCx, _sSx, N, N, M, _amodel, _norm);
+      *c0 = 1;                  // Include the 1/r term in the sum
+      _gravitational = SphericalHarmonic(c, _amodel, _norm);
       if (truncate) { N = Nmax; M = Mmax; }
       SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _cCC, _cCS, truncate);
+      SphericalEngine::coeff::Trim(N, M, _cCC, _cCS);
       if (N < 0) {
         N = M = 0;
         _cCC.resize(1, real(0));
@@ -92,6 +140,11 @@ namespace GeographicLib {
       if (pos != coeffstr.tellg())
         throw GeographicErr("Extra data in " + coeff);
     }
+    catch (...) {
+      // The destructor isn't called if the constructor throws
+      UnmapFile();
+      throw;
+    }
     int nmx = _gravitational.Coefficients().nmx();
     _nmx = max(nmx, _correction.Coefficients().nmx());
     _mmx = max(_gravitational.Coefficients().mmx(),
@@ -112,7 +165,7 @@ namespace GeographicLib {
       // goes out to n = 18.
       mult *= amult;
       real
-        r = _cCx[n],                                       // the model term
+        r = _gravitational.Coefficients().Cv(n),           // the model term
         s = - mult * _earth.Jn(n) / sqrt(real(2 * n + 1)), // the normal term
         t = r - s;                                         // the difference
       if (t == r)               // the normal term is negligible
@@ -121,14 +174,110 @@ namespace GeographicLib {
       _zonal.push_back(s);
     }
     int nmx1 = int(_zonal.size()) - 1;
-    _disturbing = SphericalHarmonic1(_cCx, _sSx,
-                                     _gravitational.Coefficients().N(),
-                                     nmx, _gravitational.Coefficients().mmx(),
-                                     _zonal,
-                                     _zonal, // This is not accessed!
-                                     nmx1, nmx1, 0,
-                                     _amodel,
+    SphericalEngine::coeff c = _gravitational.Coefficients(),
+      c1(_zonal,
+         _zonal,                // This is not accessed!
+         nmx1, nmx1, 0);
+    if (compact) {
+      // Round the coefficients to floats (accumulating the mean square
+      // change in the sum) and release the originals.
+      int N = c.N();
+      _cCf.resize(_cCx.size()); _sSf.resize(_sSx.size());
+      real e2 = 0;
+      for (int m = 0, k = 0; m <= N; ++m)
+        for (int n = m; n <= N; ++n, ++k) {
+          // The mean square of the Schmidt harmonics is 1/(2n+1)
+          real w = _norm == SphericalHarmonic::FULL ? 1 : 1 / real(2*n + 1);
+          if (k < int(_cCf.size())) {
+            _cCf[k] = float(_cCx[k]);
+            e2 += w * Math::_sq(_cCx[k] - real(_cCf[k]));
+          }
+          int l = k - (N + 1);
+          if (m > 0 && l < int(_sSf.size())) {
+            _sSf[l] = float(_sSx[l]);
+            e2 += w * Math::_sq(_sSx[l] - real(_sSf[l]));
+          }
+        }
+      // The geoid height is T/gamma ~ a * sum (C_nm Y_nm)
+      _compacterr = _amodel * sqrt(e2);
+      vector<real>().swap(_cCx); vector<real>().swap(_sSx);
+      c = SphericalEngine::coeff(_cCf.data(), _cCf.size(),
+                                 _sSf.data(), _sSf.size(),
+                                 N, c.nmx(), c.mmx());
+      _gravitational = SphericalHarmonic(c, _amodel, _norm);
+    }
+    _disturbing = SphericalHarmonic1(c, c1, _amodel,
                                      SphericalHarmonic1::normalization(_norm));
+    MemoryFootprint::Register(this, [](const void* g) {
+      return static_cast<const GravityModel*>(g)->MemoryUsage();
+    });
+  }
+
+  GravityModel::~GravityModel() {
+    MemoryFootprint::Unregister(this);
+    UnmapFile();
+  }
+
+  MemoryFootprint GravityModel::MemoryUsage() const {
+    size_t heap = MemoryFootprint::Bytes(_cCx) + MemoryFootprint::Bytes(_sSx) +
+      MemoryFootprint::Bytes(_cCC) + MemoryFootprint::Bytes(_cCS) +
+      MemoryFootprint::Bytes(_zonal) +
+      MemoryFootprint::Bytes(_cCf) + MemoryFootprint::Bytes(_sSf);
+    lock_guard<mutex> g(_circlelock);
+    return MemoryFootprint(heap, _map ? _mapsize : 0, _circlebytes);
+  }
+
+  void GravityModel::MapFile(const string& filename, size_t size) {
+#if GEOGRAPHICLIB_GRAVITY_MMAP
+    // The mapping is private and writable so that the degree 0 term can be
+    // set; only the page containing it is copied.
+#  if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      throw GeographicErr("File not readable " + filename);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY,
+                                        0, 0, NULL);
+    void* addr = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) :
+      NULL;
+    // The view keeps the mapping alive after the handles are closed
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!addr)
+      throw GeographicErr("Cannot map file " + filename);
+#  else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("File not readable " + filename);
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    // The mapping remains valid after the file descriptor is closed
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw GeographicErr("Cannot map file " + filename);
+#  endif
+    _map = static_cast<char*>(addr);
+    _mapsize = size;
+#else
+    (void)size;
+    throw GeographicErr("Memory mapping is not supported on this system: "
+                        + filename);
+#endif
+  }
+
+  void GravityModel::UnmapFile() {
+#if GEOGRAPHICLIB_GRAVITY_MMAP
+    if (_map) {
+#  if defined(_WIN32)
+      UnmapViewOfFile(_map);
+#  else
+      munmap(_map, _mapsize);
+#  endif
+    }
+#endif
+    _map = nullptr;
+    _mapsize = 0;
   }
 
   void GravityModel::ReadMetadata(const string& name) {
@@ -219,11 +368,22 @@ namespace GeographicLib {
     if (_dzonal0 == 0)
       // No need to do the correction
       correct = false;
-    real T, invR = correct ? 1 / hypot(hypot(X, Y), Z) : 1;
+    real T, invR = correct || _accuracy > 0 ? 1 / hypot(hypot(X, Y), Z) : 1;
+    int N = Truncation(1 / invR);
+    SphericalHarmonic1 disturbing;
+    if (N < _disturbing.Coefficients().nmx()) {
+      disturbing =
+        SphericalHarmonic1(_disturbing.Coefficients().Truncate(N, N),
+                           _disturbing.Coefficients1().Truncate(N, N),
+                           _amodel, SphericalHarmonic1::normalization(_norm));
+      disturbing.SetThreads(Threads());
+    }
+    const SphericalHarmonic1& dist =
+      N < _disturbing.Coefficients().nmx() ? disturbing : _disturbing;
     if (gradp) {
       // initial values to suppress warnings
       deltaX = deltaY = deltaZ = 0;
-      T = _disturbing(-1, X, Y, Z, deltaX, deltaY, deltaZ);
+      T = dist(-1, X, Y, Z, deltaX, deltaY, deltaZ);
       real f = _gGMmodel / _amodel;
       deltaX *= f;
       deltaY *= f;
@@ -235,16 +395,23 @@ namespace GeographicLib {
         deltaZ += Z * invR;
       }
     } else
-      T = _disturbing(-1, X, Y, Z);
+      T = dist(-1, X, Y, Z);
     T = (T / _amodel - (correct ? _dzonal0 : 0) * invR) * _gGMmodel;
     return T;
   }
 
   Math::real GravityModel::V(real X, real Y, real Z,
                              real& GX, real& GY, real& GZ) const {
-    real
-      Vres = _gravitational(X, Y, Z, GX, GY, GZ),
-      f = _gGMmodel / _amodel;
+    int N = Truncation(hypot(hypot(X, Y), Z));
+    real Vres, f = _gGMmodel / _amodel;
+    if (N < _gravitational.Coefficients().nmx()) {
+      SphericalHarmonic
+        gravitational(_gravitational.Coefficients().Truncate(N, N),
+                      _amodel, _norm);
+      gravitational.SetThreads(Threads());
+      Vres = gravitational(X, Y, Z, GX, GY, GZ);
+    } else
+      Vres = _gravitational(X, Y, Z, GX, GY, GZ);
     Vres *= f;
     GX *= f;
     GY *= f;
@@ -261,8 +428,39 @@ namespace GeographicLib {
     return Wres;
   }
 
+  Math::real GravityModel::GravityGradient(real X, real Y, real Z,
+                                           real& gX, real& gY, real& gZ,
+                                           real Gamma[]) const {
+    int N = Truncation(hypot(hypot(X, Y), Z));
+    real Wres, f = _gGMmodel / _amodel;
+    if (N < _gravitational.Coefficients().nmx()) {
+      SphericalHarmonic
+        gravitational(_gravitational.Coefficients().Truncate(N, N),
+                      _amodel, _norm);
+      Wres = gravitational.Hessian(X, Y, Z, gX, gY, gZ, Gamma);
+    } else
+      Wres = _gravitational.Hessian(X, Y, Z, gX, gY, gZ, Gamma);
+    Wres *= f;
+    gX *= f;
+    gY *= f;
+    gZ *= f;
+    for (int i = 0; i < 6; ++i)
+      Gamma[i] *= f;
+    real fX, fY, omega2 = Math::_sq(_earth.AngularVelocity());
+    Wres += _earth.Phi(X, Y, fX, fY);
+    gX += fX;
+    gY += fY;
+    Gamma[0] += omega2;
+    Gamma[3] += omega2;
+    return Wres;
+  }
+
   void GravityModel::SphericalAnomaly(real lat, real lon, real h,
                                       real& Dg01, real& xi, real& eta) const {
+    if (_circlebudget) {
+      shared_ptr<const GravityCircle> c = CachedCircle(lat, h);
+      if (c) { c->SphericalAnomaly(lon, Dg01, xi, eta); return; }
+    }
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real
@@ -289,6 +487,10 @@ namespace GeographicLib {
 
   Math::real GravityModel::GeoidHeight(real lat, real lon) const
   {
+    if (_circlebudget) {
+      shared_ptr<const GravityCircle> c = CachedCircle(lat, 0);
+      if (c) return c->GeoidHeight(lon);
+    }
     real X, Y, Z;
     _earth.Earth().IntForward(lat, lon, 0, X, Y, Z, NULL);
     real
@@ -303,6 +505,10 @@ namespace GeographicLib {
 
   Math::real GravityModel::Gravity(real lat, real lon, real h,
                                    real& gx, real& gy, real& gz) const {
+    if (_circlebudget) {
+      shared_ptr<const GravityCircle> c = CachedCircle(lat, h);
+      if (c) return c->Gravity(lon, gx, gy, gz);
+    }
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real Wres = W(X, Y, Z, gx, gy, gz);
@@ -312,6 +518,10 @@ namespace GeographicLib {
   Math::real GravityModel::Disturbance(real lat, real lon, real h,
                                        real& deltax, real& deltay,
                                        real& deltaz) const {
+    if (_circlebudget) {
+      shared_ptr<const GravityCircle> c = CachedCircle(lat, h);
+      if (c) return c->Disturbance(lon, deltax, deltay, deltaz);
+    }
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.Earth().IntForward(lat, lon, h, X, Y, Z, M);
     real Tres = InternalT(X, Y, Z, deltax, deltay, deltaz, true, true);
@@ -320,37 +530,341 @@ namespace GeographicLib {
   }
 
   GravityCircle GravityModel::Circle(real lat, real h, unsigned caps) const {
+    GravityCircle circ;
+    Circles(1, &lat, h, caps, &circ, Threads());
+    return circ;
+  }
+
+  void GravityModel::Circles(size_t n, const real lat[], real h,
+                             unsigned caps, GravityCircle circ[],
+                             int nthreads) const {
     if (h != 0)
       // Disallow invoking GeoidHeight unless h is zero.
       caps &= ~(CAP_GAMMA0 | CAP_C);
-    real X, Y, Z, M[Geocentric::dim2_];
-    _earth.Earth().IntForward(lat, 0, h, X, Y, Z, M);
-    // Y = 0, cphi = M[7], sphi = M[8];
-    real
-      invR = 1 / hypot(X, Z),
-      gamma0 = (caps & CAP_GAMMA0 ?_earth.SurfaceGravity(lat)
-                : Math::NaN()),
-      fx, fy, fz, gamma;
-    if (caps & CAP_GAMMA) {
-      _earth.U(X, Y, Z, fx, fy, fz); // fy = 0
-      gamma = hypot(fx, fz);
-    } else
-      gamma = Math::NaN();
-    _earth.Phi(X, Y, fx, fy);
-    return GravityCircle(GravityCircle::mask(caps),
-                         _earth._a, _earth._f, lat, h, Z, X, M[7], M[8],
-                         _amodel, _gGMmodel, _dzonal0, _corrmult,
-                         gamma0, gamma, fx,
-                         caps & CAP_G ?
-                         _gravitational.Circle(X, Z, true) :
-                         CircularEngine(),
-                         // N.B. If CAP_DELTA is set then CAP_T should be too.
-                         caps & CAP_T ?
-                         _disturbing.Circle(-1, X, Z, (caps&CAP_DELTA) != 0) :
-                         CircularEngine(),
-                         caps & CAP_C ?
-                         _correction.Circle(invR * X, invR * Z, false) :
-                         CircularEngine());
+    // For each circle, X = P, Y = 0, cphi = M[7], sphi = M[8]
+    vector<real> X(n), Z(n), cphi(n), sphi(n), Xs(n), Zs(n);
+    int N = -1;
+    for (size_t i = 0; i < n; ++i) {
+      real Y, M[Geocentric::dim2_];
+      _earth.Earth().IntForward(lat[i], 0, h, X[i], Y, Z[i], M);
+      cphi[i] = M[7]; sphi[i] = M[8];
+      real invR = 1 / hypot(X[i], Z[i]);
+      Xs[i] = invR * X[i]; Zs[i] = invR * Z[i];
+      // Use the largest degree needed for any of the circles
+      N = max(N, Truncation(1 / invR));
+    }
+    const SphericalEngine::coeff
+      &c = _gravitational.Coefficients(), &c1 = _disturbing.Coefficients1();
+    SphericalHarmonic gravitational(c.Truncate(N, N), _amodel, _norm);
+    SphericalHarmonic1
+      disturbing(c.Truncate(N, N), c1.Truncate(N, N), _amodel,
+                 SphericalHarmonic1::normalization(_norm));
+    gravitational.SetThreads(nthreads);
+    disturbing.SetThreads(nthreads);
+    vector<CircularEngine> gcirc(n), tcirc(n), ccirc(n);
+    if (caps & CAP_G)
+      gravitational.Circles(n, X.data(), Z.data(), true, gcirc.data());
+    // N.B. If CAP_DELTA is set then CAP_T should be too.
+    if (caps & CAP_T)
+      disturbing.Circles(-1, n, X.data(), Z.data(), (caps&CAP_DELTA) != 0,
+                         tcirc.data());
+    if (caps & CAP_C)
+      _correction.Circles(n, Xs.data(), Zs.data(), false, ccirc.data());
+    for (size_t i = 0; i < n; ++i) {
+      real
+        gamma0 = (caps & CAP_GAMMA0 ?_earth.SurfaceGravity(lat[i])
+                  : Math::NaN()),
+        fx, fy, fz, gamma;
+      if (caps & CAP_GAMMA) {
+        _earth.U(X[i], 0, Z[i], fx, fy, fz); // fy = 0
+        gamma = hypot(fx, fz);
+      } else
+        gamma = Math::NaN();
+      _earth.Phi(X[i], 0, fx, fy);
+      circ[i] = GravityCircle(GravityCircle::mask(caps),
+                              _earth._a, _earth._f, lat[i], h, Z[i], X[i],
+                              cphi[i], sphi[i],
+                              _amodel, _gGMmodel, _dzonal0, _corrmult,
+                              gamma0, gamma, fx,
+                              gcirc[i], tcirc[i], ccirc[i]);
+    }
+  }
+
+  void GravityModel::SetThreads(int nthreads) {
+    _gravitational.SetThreads(nthreads);
+    _disturbing.SetThreads(nthreads);
+    _correction.SetThreads(nthreads);
+  }
+
+  size_t GravityModel::CircleBytes() const {
+    // The gravitational and disturbing circles hold 6 coefficients per
+    // order; the correction circle (of low degree) holds 2.
+    return sizeof(GravityCircle) + 14 * size_t(_mmx + 1) * sizeof(real);
+  }
+
+  void GravityModel::SetCircleCacheSize(size_t maxbytes) {
+    lock_guard<mutex> g(_circlelock);
+    _circlebudget = maxbytes;
+    _circlehits = _circlemisses = 0;
+    while (!_circlelru.empty() && _circlebytes > _circlebudget) {
+      _circlemap.erase(_circlelru.back().first);
+      _circlelru.pop_back();
+      _circlebytes -= CircleBytes();
+    }
+  }
+
+  void GravityModel::SetAccuracy(real accuracy) {
+    if (!(isfinite(accuracy) && accuracy >= 0))
+      throw GeographicErr("Accuracy must be nonnegative and finite");
+    lock_guard<mutex> g(_circlelock);
+    _accuracy = accuracy;
+    // The cached circles may have been truncated differently
+    _circlemap.clear();
+    _circlelru.clear();
+    _circlebytes = 0;
+  }
+
+  int GravityModel::TruncationDegree(real h, real accuracy) const {
+    return TruncationDegreeR(_earth._a * (1 - _earth._f) + h, accuracy);
+  }
+
+  int GravityModel::Truncation(real R) const {
+    return _accuracy > 0 ? TruncationDegreeR(R, _accuracy) :
+      _gravitational.Coefficients().nmx();
+  }
+
+  int GravityModel::TruncationDegreeR(real R, real accuracy) const {
+    const SphericalEngine::coeff& c = _gravitational.Coefficients();
+    call_once(_degvarflag, [this, &c] {
+      _degvar.resize(c.nmx() + 1);
+      for (int n = 0; n <= c.nmx(); ++n) {
+        real s = 0;
+        for (int m = 0; m <= min(n, c.mmx()); ++m) {
+          int k = c.index(n, m);
+          s += Math::_sq(c.Cv(k)) + (m ? Math::_sq(c.Sv(k)) : 0);
+        }
+        // The mean square of the Schmidt harmonics is 1/(2n+1)
+        _degvar[n] = _norm == SphericalHarmonic::FULL ? s : s / (2*n + 1);
+      }
+    });
+    int nmx = c.nmx();
+    if (!(R > 0 && accuracy > 0)) return nmx;
+    // Accumulate the mean square of the omitted terms of the gravity
+    // disturbance (the radial component contributes (n+1)^2 and the
+    // horizontal components n(n+1)),
+    //   (GM/R^2)^2 * sum(n = N+1..nmx, (n+1)(2n+1) (a/R)^(2n) sigma_n^2),
+    // from the top down until it exceeds accuracy^2.
+    real q = Math::_sq(_amodel / R),
+      tol = Math::_sq(accuracy * R * R / _gGMmodel), err2 = 0;
+    if (q < 1)
+      // Skip the terms which underflow (these are negligible)
+      nmx = int(min(real(nmx), log(numeric_limits<real>::min()) / log(q)));
+    for (real p = pow(q, nmx); nmx > 0; --nmx, p /= q) {
+      err2 += real(nmx + 1) * (2*nmx + 1) * p * _degvar[nmx];
+      if (!(err2 <= tol)) break;
+    }
+    return nmx;
+  }
+
+  shared_ptr<const GravityCircle>
+  GravityModel::CachedCircle(real lat, real h) const {
+    if (!(_circlebudget && isfinite(lat) && isfinite(h)))
+      return nullptr;
+    circlekey k(lat, h);
+    {
+      lock_guard<mutex> g(_circlelock);
+      auto p = _circlemap.find(k);
+      if (p != _circlemap.end()) {
+        ++_circlehits;
+        _circlelru.splice(_circlelru.begin(), _circlelru, p->second);
+        return p->second->second;
+      }
+      ++_circlemisses;
+    }
+    // Construct the circle without holding the lock; if another thread
+    // constructs it meanwhile, use that one.
+    shared_ptr<const GravityCircle> c(new GravityCircle(Circle(lat, h, ALL)));
+    size_t bytes = CircleBytes();
+    lock_guard<mutex> g(_circlelock);
+    auto p = _circlemap.find(k);
+    if (p != _circlemap.end())
+      return p->second->second;
+    if (bytes > _circlebudget)
+      // Too big to cache
+      return c;
+    while (_circlebytes + bytes > _circlebudget) {
+      _circlemap.erase(_circlelru.back().first);
+      _circlelru.pop_back();
+      _circlebytes -= bytes;
+    }
+    _circlelru.push_front(make_pair(k, c));
+    _circlemap[k] = _circlelru.begin();
+    _circlebytes += bytes;
+    return c;
+  }
+
+  template<class F>
+  void GravityModel::Batch(size_t n, const real lat[], const real h[],
+                           unsigned caps, F f) const {
+    // Sort the points by latitude and height; NaNs go at the end.
+    vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    auto key = [lat, h](size_t i) -> pair<real, real>
+      { return make_pair(lat[i], h ? h[i] : real(0)); };
+    auto finite = [&key](size_t i) -> bool
+      { pair<real, real> k = key(i);
+        return isfinite(k.first) && isfinite(k.second); };
+    sort(order.begin(), order.end(),
+         [&key, &finite](size_t i, size_t j) -> bool
+         { bool fi = finite(i), fj = finite(j);
+           return fi != fj ? fi : (fi && key(i) < key(j)); });
+    for (size_t k0 = 0; k0 < n;) {
+      size_t k1 = k0 + 1;
+      pair<real, real> k = key(order[k0]);
+      if (finite(order[k0]))
+        while (k1 < n && key(order[k1]) == k) ++k1;
+      else
+        k1 = n;
+      shared_ptr<const GravityCircle> cc;
+      if (finite(order[k0]) && (cc = CachedCircle(k.first, k.second)))
+        for (; k0 < k1; ++k0) f(order[k0], cc.get());
+      else if (k1 - k0 >= mincircle_ && finite(order[k0])) {
+        GravityCircle c(Circle(k.first, k.second, caps));
+        for (; k0 < k1; ++k0) f(order[k0], &c);
+      } else
+        for (; k0 < k1; ++k0) f(order[k0], (const GravityCircle*)(nullptr));
+    }
+  }
+
+  void GravityModel::GravityBatch(size_t n, const real lat[], const real lon[],
+                                  const real h[],
+                                  real gx[], real gy[], real gz[], real W[])
+    const {
+    Batch(n, lat, h, GRAVITY,
+          [=](size_t i, const GravityCircle* c) -> void {
+            real w = c ? c->Gravity(lon[i], gx[i], gy[i], gz[i]) :
+              Gravity(lat[i], lon[i], h[i], gx[i], gy[i], gz[i]);
+            if (W) W[i] = w;
+          });
+  }
+
+  void GravityModel::DisturbanceBatch(size_t n, const real lat[],
+                                      const real lon[], const real h[],
+                                      real deltax[], real deltay[],
+                                      real deltaz[], real T[]) const {
+    Batch(n, lat, h, DISTURBANCE,
+          [=](size_t i, const GravityCircle* c) -> void {
+            real t = c ?
+              c->Disturbance(lon[i], deltax[i], deltay[i], deltaz[i]) :
+              Disturbance(lat[i], lon[i], h[i], deltax[i], deltay[i],
+                          deltaz[i]);
+            if (T) T[i] = t;
+          });
+  }
+
+  void GravityModel::GeoidHeightBatch(size_t n,
+                                      const real lat[], const real lon[],
+                                      real N[]) const {
+    Batch(n, lat, nullptr, GEOID_HEIGHT,
+          [=](size_t i, const GravityCircle* c) -> void {
+            N[i] = c ? c->GeoidHeight(lon[i]) : GeoidHeight(lat[i], lon[i]);
+          });
+  }
+
+  void GravityModel::SphericalAnomalyBatch(size_t n, const real lat[],
+                                           const real lon[], const real h[],
+                                           real Dg01[], real xi[], real eta[])
+    const {
+    Batch(n, lat, h, SPHERICAL_ANOMALY,
+          [=](size_t i, const GravityCircle* c) -> void {
+            if (c)
+              c->SphericalAnomaly(lon[i], Dg01[i], xi[i], eta[i]);
+            else
+              SphericalAnomaly(lat[i], lon[i], h[i], Dg01[i], xi[i], eta[i]);
+          });
+  }
+
+  void GravityModel::Grid(real lat0, real dlat, size_t nlat,
+                          real lon0, real dlon, size_t nlon, real h,
+                          unsigned what,
+                          real out1[], real out2[], real out3[]) const {
+    if (!(what == GRAVITY || what == DISTURBANCE ||
+          what == DISTURBING_POTENTIAL || what == GEOID_HEIGHT ||
+          what == SPHERICAL_ANOMALY))
+      throw GeographicErr("Unsupported quantity for GravityModel::Grid");
+    if (what == GEOID_HEIGHT) h = 0;
+    int nthreads = int(min(size_t(max(Threads(), 1)),
+                           (nlat + gridrows_ - 1) / gridrows_));
+    // The rows are handled in blocks of gridrows_ whose circles are
+    // constructed together; blocks i, i + nthreads, ... are handled by task
+    // i.
+    auto worker = [&](int t) -> void {
+      real lat[gridrows_];
+      GravityCircle circ[gridrows_];
+      for (size_t i0 = size_t(t) * gridrows_; i0 < nlat;
+           i0 += size_t(nthreads) * gridrows_) {
+        size_t m = min(size_t(gridrows_), nlat - i0);
+        for (size_t i = 0; i < m; ++i)
+          lat[i] = lat0 + real(i0 + i) * dlat;
+        Circles(m, lat, h, what, circ);
+        for (size_t i = 0; i < m; ++i) {
+          size_t k = (i0 + i) * nlon;
+          circ[i].Grid(what, lon0, dlon, nlon,
+                       out1 ? out1 + k : nullptr,
+                       out2 ? out2 + k : nullptr,
+                       out3 ? out3 + k : nullptr);
+        }
+      }
+    };
+    Executor::Batch(nthreads, worker);
+  }
+
+  void GravityModel::GeoidPGM(ostream& os, int ndeg,
+                              real offset, real scale) const {
+#if GEOGRAPHICLIB_GEOID_PGM_PIXEL_WIDTH != 4
+    typedef unsigned short pixel_t;
+#else
+    typedef unsigned pixel_t;
+#endif
+    const real pixel_max = real(numeric_limits<pixel_t>::max());
+    if (!(ndeg > 0 && ndeg <= 3600))
+      throw GeographicErr("Bad number of grid intervals per degree");
+    if (!(scale > 0 && isfinite(offset)))
+      throw GeographicErr("Scale must be positive");
+    const size_t
+      width = size_t(Math::td) * size_t(ndeg),
+      height = size_t(Math::hd) * size_t(ndeg) + 1,
+      // Give each thread a couple of blocks of rows for Grid
+      block = min(height, 2 * gridrows_ * size_t(max(Threads(), 1)));
+    const real d = 1 / real(ndeg);
+    os << "P5\n"
+       << "# Geoid file in PGM format for the GeographicLib::Geoid class\n"
+       << "# Description " << _name << " geoid heights, "
+       << "1/" << ndeg << " degree grid\n"
+       << "# Offset " << Utility::str(offset) << "\n"
+       << "# Scale " << Utility::str(scale) << "\n"
+       << "# Origin 90N 0E\n"
+       << "# AREA_OR_POINT Point\n"
+       << width << " " << height << "\n"
+       << (unsigned long long)(pixel_max) << "\n";
+    vector<real> v(block * width);
+    vector<pixel_t> data(block * width);
+    for (size_t i0 = 0; i0 < height; i0 += block) {
+      size_t m = min(block, height - i0);
+      // Rows from north to south; lat = 90 - i * d
+      Grid(Math::qd - real(i0) * d, -d, m, 0, d, width, 0, GEOID_HEIGHT,
+           v.data());
+      for (size_t k = 0; k < m * width; ++k) {
+        real p = floor((v[k] - offset) / scale + real(0.5));
+        if (!(p >= 0 && p <= pixel_max))
+          throw GeographicErr("Geoid height " + Utility::str(v[k]) +
+                              " can't be represented in the PGM file");
+        data[k] = pixel_t(p);
+      }
+      Utility::writearray<pixel_t, pixel_t, true>(os, data.data(), m * width);
+      if (!os.good())
+        throw GeographicErr("Error writing the PGM file");
+    }
   }
 
   string GravityModel::DefaultGravityPath() {
@@ -0,0 +1,175 @@
+/**
+ * \file Instrument.cpp
+ * \brief Implementation for GeographicLib::Instrument class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/Instrument.hpp>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+
+    typedef unsigned long long count_t;
+
+    // The counters for one thread.  Only the owning thread writes to them;
+    // so the updates are relaxed loads and stores (no read-modify-write).
+    // The atomics allow Snapshot to read them while they are being updated.
+    struct Block {
+      atomic<count_t> calls[Instrument::NUMSOLVERS],
+        iterations[Instrument::NUMSOLVERS],
+        fallbacks[Instrument::NUMSOLVERS],
+        hist[Instrument::NUMSOLVERS][Instrument::NBINS];
+      Block() { clear(); }
+      static void bump(atomic<count_t>& c, count_t n = 1) {
+        c.store(c.load(memory_order_relaxed) + n, memory_order_relaxed);
+      }
+      void clear() {
+        for (int s = 0; s < Instrument::NUMSOLVERS; ++s) {
+          calls[s].store(0, memory_order_relaxed);
+          iterations[s].store(0, memory_order_relaxed);
+          fallbacks[s].store(0, memory_order_relaxed);
+          for (int k = 0; k < Instrument::NBINS; ++k)
+            hist[s][k].store(0, memory_order_relaxed);
+        }
+      }
+      void addto(int s, Instrument::Counts& c) const {
+        c.calls += calls[s].load(memory_order_relaxed);
+        c.iterations += iterations[s].load(memory_order_relaxed);
+        c.fallbacks += fallbacks[s].load(memory_order_relaxed);
+        for (int k = 0; k < Instrument::NBINS; ++k)
+          c.hist[k] += hist[s][k].load(memory_order_relaxed);
+      }
+    };
+
+    // The live blocks and the totals for threads which have exited.
+    struct Registry {
+      mutex lock;
+      vector<Block*> live;
+      Instrument::Counts retired[Instrument::NUMSOLVERS];
+      Registry() { fill_n(retired, int(Instrument::NUMSOLVERS), zero()); }
+      static Instrument::Counts zero() {
+        Instrument::Counts c;
+        c.calls = c.iterations = c.fallbacks = 0;
+        fill_n(c.hist, int(Instrument::NBINS), count_t(0));
+        return c;
+      }
+    };
+
+    // Constructed on first use (by the first thread to record a call); so it
+    // outlives the thread-local blocks.
+    Registry& registry() {
+      static Registry r;
+      return r;
+    }
+
+    // The block for the current thread registers itself on construction and
+    // folds its counts into the retired totals when the thread exits.
+    struct ThreadBlock {
+      Block b;
+      ThreadBlock() {
+        Registry& r = registry();
+        lock_guard<mutex> g(r.lock);
+        r.live.push_back(&b);
+      }
+      ~ThreadBlock() {
+        Registry& r = registry();
+        lock_guard<mutex> g(r.lock);
+        for (int s = 0; s < Instrument::NUMSOLVERS; ++s)
+          b.addto(s, r.retired[s]);
+        r.live.erase(remove(r.live.begin(), r.live.end(), &b), r.live.end());
+      }
+    };
+
+    Block& threadblock() {
+      static thread_local ThreadBlock t;
+      return t.b;
+    }
+
+  }
+
+  void Instrument::Record(solver s, unsigned iterations, bool fallback) {
+    if (!(s >= 0 && s < NUMSOLVERS)) return;
+    Block& b = threadblock();
+    Block::bump(b.calls[s]);
+    Block::bump(b.iterations[s], iterations);
+    if (fallback) Block::bump(b.fallbacks[s]);
+    Block::bump(b.hist[s][min(iterations, unsigned(NBINS - 1))]);
+  }
+
+  Instrument::Counts Instrument::Snapshot(solver s) {
+    Counts c = Registry::zero();
+    if (!(s >= 0 && s < NUMSOLVERS)) return c;
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    c = r.retired[s];
+    for (const Block* b : r.live)
+      b->addto(s, c);
+    return c;
+  }
+
+  void Instrument::Snapshot(Counts counts[]) {
+    for (int s = 0; s < NUMSOLVERS; ++s)
+      counts[s] = Snapshot(solver(s));
+  }
+
+  void Instrument::Reset() {
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    fill_n(r.retired, int(NUMSOLVERS), Registry::zero());
+    for (Block* b : r.live)
+      b->clear();
+  }
+
+  const char* Instrument::Name(solver s) {
+    static const char* const names[NUMSOLVERS] = {
+      "Geodesic", "GeodesicExact", "Gnomonic", "AlbersEqualArea",
+      "TransverseMercatorExact::zetainv", "TransverseMercatorExact::sigmainv",
+      "Intersect",
+    };
+    return s >= 0 && s < NUMSOLVERS ? names[s] : "unknown";
+  }
+
+  bool Instrument::Enabled() {
+    return GEOGRAPHICLIB_INSTRUMENT != 0;
+  }
+
+  namespace {
+    atomic<Instrument::tracer>& currenttracer() {
+      static atomic<Instrument::tracer> t(nullptr);
+      return t;
+    }
+  }
+
+  void Instrument::SetTracer(tracer t) {
+    currenttracer().store(t, memory_order_release);
+  }
+
+  Instrument::tracer Instrument::Tracer() {
+    return currenttracer().load(memory_order_acquire);
+  }
+
+  const char* Instrument::Name(phase p) {
+    static const char* const names[NUMPHASES] = {
+      "Geoid::load", "Geoid::cache", "GravityModel::load",
+      "MagneticModel::load", "SphericalEngine::sum",
+      "SphericalEngine::circle", "Geodesic::iterate",
+      "GeodesicExact::iterate",
+    };
+    return p >= 0 && p < NUMPHASES ? names[p] : "unknown";
+  }
+
+  bool Instrument::TraceEnabled() {
+    return GEOGRAPHICLIB_TRACE != 0;
+  }
+
+} // namespace GeographicLib
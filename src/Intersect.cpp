@@ -8,15 +8,39 @@
  **********************************************************************/
 
 #include <GeographicLib/Intersect.hpp>
+#include <GeographicLib/Instrument.hpp>
+#include <GeographicLib/Executor.hpp>
 #include <limits>
 #include <utility>
 #include <algorithm>
-#include <set>
+#include <iterator>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
 
 using namespace std;
 
 namespace GeographicLib {
 
+  namespace {
+
+    // The distances computed by the constructor for each ellipsoid (a, f,
+    // exact) which has been seen so far.  The cache is cleared if it grows
+    // to maxcache_ entries.
+    typedef Math::real real;
+    typedef tuple<real, real, bool> ellipsoid;
+    struct distances { real t1, t2, t3, t4, t5; };
+    const size_t maxcache_ = 64;
+    mutex cachelock_;
+    map<ellipsoid, distances>& cache() {
+      static map<ellipsoid, distances> c;
+      return c;
+    }
+
+  } // namespace
+
   Intersect::Intersect(const Geodesic& geod)
     : _geod(geod)
     , _a(_geod.EquatorialRadius())
@@ -33,22 +57,43 @@ namespace GeographicLib {
     , _cnt3(0)
     , _cnt4(0)
   {
-    _t1 = _t4 = _a * (1 - _f) * Math::pi();
-    _t2 = 2 * distpolar(90);
-    _geod.Inverse(0, 0, 90, 0, _t5); _t5 *= 2;
-    if (_f > 0) {
-      _t3 = distoblique();
-      _t4 = _t1;
-    } else {
-      _t3 = _t5;
-      _t4 = polarb();
-      swap(_t1, _t2);
+    ellipsoid key(_a, _f, _geod.Exact());
+    bool cacheable = isfinite(_a) && isfinite(_f), cached = false;
+    if (cacheable) {
+      lock_guard<mutex> g(cachelock_);
+      auto p = cache().find(key);
+      if (p != cache().end()) {
+        const distances& t = p->second;
+        _t1 = t.t1; _t2 = t.t2; _t3 = t.t3; _t4 = t.t4; _t5 = t.t5;
+        cached = true;
+      }
+    }
+    if (!cached) {
+      _t1 = _t4 = _a * (1 - _f) * Math::pi();
+      _t2 = 2 * distpolar(90);
+      _geod.Inverse(0, 0, 90, 0, _t5); _t5 *= 2;
+      if (_f > 0) {
+        _t3 = distoblique();
+        _t4 = _t1;
+      } else {
+        _t3 = _t5;
+        _t4 = polarb();
+        swap(_t1, _t2);
+      }
     }
     _d1 = _t2 / 2;
     _d2 = 2 * _t3 / 3;
     _d3 = _t4 - _delta;
     if (! (_d1 < _d3 && _d2 < _d3 && _d2 < 2 * _t1) )
       throw GeographicErr("Ellipsoid too eccentric for Closest");
+    if (cacheable && !cached) {
+      lock_guard<mutex> g(cachelock_);
+      if (cache().size() >= maxcache_) cache().clear();
+      distances t = {_t1, _t2, _t3, _t4, _t5};
+      cache()[key] = t;
+    }
+    // Don't count the work done computing the distances
+    _cnt0 = _cnt1 = _cnt2 = _cnt3 = _cnt4 = 0;
   }
 
   Intersect::Point
@@ -135,6 +180,237 @@ namespace GeographicLib {
     return AllInternal(lineX, lineY, maxdist, p0, c, true);
   }
 
+  std::vector<Intersect::Point>
+  Intersect::Segments(size_t n,
+                      const Math::real lat1[], const Math::real lon1[],
+                      const Math::real lat2[], const Math::real lon2[],
+                      std::vector<std::pair<size_t, size_t>>& ij,
+                      std::vector<int>* c, int nthreads) const {
+    vector<GeodesicLine> lines;
+    lines.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+      lines.push_back(_geod.InverseLine(lat1[i], lon1[i], lat2[i], lon2[i],
+                                        LineCaps));
+    return Segments(lines, ij, c, nthreads);
+  }
+
+  std::vector<Intersect::Point>
+  Intersect::Segments(const std::vector<GeodesicLine>& lines,
+                      std::vector<std::pair<size_t, size_t>>& ij,
+                      std::vector<int>* c, int nthreads) const {
+    size_t n = lines.size();
+    // Enclose each segment in a cap about its midpoint.  Two segments can
+    // only intersect if their caps overlap.
+    vector<real> caps(5 * n);
+    for (size_t i = 0; i < n; ++i)
+      SegmentCap(lines[i], &caps[5 * i]);
+    vector<pair<size_t, size_t>> cand;
+    SegmentCandidates(caps, cand);
+    // The candidate pairs are processed with indices k, k + nthreads, ... by
+    // task k.
+    size_t ncand = cand.size();
+    nthreads = int(min(size_t(max(nthreads, 1)), max(ncand, size_t(1))));
+    struct result {
+      size_t i, j;
+      XPoint p;
+      result(size_t i1, size_t j1, const XPoint& p1) : i(i1), j(j1), p(p1) {}
+    };
+    vector<vector<result>> res(nthreads);
+    auto worker = [&](const Intersect& inter, int k) -> void {
+      for (size_t l = k; l < ncand; l += nthreads) {
+        size_t i = cand[l].first, j = cand[l].second;
+        int segmode;
+        XPoint p = inter.SegmentInt(lines[i], lines[j], segmode);
+        if (segmode == 0) res[k].emplace_back(i, j, p);
+      }
+    };
+    if (nthreads == 1)
+      worker(*this, 0);
+    else {
+      // Each task gets a private copy of *this so that the tasks don't
+      // contend for the (mutable) counters.
+      vector<Intersect> inters(nthreads, *this);
+      for (auto& inter : inters)
+        inter._cnt0 = inter._cnt1 = inter._cnt2 = inter._cnt3 = inter._cnt4
+          = 0;
+      Executor::Batch(nthreads,
+                      [&](int k) -> void { worker(inters[k], k); });
+      for (const auto& inter : inters) {
+        _cnt0 += inter._cnt0; _cnt1 += inter._cnt1; _cnt2 += inter._cnt2;
+        _cnt3 += inter._cnt3; _cnt4 += inter._cnt4;
+      }
+    }
+    vector<result> all;
+    for (auto& r : res)
+      all.insert(all.end(), r.begin(), r.end());
+    if (nthreads > 1)
+      sort(all.begin(), all.end(),
+           [](const result& a, const result& b) -> bool
+           { return a.i < b.i || (a.i == b.i && a.j < b.j); });
+    vector<Point> plist;
+    plist.reserve(all.size());
+    ij.clear(); ij.reserve(all.size());
+    if (c) { c->clear(); c->reserve(all.size()); }
+    for (const auto& r : all) {
+      plist.push_back(r.p.data());
+      ij.push_back(make_pair(r.i, r.j));
+      if (c) c->push_back(r.p.c);
+    }
+    return plist;
+  }
+
+  std::vector<Intersect::Point>
+  Intersect::SegmentFan(const GeodesicLine& lineX,
+                        const std::vector<GeodesicLine>& lines,
+                        std::vector<size_t>& idx,
+                        std::vector<int>* c, int nthreads) const {
+    real qx[5];
+    SegmentCap(lineX, qx);
+    size_t n = lines.size();
+    nthreads = int(min(size_t(max(nthreads, 1)), max(n, size_t(1))));
+    // Task k handles the segments [n*k/nthreads, n*(k+1)/nthreads) and so
+    // the results are found in order of the index.
+    struct result {
+      size_t i;
+      XPoint p;
+      result(size_t i1, const XPoint& p1) : i(i1), p(p1) {}
+    };
+    vector<vector<result>> res(nthreads);
+    auto worker = [&](const Intersect& inter, int k) -> void {
+      real q[5];
+      for (size_t i = n * k / nthreads; i < n * (k + 1) / nthreads; ++i) {
+        inter.SegmentCap(lines[i], q);
+        if (!CapsOverlap(qx, q)) continue;
+        int segmode;
+        XPoint p = inter.SegmentInt(lineX, lines[i], segmode);
+        if (segmode == 0) res[k].emplace_back(i, p);
+      }
+    };
+    if (nthreads == 1)
+      worker(*this, 0);
+    else {
+      // Each task gets a private copy of *this so that the tasks don't
+      // contend for the (mutable) counters.
+      vector<Intersect> inters(nthreads, *this);
+      for (auto& inter : inters)
+        inter._cnt0 = inter._cnt1 = inter._cnt2 = inter._cnt3 = inter._cnt4
+          = 0;
+      Executor::Batch(nthreads,
+                      [&](int k) -> void { worker(inters[k], k); });
+      for (const auto& inter : inters) {
+        _cnt0 += inter._cnt0; _cnt1 += inter._cnt1; _cnt2 += inter._cnt2;
+        _cnt3 += inter._cnt3; _cnt4 += inter._cnt4;
+      }
+    }
+    vector<Point> plist;
+    idx.clear();
+    if (c) c->clear();
+    for (const auto& r : res)
+      for (const auto& x : r) {
+        plist.push_back(x.p.data());
+        idx.push_back(x.i);
+        if (c) c->push_back(x.p.c);
+      }
+    return plist;
+  }
+
+  void Intersect::SegmentCap(const GeodesicLine& line, real q[]) const {
+    // Enclose the segment in a cap about its midpoint.  The direction of the
+    // normal to the ellipsoid changes at a rate no greater than the maximum
+    // curvature, kappa, as we move along a geodesic; so the normals to points
+    // on a segment of length s lie within an angle kappa*s/2 of the normal at
+    // the midpoint.
+    real b = _a * (1 - _f),
+      kappa = fmax(_a / (b * b), b / (_a * _a)),
+      margin = sqrt(numeric_limits<real>::epsilon()); // allow for roundoff
+    real s = line.Distance(), lat, lon, slat, clat, slon, clon;
+    line.Position(s/2, lat, lon);
+    Math::sincosd(lat, slat, clat); Math::sincosd(lon, slon, clon);
+    q[0] = clat * clon; q[1] = clat * slon; q[2] = slat;
+    real r = fmin(kappa * fabs(s)/2 * (1 + margin) + margin, Math::pi());
+    q[3] = cos(r); q[4] = sin(r);
+  }
+
+  void Intersect::SegmentCandidates(const std::vector<Math::real>& caps,
+                                    std::vector<std::pair<size_t, size_t>>&
+                                    cand) {
+    // Find the pairs of overlapping caps using a uniform grid over the cube
+    // [-1,1]^3 containing the unit normals.  Each cap is contained in a box
+    // centered at its center with half width rho = 2*sin(r/2), the chord for
+    // the cap radius r, and it is entered into the grid cells overlapped by
+    // its box.  Only the surface of the cube is occupied so the cells are
+    // stored in a hash table.  Each pair of caps in a cell is considered only
+    // in the cell containing the lower corner of the intersection of their
+    // boxes, so that each pair is considered once.  Caps which overlap more
+    // than maxcells_ cells are checked against all other caps.
+    static const int maxgrid_ = 1024, maxcells_ = 64;
+    size_t n = caps.size() / 5;
+    cand.clear();
+    if (n < 2) return;
+    vector<real> rho(n);
+    for (size_t i = 0; i < n; ++i)
+      rho[i] = sqrt(2 * (1 - caps[5 * i + 3]));
+    real h;
+    {
+      // The cell size is twice the median half width
+      vector<real> t(rho);
+      nth_element(t.begin(), t.begin() + n/2, t.end());
+      h = fmax(2 * t[n/2], 2 / real(maxgrid_));
+    }
+    int m = min(maxgrid_, max(1, int(ceil(2 / h))));
+    h = 2 / real(m);
+    auto cell = [m, h](real x) -> int
+    { return min(m - 1, max(0, int(floor((x + 1) / h)))); };
+    // Do caps i and j overlap?
+    auto overlap = [&caps](size_t i, size_t j) -> bool
+    { return CapsOverlap(&caps[5 * i], &caps[5 * j]); };
+    vector<int> lo(3 * n), hi(3 * n);
+    vector<bool> large(n, false);
+    vector<size_t> largelist;
+    unordered_map<long long, vector<size_t>> grid;
+    for (size_t i = 0; i < n; ++i) {
+      long long ncells = 1;
+      for (int d = 0; d < 3; ++d) {
+        lo[3 * i + d] = cell(caps[5 * i + d] - rho[i]);
+        hi[3 * i + d] = cell(caps[5 * i + d] + rho[i]);
+        ncells *= hi[3 * i + d] - lo[3 * i + d] + 1;
+      }
+      if (ncells > maxcells_) {
+        large[i] = true;
+        largelist.push_back(i);
+        continue;
+      }
+      for (int x = lo[3 * i]; x <= hi[3 * i]; ++x)
+        for (int y = lo[3 * i + 1]; y <= hi[3 * i + 1]; ++y)
+          for (int z = lo[3 * i + 2]; z <= hi[3 * i + 2]; ++z)
+            grid[(x * (long long)(m) + y) * m + z].push_back(i);
+    }
+    for (const auto& g : grid) {
+      const vector<size_t>& v = g.second;
+      if (v.size() < 2) continue;
+      int c[3] = { int(g.first / m / m), int(g.first / m % m),
+                   int(g.first % m) };
+      for (size_t a = 0; a < v.size(); ++a) {
+        size_t i = v[a];
+        for (size_t b = a + 1; b < v.size(); ++b) {
+          size_t j = v[b];
+          if (max(lo[3 * i    ], lo[3 * j    ]) == c[0] &&
+              max(lo[3 * i + 1], lo[3 * j + 1]) == c[1] &&
+              max(lo[3 * i + 2], lo[3 * j + 2]) == c[2] &&
+              overlap(i, j))
+            cand.push_back(make_pair(i, j)); // i < j since v is sorted
+        }
+      }
+    }
+    for (size_t i : largelist) {
+      for (size_t j = 0; j < n; ++j) {
+        if (j == i || (large[j] && j < i)) continue;
+        if (overlap(i, j)) cand.push_back(make_pair(min(i, j), max(i, j)));
+      }
+    }
+    sort(cand.begin(), cand.end());
+  }
+
   Intersect::XPoint
   Intersect::Spherical(const GeodesicLine& lineX, const GeodesicLine& lineY,
                        const Intersect::XPoint& p) const {
@@ -193,12 +469,14 @@ namespace GeographicLib {
                    const Intersect::XPoint& p0) const {
     ++_cnt1;
     XPoint q = p0;
-    for (int n = 0; n < numit_ || GEOGRAPHICLIB_PANIC; ++n) {
+    int n = 0;
+    for (; n < numit_ || GEOGRAPHICLIB_PANIC; ++n) {
       ++_cnt0;
       XPoint dq = Spherical(lineX, lineY, q);
       q += dq;
       if (q.c || !(dq.Dist() > _tol)) break; // break if nan
     }
+    GEOGRAPHICLIB_INSTRUMENT_RECORD(INTERSECT, n + (n < numit_), n == numit_);
     return q;
   }
 
@@ -299,17 +577,19 @@ namespace GeographicLib {
     return q;
   }
 
-  std::vector<Intersect::XPoint>
-  Intersect::AllInt0(const GeodesicLine& lineX,
-                     const GeodesicLine& lineY,
-                     Math::real maxdist, const XPoint& p0) const {
+  void Intersect::AllInt0(const GeodesicLine& lineX,
+                          const GeodesicLine& lineY,
+                          Math::real maxdist, const XPoint& p0,
+                          AllScratch& s) const {
     real maxdistx = maxdist + _delta;
     const int m = int(ceil(maxdistx / _d3)), // process m x m set of tiles
       m2 = m*m + (m - 1) % 2,                // add center tile if m is even
       n = m - 1;                             // Range of i, j = [-n:2:n]
     real d3 = maxdistx/m;                    // d3 <= _d3
-    vector<XPoint> start(m2);
-    vector<bool> skip(m2, false);
+    vector<XPoint>& start = s._start;
+    start.resize(m2);
+    vector<char>& skip = s._skip;
+    skip.assign(m2, false);
     int h = 0, c0 = 0;
     start[h++] = p0;
     for (int i = -n; i <= n; i += 2)
@@ -318,15 +598,28 @@ namespace GeographicLib {
           start[h++] = p0 + XPoint( d3 * (i + j) / 2, d3 * (i - j) / 2);
       }
     // assert(h == m2);
-    set<XPoint, SetComp> r(_comp); // Intersections found
-    set<XPoint, SetComp> c(_comp); // Closest coincident intersections
-    vector<XPoint> added;
+    // The intersections found and the closest coincident intersections are
+    // held in vectors sorted with _comp; these are used like sets but they
+    // retain their memory between calls.
+    vector<XPoint>& r = s._r;
+    vector<XPoint>& c = s._c;
+    vector<XPoint>& added = s._added;
+    r.clear(); c.clear();
+    auto find = [this](const vector<XPoint>& v, const XPoint& q) -> bool {
+      auto qp = lower_bound(v.begin(), v.end(), q, _comp);
+      return qp != v.end() && !_comp(q, *qp);
+    };
+    auto insert = [this](vector<XPoint>& v, const XPoint& q) -> void {
+      auto qp = lower_bound(v.begin(), v.end(), q, _comp);
+      if (!(qp != v.end() && !_comp(q, *qp)))
+        v.insert(qp, q);
+    };
     for (int k = 0; k < m2; ++k) {
       if (skip[k]) continue;
       XPoint q = Basic(lineX, lineY, start[k]);
-      if (r.find(q) != r.end()  // intersection already found
+      if (find(r, q)            // intersection already found
           // or it's on a line of coincident intersections already processed
-          || (c0 != 0 && c.find(fixcoincident(p0, q)) != c.end()))
+          || (c0 != 0 && find(c, fixcoincident(p0, q))))
         continue;
       added.clear();
       if (q.c != 0) {
@@ -335,16 +628,13 @@ namespace GeographicLib {
         c0 = q.c;
         // Process coincident intersections
         q = fixcoincident(p0, q);
-        c.insert(q);
+        insert(c, q);
         // Elimate all existing intersections on this line (which
         // didn't set c0).
-        for (auto qp = r.begin(); qp != r.end(); ) {
-          if (_comp.eq(fixcoincident(p0, *qp, c0), q)) {
-            qp = r.erase(qp);
-          }
-          else
-            ++qp;
-        }
+        r.erase(remove_if(r.begin(), r.end(),
+                          [this, &p0, &q, c0](const XPoint& qp) -> bool
+                          { return _comp.eq(fixcoincident(p0, qp, c0), q); }),
+                r.end());
         real s0 = q.x;
         XPoint qc;
         real t, m12, M12, M21;
@@ -360,45 +650,36 @@ namespace GeographicLib {
               - s0;
             qc = q + XPoint(sa, c0*sa);
             added.push_back(qc);
-            r.insert(qc);
+            insert(r, qc);
           } while (qc.Dist(p0) <= maxdistx);
         }
       }
       added.push_back(q);
-      r.insert(q);
+      insert(r, q);
       for (auto qp = added.cbegin(); qp != added.cend(); ++qp) {
         for (int l = k + 1; l < m2; ++l)
           skip[l] = skip[l] || qp->Dist(start[l]) < 2*_t1 - d3 - _delta;
       }
     }
     // Trim intersections to maxdist
-    for (auto qp = r.begin(); qp != r.end(); ) {
-      if (!(qp->Dist(p0) <= maxdist))
-        qp = r.erase(qp);
-      else
-        ++qp;
-    }
-    vector<XPoint> v(r.size());
-    int i = 0;
-    for (auto p = r.cbegin(); p != r.cend(); ++p)
-      v[i++] = *p;
-    sort(v.begin(), v.end(), RankPoint(p0));
-    return v;
+    r.erase(remove_if(r.begin(), r.end(),
+                      [&p0, maxdist](const XPoint& qp) -> bool
+                      { return !(qp.Dist(p0) <= maxdist); }),
+            r.end());
+    sort(r.begin(), r.end(), RankPoint(p0));
   }
 
   std::vector<Intersect::Point>
   Intersect::AllInternal(const GeodesicLine& lineX, const GeodesicLine& lineY,
                          Math::real maxdist, const Point& p0,
                          std::vector<int>& c, bool cp) const {
-    const vector<XPoint>
-      v = AllInt0(lineX, lineY, fmax(real(0), maxdist), XPoint(p0));
-    int i = int(v.size());
-    vector<Point> u(i);
-    if (cp) c.resize(i);
-    for (int j = 0; j < i; ++j) {
-      u[j] = v[j].data();
-      if (cp) c[j] = v[j].c;
-    }
+    AllScratch s;
+    vector<Point> u;
+    if (cp) {
+      c.clear();
+      All(lineX, lineY, maxdist, s, back_inserter(u), back_inserter(c), p0);
+    } else
+      All(lineX, lineY, maxdist, s, back_inserter(u), p0);
     return u;
   }
 
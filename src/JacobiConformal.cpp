@@ -0,0 +1,85 @@
+/**
+ * \file JacobiConformal.cpp
+ * \brief Implementation for GeographicLib::JacobiConformal class
+ *
+ * Copyright (c) Charles Karney (2014-2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/JacobiConformal.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  JacobiConformal::JacobiConformal(real a, real b, real c)
+    : _a(a), _b(b), _c(c)
+    , _ab2((_a - _b) * (_a + _b))
+    , _bc2((_b - _c) * (_b + _c))
+    , _ac2((_a - _c) * (_a + _c))
+    , _xscale(Math::_sq(_a / _b))
+    , _yscale(Math::_sq(_c / _b))
+    , _ex(_ab2 / _ac2 * Math::_sq(_c / _b), -_ab2 / Math::_sq(_b),
+          _bc2 / _ac2 * Math::_sq(_a / _b), Math::_sq(_a / _b))
+    , _ey(_bc2 / _ac2 * Math::_sq(_a / _b), +_bc2 / Math::_sq(_b),
+          _ab2 / _ac2 * Math::_sq(_c / _b), Math::_sq(_c / _b))
+  {
+    if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(_a > _c))
+      throw GeographicErr
+        ("JacobiConformal: use alternate constructor for sphere");
+  }
+
+  JacobiConformal::JacobiConformal(real a, real b, real c, real ab, real bc)
+    : _a(a), _b(b), _c(c)
+    , _ab2(ab * (_a + _b))
+    , _bc2(bc * (_b + _c))
+    , _ac2(_ab2 + _bc2)
+    , _xscale(Math::_sq(_a / _b))
+    , _yscale(Math::_sq(_c / _b))
+    , _ex(_ab2 / _ac2 * Math::_sq(_c / _b),
+          -(_a - _b) * (_a + _b) / Math::_sq(_b),
+          _bc2 / _ac2 * Math::_sq(_a / _b), Math::_sq(_a / _b))
+    , _ey(_bc2 / _ac2 * Math::_sq(_a / _b),
+          +(_b - _c) * (_b + _c) / Math::_sq(_b),
+          _ab2 / _ac2 * Math::_sq(_c / _b), Math::_sq(_c / _b))
+  {
+    if (!(isfinite(_a) && _a >= _b && _b >= _c && _c > 0 &&
+          ab >= 0 && bc >= 0))
+      throw GeographicErr("JacobiConformal: axes are not in order");
+    if (!(ab + bc > 0 && isfinite(_ac2)))
+      throw GeographicErr("JacobiConformal: ab + bc must be positive");
+  }
+
+  Math::real JacobiConformal::x(real somg, real comg) const {
+    real somg1 = _b * somg, comg1 = _a * comg; norm(somg1, comg1);
+    return _xscale * _ex.Pi(somg1, comg1, _ex.Delta(somg1, comg1));
+  }
+
+  Math::real JacobiConformal::y(real sbet, real cbet) const {
+    real sbet1 = _b * sbet, cbet1 = _c * cbet; norm(sbet1, cbet1);
+    return _yscale * _ey.Pi(sbet1, cbet1, _ey.Delta(sbet1, cbet1));
+  }
+
+  void JacobiConformal::Forward(size_t n, const real omg[], const real bet[],
+                                real x[], real y[], int nthreads) const {
+    // The points are handed out to the tasks in chunks.
+    const size_t chunk = 256;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t i = i0; i < min(n, i0 + chunk); ++i) {
+          if (x) x[i] = this->x(omg[i]);
+          if (y) y[i] = this->y(bet[i]);
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
+} // namespace GeographicLib
@@ -345,6 +345,12 @@ namespace GeographicLib {
   void LambertConformalConic::Forward(real lon0, real lat, real lon,
                                       real& x, real& y,
                                       real& gamma, real& k) const {
+    ForwardPoint(lon0, lat, lon, x, y, &gamma, &k);
+  }
+
+  void LambertConformalConic::ForwardPoint(real lon0, real lat, real lon,
+                                           real& x, real& y,
+                                           real* gamma, real* k) const {
     lon = Math::AngDiff(lon0, lon);
     // From Snyder, we have
     //
@@ -361,7 +367,7 @@ namespace GeographicLib {
     cphi = fmax(epsx_, cphi);
     real
       lam = lon * Math::degree(),
-      tphi = sphi/cphi, scbet = hyp(_fm * tphi),
+      tphi = sphi/cphi,
       scphi = 1/cphi, shxi = sinh(Math::eatanhe(sphi, _es)),
       tchi = hyp(shxi) * tphi - shxi * scphi, scchi = hyp(tchi),
       psi = asinh(tchi),
@@ -377,16 +383,61 @@ namespace GeographicLib {
       (_n != 0 ?
        (ctheta < 0 ? 1 - ctheta : Math::_sq(stheta)/(1 + ctheta)) / _n : 0)
       - drho * ctheta;
-    k = _k0 * (scbet/_scbet0) /
-      (exp( - (Math::_sq(_nc)/(1 + _n)) * dpsi )
-       * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) / (_scchi0 + _tchi0));
     y *= _sign;
-    gamma = _sign * theta / Math::degree();
+    if (k) *k = _k0 * (hyp(_fm * tphi)/_scbet0) /
+             (exp( - (Math::_sq(_nc)/(1 + _n)) * dpsi )
+              * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi))
+              / (_scchi0 + _tchi0));
+    if (gamma) *gamma = _sign * theta / Math::degree();
+  }
+
+  void LambertConformalConic::Forward(real lon0, size_t n,
+                                      const real lat[], const real lon[],
+                                      real x[], real y[],
+                                      real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i)
+      ForwardPoint(lon0, lat[i], lon[i], x[i], y[i],
+                   gamma ? gamma + i : nullptr, k ? k + i : nullptr);
   }
 
   void LambertConformalConic::Reverse(real lon0, real x, real y,
                                       real& lat, real& lon,
                                       real& gamma, real& k) const {
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, &gamma, &k);
+  }
+
+  void LambertConformalConic::Reverse(real lon0, real x, real y,
+                                      real& lat, real& lon) const {
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, nullptr, nullptr);
+  }
+
+  void LambertConformalConic::Reverse(real lon0, size_t n,
+                                      const real x[], const real y[],
+                                      real lat[], real lon[],
+                                      real gamma[], real k[]) const {
+    const int b = blocksize_;
+    size_t i = 0;
+    for (; i + b <= n; i += b)
+      ReverseBlock<b>(lon0, x + i, y + i, lat + i, lon + i,
+                      gamma ? gamma + i : nullptr, k ? k + i : nullptr);
+    if (i < n) {
+      // Pad the last partial block
+      int m = int(n - i);
+      real xx[b], yx[b], latx[b], lonx[b], gammax[b], kx[b];
+      fill(xx, xx + b, real(0)); fill(yx, yx + b, real(0));
+      copy(x + i, x + n, xx); copy(y + i, y + n, yx);
+      ReverseBlock<b>(lon0, xx, yx, latx, lonx, gammax, kx);
+      copy(latx, latx + m, lat + i); copy(lonx, lonx + m, lon + i);
+      if (gamma) copy(gammax, gammax + m, gamma + i);
+      if (k) copy(kx, kx + m, k + i);
+    }
+  }
+
+  template<int n>
+  void LambertConformalConic::ReverseBlock(real lon0,
+                                           const real x[], const real y[],
+                                           real lat[], real lon[],
+                                           real gamma[], real k[]) const {
     // From Snyder, we have
     //
     //        x = rho * sin(theta)
@@ -399,57 +450,67 @@ namespace GeographicLib {
     // From drho, obtain t^n-1
     // psi = -log(t), so
     // dpsi = - Dlog1p(t^n-1, t0^n-1) * drho / scale
-    y *= _sign;
-    real
+    //
+    // The first pass computes tchi for each point, the Newton iterations for
+    // tphi are done together by Math::tauf, and the last pass assembles the
+    // results.
+    real nx[n], y1[n], dpsi[n], tchi[n], tphi[n];
+    for (int i = 0; i < n; ++i) {
+      real yi = y[i] * _sign;
       // Guard against 0 * inf in computation of ny
-      nx = _n * x, ny = _n != 0 ? _n * y : 0, y1 = _nrho0 - ny,
-      den = hypot(nx, y1) + _nrho0, // 0 implies origin with polar aspect
-      // isfinite test is to avoid inf/inf
-      drho = ((den != 0 && isfinite(den))
-              ? (x*nx + y * (ny - 2*_nrho0)) / den
-              : den);
-    drho = fmin(drho, _drhomax);
-    if (_n == 0)
-      drho = fmax(drho, -_drhomax);
-    real
-      tnm1 = _t0nm1 + _n * drho/_scale,
-      dpsi = (den == 0 ? 0 :
-              (tnm1 + 1 != 0 ? - Dlog1p(tnm1, _t0nm1) * drho / _scale :
-               ahypover_));
-    real tchi;
-    if (2 * _n <= 1) {
-      // tchi = sinh(psi)
+      real ny = _n != 0 ? _n * yi : 0;
+      nx[i] = _n * x[i]; y1[i] = _nrho0 - ny;
       real
-        psi = _psi0 + dpsi, tchia = sinh(psi), scchi = hyp(tchia),
-        dtchi = Dsinh(psi, _psi0, tchia, _tchi0, scchi, _scchi0) * dpsi;
-      tchi = _tchi0 + dtchi;    // Update tchi using divided difference
-    } else {
-      // tchi = sinh(-1/n * log(tn))
-      //      = sinh((1-1/n) * log(tn) - log(tn))
-      //      = + sinh((1-1/n) * log(tn)) * cosh(log(tn))
-      //        - cosh((1-1/n) * log(tn)) * sinh(log(tn))
-      // (1-1/n) = - nc^2/(n*(1+n))
-      // cosh(log(tn)) = (tn + 1/tn)/2; sinh(log(tn)) = (tn - 1/tn)/2
-      real
-        tn = tnm1 + 1 == 0 ? epsx_ : tnm1 + 1,
-        sh = sinh( -Math::_sq(_nc)/(_n * (1 + _n)) *
-                   (2 * tn > 1 ? log1p(tnm1) : log(tn)) );
-      tchi = sh * (tn + 1/tn)/2 - hyp(sh) * (tnm1 * (tn + 1)/tn)/2;
+        den = hypot(nx[i], y1[i]) + _nrho0, // 0 implies origin, polar aspect
+        // isfinite test is to avoid inf/inf
+        drho = ((den != 0 && isfinite(den))
+                ? (x[i]*nx[i] + yi * (ny - 2*_nrho0)) / den
+                : den);
+      drho = fmin(drho, _drhomax);
+      if (_n == 0)
+        drho = fmax(drho, -_drhomax);
+      real tnm1 = _t0nm1 + _n * drho/_scale;
+      dpsi[i] = (den == 0 ? 0 :
+                 (tnm1 + 1 != 0 ? - Dlog1p(tnm1, _t0nm1) * drho / _scale :
+                  ahypover_));
+      if (2 * _n <= 1) {
+        // tchi = sinh(psi)
+        real
+          psi = _psi0 + dpsi[i], tchia = sinh(psi), scchi = hyp(tchia),
+          dtchi = Dsinh(psi, _psi0, tchia, _tchi0, scchi, _scchi0) * dpsi[i];
+        tchi[i] = _tchi0 + dtchi; // Update tchi using divided difference
+      } else {
+        // tchi = sinh(-1/n * log(tn))
+        //      = sinh((1-1/n) * log(tn) - log(tn))
+        //      = + sinh((1-1/n) * log(tn)) * cosh(log(tn))
+        //        - cosh((1-1/n) * log(tn)) * sinh(log(tn))
+        // (1-1/n) = - nc^2/(n*(1+n))
+        // cosh(log(tn)) = (tn + 1/tn)/2; sinh(log(tn)) = (tn - 1/tn)/2
+        real
+          tn = tnm1 + 1 == 0 ? epsx_ : tnm1 + 1,
+          sh = sinh( -Math::_sq(_nc)/(_n * (1 + _n)) *
+                     (2 * tn > 1 ? log1p(tnm1) : log(tn)) );
+        tchi[i] = sh * (tn + 1/tn)/2 - hyp(sh) * (tnm1 * (tn + 1)/tn)/2;
+      }
     }
 
-    // log(t) = -asinh(tan(chi)) = -psi
-    gamma = atan2(nx, y1);
-    real
-      tphi = Math::tauf(tchi, _es),
-      scbet = hyp(_fm * tphi), scchi = hyp(tchi),
-      lam = _n != 0 ? gamma / _n : x / y1;
-    lat = Math::atand(_sign * tphi);
-    lon = lam / Math::degree();
-    lon = Math::AngNormalize(lon + Math::AngNormalize(lon0));
-    k = _k0 * (scbet/_scbet0) /
-      (exp(_nc != 0 ? - (Math::_sq(_nc)/(1 + _n)) * dpsi : 0)
-       * (tchi >= 0 ? scchi + tchi : 1 / (scchi - tchi)) / (_scchi0 + _tchi0));
-    gamma /= _sign * Math::degree();
+    Math::tauf(size_t(n), tchi, _es, tphi);
+
+    for (int i = 0; i < n; ++i) {
+      // log(t) = -asinh(tan(chi)) = -psi
+      real
+        gam = atan2(nx[i], y1[i]),
+        scbet = hyp(_fm * tphi[i]), scchi = hyp(tchi[i]),
+        lam = _n != 0 ? gam / _n : x[i] / y1[i];
+      lat[i] = Math::atand(_sign * tphi[i]);
+      lon[i] = lam / Math::degree();
+      lon[i] = Math::AngNormalize(lon[i] + Math::AngNormalize(lon0));
+      if (k) k[i] = _k0 * (scbet/_scbet0) /
+               (exp(_nc != 0 ? - (Math::_sq(_nc)/(1 + _n)) * dpsi[i] : 0)
+                * (tchi[i] >= 0 ? scchi + tchi[i] : 1 / (scchi - tchi[i]))
+                / (_scchi0 + _tchi0));
+      if (gamma) gamma[i] = gam / (_sign * Math::degree());
+    }
   }
 
   void LambertConformalConic::SetScale(real lat, real k) {
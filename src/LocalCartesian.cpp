@@ -17,11 +17,15 @@ namespace GeographicLib {
     _lat0 = Math::LatFix(lat0);
     _lon0 = Math::AngNormalize(lon0);
     _h0 = h0;
-    _earth.Forward(_lat0, _lon0, _h0, _x0, _y0, _z0);
-    real sphi, cphi, slam, clam;
-    Math::sincosd(_lat0, sphi, cphi);
-    Math::sincosd(_lon0, slam, clam);
-    Geocentric::Rotation(sphi, cphi, slam, clam, _r);
+    Origin(_lat0, _lon0, _h0, _x0, _y0, _z0, _r);
+  }
+
+  void LocalCartesian::Origin(real lat0, real lon0, real h0,
+                              real& x0, real& y0, real& z0, real r[dim2_])
+    const {
+    // The rotation matrix for the origin is the one which Geocentric returns
+    // for the origin; so the trigonometric functions are evaluated once.
+    _earth.IntForward(lat0, lon0, h0, x0, y0, z0, r);
   }
 
   void LocalCartesian::MatrixMultiply(real M[dim2_]) const {
@@ -59,4 +63,120 @@ namespace GeographicLib {
       MatrixMultiply(M);
   }
 
+  void LocalCartesian::Forward(size_t n, const real lat[], const real lon[],
+                               const real h[], real x[], real y[], real z[],
+                               real M[]) const {
+    // Copy the origin and the rotation matrix to local variables; since the
+    // output arrays might alias the members, the compiler would otherwise
+    // need to reload them for each point.
+    real r[dim2_], x0 = _x0, y0 = _y0, z0 = _z0;
+    copy(_r, _r + dim2_, r);
+    for (size_t i = 0; i < n; ++i) {
+      real xc, yc, zc, *Mi = M ? M + dim2_ * i : NULL;
+      _earth.IntForward(lat[i], lon[i], h[i], xc, yc, zc, Mi);
+      xc -= x0; yc -= y0; zc -= z0;
+      x[i] = r[0] * xc + r[3] * yc + r[6] * zc;
+      y[i] = r[1] * xc + r[4] * yc + r[7] * zc;
+      z[i] = r[2] * xc + r[5] * yc + r[8] * zc;
+      if (Mi)
+        MatrixMultiply(Mi);
+    }
+  }
+
+  void LocalCartesian::Reverse(size_t n, const real x[], const real y[],
+                               const real z[],
+                               real lat[], real lon[], real h[],
+                               real M[]) const {
+    real r[dim2_], x0 = _x0, y0 = _y0, z0 = _z0;
+    copy(_r, _r + dim2_, r);
+    for (size_t i = 0; i < n; ++i) {
+      real
+        xc = x0 + r[0] * x[i] + r[1] * y[i] + r[2] * z[i],
+        yc = y0 + r[3] * x[i] + r[4] * y[i] + r[5] * z[i],
+        zc = z0 + r[6] * x[i] + r[7] * y[i] + r[8] * z[i],
+        *Mi = M ? M + dim2_ * i : NULL;
+      _earth.IntReverse(xc, yc, zc, lat[i], lon[i], h[i], Mi);
+      if (Mi)
+        MatrixMultiply(Mi);
+    }
+  }
+
+  void LocalCartesian::Forward(size_t n, StridedArray<const real> lat,
+                               StridedArray<const real> lon,
+                               StridedArray<const real> h,
+                               StridedArray<real> x, StridedArray<real> y,
+                               StridedArray<real> z) const {
+    real r[dim2_], x0 = _x0, y0 = _y0, z0 = _z0;
+    copy(_r, _r + dim2_, r);
+    for (size_t i = 0; i < n; ++i) {
+      real xc, yc, zc;
+      _earth.IntForward(lat[i], lon[i], h[i], xc, yc, zc, NULL);
+      xc -= x0; yc -= y0; zc -= z0;
+      x[i] = r[0] * xc + r[3] * yc + r[6] * zc;
+      y[i] = r[1] * xc + r[4] * yc + r[7] * zc;
+      z[i] = r[2] * xc + r[5] * yc + r[8] * zc;
+    }
+  }
+
+  void LocalCartesian::Reverse(size_t n, StridedArray<const real> x,
+                               StridedArray<const real> y,
+                               StridedArray<const real> z,
+                               StridedArray<real> lat, StridedArray<real> lon,
+                               StridedArray<real> h) const {
+    real r[dim2_], x0 = _x0, y0 = _y0, z0 = _z0;
+    copy(_r, _r + dim2_, r);
+    for (size_t i = 0; i < n; ++i) {
+      real
+        xc = x0 + r[0] * x[i] + r[1] * y[i] + r[2] * z[i],
+        yc = y0 + r[3] * x[i] + r[4] * y[i] + r[5] * z[i],
+        zc = z0 + r[6] * x[i] + r[7] * y[i] + r[8] * z[i];
+      _earth.IntReverse(xc, yc, zc, lat[i], lon[i], h[i], NULL);
+    }
+  }
+
+  void LocalCartesian::Forward(size_t n, const real lat0[],
+                               const real lon0[], const real h0[],
+                               const real lat[], const real lon[],
+                               const real h[],
+                               real x[], real y[], real z[]) const {
+    // The origin (copied, because the outputs may overlay the inputs) whose
+    // position and rotation matrix are held in x0, y0, z0, r; NaNs ensure
+    // that the first point sets up its origin.
+    real r[dim2_], x0 = 0, y0 = 0, z0 = 0,
+      olat = Math::NaN(), olon = olat, oh = olat;
+    for (size_t i = 0; i < n; ++i) {
+      if (!(lat0[i] == olat && lon0[i] == olon && h0[i] == oh)) {
+        olat = lat0[i]; olon = lon0[i]; oh = h0[i];
+        Origin(Math::LatFix(olat), Math::AngNormalize(olon), oh,
+               x0, y0, z0, r);
+      }
+      real xc, yc, zc;
+      _earth.IntForward(lat[i], lon[i], h[i], xc, yc, zc, NULL);
+      xc -= x0; yc -= y0; zc -= z0;
+      x[i] = r[0] * xc + r[3] * yc + r[6] * zc;
+      y[i] = r[1] * xc + r[4] * yc + r[7] * zc;
+      z[i] = r[2] * xc + r[5] * yc + r[8] * zc;
+    }
+  }
+
+  void LocalCartesian::Reverse(size_t n, const real lat0[],
+                               const real lon0[], const real h0[],
+                               const real x[], const real y[], const real z[],
+                               real lat[], real lon[], real h[]) const {
+    real r[dim2_], x0 = 0, y0 = 0, z0 = 0,
+      olat = Math::NaN(), olon = olat, oh = olat;
+    for (size_t i = 0; i < n; ++i) {
+      if (!(lat0[i] == olat && lon0[i] == olon && h0[i] == oh)) {
+        olat = lat0[i]; olon = lon0[i]; oh = h0[i];
+        Origin(Math::LatFix(olat), Math::AngNormalize(olon), oh,
+               x0, y0, z0, r);
+      }
+      real
+        xc = x0 + r[0] * x[i] + r[1] * y[i] + r[2] * z[i],
+        yc = y0 + r[3] * x[i] + r[4] * y[i] + r[5] * z[i],
+        zc = z0 + r[6] * x[i] + r[7] * y[i] + r[8] * z[i];
+      _earth.IntReverse(xc, yc, zc, lat[i], lon[i], h[i], NULL);
+    }
+  }
+
 } // namespace GeographicLib
@@ -9,6 +9,8 @@
 
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
+#include <memory>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions and mixing enums
@@ -43,16 +45,17 @@ namespace GeographicLib {
     { maxupsSind_, maxupsNind_,
       maxutmNrow_ + (maxutmSrow_ - minutmNrow_), maxutmNrow_ };
 
-  void MGRS::Forward(int zone, bool northp, real x, real y, real lat,
-                     int prec, std::string& mgrs) {
+  int MGRS::Forward(int zone, bool northp, real x, real y, real lat,
+                    int prec, char mgrs[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     // The smallest angle s.t., 90 - angeps() < 90 (approx 50e-12 arcsec)
     // 7 = ceil(log_2(90))
     static const real angeps = ldexp(real(1), -(Math::digits() - 7));
     if (zone == UTMUPS::INVALID ||
         isnan(x) || isnan(y) || isnan(lat)) {
-      mgrs = "INVALID";
-      return;
+      static const char invalid[] = "INVALID";
+      copy(invalid, invalid + sizeof(invalid), mgrs);
+      return int(sizeof(invalid)) - 1;
     }
     bool utmp = zone != 0;
     CheckCoords(utmp, northp, x, y);
@@ -64,7 +67,9 @@ namespace GeographicLib {
                           + Utility::str(int(maxprec_)) + "]");
     // Fixed char array for accumulating string.  Allow space for zone, 3 block
     // letters, easting + northing.  Don't need to allow for terminating null.
-    char mgrs1[2 + 3 + 2 * maxprec_];
+    // The result is only copied to mgrs at the end so that it is unchanged
+    // if an exception is thrown.
+    char mgrs1[MAXLENGTH];
     int
       zone1 = zone - 1,
       z = utmp ? 2 : 0,
@@ -115,19 +120,29 @@ namespace GeographicLib {
     }
     if (prec > 0) {
       ix -= m * xh; iy -= m * yh;
-      long long d = (long long)(pow(real(base_), maxprec_ - prec));
+      long long d = 1;
+      for (int c = maxprec_ - prec; c--;) d *= base_;
       ix /= d; iy /= d;
       for (int c = prec; c--;) {
         mgrs1[z + c       ] = digits_[ix % base_]; ix /= base_;
         mgrs1[z + c + prec] = digits_[iy % base_]; iy /= base_;
       }
     }
-    mgrs.resize(mlen);
-    copy(mgrs1, mgrs1 + mlen, mgrs.begin());
+    copy(mgrs1, mgrs1 + mlen, mgrs);
+    mgrs[mlen] = '\0';
+    return mlen;
   }
 
-  void MGRS::Forward(int zone, bool northp, real x, real y,
+  void MGRS::Forward(int zone, bool northp, real x, real y, real lat,
                      int prec, std::string& mgrs) {
+    char mgrs1[MAXLENGTH + 1];
+    int mlen = Forward(zone, northp, x, y, lat, prec, mgrs1);
+    mgrs.assign(mgrs1, mlen);
+  }
+
+  Math::real MGRS::BandLatitude(int zone, bool northp, real x, real y) {
+    // Return a latitude which lies in the correct latitude band or 0 for UPS
+    // or INVALID.
     real lat, lon;
     if (zone > 0) {
       // Does a rough estimate for latitude determine the latitude band?
@@ -158,15 +173,83 @@ namespace GeographicLib {
     } else
       // Latitude isn't needed for UPS specs or for INVALID
       lat = 0;
-    Forward(zone, northp, x, y, lat, prec, mgrs);
+    return lat;
+  }
+
+  void MGRS::Forward(int zone, bool northp, real x, real y,
+                     int prec, std::string& mgrs) {
+    Forward(zone, northp, x, y, BandLatitude(zone, northp, x, y), prec, mgrs);
+  }
+
+  int MGRS::Forward(int zone, bool northp, real x, real y,
+                    int prec, char mgrs[]) {
+    return Forward(zone, northp, x, y, BandLatitude(zone, northp, x, y),
+                   prec, mgrs);
+  }
+
+  void MGRS::Forward(size_t n, const int zone[], const bool northp[],
+                     const real x[], const real y[],
+                     int prec, char mgrs[], size_t stride) {
+    // The longest string is either INVALID or the full UTM designation.  If
+    // prec is out of range, the error will be signaled by the scalar
+    // version.
+    if (prec >= -1 && prec <= maxprec_ &&
+        !(stride > size_t(max(7, 5 + 2 * prec))))
+      throw GeographicErr("MGRS stride " + Utility::str(stride)
+                          + " too small for precision "
+                          + Utility::str(prec));
+    for (size_t i = 0; i < n; ++i)
+      Forward(zone[i], northp[i], x[i], y[i], prec, mgrs + i * stride);
   }
 
   void MGRS::Reverse(const string& mgrs,
                      int& zone, bool& northp, real& x, real& y,
                      int& prec, bool centerp) {
-    int
-      p = 0,
-      len = int(mgrs.length());
+    Reverse(mgrs.data(), int(mgrs.length()),
+            zone, northp, x, y, prec, centerp);
+  }
+
+  void MGRS::Reverse(const char mgrs[],
+                     int& zone, bool& northp, real& x, real& y,
+                     int& prec, bool centerp) {
+    Reverse(mgrs, int(strlen(mgrs)), zone, northp, x, y, prec, centerp);
+  }
+
+  void MGRS::Reverse(size_t n, const char mgrs[], size_t stride,
+                     int zone[], bool northp[], real x[], real y[],
+                     int prec[], bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = mgrs + i * stride;
+      const char* e = find(s, s + stride, '\0');
+      Reverse(s, int(e - s), zone[i], northp[i], x[i], y[i], prec[i],
+              centerp);
+    }
+  }
+
+  void MGRS::Reverse(size_t n, const char mgrs[], size_t stride,
+                     real lat[], real lon[], int prec[], bool centerp) {
+    // Decode the strings in blocks so that the temporary arrays are bounded
+    // while giving UTMUPS::Reverse enough points in each zone.
+    const size_t chunk = min(size_t(16384), n);
+    vector<int> zone(chunk), prec1(chunk);
+    vector<real> x(chunk), y(chunk);
+    unique_ptr<bool[]> northp(new bool[chunk]);
+    for (size_t b = 0; b < n; b += chunk) {
+      size_t m = min(chunk, n - b);
+      Reverse(m, mgrs + b * stride, stride, zone.data(), northp.get(),
+              x.data(), y.data(), prec1.data(), centerp);
+      UTMUPS::Reverse(m, zone.data(), northp.get(), x.data(), y.data(),
+                      lat + b, lon + b);
+      if (prec) copy(prec1.begin(), prec1.begin() + m, prec + b);
+    }
+  }
+
+  void MGRS::Reverse(const char* mgrs, int len,
+                     int& zone, bool& northp, real& x, real& y,
+                     int& prec, bool centerp) {
+    // The strings used in the error messages are only constructed if an
+    // error is detected.
+    int p = 0;
     if (len >= 3 &&
         toupper(mgrs[0]) == 'I' &&
         toupper(mgrs[1]) == 'N' &&
@@ -179,7 +262,7 @@ namespace GeographicLib {
     }
     int zone1 = 0;
     while (p < len) {
-      int i = Utility::lookup(digits_, mgrs[p]);
+      int i = Digit(mgrs[p]);
       if (i < 0)
         break;
       zone1 = 10 * zone1 + i;
@@ -189,9 +272,9 @@ namespace GeographicLib {
       throw GeographicErr("Zone " + Utility::str(zone1) + " not in [1,60]");
     if (p > 2)
       throw GeographicErr("More than 2 digits at start of MGRS "
-                          + mgrs.substr(0, p));
+                          + string(mgrs, p));
     if (len - p < 1)
-      throw GeographicErr("MGRS string too short " + mgrs);
+      throw GeographicErr("MGRS string too short " + string(mgrs, len));
     bool utmp = zone1 != UTMUPS::UPS;
     int zonem1 = zone1 - 1;
     const char* band = utmp ? latband_ : upsband_;
@@ -221,14 +304,14 @@ namespace GeographicLib {
       prec = -1;
       return;
     } else if (len - p < 2)
-      throw GeographicErr("Missing row letter in " + mgrs);
+      throw GeographicErr("Missing row letter in " + string(mgrs, len));
     const char* col = utmp ? utmcols_[zonem1 % 3] : upscols_[iband];
     const char* row = utmp ? utmrow_ : upsrows_[northp1];
     int icol = Utility::lookup(col, mgrs[p++]);
     if (icol < 0)
       throw GeographicErr("Column letter " + Utility::str(mgrs[p-1])
                           + " not in "
-                          + (utmp ? "zone " + mgrs.substr(0, p-2) :
+                          + (utmp ? "zone " + string(mgrs, p-2) :
                              "UPS band " + Utility::str(mgrs[p-2]))
                           + " set " + col );
     int irow = Utility::lookup(row, mgrs[p++]);
@@ -243,8 +326,8 @@ namespace GeographicLib {
       iband -= 10;
       irow = UTMRow(iband, icol, irow);
       if (irow == maxutmSrow_)
-        throw GeographicErr("Block " + mgrs.substr(p-2, 2)
-                            + " not in zone/band " + mgrs.substr(0, p-2));
+        throw GeographicErr("Block " + string(mgrs + p-2, 2)
+                            + " not in zone/band " + string(mgrs, p-2));
 
       irow = northp1 ? irow : irow + 100;
       icol = icol + minutmcol_;
@@ -261,23 +344,25 @@ namespace GeographicLib {
     for (int i = 0; i < prec1; ++i) {
       unit *= base_;
       int
-        ix = Utility::lookup(digits_, mgrs[p + i]),
-        iy = Utility::lookup(digits_, mgrs[p + i + prec1]);
+        ix = Digit(mgrs[p + i]),
+        iy = Digit(mgrs[p + i + prec1]);
       if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(mgrs + p, len - p));
       x1 = base_ * x1 + ix;
       y1 = base_ * y1 + iy;
     }
     if ((len - p) % 2) {
-      if (Utility::lookup(digits_, mgrs[len - 1]) < 0)
-        throw GeographicErr("Encountered a non-digit in " + mgrs.substr(p));
+      if (Digit(mgrs[len - 1]) < 0)
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(mgrs + p, len - p));
       else
         throw GeographicErr("Not an even number of digits in "
-                            + mgrs.substr(p));
+                            + string(mgrs + p, len - p));
     }
     if (prec1 > maxprec_)
       throw GeographicErr("More than " + Utility::str(2*maxprec_)
-                          + " digits in " + mgrs.substr(p));
+                          + " digits in " + string(mgrs + p, len - p));
     if (centerp) {
       unit *= 2; x1 = 2 * x1 + 1; y1 = 2 * y1 + 1;
     }
@@ -11,27 +11,51 @@
 #include <fstream>
 #include <sstream>
 #include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Utility.hpp>
 
 namespace GeographicLib {
 
   using namespace std;
 
-  void MagneticCircle::FieldGeocentric(real slam, real clam,
+  void MagneticCircle::Interval(real t, int& n, real& t1) const {
+    if (isnan(t)) {
+      // Give NaN results
+      n = _n0;
+      t1 = t;
+      return;
+    }
+    t1 = t - _t0;
+    n = max(min(int(floor(t1 / _dt0)), _nmodels - 1), 0);
+    if (n < _n0 || n > _n1)
+      throw GeographicErr("Time " + Utility::str(t) +
+                          " is outside the range of the MagneticCircle");
+    t1 -= n * _dt0;
+  }
+
+  void MagneticCircle::FieldGeocentric(int n, real t1, real slam, real clam,
                                        real& BX, real& BY, real& BZ,
                                        real& BXt, real& BYt, real& BZt) const {
     real BXc = 0, BYc = 0, BZc = 0;
-    _circ0(slam, clam, BX, BY, BZ);
-    _circ1(slam, clam, BXt, BYt, BZt);
+    _circ[n - _n0](slam, clam, BX, BY, BZ);
+    _circ[n - _n0 + 1](slam, clam, BXt, BYt, BZt);
     if (_constterm)
-      _circ2(slam, clam, BXc, BYc, BZc);
-    if (_interpolate) {
+      _circ.back()(slam, clam, BXc, BYc, BZc);
+    Combine(n, t1, BX, BY, BZ, BXt, BYt, BZt, BXc, BYc, BZc);
+  }
+
+  void MagneticCircle::Combine(int n, real t1,
+                               real& BX, real& BY, real& BZ,
+                               real& BXt, real& BYt, real& BZt,
+                               real BXc, real BYc, real BZc) const {
+    if (n + 1 < _nmodels) {
+      // Interpolate between the epochs n and n + 1
       BXt = (BXt - BX) / _dt0;
       BYt = (BYt - BY) / _dt0;
       BZt = (BZt - BZ) / _dt0;
     }
-    BX += _t1 * BXt + BXc;
-    BY += _t1 * BYt + BYc;
-    BZ += _t1 * BZt + BZc;
+    BX += t1 * BXt + BXc;
+    BY += t1 * BYt + BYc;
+    BZ += t1 * BZt + BZc;
 
     BXt *= - _a;
     BYt *= - _a;
@@ -45,23 +69,64 @@ namespace GeographicLib {
   void MagneticCircle::FieldGeocentric(real lon,
                                        real& BX, real& BY, real& BZ,
                                        real& BXt, real& BYt, real& BZt) const {
+    FieldGeocentric(_t, lon, BX, BY, BZ, BXt, BYt, BZt);
+  }
+
+  void MagneticCircle::FieldGeocentric(real t, real lon,
+                                       real& BX, real& BY, real& BZ,
+                                       real& BXt, real& BYt, real& BZt) const {
+    int n; real t1;
+    Interval(t, n, t1);
     real slam, clam;
     Math::sincosd(lon, slam, clam);
-    FieldGeocentric(slam, clam, BX, BY, BZ, BXt, BYt, BZt);
+    FieldGeocentric(n, t1, slam, clam, BX, BY, BZ, BXt, BYt, BZt);
   }
 
-  void MagneticCircle::Field(real lon, bool diffp,
+  void MagneticCircle::Field(real t, real lon, bool diffp,
                              real& Bx, real& By, real& Bz,
                              real& Bxt, real& Byt, real& Bzt) const {
+    int n; real t1;
+    Interval(t, n, t1);
     real slam, clam;
     Math::sincosd(lon, slam, clam);
     real M[Geocentric::dim2_];
     Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
     real BX, BY, BZ, BXt, BYt, BZt; // Components in geocentric basis
-    FieldGeocentric(slam, clam, BX, BY, BZ, BXt, BYt, BZt);
+    FieldGeocentric(n, t1, slam, clam, BX, BY, BZ, BXt, BYt, BZt);
     if (diffp)
       Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt, Byt, Bzt);
     Geocentric::Unrotate(M, BX, BY, BZ, Bx, By, Bz);
   }
 
+  void MagneticCircle::Grid(real lon0, real dlon, size_t n,
+                            real Bx[], real By[], real Bz[],
+                            real Bxt[], real Byt[], real Bzt[]) const {
+    const bool diffp = Bxt && Byt && Bzt;
+    int nt; real t1;
+    Interval(_t, nt, t1);
+    // The gradients of the sums for the epochs nt and nt + 1 and (if needed)
+    // for the constant terms are stored in successive blocks of n elements.
+    int k = _constterm ? 3 : 2;
+    vector<real> v(n), gx(k * n), gy(k * n), gz(k * n);
+    for (int j = 0; j < k; ++j) {
+      const CircularEngine& c = j < 2 ? _circ[nt - _n0 + j] : _circ.back();
+      c.Grid(lon0, dlon, n, v.data(),
+             gx.data() + j * n, gy.data() + j * n, gz.data() + j * n);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      real slam, clam, M[Geocentric::dim2_],
+        BX = gx[i], BY = gy[i], BZ = gz[i],
+        BXt = gx[n + i], BYt = gy[n + i], BZt = gz[n + i],
+        BXc = _constterm ? gx[2 * n + i] : 0,
+        BYc = _constterm ? gy[2 * n + i] : 0,
+        BZc = _constterm ? gz[2 * n + i] : 0;
+      Combine(nt, t1, BX, BY, BZ, BXt, BYt, BZt, BXc, BYc, BZc);
+      Math::sincosd(lon0 + real(i) * dlon, slam, clam);
+      Geocentric::Rotation(_sphi, _cphi, slam, clam, M);
+      if (diffp)
+        Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt[i], Byt[i], Bzt[i]);
+      Geocentric::Unrotate(M, BX, BY, BZ, Bx[i], By[i], Bz[i]);
+    }
+  }
+
 } // namespace GeographicLib
@@ -10,9 +10,30 @@
 #include <GeographicLib/MagneticModel.hpp>
 #include <fstream>
 #include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/Instrument.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
 #include <GeographicLib/Utility.hpp>
 
+// For memory mapping the coefficient file
+#if defined(_WIN32)
+#  if !defined(NOMINMAX)
+#    define NOMINMAX 1
+#  endif
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#    define WIN32_LEAN_AND_MEAN 1
+#  endif
+#  include <windows.h>
+#  define GEOGRAPHICLIB_MAGNETIC_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define GEOGRAPHICLIB_MAGNETIC_MMAP 1
+#else
+#  define GEOGRAPHICLIB_MAGNETIC_MMAP 0
+#endif
+
 #if !defined(GEOGRAPHICLIB_DATA)
 #  if defined(_WIN32)
 #    define GEOGRAPHICLIB_DATA "C:/ProgramData/GeographicLib"
@@ -35,7 +56,8 @@ namespace GeographicLib {
   using namespace std;
 
   MagneticModel::MagneticModel(const std::string& name, const std::string& path,
-                               const Geocentric& earth, int Nmax, int Mmax)
+                               const Geocentric& earth, int Nmax, int Mmax,
+                               bool compact, bool mapped)
     : _name(name)
     , _dir(path)
     , _description("NONE")
@@ -53,7 +75,15 @@ namespace GeographicLib {
     , _mmx(-1)
     , _norm(SphericalHarmonic::SCHMIDT)
     , _earth(earth)
+    , _compacterr(0)
+    , _map(nullptr)
+    , _mapsize(0)
+    , _circlebytes(0)
+    , _circlebudget(0)
+    , _circlehits(0)
+    , _circlemisses(0)
   {
+    GEOGRAPHICLIB_TRACE_SCOPE(MAGNETICMODEL_LOAD);
     if (_dir.empty())
       _dir = DefaultMagneticPath();
     bool truncate = Nmax >= 0 || Mmax >= 0;
@@ -65,7 +95,12 @@ namespace GeographicLib {
     ReadMetadata(_name);
     _gG.resize(_nNmodels + 1 + _nNconstants);
     _hH.resize(_nNmodels + 1 + _nNconstants);
-    {
+    if (compact) {
+      _gGf.resize(_nNmodels + 1 + _nNconstants);
+      _hHf.resize(_nNmodels + 1 + _nNconstants);
+    }
+    mapped = mapped && !compact;
+    try {
       string coeff = _filename + ".cof";
       ifstream coeffstr(coeff.c_str(), ios::binary);
       if (!coeffstr.good())
@@ -77,22 +112,134 @@ namespace GeographicLib {
       id[idlength_] = '\0';
       if (_id != string(id))
         throw GeographicErr("ID mismatch: " + _id + " vs " + id);
+      size_t mappos = 0;
+      if (mapped) {
+        mappos = size_t(coeffstr.tellg());
+        coeffstr.seekg(0, ios::end);
+        MapFile(coeff, size_t(coeffstr.tellg()));
+      }
       for (int i = 0; i < _nNmodels + 1 + _nNconstants; ++i) {
         int N, M;
         if (truncate) { N = Nmax; M = Mmax; }
-        SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _gG[i], _hH[i],
-                                           truncate);
-        if (!(M < 0 || _gG[i][0] == 0))
+        SphericalEngine::coeff c;
+        if (mapped)
+          c = SphericalEngine::coeff::mapcoeffs(_map, _mapsize, mappos,
+                                                N, M, truncate);
+        else {
+          SphericalEngine::coeff::readcoeffs(coeffstr, N, M, _gG[i], _hH[i],
+                                             truncate);
+          SphericalEngine::coeff::Trim(N, M, _gG[i], _hH[i]);
+          c = SphericalEngine::coeff(_gG[i], _hH[i], N, N, M);
+        }
+        if (!(M < 0 || c.Cv(0) == 0))
           throw GeographicErr("A degree 0 term is not permitted");
-        _harm.push_back(SphericalHarmonic(_gG[i], _hH[i], N, N, M, _a, _norm));
+        if (compact) {
+          // Round the coefficients to floats and release the originals.  The
+          // mean square field over the sphere is sum((n+1) * (g^2 + h^2)).
+          vector<float>& g = _gGf[i], & h = _hHf[i];
+          g.resize(_gG[i].size()); h.resize(_hH[i].size());
+          real e2 = 0;
+          for (int m = 0, k = 0; m <= N; ++m)
+            for (int n = m; n <= N; ++n, ++k) {
+              if (k < int(g.size())) {
+                g[k] = float(_gG[i][k]);
+                e2 += (n + 1) * Math::_sq(_gG[i][k] - real(g[k]));
+              }
+              int l = k - (N + 1);
+              if (m > 0 && l < int(h.size())) {
+                h[l] = float(_hH[i][l]);
+                e2 += (n + 1) * Math::_sq(_hH[i][l] - real(h[l]));
+              }
+            }
+          _compacterr = max(_compacterr, sqrt(e2));
+          vector<real>().swap(_gG[i]); vector<real>().swap(_hH[i]);
+          c = SphericalEngine::coeff(g.data(), g.size(), h.data(), h.size(),
+                                     N, c.nmx(), c.mmx());
+        }
+        _harm.push_back(SphericalHarmonic(c, _a, _norm));
         _nmx = max(_nmx, _harm.back().Coefficients().nmx());
         _mmx = max(_mmx, _harm.back().Coefficients().mmx());
       }
+      if (mapped)
+        coeffstr.seekg(streamoff(mappos), ios::beg);
       int pos = int(coeffstr.tellg());
       coeffstr.seekg(0, ios::end);
       if (pos != coeffstr.tellg())
         throw GeographicErr("Extra data in " + coeff);
     }
+    catch (...) {
+      // The destructor isn't called if the constructor throws
+      UnmapFile();
+      throw;
+    }
+    MemoryFootprint::Register(this, [](const void* m) {
+      return static_cast<const MagneticModel*>(m)->MemoryUsage();
+    });
+  }
+
+  MagneticModel::~MagneticModel() {
+    MemoryFootprint::Unregister(this);
+    UnmapFile();
+  }
+
+  MemoryFootprint MagneticModel::MemoryUsage() const {
+    size_t heap = 0;
+    for (size_t i = 0; i < _gG.size(); ++i)
+      heap += MemoryFootprint::Bytes(_gG[i]) + MemoryFootprint::Bytes(_hH[i]);
+    for (size_t i = 0; i < _gGf.size(); ++i)
+      heap += MemoryFootprint::Bytes(_gGf[i]) +
+        MemoryFootprint::Bytes(_hHf[i]);
+    lock_guard<mutex> g(_circlelock);
+    return MemoryFootprint(heap, _map ? _mapsize : 0, _circlebytes);
+  }
+
+  void MagneticModel::MapFile(const string& filename, size_t size) {
+#if GEOGRAPHICLIB_MAGNETIC_MMAP
+#  if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+                              FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      throw GeographicErr("File not readable " + filename);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* addr = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) :
+      NULL;
+    // The view keeps the mapping alive after the handles are closed
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (!addr)
+      throw GeographicErr("Cannot map file " + filename);
+#  else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw GeographicErr("File not readable " + filename);
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping remains valid after the file descriptor is closed
+    close(fd);
+    if (addr == MAP_FAILED)
+      throw GeographicErr("Cannot map file " + filename);
+#  endif
+    _map = static_cast<const char*>(addr);
+    _mapsize = size;
+#else
+    (void)size;
+    throw GeographicErr("Memory mapping is not supported on this system: "
+                        + filename);
+#endif
+  }
+
+  void MagneticModel::UnmapFile() {
+#if GEOGRAPHICLIB_MAGNETIC_MMAP
+    if (_map) {
+#  if defined(_WIN32)
+      UnmapViewOfFile(_map);
+#  else
+      munmap(const_cast<char*>(_map), _mapsize);
+#  endif
+    }
+#endif
+    _map = nullptr;
+    _mapsize = 0;
   }
 
   void MagneticModel::ReadMetadata(const string& name) {
@@ -185,17 +332,87 @@ namespace GeographicLib {
   void MagneticModel::FieldGeocentric(real t, real X, real Y, real Z,
                                       real& BX, real& BY, real& BZ,
                                       real& BXt, real& BYt, real& BZt) const {
-    t -= _t0;
-    int n = max(min(int(floor(t / _dt0)), _nNmodels - 1), 0);
-    bool interpolate = n + 1 < _nNmodels;
-    t -= n * _dt0;
+    int n = Interval(t);
     // Components in geocentric basis
     // initial values to suppress warning
-    real BXc = 0, BYc = 0, BZc = 0;
-    _harm[n](X, Y, Z, BX, BY, BZ);
-    _harm[n + 1](X, Y, Z, BXt, BYt, BZt);
+    real B[3], Bt[3], Bc[3] = {0, 0, 0};
+    _harm[n](X, Y, Z, B[0], B[1], B[2]);
+    _harm[n + 1](X, Y, Z, Bt[0], Bt[1], Bt[2]);
     if (_nNconstants)
-      _harm[_nNmodels + 1](X, Y, Z, BXc, BYc, BZc);
+      _harm[_nNmodels + 1](X, Y, Z, Bc[0], Bc[1], Bc[2]);
+    Combine(t, n, B, Bt, Bc, BX, BY, BZ, BXt, BYt, BZt);
+  }
+
+  void MagneticModel::BlendGeocentric(real t, real X, real Y, real Z,
+                                      real& BX, real& BY, real& BZ) const {
+    int n = Interval(t);
+    bool interpolate = n + 1 < _nNmodels;
+    real t1 = t - _t0;
+    t1 -= n * _dt0;
+    // The field is linear in the coefficients; so blend the coefficients
+    // as in Combine: the values at the epochs are interpolated or the value
+    // at the last epoch is extrapolated with the secular variation.
+    const int L = 2 + _nNconstants;
+    SphericalEngine::coeff c[3] = {
+      _harm[n].Coefficients(), _harm[n + 1].Coefficients(),
+      _nNconstants ? _harm[_nNmodels + 1].Coefficients() :
+      SphericalEngine::coeff() };
+    real f[3] = { interpolate ? 1 - t1 / _dt0 : 1,
+                  interpolate ? t1 / _dt0 : t1, 1 };
+    // The limits of the sums are given by c[0]; so put the set with the
+    // largest degree first.  Its multiplier is taken to be 1; so divide the
+    // others by f[0] and scale the result by f[0].  If no set has both the
+    // largest degree and the largest order or if f[0] = 0, evaluate the
+    // models separately.
+    int k = 0;
+    for (int l = 1; l < L; ++l)
+      if (c[l].nmx() > c[k].nmx()) k = l;
+    bool separate = f[k] == 0;
+    for (int l = 0; l < L; ++l)
+      separate = separate || c[l].mmx() > c[k].mmx();
+    if (separate) {
+      real BXt, BYt, BZt;
+      FieldGeocentric(t, X, Y, Z, BX, BY, BZ, BXt, BYt, BZt);
+      return;
+    }
+    swap(c[0], c[k]); swap(f[0], f[k]);
+    for (int l = 1; l < L; ++l)
+      f[l] /= f[0];
+    int nthreads = Threads();
+    if (_norm == SphericalHarmonic::FULL) {
+      if (L == 2)
+        SphericalEngine::Value<true, SphericalEngine::FULL, 2>
+          (c, f, X, Y, Z, _a, BX, BY, BZ, nthreads);
+      else
+        SphericalEngine::Value<true, SphericalEngine::FULL, 3>
+          (c, f, X, Y, Z, _a, BX, BY, BZ, nthreads);
+    } else {
+      if (L == 2)
+        SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
+          (c, f, X, Y, Z, _a, BX, BY, BZ, nthreads);
+      else
+        SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 3>
+          (c, f, X, Y, Z, _a, BX, BY, BZ, nthreads);
+    }
+    BX *= - _a * f[0];
+    BY *= - _a * f[0];
+    BZ *= - _a * f[0];
+  }
+
+  int MagneticModel::Interval(real t) const {
+    return max(min(int(floor((t - _t0) / _dt0)), _nNmodels - 1), 0);
+  }
+
+  void MagneticModel::Combine(real t, int n,
+                              const real B[], const real Bt[], const real Bc[],
+                              real& BX, real& BY, real& BZ,
+                              real& BXt, real& BYt, real& BZt) const {
+    bool interpolate = n + 1 < _nNmodels;
+    t -= _t0;
+    t -= n * _dt0;
+    real BXc = Bc[0], BYc = Bc[1], BZc = Bc[2];
+    BX = B[0]; BY = B[1]; BZ = B[2];
+    BXt = Bt[0]; BYt = Bt[1]; BZt = Bt[2];
     if (interpolate) {
       // Convert to a time derivative
       BXt = (BXt - BX) / _dt0;
@@ -218,37 +435,162 @@ namespace GeographicLib {
   void MagneticModel::Field(real t, real lat, real lon, real h, bool diffp,
                             real& Bx, real& By, real& Bz,
                             real& Bxt, real& Byt, real& Bzt) const {
+    if (_circlebudget) {
+      shared_ptr<const MagneticCircle> c = CachedCircle(t, lat, h);
+      if (c) { c->Field(t, lon, diffp, Bx, By, Bz, Bxt, Byt, Bzt); return; }
+    }
     real X, Y, Z;
     real M[Geocentric::dim2_];
     _earth.IntForward(lat, lon, h, X, Y, Z, M);
     // Components in geocentric basis
     // initial values to suppress warning
     real BX = 0, BY = 0, BZ = 0, BXt = 0, BYt = 0, BZt = 0;
-    FieldGeocentric(t, X, Y, Z, BX, BY, BZ, BXt, BYt, BZt);
-    if (diffp)
+    if (diffp) {
+      FieldGeocentric(t, X, Y, Z, BX, BY, BZ, BXt, BYt, BZt);
       Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt, Byt, Bzt);
+    } else
+      BlendGeocentric(t, X, Y, Z, BX, BY, BZ);
     Geocentric::Unrotate(M, BX, BY, BZ, Bx, By, Bz);
   }
 
+  void MagneticModel::TimeBatch(size_t n, const real t[],
+                                real lat, real lon, real h,
+                                real Bx[], real By[], real Bz[],
+                                real Bxt[], real Byt[], real Bzt[]) const {
+    real X, Y, Z;
+    real M[Geocentric::dim2_];
+    _earth.IntForward(lat, lon, h, X, Y, Z, M);
+    // The geocentric components of each spherical harmonic sum, evaluated
+    // when first needed.
+    int nharm = int(_harm.size());
+    vector<real> sums(3 * nharm);
+    vector<bool> done(nharm, false);
+    auto sum = [&](int k) -> const real* {
+      real* s = &sums[3 * k];
+      if (!done[k]) {
+        _harm[k](X, Y, Z, s[0], s[1], s[2]);
+        done[k] = true;
+      }
+      return s;
+    };
+    const real zero[3] = {0, 0, 0};
+    const real* Bc = _nNconstants ? sum(_nNmodels + 1) : zero;
+    bool diffp = Bxt && Byt && Bzt;
+    for (size_t i = 0; i < n; ++i) {
+      int k = Interval(t[i]);
+      real BX, BY, BZ, BXt, BYt, BZt;
+      Combine(t[i], k, sum(k), sum(k + 1), Bc, BX, BY, BZ, BXt, BYt, BZt);
+      if (diffp)
+        Geocentric::Unrotate(M, BXt, BYt, BZt, Bxt[i], Byt[i], Bzt[i]);
+      Geocentric::Unrotate(M, BX, BY, BZ, Bx[i], By[i], Bz[i]);
+    }
+  }
+
   MagneticCircle MagneticModel::Circle(real t, real lat, real h) const {
-    real t1 = t - _t0;
-    int n = max(min(int(floor(t1 / _dt0)), _nNmodels - 1), 0);
-    bool interpolate = n + 1 < _nNmodels;
-    t1 -= n * _dt0;
+    int n = isnan(t) ? 0 : Interval(t);
+    return Circle(t, lat, h, n, n);
+  }
+
+  MagneticCircle MagneticModel::Circle(real lat, real h) const {
+    return Circle(Math::NaN(), lat, h, 0, _nNmodels - 1);
+  }
+
+  MagneticCircle MagneticModel::Circle(real t, real lat, real h,
+                                       int n0, int n1) const {
     real X, Y, Z, M[Geocentric::dim2_];
     _earth.IntForward(lat, 0, h, X, Y, Z, M);
     // Y = 0, cphi = M[7], sphi = M[8];
+    vector<CircularEngine> circ;
+    circ.reserve(n1 - n0 + 2 + _nNconstants);
+    for (int n = n0; n <= n1 + 1; ++n)
+      circ.push_back(_harm[n].Circle(X, Z, true));
+    if (_nNconstants)
+      circ.push_back(_harm[_nNmodels + 1].Circle(X, Z, true));
+    return MagneticCircle(_a, _earth._f, lat, h, t, M[7], M[8], _t0, _dt0,
+                          _nNmodels, n0, n1, _nNconstants != 0,
+                          std::move(circ));
+  }
+
+  void MagneticModel::Grid(real t, real h,
+                           real lat0, real dlat, size_t nlat,
+                           real lon0, real dlon, size_t nlon,
+                           real D[], real I[], real F[]) const {
+    int nthreads = int(min(size_t(max(Threads(), 1)), nlat));
+    // Rows i, i + nthreads, ... are handled by task i.
+    auto worker = [&](int k) -> void {
+      vector<real> Bx(nlon), By(nlon), Bz(nlon);
+      for (size_t i = size_t(k); i < nlat; i += size_t(nthreads)) {
+        MagneticCircle c(Circle(t, lat0 + real(i) * dlat, h));
+        c.Grid(lon0, dlon, nlon, Bx.data(), By.data(), Bz.data());
+        for (size_t j = 0; j < nlon; ++j) {
+          real Hx, Fx, Dx, Ix;
+          FieldComponents(Bx[j], By[j], Bz[j], Hx, Fx, Dx, Ix);
+          size_t l = i * nlon + j;
+          if (D) D[l] = Dx;
+          if (I) I[l] = Ix;
+          if (F) F[l] = Fx;
+        }
+      }
+    };
+    Executor::Batch(nthreads, worker);
+  }
+
+  void MagneticModel::SetThreads(int nthreads) {
+    for (auto& harm : _harm)
+      harm.SetThreads(nthreads);
+  }
 
-    return (_nNconstants == 0 ?
-            MagneticCircle(_a, _earth._f, lat, h, t,
-                           M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true)) :
-            MagneticCircle(_a, _earth._f, lat, h, t,
-                           M[7], M[8], t1, _dt0, interpolate,
-                           _harm[n].Circle(X, Z, true),
-                           _harm[n + 1].Circle(X, Z, true),
-                           _harm[_nNmodels + 1].Circle(X, Z, true)));
+  size_t MagneticModel::CircleBytes() const {
+    // Up to 3 circles each holding 6 coefficients per order
+    return sizeof(MagneticCircle) + 18 * size_t(_mmx + 1) * sizeof(real);
+  }
+
+  void MagneticModel::SetCircleCacheSize(size_t maxbytes) {
+    lock_guard<mutex> g(_circlelock);
+    _circlebudget = maxbytes;
+    _circlehits = _circlemisses = 0;
+    while (!_circlelru.empty() && _circlebytes > _circlebudget) {
+      _circlemap.erase(_circlelru.back().first);
+      _circlelru.pop_back();
+      _circlebytes -= CircleBytes();
+    }
+  }
+
+  shared_ptr<const MagneticCircle>
+  MagneticModel::CachedCircle(real t, real lat, real h) const {
+    if (!(_circlebudget && isfinite(t) && isfinite(lat) && isfinite(h)))
+      return nullptr;
+    circlekey k(t, lat, h);
+    {
+      lock_guard<mutex> g(_circlelock);
+      auto p = _circlemap.find(k);
+      if (p != _circlemap.end()) {
+        ++_circlehits;
+        _circlelru.splice(_circlelru.begin(), _circlelru, p->second);
+        return p->second->second;
+      }
+      ++_circlemisses;
+    }
+    // Construct the circle without holding the lock; if another thread
+    // constructs it meanwhile, use that one.
+    shared_ptr<const MagneticCircle> c(new MagneticCircle(Circle(t, lat, h)));
+    size_t bytes = CircleBytes();
+    lock_guard<mutex> g(_circlelock);
+    auto p = _circlemap.find(k);
+    if (p != _circlemap.end())
+      return p->second->second;
+    if (bytes > _circlebudget)
+      // Too big to cache
+      return c;
+    while (_circlebytes + bytes > _circlebudget) {
+      _circlemap.erase(_circlelru.back().first);
+      _circlelru.pop_back();
+      _circlebytes -= bytes;
+    }
+    _circlelru.push_front(make_pair(k, c));
+    _circlemap[k] = _circlelru.begin();
+    _circlebytes += bytes;
+    return c;
   }
 
   void MagneticModel::FieldComponents(real Bx, real By, real Bz,
@@ -19,7 +19,7 @@ namespace GeographicLib {
   using namespace std;
 
   void Math::dummy() {
-    static_assert(GEOGRAPHICLIB_PRECISION >= 1 && GEOGRAPHICLIB_PRECISION <= 5,
+    static_assert(GEOGRAPHICLIB_PRECISION >= 1 && GEOGRAPHICLIB_PRECISION <= 6,
                   "Bad value of precision");
   }
 
@@ -68,6 +68,39 @@ namespace GeographicLib {
     return s;
   }
 
+  namespace {
+
+    // Reduce x[j] exactly to r[j] in [-mod/2, mod/2] with x[j] = r[j] + q[j]
+    // * mod, for j = 0 .. m-1, with the same result as remquo(x[j], mod) and
+    // remainder(x[j], mod), i.e., ties go to even q[j] and r[j] = 0 has the
+    // sign of x[j].  The remainder is computed as x - mod * q which is exact
+    // provided that |x| < 2^(digits - 10); the elements which don't satisfy
+    // this (including infinities and NaNs) are flagged with big[j] = true
+    // and the caller must handle them separately.
+    template<typename T>
+    void anglereduce(int m, const T x[], T mod, T r[], T q[], bool big[]) {
+      static const T maxx = 1 / (512 * numeric_limits<T>::epsilon());
+      T hmod = mod / 2;
+      for (int j = 0; j < m; ++j) {
+        T qj = floor(x[j] / mod + T(0.5)), rj = x[j] - mod * qj;
+        // x / mod may be rounded so that qj is off by 1; fix this and
+        // resolve the ties to even qj.
+        T qh = qj / 2;
+        bool odd = qh != floor(qh);
+        if (rj > hmod || (rj == hmod && odd)) {
+          qj += 1; rj -= mod;
+        } else if (rj < -hmod || (rj == -hmod && odd)) {
+          qj -= 1; rj += mod;
+        }
+        // mpreal needs T(0) here
+        r[j] = rj == 0 ? copysign(T(0), x[j]) : rj;
+        q[j] = qj;
+        big[j] = !(fabs(x[j]) < maxx);
+      }
+    }
+
+  }
+
   template<typename T> T Math::AngNormalize(T x) {
     T y = remainder(x, T(td));
 #if GEOGRAPHICLIB_PRECISION == 4
@@ -79,6 +112,21 @@ namespace GeographicLib {
     return fabs(y) == T(hd) ? copysign(T(hd), x) : y;
   }
 
+  template<typename T>
+  void Math::AngNormalize(size_t n, const T x[], T y[]) {
+    static const int nb = 16;
+    T r[nb], q[nb];
+    bool big[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      int m = int(min(size_t(nb), n - i0));
+      anglereduce(m, x + i0, T(td), r, q, big);
+      for (int j = 0; j < m; ++j)
+        r[j] = fabs(r[j]) == T(hd) ? copysign(T(hd), x[i0 + j]) : r[j];
+      for (int j = 0; j < m; ++j)
+        y[i0 + j] = big[j] ? AngNormalize(x[i0 + j]) : r[j];
+    }
+  }
+
   template<typename T> T Math::AngDiff(T x, T y, T& e) {
     // Use remainder instead of AngNormalize, since we treat boundary cases
     // later taking account of the error
@@ -94,12 +142,70 @@ namespace GeographicLib {
     return d;
   }
 
+  template<typename T>
+  void Math::AngDiff(size_t n, const T x[], const T y[], T d[], T e[]) {
+    // This follows the scalar version with remainder replaced by
+    // anglereduce.
+    static const int nb = 16;
+    T mx[nb], rx[nb], ry[nb], dd[nb], ee[nb], q[nb];
+    bool bigx[nb], bigy[nb], bigd[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      int m = int(min(size_t(nb), n - i0));
+      for (int j = 0; j < m; ++j)
+        mx[j] = -x[i0 + j];
+      anglereduce(m, mx, T(td), rx, q, bigx);
+      anglereduce(m, y + i0, T(td), ry, q, bigy);
+      for (int j = 0; j < m; ++j)
+        dd[j] = sum(rx[j], ry[j], ee[j]);
+      anglereduce(m, dd, T(td), rx, q, bigd);
+      for (int j = 0; j < m; ++j) {
+        T dj = sum(rx[j], ee[j], ee[j]);
+        if (dj == 0 || fabs(dj) == hd)
+          dj = copysign(dj, ee[j] == 0 ? y[i0 + j] - x[i0 + j] : -ee[j]);
+        dd[j] = dj;
+      }
+      for (int j = 0; j < m; ++j) {
+        if (bigx[j] || bigy[j])
+          dd[j] = AngDiff(x[i0 + j], y[i0 + j], ee[j]);
+      }
+      // Write d after reading x and y, since d may be the same as x or y.
+      copy(dd, dd + m, d + i0);
+      if (e) copy(ee, ee + m, e + i0);
+    }
+  }
+
+  namespace {
+    // For y >= 0, return z - (z - y) if y < z, else y.  This rounds small y
+    // to a multiple of z * epsilon/2.
+    template<typename T> inline T roundsmall(T y, T z) {
+      GEOGRAPHICLIB_VOLATILE T w = z - y;
+      // The compiler mustn't "simplify" z - (z - y) to y
+      return w > 0 ? z - w : y;
+    }
+#if GEOGRAPHICLIB_PRECISION == 6
+    // The subtractions are exact for DoubleDouble (which doesn't have a fixed
+    // precision), so do the rounding explicitly; z is a power of 2.
+    inline DoubleDouble roundsmall(DoubleDouble y, DoubleDouble z) {
+      if (!(y < z)) return y;
+      DoubleDouble q = z * numeric_limits<DoubleDouble>::epsilon() / 2;
+      return nearbyint(y / q) * q;
+    }
+#endif
+
+    // Evaluate sin and cos of the reduced argument.  g++ -O turns the two
+    // function calls into a call to sincos for the standard types.
+    template<typename T> inline void sincosr(T r, T& s, T& c)
+    { s = sin(r); c = cos(r); }
+#if GEOGRAPHICLIB_PRECISION == 6
+    // DoubleDouble shares the argument reduction between sin and cos
+    inline void sincosr(DoubleDouble r, DoubleDouble& s, DoubleDouble& c)
+    { DoubleDouble::sincos(r, s, c); }
+#endif
+  }
+
   template<typename T> T Math::AngRound(T x) {
     static const T z = T(1)/T(16);
-    GEOGRAPHICLIB_VOLATILE T y = fabs(x);
-    GEOGRAPHICLIB_VOLATILE T w = z - y;
-    // The compiler mustn't "simplify" z - (z - y) to y
-    y = w > 0 ? z - w : y;
+    T y = roundsmall(T(fabs(x)), z);
     return copysign(y, x);
   }
 
@@ -109,8 +215,8 @@ namespace GeographicLib {
     T r; int q = 0;
     r = remquo(x, T(qd), &q);   // now abs(r) <= 45
     r *= degree<T>();
-    // g++ -O turns these two function calls into a call to sincos
-    T s = sin(r), c = cos(r);
+    T s, c;
+    sincosr(r, s, c);
     switch (unsigned(q) & 3U) {
     case 0U: sinx =  s; cosx =  c; break;
     case 1U: sinx =  c; cosx = -s; break;
@@ -123,6 +229,45 @@ namespace GeographicLib {
     if (sinx == 0) sinx = copysign(sinx, x); // special values from F.10.1.13
   }
 
+  template<typename T>
+  void Math::sincosd(size_t n, const T x[], T sinx[], T cosx[]) {
+    // This follows the scalar version in three passes over a block: the
+    // exact reduction of the arguments, the evaluation of sin and cos, and
+    // the selection of the quadrant.
+    static const int nb = 16;
+    T r[nb], q[nb], s[nb], c[nb];
+    bool big[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      int m = int(min(size_t(nb), n - i0));
+      anglereduce(m, x + i0, T(qd), r, q, big);
+      for (int j = 0; j < m; ++j) {
+        r[j] *= degree<T>();
+        sincosr(r[j], s[j], c[j]);
+      }
+      for (int j = 0; j < m; ++j) {
+        // q mod 4 as a T in [0, 4) so that there's no conversion of large
+        // values to int.
+        T p = q[j] - 4 * floor(q[j] / 4);
+        bool odd = p == 1 || p == 3,
+          sneg = p >= 2, cneg = p == 1 || p == 2;
+        T sj = odd ? c[j] : s[j], cj = odd ? s[j] : c[j];
+        if (sneg) sj = -sj;
+        if (cneg) cj = -cj;
+        // mpreal needs T(0) here
+        cj += T(0);
+        if (sj == 0) sj = copysign(sj, x[i0 + j]);
+        s[j] = sj; c[j] = cj;
+      }
+      for (int j = 0; j < m; ++j) {
+        if (big[j]) sincosd(x[i0 + j], s[j], c[j]);
+      }
+      // Write the results after reading x, since sinx or cosx may be the same
+      // as x.
+      copy(s, s + m, sinx + i0);
+      copy(c, c + m, cosx + i0);
+    }
+  }
+
   template<typename T> void Math::sincosde(T x, T t, T& sinx, T& cosx) {
     // In order to minimize round-off errors, this function exactly reduces
     // the argument to the range [-45, 45] before converting it to radians.
@@ -131,8 +276,8 @@ namespace GeographicLib {
     T r; int q = 0;
     r = AngRound(remquo(x, T(qd), &q) + t); // now abs(r) <= 45
     r *= degree<T>();
-    // g++ -O turns these two function calls into a call to sincos
-    T s = sin(r), c = cos(r);
+    T s, c;
+    sincosr(r, s, c);
     switch (unsigned(q) & 3U) {
     case 0U: sinx =  s; cosx =  c; break;
     case 1U: sinx =  c; cosx = -s; break;
@@ -199,6 +344,35 @@ namespace GeographicLib {
     return ang;
   }
 
+  template<typename T>
+  void Math::atan2d(size_t n, const T y[], const T x[], T z[]) {
+    // This follows the scalar version in three passes over a block: the
+    // rearrangement of the arguments, the evaluation of atan2, and the
+    // mapping to the correct quadrant.
+    static const int nb = 16;
+    // The mapping to the quadrant is written as z = off + sgn * ang, with
+    // off = -0 in the first quadrant so that ang = -0 is preserved.
+    T yy[nb], xx[nb], off[nb], sgn[nb], ang[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      int m = int(min(size_t(nb), n - i0));
+      for (int j = 0; j < m; ++j) {
+        T yj = y[i0 + j], xj = x[i0 + j];
+        bool swapp = fabs(yj) > fabs(xj);
+        T xs = swapp ? yj : xj, ys = swapp ? xj : yj;
+        bool neg = signbit(xs);
+        xx[j] = neg ? -xs : xs; yy[j] = ys;
+        // q = 1: hd - ang; q = 2: qd - ang; q = 3: -qd + ang; q = 0: ang
+        off[j] = neg ? (swapp ? -T(qd) : copysign(T(hd), ys)) :
+          (swapp ? T(qd) : -T(0));
+        sgn[j] = neg == swapp ? 1 : -1;
+      }
+      for (int j = 0; j < m; ++j)
+        ang[j] = atan2(yy[j], xx[j]) / degree<T>();
+      for (int j = 0; j < m; ++j)
+        z[i0 + j] = off[j] + sgn[j] * ang[j];
+    }
+  }
+
   template<typename T> T Math::atand(T x)
   { return atan2d(x, T(1)); }
 
@@ -247,6 +421,40 @@ namespace GeographicLib {
     return tau;
   }
 
+  template<typename T>
+  void Math::tauf(size_t n, const T taup[], T es, T tau[]) {
+    // The constants and the starting guess are the same as in the scalar
+    // version.
+    static const int numit = 5, nb = 16;
+    static const T tol = sqrt(numeric_limits<T>::epsilon()) / 10;
+    static const T taumax = 2 / sqrt(numeric_limits<T>::epsilon());
+    T e2m = 1 - _sq(es), tp[nb], t[nb], stol[nb];
+    bool active[nb];
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      int m = int(min(size_t(nb), n - i0)), na = 0;
+      for (int j = 0; j < m; ++j) {
+        tp[j] = taup[i0 + j];
+        t[j] = fabs(tp[j]) > 70 ? tp[j] * exp(eatanhe(T(1), es)) : tp[j]/e2m;
+        stol[j] = tol * fmax(T(1), fabs(tp[j]));
+        active[j] = fabs(t[j]) < taumax; // excludes +/-inf and nan
+        if (active[j]) ++na;
+      }
+      for (int i = 0; na > 0 && (i < numit || GEOGRAPHICLIB_PANIC); ++i) {
+        for (int j = 0; j < m; ++j) {
+          if (!active[j]) continue;
+          T taupa = taupf(t[j], es),
+            dtau = (tp[j] - taupa) * (1 + e2m * _sq(t[j])) /
+            ( e2m * hypot(T(1), t[j]) * hypot(T(1), taupa) );
+          t[j] += dtau;
+          if (!(fabs(dtau) >= stol[j])) {
+            active[j] = false; --na;
+          }
+        }
+      }
+      copy(t, t + m, tau + i0);
+    }
+  }
+
   template<typename T> T Math::NaN() {
 #if defined(_MSC_VER)
     return numeric_limits<T>::has_quiet_NaN ?
@@ -277,17 +485,27 @@ namespace GeographicLib {
   template T    GEOGRAPHICLIB_EXPORT Math::sum          <T>(T, T, T&);     \
   template T    GEOGRAPHICLIB_EXPORT Math::AngNormalize <T>(T);            \
   template T    GEOGRAPHICLIB_EXPORT Math::AngDiff      <T>(T, T, T&);     \
+  template void GEOGRAPHICLIB_EXPORT Math::AngNormalize                     \
+  <T>(size_t, const T[], T[]);                                             \
+  template void GEOGRAPHICLIB_EXPORT Math::AngDiff                          \
+  <T>(size_t, const T[], const T[], T[], T[]);                             \
   template T    GEOGRAPHICLIB_EXPORT Math::AngRound     <T>(T);            \
   template void GEOGRAPHICLIB_EXPORT Math::sincosd      <T>(T, T&, T&);    \
+  template void GEOGRAPHICLIB_EXPORT Math::sincosd                          \
+  <T>(size_t, const T[], T[], T[]);                                        \
   template void GEOGRAPHICLIB_EXPORT Math::sincosde     <T>(T, T, T&, T&); \
   template T    GEOGRAPHICLIB_EXPORT Math::sind         <T>(T);            \
   template T    GEOGRAPHICLIB_EXPORT Math::cosd         <T>(T);            \
   template T    GEOGRAPHICLIB_EXPORT Math::tand         <T>(T);            \
   template T    GEOGRAPHICLIB_EXPORT Math::atan2d       <T>(T, T);         \
+  template void GEOGRAPHICLIB_EXPORT Math::atan2d                           \
+  <T>(size_t, const T[], const T[], T[]);                                  \
   template T    GEOGRAPHICLIB_EXPORT Math::atand        <T>(T);            \
   template T    GEOGRAPHICLIB_EXPORT Math::eatanhe      <T>(T, T);         \
   template T    GEOGRAPHICLIB_EXPORT Math::taupf        <T>(T, T);         \
   template T    GEOGRAPHICLIB_EXPORT Math::tauf         <T>(T, T);         \
+  template void GEOGRAPHICLIB_EXPORT Math::tauf                             \
+  <T>(size_t, const T[], T, T[]);                                          \
   template T    GEOGRAPHICLIB_EXPORT Math::NaN          <T>();             \
   template T    GEOGRAPHICLIB_EXPORT Math::infinity     <T>();
 
@@ -0,0 +1,64 @@
+/**
+ * \file MemoryFootprint.cpp
+ * \brief Implementation for GeographicLib::MemoryFootprint class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/MemoryFootprint.hpp>
+#include <GeographicLib/SphericalEngine.hpp>
+#include <mutex>
+#include <utility>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // The registered objects.  The registry is only changed by the
+    // constructors and destructors of the large objects; so a vector with a
+    // linear search for Unregister suffices.
+    struct Registry {
+      mutex lock;
+      vector<pair<const void*, MemoryFootprint::reporter>> objs;
+    };
+    Registry& registry() {
+      static Registry r;
+      return r;
+    }
+  }
+
+  MemoryFootprint MemoryFootprint::Shared() {
+    return MemoryFootprint(SphericalEngine::RootTableBytes() +
+                           SphericalEngine::LegendreTableBytes());
+  }
+
+  MemoryFootprint MemoryFootprint::Process() {
+    MemoryFootprint m = Shared();
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    for (const auto& o : r.objs)
+      m += o.second(o.first);
+    return m;
+  }
+
+  void MemoryFootprint::Register(const void* obj, reporter f) {
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    r.objs.push_back(make_pair(obj, f));
+  }
+
+  void MemoryFootprint::Unregister(const void* obj) {
+    Registry& r = registry();
+    lock_guard<mutex> g(r.lock);
+    for (size_t i = r.objs.size(); i-- > 0;)
+      if (r.objs[i].first == obj) {
+        r.objs[i] = r.objs.back();
+        r.objs.pop_back();
+        return;
+      }
+  }
+
+} // namespace GeographicLib
@@ -2,7 +2,7 @@
  * \file NormalGravity.cpp
  * \brief Implementation for GeographicLib::NormalGravity class
  *
- * Copyright (c) Charles Karney (2011-2022) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2011-2023) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
@@ -132,6 +132,20 @@ namespace GeographicLib {
       1 - 3 * (1 + y) * atan5series(y);
   }
 
+  void NormalGravity::QHf(real x, bool alt, real& Q, real& H) {
+    // The same as Q = Qf(x, alt), H = Hf(x, alt)
+    real y = alt ? -x / (1 + x) : x;
+    if (!(4 * fabs(y) < 1)) {   // Backwards test to allow NaNs through
+      real t = atanzz(x, alt);
+      Q = ((1 + 3/y) * t - 3/y) / (2 * y);
+      H = (3 * (1 + 1/y) * (1 - t) - 1) / y;
+    } else {
+      real t = atan5series(y);
+      Q = (3 * (3 + y) * t - 1) / 6;
+      H = 1 - 3 * (1 + y) * t;
+    }
+  }
+
   Math::real NormalGravity::QH3f(real x, bool alt) {
     // z = sqrt(x)
     // (Q(z) - H(z)/3) / z^2
@@ -165,59 +179,90 @@ namespace GeographicLib {
   Math::real NormalGravity::V0(real X, real Y, real Z,
                                real& GammaX, real& GammaY, real& GammaZ) const
   {
-    // See H+M, Sec 6-2
-    real
-      p = hypot(X, Y),
-      clam = p != 0 ? X/p : 1,
-      slam = p != 0 ? Y/p : 0,
-      r = hypot(p, Z);
-    if (_f < 0) swap(p, Z);
-    real
-      Q = Math::_sq(r) - Math::_sq(_eE),
-      t2 = Math::_sq(2 * _eE * Z),
-      disc = sqrt(Math::_sq(Q) + t2),
-      // This is H+M, Eq 6-8a, but generalized to deal with Q negative
-      // accurately.
-      u = sqrt((Q >= 0 ? (Q + disc) : t2 / (disc - Q)) / 2),
-      uE = hypot(u, _eE),
-      // H+M, Eq 6-8b
-      sbet = u != 0 ? Z * uE : copysign(sqrt(-Q), Z),
-      cbet = u != 0 ? p * u : p,
-      s = hypot(cbet, sbet);
-    sbet = s != 0 ? sbet/s : 1;
-    cbet = s != 0 ? cbet/s : 0;
-    real
-      z = _eE/u,
-      z2 = Math::_sq(z),
-      den = hypot(u, _eE * sbet);
-    if (_f < 0) {
-      swap(sbet, cbet);
-      swap(u, uE);
-    }
-    real
-      invw = uE / den,          // H+M, Eq 2-63
-      bu = _b / (u != 0 || _f < 0 ? u : _eE),
-      // Qf(z2->inf, false) = pi/(4*z^3)
-      q = ((u != 0 || _f < 0 ? Qf(z2, _f < 0) : Math::pi() / 4) / _qQ0) *
-        bu * Math::_sq(bu),
-      qp = _b * Math::_sq(bu) * (u != 0 || _f < 0 ? Hf(z2, _f < 0) : 2) / _qQ0,
-      ang = (Math::_sq(sbet) - 1/real(3)) / 2,
-      // H+M, Eqs 2-62 + 6-9, but omitting last (rotational) term.
-      Vres = _gGM * (u != 0 || _f < 0 ?
-                    atanzz(z2, _f < 0) / u :
-                    Math::pi() / (2 * _eE)) + _aomega2 * q * ang,
-      // H+M, Eq 6-10
-      gamu = - (_gGM + (_aomega2 * qp * ang)) * invw / Math::_sq(uE),
-      gamb = _aomega2 * q * sbet * cbet * invw / uE,
-      t = u * invw / uE,
-      gamp = t * cbet * gamu - invw * sbet * gamb;
-    // H+M, Eq 6-12
-    GammaX = gamp * clam;
-    GammaY = gamp * slam;
-    GammaZ = invw * sbet * gamu + t * cbet * gamb;
+    real Vres;
+    V0Block(1, &X, &Y, &Z, &Vres, &GammaX, &GammaY, &GammaZ);
     return Vres;
   }
 
+  void NormalGravity::V0Block(int m,
+                              const real X[], const real Y[], const real Z[],
+                              real V[],
+                              real GammaX[], real GammaY[], real GammaZ[])
+    const {
+    // See H+M, Sec 6-2.  The calculation is split into three passes over the
+    // points: (1) find the ellipsoidal coordinates, (2) evaluate the
+    // transcendental functions, (3) combine the results.  In (2) and (3), u
+    // and uE have been swapped if _f < 0; the quantities which depend on
+    // whether u = 0 are selected in (2).
+    const bool alt = _f < 0;
+    real clam[blocksize_], slam[blocksize_], u[blocksize_], uE[blocksize_],
+      sbet[blocksize_], cbet[blocksize_], den[blocksize_], z2[blocksize_],
+      bu[blocksize_], Q[blocksize_], H[blocksize_], A[blocksize_];
+    for (int i = 0; i < m; ++i) {
+      real
+        p = hypot(X[i], Y[i]),
+        Zi = Z[i],
+        r = hypot(p, Zi);
+      clam[i] = p != 0 ? X[i]/p : 1;
+      slam[i] = p != 0 ? Y[i]/p : 0;
+      if (alt) swap(p, Zi);
+      real
+        Qx = Math::_sq(r) - Math::_sq(_eE),
+        t2 = Math::_sq(2 * _eE * Zi),
+        disc = sqrt(Math::_sq(Qx) + t2),
+        // This is H+M, Eq 6-8a, but generalized to deal with Q negative
+        // accurately.
+        ui = sqrt((Qx >= 0 ? (Qx + disc) : t2 / (disc - Qx)) / 2),
+        uEi = hypot(ui, _eE),
+        // H+M, Eq 6-8b
+        sbeti = ui != 0 ? Zi * uEi : copysign(sqrt(-Qx), Zi),
+        cbeti = ui != 0 ? p * ui : p,
+        s = hypot(cbeti, sbeti);
+      sbeti = s != 0 ? sbeti/s : 1;
+      cbeti = s != 0 ? cbeti/s : 0;
+      z2[i] = Math::_sq(_eE/ui);
+      den[i] = hypot(ui, _eE * sbeti);
+      if (alt) {
+        swap(sbeti, cbeti);
+        swap(ui, uEi);
+      }
+      u[i] = ui; uE[i] = uEi; sbet[i] = sbeti; cbet[i] = cbeti;
+    }
+    for (int i = 0; i < m; ++i) {
+      if (u[i] != 0 || alt) {
+        bu[i] = u[i];
+        QHf(z2[i], alt, Q[i], H[i]);
+        A[i] = atanzz(z2[i], alt) / u[i];
+      } else {
+        bu[i] = _eE;
+        // Qf(z2->inf, false) = pi/(4*z^3)
+        Q[i] = Math::pi() / 4;
+        H[i] = 2;
+        A[i] = Math::pi() / (2 * _eE);
+      }
+    }
+    for (int i = 0; i < m; ++i) {
+      real
+        invw = uE[i] / den[i],  // H+M, Eq 2-63
+        bui = _b / bu[i],
+        q = (Q[i] / _qQ0) * bui * Math::_sq(bui),
+        qp = _b * Math::_sq(bui) * H[i] / _qQ0,
+        ang = (Math::_sq(sbet[i]) - 1/real(3)) / 2,
+        // H+M, Eqs 2-62 + 6-9, but omitting last (rotational) term.
+        Vres = _gGM * A[i] + _aomega2 * q * ang,
+        // H+M, Eq 6-10
+        gamu = - (_gGM + (_aomega2 * qp * ang)) * invw / Math::_sq(uE[i]),
+        gamb = _aomega2 * q * sbet[i] * cbet[i] * invw / uE[i],
+        t = u[i] * invw / uE[i],
+        gamp = t * cbet[i] * gamu - invw * sbet[i] * gamb;
+      // H+M, Eq 6-12
+      GammaX[i] = gamp * clam[i];
+      GammaY[i] = gamp * slam[i];
+      GammaZ[i] = invw * sbet[i] * gamu + t * cbet[i] * gamb;
+      V[i] = Vres;
+    }
+  }
+
   Math::real NormalGravity::Phi(real X, real Y, real& fX, real& fY) const {
     fX = _omega2 * X;
     fY = _omega2 * Y;
@@ -247,6 +292,66 @@ namespace GeographicLib {
     return Ures;
   }
 
+  void NormalGravity::SurfaceGravityBatch(size_t n, const real lat[],
+                                          real gamma[]) const {
+    for (size_t i = 0; i < n; ++i)
+      gamma[i] = SurfaceGravity(lat[i]);
+  }
+
+  void NormalGravity::V0Batch(size_t n,
+                              const real X[], const real Y[], const real Z[],
+                              real GammaX[], real GammaY[], real GammaZ[],
+                              real V0[]) const {
+    real V[blocksize_];
+    for (size_t i = 0; i < n; i += blocksize_) {
+      int m = int(min(size_t(blocksize_), n - i));
+      V0Block(m, X + i, Y + i, Z + i, V0 ? V0 + i : V,
+              GammaX + i, GammaY + i, GammaZ + i);
+    }
+  }
+
+  void NormalGravity::UBatch(size_t n,
+                             const real X[], const real Y[], const real Z[],
+                             real gammaX[], real gammaY[], real gammaZ[],
+                             real U[]) const {
+    real V[blocksize_], gX[blocksize_], gY[blocksize_];
+    for (size_t i0 = 0; i0 < n; i0 += blocksize_) {
+      int m = int(min(size_t(blocksize_), n - i0));
+      V0Block(m, X + i0, Y + i0, Z + i0, V, gX, gY, gammaZ + i0);
+      for (int j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        real fX, fY, Ures = V[j] + Phi(X[i], Y[i], fX, fY);
+        gammaX[i] = gX[j] + fX;
+        gammaY[i] = gY[j] + fY;
+        if (U) U[i] = Ures;
+      }
+    }
+  }
+
+  void NormalGravity::GravityBatch(size_t n, const real lat[], const real h[],
+                                   real gammay[], real gammaz[], real U[])
+    const {
+    real X[blocksize_], Y[blocksize_], Z[blocksize_],
+      M[blocksize_ * Geocentric::dim2_],
+      gX[blocksize_], gY[blocksize_], gZ[blocksize_], V[blocksize_];
+    for (size_t i0 = 0; i0 < n; i0 += blocksize_) {
+      int m = int(min(size_t(blocksize_), n - i0));
+      for (int j = 0; j < m; ++j)
+        _earth.IntForward(lat[i0 + j], 0, h[i0 + j], X[j], Y[j], Z[j],
+                          M + j * Geocentric::dim2_);
+      V0Block(m, X, Y, Z, V, gX, gY, gZ);
+      for (int j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        const real* Mj = M + j * Geocentric::dim2_;
+        real fX, fY, Ures = V[j] + Phi(X[j], Y[j], fX, fY),
+          gammaX = gX[j] + fX, gammaY = gY[j] + fY, gammaZ = gZ[j];
+        gammay[i] = Mj[1] * gammaX + Mj[4] * gammaY + Mj[7] * gammaZ;
+        gammaz[i] = Mj[2] * gammaX + Mj[5] * gammaY + Mj[8] * gammaZ;
+        if (U) U[i] = Ures;
+      }
+    }
+  }
+
   Math::real NormalGravity::J2ToFlattening(real a, real GM,
                                            real omega, real J2) {
     // Solve
@@ -2,13 +2,14 @@
  * \file OSGB.cpp
  * \brief Implementation for GeographicLib::OSGB class
  *
- * Copyright (c) Charles Karney (2010-2020) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2010-2023) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
 #include <GeographicLib/OSGB.hpp>
 #include <GeographicLib/Utility.hpp>
+#include <cstring>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -36,7 +37,38 @@ namespace GeographicLib {
     return northoffset;
   }
 
+  void OSGB::Forward(size_t n, const real lat[], const real lon[],
+                     real x[], real y[], real gamma[], real k[]) {
+    OSGBTM().Forward(OriginLongitude(), n, lat, lon, x, y, gamma, k);
+    real x0 = FalseEasting(), y0 = computenorthoffset();
+    for (size_t i = 0; i < n; ++i) {
+      x[i] += x0;
+      y[i] += y0;
+    }
+  }
+
+  void OSGB::Reverse(size_t n, const real x[], const real y[],
+                     real lat[], real lon[], real gamma[], real k[]) {
+    real x0 = FalseEasting(), y0 = computenorthoffset();
+    real xx[block_], yx[block_];
+    for (size_t i0 = 0; i0 < n; i0 += block_) {
+      size_t m = min(size_t(block_), n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        xx[j] = x[i0 + j] - x0;
+        yx[j] = y[i0 + j] - y0;
+      }
+      OSGBTM().Reverse(OriginLongitude(), m, xx, yx, lat + i0, lon + i0,
+                       gamma ? gamma + i0 : nullptr, k ? k + i0 : nullptr);
+    }
+  }
+
   void OSGB::GridReference(real x, real y, int prec, std::string& gridref) {
+    char grid[MAXLENGTH + 1];
+    int len = GridReference(x, y, prec, grid);
+    gridref.assign(grid, len);
+  }
+
+  int OSGB::GridReference(real x, real y, int prec, char gridref[]) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     CheckCoords(x, y);
     if (!(prec >= 0 && prec <= maxprec_))
@@ -44,10 +76,11 @@ namespace GeographicLib {
                           + " not in [0, "
                           + Utility::str(int(maxprec_)) + "]");
     if (isnan(x) || isnan(y)) {
-      gridref = "INVALID";
-      return;
+      static const char invalid[] = "INVALID";
+      copy(invalid, invalid + sizeof(invalid), gridref);
+      return int(sizeof(invalid)) - 1;
     }
-    char grid[2 + 2 * maxprec_];
+    char grid[MAXLENGTH];
     int
       xh = int(floor(x / tile_)),
       yh = int(floor(y / tile_));
@@ -86,37 +119,75 @@ namespace GeographicLib {
       }
     }
     int mlen = z + 2 * prec;
-    gridref.resize(mlen);
-    copy(grid, grid + mlen, gridref.begin());
+    copy(grid, grid + mlen, gridref);
+    gridref[mlen] = '\0';
+    return mlen;
+  }
+
+  void OSGB::GridReference(size_t n, const real x[], const real y[],
+                           int prec, char gridref[], size_t stride) {
+    // The longest string is either INVALID or the full grid reference.  If
+    // prec is out of range, the error will be signaled by the scalar
+    // version.
+    if (prec >= 0 && prec <= maxprec_ &&
+        !(stride > size_t(max(7, 2 + 2 * prec))))
+      throw GeographicErr("OSGB stride " + Utility::str(stride)
+                          + " too small for precision "
+                          + Utility::str(prec));
+    for (size_t i = 0; i < n; ++i)
+      GridReference(x[i], y[i], prec, gridref + i * stride);
   }
 
   void OSGB::GridReference(const std::string& gridref,
                            real& x, real& y, int& prec,
                            bool centerp) {
-    int
-      len = int(gridref.size()),
-      p = 0;
-    if (len >= 2 &&
+    GridReference(gridref.data(), int(gridref.size()), x, y, prec, centerp);
+  }
+
+  void OSGB::GridReference(const char gridref[],
+                           real& x, real& y, int& prec,
+                           bool centerp) {
+    GridReference(gridref, int(strlen(gridref)), x, y, prec, centerp);
+  }
+
+  void OSGB::GridReference(size_t n, const char gridref[], size_t stride,
+                           real x[], real y[], int prec[], bool centerp) {
+    for (size_t i = 0; i < n; ++i) {
+      const char* s = gridref + i * stride;
+      const char* e = find(s, s + stride, '\0');
+      GridReference(s, int(e - s), x[i], y[i], prec[i], centerp);
+    }
+  }
+
+  void OSGB::GridReference(const char* gridref, int slen,
+                           real& x, real& y, int& prec,
+                           bool centerp) {
+    // The strings used in the error messages are only constructed if an
+    // error is detected.
+    int p = 0;
+    if (slen >= 2 &&
         toupper(gridref[0]) == 'I' &&
         toupper(gridref[1]) == 'N') {
       x = y = Math::NaN();
       prec = -2;                // For compatibility with MGRS::Reverse.
       return;
     }
-    char grid[2 + 2 * maxprec_];
-    for (int i = 0; i < len; ++i) {
+    char grid[MAXLENGTH];
+    for (int i = 0; i < slen; ++i) {
       if (!isspace(gridref[i])) {
-        if (p >= 2 + 2 * maxprec_)
-          throw GeographicErr("OSGB string " + gridref + " too long");
+        if (p >= MAXLENGTH)
+          throw GeographicErr("OSGB string " + string(gridref, slen)
+                              + " too long");
         grid[p++] = gridref[i];
       }
     }
-    len = p;
+    int len = p;
     p = 0;
     if (len < 2)
-      throw GeographicErr("OSGB string " + gridref + " too short");
+      throw GeographicErr("OSGB string " + string(gridref, slen)
+                          + " too short");
     if (len % 2)
-      throw GeographicErr("OSGB string " + gridref +
+      throw GeographicErr("OSGB string " + string(gridref, slen) +
                           " has odd number of characters");
     int
       xh = 0,
@@ -124,7 +195,8 @@ namespace GeographicLib {
     while (p < 2) {
       int i = Utility::lookup(letters_, grid[p++]);
       if (i < 0)
-        throw GeographicErr("Illegal prefix character " + gridref);
+        throw GeographicErr("Illegal prefix character "
+                            + string(gridref, slen));
       yh = yh * tilegrid_ + tilegrid_ - (i / tilegrid_) - 1;
       xh = xh * tilegrid_ + (i % tilegrid_);
     }
@@ -142,7 +214,8 @@ namespace GeographicLib {
         ix = Utility::lookup(digits_, grid[p + i]),
         iy = Utility::lookup(digits_, grid[p + i + prec1]);
       if (ix < 0 || iy < 0)
-        throw GeographicErr("Encountered a non-digit in " + gridref);
+        throw GeographicErr("Encountered a non-digit in "
+                            + string(gridref, slen));
       x1 += unit * ix;
       y1 += unit * iy;
     }
@@ -0,0 +1,197 @@
+/**
+ * \file PointInPolygon.cpp
+ * \brief Implementation for GeographicLib::PointInPolygon class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PointInPolygon.hpp>
+#include <GeographicLib/Accumulator.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  PointInPolygon::PointInPolygon(const Geodesic& geod,
+                                 size_t n, const real lat[], const real lon[])
+    : _geod(geod)
+    , _inter(_geod)
+    , _area(0)
+    , _latmin(Math::qd)
+    , _latmax(-Math::qd)
+    , _lonmin(-Math::hd)
+    , _lonmax(Math::hd)
+    , _north(false)
+    , _south(false)
+  {
+    const unsigned outmask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE;
+    real f = _geod.Flattening();
+    // The sum of S12 and of the longitude differences around the polygon
+    Accumulator<> areasum, lonsum;
+    // The longitudes of the two ends of each piece
+    vector<real> key1, key2;
+    // The range of the unrolled longitude around the polygon
+    real lonu = n ? lon[0] : 0, lonumin = lonu, lonumax = lonu;
+    _edges.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      size_t i2 = i + 1 < n ? i + 1 : 0;
+      real S12, t;
+      _geod.GenInverse(lat[i], lon[i], lat[i2], lon[i2], Geodesic::AREA,
+                       t, t, t, t, t, t, S12);
+      areasum += S12;
+      _edges.push_back(_geod.InverseLine(lat[i], lon[i], lat[i2], lon[i2],
+                                         Intersect::LineCaps));
+      const GeodesicLine& l = _edges.back();
+      // The latitude of the vertex of the geodesic (the maximum |lat|)
+      real salp0, calp0, a12 = l.Arc();
+      Math::sincosd(l.EquatorialAzimuth(), salp0, calp0);
+      real latv = Math::atan2d(fabs(calp0), (1 - f) * fabs(salp0));
+      int np = max(1, int(ceil(a12 / maxarc_)));
+      real lat1 = lat[i], lon1 = lon[i], azi1 = l.Azimuth(), x1 = 0;
+      for (int k = 1; k <= np; ++k) {
+        real lat2, lon2, azi2, x2;
+        l.GenPosition(true, k * a12 / np, outmask,
+                      lat2, lon2, azi2, x2, t, t, t, t);
+        if (k == np) {
+          // Use the vertex itself so that adjacent edges share this end.
+          lat2 = lat[i2]; lon2 = lon[i2]; x2 = l.Distance();
+        }
+        piece p;
+        p.lon1 = lon1;
+        p.lon12 = Math::AngDiff(lon1, lon2);
+        lonsum += p.lon12;
+        p.latmin = fmin(lat1, lat2); p.latmax = fmax(lat1, lat2);
+        // The piece includes the vertex if the geodesic turns from heading
+        // north to heading south or vice versa.
+        if (fabs(azi1) < Math::qd && fabs(azi2) > Math::qd)
+          p.latmax = latv;
+        else if (fabs(azi1) > Math::qd && fabs(azi2) < Math::qd)
+          p.latmin = -latv;
+        p.x1 = x1; p.x2 = x2;
+        p.edge = i;
+        _latmin = fmin(_latmin, p.latmin); _latmax = fmax(_latmax, p.latmax);
+        lonu += p.lon12;
+        lonumin = fmin(lonumin, lonu); lonumax = fmax(lonumax, lonu);
+        // A piece on a meridian never crosses a meridian.
+        if (p.lon12 != 0) {
+          _pieces.push_back(p);
+          key1.push_back(Key(lon1)); key2.push_back(Key(lon2));
+        }
+        lat1 = lat2; lon1 = lon2; azi1 = azi2; x1 = x2;
+      }
+    }
+    // The interior is the smaller region bounded by the edges.  The region to
+    // the left of the edges contains the north pole if the net change in
+    // longitude is +360; if the change is zero, it contains both poles if
+    // the sum of S12 (which is then the area of the region not containing
+    // the poles, positive if the edges go clockwise around it) is positive.
+    {
+      PolygonArea poly(_geod);
+      for (size_t i = 0; i < n; ++i)
+        poly.AddPoint(lat[i], lon[i]);
+      real perimeter, area, area0 = _geod.EllipsoidArea();
+      poly.Compute(false, false, perimeter, area);
+      bool leftin = area <= area0 / 2;
+      _area = leftin ? area : area0 - area;
+      int winding = int(round(lonsum() / Math::td));
+      bool northleft = winding > 0 || (winding == 0 && areasum() > 0);
+      _north = northleft == leftin;
+      // A meridian from pole to pole crosses the boundary winding times
+      // (mod 2).
+      _south = _north != (winding % 2 != 0);
+    }
+    // The longitude on each piece varies monotonically between its ends, so
+    // the unrolled longitudes of the ends give the longitude range unless
+    // the polygon contains a pole.
+    if (_north) _latmax = Math::qd;
+    if (_south) _latmin = -Math::qd;
+    if (!(_north || _south) && lonumax - lonumin < Math::td) {
+      _lonmin = Key(lonumin);
+      _lonmax = _lonmin + (lonumax - lonumin);
+    }
+    // Build the slabs
+    _slabs.reserve(2 * key1.size());
+    _slabs.insert(_slabs.end(), key1.begin(), key1.end());
+    _slabs.insert(_slabs.end(), key2.begin(), key2.end());
+    sort(_slabs.begin(), _slabs.end());
+    _slabs.erase(unique(_slabs.begin(), _slabs.end()), _slabs.end());
+    size_t m = _slabs.size(), np = _pieces.size();
+    // Piece j crosses the slabs s[j], s[j]+1, ..., e[j]-1 (cyclically).
+    vector<size_t> s(np), e(np);
+    for (size_t j = 0; j < np; ++j) {
+      real lo = _pieces[j].lon12 > 0 ? key1[j] : key2[j],
+        hi = _pieces[j].lon12 > 0 ? key2[j] : key1[j];
+      s[j] = lower_bound(_slabs.begin(), _slabs.end(), lo) - _slabs.begin();
+      e[j] = lower_bound(_slabs.begin(), _slabs.end(), hi) - _slabs.begin();
+    }
+    _slabstart.assign(m + 1, 0);
+    for (size_t j = 0; j < np; ++j)
+      for (size_t k = s[j]; k != e[j]; k = k + 1 < m ? k + 1 : 0)
+        ++_slabstart[k + 1];
+    for (size_t k = 0; k < m; ++k)
+      _slabstart[k + 1] += _slabstart[k];
+    _slabpieces.resize(m ? _slabstart[m] : 0);
+    vector<size_t> next(_slabstart.begin(), _slabstart.end());
+    for (size_t j = 0; j < np; ++j)
+      for (size_t k = s[j]; k != e[j]; k = k + 1 < m ? k + 1 : 0)
+        _slabpieces[next[k]++] = j;
+  }
+
+  bool PointInPolygon::Contains(real lat, real lon, const Intersect& inter)
+    const {
+    if (!(fabs(lat) <= Math::qd)) return false;
+    if (_slabs.empty()) return _north;
+    real q = Key(lon);
+    size_t j = upper_bound(_slabs.begin(), _slabs.end(), q) - _slabs.begin();
+    // A longitude before the first boundary is in the last slab which wraps
+    // around to the first boundary.
+    j = (j > 0 ? j : _slabs.size()) - 1;
+    bool inside = _north;
+    GeodesicLine meridian;
+    for (size_t k = _slabstart[j]; k < _slabstart[j + 1]; ++k) {
+      const piece& p = _pieces[_slabpieces[k]];
+      if (lat > p.latmax) continue; // The piece is south of the point
+      if (lat >= p.latmin) {
+        // Find the crossing of the piece and the meridian northwards from
+        // the point starting from an estimate obtained by interpolating the
+        // longitude.
+        if (!meridian.Init())
+          meridian = _geod.Line(lat, lon, 0, Intersect::LineCaps);
+        real t = fmin(fmax(Math::AngDiff(p.lon1, lon) / p.lon12, real(0)),
+                      real(1)),
+          x0 = p.x1 + t * (p.x2 - p.x1);
+        if (!(inter.Closest(_edges[p.edge], meridian,
+                            Intersect::Point(x0, 0)).second > 0))
+          continue;
+      }
+      inside = !inside;
+    }
+    return inside;
+  }
+
+  void PointInPolygon::Contains(size_t n, const real lat[], const real lon[],
+                                bool inside[], int nthreads) const {
+    nthreads = int(min(size_t(max(nthreads, 1)), max(n, size_t(1))));
+    if (nthreads == 1) {
+      for (size_t i = 0; i < n; ++i)
+        inside[i] = Contains(lat[i], lon[i], _inter);
+      return;
+    }
+    // Each task gets a private copy of the Intersect object so that the
+    // tasks don't contend for its (mutable) counters.  Task t handles the
+    // points [n*t/nthreads, n*(t+1)/nthreads).
+    vector<Intersect> inters(nthreads, _inter);
+    auto worker = [&](int t) -> void {
+      for (size_t i = n * t / nthreads; i < n * (t + 1) / nthreads; ++i)
+        inside[i] = Contains(lat[i], lon[i], inters[t]);
+    };
+    Executor::Batch(nthreads, worker);
+  }
+
+} // namespace GeographicLib
@@ -66,38 +66,96 @@ namespace GeographicLib {
   void PolarStereographic::Forward(bool northp, real lat, real lon,
                                    real& x, real& y,
                                    real& gamma, real& k) const {
+    ForwardPoint(northp, lat, lon, x, y, &gamma, &k);
+  }
+
+  void PolarStereographic::ForwardPoint(bool northp, real lat, real lon,
+                                        real& x, real& y,
+                                        real* gamma, real* k) const {
     lat = Math::LatFix(lat);
     lat *= northp ? 1 : -1;
     real
       tau = Math::tand(lat),
-      secphi = hypot(real(1), tau),
       taup = Math::taupf(tau, _es),
       rho = hypot(real(1), taup) + fabs(taup);
     rho = taup >= 0 ? (lat != Math::qd ? 1/rho : 0) : rho;
     rho *= 2 * _k0 * _a / _c;
-    k = lat != Math::qd ?
-      (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::_sq(secphi)) : _k0;
+    if (k) {
+      real secphi = hypot(real(1), tau);
+      *k = lat != Math::qd ?
+        (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::_sq(secphi)) : _k0;
+    }
     Math::sincosd(lon, x, y);
     x *= rho;
     y *= (northp ? -rho : rho);
-    gamma = Math::AngNormalize(northp ? lon : -lon);
+    if (gamma) *gamma = Math::AngNormalize(northp ? lon : -lon);
   }
 
   void PolarStereographic::Reverse(bool northp, real x, real y,
                                    real& lat, real& lon,
                                    real& gamma, real& k) const {
+    ReversePoint(northp, x, y, lat, lon, &gamma, &k);
+  }
+
+  void PolarStereographic::ReversePoint(bool northp, real x, real y,
+                                        real& lat, real& lon,
+                                        real* gamma, real* k) const {
     real
       rho = hypot(x, y),
       t = rho != 0 ? rho / (2 * _k0 * _a / _c) :
       Math::_sq(numeric_limits<real>::epsilon()),
       taup = (1 / t - t) / 2,
-      tau = Math::tauf(taup, _es),
-      secphi = hypot(real(1), tau);
-    k = rho != 0 ? (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::_sq(secphi)) :
-      _k0;
+      tau = Math::tauf(taup, _es);
+    if (k) {
+      real secphi = hypot(real(1), tau);
+      *k = rho != 0 ?
+        (rho / _a) * secphi * sqrt(_e2m + _e2 / Math::_sq(secphi)) : _k0;
+    }
     lat = (northp ? 1 : -1) * Math::atand(tau);
     lon = Math::atan2d(x, northp ? -y : y );
-    gamma = Math::AngNormalize(northp ? lon : -lon);
+    if (gamma) *gamma = Math::AngNormalize(northp ? lon : -lon);
+  }
+
+  void PolarStereographic::Forward(bool northp, size_t n,
+                                   const real lat[], const real lon[],
+                                   real x[], real y[],
+                                   real gamma[], real k[]) const {
+    for (size_t i = 0; i < n; ++i)
+      ForwardPoint(northp, lat[i], lon[i], x[i], y[i],
+                   gamma ? gamma + i : nullptr, k ? k + i : nullptr);
+  }
+
+  void PolarStereographic::Reverse(bool northp, size_t n,
+                                   const real x[], const real y[],
+                                   real lat[], real lon[],
+                                   real gamma[], real k[]) const {
+    // The same steps as the scalar Reverse with tau computed for a block of
+    // points at a time.
+    real rho[block_], tau[block_];
+    for (size_t i0 = 0; i0 < n; i0 += block_) {
+      size_t m = min(size_t(block_), n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        rho[j] = hypot(x[i], y[i]);
+        real t = rho[j] != 0 ? rho[j] / (2 * _k0 * _a / _c) :
+          Math::_sq(numeric_limits<real>::epsilon());
+        tau[j] = (1 / t - t) / 2;
+      }
+      Math::tauf(m, tau, _es, tau);
+      for (size_t j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        real
+          secphi = hypot(real(1), tau[j]),
+          lonx = Math::atan2d(x[i], northp ? -y[i] : y[i]);
+        if (k)
+          k[i] = rho[j] != 0 ?
+            (rho[j] / _a) * secphi * sqrt(_e2m + _e2 / Math::_sq(secphi)) :
+            _k0;
+        if (gamma) gamma[i] = Math::AngNormalize(northp ? lonx : -lonx);
+        lat[i] = (northp ? 1 : -1) * Math::atand(tau[j]);
+        lon[i] = lonx;
+      }
+    }
   }
 
   void PolarStereographic::SetScale(real lat, real k) {
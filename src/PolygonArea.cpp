@@ -8,6 +8,9 @@
  **********************************************************************/
 
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
+#include <vector>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -84,6 +87,109 @@ namespace GeographicLib {
     ++_num;
   }
 
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::AddPoints(size_t n,
+                                         const real lat[], const real lon[],
+                                         int nthreads) {
+    if (n == 0) return;
+    size_t i0 = 0;
+    if (_num == 0) {
+      AddPoint(lat[0], lon[0]);
+      i0 = 1;
+    }
+    // The number of edges in a block
+    const size_t nb = 16384;
+    nthreads = max(1, nthreads);
+    vector<real> s12(min(nb, n - i0)), S12(_polyline ? 0 : s12.size());
+    while (i0 < n) {
+      size_t m = min(nb, n - i0);
+      int nt = int(min(size_t(nthreads), m));
+      // Task t computes edges [m*t/nt, m*(t+1)/nt); edge j ends at point
+      // i0+j.
+      auto worker = [&](int t) -> void {
+        real lat1, lon1, t1;
+        for (size_t j = m * t / nt; j < m * (t + 1) / nt; ++j) {
+          if (j == 0) { lat1 = _lat1; lon1 = _lon1; }
+          else        { lat1 = lat[i0 + j - 1]; lon1 = lon[i0 + j - 1]; }
+          _earth.GenInverse(lat1, lon1, lat[i0 + j], lon[i0 + j], _mask,
+                            s12[j], t1, t1, t1, t1, t1,
+                            _polyline ? t1 : S12[j]);
+        }
+      };
+      Executor::Batch(nt, worker);
+      // Accumulate in the same order as AddPoint
+      for (size_t j = 0; j < m; ++j) {
+        _perimetersum += s12[j];
+        if (!_polyline) {
+          _areasum += S12[j];
+          _crossings += transit(_lon1, lon[i0 + j]);
+        }
+        _lat1 = lat[i0 + j]; _lon1 = lon[i0 + j];
+      }
+      _num += unsigned(m);
+      i0 += m;
+    }
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::Ring(size_t n,
+                                    const real lat[], const real lon[],
+                                    bool reverse, bool sign,
+                                    real& perimeter, real& area) const {
+    // This follows the sequence of operations in AddPoint and Compute.
+    if (n < 2) {
+      perimeter = 0;
+      if (!_polyline)
+        area = 0;
+      return;
+    }
+    Accumulator<> perimetersum(0), areasum(0);
+    int crossings = 0;
+    real s12, S12, t;
+    for (size_t i = 1; i < n; ++i) {
+      _earth.GenInverse(lat[i - 1], lon[i - 1], lat[i], lon[i], _mask,
+                        s12, t, t, t, t, t, S12);
+      perimetersum += s12;
+      if (!_polyline) {
+        areasum += S12;
+        crossings += transit(lon[i - 1], lon[i]);
+      }
+    }
+    if (_polyline) {
+      perimeter = perimetersum();
+      return;
+    }
+    _earth.GenInverse(lat[n - 1], lon[n - 1], lat[0], lon[0], _mask,
+                      s12, t, t, t, t, t, S12);
+    perimeter = perimetersum(s12);
+    areasum += S12;
+    crossings += transit(lon[n - 1], lon[0]);
+    AreaReduce(areasum, crossings, reverse, sign);
+    area = real(0) + areasum();
+  }
+
+  template<class GeodType>
+  void PolygonAreaT<GeodType>::Rings(size_t nrings, const size_t offsets[],
+                                     const real lat[], const real lon[],
+                                     bool reverse, bool sign,
+                                     real perimeter[], real area[],
+                                     int nthreads) const {
+    // The rings are handed out to the tasks in chunks.
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      for (size_t k0; (k0 = next.fetch_add(chunk)) < nrings;)
+        for (size_t k = k0; k < min(nrings, k0 + chunk); ++k) {
+          real t;
+          Ring(offsets[k + 1] - offsets[k],
+               lat + offsets[k], lon + offsets[k], reverse, sign,
+               perimeter[k], _polyline ? t : area[k]);
+        }
+    };
+    int nt = int(min(size_t(max(1, nthreads)), (nrings + chunk - 1) / chunk));
+    Executor::Batch(nt, worker);
+  }
+
   template<class GeodType>
   void PolygonAreaT<GeodType>::AddEdge(real azi, real s) {
     if (_num) {                 // Do nothing if _num is zero
@@ -162,6 +268,54 @@ namespace GeographicLib {
     return num;
   }
 
+  template<class GeodType>
+  unsigned PolygonAreaT<GeodType>::TestPoints(size_t n,
+                                              const real lat[],
+                                              const real lon[],
+                                              bool reverse, bool sign,
+                                              real perimeter[], real area[],
+                                              int nthreads) const {
+    if (_num == 0) {
+      for (size_t i = 0; i < n; ++i) {
+        perimeter[i] = 0;
+        if (!_polyline)
+          area[i] = 0;
+      }
+      return 1;
+    }
+    // This follows the sequence of operations in TestPoint with the sums
+    // for the current polygon computed once.
+    const real perimeter0 = _perimetersum(),
+      area0 = _polyline ? 0 : _areasum();
+    int nt = int(min(size_t(max(1, nthreads)), max(n, size_t(1))));
+    // Task t handles points [n*t/nt, n*(t+1)/nt).
+    auto worker = [&](int t) -> void {
+      for (size_t j = n * t / nt; j < n * (t + 1) / nt; ++j) {
+        real perimeterx = perimeter0, tempsum = area0;
+        int crossings = _crossings;
+        for (int i = 0; i < (_polyline ? 1 : 2); ++i) {
+          real s12, S12, t1;
+          _earth.GenInverse(i == 0 ? _lat1 : lat[j], i == 0 ? _lon1 : lon[j],
+                            i != 0 ? _lat0 : lat[j], i != 0 ? _lon0 : lon[j],
+                            _mask, s12, t1, t1, t1, t1, t1, S12);
+          perimeterx += s12;
+          if (!_polyline) {
+            tempsum += S12;
+            crossings += transit(i == 0 ? _lon1 : lon[j],
+                                 i != 0 ? _lon0 : lon[j]);
+          }
+        }
+        perimeter[j] = perimeterx;
+        if (!_polyline) {
+          AreaReduce(tempsum, crossings, reverse, sign);
+          area[j] = real(0) + tempsum;
+        }
+      }
+    };
+    Executor::Batch(nt, worker);
+    return _num + 1;
+  }
+
   template<class GeodType>
   unsigned PolygonAreaT<GeodType>::TestEdge(real azi, real s,
                                             bool reverse, bool sign,
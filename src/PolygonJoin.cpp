@@ -0,0 +1,165 @@
+/**
+ * \file PolygonJoin.cpp
+ * \brief Implementation for GeographicLib::PolygonJoin class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PolygonJoin.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
+#include <limits>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  PolygonJoin::PolygonJoin(const Geodesic& geod, size_t npolys,
+                           const size_t start[],
+                           const real lat[], const real lon[])
+    : _geod(geod)
+    , _inter(_geod)
+    , _nrows(1)
+    , _ncols(2)
+    , _h(Math::hd)
+  {
+    if (npolys >= size_t(numeric_limits<int>::max()))
+      throw GeographicErr("Too many polygons");
+    _polys.reserve(npolys);
+    _bounds.resize(4 * npolys);
+    vector<real> size(npolys);
+    for (size_t k = 0; k < npolys; ++k) {
+      if (!(start[k] <= start[k + 1]))
+        throw GeographicErr("Polygon offsets are not nondecreasing");
+      _polys.emplace_back(_geod, start[k + 1] - start[k],
+                          lat + start[k], lon + start[k]);
+      real* b = &_bounds[4 * k];
+      _polys.back().Bounds(b[0], b[1], b[2], b[3]);
+      size[k] = fmax(b[1] - b[0], b[3] - b[2]);
+    }
+    if (npolys > 0) {
+      // The cell size is the median size of the bounding boxes
+      nth_element(size.begin(), size.begin() + npolys/2, size.end());
+      real h = fmax(size[npolys/2], Math::hd / maxrows_);
+      _nrows = min(int(maxrows_), max(1, int(ceil(Math::hd / h))));
+      _ncols = 2 * _nrows;
+      _h = Math::hd / real(_nrows);
+    }
+    // Each polygon is entered into the cells overlapped by its box; the box
+    // covers columns c0, c0+1, ..., c0+nc-1 (cyclically) of rows r0..r1.
+    vector<int> r0(npolys), r1(npolys), c0(npolys), nc(npolys);
+    for (size_t k = 0; k < npolys; ++k) {
+      const real* b = &_bounds[4 * k];
+      r0[k] = Row(b[0]); r1[k] = Row(b[1]);
+      c0[k] = Col(b[2]);
+      // b[3] may exceed 180, so the last column isn't reduced to [0, ncols)
+      nc[k] = b[3] - b[2] >= Math::td ? _ncols :
+        min(_ncols, int((b[3] + Math::hd) / _h) - c0[k] + 1);
+      if ((long long)(r1[k] - r0[k] + 1) * nc[k] > maxcells_) {
+        _large.push_back(int(k));
+        nc[k] = 0;
+      }
+    }
+    size_t ncells = size_t(_nrows) * size_t(_ncols);
+    _cellstart.assign(ncells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass) {
+      vector<size_t> next(pass ? _cellstart : vector<size_t>());
+      for (size_t k = 0; k < npolys; ++k)
+        for (int r = r0[k]; nc[k] && r <= r1[k]; ++r)
+          for (int i = 0; i < nc[k]; ++i) {
+            size_t cell = size_t(r) * _ncols + (c0[k] + i) % _ncols;
+            if (pass)
+              _cellpolys[next[cell]++] = int(k);
+            else
+              ++_cellstart[cell + 1];
+          }
+      if (!pass) {
+        for (size_t j = 0; j < ncells; ++j)
+          _cellstart[j + 1] += _cellstart[j];
+        _cellpolys.resize(_cellstart[ncells]);
+      }
+    }
+  }
+
+  long long PolygonJoin::Cell(real lat, real lon) const {
+    if (!(fabs(lat) <= Math::qd) || !isfinite(lon)) return -1;
+    return (long long)(Row(lat)) * _ncols + Col(PointInPolygon::Key(lon));
+  }
+
+  bool PolygonJoin::InBox(int k, real lat, real lon) const {
+    const real* b = &_bounds[4 * k];
+    if (!(lat >= b[0] && lat <= b[1])) return false;
+    real t = PointInPolygon::Key(lon) - b[2];
+    if (t < 0) t += Math::td;
+    return t <= b[3] - b[2];
+  }
+
+  int PolygonJoin::Find(real lat, real lon, long long cell,
+                        const Intersect& inter) const {
+    if (cell < 0) return -1;
+    int found = -1;
+    for (size_t j = _cellstart[cell]; j < _cellstart[cell + 1]; ++j) {
+      int k = _cellpolys[j];
+      if (InBox(k, lat, lon) && _polys[k].Contains(lat, lon, inter)) {
+        found = k;
+        break;
+      }
+    }
+    for (int k : _large) {
+      if (found >= 0 && k > found) break;
+      if (InBox(k, lat, lon) && _polys[k].Contains(lat, lon, inter))
+        return k;
+    }
+    return found;
+  }
+
+  void PolygonJoin::FindAll(real lat, real lon, vector<int>& polys) const {
+    polys.clear();
+    long long cell = Cell(lat, lon);
+    if (cell < 0) return;
+    for (size_t j = _cellstart[cell]; j < _cellstart[cell + 1]; ++j) {
+      int k = _cellpolys[j];
+      if (InBox(k, lat, lon) && _polys[k].Contains(lat, lon, _inter))
+        polys.push_back(k);
+    }
+    size_t m = polys.size();
+    for (int k : _large)
+      if (InBox(k, lat, lon) && _polys[k].Contains(lat, lon, _inter))
+        polys.push_back(k);
+    inplace_merge(polys.begin(), polys.begin() + m, polys.end());
+  }
+
+  void PolygonJoin::Find(size_t n, const real lat[], const real lon[],
+                         int poly[], int nthreads) const {
+    // Sort the points by cell with a counting sort; the invalid points are
+    // put in an extra last cell.
+    size_t ncells = size_t(_nrows) * size_t(_ncols);
+    vector<long long> cell(n);
+    vector<size_t> count(ncells + 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      cell[i] = Cell(lat[i], lon[i]);
+      ++count[(cell[i] < 0 ? ncells : size_t(cell[i])) + 1];
+    }
+    for (size_t j = 0; j <= ncells; ++j)
+      count[j + 1] += count[j];
+    vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i)
+      order[count[cell[i] < 0 ? ncells : size_t(cell[i])]++] = i;
+    // The sorted points are handed out to the tasks in chunks.
+    const size_t chunk = 256;
+    int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+    vector<Intersect> inters(max(nt, 1), _inter);
+    atomic<size_t> next(0);
+    auto worker = [&](int t) -> void {
+      for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+        for (size_t l = i0; l < min(n, i0 + chunk); ++l) {
+          size_t i = order[l];
+          poly[i] = Find(lat[i], lon[i], cell[i], inters[t]);
+        }
+    };
+    Executor::Batch(nt, worker);
+  }
+
+} // namespace GeographicLib
@@ -0,0 +1,172 @@
+/**
+ * \file PolylineSimplifier.cpp
+ * \brief Implementation for GeographicLib::PolylineSimplifier class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/PolylineSimplifier.hpp>
+#include <GeographicLib/ClosestPoint.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  namespace {
+    // Call f(t, i) for i in [0, n) handing out the indices in chunks to at
+    // most nthreads tasks; t is the task number.
+    template<class F>
+    void ForEach(size_t n, int nthreads, const F& f) {
+      const size_t chunk = 64;
+      atomic<size_t> next(0);
+      auto worker = [&](int t) -> void {
+        for (size_t i0; (i0 = next.fetch_add(chunk)) < n;)
+          for (size_t i = i0; i < min(n, i0 + chunk); ++i)
+            f(t, i);
+      };
+      int nt = int(min(size_t(max(1, nthreads)), (n + chunk - 1) / chunk));
+      Executor::Batch(nt, worker);
+    }
+
+    void CheckLatitudes(size_t n, const Math::real lat[]) {
+      for (size_t i = 0; i < n; ++i)
+        if (!(fabs(lat[i]) <= Math::qd))
+          throw GeographicErr("Latitude not in [-" + to_string(Math::qd)
+                              + "d, " + to_string(Math::qd) + "d]");
+    }
+  }
+
+  void PolylineSimplifier::DouglasPeucker(size_t n,
+                                          const real lat[], const real lon[],
+                                          real tol, vector<size_t>& keep,
+                                          int nthreads) const {
+    if (!(tol >= 0))
+      throw GeographicErr("Tolerance must be nonnegative");
+    CheckLatitudes(n, lat);
+    keep.clear();
+    if (n <= 2) {
+      for (size_t i = 0; i < n; ++i) keep.push_back(i);
+      return;
+    }
+    const unsigned caps = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+      Geodesic::AZIMUTH | Geodesic::DISTANCE_IN;
+    vector<char> kept(n, 0);
+    kept[0] = kept[n - 1] = 1;
+    // The unresolved sections, each given by the indices of its ends
+    vector<pair<size_t, size_t>> sect(1, make_pair(size_t(0), n - 1)),
+      nextsect;
+    vector<GeodesicLine> lines;
+    // The interior vertices of the sections and the sections they belong to
+    vector<size_t> vert, owner;
+    vector<real> dev(n);
+    while (!sect.empty()) {
+      lines.resize(sect.size());
+      vert.clear(); owner.clear();
+      for (size_t k = 0; k < sect.size(); ++k)
+        for (size_t v = sect[k].first + 1; v < sect[k].second; ++v) {
+          vert.push_back(v); owner.push_back(k);
+        }
+      ForEach(sect.size(), nthreads, [&](int, size_t k) -> void {
+        size_t i = sect[k].first, j = sect[k].second;
+        lines[k] = _geod.InverseLine(lat[i], lon[i], lat[j], lon[j], caps);
+      });
+      ForEach(vert.size(), nthreads, [&](int, size_t l) -> void {
+        size_t v = vert[l], k = owner[l],
+          i = sect[k].first, j = sect[k].second;
+        // Start the iteration at the proportional distance along the segment
+        real s0 = lines[k].Distance() * real(v - i) / real(j - i),
+          s, cross, latc, lonc;
+        ClosestPoint::ClosestOnSegment(_geod, lines[k], lat[v], lon[v], s0,
+                                       s, cross, latc, lonc);
+        dev[v] = fabs(cross);
+      });
+      nextsect.clear();
+      for (const auto& sc : sect) {
+        size_t i = sc.first, j = sc.second, vmax = i + 1;
+        for (size_t v = i + 2; v < j; ++v)
+          if (dev[v] > dev[vmax]) vmax = v;
+        if (dev[vmax] > tol) {
+          kept[vmax] = 1;
+          if (vmax - i >= 2) nextsect.push_back(make_pair(i, vmax));
+          if (j - vmax >= 2) nextsect.push_back(make_pair(vmax, j));
+        }
+      }
+      swap(sect, nextsect);
+    }
+    for (size_t i = 0; i < n; ++i)
+      if (kept[i]) keep.push_back(i);
+  }
+
+  void PolylineSimplifier::Visvalingam(size_t n,
+                                       const real lat[], const real lon[],
+                                       real area, vector<size_t>& keep,
+                                       int nthreads) const {
+    if (!(area >= 0))
+      throw GeographicErr("Threshold area must be nonnegative");
+    CheckLatitudes(n, lat);
+    keep.clear();
+    if (n <= 2) {
+      for (size_t i = 0; i < n; ++i) keep.push_back(i);
+      return;
+    }
+    // The area of the triangle with vertices a, b, c
+    auto triangle = [lat, lon](PolygonArea& poly,
+                               size_t a, size_t b, size_t c) -> real {
+      poly.Clear();
+      poly.AddPoint(lat[a], lon[a]);
+      poly.AddPoint(lat[b], lon[b]);
+      poly.AddPoint(lat[c], lon[c]);
+      real perim, A;
+      poly.Compute(false, true, perim, A);
+      return fabs(A);
+    };
+    vector<size_t> prev(n), next(n);
+    for (size_t i = 0; i < n; ++i) {
+      prev[i] = i - 1; next[i] = i + 1;
+    }
+    vector<real> eff(n);
+    {
+      vector<PolygonArea> polys(max(1, nthreads), PolygonArea(_geod));
+      ForEach(n - 2, nthreads, [&](int t, size_t l) -> void {
+        size_t i = l + 1;
+        eff[i] = triangle(polys[t], i - 1, i, i + 1);
+      });
+    }
+    // A min heap of the effective areas; the entries superseded by a later
+    // update are skipped when they reach the top.
+    typedef pair<real, size_t> item;
+    priority_queue<item, vector<item>, greater<item>> heap;
+    for (size_t i = 1; i + 1 < n; ++i)
+      heap.push(make_pair(eff[i], i));
+    vector<char> removed(n, 0);
+    PolygonArea poly(_geod);
+    while (!heap.empty()) {
+      item top = heap.top();
+      heap.pop();
+      size_t i = top.second;
+      if (removed[i] || top.first != eff[i]) continue;
+      if (!(top.first < area)) break;
+      removed[i] = 1;
+      size_t p = prev[i], q = next[i];
+      next[p] = q; prev[q] = p;
+      for (size_t j : {p, q}) {
+        if (j == 0 || j == n - 1) continue;
+        eff[j] = fmax(triangle(poly, prev[j], j, next[j]), top.first);
+        heap.push(make_pair(eff[j], j));
+      }
+    }
+    for (size_t i = 0; i < n; ++i)
+      if (!removed[i]) keep.push_back(i);
+  }
+
+} // namespace GeographicLib
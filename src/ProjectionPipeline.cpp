@@ -0,0 +1,336 @@
+/**
+ * \file ProjectionPipeline.cpp
+ * \brief Implementation for GeographicLib::ProjectionPipeline class
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/ProjectionPipeline.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  typedef ProjectionPipeline::System System;
+
+  System System::Geographic() {
+    return System(GEOGRAPHIC);
+  }
+
+  System System::UTMUPS(int zone, bool northp) {
+    if (!(zone >= GeographicLib::UTMUPS::MINZONE &&
+          zone <= GeographicLib::UTMUPS::MAXZONE))
+      throw GeographicErr("Zone " + Utility::str(zone)
+                          + " not in range [0, 60]");
+    System s(UTMUPSZONE);
+    s._zone = zone;
+    s._northp = northp;
+    return s;
+  }
+
+  System
+  System::TransverseMercator(const GeographicLib::TransverseMercator& tm,
+                             real lon0) {
+    System s(TRANSVERSEMERCATOR);
+    s._tm = make_shared<const GeographicLib::TransverseMercator>(tm);
+    s._lon0 = lon0;
+    return s;
+  }
+
+  System
+  System::PolarStereographic(const GeographicLib::PolarStereographic& ps,
+                             bool northp) {
+    System s(POLARSTEREOGRAPHIC);
+    s._ps = make_shared<const GeographicLib::PolarStereographic>(ps);
+    s._northp = northp;
+    return s;
+  }
+
+  System
+  System::LambertConformalConic(const GeographicLib::LambertConformalConic&
+                                lcc, real lon0) {
+    System s(LAMBERTCONFORMALCONIC);
+    s._lcc = make_shared<const GeographicLib::LambertConformalConic>(lcc);
+    s._lon0 = lon0;
+    return s;
+  }
+
+  System System::AlbersEqualArea(const GeographicLib::AlbersEqualArea& aea,
+                                 real lon0) {
+    System s(ALBERSEQUALAREA);
+    s._aea = make_shared<const GeographicLib::AlbersEqualArea>(aea);
+    s._lon0 = lon0;
+    return s;
+  }
+
+  System System::LocalCartesian(const GeographicLib::LocalCartesian& lc) {
+    System s(LOCALCARTESIAN);
+    s._lc = make_shared<const GeographicLib::LocalCartesian>(lc);
+    return s;
+  }
+
+  System System::Geocentric(const GeographicLib::Geocentric& earth) {
+    System s(GEOCENTRIC);
+    s._geo = make_shared<const GeographicLib::Geocentric>(earth);
+    return s;
+  }
+
+  void System::Ellipsoid(real& a, real& f) const {
+    if (_kind == LOCALCARTESIAN) {
+      a = _lc->EquatorialRadius(); f = _lc->Flattening();
+    } else {
+      a = _geo->EquatorialRadius(); f = _geo->Flattening();
+    }
+  }
+
+  bool System::Same(const System& s) const {
+    // Systems from the same object (or copies of it) with the same
+    // parameters are the same; no attempt is made to detect equivalent
+    // objects constructed separately.
+    return _kind == s._kind && _zone == s._zone && _northp == s._northp &&
+      _lon0 == s._lon0 &&
+      _tm == s._tm && _ps == s._ps && _lcc == s._lcc && _aea == s._aea &&
+      _lc == s._lc && _geo == s._geo;
+  }
+
+  void System::Reverse(real x, real y, real z,
+                       real& lat, real& lon, real& h) const {
+    h = z;
+    switch (_kind) {
+    case GEOGRAPHIC:
+      lat = x; lon = y;
+      break;
+    case UTMUPSZONE:
+      GeographicLib::UTMUPS::Reverse(_zone, _northp, x, y, lat, lon);
+      break;
+    case TRANSVERSEMERCATOR:
+      _tm->Reverse(_lon0, x, y, lat, lon);
+      break;
+    case POLARSTEREOGRAPHIC:
+      _ps->Reverse(_northp, x, y, lat, lon);
+      break;
+    case LAMBERTCONFORMALCONIC:
+      _lcc->Reverse(_lon0, x, y, lat, lon);
+      break;
+    case ALBERSEQUALAREA:
+      _aea->Reverse(_lon0, x, y, lat, lon);
+      break;
+    case LOCALCARTESIAN:
+      _lc->Reverse(x, y, z, lat, lon, h);
+      break;
+    default:                    // GEOCENTRIC
+      _geo->Reverse(x, y, z, lat, lon, h);
+      break;
+    }
+  }
+
+  void System::Forward(real lat, real lon, real h,
+                       real& x, real& y, real& z) const {
+    z = h;
+    switch (_kind) {
+    case GEOGRAPHIC:
+      x = lat; y = lon;
+      break;
+    case UTMUPSZONE:
+      {
+        int zone; bool northp;
+        GeographicLib::UTMUPS::Forward(lat, lon, zone, northp, x, y, _zone);
+        // Shift the northing if necessary for the requested hemisphere.
+        GeographicLib::UTMUPS::Transfer(zone, northp, x, y,
+                                        _zone, _northp, x, y, zone);
+      }
+      break;
+    case TRANSVERSEMERCATOR:
+      _tm->Forward(_lon0, lat, lon, x, y);
+      break;
+    case POLARSTEREOGRAPHIC:
+      _ps->Forward(_northp, lat, lon, x, y);
+      break;
+    case LAMBERTCONFORMALCONIC:
+      _lcc->Forward(_lon0, lat, lon, x, y);
+      break;
+    case ALBERSEQUALAREA:
+      _aea->Forward(_lon0, lat, lon, x, y);
+      break;
+    case LOCALCARTESIAN:
+      _lc->Forward(lat, lon, h, x, y, z);
+      break;
+    default:                    // GEOCENTRIC
+      _geo->Forward(lat, lon, h, x, y, z);
+      break;
+    }
+  }
+
+  void System::Reverse(size_t n,
+                       const real x[], const real y[], const real z[],
+                       real lat[], real lon[], real h[]) const {
+    switch (_kind) {
+    case TRANSVERSEMERCATOR:
+      _tm->Reverse(_lon0, n, x, y, lat, lon);
+      break;
+    case POLARSTEREOGRAPHIC:
+      _ps->Reverse(_northp, n, x, y, lat, lon);
+      break;
+    case LAMBERTCONFORMALCONIC:
+      _lcc->Reverse(_lon0, n, x, y, lat, lon);
+      break;
+    case ALBERSEQUALAREA:
+      _aea->Reverse(_lon0, n, x, y, lat, lon);
+      break;
+    case LOCALCARTESIAN:
+      _lc->Reverse(n, x, y, z, lat, lon, h);
+      return;
+    case GEOCENTRIC:
+      _geo->Reverse(n, x, y, z, lat, lon, h);
+      return;
+    default:                    // GEOGRAPHIC, UTMUPSZONE
+      for (size_t i = 0; i < n; ++i)
+        Reverse(x[i], y[i], z[i], lat[i], lon[i], h[i]);
+      return;
+    }
+    copy(z, z + n, h);
+  }
+
+  void System::Forward(size_t n,
+                       const real lat[], const real lon[], const real h[],
+                       real x[], real y[], real z[]) const {
+    switch (_kind) {
+    case TRANSVERSEMERCATOR:
+      _tm->Forward(_lon0, n, lat, lon, x, y);
+      break;
+    case POLARSTEREOGRAPHIC:
+      _ps->Forward(_northp, n, lat, lon, x, y);
+      break;
+    case LAMBERTCONFORMALCONIC:
+      _lcc->Forward(_lon0, n, lat, lon, x, y);
+      break;
+    case ALBERSEQUALAREA:
+      _aea->Forward(_lon0, n, lat, lon, x, y);
+      break;
+    case LOCALCARTESIAN:
+      _lc->Forward(n, lat, lon, h, x, y, z);
+      return;
+    case GEOCENTRIC:
+      _geo->Forward(n, lat, lon, h, x, y, z);
+      return;
+    default:                    // GEOGRAPHIC, UTMUPSZONE
+      for (size_t i = 0; i < n; ++i)
+        Forward(lat[i], lon[i], h[i], x[i], y[i], z[i]);
+      return;
+    }
+    copy(h, h + n, z);
+  }
+
+  void ProjectionPipeline::ToGeocentric(const System& s,
+                                        real t[3], real R[9]) {
+    if (s._kind == System::LOCALCARTESIAN) {
+      const LocalCartesian& lc = *s._lc;
+      t[0] = lc._x0; t[1] = lc._y0; t[2] = lc._z0;
+      copy(lc._r, lc._r + 9, R);
+    } else {
+      t[0] = t[1] = t[2] = 0;
+      for (int i = 0; i < 9; ++i)
+        R[i] = i % 4 == 0 ? 1 : 0;
+    }
+  }
+
+  bool ProjectionPipeline::SameEllipsoid() const {
+    real ai, fi, ao, fo;
+    _in.Ellipsoid(ai, fi);
+    _out.Ellipsoid(ao, fo);
+    return ai == ao && fi == fo;
+  }
+
+  ProjectionPipeline::ProjectionPipeline(const System& in, const System& out)
+    : _in(in)
+    , _out(out)
+    , _path(GENERAL)
+  {
+    if (_in.Same(_out))
+      _path = COPY;
+    else if (_in._kind == System::UTMUPSZONE &&
+             _out._kind == System::UTMUPSZONE)
+      _path = TRANSFER;
+    else if (_in.Cartesian() && _out.Cartesian() && SameEllipsoid()) {
+      // X = ti + Ri . xin, xout = Ro^T . (X - to)
+      // so xout = Ro^T . (ti - to) + Ro^T . Ri . xin
+      _path = AFFINE;
+      real ti[3], ri[9], to[3], ro[9];
+      ToGeocentric(_in, ti, ri);
+      ToGeocentric(_out, to, ro);
+      for (int i = 0; i < 3; ++i) {
+        _t[i] = 0;
+        for (int k = 0; k < 3; ++k) {
+          _t[i] += ro[3*k + i] * (ti[k] - to[k]);
+          real r = 0;
+          for (int j = 0; j < 3; ++j)
+            r += ro[3*j + i] * ri[3*j + k];
+          _r[3*i + k] = r;
+        }
+      }
+    }
+  }
+
+  void ProjectionPipeline::Transform(real x, real y, real z,
+                                     real& X, real& Y, real& Z) const {
+    switch (_path) {
+    case COPY:
+      X = x; Y = y; Z = z;
+      break;
+    case TRANSFER:
+      {
+        int zone;
+        GeographicLib::UTMUPS::Transfer(_in._zone, _in._northp, x, y,
+                                        _out._zone, _out._northp, X, Y, zone);
+        Z = z;
+      }
+      break;
+    case AFFINE:
+      {
+        real
+          xo = _t[0] + _r[0] * x + _r[1] * y + _r[2] * z,
+          yo = _t[1] + _r[3] * x + _r[4] * y + _r[5] * z,
+          zo = _t[2] + _r[6] * x + _r[7] * y + _r[8] * z;
+        X = xo; Y = yo; Z = zo;
+      }
+      break;
+    default:                    // GENERAL
+      {
+        real lat, lon, h;
+        _in.Reverse(x, y, z, lat, lon, h);
+        _out.Forward(lat, lon, h, X, Y, Z);
+      }
+      break;
+    }
+  }
+
+  void ProjectionPipeline::Transform(size_t n,
+                                     const real x[], const real y[],
+                                     const real z[],
+                                     real X[], real Y[], real Z[]) const {
+    if (_path != GENERAL) {
+      for (size_t i = 0; i < n; ++i) {
+        real Zi;
+        Transform(x[i], y[i], z ? z[i] : 0, X[i], Y[i], Zi);
+        if (Z) Z[i] = Zi;
+      }
+      return;
+    }
+    // The intermediate geographic coordinates for a block of points.  The
+    // input for a block is read (into zx if necessary) before any output is
+    // written; so the output arrays may be the same as the input ones.
+    real lat[block_], lon[block_], h[block_], zx[block_], Zx[block_];
+    for (size_t i = 0; i < n; i += block_) {
+      size_t m = min(size_t(block_), n - i);
+      const real* zi = z ? z + i : zx;
+      if (!z) fill(zx, zx + m, real(0));
+      _in.Reverse(m, x + i, y + i, zi, lat, lon, h);
+      _out.Forward(m, lat, lon, h, X + i, Y + i, Z ? Z + i : Zx);
+    }
+  }
+
+} // namespace GeographicLib
@@ -10,6 +10,7 @@
 
 #include <GeographicLib/Rhumb.hpp>
 #include <GeographicLib/DST.hpp>
+#include <GeographicLib/Registry.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -40,6 +41,13 @@ namespace GeographicLib {
     return wgs84;
   }
 
+  const Rhumb& Rhumb::Get(real a, real f, bool exact) {
+    static Registry<Rhumb> registry;
+    return registry.Get(a, f, 0, int(exact), [=]() -> Rhumb* {
+      return new Rhumb(a, f, exact);
+    });
+  }
+
   void Rhumb::AreaCoeffs() {
     // Set up coefficients for area calculation
     if (_exact) {
@@ -210,10 +218,19 @@ namespace GeographicLib {
   void Rhumb::GenInverse(real lat1, real lon1, real lat2, real lon2,
                          unsigned outmask,
                          real& s12, real& azi12, real& S12) const {
-    using std::isinf;           // Needed for Centos 7, ubuntu 14
     AuxAngle phi1(AuxAngle::degrees(lat1)), phi2(AuxAngle::degrees(lat2)),
       chi1(_aux.Convert(_aux.PHI, _aux.CHI, phi1, _exact)),
       chi2(_aux.Convert(_aux.PHI, _aux.CHI, phi2, _exact));
+    IntInverse(phi1, chi1, lon1, phi2, chi2, lon2, outmask, s12, azi12, S12);
+  }
+
+  void Rhumb::IntInverse(const AuxAngle& phi1, const AuxAngle& chi1,
+                         real lon1,
+                         const AuxAngle& phi2, const AuxAngle& chi2,
+                         real lon2,
+                         unsigned outmask,
+                         real& s12, real& azi12, real& S12) const {
+    using std::isinf;           // Needed for Centos 7, ubuntu 14
     real
       lon12 = Math::AngDiff(lon1, lon2),
       lam12 = lon12 * Math::degree<real>(),
@@ -242,6 +259,35 @@ namespace GeographicLib {
       S12 = _c2 * lon12 * MeanSinXi(chi1, chi2);
   }
 
+  void Rhumb::InverseMatrix(size_t nrows,
+                            const real lat1[], const real lon1[],
+                            size_t ncols,
+                            const real lat2[], const real lon2[],
+                            unsigned outmask,
+                            real s12[], real azi12[], real S12[]) const {
+    // The conformal latitudes of all the points are computed once.
+    vector<AuxAngle> phi(nrows + ncols), chi(nrows + ncols);
+    for (size_t k = 0; k < nrows + ncols; ++k) {
+      phi[k] = AuxAngle::degrees(k < nrows ? lat1[k] : lat2[k - nrows]);
+      chi[k] = _aux.Convert(_aux.PHI, _aux.CHI, phi[k], _exact);
+    }
+    const bool
+      distp = (outmask & DISTANCE) != 0,
+      azip = (outmask & AZIMUTH) != 0,
+      areap = (outmask & AREA) != 0;
+    for (size_t i = 0; i < nrows; ++i)
+      for (size_t j = 0; j < ncols; ++j) {
+        real s12x, azi12x, S12x;
+        IntInverse(phi[i], chi[i], lon1[i],
+                   phi[nrows + j], chi[nrows + j], lon2[j],
+                   outmask, s12x, azi12x, S12x);
+        size_t k = i * ncols + j;
+        if (distp) s12[k] = s12x;
+        if (azip) azi12[k] = azi12x;
+        if (areap) S12[k] = S12x;
+      }
+  }
+
   RhumbLine Rhumb::Line(real lat1, real lon1, real azi12) const
   { return RhumbLine(*this, lat1, lon1, azi12); }
 
@@ -257,6 +303,13 @@ namespace GeographicLib {
       phiy (_aux.Convert(_aux.CHI, _aux.PHI , chiy, _exact)),
       betax(_aux.Convert(_aux.PHI, _aux.BETA, phix, _exact).normalized()),
       betay(_aux.Convert(_aux.PHI, _aux.BETA, phiy, _exact).normalized());
+    return MeanSinXi(chix, chiy, phix, phiy, betax, betay);
+  }
+
+  Math::real Rhumb::MeanSinXi(const AuxAngle& chix, const AuxAngle& chiy,
+                              const AuxAngle& phix, const AuxAngle& phiy,
+                              const AuxAngle& betax, const AuxAngle& betay)
+    const {
     real DpbetaDbeta =
       DAuxLatitude::DClenshaw(false,
                         betay.radians() - betax.radians(),
@@ -323,4 +376,75 @@ namespace GeographicLib {
     if (outmask & LONGITUDE) lon2 = lon2x;
   }
 
+  void RhumbLine::Positions(size_t n, const real s12[], unsigned outmask,
+                            real lat2[], real lon2[], real S12[]) const {
+    const bool
+      latp = (outmask & LATITUDE) != 0,
+      lonp = (outmask & LONGITUDE) != 0,
+      areap = (outmask & AREA) != 0;
+    if (_rh._exact) {
+      // The array conversions offer no advantage with the exact equations
+      for (size_t i = 0; i < n; ++i) {
+        real lat2x, lon2x, S12x;
+        GenPosition(s12[i], outmask, lat2x, lon2x, S12x);
+        if (latp) lat2[i] = lat2x;
+        if (lonp) lon2[i] = lon2x;
+        if (areap) S12[i] = S12x;
+      }
+      return;
+    }
+    // Process the points in blocks; the conversions mu -> phi -> chi (and
+    // phi -> beta for the area) for a block are done with
+    // AuxLatitude::Convert for arrays.
+    const size_t nb = 64;
+    real r12[nb], mu2[nb], phi2[nb], chi2[nb], beta2[nb];
+    AuxAngle phi1, beta1;
+    if (areap) {
+      // The point 1 terms in Rhumb::MeanSinXi
+      phi1 = _rh._aux.Convert(AuxLatitude::CHI, AuxLatitude::PHI, _chi1);
+      beta1 = _rh._aux.Convert(AuxLatitude::PHI, AuxLatitude::BETA,
+                               phi1).normalized();
+    }
+    for (size_t i0 = 0; i0 < n; i0 += nb) {
+      size_t m = min(nb, n - i0);
+      for (size_t j = 0; j < m; ++j) {
+        r12[j] = s12[i0 + j] / (_rh._rm * Math::degree());
+        mu2[j] = _mu1 + r12[j] * _calp;
+      }
+      _rh._aux.Convert(AuxLatitude::MU, AuxLatitude::PHI, m, mu2, phi2);
+      if (lonp || areap)
+        _rh._aux.Convert(AuxLatitude::PHI, AuxLatitude::CHI, m, phi2, chi2);
+      if (areap)
+        _rh._aux.Convert(AuxLatitude::PHI, AuxLatitude::BETA, m, phi2, beta2);
+      for (size_t j = 0; j < m; ++j) {
+        size_t i = i0 + j;
+        if (!(fabs(mu2[j]) <= Math::qd)) {
+          // The line crosses a pole (or s12 is a NaN)
+          real lat2x, lon2x, S12x;
+          GenPosition(s12[i], outmask, lat2x, lon2x, S12x);
+          if (latp) lat2[i] = lat2x;
+          if (lonp) lon2[i] = lon2x;
+          if (areap) S12[i] = S12x;
+          continue;
+        }
+        if (latp) lat2[i] = phi2[j];
+        if (lonp || areap) {
+          AuxAngle chi2a(AuxAngle::degrees(chi2[j]));
+          real
+            dmudpsi = _rh._aux.DConvert(AuxLatitude::CHI, AuxLatitude::MU,
+                                        _chi1, chi2a)
+            / DAuxLatitude::Dlam(_chi1.tan(), chi2a.tan()),
+            lon2x = r12[j] * _salp / dmudpsi;
+          if (areap)
+            S12[i] = _rh._c2 * lon2x *
+              _rh.MeanSinXi(_chi1, chi2a, phi1, AuxAngle::degrees(phi2[j]),
+                            beta1, AuxAngle::degrees(beta2[j]));
+          if (lonp)
+            lon2[i] = outmask & LONG_UNROLL ? _lon1 + lon2x :
+              Math::AngNormalize(Math::AngNormalize(_lon1) + lon2x);
+        }
+      }
+    }
+  }
+
 } // namespace GeographicLib
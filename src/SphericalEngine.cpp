@@ -2,7 +2,7 @@
  * \file SphericalEngine.cpp
  * \brief Implementation for GeographicLib::SphericalEngine class
  *
- * Copyright (c) Charles Karney (2011-2022) <karney@alum.mit.edu> and licensed
+ * Copyright (c) Charles Karney (2011-2023) <karney@alum.mit.edu> and licensed
  * under the MIT/X11 License.  For more information, see
  * https://geographiclib.sourceforge.io/
  *
@@ -130,10 +130,32 @@
  * cartesian coordinates.
  **********************************************************************/
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <GeographicLib/SphericalEngine.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <GeographicLib/Instrument.hpp>
 #include <GeographicLib/CircularEngine.hpp>
 #include <GeographicLib/Utility.hpp>
 
+// The number of points evaluated together by SphericalEngine::Values; this
+// is chosen to match the width of the SIMD registers for doubles.
+#if !defined(GEOGRAPHICLIB_SPHERICAL_LANES)
+#  if defined(__AVX512F__)
+#    define GEOGRAPHICLIB_SPHERICAL_LANES 8
+#  elif defined(__AVX__)
+#    define GEOGRAPHICLIB_SPHERICAL_LANES 4
+#  elif defined(__SSE2__) || defined(_M_X64) || defined(__ARM_NEON)
+#    define GEOGRAPHICLIB_SPHERICAL_LANES 2
+#  else
+#    define GEOGRAPHICLIB_SPHERICAL_LANES 4
+#  endif
+#endif
+
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions and potentially
 // uninitialized local variables
@@ -144,19 +166,248 @@ namespace GeographicLib {
 
   using namespace std;
 
-  vector<Math::real>& SphericalEngine::sqrttable() {
-    static vector<real> sqrttable(0);
-    return sqrttable;
+  namespace {
+    // The tables of square roots used by SphericalEngine.  A table is never
+    // modified once it has been published in current.  RootTable enlarges the
+    // table by making a larger copy and publishing it with an atomic store.
+    // The older tables are kept (in all) so that a thread which fetched an
+    // older table can continue to use it.  Readers therefore need no lock;
+    // the mutex only serializes the writers.  Because the table at least
+    // doubles in size each time it's enlarged, the total memory is less than
+    // twice the size of the current table.
+    struct SqrtTables {
+      typedef Math::real real;
+      mutex lock;
+      vector<unique_ptr<const vector<real>>> all;
+      atomic<const vector<real>*> current;
+      SqrtTables() : current(nullptr) { reset(); }
+      void reset() {
+        all.clear();
+        all.emplace_back(new vector<real>());
+        current.store(all.back().get(), memory_order_release);
+      }
+    };
+    SqrtTables& sqrttables() {
+      static SqrtTables tables;
+      return tables;
+    }
+
+    // The coefficients of the Legendre recursion for the inner sums of
+    // Circle and Circles are alpha[n,m] (Ax = q * alpha) and beta[n,m] (B =
+    // - q^2 * beta).  These depend only on n, m, and the normalization.
+    template<SphericalEngine::normalization norm>
+    inline void Recursion(const vector<Math::real>& root, int n, int m,
+                          Math::real& alpha, Math::real& beta) {
+      typedef Math::real real;
+      switch (norm) {
+      case SphericalEngine::FULL:
+        {
+          real w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
+          alpha = w * root[2 * n + 3];
+          beta = root[2 * n + 5] / (w * root[n - m + 2] * root[n + m + 2]);
+        }
+        break;
+      case SphericalEngine::SCHMIDT:
+        {
+          real w = root[n - m + 1] * root[n + m + 1];
+          alpha = (2 * n + 1) / w;
+          beta = w / (root[n - m + 2] * root[n + m + 2]);
+        }
+        break;
+      default: break;         // To suppress warning message from Visual Studio
+      }
+    }
+
+    // The tables of the recursion coefficients set by
+    // SphericalEngine::LegendreTable, one for each normalization.  The
+    // coefficients for degree n and order m are at ab[2 * (start(m) + n - m)]
+    // and the following element.  These are published and retained in the
+    // same way as the tables of square roots.
+    struct LegendreTab {
+      typedef Math::real real;
+      int N;
+      vector<real> ab;
+      explicit LegendreTab(int N = -1) : N(N) {}
+      int start(int m) const { return m * (2 * N - m + 3) / 2; }
+    };
+    struct LegendreTables {
+      mutex lock;
+      vector<unique_ptr<const LegendreTab>> all;
+      atomic<const LegendreTab*> current[2];
+      LegendreTables() { reset(); }
+      void reset() {
+        all.clear();
+        all.emplace_back(new LegendreTab());
+        for (int k = 0; k < 2; ++k)
+          current[k].store(all.back().get(), memory_order_release);
+      }
+    };
+    LegendreTables& legendretables() {
+      static LegendreTables tables;
+      return tables;
+    }
+    // The table for norm if it covers degree N, else null
+    const LegendreTab* legendretable(SphericalEngine::normalization norm,
+                                     int N) {
+      const LegendreTab* tab =
+        legendretables().current[norm].load(memory_order_acquire);
+      return tab->N >= N ? tab : nullptr;
+    }
+    // Return a pointer p such that p[2*n] and p[2*n+1] are alpha and beta
+    // for order m and degrees n = m .. N.  These are in tab, if it's not
+    // null, else they are computed and stored in abm.
+    template<SphericalEngine::normalization norm>
+    const Math::real* Coeffs(const LegendreTab* tab,
+                             const vector<Math::real>& root, int N, int m,
+                             vector<Math::real>& abm) {
+      if (tab)
+        return tab->ab.data() + 2 * (tab->start(m) - m);
+      for (int n = m; n <= N; ++n)
+        Recursion<norm>(root, n, m, abm[2 * n], abm[2 * n + 1]);
+      return abm.data();
+    }
+
+    // The coefficients of the sums for order m.  The limits of the sums are
+    // given by c[0]; the terms of c[l], l > 0, are only visited for n <=
+    // c[l].nmx() and m <= c[l].mmx().  Thus a truncated or zonal correction
+    // costs in proportion to its size instead of that of c[0].  Call C(n)
+    // for n = N, N - 1, ..., m, each followed, if m > 0, by S().
+    template<int L>
+    class Terms {
+    private:
+      typedef Math::real real;
+      const SphericalEngine::coeff* _c;
+      const real* _f;
+      int _m;
+      int _k[L];                // the indices of the current terms
+      int _n1[L];               // the degree of the first term of c[l]
+      int _l[L], _nl;           // the active corrections and their number
+      int _nnext;               // where the next correction becomes active
+      void activate(int n) {
+        _nl = 0; _nnext = -1;
+        for (int l = 1; l < L; ++l) {
+          if (_n1[l] == n) _k[l] = _c[l].index(n, _m) + 1;
+          if (_n1[l] >= n)
+            _l[_nl++] = l;
+          else
+            _nnext = max(_nnext, _n1[l]);
+        }
+      }
+    public:
+      Terms(const SphericalEngine::coeff c[], const real f[], int N, int m)
+        : _c(c), _f(f), _m(m), _nl(0), _nnext(-1) {
+        for (int l = 0; l < L; ++l) {
+          _k[l] = _l[l] = 0;
+          _n1[l] = m <= c[l].mmx() ? min(N, c[l].nmx()) : -1;
+        }
+        _k[0] = c[0].index(N, m) + 1;
+        if (L > 1) activate(N);
+      }
+      real C(int n) {
+        if (L > 1 && n == _nnext) activate(n);
+        real R = _c[0].Cv(--_k[0]);
+        for (int j = 0; j < _nl; ++j) {
+          int l = _l[j];
+          R += _c[l].Cv(--_k[l]) * _f[l];
+        }
+        return R;
+      }
+      real S() const {
+        real R = _c[0].Sv(_k[0]);
+        for (int j = 0; j < _nl; ++j) {
+          int l = _l[j];
+          R += _c[l].Sv(_k[l]) * _f[l];
+        }
+        return R;
+      }
+    };
+  }
+
+  const vector<Math::real>& SphericalEngine::sqrttable() {
+    return *sqrttables().current.load(memory_order_acquire);
   }
 
   template<bool gradp, SphericalEngine::normalization norm, int L>
   Math::real SphericalEngine::Value(const coeff c[], const real f[],
                                     real x, real y, real z, real a,
                                     real& gradx, real& grady, real& gradz)
+  {
+    return ValueRange<gradp, norm, L>(c, f, x, y, z, a, 0, c[0].mmx(),
+                                      gradx, grady, gradz);
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  Math::real SphericalEngine::Value(const coeff c[], const real f[],
+                                    real x, real y, real z, real a,
+                                    real& gradx, real& grady, real& gradz,
+                                    int nthreads)
+  {
+    int N = c[0].nmx(), M = c[0].mmx();
+    // The number of terms in the sum; there are N - m + 1 terms of order m.
+    long long work = M < 0 ? 0 : (long long)(M + 1) * (2 * N - M + 2) / 2;
+    // Splitting the sum changes the roundoff; so a reproducible build uses
+    // one thread.
+    nthreads = Math::reproducible ? 1 :
+      int(min((long long)(max(nthreads, 1)), max(work / minwork_, 1LL)));
+    if (nthreads == 1)
+      return ValueRange<gradp, norm, L>(c, f, x, y, z, a, 0, M,
+                                        gradx, grady, gradz);
+    // Task i handles orders mlim[i] thru mlim[i+1]-1
+    vector<int> mlim(nthreads + 1, M + 1);
+    mlim[0] = 0;
+    {
+      long long acc = 0;
+      for (int m = 0, i = 1; m <= M && i < nthreads; ++m) {
+        acc += N - m + 1;
+        if (acc * nthreads >= i * work) mlim[i++] = m + 1;
+      }
+    }
+    // v, gradx, grady, gradz for each task
+    vector<real> res(4 * nthreads, real(0));
+    auto worker = [&](int i) -> void {
+      real* r = &res[4 * i];
+      r[0] = ValueRange<gradp, norm, L>(c, f, x, y, z, a,
+                                        mlim[i], mlim[i + 1] - 1,
+                                        r[1], r[2], r[3]);
+    };
+    Executor::Batch(nthreads, worker);
+    real v = 0;
+    if (gradp) gradx = grady = gradz = 0;
+    for (int i = 0; i < nthreads; ++i) {
+      v += res[4 * i];
+      if (gradp) {
+        gradx += res[4 * i + 1];
+        grady += res[4 * i + 2];
+        gradz += res[4 * i + 3];
+      }
+    }
+    return v;
+  }
+
+  template<SphericalEngine::normalization norm, int L>
+  Math::real SphericalEngine::Hessian(const coeff c[], const real f[],
+                                      real x, real y, real z, real a,
+                                      real& gradx, real& grady, real& gradz,
+                                      real hess[])
+  {
+    return ValueRange<true, norm, L, true>(c, f, x, y, z, a, 0, c[0].mmx(),
+                                           gradx, grady, gradz, hess);
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L, bool hessp>
+  Math::real SphericalEngine::ValueRange(const coeff c[], const real f[],
+                                         real x, real y, real z, real a,
+                                         int m0, int m1,
+                                         real& gradx, real& grady, real& gradz,
+                                         real hess[])
     {
     static_assert(L > 0, "L must be positive");
+    static_assert(gradp || !hessp, "The Hessian requires the gradient");
     static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
-    int N = c[0].nmx(), M = c[0].mmx();
+    GEOGRAPHICLIB_TRACE_SCOPE(SPHERICAL_SUM);
+    // The orders above m1 contribute nothing; the inner sums for orders
+    // below m0 are 0.
+    int N = c[0].nmx(), M = m1;
 
     real
       p = hypot(x, y),
@@ -178,7 +429,16 @@ namespace GeographicLib {
     real vrc = 0, vrc2 = 0, vrs = 0, vrs2 = 0;   // vr[N + 1], vr[N + 2]
     real vtc = 0, vtc2 = 0, vts = 0, vts2 = 0;   // vt[N + 1], vt[N + 2]
     real vlc = 0, vlc2 = 0, vls = 0, vls2 = 0;   // vl[N + 1], vl[N + 2]
-    int k[L];
+    // The sums for the second derivatives wrt r and r, r and theta, theta
+    // and theta, r and lambda, theta and lambda, and lambda and lambda.  The
+    // last two are combined with first derivative terms so that the sums are
+    // regular at the poles.
+    real vrrc = 0, vrrc2 = 0, vrrs = 0, vrrs2 = 0;
+    real vrtc = 0, vrtc2 = 0, vrts = 0, vrts2 = 0;
+    real vttc = 0, vttc2 = 0, vtts = 0, vtts2 = 0;
+    real vrlc = 0, vrlc2 = 0, vrls = 0, vrls2 = 0;
+    real vtlc = 0, vtlc2 = 0, vtls = 0, vtls2 = 0;
+    real vllc = 0, vllc2 = 0, vlls = 0, vlls2 = 0;
     const vector<real>& root( sqrttable() );
     for (int m = M; m >= 0; --m) {   // m = M .. 0
       // Initialize inner sum
@@ -186,9 +446,13 @@ namespace GeographicLib {
         wc  = 0, wc2  = 0, ws  = 0, ws2  = 0, // w [N - m + 1], w [N - m + 2]
         wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0, // wr[N - m + 1], wr[N - m + 2]
         wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
-      for (int l = 0; l < L; ++l)
-        k[l] = c[l].index(N, m) + 1;
-      for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
+      real
+        wrrc = 0, wrrc2 = 0, wrrs = 0, wrrs2 = 0,
+        wrtc = 0, wrtc2 = 0, wrts = 0, wrts2 = 0,
+        wttc = 0, wttc2 = 0, wtts = 0, wtts2 = 0;
+      Terms<L> terms(c, f, N, m);
+      // n = N .. m; l = N - m .. 0 (no terms if m < m0)
+      for (int n = m >= m0 ? N : m - 1; n >= m; --n) {
         real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
         switch (norm) {
         case FULL:
@@ -206,24 +470,39 @@ namespace GeographicLib {
           break;
         default: break;       // To suppress warning message from Visual Studio
         }
-        R = c[0].Cv(--k[0]);
-        for (int l = 1; l < L; ++l)
-          R += c[l].Cv(--k[l], n, m, f[l]);
+        R = terms.C(n);
         R *= scale();
-        w = A * wc + B * wc2 + R; wc2 = wc; wc = w;
+        w = Math::muladd(A, wc, B * wc2) + R; wc2 = wc; wc = w;
         if (gradp) {
-          w = A * wrc + B * wrc2 + (n + 1) * R; wrc2 = wrc; wrc = w;
-          w = A * wtc + B * wtc2 -  u*Ax * wc2; wtc2 = wtc; wtc = w;
+          w = Math::muladd(A, wrc, B * wrc2) + (n + 1) * R; wrc2 = wrc; wrc = w;
+          w = Math::muladd(A, wtc, B * wtc2) -  u*Ax * wc2; wtc2 = wtc; wtc = w;
+          if (hessp) {
+            // d(A)/dtheta = -u*Ax and d^2(A)/dtheta^2 = -A
+            w = Math::muladd(A, wrrc, B * wrrc2) + (n + 1) * (n + 2) * R;
+            wrrc2 = wrrc; wrrc = w;
+            w = Math::muladd(A, wrtc, B * wrtc2) - u*Ax * wrc2;
+            wrtc2 = wrtc; wrtc = w;
+            w = Math::muladd(A, wttc, B * wttc2) - 2*u*Ax * wtc2 - A * wc2;
+            wttc2 = wttc; wttc = w;
+          }
         }
         if (m) {
-          R = c[0].Sv(k[0]);
-          for (int l = 1; l < L; ++l)
-            R += c[l].Sv(k[l], n, m, f[l]);
+          R = terms.S();
           R *= scale();
-          w = A * ws + B * ws2 + R; ws2 = ws; ws = w;
+          w = Math::muladd(A, ws, B * ws2) + R; ws2 = ws; ws = w;
           if (gradp) {
-            w = A * wrs + B * wrs2 + (n + 1) * R; wrs2 = wrs; wrs = w;
-            w = A * wts + B * wts2 -  u*Ax * ws2; wts2 = wts; wts = w;
+            w = Math::muladd(A, wrs, B * wrs2) + (n + 1) * R;
+            wrs2 = wrs; wrs = w;
+            w = Math::muladd(A, wts, B * wts2) -  u*Ax * ws2;
+            wts2 = wts; wts = w;
+            if (hessp) {
+              w = Math::muladd(A, wrrs, B * wrrs2) + (n + 1) * (n + 2) * R;
+              wrrs2 = wrrs; wrrs = w;
+              w = Math::muladd(A, wrts, B * wrts2) - u*Ax * wrs2;
+              wrts2 = wrts; wrts = w;
+              w = Math::muladd(A, wtts, B * wtts2) - 2*u*Ax * wts2 - A * ws2;
+              wtts2 = wtts; wtts = w;
+            }
           }
         }
       }
@@ -244,17 +523,53 @@ namespace GeographicLib {
           break;
         default: break;       // To suppress warning message from Visual Studio
         }
-        v = A * vc  + B * vc2  +  wc ; vc2  = vc ; vc  = v;
-        v = A * vs  + B * vs2  +  ws ; vs2  = vs ; vs  = v;
+        v = Math::muladd(A, vc, B * vc2)  +  wc ; vc2  = vc ; vc  = v;
+        v = Math::muladd(A, vs, B * vs2)  +  ws ; vs2  = vs ; vs  = v;
+        if (hessp) {
+          // With T[m] = u^m * S[m] (S = Sc[m] or Ss[m] and ' = d/dtheta)
+          //   T'[m]  = u^m * (S' + m*t/u * S)
+          //   T''[m] = u^m * (S'' + 2*m*t/u * S' + (m*(m-1)*t^2/u^2 - m) * S)
+          // The theta-lambda sum is d/dlambda (T' - t/u * T) / u and the
+          // lambda-lambda sum is (d^2/dlambda^2 T / u + t * T') / u; the
+          // singular terms cancel for m = 1.
+          real
+            ct = m * (m - 1) * Math::_sq(tu) - m,
+            cl1 = (m - 1) * tu,
+            cl2 = (m * (1 - m) / u - m * u) / u;
+          v = Math::muladd(A, vrrc, B * vrrc2) + wrrc; vrrc2 = vrrc; vrrc = v;
+          v = Math::muladd(A, vrrs, B * vrrs2) + wrrs; vrrs2 = vrrs; vrrs = v;
+          v = Math::muladd(A, vrtc, B * vrtc2) + wrtc + m * tu * wrc;
+          vrtc2 = vrtc; vrtc = v;
+          v = Math::muladd(A, vrts, B * vrts2) + wrts + m * tu * wrs;
+          vrts2 = vrts; vrts = v;
+          v = Math::muladd(A, vttc, B * vttc2) +
+            wttc + 2 * m * tu * wtc + ct * wc;
+          vttc2 = vttc; vttc = v;
+          v = Math::muladd(A, vtts, B * vtts2) +
+            wtts + 2 * m * tu * wts + ct * ws;
+          vtts2 = vtts; vtts = v;
+          v = Math::muladd(A, vrlc, B * vrlc2) + m * wrs;
+          vrlc2 = vrlc; vrlc = v;
+          v = Math::muladd(A, vrls, B * vrls2) - m * wrc;
+          vrls2 = vrls; vrls = v;
+          v = Math::muladd(A, vtlc, B * vtlc2) + m * (wts + cl1 * ws);
+          vtlc2 = vtlc; vtlc = v;
+          v = Math::muladd(A, vtls, B * vtls2) - m * (wtc + cl1 * wc);
+          vtls2 = vtls; vtls = v;
+          v = Math::muladd(A, vllc, B * vllc2) + tu * wtc + cl2 * wc;
+          vllc2 = vllc; vllc = v;
+          v = Math::muladd(A, vlls, B * vlls2) + tu * wts + cl2 * ws;
+          vlls2 = vlls; vlls = v;
+        }
         if (gradp) {
           // Include the terms Sc[m] * P'[m,m](t) and Ss[m] * P'[m,m](t)
           wtc += m * tu * wc; wts += m * tu * ws;
-          v = A * vrc + B * vrc2 +  wrc; vrc2 = vrc; vrc = v;
-          v = A * vrs + B * vrs2 +  wrs; vrs2 = vrs; vrs = v;
-          v = A * vtc + B * vtc2 +  wtc; vtc2 = vtc; vtc = v;
-          v = A * vts + B * vts2 +  wts; vts2 = vts; vts = v;
-          v = A * vlc + B * vlc2 + m*ws; vlc2 = vlc; vlc = v;
-          v = A * vls + B * vls2 - m*wc; vls2 = vls; vls = v;
+          v = Math::muladd(A, vrc, B * vrc2) +  wrc; vrc2 = vrc; vrc = v;
+          v = Math::muladd(A, vrs, B * vrs2) +  wrs; vrs2 = vrs; vrs = v;
+          v = Math::muladd(A, vtc, B * vtc2) +  wtc; vtc2 = vtc; vtc = v;
+          v = Math::muladd(A, vts, B * vts2) +  wts; vts2 = vts; vts = v;
+          v = Math::muladd(A, vlc, B * vlc2) + m*ws; vlc2 = vlc; vlc = v;
+          v = Math::muladd(A, vls, B * vls2) - m*wc; vls2 = vls; vls = v;
         }
       } else {
         real A, B, qs;
@@ -280,10 +595,54 @@ namespace GeographicLib {
           vrc =   - qs * (wrc + A * (cl * vrc + sl * vrs) + B * vrc2);
           vtc =     qs * (wtc + A * (cl * vtc + sl * vts) + B * vtc2);
           vlc = qs / u * (      A * (cl * vlc + sl * vls) + B * vlc2);
+          if (hessp) {
+            qs /= r;
+            // The second derivatives in spherical coordinates are
+            // r-r: d^2V/dr^2
+            // r-theta: 1/r * d^2V/(dr*dtheta)
+            // theta-theta: 1/r^2 * d^2V/dtheta^2
+            // r-lambda: 1/(r*u) * d^2V/(dr*dlambda)
+            // theta-lambda: 1/(r^2*u) * (d^2V/(dtheta*dlambda) -
+            //                            t/u * dV/dlambda)
+            // lambda-lambda: 1/(r^2*u) * (1/u * d^2V/dlambda^2 + t * dV/dtheta)
+            // (the last two include the first derivative terms from the
+            // metric so that they are regular at the poles).
+            vrrc =    qs * (wrrc + A * (cl * vrrc + sl * vrrs) + B * vrrc2);
+            vrtc =  - qs * (wrtc + A * (cl * vrtc + sl * vrts) + B * vrtc2);
+            vttc =    qs * (wttc + A * (cl * vttc + sl * vtts) + B * vttc2);
+            vrlc = - qs / u * (    A * (cl * vrlc + sl * vrls) + B * vrlc2);
+            vtlc =   qs / u * (    A * (cl * vtlc + sl * vtls) + B * vtlc2);
+            vllc =    qs * (tu * wtc +
+                            A * (cl * vllc + sl * vlls) + B * vllc2);
+          }
         }
       }
     }
 
+    if (hessp) {
+      // The Hessian in the local frame (r, theta, lambda)
+      real
+        hrr = vrrc,
+        hrt = vrtc - vtc / r,
+        hrl = vrlc - vlc / r,
+        htt = vttc + vrc / r,
+        htl = vtlc,
+        hll = vllc + vrc / r,
+        // The unit vectors in the r, theta, and lambda directions
+        er[] = {cl * u, sl * u, t},
+        et[] = {cl * t, sl * t, -u},
+        el[] = {-sl, cl, 0};
+      // Rotate into cartesian coordinates, hess = E * H * E^T where the
+      // columns of E are er, et, and el; hess = [xx, xy, xz, yy, yz, zz].
+      for (int i = 0, l = 0; i < 3; ++i)
+        for (int j = i; j < 3; ++j, ++l)
+          hess[l] =
+            hrr * er[i] * er[j] + htt * et[i] * et[j] + hll * el[i] * el[j] +
+            hrt * (er[i] * et[j] + et[i] * er[j]) +
+            hrl * (er[i] * el[j] + el[i] * er[j]) +
+            htl * (et[i] * el[j] + el[i] * et[j]);
+    }
+
     if (gradp) {
       // Rotate into cartesian (geocentric) coordinates
       gradx = cl * (u * vrc + t * vtc) - sl * vlc;
@@ -293,12 +652,188 @@ namespace GeographicLib {
     return vc;
   }
 
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::Values(const coeff c[], const real f[], size_t num,
+                               const real x[], const real y[], const real z[],
+                               real a, real v[],
+                               real gradx[], real grady[], real gradz[]) {
+    // This follows Value except that the quantities depending on the point
+    // are arrays of length K and the operations on these arrays are loops
+    // over j = 0 .. K-1 with no dependencies between iterations.
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SCOPE(SPHERICAL_SUM);
+    const int K = GEOGRAPHICLIB_SPHERICAL_LANES;
+    int N = c[0].nmx(), M = c[0].mmx();
+    const vector<real>& root( sqrttable() );
+    for (size_t i0 = 0; i0 < num; i0 += K) {
+      real cl[K], sl[K], r[K], t[K], u[K], q[K], q2[K], uq[K], uq2[K], tu[K];
+      for (int j = 0; j < K; ++j) {
+        // Pad the last group with copies of the last point
+        size_t i = min(i0 + j, num - 1);
+        real p = hypot(x[i], y[i]);
+        cl[j] = p != 0 ? x[i] / p : 1;
+        sl[j] = p != 0 ? y[i] / p : 0;
+        r[j] = hypot(z[i], p);
+        t[j] = r[j] != 0 ? z[i] / r[j] : 0;
+        u[j] = r[j] != 0 ? fmax(p / r[j], eps()) : 1;
+        q[j] = a / r[j];
+        q2[j] = Math::_sq(q[j]);
+        uq[j] = u[j] * q[j];
+        uq2[j] = Math::_sq(uq[j]);
+        tu[j] = t[j] / u[j];
+      }
+      real
+        vc [K] = {}, vc2 [K] = {}, vs [K] = {}, vs2 [K] = {},
+        vrc[K] = {}, vrc2[K] = {}, vrs[K] = {}, vrs2[K] = {},
+        vtc[K] = {}, vtc2[K] = {}, vts[K] = {}, vts2[K] = {},
+        vlc[K] = {}, vlc2[K] = {}, vls[K] = {}, vls2[K] = {};
+      for (int m = M; m >= 0; --m) {
+        real
+          wc [K] = {}, wc2 [K] = {}, ws [K] = {}, ws2 [K] = {},
+          wrc[K] = {}, wrc2[K] = {}, wrs[K] = {}, wrs2[K] = {},
+          wtc[K] = {}, wtc2[K] = {}, wts[K] = {}, wts2[K] = {};
+        Terms<L> terms(c, f, N, m);
+        for (int n = N; n >= m; --n) {
+          // For each point, Ax = q * alpha, A = t * Ax, B = - q2 * beta
+          real alpha = 0, beta = 0;
+          switch (norm) {
+          case FULL:
+            {
+              real w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
+              alpha = w * root[2 * n + 3];
+              beta = root[2 * n + 5] / (w * root[n - m + 2] * root[n + m + 2]);
+            }
+            break;
+          case SCHMIDT:
+            {
+              real w = root[n - m + 1] * root[n + m + 1];
+              alpha = (2 * n + 1) / w;
+              beta = w / (root[n - m + 2] * root[n + m + 2]);
+            }
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+          real RC = terms.C(n), RS = 0;
+          RC *= scale();
+          if (m) {
+            RS = terms.S();
+            RS *= scale();
+          }
+          for (int j = 0; j < K; ++j) {
+            real Ax = q[j] * alpha, A = t[j] * Ax, B = - q2[j] * beta, w;
+            w = Math::muladd(A, wc[j], B * wc2[j]) + RC;
+            wc2[j] = wc[j]; wc[j] = w;
+            if (gradp) {
+              w = Math::muladd(A, wrc[j], B * wrc2[j]) + (n + 1) * RC;
+              wrc2[j] = wrc[j]; wrc[j] = w;
+              w = Math::muladd(A, wtc[j], B * wtc2[j]) - u[j] * Ax * wc2[j];
+              wtc2[j] = wtc[j]; wtc[j] = w;
+            }
+            if (m) {
+              w = Math::muladd(A, ws[j], B * ws2[j]) + RS;
+              ws2[j] = ws[j]; ws[j] = w;
+              if (gradp) {
+                w = Math::muladd(A, wrs[j], B * wrs2[j]) + (n + 1) * RS;
+                wrs2[j] = wrs[j]; wrs[j] = w;
+                w = Math::muladd(A, wts[j], B * wts2[j]) - u[j] * Ax * ws2[j];
+                wts2[j] = wts[j]; wts[j] = w;
+              }
+            }
+          }
+        }
+        if (m) {
+          // For each point, A = cl * alpha * uq, B = - beta * uq2
+          real alpha = 0, beta = 0;
+          switch (norm) {
+          case FULL:
+            alpha = root[2] * root[2 * m + 3] / root[m + 1];
+            beta = alpha * root[2 * m + 5] / (root[8] * root[m + 2]);
+            break;
+          case SCHMIDT:
+            alpha = root[2] * root[2 * m + 1] / root[m + 1];
+            beta = alpha * root[2 * m + 3] / (root[8] * root[m + 2]);
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+          for (int j = 0; j < K; ++j) {
+            real A = cl[j] * alpha * uq[j], B = - beta * uq2[j], w;
+            w = Math::muladd(A, vc[j], B * vc2[j]) + wc[j];
+            vc2[j] = vc[j]; vc[j] = w;
+            w = Math::muladd(A, vs[j], B * vs2[j]) + ws[j];
+            vs2[j] = vs[j]; vs[j] = w;
+            if (gradp) {
+              wtc[j] += m * tu[j] * wc[j]; wts[j] += m * tu[j] * ws[j];
+              w = Math::muladd(A, vrc[j], B * vrc2[j]) + wrc[j];
+              vrc2[j] = vrc[j]; vrc[j] = w;
+              w = Math::muladd(A, vrs[j], B * vrs2[j]) + wrs[j];
+              vrs2[j] = vrs[j]; vrs[j] = w;
+              w = Math::muladd(A, vtc[j], B * vtc2[j]) + wtc[j];
+              vtc2[j] = vtc[j]; vtc[j] = w;
+              w = Math::muladd(A, vts[j], B * vts2[j]) + wts[j];
+              vts2[j] = vts[j]; vts[j] = w;
+              w = Math::muladd(A, vlc[j], B * vlc2[j]) + m * ws[j];
+              vlc2[j] = vlc[j]; vlc[j] = w;
+              w = Math::muladd(A, vls[j], B * vls2[j]) - m * wc[j];
+              vls2[j] = vls[j]; vls[j] = w;
+            }
+          }
+        } else {
+          real alpha = 0, beta = 0;
+          switch (norm) {
+          case FULL:
+            alpha = root[3];
+            beta = root[15]/2;
+            break;
+          case SCHMIDT:
+            alpha = 1;
+            beta = root[3]/2;
+            break;
+          default: break;     // To suppress warning message from Visual Studio
+          }
+          for (int j = 0; j < K; ++j) {
+            real A = alpha * uq[j], B = - beta * uq2[j], qs = q[j] / scale();
+            vc[j] = qs * (wc[j] + A * (cl[j] * vc[j] + sl[j] * vs[j]) +
+                          B * vc2[j]);
+            if (gradp) {
+              qs /= r[j];
+              vrc[j] = - qs * (wrc[j] + A * (cl[j] * vrc[j] + sl[j] * vrs[j])
+                               + B * vrc2[j]);
+              vtc[j] =   qs * (wtc[j] + A * (cl[j] * vtc[j] + sl[j] * vts[j])
+                               + B * vtc2[j]);
+              vlc[j] = qs / u[j] * (A * (cl[j] * vlc[j] + sl[j] * vls[j])
+                                    + B * vlc2[j]);
+            }
+          }
+        }
+      }
+      for (int j = 0; j < K && i0 + j < num; ++j) {
+        size_t i = i0 + j;
+        v[i] = vc[j];
+        if (gradp) {
+          // Rotate into cartesian (geocentric) coordinates
+          gradx[i] = cl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) - sl[j] * vlc[j];
+          grady[i] = sl[j] * (u[j] * vrc[j] + t[j] * vtc[j]) + cl[j] * vlc[j];
+          gradz[i] =         t[j] * vrc[j] - u[j] * vtc[j]                  ;
+        }
+      }
+    }
+  }
+
   template<bool gradp, SphericalEngine::normalization norm, int L>
   CircularEngine SphericalEngine::Circle(const coeff c[], const real f[],
                                          real p, real z, real a) {
+    return Circle<gradp, norm, L>(c, f, p, z, a, 1);
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  CircularEngine SphericalEngine::Circle(const coeff c[], const real f[],
+                                         real p, real z, real a,
+                                         int nthreads) {
 
     static_assert(L > 0, "L must be positive");
     static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SCOPE(SPHERICAL_CIRCLE);
     int N = c[0].nmx(), M = c[0].mmx();
 
     real
@@ -306,56 +841,77 @@ namespace GeographicLib {
       t = r != 0 ? z / r : 0,   // cos(theta); at origin, pick theta = pi/2
       u = r != 0 ? fmax(p / r, eps()) : 1, // sin(theta); but avoid the pole
       q = a / r;
+    CircularEngine circ(M, gradp, norm, a, r, u, t);
+    // The inner sums for different orders are independent and each is
+    // stored in its own slot of circ; so, unlike Value, splitting the orders
+    // among threads doesn't change the result.
+    long long work = M < 0 ? 0 : (long long)(M + 1) * (2 * N - M + 2) / 2;
+    nthreads =
+      int(min((long long)(max(nthreads, 1)), max(work / minwork_, 1LL)));
+    if (nthreads == 1) {
+      CircleRange<gradp, norm, L>(c, f, q, t, u, 0, M, circ);
+      return circ;
+    }
+    // Task i handles orders mlim[i] thru mlim[i+1]-1
+    vector<int> mlim(nthreads + 1, M + 1);
+    mlim[0] = 0;
+    {
+      long long acc = 0;
+      for (int m = 0, i = 1; m <= M && i < nthreads; ++m) {
+        acc += N - m + 1;
+        if (acc * nthreads >= i * work) mlim[i++] = m + 1;
+      }
+    }
+    auto worker = [&](int i) -> void {
+      CircleRange<gradp, norm, L>(c, f, q, t, u, mlim[i], mlim[i + 1] - 1,
+                                  circ);
+    };
+    Executor::Batch(nthreads, worker);
+    return circ;
+  }
+
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::CircleRange(const coeff c[], const real f[],
+                                    real q, real t, real u, int m0, int m1,
+                                    CircularEngine& circ) {
+    int N = c[0].nmx();
     real
       q2 = Math::_sq(q),
       tu = t / u;
-    CircularEngine circ(M, gradp, norm, a, r, u, t);
-    int k[L];
     const vector<real>& root( sqrttable() );
-    for (int m = M; m >= 0; --m) {   // m = M .. 0
+    const LegendreTab* tab = legendretable(norm, N);
+    // Without a table, the coefficients for each order are computed here
+    vector<real> abm(tab ? 0 : 2 * (N + 1));
+    for (int m = m1; m >= m0; --m) {   // m = m1 .. m0
       // Initialize inner sum
       real
         wc  = 0, wc2  = 0, ws  = 0, ws2  = 0, // w [N - m + 1], w [N - m + 2]
         wrc = 0, wrc2 = 0, wrs = 0, wrs2 = 0, // wr[N - m + 1], wr[N - m + 2]
         wtc = 0, wtc2 = 0, wts = 0, wts2 = 0; // wt[N - m + 1], wt[N - m + 2]
-      for (int l = 0; l < L; ++l)
-        k[l] = c[l].index(N, m) + 1;
+      Terms<L> terms(c, f, N, m);
+      const real* ab = Coeffs<norm>(tab, root, N, m, abm);
       for (int n = N; n >= m; --n) {             // n = N .. m; l = N - m .. 0
-        real w, A, Ax, B, R;    // alpha[l], beta[l + 1]
-        switch (norm) {
-        case FULL:
-          w = root[2 * n + 1] / (root[n - m + 1] * root[n + m + 1]);
-          Ax = q * w * root[2 * n + 3];
-          A = t * Ax;
-          B = - q2 * root[2 * n + 5] /
-            (w * root[n - m + 2] * root[n + m + 2]);
-          break;
-        case SCHMIDT:
-          w = root[n - m + 1] * root[n + m + 1];
-          Ax = q * (2 * n + 1) / w;
-          A = t * Ax;
-          B = - q2 * w / (root[n - m + 2] * root[n + m + 2]);
-          break;
-        default: break;       // To suppress warning message from Visual Studio
-        }
-        R = c[0].Cv(--k[0]);
-        for (int l = 1; l < L; ++l)
-          R += c[l].Cv(--k[l], n, m, f[l]);
+        real
+          w, R,
+          Ax = q * ab[2 * n],   // q * alpha[l]
+          A = t * Ax,
+          B = - q2 * ab[2 * n + 1]; // - q^2 * beta[l + 1]
+        R = terms.C(n);
         R *= scale();
-        w = A * wc + B * wc2 + R; wc2 = wc; wc = w;
+        w = Math::muladd(A, wc, B * wc2) + R; wc2 = wc; wc = w;
         if (gradp) {
-          w = A * wrc + B * wrc2 + (n + 1) * R; wrc2 = wrc; wrc = w;
-          w = A * wtc + B * wtc2 -  u*Ax * wc2; wtc2 = wtc; wtc = w;
+          w = Math::muladd(A, wrc, B * wrc2) + (n + 1) * R; wrc2 = wrc; wrc = w;
+          w = Math::muladd(A, wtc, B * wtc2) -  u*Ax * wc2; wtc2 = wtc; wtc = w;
         }
         if (m) {
-          R = c[0].Sv(k[0]);
-          for (int l = 1; l < L; ++l)
-            R += c[l].Sv(k[l], n, m, f[l]);
+          R = terms.S();
           R *= scale();
-          w = A * ws + B * ws2 + R; ws2 = ws; ws = w;
+          w = Math::muladd(A, ws, B * ws2) + R; ws2 = ws; ws = w;
           if (gradp) {
-            w = A * wrs + B * wrs2 + (n + 1) * R; wrs2 = wrs; wrs = w;
-            w = A * wts + B * wts2 -  u*Ax * ws2; wts2 = wts; wts = w;
+            w = Math::muladd(A, wrs, B * wrs2) + (n + 1) * R;
+            wrs2 = wrs; wrs = w;
+            w = Math::muladd(A, wts, B * wts2) -  u*Ax * ws2;
+            wts2 = wts; wts = w;
           }
         }
       }
@@ -367,19 +923,170 @@ namespace GeographicLib {
         circ.SetCoeff(m, wc, ws, wrc, wrs, wtc, wts);
       }
     }
+  }
 
-    return circ;
+  template<bool gradp, SphericalEngine::normalization norm, int L>
+  void SphericalEngine::Circles(const coeff c[], const real f[], size_t num,
+                                const real p[], const real z[], real a,
+                                CircularEngine circ[]) {
+    // This follows Circle except that the quantities depending on the circle
+    // are arrays of length K, as in Values.
+    static_assert(L > 0, "L must be positive");
+    static_assert(norm == FULL || norm == SCHMIDT, "Unknown normalization");
+    GEOGRAPHICLIB_TRACE_SCOPE(SPHERICAL_CIRCLE);
+    const int K = GEOGRAPHICLIB_SPHERICAL_LANES;
+    int N = c[0].nmx(), M = c[0].mmx();
+    const vector<real>& root( sqrttable() );
+    const LegendreTab* tab = legendretable(norm, N);
+    vector<real> abm(tab ? 0 : 2 * (N + 1));
+    for (size_t i0 = 0; i0 < num; i0 += K) {
+      if (num - i0 == 1) {
+        // Don't pad a single circle
+        circ[i0] = Circle<gradp, norm, L>(c, f, p[i0], z[i0], a);
+        break;
+      }
+      real r[K], t[K], u[K], q[K], q2[K], tu[K];
+      for (int j = 0; j < K; ++j) {
+        // Pad the last group with copies of the last circle
+        size_t i = min(i0 + j, num - 1);
+        r[j] = hypot(z[i], p[i]);
+        t[j] = r[j] != 0 ? z[i] / r[j] : 0;
+        u[j] = r[j] != 0 ? fmax(p[i] / r[j], eps()) : 1;
+        q[j] = a / r[j];
+        q2[j] = Math::_sq(q[j]);
+        tu[j] = t[j] / u[j];
+      }
+      for (int j = 0; j < K && i0 + j < num; ++j)
+        circ[i0 + j] = CircularEngine(M, gradp, norm, a, r[j], u[j], t[j]);
+      for (int m = M; m >= 0; --m) {
+        real
+          wc [K] = {}, wc2 [K] = {}, ws [K] = {}, ws2 [K] = {},
+          wrc[K] = {}, wrc2[K] = {}, wrs[K] = {}, wrs2[K] = {},
+          wtc[K] = {}, wtc2[K] = {}, wts[K] = {}, wts2[K] = {};
+        Terms<L> terms(c, f, N, m);
+        const real* ab = Coeffs<norm>(tab, root, N, m, abm);
+        for (int n = N; n >= m; --n) {
+          // For each circle, Ax = q * alpha, A = t * Ax, B = - q2 * beta
+          real alpha = ab[2 * n], beta = ab[2 * n + 1];
+          real RC = terms.C(n), RS = 0;
+          RC *= scale();
+          if (m) {
+            RS = terms.S();
+            RS *= scale();
+          }
+          for (int j = 0; j < K; ++j) {
+            real Ax = q[j] * alpha, A = t[j] * Ax, B = - q2[j] * beta, w;
+            w = Math::muladd(A, wc[j], B * wc2[j]) + RC;
+            wc2[j] = wc[j]; wc[j] = w;
+            if (gradp) {
+              w = Math::muladd(A, wrc[j], B * wrc2[j]) + (n + 1) * RC;
+              wrc2[j] = wrc[j]; wrc[j] = w;
+              w = Math::muladd(A, wtc[j], B * wtc2[j]) - u[j] * Ax * wc2[j];
+              wtc2[j] = wtc[j]; wtc[j] = w;
+            }
+            if (m) {
+              w = Math::muladd(A, ws[j], B * ws2[j]) + RS;
+              ws2[j] = ws[j]; ws[j] = w;
+              if (gradp) {
+                w = Math::muladd(A, wrs[j], B * wrs2[j]) + (n + 1) * RS;
+                wrs2[j] = wrs[j]; wrs[j] = w;
+                w = Math::muladd(A, wts[j], B * wts2[j]) - u[j] * Ax * ws2[j];
+                wts2[j] = wts[j]; wts[j] = w;
+              }
+            }
+          }
+        }
+        for (int j = 0; j < K && i0 + j < num; ++j) {
+          if (!gradp)
+            circ[i0 + j].SetCoeff(m, wc[j], ws[j]);
+          else {
+            // Include the terms Sc[m] * P'[m,m](t) and  Ss[m] * P'[m,m](t)
+            wtc[j] += m * tu[j] * wc[j]; wts[j] += m * tu[j] * ws[j];
+            circ[i0 + j].SetCoeff(m, wc[j], ws[j],
+                                  wrc[j], wrs[j], wtc[j], wts[j]);
+          }
+        }
+      }
+    }
   }
 
   void SphericalEngine::RootTable(int N) {
     // Need square roots up to max(2 * N + 5, 15).
-    vector<real>& root( sqrttable() );
-    int L = max(2 * N + 5, 15) + 1, oldL = int(root.size());
-    if (oldL >= L)
+    int L = max(2 * N + 5, 15) + 1;
+    if (int(sqrttable().size()) >= L)
       return;
-    root.resize(L);
+    SqrtTables& tables = sqrttables();
+    lock_guard<mutex> guard(tables.lock);
+    const vector<real>& oldroot =
+      *tables.current.load(memory_order_relaxed);
+    int oldL = int(oldroot.size());
+    if (oldL >= L)              // Another thread got here first
+      return;
+    L = max(L, 2 * oldL);
+    unique_ptr<vector<real>> root(new vector<real>(oldroot));
+    root->resize(L);
     for (int l = oldL; l < L; ++l)
-      root[l] = sqrt(real(l));
+      (*root)[l] = sqrt(real(l));
+    const vector<real>* newroot = root.get();
+    tables.all.push_back(move(root));
+    tables.current.store(newroot, memory_order_release);
+  }
+
+  void SphericalEngine::ClearRootTable() {
+    SqrtTables& tables = sqrttables();
+    lock_guard<mutex> guard(tables.lock);
+    tables.reset();
+  }
+
+  size_t SphericalEngine::RootTableBytes() {
+    SqrtTables& tables = sqrttables();
+    lock_guard<mutex> guard(tables.lock);
+    size_t bytes = 0;
+    for (const auto& t : tables.all)
+      bytes += t->capacity() * sizeof(real);
+    return bytes;
+  }
+
+  void SphericalEngine::LegendreTable(int N, normalization norm) {
+    if (!(norm == FULL || norm == SCHMIDT))
+      throw GeographicErr("Unknown normalization");
+    if (legendretable(norm, N))
+      return;
+    RootTable(N);
+    const vector<real>& root( sqrttable() );
+    LegendreTables& tables = legendretables();
+    lock_guard<mutex> guard(tables.lock);
+    if (legendretable(norm, N))  // Another thread got here first
+      return;
+    unique_ptr<LegendreTab> tab(new LegendreTab(N));
+    tab->ab.resize(size_t(N + 1) * (N + 2));
+    for (int m = 0; m <= N; ++m) {
+      real* ab = tab->ab.data() + 2 * (tab->start(m) - m);
+      for (int n = m; n <= N; ++n) {
+        if (norm == FULL)
+          Recursion<FULL>(root, n, m, ab[2 * n], ab[2 * n + 1]);
+        else
+          Recursion<SCHMIDT>(root, n, m, ab[2 * n], ab[2 * n + 1]);
+      }
+    }
+    const LegendreTab* newtab = tab.get();
+    tables.all.push_back(move(tab));
+    tables.current[norm].store(newtab, memory_order_release);
+  }
+
+  void SphericalEngine::ClearLegendreTables() {
+    LegendreTables& tables = legendretables();
+    lock_guard<mutex> guard(tables.lock);
+    tables.reset();
+  }
+
+  size_t SphericalEngine::LegendreTableBytes() {
+    LegendreTables& tables = legendretables();
+    lock_guard<mutex> guard(tables.lock);
+    size_t bytes = 0;
+    for (const auto& t : tables.all)
+      bytes += t->ab.capacity() * sizeof(real);
+    return bytes;
   }
 
   void SphericalEngine::coeff::readcoeffs(istream& stream, int& N, int& M,
@@ -427,45 +1134,227 @@ namespace GeographicLib {
     return;
   }
 
+  void SphericalEngine::coeff::Trim(int& N, int& M,
+                                    vector<real>& C, vector<real>& S) {
+    int N1 = -1, M1 = -1;
+    for (int m = 0, k = 0; m <= M; ++m)
+      for (int n = m; n <= N; ++n, ++k)
+        if (C[k] != 0 || (m > 0 && S[k - (N + 1)] != 0)) {
+          N1 = max(N1, n); M1 = m;
+        }
+    if (N1 == N && M1 == M)
+      return;
+    // Repack in place; the new index of each coefficient does not exceed
+    // the old one.
+    for (int m = 0, k = 0; m <= M1; ++m)
+      for (int n = m; n <= N1; ++n, ++k) {
+        int k0 = m * N - m * (m - 1) / 2 + n;
+        C[k] = C[k0];
+        if (m > 0) S[k - (N1 + 1)] = S[k0 - (N + 1)];
+      }
+    N = N1; M = M1;
+    vector<real>(C.begin(), C.begin() + Csize(N, M)).swap(C);
+    vector<real>(S.begin(), S.begin() + Ssize(N, M)).swap(S);
+  }
+
+  SphericalEngine::coeff
+  SphericalEngine::coeff::mapcoeffs(const char* data, size_t size,
+                                    size_t& pos, int& N, int& M,
+                                    bool truncate) {
+    // The coefficients in the file are little-endian doubles; these can only
+    // be used in place if this matches the native representation of real.
+    if (Math::bigendian || !is_same<real, double>::value)
+      throw GeographicErr("Cannot map coefficients with this configuration");
+    if (truncate) {
+      if (!((N >= M && M >= 0) || (N == -1 && M == -1)))
+        // The last condition is that M = -1 implies N = -1.
+        throw GeographicErr("Bad requested degree and order " +
+                            Utility::str(N) + " " + Utility::str(M));
+    }
+    int nm[2];
+    if (!(pos <= size && size - pos >= sizeof(nm)))
+      throw GeographicErr("Coefficient data too short");
+    memcpy(nm, data + pos, sizeof(nm));
+    pos += sizeof(nm);
+    int N0 = nm[0], M0 = nm[1];
+    if (!((N0 >= M0 && M0 >= 0) || (N0 == -1 && M0 == -1)))
+      // The last condition is that M0 = -1 implies N0 = -1.
+      throw GeographicErr("Bad degree and order " +
+                          Utility::str(N0) + " " + Utility::str(M0));
+    size_t
+      nc = size_t(SphericalEngine::coeff::Csize(N0, M0)),
+      ns = size_t(SphericalEngine::coeff::Ssize(N0, M0));
+    if ((size - pos) / sizeof(real) < nc + ns)
+      throw GeographicErr("Coefficient data too short");
+    if (reinterpret_cast<uintptr_t>(data + pos) % alignof(real) != 0)
+      throw GeographicErr("Coefficient data is misaligned");
+    const real* C = reinterpret_cast<const real*>(data + pos);
+    pos += (nc + ns) * sizeof(real);
+    N = truncate ? min(N, N0) : N0;
+    M = truncate ? min(M, M0) : M0;
+    return coeff(C, C + nc, N0, N, M);
+  }
+
   /// \cond SKIP
   template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::FULL, 1>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::FULL, 1>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
 
   template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::FULL, 2>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::FULL, 2>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 2>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
 
   template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::FULL, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::FULL, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
   template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
   SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real, real, real&, real&, real&);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Value<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   int);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Values<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[],
+   const real[], real, real[], real[], real[], real[]);
+
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
+  template Math::real GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Hessian<SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, real, real&, real&, real&,
+   real[]);
 
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
@@ -505,6 +1394,96 @@ namespace GeographicLib {
   template CircularEngine GEOGRAPHICLIB_EXPORT
   SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
   (const coeff[], const real[], real, real, real);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], real, real, real, int);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], real, real, real, int);
+
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, int);
+  template CircularEngine GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circle<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], real, real, real, int);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 1>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 1>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 2>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 2>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::FULL, 3>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<true, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
+  template void GEOGRAPHICLIB_EXPORT
+  SphericalEngine::Circles<false, SphericalEngine::SCHMIDT, 3>
+  (const coeff[], const real[], size_t, const real[], const real[], real,
+   CircularEngine[]);
   /// \endcond
 
 } // namespace GeographicLib
@@ -0,0 +1,89 @@
+/**
+ * \file TrackStatistics.cpp
+ * \brief Implementation for GeographicLib::TrackStatistics class
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <GeographicLib/TrackStatistics.hpp>
+#include <GeographicLib/Executor.hpp>
+#include <atomic>
+#include <vector>
+
+namespace GeographicLib {
+
+  using namespace std;
+
+  void TrackStatistics::Add(size_t n, const real lat[], const real lon[],
+                            const real time[],
+                            real s12[], real azi[], real speed[],
+                            int nthreads) {
+    if (n == 0) return;
+    const unsigned outmask = Geodesic::DISTANCE | Geodesic::AZIMUTH;
+    size_t nblocks = (n + nb_ - 1) / nb_;
+    // The length and maximum speed of each block
+    vector<Accumulator<>> part(nblocks);
+    vector<real> vmax(nblocks, Math::NaN());
+    // A reproducible build instead adds the segment lengths one at a time
+    // in order (as AddPoint does); lens holds them.
+    vector<real> len(Math::reproducible && !s12 ? n : 0);
+    real* lens = s12 ? s12 : len.data();
+    atomic<size_t> next(0);
+    auto worker = [&](int) -> void {
+      vector<real> bs12(nb_), bazi1(nb_), bazi2(nb_);
+      for (size_t b; (b = next.fetch_add(1)) < nblocks;) {
+        // Block b holds the segments ending at vertices [i0, i1).
+        size_t i0 = b * nb_, i1 = min(n, i0 + nb_), j0 = i0;
+        if (i0 == 0) {
+          // The segment joining this chunk to the previous one
+          real t;
+          if (_num > 0)
+            _geod.GenInverse(_lat1, _lon1, lat[0], lon[0], outmask,
+                             bs12[0], bazi1[0], bazi2[0], t, t, t, t);
+          else {
+            bs12[0] = 0; bazi1[0] = Math::NaN();
+          }
+          j0 = 1;
+        }
+        _geod.InverseBatch(i1 - j0, lat + j0 - 1, lon + j0 - 1,
+                           lat + j0, lon + j0, outmask,
+                           bs12.data() + (j0 - i0), bazi1.data() + (j0 - i0),
+                           bazi2.data() + (j0 - i0),
+                           nullptr, nullptr, nullptr, nullptr);
+        for (size_t i = i0; i < i1; ++i) {
+          size_t k = i - i0;
+          if (Math::reproducible)
+            lens[i] = bs12[k];
+          else {
+            part[b] += bs12[k];
+            if (s12) s12[i] = bs12[k];
+          }
+          if (azi) azi[i] = bazi1[k];
+          real v = Math::NaN();
+          if (time && (i > 0 || _num > 0)) {
+            real dt = time[i] - (i > 0 ? time[i - 1] : _time1);
+            if (dt > 0) v = bs12[k] / dt;
+          }
+          if (speed) speed[i] = v;
+          vmax[b] = fmax(vmax[b], v);
+        }
+      }
+    };
+    Executor::Batch(int(min(size_t(max(1, nthreads)), nblocks)), worker);
+    // Combine the partial sums in order
+    for (size_t b = 0; b < nblocks; ++b) {
+      if (!Math::reproducible) _length += part[b];
+      _maxspeed = fmax(_maxspeed, vmax[b]);
+    }
+    if (Math::reproducible)
+      for (size_t i = 0; i < n; ++i) _length += lens[i];
+    if (_num == 0)
+      _time0 = time ? time[0] : Math::NaN();
+    _num += n;
+    _lat1 = lat[n - 1]; _lon1 = lon[n - 1];
+    _time1 = time ? time[n - 1] : Math::NaN();
+  }
+
+} // namespace GeographicLib
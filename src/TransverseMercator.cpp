@@ -36,6 +36,7 @@
 
 #include <complex>
 #include <GeographicLib/TransverseMercator.hpp>
+#include <GeographicLib/Registry.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about enum-float expressions
@@ -47,7 +48,7 @@ namespace GeographicLib {
   using namespace std;
 
   TransverseMercator::TransverseMercator(real a, real f, real k0,
-                                         bool exact, bool extendp)
+                                         bool exact, bool extendp, int order)
     : _a(a)
     , _f(f)
     , _k0(k0)
@@ -59,6 +60,7 @@ namespace GeographicLib {
       // See, for example, Lee (1976), p 100.
     , _c( sqrt(_e2m) * exp(Math::eatanhe(real(1), _es)) )
     , _n(_f / (2 - _f))
+    , _order(order < 0 ? maxpow_ : min(order, int(maxpow_)))
     , _tmexact(_exact ? TransverseMercatorExact(a, f, k0, extendp) :
                TransverseMercatorExact())
   {
@@ -71,6 +73,8 @@ namespace GeographicLib {
       throw GeographicErr("Scale is not positive");
     if (extendp)
       throw GeographicErr("TransverseMercator extendp not allowed if !exact");
+    if (!(order < 0 || order >= 4))
+      throw GeographicErr("TransverseMercator order must be at least 4");
 
     // Generated by Maxima on 2015-05-14 22:55:13-04:00
 #if GEOGRAPHICLIB_TRANSVERSEMERCATOR_ORDER/2 == 2
@@ -291,6 +295,19 @@ namespace GeographicLib {
     return utm;
   }
 
+  const TransverseMercator&
+  TransverseMercator::Get(real a, real f, real k0,
+                          bool exact, bool extendp, int order) {
+    static Registry<TransverseMercator> registry;
+    // The flags encode exact, extendp, and order.
+    return registry.Get(a, f, k0,
+                        int(exact) + 2 * int(extendp) + 4 * order,
+                        [=]() -> TransverseMercator* {
+                          return new TransverseMercator(a, f, k0, exact,
+                                                        extendp, order);
+                        });
+  }
+
   // Engsager and Poder (2007) use trigonometric series to convert between phi
   // and phip.  Here are the series...
   //
@@ -362,167 +379,301 @@ namespace GeographicLib {
                                    real& gamma, real& k) const {
     if (_exact)
       return _tmexact.Forward(lon0, lat, lon, x, y, gamma, k);
-    lat = Math::LatFix(lat);
-    lon = Math::AngDiff(lon0, lon);
-    // Explicitly enforce the parity
-    int
-      latsign = signbit(lat) ? -1 : 1,
-      lonsign = signbit(lon) ? -1 : 1;
-    lon *= lonsign;
-    lat *= latsign;
-    bool backside = lon > Math::qd;
-    if (backside) {
-      if (lat == 0)
-        latsign = -1;
-      lon = Math::hd - lon;
+    ForwardBlock<1>(lon0, &lat, &lon, &x, &y, &gamma, &k);
+  }
+
+  void TransverseMercator::Forward(real lon0, real lat, real lon,
+                                   real& x, real& y) const {
+    if (_exact)
+      return _tmexact.Forward(lon0, lat, lon, x, y);
+    ForwardBlock<1>(lon0, &lat, &lon, &x, &y, nullptr, nullptr);
+  }
+
+  void TransverseMercator::Forward(real lon0, size_t n,
+                                   const real lat[], const real lon[],
+                                   real x[], real y[],
+                                   real gamma[], real k[]) const {
+    if (_exact)
+      return _tmexact.Forward(lon0, n, lat, lon, x, y, gamma, k);
+    const int b = blocksize_;
+    size_t i = 0;
+    for (; i + b <= n; i += b)
+      ForwardBlock<b>(lon0, lat + i, lon + i, x + i, y + i,
+                      gamma ? gamma + i : nullptr, k ? k + i : nullptr);
+    if (i < n) {
+      // Pad the last partial block
+      int m = int(n - i);
+      real latx[b], lonx[b], xx[b], yx[b], gammax[b], kx[b];
+      fill(latx, latx + b, real(0)); fill(lonx, lonx + b, lon0);
+      copy(lat + i, lat + n, latx); copy(lon + i, lon + n, lonx);
+      ForwardBlock<b>(lon0, latx, lonx, xx, yx,
+                      gamma ? gammax : nullptr, k ? kx : nullptr);
+      copy(xx, xx + m, x + i); copy(yx, yx + m, y + i);
+      if (gamma) copy(gammax, gammax + m, gamma + i);
+      if (k) copy(kx, kx + m, k + i);
     }
-    real sphi, cphi, slam, clam;
-    Math::sincosd(lat, sphi, cphi);
-    Math::sincosd(lon, slam, clam);
-    // phi = latitude
-    // phi' = conformal latitude
-    // psi = isometric latitude
-    // tau = tan(phi)
-    // tau' = tan(phi')
-    // [xi', eta'] = Gauss-Schreiber TM coordinates
-    // [xi, eta] = Gauss-Krueger TM coordinates
-    //
-    // We use
-    //   tan(phi') = sinh(psi)
-    //   sin(phi') = tanh(psi)
-    //   cos(phi') = sech(psi)
-    //   denom^2    = 1-cos(phi')^2*sin(lam)^2 = 1-sech(psi)^2*sin(lam)^2
-    //   sin(xip)   = sin(phi')/denom          = tanh(psi)/denom
-    //   cos(xip)   = cos(phi')*cos(lam)/denom = sech(psi)*cos(lam)/denom
-    //   cosh(etap) = 1/denom                  = 1/denom
-    //   sinh(etap) = cos(phi')*sin(lam)/denom = sech(psi)*sin(lam)/denom
-    real etap, xip;
-    if (lat != Math::qd) {
+  }
+
+  void TransverseMercator::Forward(real lon0, size_t n,
+                                   StridedArray<const real> lat,
+                                   StridedArray<const real> lon,
+                                   StridedArray<real> x, StridedArray<real> y,
+                                   StridedArray<real> gamma,
+                                   StridedArray<real> k) const {
+    if (_exact)
+      return _tmexact.Forward(lon0, n, lat, lon, x, y, gamma, k);
+    // Copy each block to contiguous arrays, padding the last one as in the
+    // array version.
+    const int b = blocksize_;
+    real latx[b], lonx[b], xx[b], yx[b], gammax[b], kx[b];
+    for (size_t i = 0; i < n; i += b) {
+      int m = int(min(size_t(b), n - i));
+      for (int j = 0; j < b; ++j) {
+        latx[j] = j < m ? lat[i + j] : 0;
+        lonx[j] = j < m ? lon[i + j] : lon0;
+      }
+      ForwardBlock<b>(lon0, latx, lonx, xx, yx,
+                      gamma ? gammax : nullptr, k ? kx : nullptr);
+      for (int j = 0; j < m; ++j) {
+        x[i + j] = xx[j]; y[i + j] = yx[j];
+        if (gamma) gamma[i + j] = gammax[j];
+        if (k) k[i + j] = kx[j];
+      }
+    }
+  }
+
+  template<int n>
+  void TransverseMercator::ForwardBlock(real lon0,
+                                        const real lat[], const real lon[],
+                                        real x[], real y[],
+                                        real gamma[], real k[]) const {
+    const bool scalp = gamma || k;
+    // The state of each point between the stages of the calculation
+    int latsign[n], lonsign[n];
+    bool backside[n];
+    real xip[n], etap[n],
+      c0[n], s0[n], ch0[n], sh0[n],
+      xi[n], eta[n], zr[n], zi[n],
+      // gam and kap are only set if scalp; initialize to quiet the compiler
+      gam[n] = {}, kap[n] = {};
+    for (int i = 0; i < n; ++i) {
       real
-        tau = sphi / cphi,
-        taup = Math::taupf(tau, _es);
-      xip = atan2(taup, clam);
-      // Used to be
-      //   etap = Math::atanh(sin(lam) / cosh(psi));
-      etap = asinh(slam / hypot(taup, clam));
-      // convergence and scale for Gauss-Schreiber TM (xip, etap) -- gamma0 =
-      // atan(tan(xip) * tanh(etap)) = atan(tan(lam) * sin(phi'));
-      // sin(phi') = tau'/sqrt(1 + tau'^2)
-      // Krueger p 22 (44)
-      gamma = Math::atan2d(slam * taup, clam * hypot(real(1), taup));
-      // k0 = sqrt(1 - _e2 * sin(phi)^2) * (cos(phi') / cos(phi)) * cosh(etap)
-      // Note 1/cos(phi) = cosh(psip);
-      // and cos(phi') * cosh(etap) = 1/hypot(sinh(psi), cos(lam))
+        phi = Math::LatFix(lat[i]),
+        lam = Math::AngDiff(lon0, lon[i]);
+      // Explicitly enforce the parity
+      latsign[i] = signbit(phi) ? -1 : 1;
+      lonsign[i] = signbit(lam) ? -1 : 1;
+      lam *= lonsign[i];
+      phi *= latsign[i];
+      backside[i] = lam > Math::qd;
+      if (backside[i]) {
+        if (phi == 0)
+          latsign[i] = -1;
+        lam = Math::hd - lam;
+      }
+      real sphi, cphi, slam, clam;
+      Math::sincosd(phi, sphi, cphi);
+      Math::sincosd(lam, slam, clam);
+      // phi = latitude
+      // phi' = conformal latitude
+      // psi = isometric latitude
+      // tau = tan(phi)
+      // tau' = tan(phi')
+      // [xi', eta'] = Gauss-Schreiber TM coordinates
+      // [xi, eta] = Gauss-Krueger TM coordinates
       //
-      // This form has cancelling errors.  This property is lost if cosh(psip)
-      // is replaced by 1/cos(phi), even though it's using "primary" data (phi
-      // instead of psip).
-      k = sqrt(_e2m + _e2 * Math::_sq(cphi)) * hypot(real(1), tau)
-        / hypot(taup, clam);
-    } else {
-      xip = Math::pi()/2;
-      etap = 0;
-      gamma = lon;
-      k = _c;
+      // We use
+      //   tan(phi') = sinh(psi)
+      //   sin(phi') = tanh(psi)
+      //   cos(phi') = sech(psi)
+      //   denom^2    = 1-cos(phi')^2*sin(lam)^2 = 1-sech(psi)^2*sin(lam)^2
+      //   sin(xip)   = sin(phi')/denom          = tanh(psi)/denom
+      //   cos(xip)   = cos(phi')*cos(lam)/denom = sech(psi)*cos(lam)/denom
+      //   cosh(etap) = 1/denom                  = 1/denom
+      //   sinh(etap) = cos(phi')*sin(lam)/denom = sech(psi)*sin(lam)/denom
+      if (phi != Math::qd) {
+        real
+          tau = sphi / cphi,
+          taup = Math::taupf(tau, _es),
+          taup1 = hypot(real(1), taup),
+          // h = hypot(sinh(psi), cos(lam)) = cosh(psi) * denom
+          h = hypot(taup, clam),
+          sx = taup / h, cx = clam / h,    // sin(xip), cos(xip)
+          shx = slam / h, chx = taup1 / h; // sinh(etap), cosh(etap)
+        xip[i] = atan2(taup, clam);
+        // Used to be
+        //   etap = Math::atanh(sin(lam) / cosh(psi));
+        etap[i] = asinh(shx);
+        // The double angle formulas give the trigonometric and hyperbolic
+        // functions of 2*xip and 2*etap needed for the series.
+        s0[i] = 2 * sx * cx; c0[i] = (cx - sx) * (cx + sx);
+        sh0[i] = 2 * shx * chx; ch0[i] = 1 + 2 * Math::_sq(shx);
+        // convergence and scale for Gauss-Schreiber TM (xip, etap) -- gamma0
+        // = atan(tan(xip) * tanh(etap)) = atan(tan(lam) * sin(phi'));
+        // sin(phi') = tau'/sqrt(1 + tau'^2)
+        // Krueger p 22 (44)
+        if (scalp) {
+          gam[i] = Math::atan2d(slam * taup, clam * taup1);
+          // k0 = sqrt(1 - _e2 * sin(phi)^2) * (cos(phi') / cos(phi)) *
+          //   cosh(etap)
+          // Note 1/cos(phi) = cosh(psip);
+          // and cos(phi') * cosh(etap) = 1/hypot(sinh(psi), cos(lam))
+          //
+          // This form has cancelling errors.  This property is lost if
+          // cosh(psip) is replaced by 1/cos(phi), even though it's using
+          // "primary" data (phi instead of psip).
+          kap[i] = sqrt(_e2m + _e2 * Math::_sq(cphi)) *
+            hypot(real(1), tau) / h;
+        }
+      } else {
+        xip[i] = Math::pi()/2;
+        etap[i] = 0;
+        s0[i] = 0; c0[i] = -1; sh0[i] = 0; ch0[i] = 1;
+        gam[i] = lam;
+        kap[i] = _c;
+      }
+    }
+    Series<n>(_order, _alp, 1, scalp, xip, etap, c0, s0, ch0, sh0,
+              xi, eta, zr, zi);
+    for (int i = 0; i < n; ++i) {
+      y[i] = _a1 * _k0 * (backside[i] ? Math::pi() - xi[i] : xi[i]) *
+        latsign[i];
+      x[i] = _a1 * _k0 * eta[i] * lonsign[i];
+      if (!scalp) continue;
+      // Fold in change in convergence and scale for Gauss-Schreiber TM to
+      // Gauss-Krueger TM.
+      real
+        gammax = gam[i] - Math::atan2d(zi[i], zr[i]),
+        kx = kap[i] * _b1 * abs(complex<real>(zr[i], zi[i]));
+      if (backside[i])
+        gammax = Math::hd - gammax;
+      gammax *= latsign[i] * lonsign[i];
+      if (gamma) gamma[i] = Math::AngNormalize(gammax);
+      if (k) k[i] = kx * _k0;
     }
-    // {xi',eta'} is {northing,easting} for Gauss-Schreiber transverse Mercator
-    // (for eta' = 0, xi' = bet). {xi,eta} is {northing,easting} for transverse
-    // Mercator with constant scale on the central meridian (for eta = 0, xip =
-    // rectifying latitude).  Define
-    //
-    //   zeta = xi + i*eta
-    //   zeta' = xi' + i*eta'
-    //
-    // The conversion from conformal to rectifying latitude can be expressed as
-    // a series in _n:
-    //
-    //   zeta = zeta' + sum(h[j-1]' * sin(2 * j * zeta'), j = 1..maxpow_)
-    //
-    // where h[j]' = O(_n^j).  The reversion of this series gives
-    //
-    //   zeta' = zeta - sum(h[j-1] * sin(2 * j * zeta), j = 1..maxpow_)
-    //
-    // which is used in Reverse.
-    //
-    // Evaluate sums via Clenshaw method.  See
-    //    https://en.wikipedia.org/wiki/Clenshaw_algorithm
-    //
-    // Let
-    //
-    //    S = sum(a[k] * phi[k](x), k = 0..n)
-    //    phi[k+1](x) = alpha[k](x) * phi[k](x) + beta[k](x) * phi[k-1](x)
-    //
-    // Evaluate S with
-    //
-    //    b[n+2] = b[n+1] = 0
-    //    b[k] = alpha[k](x) * b[k+1] + beta[k+1](x) * b[k+2] + a[k]
-    //    S = (a[0] + beta[1](x) * b[2]) * phi[0](x) + b[1] * phi[1](x)
-    //
-    // Here we have
-    //
-    //    x = 2 * zeta'
-    //    phi[k](x) = sin(k * x)
-    //    alpha[k](x) = 2 * cos(x)
-    //    beta[k](x) = -1
-    //    [ sin(A+B) - 2*cos(B)*sin(A) + sin(A-B) = 0, A = k*x, B = x ]
-    //    n = maxpow_
-    //    a[k] = _alp[k]
-    //    S = b[1] * sin(x)
-    //
-    // For the derivative we have
-    //
-    //    x = 2 * zeta'
-    //    phi[k](x) = cos(k * x)
-    //    alpha[k](x) = 2 * cos(x)
-    //    beta[k](x) = -1
-    //    [ cos(A+B) - 2*cos(B)*cos(A) + cos(A-B) = 0, A = k*x, B = x ]
-    //    a[0] = 1; a[k] = 2*k*_alp[k]
-    //    S = (a[0] - b[2]) + b[1] * cos(x)
-    //
-    // Matrix formulation (not used here):
-    //    phi[k](x) = [sin(k * x); k * cos(k * x)]
-    //    alpha[k](x) = 2 * [cos(x), 0; -sin(x), cos(x)]
-    //    beta[k](x) = -1 * [1, 0; 0, 1]
-    //    a[k] = _alp[k] * [1, 0; 0, 1]
-    //    b[n+2] = b[n+1] = [0, 0; 0, 0]
-    //    b[k] = alpha[k](x) * b[k+1] + beta[k+1](x) * b[k+2] + a[k]
-    //    N.B., for all k: b[k](1,2) = 0; b[k](1,1) = b[k](2,2)
-    //    S = (a[0] + beta[1](x) * b[2]) * phi[0](x) + b[1] * phi[1](x)
-    //    phi[0](x) = [0; 0]
-    //    phi[1](x) = [sin(x); cos(x)]
+  }
+
+  // {xi',eta'} is {northing,easting} for Gauss-Schreiber transverse Mercator
+  // (for eta' = 0, xi' = bet). {xi,eta} is {northing,easting} for transverse
+  // Mercator with constant scale on the central meridian (for eta = 0, xip =
+  // rectifying latitude).  Define
+  //
+  //   zeta = xi + i*eta
+  //   zeta' = xi' + i*eta'
+  //
+  // The conversion from conformal to rectifying latitude can be expressed as
+  // a series in _n:
+  //
+  //   zeta = zeta' + sum(h[j-1]' * sin(2 * j * zeta'), j = 1..maxpow_)
+  //
+  // where h[j]' = O(_n^j).  The reversion of this series gives
+  //
+  //   zeta' = zeta - sum(h[j-1] * sin(2 * j * zeta), j = 1..maxpow_)
+  //
+  // which is used in Reverse.
+  //
+  // Evaluate sums via Clenshaw method.  See
+  //    https://en.wikipedia.org/wiki/Clenshaw_algorithm
+  //
+  // Let
+  //
+  //    S = sum(a[k] * phi[k](x), k = 0..n)
+  //    phi[k+1](x) = alpha[k](x) * phi[k](x) + beta[k](x) * phi[k-1](x)
+  //
+  // Evaluate S with
+  //
+  //    b[n+2] = b[n+1] = 0
+  //    b[k] = alpha[k](x) * b[k+1] + beta[k+1](x) * b[k+2] + a[k]
+  //    S = (a[0] + beta[1](x) * b[2]) * phi[0](x) + b[1] * phi[1](x)
+  //
+  // Here we have
+  //
+  //    x = 2 * zeta'
+  //    phi[k](x) = sin(k * x)
+  //    alpha[k](x) = 2 * cos(x)
+  //    beta[k](x) = -1
+  //    [ sin(A+B) - 2*cos(B)*sin(A) + sin(A-B) = 0, A = k*x, B = x ]
+  //    n = maxpow_
+  //    a[k] = _alp[k]
+  //    S = b[1] * sin(x)
+  //
+  // For the derivative we have
+  //
+  //    x = 2 * zeta'
+  //    phi[k](x) = cos(k * x)
+  //    alpha[k](x) = 2 * cos(x)
+  //    beta[k](x) = -1
+  //    [ cos(A+B) - 2*cos(B)*cos(A) + cos(A-B) = 0, A = k*x, B = x ]
+  //    a[0] = 1; a[k] = 2*k*_alp[k]
+  //    S = (a[0] - b[2]) + b[1] * cos(x)
+  //
+  // Matrix formulation (not used here):
+  //    phi[k](x) = [sin(k * x); k * cos(k * x)]
+  //    alpha[k](x) = 2 * [cos(x), 0; -sin(x), cos(x)]
+  //    beta[k](x) = -1 * [1, 0; 0, 1]
+  //    a[k] = _alp[k] * [1, 0; 0, 1]
+  //    b[n+2] = b[n+1] = [0, 0; 0, 0]
+  //    b[k] = alpha[k](x) * b[k+1] + beta[k+1](x) * b[k+2] + a[k]
+  //    N.B., for all k: b[k](1,2) = 0; b[k](1,1) = b[k](2,2)
+  //    S = (a[0] + beta[1](x) * b[2]) * phi[0](x) + b[1] * phi[1](x)
+  //    phi[0](x) = [0; 0]
+  //    phi[1](x) = [sin(x); cos(x)]
+  //
+  // Series carries out the Clenshaw sums (with a[k] = sign * c[k]) in
+  // parallel for all the points in a block, holding the real and imaginary
+  // parts in separate arrays, so that the compiler can vectorize the loops.
+  // Reverse uses sign = -1 and c = _bet.
+  template<int n>
+  void TransverseMercator::Series(int order, const real c[], real sign,
+                                  bool scalp,
+                                  const real xi[], const real eta[],
+                                  const real c0[], const real s0[],
+                                  const real ch0[], const real sh0[],
+                                  real xi1[], real eta1[],
+                                  real zr[], real zi[]) {
+    // y0 = b[k+1], y1 = b[k+2] for the series; z0, z1 similarly for the
+    // derivative
     real
-      c0 = cos(2 * xip), ch0 = cosh(2 * etap),
-      s0 = sin(2 * xip), sh0 = sinh(2 * etap);
-    complex<real> a(2 * c0 * ch0, -2 * s0 * sh0); // 2 * cos(2*zeta')
-    int n = maxpow_;
-    complex<real>
-      y0(n & 1 ?       _alp[n] : 0), y1, // default initializer is 0+i0
-      z0(n & 1 ? 2*n * _alp[n] : 0), z1;
-    if (n & 1) --n;
-    while (n) {
-      y1 = a * y0 - y1 +       _alp[n];
-      z1 = a * z0 - z1 + 2*n * _alp[n];
-      --n;
-      y0 = a * y1 - y0 +       _alp[n];
-      z0 = a * z1 - z0 + 2*n * _alp[n];
-      --n;
+      ar[n], ai[n],
+      yr0[n], yi0[n], yr1[n], yi1[n],
+      zr0[n], zi0[n], zr1[n], zi1[n];
+    for (int i = 0; i < n; ++i) {
+      // 2 * cos(2*zeta)
+      ar[i] = 2 * c0[i] * ch0[i]; ai[i] = -2 * s0[i] * sh0[i];
+      yr0[i] = yi0[i] = yr1[i] = yi1[i] = 0;
+      zr0[i] = zi0[i] = zr1[i] = zi1[i] = 0;
+    }
+    for (int j = order; j > 0; --j) {
+      real cy = sign * c[j];
+      for (int i = 0; i < n; ++i) {
+        real
+          tr = Math::muladd(ar[i], yr0[i], -(ai[i] * yi0[i])) - yr1[i] + cy,
+          ti = Math::muladd(ar[i], yi0[i], ai[i] * yr0[i]) - yi1[i];
+        yr1[i] = yr0[i]; yi1[i] = yi0[i];
+        yr0[i] = tr; yi0[i] = ti;
+      }
+      if (!scalp) continue;
+      real cz = sign * (2*j * c[j]);
+      for (int i = 0; i < n; ++i) {
+        real
+          tr = Math::muladd(ar[i], zr0[i], -(ai[i] * zi0[i])) - zr1[i] + cz,
+          ti = Math::muladd(ar[i], zi0[i], ai[i] * zr0[i]) - zi1[i];
+        zr1[i] = zr0[i]; zi1[i] = zi0[i];
+        zr0[i] = tr; zi0[i] = ti;
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      // sin(2*zeta)
+      complex<real> a(s0[i] * ch0[i], c0[i] * sh0[i]),
+        y1 = complex<real>(xi[i], eta[i]) + a * complex<real>(yr0[i], yi0[i]);
+      xi1[i] = y1.real(); eta1[i] = y1.imag();
+      if (!scalp) continue;
+      // cos(2*zeta)
+      a = complex<real>(c0[i] * ch0[i], -s0[i] * sh0[i]);
+      complex<real> z1 = real(1) - complex<real>(zr1[i], zi1[i]) +
+        a * complex<real>(zr0[i], zi0[i]);
+      zr[i] = z1.real(); zi[i] = z1.imag();
     }
-    a /= real(2);               // cos(2*zeta')
-    z1 = real(1) - z1 + a * z0;
-    a = complex<real>(s0 * ch0, c0 * sh0); // sin(2*zeta')
-    y1 = complex<real>(xip, etap) + a * y0;
-    // Fold in change in convergence and scale for Gauss-Schreiber TM to
-    // Gauss-Krueger TM.
-    gamma -= Math::atan2d(z1.imag(), z1.real());
-    k *= _b1 * abs(z1);
-    real xi = y1.real(), eta = y1.imag();
-    y = _a1 * _k0 * (backside ? Math::pi() - xi : xi) * latsign;
-    x = _a1 * _k0 * eta * lonsign;
-    if (backside)
-      gamma = Math::hd - gamma;
-    gamma *= latsign * lonsign;
-    gamma = Math::AngNormalize(gamma);
-    k *= _k0;
   }
 
   void TransverseMercator::Reverse(real lon0, real x, real y,
@@ -530,81 +681,145 @@ namespace GeographicLib {
                                    real& gamma, real& k) const {
     if (_exact)
       return _tmexact.Reverse(lon0, x, y, lat, lon, gamma, k);
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, &gamma, &k);
+  }
+
+  void TransverseMercator::Reverse(real lon0, real x, real y,
+                                   real& lat, real& lon) const {
+    if (_exact)
+      return _tmexact.Reverse(lon0, x, y, lat, lon);
+    ReverseBlock<1>(lon0, &x, &y, &lat, &lon, nullptr, nullptr);
+  }
+
+  void TransverseMercator::Reverse(real lon0, size_t n,
+                                   const real x[], const real y[],
+                                   real lat[], real lon[],
+                                   real gamma[], real k[]) const {
+    if (_exact)
+      return _tmexact.Reverse(lon0, n, x, y, lat, lon, gamma, k);
+    const int b = blocksize_;
+    size_t i = 0;
+    for (; i + b <= n; i += b)
+      ReverseBlock<b>(lon0, x + i, y + i, lat + i, lon + i,
+                      gamma ? gamma + i : nullptr, k ? k + i : nullptr);
+    if (i < n) {
+      // Pad the last partial block
+      int m = int(n - i);
+      real xx[b], yx[b], latx[b], lonx[b], gammax[b], kx[b];
+      fill(xx, xx + b, real(0)); fill(yx, yx + b, real(0));
+      copy(x + i, x + n, xx); copy(y + i, y + n, yx);
+      ReverseBlock<b>(lon0, xx, yx, latx, lonx,
+                      gamma ? gammax : nullptr, k ? kx : nullptr);
+      copy(latx, latx + m, lat + i); copy(lonx, lonx + m, lon + i);
+      if (gamma) copy(gammax, gammax + m, gamma + i);
+      if (k) copy(kx, kx + m, k + i);
+    }
+  }
+
+  void TransverseMercator::Reverse(real lon0, size_t n,
+                                   StridedArray<const real> x,
+                                   StridedArray<const real> y,
+                                   StridedArray<real> lat,
+                                   StridedArray<real> lon,
+                                   StridedArray<real> gamma,
+                                   StridedArray<real> k) const {
+    if (_exact)
+      return _tmexact.Reverse(lon0, n, x, y, lat, lon, gamma, k);
+    const int b = blocksize_;
+    real xx[b], yx[b], latx[b], lonx[b], gammax[b], kx[b];
+    for (size_t i = 0; i < n; i += b) {
+      int m = int(min(size_t(b), n - i));
+      for (int j = 0; j < b; ++j) {
+        xx[j] = j < m ? x[i + j] : 0;
+        yx[j] = j < m ? y[i + j] : 0;
+      }
+      ReverseBlock<b>(lon0, xx, yx, latx, lonx,
+                      gamma ? gammax : nullptr, k ? kx : nullptr);
+      for (int j = 0; j < m; ++j) {
+        lat[i + j] = latx[j]; lon[i + j] = lonx[j];
+        if (gamma) gamma[i + j] = gammax[j];
+        if (k) k[i + j] = kx[j];
+      }
+    }
+  }
+
+  template<int n>
+  void TransverseMercator::ReverseBlock(real lon0,
+                                        const real x[], const real y[],
+                                        real lat[], real lon[],
+                                        real gamma[], real k[]) const {
+    const bool scalp = gamma || k;
     // This undoes the steps in Forward.  The wrinkles are: (1) Use of the
     // reverted series to express zeta' in terms of zeta. (2) Newton's method
     // to solve for phi in terms of tan(phi).
-    real
-      xi = y / (_a1 * _k0),
-      eta = x / (_a1 * _k0);
-    // Explicitly enforce the parity
-    int
-      xisign = signbit(xi) ? -1 : 1,
-      etasign = signbit(eta) ? -1 : 1;
-    xi *= xisign;
-    eta *= etasign;
-    bool backside = xi > Math::pi()/2;
-    if (backside)
-      xi = Math::pi() - xi;
-    real
-      c0 = cos(2 * xi), ch0 = cosh(2 * eta),
-      s0 = sin(2 * xi), sh0 = sinh(2 * eta);
-    complex<real> a(2 * c0 * ch0, -2 * s0 * sh0); // 2 * cos(2*zeta)
-    int n = maxpow_;
-    complex<real>
-      y0(n & 1 ?       -_bet[n] : 0), y1, // default initializer is 0+i0
-      z0(n & 1 ? -2*n * _bet[n] : 0), z1;
-    if (n & 1) --n;
-    while (n) {
-      y1 = a * y0 - y1 -       _bet[n];
-      z1 = a * z0 - z1 - 2*n * _bet[n];
-      --n;
-      y0 = a * y1 - y0 -       _bet[n];
-      z0 = a * z1 - z0 - 2*n * _bet[n];
-      --n;
+    int xisign[n], etasign[n];
+    bool backside[n];
+    real xi[n], eta[n],
+      c0[n], s0[n], ch0[n], sh0[n],
+      xip[n], etap[n], zr[n], zi[n];
+    for (int i = 0; i < n; ++i) {
+      xi[i] = y[i] / (_a1 * _k0);
+      eta[i] = x[i] / (_a1 * _k0);
+      // Explicitly enforce the parity
+      xisign[i] = signbit(xi[i]) ? -1 : 1;
+      etasign[i] = signbit(eta[i]) ? -1 : 1;
+      xi[i] *= xisign[i];
+      eta[i] *= etasign[i];
+      backside[i] = xi[i] > Math::pi()/2;
+      if (backside[i])
+        xi[i] = Math::pi() - xi[i];
+      c0[i] = cos(2 * xi[i]); ch0[i] = cosh(2 * eta[i]);
+      s0[i] = sin(2 * xi[i]); sh0[i] = sinh(2 * eta[i]);
     }
-    a /= real(2);               // cos(2*zeta)
-    z1 = real(1) - z1 + a * z0;
-    a = complex<real>(s0 * ch0, c0 * sh0); // sin(2*zeta)
-    y1 = complex<real>(xi, eta) + a * y0;
-    // Convergence and scale for Gauss-Schreiber TM to Gauss-Krueger TM.
-    gamma = Math::atan2d(z1.imag(), z1.real());
-    k = _b1 / abs(z1);
-    // JHS 154 has
-    //
-    //   phi' = asin(sin(xi') / cosh(eta')) (Krueger p 17 (25))
-    //   lam = asin(tanh(eta') / cos(phi')
-    //   psi = asinh(tan(phi'))
-    real
-      xip = y1.real(), etap = y1.imag(),
-      s = sinh(etap),
-      c = fmax(real(0), cos(xip)), // cos(pi/2) might be negative
-      r = hypot(s, c);
-    if (r != 0) {
-      lon = Math::atan2d(s, c); // Krueger p 17 (25)
-      // Use Newton's method to solve for tau
+    Series<n>(_order, _bet, -1, scalp, xi, eta, c0, s0, ch0, sh0,
+              xip, etap, zr, zi);
+    for (int i = 0; i < n; ++i) {
+      // Convergence and scale for Gauss-Schreiber TM to Gauss-Krueger TM.
+      real gammax = 0, kx = 0;
+      if (scalp) {
+        gammax = Math::atan2d(zi[i], zr[i]);
+        kx = _b1 / abs(complex<real>(zr[i], zi[i]));
+      }
+      // JHS 154 has
+      //
+      //   phi' = asin(sin(xi') / cosh(eta')) (Krueger p 17 (25))
+      //   lam = asin(tanh(eta') / cos(phi')
+      //   psi = asinh(tan(phi'))
       real
-        sxip = sin(xip),
-        tau = Math::tauf(sxip/r, _es);
-      gamma += Math::atan2d(sxip * tanh(etap), c); // Krueger p 19 (31)
-      lat = Math::atand(tau);
-      // Note cos(phi') * cosh(eta') = r
-      k *= sqrt(_e2m + _e2 / (1 + Math::_sq(tau))) *
-        hypot(real(1), tau) * r;
-    } else {
-      lat = Math::qd;
-      lon = 0;
-      k *= _c;
+        s = sinh(etap[i]),
+        c = fmax(real(0), cos(xip[i])), // cos(pi/2) might be negative
+        r = hypot(s, c),
+        latx, lonx;
+      if (r != 0) {
+        lonx = Math::atan2d(s, c); // Krueger p 17 (25)
+        // Use Newton's method to solve for tau
+        real
+          sxip = sin(xip[i]),
+          tau = Math::tauf(sxip/r, _es);
+        latx = Math::atand(tau);
+        if (scalp) {
+          gammax += Math::atan2d(sxip * tanh(etap[i]), c); // Krueger p 19 (31)
+          // Note cos(phi') * cosh(eta') = r
+          kx *= sqrt(_e2m + _e2 / (1 + Math::_sq(tau))) *
+            hypot(real(1), tau) * r;
+        }
+      } else {
+        latx = Math::qd;
+        lonx = 0;
+        kx *= _c;
+      }
+      lat[i] = latx * xisign[i];
+      if (backside[i])
+        lonx = Math::hd - lonx;
+      lonx *= etasign[i];
+      lon[i] = Math::AngNormalize(lonx + lon0);
+      if (!scalp) continue;
+      if (backside[i])
+        gammax = Math::hd - gammax;
+      gammax *= xisign[i] * etasign[i];
+      if (gamma) gamma[i] = Math::AngNormalize(gammax);
+      if (k) k[i] = kx * _k0;
     }
-    lat *= xisign;
-    if (backside)
-      lon = Math::hd - lon;
-    lon *= etasign;
-    lon = Math::AngNormalize(lon + lon0);
-    if (backside)
-      gamma = Math::hd - gamma;
-    gamma *= xisign * etasign;
-    gamma = Math::AngNormalize(gamma);
-    k *= _k0;
   }
 
 } // namespace GeographicLib
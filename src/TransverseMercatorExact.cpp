@@ -42,6 +42,8 @@
  **********************************************************************/
 
 #include <GeographicLib/TransverseMercatorExact.hpp>
+#include <GeographicLib/Instrument.hpp>
+#include <complex>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional and enum-float expressions
@@ -75,6 +77,66 @@ namespace GeographicLib {
       throw GeographicErr("Polar semi-axis is not positive");
     if (!(isfinite(_k0) && _k0 > 0))
       throw GeographicErr("Scale is not positive");
+    SeriesInit();
+  }
+
+  void TransverseMercatorExact::SeriesInit() {
+    // Away from the singular points, the Thompson coordinate w = u + i*v is
+    // given in terms of the Gauss-Schreiber coordinate zeta' = xi' + i*eta'
+    // (the spherical TM of the conformal sphere) and in terms of sigma by
+    //
+    //   w * pi/(2*K) = zeta'     + sum(c[j] * sin(2*j*zeta'), j, 1, inf)
+    //   w * pi/K     = sigma' + sum(d[j] * sin(j*sigma'), j, 1, inf)
+    //
+    // where K = Eu.K(), sigma' = sigma * pi/Eu.E(), and the coefficients
+    // decrease geometrically (the ratio is about e^2/16).  The coefficients
+    // are found by evaluating the exact inverse on the central meridian and
+    // taking a discrete sine transform.  The series diverge at the singular
+    // point w = i*Ev.K() (lam = (1 - e) * pi/2 on the equator) where eta' =
+    // asinh(cot(e * pi/2)), so they are only used for eta' < _serlim, 0.6
+    // times this value.  (For WGS84, this is lon < 69d on the equator.)  In
+    // this region, the starting guesses are good enough that Newton's method
+    // converges in 2 iterations instead of about 4.
+    _serp = false;
+    _serlim = real(0.6) * asinh(1 / tan(_e * Math::pi()/2));
+    const int m = 2 * nser_;
+    real hz[m], hs[m];
+    for (int j = 1; j < m; ++j) {
+      real t = j * Math::pi() / m, u, v;
+      // On the central meridian xi' = gd(psi), so taup = tan(xi')
+      zetainv(tan(t/2), 0, u, v);
+      hz[j] = u * (Math::pi()/2) / _eEu.K() - t/2;
+      sigmainv(t * _eEu.E() / Math::pi(), 0, u, v);
+      hs[j] = u * Math::pi() / _eEu.K() - t;
+    }
+    _zetc[0] = _sigc[0] = 0;
+    for (int k = 1; k <= nser_; ++k) {
+      real cz = 0, cs = 0;
+      for (int j = 1; j < m; ++j) {
+        real sn = sin((k * j) % (2 * m) * Math::pi() / m);
+        cz += hz[j] * sn;
+        cs += hs[j] * sn;
+      }
+      _zetc[k] = 2 * cz / m;
+      _sigc[k] = 2 * cs / m;
+    }
+    _serp = true;
+  }
+
+  void TransverseMercatorExact::SinSeries(const real c[], real x, real y,
+                                          real& sx, real& sy) {
+    // Evaluate sum(c[j] * sin(j*z), j, 1, nser_) for z = x + i*y using
+    // Clenshaw summation.
+    complex<real>
+      z(x, y),
+      a = real(2) * cos(z),
+      b1(0), b2(0);
+    for (int j = nser_; j > 0; --j) {
+      complex<real> b0 = a * b1 - b2 + c[j];
+      b2 = b1; b1 = b0;
+    }
+    complex<real> s = b1 * sin(z);
+    sx = s.real(); sy = s.imag();
   }
 
   const TransverseMercatorExact& TransverseMercatorExact::UTM() {
@@ -178,6 +240,12 @@ namespace GeographicLib {
       // log singularity at zeta = Eu.K() (corresponding to the north pole)
       v = asinh(sin(lam) / hypot(cos(lam), sinh(psi)));
       u = atan2(sinh(psi), cos(lam));
+      if (_serp && fabs(v) < _serlim) {
+        // Correct this using the Fourier series, see SeriesInit
+        real du, dv;
+        SinSeries(_zetc, 2 * u, 2 * v, du, dv);
+        u += du; v += dv;
+      }
       // But scale to put 90,0 on the right place
       u *= _eEu.K() / (Math::pi()/2);
       v *= _eEu.K() / (Math::pi()/2);
@@ -191,11 +259,15 @@ namespace GeographicLib {
     real
       psi = asinh(taup),
       scal = 1/hypot(real(1), taup);
-    if (zetainv0(psi, lam, u, v))
+    if (zetainv0(psi, lam, u, v)) {
+      GEOGRAPHICLIB_INSTRUMENT_RECORD(TMEXACT_ZETAINV, 0, false);
       return;
+    }
     real stol2 = tol2_ / Math::_sq(fmax(psi, real(1)));
-    // min iterations = 2, max iterations = 6; mean = 4.0
-    for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
+    // min iterations = 2, max iterations = 6; mean = 4.0 (2 iterations
+    // suffice when the Fourier series starting guess is used)
+    int i = 0, trip = 0;
+    for (; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       real snu, cnu, dnu, snv, cnv, dnv;
       _eEu.sncndn(u, snu, cnu, dnu);
       _eEv.sncndn(v, snv, cnv, dnv);
@@ -216,6 +288,7 @@ namespace GeographicLib {
       if (!(delw2 >= stol2))
         ++trip;
     }
+    GEOGRAPHICLIB_INSTRUMENT_RECORD(TMEXACT_ZETAINV, i + (i < numit_), !trip);
   }
 
   void TransverseMercatorExact::sigma(real /*u*/, real snu, real cnu, real dnu,
@@ -285,6 +358,15 @@ namespace GeographicLib {
       ang /= 3;
       u = rad * cos(ang);
       v = rad * sin(ang) + _eEv.K();
+    } else if (_serp && fabs(eta) * Math::pi() / _eEu.E() < 2 * _serlim) {
+      // Use the Fourier series for w in terms of sigma, see SeriesInit.
+      real
+        x = xi * Math::pi() / _eEu.E(),
+        y = eta * Math::pi() / _eEu.E(),
+        du, dv;
+      SinSeries(_sigc, x, y, du, dv);
+      u = (x + du) * _eEu.K() / Math::pi();
+      v = (y + dv) * _eEu.K() / Math::pi();
     } else {
       // Else use w = sigma * Eu.K/Eu.E (which is correct in the limit _e -> 0)
       u = xi * _eEu.K()/_eEu.E();
@@ -296,10 +378,14 @@ namespace GeographicLib {
   // Invert sigma using Newton's method
   void TransverseMercatorExact::sigmainv(real xi, real eta,
                                          real& u, real& v) const {
-    if (sigmainv0(xi, eta, u, v))
+    if (sigmainv0(xi, eta, u, v)) {
+      GEOGRAPHICLIB_INSTRUMENT_RECORD(TMEXACT_SIGMAINV, 0, false);
       return;
-    // min iterations = 2, max iterations = 7; mean = 3.9
-    for (int i = 0, trip = 0; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
+    }
+    // min iterations = 2, max iterations = 7; mean = 3.9 (2 iterations
+    // suffice when the Fourier series starting guess is used)
+    int i = 0, trip = 0;
+    for (; i < numit_ || GEOGRAPHICLIB_PANIC; ++i) {
       real snu, cnu, dnu, snv, cnv, dnv;
       _eEu.sncndn(u, snu, cnu, dnu);
       _eEv.sncndn(v, snv, cnv, dnv);
@@ -319,6 +405,7 @@ namespace GeographicLib {
       if (!(delw2 >= tol2_))
         ++trip;
     }
+    GEOGRAPHICLIB_INSTRUMENT_RECORD(TMEXACT_SIGMAINV, i + (i < numit_), !trip);
   }
 
   void TransverseMercatorExact::Scale(real tau, real /*lam*/,
@@ -461,4 +548,53 @@ namespace GeographicLib {
     k *= _k0;
   }
 
+  void TransverseMercatorExact::Forward(real lon0, size_t n,
+                                        const real lat[], const real lon[],
+                                        real x[], real y[],
+                                        real gamma[], real k[]) const {
+    Forward(lon0, n, StridedArray<const real>(lat),
+            StridedArray<const real>(lon),
+            StridedArray<real>(x), StridedArray<real>(y),
+            StridedArray<real>(gamma), StridedArray<real>(k));
+  }
+
+  void TransverseMercatorExact::Forward(real lon0, size_t n,
+                                        StridedArray<const real> lat,
+                                        StridedArray<const real> lon,
+                                        StridedArray<real> x,
+                                        StridedArray<real> y,
+                                        StridedArray<real> gamma,
+                                        StridedArray<real> k) const {
+    for (size_t i = 0; i < n; ++i) {
+      real gammax, kx;
+      Forward(lon0, lat[i], lon[i], x[i], y[i], gammax, kx);
+      if (gamma) gamma[i] = gammax;
+      if (k) k[i] = kx;
+    }
+  }
+
+  void TransverseMercatorExact::Reverse(real lon0, size_t n,
+                                        const real x[], const real y[],
+                                        real lat[], real lon[],
+                                        real gamma[], real k[]) const {
+    Reverse(lon0, n, StridedArray<const real>(x), StridedArray<const real>(y),
+            StridedArray<real>(lat), StridedArray<real>(lon),
+            StridedArray<real>(gamma), StridedArray<real>(k));
+  }
+
+  void TransverseMercatorExact::Reverse(real lon0, size_t n,
+                                        StridedArray<const real> x,
+                                        StridedArray<const real> y,
+                                        StridedArray<real> lat,
+                                        StridedArray<real> lon,
+                                        StridedArray<real> gamma,
+                                        StridedArray<real> k) const {
+    for (size_t i = 0; i < n; ++i) {
+      real gammax, kx;
+      Reverse(lon0, x[i], y[i], lat[i], lon[i], gammax, kx);
+      if (gamma) gamma[i] = gammax;
+      if (k) k[i] = kx;
+    }
+  }
+
 } // namespace GeographicLib
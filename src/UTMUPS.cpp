@@ -71,6 +71,13 @@ namespace GeographicLib {
                        int& zone, bool& northp, real& x, real& y,
                        real& gamma, real& k,
                        int setzone, bool mgrslimits) {
+    ForwardPoint(lat, lon, zone, northp, x, y, &gamma, &k, setzone, mgrslimits);
+  }
+
+  void UTMUPS::ForwardPoint(real lat, real lon,
+                            int& zone, bool& northp, real& x, real& y,
+                            real* gamma, real* k,
+                            int setzone, bool mgrslimits) {
     if (fabs(lat) > Math::qd)
       throw GeographicErr("Latitude " + Utility::str(lat)
                           + "d not in [-" + to_string(Math::qd)
@@ -80,11 +87,13 @@ namespace GeographicLib {
     if (zone1 == INVALID) {
       zone = zone1;
       northp = northp1;
-      x = y = gamma = k = Math::NaN();
+      x = y = Math::NaN();
+      if (gamma) *gamma = Math::NaN();
+      if (k) *k = Math::NaN();
       return;
     }
     real x1, y1, gamma1, k1;
-    bool utmp = zone1 != UPS;
+    bool scalp = gamma || k, utmp = zone1 != UPS;
     if (utmp) {
       real
         lon0 = CentralMeridian(zone1),
@@ -95,14 +104,21 @@ namespace GeographicLib {
         throw GeographicErr("Longitude " + Utility::str(lon)
                             + "d more than 60d from center of UTM zone "
                             + Utility::str(zone1));
-      TransverseMercator::UTM().Forward(lon0, lat, lon, x1, y1, gamma1, k1);
+      if (scalp)
+        TransverseMercator::UTM().Forward(lon0, lat, lon, x1, y1, gamma1, k1);
+      else
+        TransverseMercator::UTM().Forward(lon0, lat, lon, x1, y1);
     } else {
       if (fabs(lat) < 70)
         // Check isn't really necessary ... (see above).
         throw GeographicErr("Latitude " + Utility::str(lat)
                             + "d more than 20d from "
                             + (northp1 ? "N" : "S") + " pole");
-      PolarStereographic::UPS().Forward(northp1, lat, lon, x1, y1, gamma1, k1);
+      if (scalp)
+        PolarStereographic::UPS().Forward(northp1, lat, lon,
+                                          x1, y1, gamma1, k1);
+      else
+        PolarStereographic::UPS().Forward(northp1, lat, lon, x1, y1);
     }
     int ind = (utmp ? 2 : 0) + (northp1 ? 1 : 0);
     x1 += falseeasting_[ind];
@@ -117,16 +133,192 @@ namespace GeographicLib {
     northp = northp1;
     x = x1;
     y = y1;
-    gamma = gamma1;
-    k = k1;
+    if (gamma) *gamma = gamma1;
+    if (k) *k = k1;
+  }
+
+  void UTMUPS::Forward(size_t n, const real lat[], const real lon[],
+                       int zone[], bool northp[], real x[], real y[],
+                       real gamma[], real k[],
+                       int setzone, bool mgrslimits) {
+    Forward(n, StridedArray<const real>(lat), StridedArray<const real>(lon),
+            StridedArray<int>(zone), StridedArray<bool>(northp),
+            StridedArray<real>(x), StridedArray<real>(y),
+            StridedArray<real>(gamma), StridedArray<real>(k),
+            setzone, mgrslimits);
+  }
+
+  void UTMUPS::Forward(size_t n, StridedArray<const real> lat,
+                       StridedArray<const real> lon,
+                       StridedArray<int> zone, StridedArray<bool> northp,
+                       StridedArray<real> x, StridedArray<real> y,
+                       StridedArray<real> gamma, StridedArray<real> k,
+                       int setzone, bool mgrslimits) {
+    // On an error, the scalar version is invoked for the offending point to
+    // throw the exception.
+    int zone1; bool northp1; real x1, y1;
+    // Find the zones (and project the UPS points), counting the UTM points in
+    // each zone.
+    vector<size_t> start(MAXUTMZONE + 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      if (fabs(lat[i]) > Math::qd)
+        Forward(lat[i], lon[i], zone1, northp1, x1, y1, setzone, mgrslimits);
+      northp[i] = !(signbit(lat[i]));
+      zone[i] = StandardZone(lat[i], lon[i], setzone);
+      if (zone[i] == INVALID) {
+        x[i] = y[i] = Math::NaN();
+        if (gamma) gamma[i] = Math::NaN();
+        if (k) k[i] = Math::NaN();
+      } else if (zone[i] != UPS) {
+        if (!(Math::AngDiff(CentralMeridian(zone[i]), lon[i]) <= 60))
+          Forward(lat[i], lon[i], zone1, northp1, x1, y1, setzone, mgrslimits);
+        ++start[zone[i] + 1];
+      } else {
+        if (fabs(lat[i]) < 70)
+          Forward(lat[i], lon[i], zone1, northp1, x1, y1, setzone, mgrslimits);
+        real lati = lat[i], loni = lon[i], gammai, ki;
+        PolarStereographic::UPS().Forward(northp[i], 1, &lati, &loni,
+                                          &x[i], &y[i],
+                                          gamma ? &gammai : nullptr,
+                                          k ? &ki : nullptr);
+        if (gamma) gamma[i] = gammai;
+        if (k) k[i] = ki;
+      }
+    }
+    // Sort the indices of the UTM points by zone (a counting sort); the
+    // points for zone z are then ind[start[z]..start[z+1]-1].
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z)
+      start[z + 1] += start[z];
+    vector<size_t> ind(start[MAXUTMZONE + 1]), next(start);
+    for (size_t i = 0; i < n; ++i)
+      if (zone[i] >= MINUTMZONE)
+        ind[next[zone[i]]++] = i;
+    // Project the points for each zone in chunks with the central meridian
+    // fixed.
+    const TransverseMercator& utm = TransverseMercator::UTM();
+    const size_t chunk = min(size_t(1024), ind.size());
+    vector<real> buf(6 * chunk);
+    real *latx = buf.data(), *lonx = latx + chunk, *xx = lonx + chunk,
+      *yx = xx + chunk, *gammax = yx + chunk, *kx = gammax + chunk;
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z) {
+      real lon0 = CentralMeridian(z);
+      for (size_t b = start[z]; b < start[z + 1]; b += chunk) {
+        size_t m = min(chunk, start[z + 1] - b);
+        for (size_t j = 0; j < m; ++j) {
+          latx[j] = lat[ind[b + j]]; lonx[j] = lon[ind[b + j]];
+        }
+        utm.Forward(lon0, m, latx, lonx, xx, yx,
+                    gamma ? gammax : nullptr, k ? kx : nullptr);
+        for (size_t j = 0; j < m; ++j) {
+          size_t i = ind[b + j];
+          x[i] = xx[j]; y[i] = yx[j];
+          if (gamma) gamma[i] = gammax[j];
+          if (k) k[i] = kx[j];
+        }
+      }
+    }
+    // Add the false easting and northing and check the results
+    for (size_t i = 0; i < n; ++i) {
+      if (zone[i] == INVALID) continue;
+      bool utmp = zone[i] != UPS;
+      int l = (utmp ? 2 : 0) + (northp[i] ? 1 : 0);
+      x[i] += falseeasting_[l];
+      y[i] += falsenorthing_[l];
+      if (!CheckCoords(utmp, northp[i], x[i], y[i], mgrslimits, false))
+        Forward(lat[i], lon[i], zone1, northp1, x1, y1, setzone, mgrslimits);
+    }
+  }
+
+  void UTMUPS::Reverse(size_t n, const int zone[], const bool northp[],
+                       const real x[], const real y[],
+                       real lat[], real lon[], real gamma[], real k[],
+                       bool mgrslimits) {
+    using std::isnan;
+    // On an error, the scalar version is invoked for the offending point to
+    // throw the exception.
+    real lat1, lon1;
+    auto utmp = [zone, x, y](size_t i) -> bool {
+      return zone[i] >= MINUTMZONE && !(isnan(x[i]) || isnan(y[i]));
+    };
+    // Check the coordinates (and unproject the UPS points), counting the UTM
+    // points in each zone.
+    vector<size_t> start(MAXUTMZONE + 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      if (zone[i] == INVALID || isnan(x[i]) || isnan(y[i])) {
+        lat[i] = lon[i] = Math::NaN();
+        if (gamma) gamma[i] = Math::NaN();
+        if (k) k[i] = Math::NaN();
+        continue;
+      }
+      if (!(zone[i] >= MINZONE && zone[i] <= MAXZONE &&
+            CheckCoords(zone[i] != UPS, northp[i], x[i], y[i],
+                        mgrslimits, false)))
+        Reverse(zone[i], northp[i], x[i], y[i], lat1, lon1, mgrslimits);
+      if (zone[i] != UPS)
+        ++start[zone[i] + 1];
+      else {
+        int l = northp[i] ? 1 : 0;
+        real xi = x[i] - falseeasting_[l], yi = y[i] - falsenorthing_[l],
+          gammai, ki;
+        PolarStereographic::UPS().Reverse(northp[i], 1, &xi, &yi,
+                                          &lat[i], &lon[i],
+                                          gamma ? &gammai : nullptr,
+                                          k ? &ki : nullptr);
+        if (gamma) gamma[i] = gammai;
+        if (k) k[i] = ki;
+      }
+    }
+    // Sort the indices of the UTM points by zone (a counting sort); the
+    // points for zone z are then ind[start[z]..start[z+1]-1].
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z)
+      start[z + 1] += start[z];
+    vector<size_t> ind(start[MAXUTMZONE + 1]), next(start);
+    for (size_t i = 0; i < n; ++i)
+      if (utmp(i))
+        ind[next[zone[i]]++] = i;
+    // Unproject the points for each zone in chunks with the central meridian
+    // fixed.
+    const TransverseMercator& utm = TransverseMercator::UTM();
+    const size_t chunk = min(size_t(1024), ind.size());
+    vector<real> buf(6 * chunk);
+    real *xx = buf.data(), *yx = xx + chunk, *latx = yx + chunk,
+      *lonx = latx + chunk, *gammax = lonx + chunk, *kx = gammax + chunk;
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z) {
+      real lon0 = CentralMeridian(z);
+      for (size_t b = start[z]; b < start[z + 1]; b += chunk) {
+        size_t m = min(chunk, start[z + 1] - b);
+        for (size_t j = 0; j < m; ++j) {
+          size_t i = ind[b + j];
+          int l = 2 + (northp[i] ? 1 : 0);
+          xx[j] = x[i] - falseeasting_[l];
+          yx[j] = y[i] - falsenorthing_[l];
+        }
+        utm.Reverse(lon0, m, xx, yx, latx, lonx,
+                    gamma ? gammax : nullptr, k ? kx : nullptr);
+        for (size_t j = 0; j < m; ++j) {
+          size_t i = ind[b + j];
+          lat[i] = latx[j]; lon[i] = lonx[j];
+          if (gamma) gamma[i] = gammax[j];
+          if (k) k[i] = kx[j];
+        }
+      }
+    }
   }
 
   void UTMUPS::Reverse(int zone, bool northp, real x, real y,
                        real& lat, real& lon, real& gamma, real& k,
                        bool mgrslimits) {
+    ReversePoint(zone, northp, x, y, lat, lon, &gamma, &k, mgrslimits);
+  }
+
+  void UTMUPS::ReversePoint(int zone, bool northp, real x, real y,
+                            real& lat, real& lon, real* gamma, real* k,
+                            bool mgrslimits) {
     using std::isnan;           // Needed for Centos 7, ubuntu 14
     if (zone == INVALID || isnan(x) || isnan(y)) {
-      lat = lon = gamma = k = Math::NaN();
+      lat = lon = Math::NaN();
+      if (gamma) *gamma = Math::NaN();
+      if (k) *k = Math::NaN();
       return;
     }
     if (!(zone >= MINZONE && zone <= MAXZONE))
@@ -137,11 +329,23 @@ namespace GeographicLib {
     int ind = (utmp ? 2 : 0) + (northp ? 1 : 0);
     x -= falseeasting_[ind];
     y -= falsenorthing_[ind];
-    if (utmp)
-      TransverseMercator::UTM().Reverse(CentralMeridian(zone),
-                                        x, y, lat, lon, gamma, k);
-    else
-      PolarStereographic::UPS().Reverse(northp, x, y, lat, lon, gamma, k);
+    real gamma1, k1;
+    bool scalp = gamma || k;
+    if (utmp) {
+      if (scalp)
+        TransverseMercator::UTM().Reverse(CentralMeridian(zone),
+                                          x, y, lat, lon, gamma1, k1);
+      else
+        TransverseMercator::UTM().Reverse(CentralMeridian(zone),
+                                          x, y, lat, lon);
+    } else {
+      if (scalp)
+        PolarStereographic::UPS().Reverse(northp, x, y, lat, lon, gamma1, k1);
+      else
+        PolarStereographic::UPS().Reverse(northp, x, y, lat, lon);
+    }
+    if (gamma) *gamma = gamma1;
+    if (k) *k = k1;
   }
 
   bool UTMUPS::CheckCoords(bool utmp, bool northp, real x, real y,
@@ -209,6 +413,87 @@ namespace GeographicLib {
     return;
   }
 
+  void UTMUPS::Transfer(size_t n, const int zonein[], const bool northpin[],
+                        const real xin[], const real yin[],
+                        int zoneout, bool northpout,
+                        real xout[], real yout[], int zone[]) {
+    using std::isnan;
+    // Only UTM to UTM transfers of valid points are batched.  On an error,
+    // the scalar version is invoked for the offending point to throw the
+    // exception.
+    bool utmout = zoneout == MATCH ||
+      (zoneout >= MINUTMZONE && zoneout <= MAXUTMZONE);
+    auto batchp = [=](size_t i) -> bool {
+      return utmout && zonein[i] != zoneout &&
+        zonein[i] >= MINUTMZONE && zonein[i] <= MAXUTMZONE &&
+        !(isnan(xin[i]) || isnan(yin[i]));
+    };
+    // Transfer the other points, counting the batched points in each input
+    // zone.
+    vector<size_t> start(MAXUTMZONE + 2, 0);
+    for (size_t i = 0; i < n; ++i) {
+      if (batchp(i))
+        ++start[zonein[i] + 1];
+      else
+        Transfer(zonein[i], northpin[i], xin[i], yin[i], zoneout, northpout,
+                 xout[i], yout[i], zone[i]);
+    }
+    // Sort the indices of the batched points by input zone (a counting
+    // sort), as in the batch Forward.
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z)
+      start[z + 1] += start[z];
+    vector<size_t> ind(start[MAXUTMZONE + 1]), next(start);
+    for (size_t i = 0; i < n; ++i)
+      if (batchp(i))
+        ind[next[zonein[i]]++] = i;
+    // Convert the points for each input zone in chunks with both central
+    // meridians fixed.
+    const TransverseMercator& utm = TransverseMercator::UTM();
+    const size_t chunk = min(size_t(1024), ind.size());
+    vector<real> buf(4 * chunk);
+    real *xx = buf.data(), *yx = xx + chunk,
+      *latx = yx + chunk, *lonx = latx + chunk;
+    for (int z = MINUTMZONE; z <= MAXUTMZONE; ++z) {
+      int zone1 = zoneout == MATCH ? z : zoneout;
+      real lon0in = CentralMeridian(z), lon0out = CentralMeridian(zone1);
+      for (size_t b = start[z]; b < start[z + 1]; b += chunk) {
+        size_t m = min(chunk, start[z + 1] - b);
+        for (size_t j = 0; j < m; ++j) {
+          size_t i = ind[b + j];
+          if (!CheckCoords(true, northpin[i], xin[i], yin[i], false, false))
+            Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                     zoneout, northpout, xout[i], yout[i], zone[i]);
+          int l = 2 + (northpin[i] ? 1 : 0);
+          xx[j] = xin[i] - falseeasting_[l];
+          yx[j] = yin[i] - falsenorthing_[l];
+        }
+        utm.Reverse(lon0in, m, xx, yx, latx, lonx);
+        for (size_t j = 0; j < m; ++j) {
+          if (!(Math::AngDiff(lon0out, lonx[j]) <= 60)) {
+            size_t i = ind[b + j];
+            Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                     zoneout, northpout, xout[i], yout[i], zone[i]);
+          }
+        }
+        utm.Forward(lon0out, m, latx, lonx, xx, yx);
+        for (size_t j = 0; j < m; ++j) {
+          size_t i = ind[b + j];
+          bool northp = !(signbit(latx[j]));
+          int l = 2 + (northp ? 1 : 0);
+          real x1 = xx[j] + falseeasting_[l], y1 = yx[j] + falsenorthing_[l];
+          if (!CheckCoords(true, northp, x1, y1, false, false))
+            Transfer(zonein[i], northpin[i], xin[i], yin[i],
+                     zoneout, northpout, xout[i], yout[i], zone[i]);
+          if (northp != northpout)
+            y1 += (northpout ? -1 : 1) * MGRS::utmNshift_;
+          zone[i] = zone1;
+          xout[i] = x1;
+          yout[i] = y1;
+        }
+      }
+    }
+  }
+
   void UTMUPS::DecodeZone(const string& zonestr, int& zone, bool& northp)
   {
     unsigned zlen = unsigned(zonestr.size());
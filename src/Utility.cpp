@@ -8,6 +8,9 @@
  **********************************************************************/
 
 #include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <clocale>
 #include <GeographicLib/Utility.hpp>
 
 #if defined(_MSC_VER)
@@ -19,6 +22,80 @@ namespace GeographicLib {
 
   using namespace std;
 
+  namespace {
+    // The fast conversions use the C library which depends on LC_NUMERIC;
+    // only use them if the decimal point is a period.
+    bool cdecimalpoint() {
+      const char* p = localeconv()->decimal_point;
+      return p[0] == '.' && p[1] == '\0';
+    }
+
+    template<typename T> T strtoT(const char* p, char** q);
+    template<> float strtoT<float>(const char* p, char** q)
+    { return strtof(p, q); }
+    template<> double strtoT<double>(const char* p, char** q)
+    { return strtod(p, q); }
+    template<> long double strtoT<long double>(const char* p, char** q)
+    { return strtold(p, q); }
+
+    template<typename T> bool fastvalT(const std::string& s, T& x) {
+      // Only handle strings consisting of a plain decimal number (optionally
+      // surrounded by white space); for these the C library and the stream
+      // classes give the same results.  Everything else (errors, inf, nan,
+      // overflow, etc.) is left to the general code.
+      size_t beg = 0, end = s.size();
+      while (beg < end && isspace(s[beg]))
+        ++beg;
+      while (beg < end && isspace(s[end - 1]))
+        --end;
+      if (beg == end) return false;
+      for (size_t i = beg; i < end; ++i) {
+        char c = s[i];
+        if (!((c >= '0' && c <= '9') || c == '.' || c == '+' || c == '-' ||
+              c == 'e' || c == 'E'))
+          return false;
+      }
+      if (!cdecimalpoint()) return false;
+      const char* p = s.c_str() + beg;
+      char* q;
+      int olderrno = errno;
+      errno = 0;
+      T y = strtoT<T>(p, &q);
+      bool ok = q == s.c_str() + end && errno != ERANGE;
+      errno = olderrno;
+      if (ok) x = y;
+      return ok;
+    }
+
+    template<typename T>
+    bool faststrT(T x, int p, std::string& s, const char* fmtfixed,
+                  const char* fmtdefault) {
+      // With p >= 0, ostream uses %.*f, otherwise %.*g with a precision of 6.
+      if (!cdecimalpoint()) return false;
+      char buf[64];
+      int n = p >= 0 ? snprintf(buf, sizeof(buf), fmtfixed, p, x) :
+        snprintf(buf, sizeof(buf), fmtdefault, 6, x);
+      if (!(n > 0 && n < int(sizeof(buf)))) return false;
+      s.assign(buf, n);
+      return true;
+    }
+  }
+
+  bool Utility::fastval(const std::string& s, float& x)
+  { return fastvalT(s, x); }
+
+  bool Utility::fastval(const std::string& s, double& x)
+  { return fastvalT(s, x); }
+
+  bool Utility::fastval(const std::string& s, long double& x)
+  { return fastvalT(s, x); }
+
+  bool Utility::faststr(double x, int p, std::string& s)
+  { return faststrT(x, p, s, "%.*f", "%.*g"); }
+
+  bool Utility::faststr(long double x, int p, std::string& s)
+  { return faststrT(x, p, s, "%.*Lf", "%.*Lg"); }
+
   int Utility::day(int y, int m, int d) {
     // Convert from date to sequential day and vice versa
     //
@@ -7,9 +7,20 @@
  * https://geographiclib.sourceforge.io/
  **********************************************************************/
 
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <GeographicLib/CachedGeodesic.hpp>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
+#include <GeographicLib/GeodesicLineExact.hpp>
+#include <GeographicLib/GeodesicLine.hpp>
+#include <GeographicLib/GeodesicMatrix.hpp>
+#include <GeographicLib/GeodesicOrigin.hpp>
+#include <GeographicLib/GeodesicStart.hpp>
+#include <GeographicLib/Rhumb.hpp>
+#include <GeographicLib/TransverseMercatorExact.hpp>
 
 using namespace std;
 using namespace GeographicLib;
@@ -23,6 +34,10 @@ static int checkEquals(T x, T y, T d) {
   return 1;
 }
 
+static int checkSame(T x, T y) {
+  return isnan(x) && isnan(y) ? 0 : checkEquals(x, y, 0);
+}
+
 static const int ncases = 20;
 static const T testcases[ncases][12] = {
   {35.60777, -139.44815, 111.098748429560326,
@@ -134,6 +149,568 @@ static int testinverse(T f = 1) {
   return result;
 }
 
+template <class G>
+static int testinversebatch(int nthreads) {
+  // Repeat the test cases so that the batch is split among several tasks
+  const int num = 4 * 64 + 1;
+  T lat1[num], lon1[num], lat2[num], lon2[num],
+    s12[num], azi1[num], azi2[num], m12[num],
+    M12[num], M21[num], S12[num], a12[num];
+  T azi1a, azi2a, s12a, a12a, m12a, M12a, M21a, S12a;
+  const G& g = G::WGS84();
+  int result = 0;
+  for (int i = 0; i < num; ++i) {
+    lat1[i] = testcases[i % ncases][0]; lon1[i] = testcases[i % ncases][1];
+    lat2[i] = testcases[i % ncases][3]; lon2[i] = testcases[i % ncases][4];
+  }
+  g.InverseBatch(num, lat1, lon1, lat2, lon2, G::ALL,
+                 s12, azi1, azi2, m12, M12, M21, S12, a12, nthreads);
+  for (int i = 0; i < num; ++i) {
+    int k = 0;
+    a12a = g.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], G::ALL,
+                        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    // The batch results should be identical to the scalar ones
+    k += checkEquals(azi1[i], azi1a, 0);
+    k += checkEquals(azi2[i], azi2a, 0);
+    k += checkEquals(s12[i], s12a, 0);
+    k += checkEquals(a12[i], a12a, 0);
+    k += checkEquals(m12[i], m12a, 0);
+    k += checkEquals(M12[i], M12a, 0);
+    k += checkEquals(M21[i], M21a, 0);
+    k += checkEquals(S12[i], S12a, 0);
+    if (k) cout << "testinversebatch failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testinversebatchexact(T f, int nthreads) {
+  // A prolate ellipsoid for which the area is computed with a variable
+  // number of terms
+  const int num = 300;
+  T lat1[num], lon1[num], lat2[num], lon2[num],
+    s12[num], azi1[num], azi2[num], S12[num];
+  T azi1a, azi2a, s12a, m12a, M12a, M21a, S12a, lat2a, lon2a, S12b;
+  const GeodesicExact g(Constants::WGS84_a(), f);
+  int result = 0;
+  for (int i = 0; i < num; ++i) {
+    lat1[i] = T(i % 17) * 10 - 80; lon1[i] = 0;
+    lat2[i] = T(i % 13) * 14 - 84; lon2[i] = T(i) * 179 / (num - 1);
+  }
+  const unsigned mask = GeodesicExact::DISTANCE | GeodesicExact::AZIMUTH |
+    GeodesicExact::AREA;
+  g.InverseBatch(num, lat1, lon1, lat2, lon2, mask,
+                 s12, azi1, azi2, nullptr, nullptr, nullptr, S12,
+                 nullptr, nthreads);
+  for (int i = 0; i < num; ++i) {
+    int k = 0;
+    g.GenInverse(lat1[i], lon1[i], lat2[i], lon2[i], mask,
+                 s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    k += checkEquals(azi1[i], azi1a, 0);
+    k += checkEquals(azi2[i], azi2a, 0);
+    k += checkEquals(s12[i], s12a, 0);
+    k += checkEquals(S12[i], S12a, 0);
+    // The area computed via GeodesicLineExact should agree
+    g.Line(lat1[i], lon1[i], azi1a).
+      GenPosition(false, s12a, GeodesicExact::AREA | GeodesicExact::LATITUDE |
+                  GeodesicExact::LONGITUDE, lat2a, lon2a,
+                  azi2a, s12a, m12a, M12a, M21a, S12b);
+    k += checkEquals(S12b, S12a,
+                     1e-10 * Math::_sq(g.EquatorialRadius()) * (1 - f));
+    if (k) cout << "testinversebatchexact failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testmatrix(bool exact) {
+  T lat1[ncases], lon1[ncases], lat2[ncases], lon2[ncases],
+    s12[ncases * ncases], azi1[ncases * ncases], azi2[ncases * ncases];
+  T azi1a, azi2a, s12a;
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    lat2[i] = testcases[i][3]; lon2[i] = testcases[i][4];
+  }
+  GeodesicMatrix mat(g, ncases, lat1, lon1, ncases, lat2, lon2);
+  mat.GenMatrix(Geodesic::DISTANCE | Geodesic::AZIMUTH, s12, azi1, azi2);
+  for (int i = 0; i < ncases; ++i) {
+    for (int j = 0; j < ncases; ++j) {
+      int k = 0, l = i * ncases + j;
+      g.Inverse(lat1[i], lon1[i], lat2[j], lon2[j], s12a, azi1a, azi2a);
+      // The matrix results should be identical to the scalar ones
+      k += checkEquals(s12[l], s12a, 0);
+      k += checkEquals(azi1[l], azi1a, 0);
+      k += checkEquals(azi2[l], azi2a, 0);
+      if (k) cout << "testmatrix failure: case " << i << " " << j << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+template<typename R>
+static vector<R> readmatrix(const string& filename, size_t& done) {
+  ifstream f(filename, ios::binary);
+  uint64_t hdr[8];
+  f.read(reinterpret_cast<char*>(hdr), sizeof(hdr));
+  done = size_t(hdr[4]);
+  vector<R> v;
+  R x;
+  while (f.read(reinterpret_cast<char*>(&x), sizeof(x)))
+    v.push_back(x);
+  return v;
+}
+
+static int testmatrixfile() {
+  T lat[ncases], lon[ncases], s12[ncases * ncases];
+  const Geodesic& g = Geodesic::WGS84();
+  for (int i = 0; i < ncases; ++i) {
+    lat[i] = testcases[i][0]; lon[i] = testcases[i][1];
+  }
+  GeodesicMatrix mat(g, ncases, lat, lon, ncases, lat, lon);
+  mat.Distances(s12);
+  const string filename = "geodtest-matrix.bin";
+  int result = 0;
+  size_t done;
+  // Full matrix in tiles of 3 rows
+  mat.WriteDistances(filename, GeodesicMatrix::FLOAT64, false, 2, 3);
+  vector<double> d = readmatrix<double>(filename, done);
+  result += !(done == size_t(ncases) && d.size() == size_t(ncases * ncases));
+  for (size_t k = 0; k < d.size() && !result; ++k)
+    result += checkEquals(T(d[k]), T(double(s12[k])), 0);
+  // Interrupt the calculation after 3 rows and resume
+  {
+    fstream f(filename, ios::in | ios::out | ios::binary);
+    uint64_t three = 3;
+    f.seekp(4 * sizeof(uint64_t));
+    f.write(reinterpret_cast<const char*>(&three), sizeof(three));
+    f.seekp(streamoff(64 + 3 * ncases * sizeof(double)));
+    vector<char> zero((ncases - 3) * ncases * sizeof(double), 0);
+    f.write(zero.data(), zero.size());
+  }
+  mat.WriteDistances(filename, GeodesicMatrix::FLOAT64, true, 1, 2);
+  d = readmatrix<double>(filename, done);
+  result += !(done == size_t(ncases) && d.size() == size_t(ncases * ncases));
+  for (size_t k = 0; k < d.size() && !result; ++k)
+    result += checkEquals(T(d[k]), T(double(s12[k])), 0);
+  // Resuming with a different format is an error
+  try {
+    mat.WriteDistances(filename, GeodesicMatrix::FLOAT32, true);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  // The upper triangle as floats
+  mat.WriteDistances(filename,
+                     GeodesicMatrix::FLOAT32 | GeodesicMatrix::SYMMETRIC);
+  vector<float> e = readmatrix<float>(filename, done);
+  result += !(done == size_t(ncases) &&
+              e.size() == size_t(ncases * (ncases + 1) / 2));
+  for (int i = 0; i < ncases && !result; ++i)
+    for (int j = 0; j < ncases; ++j) {
+      size_t k = GeodesicMatrix::FileIndex(ncases, i, j, true);
+      int l = (i <= j ? i * ncases + j : j * ncases + i);
+      result += checkEquals(T(e[k]), T(float(s12[l])), 0);
+    }
+  remove(filename.c_str());
+  if (result) cout << "testmatrixfile failure\n";
+  return result;
+}
+
+static int testrhumbmatrix(bool exact) {
+  // Include the poles to check the treatment of infinite isometric latitude
+  const int n = ncases + 2;
+  T lat1[n], lon1[n], lat2[n], lon2[n],
+    s12[n * n], azi12[n * n], S12[n * n];
+  T s12a, azi12a, S12a;
+  Rhumb rh(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    lat2[i] = testcases[i][3]; lon2[i] = testcases[i][4];
+  }
+  lat1[ncases] = lat2[ncases + 1] = 90;
+  lat1[ncases + 1] = lat2[ncases] = -90;
+  lon1[ncases] = lon1[ncases + 1] = lon2[ncases] = lon2[ncases + 1] = 10;
+  rh.InverseMatrix(n, lat1, lon1, n, lat2, lon2, Rhumb::ALL,
+                   s12, azi12, S12);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      int k = 0, l = i * n + j;
+      rh.Inverse(lat1[i], lon1[i], lat2[j], lon2[j], s12a, azi12a, S12a);
+      // The matrix results should be identical to the scalar ones (including
+      // the NaNs for some of the pole-to-pole lines).
+      k += checkSame(s12[l], s12a);
+      k += checkSame(azi12[l], azi12a);
+      k += checkSame(S12[l], S12a);
+      if (k) cout << "testrhumbmatrix failure: case " << i << " " << j << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+static int testorigin(bool exact) {
+  T lat1, lon1, lat2, lon2;
+  T azi1, azi2, s12, a12, m12, M12, M21, S12;
+  T azi1a, azi2a, s12a, a12a, m12a, M12a, M21a, S12a;
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    lat1 = testcases[i][0]; lon1 = testcases[i][1];
+    GeodesicOrigin o = g.Origin(lat1, lon1);
+    for (int j = 0; j < ncases; ++j) {
+      int k = 0;
+      lat2 = testcases[j][3]; lon2 = testcases[j][4];
+      a12 = o.GenInverse(lat2, lon2, Geodesic::ALL,
+                         s12, azi1, azi2, m12, M12, M21, S12);
+      a12a = g.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                          s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+      // The results should be identical to the Geodesic ones
+      k += checkEquals(azi1, azi1a, 0);
+      k += checkEquals(azi2, azi2a, 0);
+      k += checkEquals(s12, s12a, 0);
+      k += checkEquals(a12, a12a, 0);
+      k += checkEquals(m12, m12a, 0);
+      k += checkEquals(M12, M12a, 0);
+      k += checkEquals(M21, M21a, 0);
+      k += checkEquals(S12, S12a, 0);
+      if (k) cout << "testorigin failure: case " << i << " " << j << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+static int testwarminverse() {
+  T lat1, lon1, lat2, lon2, azi1, azi2, s12, a12, m12, M12, M21, S12;
+  T azi1a, azi2a, s12a, a12a, m12a, M12a, M21a, S12a;
+  const Geodesic& g = Geodesic::WGS84();
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    int k = 0;
+    lat1 = testcases[i][0]; lon1 = testcases[i][1];
+    lat2 = testcases[i][3]; lon2 = testcases[i][4];
+    // Start with the solution of a problem with point 2 moved by ~100 m
+    g.Inverse(lat1, lon1, lat2 + T(0.001), lon2 - T(0.001), azi1a, azi2a);
+    a12a = g.WarmInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                         s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    a12 = g.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                       s12, azi1, azi2, m12, M12, M21, S12);
+    k += checkEquals(azi1, azi1a, 1e-13);
+    k += checkEquals(azi2, azi2a, 1e-13);
+    k += checkEquals(s12, s12a, 1e-8);
+    k += checkEquals(a12, a12a, 1e-13);
+    k += checkEquals(m12, m12a, 1e-8);
+    k += checkEquals(M12, M12a, 1e-15);
+    k += checkEquals(M21, M21a, 1e-15);
+    k += checkEquals(S12, S12a, 0.1);
+    if (k) cout << "testwarminverse failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testregistry() {
+  // Geodesic::Get returns the same instance for the same parameters
+  int result = 0;
+  T a = 6378388, f = 1/T(297);
+  const Geodesic& g = Geodesic::Get(a, f);
+  result += &g != &Geodesic::Get(a, f);
+  result += &g == &Geodesic::Get(a, f, true);
+  result += &g == &Geodesic::Get(a, -f);
+  result += !(g.EquatorialRadius() == a && g.Flattening() == f && !g.Exact());
+  Geodesic h(a, f);
+  T s12a, s12b;
+  g.Inverse(10, 20, -30, 140, s12a); h.Inverse(10, 20, -30, 140, s12b);
+  result += checkSame(s12a, s12b);
+  const Rhumb& r = Rhumb::Get(a, f, true);
+  result += &r != &Rhumb::Get(a, f, true);
+  result += &r == &Rhumb::Get(a, f);
+  result += !(r.EquatorialRadius() == a && r.Flattening() == f);
+  try {
+    Geodesic::Get(-1, 0);
+    ++result;
+  }
+  catch (const GeographicErr&) {}
+  if (result) cout << "testregistry failure\n";
+  return result;
+}
+
+static int testcachedgeodesic() {
+  // CachedGeodesic returns the same results as Geodesic and only caches a
+  // problem the second time it's seen.
+  int result = 0;
+  const Geodesic& g = Geodesic::WGS84();
+  // A large budget so that the admission filter is exact for these cases
+  CachedGeodesic c(g, 1 << 24, 4);
+  for (int k = 0; k < 3; ++k)
+    for (int i = 0; i < ncases; ++i) {
+      T lat1 = testcases[i][0], lon1 = testcases[i][1],
+        lat2 = testcases[i][3], lon2 = testcases[i][4],
+        s12, azi1, azi2, m12, M12, M21, S12,
+        s12a, azi1a, azi2a, m12a, M12a, M21a, S12a, a12, a12a;
+      a12 = g.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                         s12, azi1, azi2, m12, M12, M21, S12);
+      a12a = c.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                          s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+      result += checkSame(a12, a12a) + checkSame(s12, s12a) +
+        checkSame(azi1, azi1a) + checkSame(azi2, azi2a) +
+        checkSame(m12, m12a) + checkSame(M12, M12a) +
+        checkSame(M21, M21a) + checkSame(S12, S12a);
+      // A different outmask is a different problem
+      c.Inverse(lat1, lon1, lat2, lon2, s12a);
+      result += checkSame(s12, s12a);
+    }
+  result += !(c.Bypasses() == 2 * ncases && c.Misses() == 2 * ncases &&
+              c.Hits() == 2 * ncases && c.Size() == 2 * ncases);
+  c.Clear();
+  result += !(c.Size() == 0 && c.Hits() == 0);
+  if (result) cout << "testcachedgeodesic failure\n";
+  return result;
+}
+
+static int testgeodesicstart(T f) {
+  // GeodesicStart agrees with Geodesic::GenInverse
+  int result = 0;
+  Geodesic g(Constants::WGS84_a(), f * Constants::WGS84_f());
+  GeodesicStart start(g, 8);
+  for (int i = 0; i < ncases; ++i) {
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      lat2 = testcases[i][3], lon2 = testcases[i][4],
+      s12, azi1, azi2, m12, M12, M21, S12,
+      s12a, azi1a, azi2a, m12a, M12a, M21a, S12a, a12, a12a;
+    a12 = g.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                       s12, azi1, azi2, m12, M12, M21, S12);
+    a12a = start.GenInverse(lat1, lon1, lat2, lon2, Geodesic::ALL,
+                            s12a, azi1a, azi2a, m12a, M12a, M21a, S12a);
+    int k = 0;
+    k += checkEquals(a12, a12a, 1e-13);
+    k += checkEquals(s12, s12a, 1e-8);
+    k += checkEquals(azi1, azi1a, 1e-13);
+    k += checkEquals(azi2, azi2a, 1e-13);
+    k += checkEquals(m12, m12a, 1e-8);
+    k += checkEquals(M12, M12a, 1e-15);
+    k += checkEquals(M21, M21a, 1e-15);
+    k += checkEquals(S12, S12a, 0.1);
+    if (k) cout << "testgeodesicstart failure: f " << f << " case " << i
+                << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testdistancebounds(T f) {
+  T lat1, lon1, lat2, lon2, s12, s12min, s12max;
+  Geodesic g(Constants::WGS84_a(), f, true);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    lat1 = testcases[i][0]; lon1 = testcases[i][1];
+    for (int j = 0; j < ncases; ++j) {
+      int k = 0;
+      lat2 = testcases[j][3]; lon2 = testcases[j][4];
+      g.Inverse(lat1, lon1, lat2, lon2, s12);
+      g.DistanceBounds(lat1, lon1, lat2, lon2, s12min, s12max);
+      // The bounds must hold and the interval is about |f| * s12 wide
+      k += !(s12min <= s12 && s12 <= s12max);
+      k += !(s12max - s12min <= (fabs(f) * 1.01) * s12 + T(1e-5));
+      g.DistanceBounds(lat1, lon1, lat1, lon1, s12min, s12max);
+      k += !(s12min == 0 && s12max <= T(1e-5));
+      if (k) cout << "testdistancebounds failure: case " << i << " " << j
+                  << "\n";
+      result += k;
+    }
+  }
+  return result;
+}
+
+static int testdistanceapprox() {
+  const Geodesic& g = Geodesic::WGS84();
+  T lat1[ncases], lon1[ncases], lat2[ncases], lon2[ncases], s12a[ncases];
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    lat2[i] = testcases[i][3]; lon2[i] = testcases[i][4];
+  }
+  g.DistanceApproxBatch(ncases, lat1, lon1, lat2, lon2, s12a);
+  for (int i = 0; i < ncases; ++i) {
+    for (int j = 0; j < ncases; ++j) {
+      int k = 0;
+      T s12, s12x = g.DistanceApprox(lat1[i], lon1[i], lat2[j], lon2[j]);
+      g.Inverse(lat1[i], lon1[i], lat2[j], lon2[j], s12);
+      // The documented error bounds
+      if (s12 <= 1e6)
+        k += checkEquals(s12x, s12, T(1.5));
+      else if (s12 <= 1e7)
+        k += checkEquals(s12x, s12, T(14));
+      if (i == j)
+        k += checkEquals(s12a[i], s12x, 0);
+      if (k) cout << "testdistanceapprox failure: case " << i << " " << j
+                  << "\n";
+      result += k;
+    }
+    // Coincident points
+    result += checkEquals(g.DistanceApprox(lat1[i], lon1[i],
+                                           lat1[i], lon1[i]), T(0), T(0));
+  }
+  return result;
+}
+
+static int testpositions(bool exact) {
+  const int npts = 50;
+  T s12[npts], lat2[npts], lon2[npts], azi2[npts], m12[npts], a12[npts],
+    lat2u[npts], lon2u[npts], azi2u[npts], m12u[npts], a12u[npts];
+  T lat2a, lon2a, azi2a, m12a, t;
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  unsigned mask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+    Geodesic::AZIMUTH | Geodesic::REDUCEDLENGTH | Geodesic::LONG_UNROLL;
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      lat3 = testcases[i][3], lon3 = testcases[i][4],
+      s13 = testcases[i][6], ds = s13 / (npts - 1);
+    GeodesicLine l = g.InverseLine(lat1, lon1, lat3, lon3);
+    for (int j = 0; j < npts; ++j) s12[j] = j * ds;
+    l.GenPositions(false, npts, s12, mask, lat2, lon2, azi2,
+                   nullptr, m12, nullptr, nullptr, nullptr, a12);
+    l.GenPositionsUniform(false, 0, ds, npts, mask, lat2u, lon2u, azi2u,
+                          nullptr, m12u, nullptr, nullptr, nullptr, a12u);
+    int k = 0;
+    for (int j = 0; j < npts; ++j) {
+      T a12a = l.GenPosition(false, s12[j], mask, lat2a, lon2a, azi2a,
+                             t, m12a, t, t, t);
+      // GenPositions should be identical to GenPosition
+      k += checkEquals(lat2[j], lat2a, 0);
+      k += checkEquals(lon2[j], lon2a, 0);
+      k += checkEquals(azi2[j], azi2a, 0);
+      k += checkEquals(m12[j], m12a, 0);
+      k += checkEquals(a12[j], a12a, 0);
+      // GenPositionsUniform should agree to within roundoff
+      k += checkEquals(lat2u[j], lat2a, 1e-13);
+      k += checkEquals(lon2u[j], lon2a, 1e-13);
+      k += checkEquals(azi2u[j], azi2a, 1e-13);
+      k += checkEquals(m12u[j], m12a, 1e-8);
+      k += checkEquals(a12u[j], a12a, 1e-13);
+    }
+    // Stepper should be identical to GenPositionsUniform
+    GeodesicLine::Stepper stepper(l, ds);
+    for (int j = 0; j < npts; ++j) {
+      T a12s = stepper.GenNext(mask, lat2a, lon2a, azi2a, t, m12a, t, t, t);
+      k += checkEquals(lat2a, lat2u[j], 0);
+      k += checkEquals(lon2a, lon2u[j], 0);
+      k += checkEquals(azi2a, azi2u[j], 0);
+      k += checkEquals(m12a, m12u[j], 0);
+      k += checkEquals(a12s, a12u[j], 0);
+    }
+    k += checkEquals(T(stepper.Count()), npts, 0);
+    std::vector<T> lat, lon;
+    size_t n = l.Densify(s13 / T(9.5), lat, lon);
+    k += checkEquals(T(n), 11, 0);
+    if (n == 11) {
+      k += checkEquals(lat[0], lat1, 1e-12);
+      k += checkEquals(lon[0], lon1, 1e-12);
+      k += checkEquals(lat[n-1], lat3, 1e-12);
+      k += checkEquals(Math::AngDiff(lon[n-1], lon3), 0, 1e-12);
+    }
+    if (k) cout << "testpositions failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testcrossings(bool exact) {
+  // Compare the crossings with the sign changes found by sampling the line
+  const int npts = 2000;
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  unsigned mask = Geodesic::LATITUDE | Geodesic::LONGITUDE |
+    Geodesic::LONG_UNROLL;
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      azi1 = testcases[i][2], a13 = 3 * testcases[i][7];
+    // Extend the test lines so that they cross the parallels and meridians
+    // several times
+    GeodesicLine l = g.ArcDirectLine(lat1, lon1, azi1, a13);
+    T lat3, lon3, t;
+    l.GenPosition(true, a13, mask, lat3, lon3, t, t, t, t, t, t);
+    T lat = (lat1 + lat3) / 2 + 1, lon = (lon1 + lon3) / 2 + 1;
+    std::vector<T> a12;
+    int k = 0, nlat = 0, nlon = 0;
+    T latp = lat1, lonp = lon1;
+    for (int j = 1; j <= npts; ++j) {
+      T lat2, lon2;
+      l.GenPosition(true, j * a13 / npts, mask, lat2, lon2, t, t, t, t, t, t);
+      nlat += (latp - lat) * (lat2 - lat) < 0;
+      nlon += floor((lonp - lon) / 360) != floor((lon2 - lon) / 360);
+      latp = lat2; lonp = lon2;
+    }
+    size_t n = l.LatitudeCrossing(lat, a12);
+    k += checkEquals(T(n), nlat, 0);
+    for (size_t j = 0; j < n; ++j) {
+      T lat2, lon2;
+      l.GenPosition(true, a12[j], mask, lat2, lon2, t, t, t, t, t, t);
+      k += checkEquals(lat2, lat, 1e-12);
+      k += j > 0 && !(a13 > 0 ? a12[j] > a12[j-1] : a12[j] < a12[j-1]);
+    }
+    n = l.LongitudeCrossing(lon, a12);
+    k += checkEquals(T(n), nlon, 0);
+    for (size_t j = 0; j < n; ++j) {
+      T lat2, lon2;
+      l.GenPosition(true, a12[j], mask, lat2, lon2, t, t, t, t, t, t);
+      k += checkEquals(Math::AngDiff(lon, lon2), 0, 1e-12);
+      k += j > 0 && !(a13 > 0 ? a12[j] > a12[j-1] : a12[j] < a12[j-1]);
+    }
+    if (k) cout << "testcrossings failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
+static int testbounds(bool exact) {
+  // All the points of the segment must lie in the box and the cap and the
+  // box must be tight
+  const int npts = 1000;
+  Geodesic g(Constants::WGS84_a(), Constants::WGS84_f(), exact);
+  int result = 0;
+  for (int i = 0; i < ncases; ++i) {
+    T lat1 = testcases[i][0], lon1 = testcases[i][1],
+      azi1 = testcases[i][2], s13 = testcases[i][6];
+    GeodesicLine l = g.DirectLine(lat1, lon1, azi1, 2 * s13);
+    T s1 = s13 / 3, s2 = 2 * s13;
+    GeodesicLine::SegmentBounds b = l.Bounds(s1, s2);
+    int k = 0;
+    T latmin = Math::qd, latmax = -Math::qd, dlonmax = 0;
+    for (int j = 0; j <= npts; ++j) {
+      T lat2, lon2, s12;
+      l.Position(s1 + j * (s2 - s1) / npts, lat2, lon2);
+      latmin = fmin(latmin, lat2); latmax = fmax(latmax, lat2);
+      T dlon = Math::AngNormalize(lon2 - b.lonmin);
+      if (dlon < -T(1e-10)) dlon += Math::td;
+      dlonmax = fmax(dlonmax, dlon);
+      g.Inverse(b.lat0, b.lon0, lat2, lon2, s12);
+      k += !(s12 <= b.radius * (1 + T(1e-12)));
+    }
+    k += checkEquals(latmin, b.latmin, 1e-3);
+    k += checkEquals(latmax, b.latmax, 1e-3);
+    k += !(b.latmin <= latmin && latmax <= b.latmax);
+    k += checkEquals(dlonmax, b.lonmax - b.lonmin, 1e-10);
+    GeodesicLine::SegmentBounds bb[2];
+    T lats[3] = {lat1, testcases[i][3], lat1},
+      lons[3] = {lon1, testcases[i][4], lon1};
+    GeodesicLine::Bounds(g, 3, lats, lons, bb);
+    k += checkEquals(bb[0].radius, s13 / 2, 1e-8);
+    k += checkEquals(bb[1].radius, s13 / 2, 1e-8);
+    k += checkEquals(bb[0].latmin, bb[1].latmin, 1e-12);
+    k += checkEquals(bb[0].latmax, bb[1].latmax, 1e-12);
+    k += checkEquals(bb[0].lonmax - bb[0].lonmin, bb[1].lonmax - bb[1].lonmin,
+                     1e-10);
+    if (k) cout << "testbounds failure: case " << i << "\n";
+    result += k;
+  }
+  return result;
+}
+
 template <class G>
 static int testdirect(T f = 1) {
   T lat1, lon1, azi1, lat2, lon2, azi2, s12, a12, m12, M12, M21, S12;
@@ -192,12 +769,99 @@ static int testarcdirect(T f = 1) {
   return result;
 }
 
+static int testtmextended() {
+  // Round trip TransverseMercatorExact with extendp = true near the branch
+  // point at lat = 0, lon = 90(1-e).  This covers the extended domain (lat <
+  // 0 for lon > 90(1-e)) and negative longitudes (where v and eta are
+  // negative) away from the equator.
+  const TransverseMercatorExact tm(Constants::WGS84_a(), Constants::WGS84_f(),
+                                   Constants::UTM_k0(), true);
+  int result = 0;
+  for (int j = -20; j <= 20; ++j) {
+    for (int k = -40; k <= 40; ++k) {
+      T lat = T(j) / 2, lon = (k < 0 ? -70 : 70) + T(k) / 2,
+        x, y, gam, scale, lat1, lon1;
+      if ((lon > 0 && lat < 0 && lon < 83) || (lon < 0 && fabs(lat) < 3))
+        continue;
+      tm.Forward(0, lat, lon, x, y, gam, scale);
+      tm.Reverse(0, x, y, lat1, lon1, gam, scale);
+      int i = checkEquals(lat1, lat, 1e-9) + checkEquals(lon1, lon, 1e-9);
+      if (i) cout << "testtmextended failure: " << lat << " " << lon << "\n";
+      result += i;
+    }
+  }
+  return result;
+}
+
 int main() {
   int n = 0, i;
 
   i = testinverse<Geodesic>(); n += i;
   if (i) cout << "testinverse<Geodesic> failure\n";
 
+  i = testinversebatch<Geodesic>(1); n += i;
+  if (i) cout << "testinversebatch<Geodesic> failure\n";
+  i = testinversebatch<Geodesic>(3); n += i;
+  if (i) cout << "testinversebatch<Geodesic> failure with threads\n";
+
+  i = testmatrix(false); n += i;
+  if (i) cout << "testmatrix(false) failure\n";
+
+  i = testmatrix(true); n += i;
+  if (i) cout << "testmatrix(true) failure\n";
+
+  i = testmatrixfile(); n += i;
+  if (i) cout << "testmatrixfile failure\n";
+
+  i = testrhumbmatrix(false); n += i;
+  if (i) cout << "testrhumbmatrix(false) failure\n";
+
+  i = testrhumbmatrix(true); n += i;
+  if (i) cout << "testrhumbmatrix(true) failure\n";
+
+  i = testorigin(false); n += i;
+  if (i) cout << "testorigin(false) failure\n";
+
+  i = testorigin(true); n += i;
+  if (i) cout << "testorigin(true) failure\n";
+
+  i = testwarminverse(); n += i;
+  if (i) cout << "testwarminverse failure\n";
+
+  i = testdistanceapprox(); n += i;
+  if (i) cout << "testdistanceapprox failure\n";
+
+  i = testdistancebounds(Constants::WGS84_f()); n += i;
+  if (i) cout << "testdistancebounds(WGS84) failure\n";
+
+  i = testdistancebounds(-T(1)/10); n += i;
+  if (i) cout << "testdistancebounds(prolate) failure\n";
+
+  i = testpositions(false); n += i;
+  if (i) cout << "testpositions(false) failure\n";
+
+  i = testpositions(true); n += i;
+  if (i) cout << "testpositions(true) failure\n";
+
+  i = testcrossings(false); n += i;
+  if (i) cout << "testcrossings(false) failure\n";
+
+  i = testcrossings(true); n += i;
+  if (i) cout << "testcrossings(true) failure\n";
+
+  i = testbounds(false); n += i;
+  if (i) cout << "testbounds(false) failure\n";
+
+  i = testbounds(true); n += i;
+  if (i) cout << "testbounds(true) failure\n";
+
+  i = testregistry(); n += i;
+
+  i = testcachedgeodesic(); n += i;
+
+  i = testgeodesicstart(1); n += i;
+  i = testgeodesicstart(-1); n += i;
+
   i = testdirect<Geodesic>(); n += i;
   if (i) cout << "testdirect<Geodesic> failure\n";
 
@@ -214,6 +878,12 @@ int main() {
   i = testarcdirect<GeodesicExact>(2); n += i;
   if (i) cout << "testarcdirect<GeodesicExact> failure\n";
 
+  i = testinversebatchexact(-9, 3); n += i;
+  if (i) cout << "testinversebatchexact failure\n";
+
+  i = testtmextended(); n += i;
+  if (i) cout << "testtmextended failure\n";
+
   if (n) {
     cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
     return 1;
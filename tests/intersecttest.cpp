@@ -10,6 +10,8 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 #include <GeographicLib/Math.hpp>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/Intersect.hpp>
@@ -75,9 +77,161 @@ int checkcoincident1() {
   return n;
 }
 
+int checksegments() {
+  // Check Intersect::Segments against calling Intersect::Segment for all
+  // pairs of a set of segments.
+  int n = 0;
+  const int num = 60;
+  vector<T> lat1(num), lon1(num), lat2(num), lon2(num);
+  for (int i = 0; i < num; ++i) {
+    // A deterministic scattering of segments of up to about 40d in length
+    lat1[i] = T((i * 37) % 120 - 60);
+    lon1[i] = T((i * 53) % 240 - 120);
+    lat2[i] = lat1[i] + T((i * 11) % 40 - 20);
+    lon2[i] = lon1[i] + T((i * 17) % 50 - 25);
+  }
+  T eps = 1/T(1000000);
+  for (int fi = -1; fi <= 1; ++fi) {
+    Geodesic geod(Constants::WGS84_a(), fi/T(10));
+    Intersect inter(geod);
+    for (int nthreads = 1; nthreads <= 3; nthreads += 2) {
+      vector<pair<size_t, size_t>> ij;
+      vector<int> c;
+      vector<Intersect::Point> p =
+        inter.Segments(num, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                       ij, &c, nthreads);
+      size_t k = 0;
+      for (int i = 0; i < num; ++i) {
+        for (int j = i + 1; j < num; ++j) {
+          int segmode, cc;
+          Intersect::Point q =
+            inter.Segment(lat1[i], lon1[i], lat2[i], lon2[i],
+                          lat1[j], lon1[j], lat2[j], lon2[j], segmode, &cc);
+          if (segmode != 0) continue;
+          if (k < ij.size() && ij[k] == make_pair(size_t(i), size_t(j))) {
+            int e = checkEquals(p[k].first, q.first, eps) +
+              checkEquals(p[k].second, q.second, eps) +
+              (c[k] == cc ? 0 : 1);
+            if (e) cout << "ERROR in segments " << i << " " << j << "\n";
+            n += e;
+            ++k;
+          } else {
+            cout << "ERROR missing segments " << i << " " << j << "\n";
+            ++n;
+          }
+        }
+      }
+      if (k != ij.size()) {
+        cout << "ERROR extra segments " << ij.size() - k << "\n";
+        ++n;
+      }
+    }
+  }
+  return n;
+}
+
+int checksegmentfan() {
+  // Check Intersect::SegmentFan against calling Intersect::Segment for each
+  // segment of a set.
+  int n = 0;
+  const int num = 60;
+  Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+  Intersect inter(geod);
+  vector<GeodesicLine> lines;
+  for (int i = 0; i < num; ++i) {
+    T lat1 = T((i * 37) % 120 - 60), lon1 = T((i * 53) % 240 - 120),
+      lat2 = lat1 + T((i * 11) % 40 - 20), lon2 = lon1 + T((i * 17) % 50 - 25);
+    lines.push_back(geod.InverseLine(lat1, lon1, lat2, lon2,
+                                     Intersect::LineCaps));
+  }
+  T eps = 1/T(1000000);
+  for (int x = 0; x < 10; ++x) {
+    GeodesicLine lineX = geod.InverseLine(T(x * 13 % 90 - 45), T(x * 29 - 140),
+                                          T(x * 7 % 60 - 20), T(x * 31 - 100),
+                                          Intersect::LineCaps);
+    for (int nthreads = 1; nthreads <= 3; nthreads += 2) {
+      vector<size_t> idx;
+      vector<int> c;
+      vector<Intersect::Point> p =
+        inter.SegmentFan(lineX, lines, idx, &c, nthreads);
+      size_t k = 0;
+      for (int i = 0; i < num; ++i) {
+        int segmode, cc;
+        Intersect::Point q = inter.Segment(lineX, lines[i], segmode, &cc);
+        if (segmode != 0) continue;
+        if (k < idx.size() && idx[k] == size_t(i)) {
+          int e = checkEquals(p[k].first, q.first, eps) +
+            checkEquals(p[k].second, q.second, eps) +
+            (c[k] == cc ? 0 : 1);
+          if (e) cout << "ERROR in segment fan " << x << " " << i << "\n";
+          n += e;
+          ++k;
+        } else {
+          cout << "ERROR missing segment fan " << x << " " << i << "\n";
+          ++n;
+        }
+      }
+      if (k != idx.size()) {
+        cout << "ERROR extra segment fan " << idx.size() - k << "\n";
+        ++n;
+      }
+    }
+  }
+  return n;
+}
+
+int checkall() {
+  // Check Intersect::All with a reused AllScratch against the version which
+  // returns vectors and against Intersect::Closest.
+  int n = 0;
+  Geodesic geod(Constants::WGS84_a(), Constants::WGS84_f());
+  Intersect inter(geod);
+  Intersect::AllScratch scratch;
+  T eps = 1/T(1000000);
+  for (int x = 0; x < 8; ++x) {
+    GeodesicLine
+      lineX = geod.Line(T(x * 13 % 90 - 45), T(x * 29 - 140), T(x * 41 - 150),
+                        Intersect::LineCaps),
+      lineY = geod.Line(T(x * 7 % 60 - 20), T(x * 31 - 100), T(x * 23 - 60),
+                        Intersect::LineCaps);
+    // Alternate between long and short queries, so that the scratch is
+    // reused after holding more data than is needed
+    T maxdist = x % 2 ? T(3e7) : T(1e7);
+    vector<int> c;
+    vector<Intersect::Point> p = inter.All(lineX, lineY, maxdist, c);
+    const size_t nmax = 100;
+    Intersect::Point q[nmax];
+    int cq[nmax];
+    size_t k = size_t(inter.All(lineX, lineY, maxdist, scratch, q, cq) - q);
+    if (k != p.size()) {
+      cout << "ERROR count all " << x << " " << k << " " << p.size() << "\n";
+      ++n;
+      continue;
+    }
+    for (size_t i = 0; i < k; ++i) {
+      int e = checkEquals(p[i].first, q[i].first, eps) +
+        checkEquals(p[i].second, q[i].second, eps) +
+        (c[i] == cq[i] ? 0 : 1);
+      if (e) cout << "ERROR in all " << x << " " << i << "\n";
+      n += e;
+    }
+    Intersect::Point r = inter.Closest(lineX, lineY);
+    if (k > 0 && Intersect::Dist(r) <= maxdist) {
+      int e = checkEquals(q[0].first, r.first, eps) +
+        checkEquals(q[0].second, r.second, eps);
+      if (e) cout << "ERROR closest all " << x << "\n";
+      n += e;
+    }
+  }
+  return n;
+}
+
 int main() {
   int n = 0;
   n += checkcoincident1();
+  n += checksegments();
+  n += checksegmentfan();
+  n += checkall();
   if (n) {
     cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
     return 1;
@@ -8,8 +8,11 @@
  **********************************************************************/
 
 #include <iostream>
+#include <algorithm>
+#include <memory>
 #include <limits>
 #include <string>
+#include <vector>
 #include <GeographicLib/Math.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -18,6 +21,7 @@
 #include <GeographicLib/UTMUPS.hpp>
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/PolygonArea.hpp>
+#include <GeographicLib/PointInPolygon.hpp>
 
 using namespace std;
 using namespace GeographicLib;
@@ -183,6 +187,211 @@ static int Planimeter29() {
   return result;
 }
 
+static int AddPoints() {
+  // AddPoints should give the same results as AddPoint for any number of
+  // threads; test a polygon long enough to need several blocks.
+  const Geodesic& g = Geodesic::WGS84();
+  const int n = 40000;
+  vector<T> lat(n), lon(n);
+  for (int i = 0; i < n; ++i) {
+    T a = Math::td * i / n;
+    lat[i] = 60 + 10 * Math::sind(7 * a);
+    lon[i] = a + 2 * Math::cosd(11 * a);
+  }
+  int result = 0;
+  for (int polyline = 0; polyline < 2; ++polyline) {
+    PolygonArea p0(g, polyline != 0);
+    T perim0, area0 = 0, perim, area = 0;
+    for (int i = 0; i < n; ++i) p0.AddPoint(lat[i], lon[i]);
+    p0.Compute(false, true, perim0, area0);
+    for (int nthreads = 1; nthreads <= 3; ++nthreads) {
+      PolygonArea p(g, polyline != 0);
+      // Start with a single point to check continuing a polygon
+      p.AddPoint(lat[0], lon[0]);
+      p.AddPoints(n - 1, lat.data() + 1, lon.data() + 1, nthreads);
+      result += p.Compute(false, true, perim, area) == unsigned(n) ? 0 : 1;
+      result += checkEquals(perim, perim0, 0);
+      result += checkEquals(area, area0, 0);
+    }
+  }
+  return result;
+}
+
+static int Rings() {
+  // Rings should give the same results as separate PolygonArea objects,
+  // including for degenerate rings with 0, 1, and 2 vertices.
+  const Geodesic& g = Geodesic::WGS84();
+  const int nrings = 200;
+  vector<size_t> offsets(1, 0);
+  vector<T> lat, lon;
+  for (int k = 0; k < nrings; ++k) {
+    int n = k < 3 ? k : 3 + k % 17;
+    for (int i = 0; i < n; ++i) {
+      T a = Math::td * i / n;
+      lat.push_back(T(k % 171) - 85 + 3 * Math::cosd(a));
+      lon.push_back(T(7 * k % 360) - 180 + 4 * Math::sind(a));
+    }
+    offsets.push_back(lat.size());
+  }
+  int result = 0;
+  for (int polyline = 0; polyline < 2; ++polyline) {
+    PolygonArea p(g, polyline != 0);
+    for (int sense = 0; sense < 4; ++sense) {
+      bool reverse = (sense & 1) != 0, sign = (sense & 2) != 0;
+      vector<T> perim(nrings), area(nrings, 0);
+      p.Rings(nrings, offsets.data(), lat.data(), lon.data(), reverse, sign,
+              perim.data(), area.data(), 3);
+      for (int k = 0; k < nrings; ++k) {
+        PolygonArea q(g, polyline != 0);
+        for (size_t i = offsets[k]; i < offsets[k + 1]; ++i)
+          q.AddPoint(lat[i], lon[i]);
+        T perim0, area0 = 0;
+        q.Compute(reverse, sign, perim0, area0);
+        result += checkEquals(perim[k], perim0, 0);
+        result += checkEquals(area[k], area0, 0);
+      }
+    }
+  }
+  return result;
+}
+
+static int TestPoints() {
+  // TestPoints should give the same results as TestPoint for each point,
+  // including for empty polygons.
+  const Geodesic& g = Geodesic::WGS84();
+  const int n = 100;
+  vector<T> lat(n), lon(n);
+  for (int i = 0; i < n; ++i) {
+    lat[i] = T(i % 36) * 5 - 87;
+    lon[i] = T(i * 13 % 360) - 180;
+  }
+  int result = 0;
+  for (int polyline = 0; polyline < 2; ++polyline) {
+    for (int npts = 0; npts < 4; ++npts) {
+      PolygonArea p(g, polyline != 0);
+      for (int i = 0; i < npts; ++i)
+        p.AddPoint(T(10 * i), T(40 * i) - 170);
+      for (int sense = 0; sense < 4; ++sense) {
+        bool reverse = (sense & 1) != 0, sign = (sense & 2) != 0;
+        vector<T> perim(n), area(n, 0);
+        unsigned num = p.TestPoints(n, lat.data(), lon.data(), reverse, sign,
+                                    perim.data(),
+                                    polyline ? nullptr : area.data(), 3);
+        for (int i = 0; i < n; ++i) {
+          T perim0, area0 = 0;
+          result += p.TestPoint(lat[i], lon[i], reverse, sign,
+                                perim0, area0) == num ? 0 : 1;
+          result += checkEquals(perim[i], perim0, 0);
+          result += checkEquals(area[i], area0, 0);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+static int checkContains(const PointInPolygon& fence, T lat, T lon,
+                         bool inside) {
+  if (fence.Contains(lat, lon) == inside)
+    return 0;
+  cout << "checkContains fails: " << lat << " " << lon << "\n";
+  return 1;
+}
+
+static int PointInPolygon0() {
+  // Compare with the result of testing that a point is on the same side of
+  // each edge of a convex polygon, with the vertices in either order.
+  const Geodesic& g = Geodesic::WGS84();
+  int result = 0;
+  const T lat[] = {10, 10, 30, 30}, lon[] = {10, 30, 30, 10};
+  for (int order = 0; order < 2; ++order) {
+    vector<T> plat(4), plon(4);
+    for (int k = 0; k < 4; ++k) {
+      plat[k] = lat[order ? 3 - k : k]; plon[k] = lon[order ? 3 - k : k];
+    }
+    PointInPolygon fence(g, 4, plat.data(), plon.data());
+    PolygonArea poly(g);
+    for (int k = 0; k < 4; ++k) poly.AddPoint(plat[k], plon[k]);
+    T perim, area;
+    poly.Compute(false, true, perim, area);
+    result += checkEquals(fence.Area(), fabs(area), 1);
+    vector<T> qlat, qlon;
+    vector<bool> inside0;
+    for (int i = 0; i < 50; ++i) {
+      for (int j = 0; j < 50; ++j) {
+        T la = T(5.25) + T(0.5) * i, lo = T(5.25) + T(0.5) * j;
+        bool in = true, close = false;
+        for (int k = 0; k < 4; ++k) {
+          T azi12, azi13, t;
+          g.Inverse(lat[k], lon[k], lat[(k+1)%4], lon[(k+1)%4], azi12, t);
+          g.Inverse(lat[k], lon[k], la, lo, azi13, t);
+          T d = Math::AngDiff(azi12, azi13);
+          close = close || fabs(d) < T(1e-9);
+          in = in && d < 0;
+        }
+        if (close) continue;
+        result += checkContains(fence, la, lo, in);
+        qlat.push_back(la); qlon.push_back(lo); inside0.push_back(in);
+      }
+    }
+    size_t n = qlat.size();
+    unique_ptr<bool[]> inside(new bool[n]);
+    fence.Contains(n, qlat.data(), qlon.data(), inside.get(), 3);
+    for (size_t i = 0; i < n; ++i)
+      result += inside[i] == inside0[i] ? 0 : 1;
+  }
+  return result;
+}
+
+static int PointInPolygon1() {
+  // Polygons encircling the poles, crossing the antimeridian, and one
+  // whose interior is a cap about the south pole
+  const Geodesic& g = Geodesic::WGS84();
+  int result = 0;
+  for (int order = 0; order < 2; ++order) {
+    for (int sgn = -1; sgn <= 1; sgn += 2) {
+      // At lon = 60, the edge is at lat = +/-85
+      vector<T> lat(3, sgn * T(80)), lon{0, 120, 240};
+      if (order) reverse(lon.begin(), lon.end());
+      PointInPolygon fence(g, 3, lat.data(), lon.data());
+      result += checkContains(fence,  sgn * T(90), 0, true);
+      result += checkContains(fence, -sgn * T(90), 0, false);
+      result += checkContains(fence,  sgn * T(86), 60, true);
+      result += checkContains(fence,  sgn * T(84), 60, false);
+      result += checkContains(fence,  sgn * T(87), -60, true);
+      result += checkContains(fence,  sgn * T(79), 33, false);
+      result += checkContains(fence,  sgn * T(82), 0, true);
+      result += checkContains(fence, 0, 60, false);
+    }
+    {
+      vector<T> lat{10, 10, 20, 20}, lon{170, -170, -170, 170};
+      if (order) reverse(lat.begin(), lat.end());
+      if (order) reverse(lon.begin(), lon.end());
+      PointInPolygon fence(g, 4, lat.data(), lon.data());
+      result += checkContains(fence, 15, 180, true);
+      result += checkContains(fence, 15, -180, true);
+      result += checkContains(fence, 15, 540, true);
+      result += checkContains(fence, 15, 175, true);
+      result += checkContains(fence, 15, -175, true);
+      result += checkContains(fence, 15, 0, false);
+      result += checkContains(fence, 15, 165, false);
+      result += checkContains(fence, 25, 180, false);
+      result += checkContains(fence, 5, 180, false);
+    }
+    {
+      vector<T> lat(4, -10), lon{0, 90, 180, 270};
+      if (order) reverse(lon.begin(), lon.end());
+      PointInPolygon fence(g, 4, lat.data(), lon.data());
+      result += checkContains(fence, -90, 0, true);
+      result += checkContains(fence, -45, 100, true);
+      result += checkContains(fence, 0, 45, false);
+      result += checkContains(fence, 90, 0, false);
+      result += fence.Contains(Math::NaN(), 0) ? 1 : 0;
+    }
+  }
+  return result;
+}
+
 int main() {
   int n = 0, i;
 
@@ -202,6 +411,26 @@ int main() {
   if (i)
     cout << "Planimeter29 failure\n";
 
+  i = AddPoints(); n += i;
+  if (i)
+    cout << "AddPoints failure\n";
+
+  i = Rings(); n += i;
+  if (i)
+    cout << "Rings failure\n";
+
+  i = TestPoints(); n += i;
+  if (i)
+    cout << "TestPoints failure\n";
+
+  i = PointInPolygon0(); n += i;
+  if (i)
+    cout << "PointInPolygon0 failure\n";
+
+  i = PointInPolygon1(); n += i;
+  if (i)
+    cout << "PointInPolygon1 failure\n";
+
   if (n) {
     cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
     return 1;
@@ -0,0 +1,379 @@
+/**
+ * \file reprotest.cpp
+ * \brief Test that the batch and multi-threaded functions are reproducible
+ *
+ * The results of the batch and multi-threaded functions must not depend on
+ * the number of threads.  If the library was built with
+ * GEOGRAPHICLIB_REPRODUCIBLE, they must also match the scalar functions and
+ * not depend on how the input is split into batches.
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <limits>
+#include <GeographicLib/Accumulator.hpp>
+#include <GeographicLib/CircularEngine.hpp>
+#include <GeographicLib/Geocentric.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/JacobiConformal.hpp>
+#include <GeographicLib/MGRS.hpp>
+#include <GeographicLib/SphericalHarmonic.hpp>
+#include <GeographicLib/TrackStatistics.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+
+using namespace std;
+using namespace GeographicLib;
+
+typedef Math::real T;
+
+static int checkSame(T x, T y) {
+  using std::isnan;             // Needed for Centos 7, ubuntu 14
+  if ((isnan(x) && isnan(y)) || x == y)
+    return 0;
+  cout << "checkSame fails: " << x << " != " << y << "\n";
+  return 1;
+}
+
+// A track around a hemisphere with some repeated points and times
+static void track(int n, vector<T>& lat, vector<T>& lon, vector<T>& time) {
+  lat.resize(n); lon.resize(n); time.resize(n);
+  for (int i = 0; i < n; ++i) {
+    T a = Math::td * i / n;
+    lat[i] = 40 + 30 * Math::sind(3 * a);
+    lon[i] = a / 2 + 5 * Math::cosd(17 * a);
+    time[i] = T(i - (i % 7 == 0 ? 1 : 0));
+  }
+}
+
+static int DirectBatch() {
+  // DirectBatch gives the scalar results for any number of threads
+  const Geodesic& g = Geodesic::WGS84();
+  const int n = 3000;
+  vector<T> lat1(n), lon1(n), azi1(n), s12(n);
+  for (int i = 0; i < n; ++i) {
+    lat1[i] = T(i % 179) - 89; lon1[i] = T(i % 360) - 180;
+    azi1[i] = T(i * 7 % 360) - 180; s12[i] = T(i) * 6000;
+  }
+  int result = 0;
+  for (int nthreads = 1; nthreads <= 4; ++nthreads) {
+    vector<T> lat2(n), lon2(n), azi2(n), s12x(n), m12(n), M12(n), M21(n),
+      S12(n);
+    g.DirectBatch(n, lat1.data(), lon1.data(), azi1.data(),
+                  false, s12.data(), Geodesic::ALL,
+                  lat2.data(), lon2.data(), azi2.data(), s12x.data(),
+                  m12.data(), M12.data(), M21.data(), S12.data(),
+                  nullptr, nthreads);
+    for (int i = 0; i < n; ++i) {
+      T lat, lon, azi, t, m, MM12, MM21, SS12;
+      g.GenDirect(lat1[i], lon1[i], azi1[i], false, s12[i], Geodesic::ALL,
+                  lat, lon, azi, t, m, MM12, MM21, SS12);
+      result += checkSame(lat2[i], lat) + checkSame(lon2[i], lon) +
+        checkSame(azi2[i], azi) + checkSame(s12x[i], t) +
+        checkSame(m12[i], m) +
+        checkSame(M12[i], MM12) + checkSame(M21[i], MM21) +
+        checkSame(S12[i], SS12);
+    }
+  }
+  return result;
+}
+
+static int TrackStatisticsThreads() {
+  // The statistics of a track don't depend on the number of threads; in a
+  // reproducible build they also don't depend on how the track is split
+  // into chunks.
+  const int n = 50000;
+  vector<T> lat, lon, time;
+  track(n, lat, lon, time);
+  TrackStatistics t0(Geodesic::WGS84());
+  t0.Add(n, lat.data(), lon.data(), time.data());
+  int result = 0;
+  for (int nthreads = 2; nthreads <= 4; ++nthreads) {
+    TrackStatistics t(Geodesic::WGS84());
+    t.Add(n, lat.data(), lon.data(), time.data(),
+          nullptr, nullptr, nullptr, nthreads);
+    result += checkSame(t.Length(), t0.Length()) +
+      checkSame(t.MaxSpeed(), t0.MaxSpeed());
+  }
+  if (Math::reproducible) {
+    TrackStatistics t1(Geodesic::WGS84()), t2(Geodesic::WGS84());
+    for (int i = 0; i < n; ++i)
+      t1.AddPoint(lat[i], lon[i], time[i]);
+    for (int i0 = 0, m = 1; i0 < n; i0 += m, m = 2 * m + 1) {
+      int m1 = min(m, n - i0);
+      t2.Add(m1, lat.data() + i0, lon.data() + i0, time.data() + i0,
+             nullptr, nullptr, nullptr, 3);
+    }
+    result += checkSame(t1.Length(), t0.Length()) +
+      checkSame(t2.Length(), t0.Length()) +
+      checkSame(t1.MaxSpeed(), t0.MaxSpeed());
+  }
+  return result;
+}
+
+static int JacobiConformalThreads() {
+  // The batch Forward gives the scalar results for any number of threads
+  const JacobiConformal jc(T(6378172), T(6378102), T(6356752));
+  const int n = 2000;
+  vector<T> omg(n), bet(n);
+  for (int i = 0; i < n; ++i) {
+    omg[i] = T(i % 361) - 180;
+    bet[i] = T(i * 11 % 359) - 179;
+  }
+  int result = 0;
+  for (int nthreads = 1; nthreads <= 4; ++nthreads) {
+    vector<T> x(n), y(n);
+    jc.Forward(n, omg.data(), bet.data(), x.data(), y.data(), nthreads);
+    for (int i = 0; i < n; ++i)
+      result += checkSame(x[i], jc.x(omg[i])) +
+        checkSame(y[i], jc.y(bet[i]));
+  }
+  return result;
+}
+
+static int SphericalHarmonicThreads() {
+  // In a reproducible build, splitting a spherical harmonic sum between
+  // threads doesn't change the result.
+  if (!Math::reproducible) return 0;
+  const int N = 400;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = T(1) / T(k % 97 + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = T(1) / T(k % 89 + 2);
+  SphericalHarmonic h(C, S, N, T(1));
+  T x = T(0.3), y = T(-0.4), z = T(0.8), gx, gy, gz;
+  T v0 = h(x, y, z), gx0, gy0, gz0, w0 = h(x, y, z, gx0, gy0, gz0);
+  int result = 0;
+  for (int nthreads = 2; nthreads <= 4; ++nthreads) {
+    h.SetThreads(nthreads);
+    result += checkSame(h(x, y, z), v0);
+    result += checkSame(h(x, y, z, gx, gy, gz), w0) +
+      checkSame(gx, gx0) + checkSame(gy, gy0) + checkSame(gz, gz0);
+  }
+  return result;
+}
+
+static int CircleThreads() {
+  // The CircularEngine doesn't depend on the number of threads used to
+  // construct it.
+  const int N = 400;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = T(1) / T(k % 97 + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = T(1) / T(k % 89 + 2);
+  SphericalHarmonic h(C, S, N, T(1));
+  T p = T(0.6), z = T(0.8), gx, gy, gz, gx0, gy0, gz0;
+  CircularEngine c0 = h.Circle(p, z, true);
+  int result = 0;
+  for (int nthreads = 2; nthreads <= 4; ++nthreads) {
+    h.SetThreads(nthreads);
+    CircularEngine c = h.Circle(p, z, true);
+    for (int lon = -180; lon < 180; lon += 7)
+      result += checkSame(c(T(lon), gx, gy, gz), c0(T(lon), gx0, gy0, gz0)) +
+        checkSame(gx, gx0) + checkSame(gy, gy0) + checkSame(gz, gz0);
+  }
+  return result;
+}
+
+static int LegendreTables() {
+  // The circles are the same with and without the table of the
+  // coefficients of the Legendre recursion.
+  const int N = 60, num = 5;
+  vector<T> C((N + 1) * (N + 2) / 2), S(N * (N + 1) / 2);
+  for (size_t k = 0; k < C.size(); ++k) C[k] = T(1) / T(k % 97 + 1);
+  for (size_t k = 0; k < S.size(); ++k) S[k] = T(1) / T(k % 89 + 2);
+  T p[num], z[num];
+  for (int i = 0; i < num; ++i) {
+    p[i] = Math::cosd(T(17 * i - 40)); z[i] = Math::sind(T(17 * i - 40));
+  }
+  int result = 0;
+  for (int k = 0; k < 2; ++k) {
+    SphericalHarmonic::normalization norm =
+      k ? SphericalHarmonic::SCHMIDT : SphericalHarmonic::FULL;
+    SphericalHarmonic h(C, S, N, T(1), norm);
+    vector<CircularEngine> c0(num), c1(num), cs0(num), cs1(num);
+    for (int i = 0; i < num; ++i) c0[i] = h.Circle(p[i], z[i], true);
+    h.Circles(num, p, z, true, cs0.data());
+    SphericalEngine::LegendreTable(N, SphericalEngine::normalization(norm));
+    for (int i = 0; i < num; ++i) c1[i] = h.Circle(p[i], z[i], true);
+    h.Circles(num, p, z, true, cs1.data());
+    for (int i = 0; i < num; ++i) {
+      for (int lon = -180; lon < 180; lon += 37) {
+        T gx, gy, gz, gx0, gy0, gz0;
+        result += checkSame(c1[i](T(lon), gx, gy, gz),
+                            c0[i](T(lon), gx0, gy0, gz0)) +
+          checkSame(gx, gx0) + checkSame(gy, gy0) + checkSame(gz, gz0);
+        result += checkSame(cs1[i](T(lon), gx, gy, gz),
+                            cs0[i](T(lon), gx0, gy0, gz0)) +
+          checkSame(gx, gx0) + checkSame(gy, gy0) + checkSame(gz, gz0);
+      }
+    }
+  }
+  SphericalEngine::ClearLegendreTables();
+  return result;
+}
+
+static int StridedArrays() {
+  // The strided versions of the batch functions give the same results as
+  // the array versions, including when converting records in place.
+  struct rec { T lat, lon, h; int zone; bool northp; };
+  const int n = 1000;
+  vector<rec> r(n);
+  vector<T> lat(n), lon(n), h(n);
+  for (int i = 0; i < n; ++i) {
+    r[i].lat = lat[i] = T(i % 179) - 89 + T(0.5);
+    r[i].lon = lon[i] = T(i * 7 % 360) - 180;
+    r[i].h = h[i] = T(i % 13) * 100;
+  }
+  const size_t st = sizeof(rec);
+  StridedArray<T> rlat(&r[0].lat, st), rlon(&r[0].lon, st), rh(&r[0].h, st);
+  int result = 0;
+  {
+    const Geocentric& earth = Geocentric::WGS84();
+    vector<T> X(n), Y(n), Z(n);
+    earth.Forward(n, lat.data(), lon.data(), h.data(),
+                  X.data(), Y.data(), Z.data());
+    // In place, the geodetic fields of the records get X, Y, Z
+    earth.Forward(n, rlat, rlon, rh, rlat, rlon, rh);
+    for (int i = 0; i < n; ++i)
+      result += checkSame(r[i].lat, X[i]) + checkSame(r[i].lon, Y[i]) +
+        checkSame(r[i].h, Z[i]);
+    earth.Reverse(n, X.data(), Y.data(), Z.data(),
+                  lat.data(), lon.data(), h.data());
+    earth.Reverse(n, rlat, rlon, rh, rlat, rlon, rh);
+    for (int i = 0; i < n; ++i)
+      result += checkSame(r[i].lat, lat[i]) + checkSame(r[i].lon, lon[i]) +
+        checkSame(r[i].h, h[i]);
+  }
+  {
+    vector<int> zone(n); vector<T> x(n), y(n), k(n);
+    bool np[n];
+    UTMUPS::Forward(n, lat.data(), lon.data(), zone.data(), np,
+                    x.data(), y.data(), nullptr, k.data());
+    vector<T> xs(n, 0), ks(n, 0);
+    UTMUPS::Forward(n, rlat, rlon, StridedArray<int>(&r[0].zone, st),
+                    StridedArray<bool>(&r[0].northp, st),
+                    xs.data(), rh, nullptr, ks.data());
+    for (int i = 0; i < n; ++i)
+      result += (r[i].zone != zone[i] || r[i].northp != np[i]) +
+        checkSame(xs[i], x[i]) + checkSame(r[i].h, y[i]) +
+        checkSame(ks[i], k[i]);
+  }
+  {
+    const Geodesic& g = Geodesic::WGS84();
+    vector<T> s12(n), azi1(n), azi2(n), azi1s(n), azi2s(n);
+    g.InverseBatch(n - 1, lat.data(), lon.data(), lat.data() + 1,
+                   lon.data() + 1, Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                   s12.data(), azi1.data(), azi2.data(),
+                   nullptr, nullptr, nullptr, nullptr);
+    // Consecutive records give the problems; azi2 is stored backwards
+    StridedArray<const T> clat(rlat), clon(rlon);
+    g.InverseBatch(n - 1, clat, clon, clat + 1, clon + 1,
+                   Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                   rh, azi1s.data(),
+                   StridedArray<T>(&azi2s[n - 2], -ptrdiff_t(sizeof(T))),
+                   nullptr, nullptr, nullptr, nullptr);
+    for (int i = 0; i < n - 1; ++i)
+      result += checkSame(r[i].h, s12[i]) + checkSame(azi1s[i], azi1[i]) +
+        checkSame(azi2s[n - 2 - i], azi2[i]);
+  }
+  return result;
+}
+
+static int MGRSBatch() {
+  // The batch conversion of MGRS strings to geographic coordinates matches
+  // MGRS::Reverse followed by UTMUPS::Reverse; the projections of the
+  // points in a zone are done together; so the match is only exact in a
+  // reproducible build.
+  const int n = 3000;
+  const size_t stride = MGRS::MAXLENGTH + 1;
+  vector<char> buf(n * stride);
+  for (int i = 0; i < n; ++i) {
+    char* s = buf.data() + i * stride;
+    if (i % 101 == 0)
+      strcpy(s, "INV");
+    else if (i % 103 == 0)
+      strcpy(s, i % 2 ? "38s" : "Z");
+    else {
+      T lat = T(i % 179) - 89 + T(0.25), lon = T(i * 7 % 360) - 180;
+      int zone; bool northp; T x, y;
+      UTMUPS::Forward(lat, lon, zone, northp, x, y);
+      MGRS::Forward(zone, northp, x, y, lat, i % 6, s);
+    }
+  }
+  vector<T> lat(n), lon(n);
+  vector<int> prec(n);
+  MGRS::Reverse(n, buf.data(), stride, lat.data(), lon.data(), prec.data());
+  int result = 0;
+  for (int i = 0; i < n; ++i) {
+    int zone, prec1; bool northp; T x, y, lat1, lon1;
+    MGRS::Reverse(buf.data() + i * stride, zone, northp, x, y, prec1);
+    UTMUPS::Reverse(zone, northp, x, y, lat1, lon1);
+    result += prec[i] != prec1;
+    if (Math::reproducible)
+      result += checkSame(lat[i], lat1) + checkSame(lon[i], lon1);
+    else {
+      using std::isnan; using std::fabs;
+      const T tol = 100 * Math::qd * numeric_limits<T>::epsilon();
+      if (isnan(lat1) ? !isnan(lat[i]) :
+          !(fabs(lat[i] - lat1) <= tol &&
+            fabs(Math::AngDiff(lon1, lon[i])) <= tol)) {
+        cout << "MGRSBatch fails for " << buf.data() + i * stride << "\n";
+        ++result;
+      }
+    }
+  }
+  return result;
+}
+
+static int AccumulatorArray() {
+  // In a reproducible build, adding an array to an Accumulator is the
+  // same as adding the elements one at a time.
+  if (!Math::reproducible) return 0;
+  const int n = 10001;
+  vector<T> x(n);
+  for (int i = 0; i < n; ++i)
+    x[i] = (i % 3 ? 1 : -1) * T(1) / T(i + 1) + (i % 5 ? 0 : T(1e10));
+  Accumulator<T> a, b;
+  a.Add(n, x.data());
+  for (int i = 0; i < n; ++i) b += x[i];
+  return checkSame(a(), b());
+}
+
+int main() {
+  int n = 0, i;
+
+  i = DirectBatch(); n += i;
+  if (i) cout << "DirectBatch failure\n";
+
+  i = TrackStatisticsThreads(); n += i;
+  if (i) cout << "TrackStatisticsThreads failure\n";
+
+  i = JacobiConformalThreads(); n += i;
+  if (i) cout << "JacobiConformalThreads failure\n";
+
+  i = SphericalHarmonicThreads(); n += i;
+  if (i) cout << "SphericalHarmonicThreads failure\n";
+
+  i = CircleThreads(); n += i;
+  if (i) cout << "CircleThreads failure\n";
+
+  i = LegendreTables(); n += i;
+  if (i) cout << "LegendreTables failure\n";
+
+  i = StridedArrays(); n += i;
+  if (i) cout << "StridedArrays failure\n";
+
+  i = MGRSBatch(); n += i;
+  if (i) cout << "MGRSBatch failure\n";
+
+  i = AccumulatorArray(); n += i;
+  if (i) cout << "AccumulatorArray failure\n";
+
+  if (n) {
+    cout << n << " failure" << (n > 1 ? "s" : "") << "\n";
+    return 1;
+  }
+}
@@ -44,8 +44,19 @@
 #endif
 
 // use "do { } while (false)" idiom so it can be punctuated like a statement.
+// With GEOGRAPHICLIB_PRECISION = 6, the real type, DoubleDouble, doesn't have
+// a fixed precision, so that, for example, 1 + eps/4 isn't rounded to 1 and
+// 180 - eps isn't rounded to 180.  Skip the tests which rely on this rounding.
+#if GEOGRAPHICLIB_PRECISION == 6
+#  define VARIABLE_PRECISION 1
+#else
+#  define VARIABLE_PRECISION 0
+#endif
+
 #define REMQUO_CHECK(CMD) do { if (!BUGGY_REMQUO) { CMD; } } while (false)
 #define ROUNDING_CHECK(CMD) do { if (!BUGGY_ROUNDING) { CMD; } } while (false)
+#define PRECISION_CHECK(CMD) \
+  do { if (!VARIABLE_PRECISION) { CMD; } } while (false)
 
 using namespace std;
 using namespace GeographicLib;
@@ -102,7 +113,7 @@ int main() {
   T inf = Math::infinity(),
     nan = Math::NaN(),
     eps = numeric_limits<T>::epsilon(),
-    ovf = 1 / Math::sq(eps),
+    ovf = 1 / Math::_sq(eps),
     e;
   int n = 0;
 
@@ -130,23 +141,23 @@ int main() {
   check( Math::AngRound((1-eps/2)/16), (1-eps/2)/16);
   check( Math::AngRound((1-eps/4)/16),  T(1)    /16);
   check( Math::AngRound( T(1)    /16),  T(1)    /16);
-  check( Math::AngRound((1+eps/4)/16),  T(1)    /16);
-  check( Math::AngRound((1+eps/2)/16),  T(1)    /16);
+  PRECISION_CHECK(check( Math::AngRound((1+eps/4)/16),  T(1)    /16));
+  PRECISION_CHECK(check( Math::AngRound((1+eps/2)/16),  T(1)    /16));
   check( Math::AngRound((1+eps  )/16), (1+eps  )/16);
   check( Math::AngRound((1-eps  )/ 8), (1-eps  )/ 8);
   check( Math::AngRound((1-eps/2)/ 8), (1-eps/2)/ 8);
-  check( Math::AngRound((1-eps/4)/ 8),  T(1)    / 8);
-  check( Math::AngRound((1+eps/2)/ 8),  T(1)    / 8);
+  PRECISION_CHECK(check( Math::AngRound((1-eps/4)/ 8),  T(1)    / 8));
+  PRECISION_CHECK(check( Math::AngRound((1+eps/2)/ 8),  T(1)    / 8));
   check( Math::AngRound((1+eps  )/ 8), (1+eps  )/ 8);
   check( Math::AngRound( 1-eps      ),  1-eps      );
   check( Math::AngRound( 1-eps/2    ),  1-eps/2    );
-  check( Math::AngRound( 1-eps/4    ),  1          );
+  PRECISION_CHECK(check( Math::AngRound( 1-eps/4    ),  1          ));
   check( Math::AngRound( T(1)       ),  1          );
-  check( Math::AngRound( 1+eps/4    ),  1          );
-  check( Math::AngRound( 1+eps/2    ),  1          );
+  PRECISION_CHECK(check( Math::AngRound( 1+eps/4    ),  1          ));
+  PRECISION_CHECK(check( Math::AngRound( 1+eps/2    ),  1          ));
   check( Math::AngRound( 1+eps      ),  1+  eps    );
   check( Math::AngRound(T(90)-64*eps),  90-64*eps  );
-  check( Math::AngRound(T(90)-32*eps),  90         );
+  PRECISION_CHECK(check( Math::AngRound(T(90)-32*eps),  90         ));
   check( Math::AngRound(T(90)       ),  90         );
 
   checksincosd(-  inf ,  nan,  nan);
@@ -302,10 +313,10 @@ int main() {
   check( Math::AngDiff(+T(365), +T(  5), e), -0.0 );
   check( Math::AngDiff(+T(  5), +T(185), e), +180.0 );
   check( Math::AngDiff(+T(185), +T(  5), e), -180.0 );
-  check( Math::AngDiff( +eps  , +T(180), e), +180.0 );
-  check( Math::AngDiff( -eps  , +T(180), e), -180.0 );
-  check( Math::AngDiff( +eps  , -T(180), e), +180.0 );
-  check( Math::AngDiff( -eps  , -T(180), e), -180.0 );
+  PRECISION_CHECK(check( Math::AngDiff( +eps  , +T(180), e), +180.0 ));
+  PRECISION_CHECK(check( Math::AngDiff( -eps  , +T(180), e), -180.0 ));
+  PRECISION_CHECK(check( Math::AngDiff( +eps  , -T(180), e), +180.0 ));
+  PRECISION_CHECK(check( Math::AngDiff( -eps  , -T(180), e), -180.0 ));
 
   {
     T x = 138 + 128 * eps, y = -164;
@@ -523,7 +534,9 @@ int main() {
     const GeodesicExact& ge = GeodesicExact::WGS84();
     T lon2, azi2;
     int i = 0;
-    for (int k = 0; k < 4; ++k) {
+    // In the cases azi1 = +/-180, lon2 = +/-180 relies on the rounding of
+    // the result
+    for (int k = 0; k < (VARIABLE_PRECISION ? 2 : 4); ++k) {
       T t;
       g.GenDirect(T(0), T(0), C[k][0], false, T(15e6),
                   Geodesic::LONGITUDE | Geodesic::AZIMUTH |
@@ -563,6 +576,9 @@ int main() {
       if (!( mgrs == (k == 0 ? "31NEA0000" : "31MEV0099") )) ++i;
       MGRS::Forward(zone, northp, x, y, -T(0), 2, mgrs);
       if (!( mgrs == (k == 0 ? "31NEA0000" : "31MEV0099") )) ++i;
+      char mgrsc[MGRS::MAXLENGTH + 1];
+      if (!( MGRS::Forward(zone, northp, x, y, 2, mgrsc) == 9 &&
+             mgrs == mgrsc )) ++i;
     }
     if (i) {
       cout << "Line " << __LINE__
@@ -13,6 +13,10 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstring>
 #include <GeographicLib/GeoCoords.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -24,13 +28,87 @@
 #endif
 
 #include "GeoConvert.usage"
+#include "ToolIO.hpp"
+
+typedef GeographicLib::Math::real real;
+
+// The settings needed to convert a line of input.  Convert is const so that
+// it may be called from several threads at once.
+class GeoConverter {
+public:
+  enum { GEOGRAPHIC, DMS, UTMUPS, MGRS, CONVERGENCE };
+  int outputmode, prec, zone;
+  bool centerp, longfirst, sethemisphere, northp, abbrev;
+  char dmssep;
+  std::string cdelim;
+  GeoConverter()
+    : outputmode(GEOGRAPHIC), prec(0), zone(GeographicLib::UTMUPS::MATCH)
+    , centerp(true), longfirst(false), sethemisphere(false), northp(false)
+    , abbrev(true), dmssep(char(0))
+  {}
+  // Convert one line of input, returning false if there's an error.  p is
+  // the GeoCoords object for the position (used to latch the zone).
+  bool Convert(const std::string& line, std::string& out,
+               GeographicLib::GeoCoords& p) const;
+};
+
+bool GeoConverter::Convert(const std::string& line, std::string& out,
+                           GeographicLib::GeoCoords& p) const {
+  using namespace GeographicLib;
+  std::string eol("\n");
+  bool ok = true;
+  try {
+    std::string::size_type m = cdelim.empty() ? std::string::npos :
+      line.find(cdelim);
+    if (m != std::string::npos) {
+      eol = " " + line.substr(m) + "\n";
+      p.Reset(line.substr(0, m), centerp, longfirst);
+    } else
+      p.Reset(line, centerp, longfirst);
+    p.SetAltZone(zone);
+    switch (outputmode) {
+    case GEOGRAPHIC:
+      out = p.GeoRepresentation(prec, longfirst);
+      break;
+    case DMS:
+      out = p.DMSRepresentation(prec, longfirst, dmssep);
+      break;
+    case UTMUPS:
+      out = (sethemisphere
+             ? p.AltUTMUPSRepresentation(northp, prec, abbrev)
+             : p.AltUTMUPSRepresentation(prec, abbrev));
+      break;
+    case MGRS:
+      out = p.AltMGRSRepresentation(prec);
+      break;
+    case CONVERGENCE:
+      {
+        real
+          gamma = p.AltConvergence(),
+          k = p.AltScale();
+        int prec1 = std::max(-5, std::min(Math::extra_digits() + 8, prec));
+        out = Utility::str(gamma, prec1 + 5) + " "
+          + Utility::str(k, prec1 + 7);
+      }
+    }
+  }
+  catch (const std::exception& e) {
+    // Write error message to cout so output lines match input lines
+    out = std::string("ERROR: ") + e.what();
+    ok = false;
+  }
+  out += eol;
+  return ok;
+}
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
-    enum { GEOGRAPHIC, DMS, UTMUPS, MGRS, CONVERGENCE };
+    ToolStats stats;
+    enum { GEOGRAPHIC = GeoConverter::GEOGRAPHIC, DMS = GeoConverter::DMS,
+           UTMUPS = GeoConverter::UTMUPS, MGRS = GeoConverter::MGRS,
+           CONVERGENCE = GeoConverter::CONVERGENCE };
     int outputmode = GEOGRAPHIC;
     int prec = 0;
     int zone = UTMUPS::MATCH;
@@ -38,6 +116,7 @@ int main(int argc, const char* const argv[]) {
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';', dmssep = char(0);
     bool sethemisphere = false, northp = false, abbrev = true, latch = false;
+    unsigned nthreads = 1;
 
     for (int m = 1; m < argc; ++m) {
       std::string arg(argv[m]);
@@ -129,7 +208,12 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-      } else if (arg == "--version") {
+      } else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--stats")
+        stats.Enable();
+      else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         MGRS::Check();
@@ -143,7 +227,7 @@ int main(int argc, const char* const argv[]) {
       return 1;
     }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
       infile.open(ifile.c_str());
@@ -164,7 +248,7 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
       outfile.open(ofile.c_str());
@@ -175,63 +259,74 @@ int main(int argc, const char* const argv[]) {
     }
     std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
 
+    GeoConverter conv;
+    conv.outputmode = outputmode; conv.prec = prec; conv.zone = zone;
+    conv.centerp = centerp; conv.longfirst = longfirst;
+    conv.sethemisphere = sethemisphere; conv.northp = northp;
+    conv.abbrev = abbrev; conv.dmssep = dmssep; conv.cdelim = cdelim;
+
     GeoCoords p;
-    std::string s, eol;
-    std::string os;
+    stats.Stage("setup");
     int retval = 0;
-
-    while (std::getline(*input, s)) {
-      eol = "\n";
-      try {
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
-          }
-        }
-        p.Reset(s, centerp, longfirst);
-        p.SetAltZone(zone);
-        switch (outputmode) {
-        case GEOGRAPHIC:
-          os = p.GeoRepresentation(prec, longfirst);
-          break;
-        case DMS:
-          os = p.DMSRepresentation(prec, longfirst, dmssep);
-          break;
-        case UTMUPS:
-          os = (sethemisphere
-                ? p.AltUTMUPSRepresentation(northp, prec, abbrev)
-                : p.AltUTMUPSRepresentation(prec, abbrev));
-          break;
-        case MGRS:
-          os = p.AltMGRSRepresentation(prec);
-          break;
-        case CONVERGENCE:
-          {
-            real
-              gamma = p.AltConvergence(),
-              k = p.AltScale();
-            int prec1 = std::max(-5, std::min(Math::extra_digits() + 8, prec));
-            os = Utility::str(gamma, prec1 + 5) + " "
-              + Utility::str(k, prec1 + 7);
-          }
-        }
-        if (latch &&
-            zone < UTMUPS::MINZONE && p.AltZone() >= UTMUPS::MINZONE) {
-          zone = p.AltZone();
-          northp = p.Northp();
-          sethemisphere = true;
-          latch = false;
-        }
+    // The zone for -S and -T is latched on the first line with a UTM zone;
+    // until then the lines are converted one at a time.
+    auto convertlatch = [&](const std::string& line, std::string& out)
+      -> void {
+      if (!conv.Convert(line, out, p)) retval = 1;
+      if (latch &&
+          conv.zone < UTMUPS::MINZONE && p.AltZone() >= UTMUPS::MINZONE) {
+        conv.zone = p.AltZone();
+        conv.northp = p.Northp();
+        conv.sethemisphere = true;
+        latch = false;
       }
-      catch (const std::exception& e) {
-        // Write error message to cout so output lines match input lines
-        os = std::string("ERROR: ") + e.what();
-        retval = 1;
+    };
+    if (nthreads <= 1) {
+      // Process each line as it is read
+      std::string s, os;
+      while (std::getline(*input, s)) {
+        auto t = ToolStats::Now();
+        convertlatch(s, os);
+        stats.Time("convert", t);
+        *output << os;
+        stats.Rows();
       }
-      *output << os << eol;
+    } else {
+      // Read the input in blocks and convert it in chunks of lines divided
+      // among the threads; write out the results for each chunk in order.
+      const size_t chunk = 4096 * nthreads;
+      LineReader reader(*input);
+      std::vector<std::string> lines(chunk), outs(chunk);
+      std::vector<char> oks(chunk);
+      std::string obuf;
+      size_t n;
+      do {
+        auto t = ToolStats::Now();
+        for (n = 0; n < chunk && reader.Next(lines[n]); ++n) {}
+        stats.Time("input", t); t = ToolStats::Now();
+        size_t i0 = 0;
+        for (; latch && i0 < n; ++i0) {
+          convertlatch(lines[i0], outs[i0]);
+          oks[i0] = true;
+        }
+        ParallelFor(n - i0, nthreads, [&](size_t j0, size_t j1) {
+          GeoCoords q;
+          for (size_t i = i0 + j0; i < i0 + j1; ++i)
+            oks[i] = conv.Convert(lines[i], outs[i], q);
+        });
+        stats.Time("convert", t); t = ToolStats::Now();
+        obuf.clear();
+        for (size_t i = 0; i < n; ++i) {
+          obuf += outs[i];
+          if (!oks[i]) retval = 1;
+        }
+        output->write(obuf.data(), obuf.size());
+        stats.Time("output", t);
+        stats.Rows(n);
+      } while (n == chunk);
     }
+    stats.Stage("process");
+    stats.Report(std::cerr, "GeoConvert");
     return retval;
   }
   catch (const std::exception& e) {
@@ -0,0 +1,564 @@
+/**
+ * \file GeoServer.cpp
+ * \brief Command line utility serving geodesic, geoid, gravity, and magnetic
+ *   field requests from a persistent process
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ *
+ * See the <a href="GeoServer.1.html">man page</a> for usage information.
+ **********************************************************************/
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MagneticModel.hpp>
+#include <GeographicLib/GeoCoords.hpp>
+#include <GeographicLib/DMS.hpp>
+#include <GeographicLib/Utility.hpp>
+
+#if !defined(_WIN32)
+#  include <csignal>
+#  include <cstring>
+#  include <cerrno>
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#  define GEOSERVER_SOCKETS 1
+#else
+#  define GEOSERVER_SOCKETS 0
+#endif
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions and potentially
+// uninitialized local variables
+#  pragma warning (disable: 4127 4701)
+#endif
+
+#include "GeoServer.usage"
+
+typedef GeographicLib::Math::real real;
+
+// The name is used to form a file name; don't let it specify a directory.
+void CheckName(const std::string& name) {
+  if (name.empty() || name.find_first_of("/\\") != std::string::npos ||
+      name[0] == '.')
+    throw GeographicLib::GeographicErr("Illegal model name " + name);
+}
+
+// The models loaded so far, indexed by name.  A model is loaded on its
+// first use and is kept for the lifetime of the process; all the objects
+// are thread safe.
+template<class Model>
+class ModelCache {
+private:
+  std::mutex _lock;
+  std::map<std::string, std::unique_ptr<const Model>> _models;
+public:
+  template<class F>
+  const Model& Get(const std::string& name, const F& load) {
+    CheckName(name);
+    // Loading a model holds the lock; so concurrent first uses of a model
+    // only load it once.
+    std::lock_guard<std::mutex> g(_lock);
+    auto p = _models.find(name);
+    if (p == _models.end())
+      p = _models.emplace(name, std::unique_ptr<const Model>(load())).first;
+    return *p->second;
+  }
+};
+
+class Server {
+private:
+  const GeographicLib::Geodesic _geod;
+  int _prec;
+  bool _mapped;
+  ModelCache<GeographicLib::Geoid> _geoids;
+  ModelCache<GeographicLib::GravityModel> _gravity;
+  ModelCache<GeographicLib::MagneticModel> _magnetic;
+  // The geoids being loaded in the background (--preload), indexed by name,
+  // together with the names of the geoids used in their place until they
+  // are ready (empty if the requests should wait).
+  struct PendingGeoid {
+    std::future<std::unique_ptr<GeographicLib::Geoid>> load;
+    std::string fallback;
+  };
+  std::mutex _pendinglock;
+  std::map<std::string, PendingGeoid> _pending;
+  static void Check(const std::vector<std::string>& tok, size_t n) {
+    if (tok.size() != n)
+      throw GeographicLib::GeographicErr("Command " + tok[0] + " needs " +
+                                         std::to_string(n - 1) +
+                                         " arguments");
+  }
+  static real Num(const std::string& s)
+  { return GeographicLib::Utility::val<real>(s); }
+  const GeographicLib::Geoid& LoadGeoid(const std::string& name) {
+    {
+      std::lock_guard<std::mutex> g(_pendinglock);
+      auto p = _pending.find(name);
+      if (p != _pending.end()) {
+        if (!p->second.fallback.empty() &&
+            p->second.load.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+          return LoadGeoidNow(p->second.fallback);
+        // Holding the lock, move the geoid into the cache (or, if loading
+        // failed, remove the entry so that later requests try again).
+        std::future<std::unique_ptr<GeographicLib::Geoid>> load =
+          std::move(p->second.load);
+        _pending.erase(p);
+        std::unique_ptr<GeographicLib::Geoid> geoid = load.get();
+        return _geoids.Get(name, [&geoid]() { return geoid.release(); });
+      }
+    }
+    return LoadGeoidNow(name);
+  }
+  const GeographicLib::Geoid& LoadGeoidNow(const std::string& name) {
+    bool mapped = _mapped;
+    return _geoids.Get(name, [&name, mapped]() {
+      using GeographicLib::Geoid;
+      if (mapped) {
+        try {
+          return new Geoid(name, "", true, true, true);
+        }
+        catch (const std::exception&) {
+          // e.g., a tiled data set; fall back to reading the data
+        }
+      }
+      return new Geoid(name, "", true, true);
+    });
+  }
+  const GeographicLib::GravityModel& LoadGravity(const std::string& name) {
+    bool mapped = _mapped;
+    return _gravity.Get(name, [&name, mapped]() {
+      using GeographicLib::GravityModel;
+      if (mapped) {
+        try {
+          return new GravityModel(name, "", -1, -1, false, true);
+        }
+        catch (const std::exception&) {
+          // e.g., not a little-endian machine; fall back to reading the data
+        }
+      }
+      return new GravityModel(name);
+    });
+  }
+  const GeographicLib::MagneticModel& LoadMagnetic(const std::string& name) {
+    bool mapped = _mapped;
+    return _magnetic.Get(name, [&name, mapped]() {
+      using namespace GeographicLib;
+      if (mapped) {
+        try {
+          return new MagneticModel(name, "", Geocentric::WGS84(),
+                                   -1, -1, false, true);
+        }
+        catch (const std::exception&) {
+          // fall back to reading the data
+        }
+      }
+      return new MagneticModel(name);
+    });
+  }
+public:
+  Server(real a, real f, int prec, bool mapped)
+    : _geod(a, f), _prec(prec), _mapped(mapped) {}
+  // Start loading the geoid name with nthreads threads in the background;
+  // until it's ready, requests for name are answered using the geoid
+  // fallback (which is loaded now), or, if fallback is empty, wait.
+  void Preload(const std::string& name, const std::string& fallback,
+               int nthreads) {
+    CheckName(name);
+    if (!fallback.empty()) {
+      CheckName(fallback);
+      LoadGeoidNow(fallback);
+    }
+    if (_mapped) {
+      // Mapping the data is fast; so just do it now.
+      LoadGeoidNow(name);
+      return;
+    }
+    std::lock_guard<std::mutex> g(_pendinglock);
+    if (_pending.find(name) != _pending.end() || name == fallback)
+      throw GeographicLib::GeographicErr("Geoid " + name +
+                                         " is already being preloaded");
+    PendingGeoid pending;
+    pending.load = GeographicLib::Geoid::LoadAsync(name, "", true, nthreads);
+    pending.fallback = fallback;
+    _pending.emplace(name, std::move(pending));
+  }
+  // Handle one request returning the response (without the line ending).
+  std::string Process(const std::string& line) {
+    using namespace GeographicLib;
+    try {
+      std::istringstream str(line);
+      std::vector<std::string> tok;
+      for (std::string s; str >> s;) tok.push_back(s);
+      if (tok.empty()) return "";
+      const std::string& cmd = tok[0];
+      if (cmd == "inverse") {
+        Check(tok, 5);
+        real lat1, lon1, lat2, lon2, azi1, azi2, s12;
+        DMS::DecodeLatLon(tok[1], tok[2], lat1, lon1);
+        DMS::DecodeLatLon(tok[3], tok[4], lat2, lon2);
+        _geod.Inverse(lat1, lon1, lat2, lon2, s12, azi1, azi2);
+        return DMS::Encode(azi1, _prec + 5, DMS::NUMBER) + " " +
+          DMS::Encode(azi2, _prec + 5, DMS::NUMBER) + " " +
+          Utility::str(s12, _prec);
+      } else if (cmd == "direct") {
+        Check(tok, 5);
+        real lat1, lon1, azi1, s12, lat2, lon2, azi2;
+        DMS::DecodeLatLon(tok[1], tok[2], lat1, lon1);
+        azi1 = DMS::DecodeAzimuth(tok[3]);
+        s12 = Num(tok[4]);
+        _geod.Direct(lat1, lon1, azi1, s12, lat2, lon2, azi2);
+        return DMS::Encode(lat2, _prec + 5, DMS::NUMBER) + " " +
+          DMS::Encode(lon2, _prec + 5, DMS::NUMBER) + " " +
+          DMS::Encode(azi2, _prec + 5, DMS::NUMBER);
+      } else if (cmd == "convert") {
+        if (tok.size() < 3)
+          throw GeographicErr("Command convert needs a format and a position");
+        std::string pos = tok[2];
+        for (size_t i = 3; i < tok.size(); ++i) pos += " " + tok[i];
+        GeoCoords p(pos);
+        if (tok[1] == "g")
+          return p.GeoRepresentation();
+        else if (tok[1] == "d")
+          return p.DMSRepresentation();
+        else if (tok[1] == "u")
+          return p.UTMUPSRepresentation();
+        else if (tok[1] == "m")
+          return p.MGRSRepresentation();
+        else
+          throw GeographicErr("Unknown format " + tok[1]);
+      } else if (cmd == "geoid") {
+        Check(tok, 4);
+        const GeographicLib::Geoid& g = LoadGeoid(tok[1]);
+        real lat, lon;
+        DMS::DecodeLatLon(tok[2], tok[3], lat, lon);
+        return Utility::str(g(lat, lon), 4);
+      } else if (cmd == "gravity") {
+        Check(tok, 5);
+        const std::string& name = tok[1];
+        const GravityModel& g = LoadGravity(name);
+        real lat, lon, h = Num(tok[4]), gx, gy, gz;
+        DMS::DecodeLatLon(tok[2], tok[3], lat, lon);
+        g.Gravity(lat, lon, h, gx, gy, gz);
+        return Utility::str(gx, 5) + " " + Utility::str(gy, 5) + " " +
+          Utility::str(gz, 5);
+      } else if (cmd == "magnetic") {
+        Check(tok, 6);
+        const std::string& name = tok[1];
+        const MagneticModel& m = LoadMagnetic(name);
+        real t = Num(tok[2]), lat, lon, h = Num(tok[5]), Bx, By, Bz,
+          H, F, D, I;
+        DMS::DecodeLatLon(tok[3], tok[4], lat, lon);
+        m(t, lat, lon, h, Bx, By, Bz);
+        MagneticModel::FieldComponents(Bx, By, Bz, H, F, D, I);
+        // The same as MagneticField's output: D I H By Bx -Bz F.
+        return DMS::Encode(D, 2, DMS::NUMBER) + " " +
+          DMS::Encode(I, 2, DMS::NUMBER) + " " +
+          Utility::str(H, 1) + " " + Utility::str(By, 1) + " " +
+          Utility::str(Bx, 1) + " " + Utility::str(-Bz, 1) + " " +
+          Utility::str(F, 1);
+      } else
+        throw GeographicErr("Unknown command " + cmd);
+    }
+    catch (const std::exception& e) {
+      // Write error message and continue
+      return std::string("ERROR: ") + e.what();
+    }
+  }
+};
+
+#if GEOSERVER_SOCKETS
+// Serve the requests on the connection fd until it's closed.  A client which
+// sends a line longer than maxline is sent an error and disconnected.
+void Serve(Server& server, int fd) {
+  const std::string::size_type maxline = 65536;
+  std::string buf, out;
+  char chunk[4096];
+  for (;;) {
+    ssize_t k = read(fd, chunk, sizeof(chunk));
+    if (k < 0 && errno == EINTR) continue;
+    if (k <= 0) break;
+    buf.append(chunk, size_t(k));
+    // Answer all the complete lines in the buffer with a single write.
+    out.clear();
+    std::string::size_type p0 = 0, p;
+    while ((p = buf.find('\n', p0)) != std::string::npos) {
+      std::string line = buf.substr(p0, p - p0);
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      out += server.Process(line) + "\n";
+      p0 = p + 1;
+    }
+    buf.erase(0, p0);
+    bool toolong = buf.size() > maxline;
+    if (toolong)
+      out += "ERROR: Line longer than " +
+        GeographicLib::Utility::str(maxline) + " characters\n";
+    for (size_t w = 0; w < out.size();) {
+      ssize_t j = write(fd, out.data() + w, out.size() - w);
+      if (j < 0 && errno == EINTR) continue;
+      if (j <= 0) { close(fd); return; }
+      w += size_t(j);
+    }
+    if (toolong) {
+      // Discard the rest of the input, so that the client sees the error
+      // instead of a reset connection.
+      shutdown(fd, SHUT_WR);
+      for (;;) {
+        ssize_t k = read(fd, chunk, sizeof(chunk));
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) break;
+      }
+      break;
+    }
+  }
+  close(fd);
+}
+
+// Listen on the Unix socket path and serve the connections with nthreads
+// threads.  This only returns on an error.
+int Listen(Server& server, const std::string& path, unsigned nthreads) {
+  sockaddr_un addr;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::cerr << "Socket path " << path << " is too long\n";
+    return 1;
+  }
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strcpy(addr.sun_path, path.c_str());
+  int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0) {
+    std::cerr << "Cannot create socket: " << std::strerror(errno) << "\n";
+    return 1;
+  }
+  unlink(path.c_str());
+  if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0
+      || listen(sock, 128) < 0) {
+    std::cerr << "Cannot listen on " << path << ": "
+              << std::strerror(errno) << "\n";
+    close(sock);
+    return 1;
+  }
+  // A client closing its connection early mustn't kill the server.
+  std::signal(SIGPIPE, SIG_IGN);
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<int> pending;
+  auto worker = [&]() -> void {
+    for (;;) {
+      int fd;
+      {
+        std::unique_lock<std::mutex> g(lock);
+        ready.wait(g, [&pending]() { return !pending.empty(); });
+        fd = pending.front();
+        pending.pop_front();
+      }
+      Serve(server, fd);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned k = 0; k < nthreads; ++k)
+    threads.push_back(std::thread(worker));
+  for (;;) {
+    int fd = accept(sock, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      std::cerr << "Error accepting connection: "
+                << std::strerror(errno) << "\n";
+      // The workers never exit; so leave without joining them.
+      std::_Exit(1);
+    }
+    {
+      std::lock_guard<std::mutex> g(lock);
+      pending.push_back(fd);
+    }
+    ready.notify_one();
+  }
+}
+#endif
+
+int main(int argc, const char* const argv[]) {
+  try {
+    using namespace GeographicLib;
+    Utility::set_digits();
+    real
+      a = Constants::WGS84_a(),
+      f = Constants::WGS84_f();
+    int prec = 3;
+    bool mapped = false;
+    unsigned nthreads = 0;
+    std::string socketpath, istring, ifile, ofile;
+    std::vector<std::string> preload;
+    char lsep = ';';
+
+    for (int m = 1; m < argc; ++m) {
+      std::string arg(argv[m]);
+      if (arg == "-s") {
+        if (++m == argc) return usage(1, true);
+        socketpath = argv[m];
+      } else if (arg == "-j") {
+        if (++m == argc) return usage(1, true);
+        try {
+          int n = Utility::val<int>(std::string(argv[m]));
+          if (n < 0) throw GeographicErr("negative");
+          nthreads = unsigned(n);
+        }
+        catch (const std::exception&) {
+          std::cerr << "Number of threads " << argv[m]
+                    << " is not a non-negative integer\n";
+          return 1;
+        }
+      } else if (arg == "-e") {
+        if (m + 2 >= argc) return usage(1, true);
+        try {
+          a = Utility::val<real>(std::string(argv[m + 1]));
+          f = Utility::fract<real>(std::string(argv[m + 2]));
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding arguments of -e: " << e.what() << "\n";
+          return 1;
+        }
+        m += 2;
+      } else if (arg == "-p") {
+        if (++m == argc) return usage(1, true);
+        try {
+          prec = Utility::val<int>(std::string(argv[m]));
+        }
+        catch (const std::exception&) {
+          std::cerr << "Precision " << argv[m] << " is not a number\n";
+          return 1;
+        }
+      } else if (arg == "--mapped")
+        mapped = true;
+      else if (arg == "--preload") {
+        if (++m == argc) return usage(1, true);
+        preload.push_back(argv[m]);
+      }
+      else if (arg == "--input-string") {
+        if (++m == argc) return usage(1, true);
+        istring = argv[m];
+      } else if (arg == "--input-file") {
+        if (++m == argc) return usage(1, true);
+        ifile = argv[m];
+      } else if (arg == "--output-file") {
+        if (++m == argc) return usage(1, true);
+        ofile = argv[m];
+      } else if (arg == "--line-separator") {
+        if (++m == argc) return usage(1, true);
+        if (std::string(argv[m]).size() != 1) {
+          std::cerr << "Line separator must be a single character\n";
+          return 1;
+        }
+        lsep = argv[m][0];
+      } else if (arg == "--version") {
+        std::cout << argv[0] << ": GeographicLib version "
+                  << GEOGRAPHICLIB_VERSION_STRING << "\n";
+        return 0;
+      } else
+        return usage(!(arg == "-h" || arg == "--help"), arg != "--help");
+    }
+
+    Server server(a, f, prec, mapped);
+    for (const std::string& spec : preload) {
+      std::string::size_type p = spec.find(',');
+      try {
+        server.Preload(spec.substr(0, p),
+                       p == std::string::npos ? "" : spec.substr(p + 1),
+                       int(std::max(1u, std::thread::hardware_concurrency())));
+      }
+      catch (const std::exception& e) {
+        std::cerr << "Error preloading " << spec << ": " << e.what() << "\n";
+        return 1;
+      }
+    }
+
+    if (!socketpath.empty()) {
+      if (!(ifile.empty() && istring.empty() && ofile.empty())) {
+        std::cerr << "Cannot specify -s with the input and output options\n";
+        return 1;
+      }
+#if GEOSERVER_SOCKETS
+      if (nthreads == 0)
+        nthreads = std::max(1u, std::thread::hardware_concurrency());
+      return Listen(server, socketpath, nthreads);
+#else
+      std::cerr << "The -s option is not supported on this system\n";
+      return 1;
+#endif
+    }
+
+    if (!ifile.empty() && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --input-file together\n";
+      return 1;
+    }
+    if (ifile == "-") ifile.clear();
+    std::ifstream infile;
+    std::istringstream instring;
+    if (!ifile.empty()) {
+      infile.open(ifile.c_str());
+      if (!infile.is_open()) {
+        std::cerr << "Cannot open " << ifile << " for reading\n";
+        return 1;
+      }
+    } else if (!istring.empty()) {
+      std::string::size_type m = 0;
+      while (true) {
+        m = istring.find(lsep, m);
+        if (m == std::string::npos)
+          break;
+        istring[m] = '\n';
+      }
+      instring.str(istring);
+    }
+    std::istream* input = !ifile.empty() ? &infile :
+      (!istring.empty() ? &instring : &std::cin);
+
+    std::ofstream outfile;
+    if (ofile == "-") ofile.clear();
+    if (!ofile.empty()) {
+      outfile.open(ofile.c_str());
+      if (!outfile.is_open()) {
+        std::cerr << "Cannot open " << ofile << " for writing\n";
+        return 1;
+      }
+    }
+    std::ostream* output = !ofile.empty() ? &outfile : &std::cout;
+
+    // Serve the requests on the input, flushing each response so that the
+    // tool can be driven interactively through a pipe.
+    int retval = 0;
+    std::string s;
+    while (std::getline(*input, s)) {
+      std::string r = server.Process(s);
+      if (r.compare(0, 7, "ERROR: ") == 0) retval = 1;
+      *output << r << std::endl;
+    }
+    return retval;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Caught exception: " << e.what() << "\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Caught unknown exception\n";
+    return 1;
+  }
+}
@@ -13,6 +13,8 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <thread>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicLine.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -25,6 +27,7 @@
 #endif
 
 #include "GeodSolve.usage"
+#include "ToolIO.hpp"
 
 typedef GeographicLib::Math::real real;
 
@@ -65,21 +68,216 @@ real ReadDistance(const std::string& s, bool arcmode, bool fraction = false) {
     (arcmode ? DMS::DecodeAngle(s) : Utility::val<real>(s));
 }
 
+// The settings and objects needed to solve a line (or binary record) of
+// input.  The member functions are const so that they may be called from
+// several threads at once.
+class GeodSolver {
+public:
+  enum { NONE = 0, LINE, DIRECT, INVERSE };
+  bool inverse, arcmode, dms, full, unroll, longfirst, azi2back, fraction;
+  int linecalc, prec;
+  char dmssep;
+  std::string cdelim;
+  unsigned outmask;
+  // The parameters of the geodesic line for linecalc != NONE
+  real lat1, lon1, azi1, mult;
+  GeographicLib::Geodesic geods;
+  GeographicLib::GeodesicLine ls;
+  GeodSolver(real a, real f, bool exact)
+    : inverse(false), arcmode(false), dms(false), full(false), unroll(false)
+    , longfirst(false), azi2back(false), fraction(false)
+    , linecalc(NONE), prec(3), dmssep(char(0)), outmask(0u)
+    , lat1(0), lon1(0), azi1(0), mult(1)
+    , geods(a, f, exact)
+  {}
+  // Solve one line of input, returning false if there's an error.
+  bool Text(const std::string& line, std::string& out) const;
+  // The number of values in a binary input and output record.
+  size_t NumIn() const { return inverse ? 4 : (linecalc ? 1 : 4); }
+  size_t NumOut() const { return full ? 12 : 3; }
+  // Solve one binary record.
+  void Binary(const real in[], real out[]) const;
+private:
+  static real Back(real azi2) {
+    using std::copysign;
+    // map +/-0 -> -/+180; +/-180 -> -/+0
+    // this depends on abs(azi2) <= 180
+    return copysign(azi2 + copysign(real(GeographicLib::Math::hd), -azi2),
+                    -azi2);
+  }
+};
+
+bool GeodSolver::Text(const std::string& line, std::string& out) const {
+  using namespace GeographicLib;
+  real lat1x, lon1x, azi1x, lat2, lon2, azi2, s12, m12, a12, M12, M21, S12;
+  std::string s(line), eol, slat1, slon1, slat2, slon2, sazi1, ss12, strc;
+  std::istringstream str;
+  try {
+    eol = "\n";
+    if (!cdelim.empty()) {
+      std::string::size_type m = s.find(cdelim);
+      if (m != std::string::npos) {
+        eol = " " + s.substr(m) + "\n";
+        s = s.substr(0, m);
+      }
+    }
+    str.str(s);
+    out.clear();
+    if (inverse) {
+      if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
+        throw GeographicErr("Incomplete input: " + s);
+      if (str >> strc)
+        throw GeographicErr("Extraneous input: " + strc);
+      DMS::DecodeLatLon(slat1, slon1, lat1x, lon1x, longfirst);
+      DMS::DecodeLatLon(slat2, slon2, lat2, lon2, longfirst);
+      a12 = geods.GenInverse(lat1x, lon1x, lat2, lon2, outmask,
+                             s12, azi1x, azi2, m12, M12, M21, S12);
+      if (full) {
+        if (unroll) {
+          real e;
+          lon2 = lon1x + Math::AngDiff(lon1x, lon2, e);
+          lon2 += e;
+        } else {
+          lon1x = Math::AngNormalize(lon1x);
+          lon2 = Math::AngNormalize(lon2);
+        }
+        out += LatLonString(lat1x, lon1x, prec, dms, dmssep, longfirst) + " ";
+      }
+      out += AzimuthString(azi1x, prec, dms, dmssep) + " ";
+      if (full)
+        out += LatLonString(lat2, lon2, prec, dms, dmssep, longfirst) + " ";
+      if (azi2back) azi2 = Back(azi2);
+      out += AzimuthString(azi2, prec, dms, dmssep) + " "
+        + DistanceStrings(s12, a12, full, arcmode, prec, dms);
+      if (full)
+        out += " " + Utility::str(m12, prec)
+          + " " + Utility::str(M12, prec+7)
+          + " " + Utility::str(M21, prec+7)
+          + " " + Utility::str(S12, std::max(prec-7, 0));
+      out += eol;
+    } else {
+      if (linecalc) {
+        if (!(str >> ss12))
+          throw GeographicErr("Incomplete input: " + s);
+        if (str >> strc)
+          throw GeographicErr("Extraneous input: " + strc);
+        lat1x = lat1; lon1x = lon1; azi1x = azi1;
+        // In fraction mode input is read as a distance
+        s12 = ReadDistance(ss12, !fraction && arcmode, fraction) * mult;
+        a12 = ls.GenPosition(arcmode, s12, outmask,
+                             lat2, lon2, azi2, s12, m12, M12, M21, S12);
+      } else {
+        if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
+          throw GeographicErr("Incomplete input: " + s);
+        if (str >> strc)
+          throw GeographicErr("Extraneous input: " + strc);
+        DMS::DecodeLatLon(slat1, slon1, lat1x, lon1x, longfirst);
+        azi1x = DMS::DecodeAzimuth(sazi1);
+        s12 = ReadDistance(ss12, arcmode);
+        a12 = geods.GenDirect(lat1x, lon1x, azi1x, arcmode, s12, outmask,
+                              lat2, lon2, azi2, s12, m12, M12, M21, S12);
+      }
+      if (full)
+        out += LatLonString(lat1x, unroll ? lon1x : Math::AngNormalize(lon1x),
+                            prec, dms, dmssep, longfirst)
+          + " " + AzimuthString(azi1x, prec, dms, dmssep) + " ";
+      if (azi2back) azi2 = Back(azi2);
+      out += LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
+        + " " + AzimuthString(azi2, prec, dms, dmssep);
+      if (full)
+        out += " "
+          + DistanceStrings(s12, a12, full, arcmode, prec, dms)
+          + " " + Utility::str(m12, prec)
+          + " " + Utility::str(M12, prec+7)
+          + " " + Utility::str(M21, prec+7)
+          + " " + Utility::str(S12, std::max(prec-7, 0));
+      out += eol;
+    }
+    return true;
+  }
+  catch (const std::exception& e) {
+    // Write error message to output so output lines match input lines
+    out = std::string("ERROR: ") + e.what() + "\n";
+    return false;
+  }
+}
+
+void GeodSolver::Binary(const real in[], real out[]) const {
+  using namespace GeographicLib;
+  real lat1x, lon1x, azi1x, lat2, lon2, azi2, s12, a12,
+    m12 = Math::NaN(), M12 = Math::NaN(), M21 = Math::NaN(),
+    S12 = Math::NaN();
+  // The order of latitude and longitude in the records
+  const int ilat = longfirst ? 1 : 0, ilon = 1 - ilat;
+  int k = 0;
+  if (inverse) {
+    lat1x = in[ilat]; lon1x = in[ilon];
+    lat2 = in[2 + ilat]; lon2 = in[2 + ilon];
+    a12 = geods.GenInverse(lat1x, lon1x, lat2, lon2, outmask,
+                           s12, azi1x, azi2, m12, M12, M21, S12);
+    if (full) {
+      if (unroll) {
+        real e;
+        lon2 = lon1x + Math::AngDiff(lon1x, lon2, e);
+        lon2 += e;
+      } else {
+        lon1x = Math::AngNormalize(lon1x);
+        lon2 = Math::AngNormalize(lon2);
+      }
+      out[k + ilat] = lat1x; out[k + ilon] = lon1x; k += 2;
+    }
+    out[k++] = azi1x;
+    if (full) {
+      out[k + ilat] = lat2; out[k + ilon] = lon2; k += 2;
+    }
+    out[k++] = azi2back ? Back(azi2) : azi2;
+    if (full || !arcmode) out[k++] = s12;
+    if (full || arcmode) out[k++] = a12;
+  } else {
+    if (linecalc) {
+      lat1x = lat1; lon1x = lon1; azi1x = azi1;
+      s12 = in[0] * mult;
+      a12 = ls.GenPosition(arcmode, s12, outmask,
+                           lat2, lon2, azi2, s12, m12, M12, M21, S12);
+    } else {
+      lat1x = in[ilat]; lon1x = in[ilon]; azi1x = in[2]; s12 = in[3];
+      a12 = geods.GenDirect(lat1x, lon1x, azi1x, arcmode, s12, outmask,
+                            lat2, lon2, azi2, s12, m12, M12, M21, S12);
+    }
+    if (full) {
+      out[k + ilat] = lat1x;
+      out[k + ilon] = unroll ? lon1x : Math::AngNormalize(lon1x);
+      out[k + 2] = azi1x; k += 3;
+    }
+    out[k + ilat] = lat2; out[k + ilon] = lon2;
+    out[k + 2] = azi2back ? Back(azi2) : azi2; k += 3;
+    if (full) {
+      out[k++] = s12; out[k++] = a12;
+    }
+  }
+  if (full) {
+    out[k++] = m12; out[k++] = M12; out[k++] = M21; out[k++] = S12;
+  }
+}
+
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
-    enum { NONE = 0, LINE, DIRECT, INVERSE };
+    enum { NONE = GeodSolver::NONE, LINE = GeodSolver::LINE,
+           DIRECT = GeodSolver::DIRECT, INVERSE = GeodSolver::INVERSE };
     Utility::set_digits();
+    ToolStats stats;
     bool inverse = false, arcmode = false,
       dms = false, full = false, exact = false, unroll = false,
       longfirst = false, azi2back = false, fraction = false,
-      arcmodeline = false;
+      arcmodeline = false, binary = false;
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
-    real lat1, lon1, azi1, lat2, lon2, azi2, s12, m12, a12, M12, M21, S12,
+    real lat1 = 0, lon1 = 0, azi1 = 0, lat2 = 0, lon2 = 0, s12 = 0,
       mult = 1;
     int linecalc = NONE, prec = 3;
+    unsigned nthreads = 1;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';', dmssep = char(0);
 
@@ -173,6 +371,13 @@ int main(int argc, const char* const argv[]) {
         }
       } else if (arg == "-E")
         exact = true;
+      else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--stats")
+        stats.Enable();
       else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
@@ -204,11 +409,16 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::in | std::ios::binary :
+                  std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -226,10 +436,11 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -248,126 +459,70 @@ int main(int argc, const char* const argv[]) {
                        Geodesic::GEODESICSCALE | Geodesic::AREA) :
       Geodesic::NONE;
 
-    const Geodesic geods(a, f, exact);
-    GeodesicLine ls;
+    GeodSolver solver(a, f, exact);
+    const Geodesic& geods = solver.geods;
     if (linecalc) {
       if (linecalc == LINE) fraction = false;
-      ls = linecalc == DIRECT ?
+      solver.ls = linecalc == DIRECT ?
         geods.GenDirectLine(lat1, lon1, azi1, arcmodeline, s12, outmask) :
         linecalc == INVERSE ?
         geods.InverseLine(lat1, lon1, lat2, lon2, outmask) :
         // linecalc == LINE
         geods.Line(lat1, lon1, azi1, outmask);
-      mult = fraction ? ls.GenDistance(arcmode) : 1;
-      if (linecalc == INVERSE) azi1 = ls.Azimuth();
+      mult = fraction ? solver.ls.GenDistance(arcmode) : 1;
+      if (linecalc == INVERSE) azi1 = solver.ls.Azimuth();
     }
 
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, slat1, slon1, slat2, slon2, sazi1, ss12, strc;
-    std::istringstream str;
+    solver.inverse = inverse; solver.arcmode = arcmode; solver.dms = dms;
+    solver.full = full; solver.unroll = unroll; solver.longfirst = longfirst;
+    solver.azi2back = azi2back; solver.fraction = fraction;
+    solver.linecalc = linecalc; solver.prec = prec; solver.dmssep = dmssep;
+    solver.cdelim = cdelim; solver.outmask = outmask;
+    solver.lat1 = lat1; solver.lon1 = lon1; solver.azi1 = azi1;
+    solver.mult = mult;
+
+    stats.Stage("setup");
     int retval = 0;
-    while (std::getline(*input, s)) {
-      try {
-        eol = "\n";
-        if (!cdelim.empty()) {
-          std::string::size_type m = s.find(cdelim);
-          if (m != std::string::npos) {
-            eol = " " + s.substr(m) + "\n";
-            s = s.substr(0, m);
-          }
-        }
-        str.clear(); str.str(s);
-        if (inverse) {
-          if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
-            throw GeographicErr("Incomplete input: " + s);
-          if (str >> strc)
-            throw GeographicErr("Extraneous input: " + strc);
-          DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
-          DMS::DecodeLatLon(slat2, slon2, lat2, lon2, longfirst);
-          a12 = geods.GenInverse(lat1, lon1, lat2, lon2, outmask,
-                                 s12, azi1, azi2, m12, M12, M21, S12);
-          if (full) {
-            if (unroll) {
-              real e;
-              lon2 = lon1 + Math::AngDiff(lon1, lon2, e);
-              lon2 += e;
-            } else {
-              lon1 = Math::AngNormalize(lon1);
-              lon2 = Math::AngNormalize(lon2);
-            }
-            *output << LatLonString(lat1, lon1, prec, dms, dmssep, longfirst)
-                    << " ";
-          }
-          *output << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          if (full)
-            *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                    << " ";
-          if (azi2back) {
-            using std::copysign;
-            // map +/-0 -> -/+180; +/-180 -> -/+0
-            // this depends on abs(azi2) <= 180
-            azi2 = copysign(azi2 + copysign(real(Math::hd), -azi2), -azi2);
-          }
-          *output << AzimuthString(azi2, prec, dms, dmssep) << " "
-                  << DistanceStrings(s12, a12, full, arcmode, prec, dms);
-          if (full)
-            *output << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
-        } else {
-          if (linecalc) {
-            if (!(str >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            // In fraction mode input is read as a distance
-            s12 = ReadDistance(ss12, !fraction && arcmode, fraction) * mult;
-            a12 = ls.GenPosition(arcmode, s12, outmask,
-                                 lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          } else {
-            if (!(str >> slat1 >> slon1 >> sazi1 >> ss12))
-              throw GeographicErr("Incomplete input: " + s);
-            if (str >> strc)
-              throw GeographicErr("Extraneous input: " + strc);
-            DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
-            azi1 = DMS::DecodeAzimuth(sazi1);
-            s12 = ReadDistance(ss12, arcmode);
-            a12 = geods.GenDirect(lat1, lon1, azi1, arcmode, s12, outmask,
-                                  lat2, lon2, azi2, s12, m12, M12, M21, S12);
-          }
-          if (full)
-            *output
-              << LatLonString(lat1, unroll ? lon1 : Math::AngNormalize(lon1),
-                              prec, dms, dmssep, longfirst)
-              << " " << AzimuthString(azi1, prec, dms, dmssep) << " ";
-          if (azi2back) {
-            using std::copysign;
-            // map +/-0 -> -/+180; +/-180 -> -/+0
-            // this depends on abs(azi2) <= 180
-            azi2 = copysign(azi2 + copysign(real(Math::hd), -azi2), -azi2);
-          }
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << AzimuthString(azi2, prec, dms, dmssep);
-          if (full)
-            *output << " "
-                    << DistanceStrings(s12, a12, full, arcmode, prec, dms)
-                    << " " << Utility::str(m12, prec)
-                    << " " << Utility::str(M12, prec+7)
-                    << " " << Utility::str(M21, prec+7)
-                    << " " << Utility::str(S12, std::max(prec-7, 0));
-          *output << eol;
+    if (binary) {
+      // Process this many records at a time
+      const size_t chunk = 4096 * nthreads,
+        nin = solver.NumIn(), nout = solver.NumOut();
+      std::vector<double> buf(chunk * nin);
+      std::vector<real> in(chunk * nin), out(chunk * nout);
+      while (*input) {
+        input->read(reinterpret_cast<char*>(buf.data()),
+                    buf.size() * sizeof(double));
+        size_t nread = size_t(input->gcount()) / sizeof(double),
+          n = nread / nin;
+        if (nread % nin || input->gcount() % sizeof(double)) {
+          std::cerr << "Incomplete record at end of input\n";
+          retval = 1;
         }
+        for (size_t i = 0; i < n * nin; ++i)
+          // input is little-endian
+          in[i] = real(Math::bigendian ? Math::swab<double>(buf[i]) : buf[i]);
+        auto t = ToolStats::Now();
+        ParallelFor(n, nthreads, [&](size_t i0, size_t i1) {
+          for (size_t i = i0; i < i1; ++i)
+            solver.Binary(&in[i * nin], &out[i * nout]);
+        });
+        stats.Time("convert", t);
+        Utility::writearray<double, real, false>(*output, out.data(),
+                                                 n * nout);
+        stats.Rows(n);
       }
-      catch (const std::exception& e) {
-        // Write error message cout so output lines match input lines
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
-      }
+    } else {
+      retval = ProcessLines(*input, *output, nthreads,
+                            [&solver](const std::string& line,
+                                      std::string& out) -> bool {
+                              return solver.Text(line, out);
+                            }, &stats);
     }
+    stats.Stage("process");
+    stats.Report(std::cerr, "GeodSolve");
     return retval;
   }
   catch (const std::exception& e) {
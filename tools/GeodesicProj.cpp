@@ -27,6 +27,7 @@
 #endif
 
 #include "GeodesicProj.usage"
+#include "ToolIO.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
@@ -40,6 +41,8 @@ int main(int argc, const char* const argv[]) {
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     int prec = 6;
+    unsigned nthreads = 1;
+    bool binary = false;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
 
@@ -104,7 +107,12 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-      } else if (arg == "--version") {
+      } else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
@@ -116,11 +124,16 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::in | std::ios::binary :
+                  std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -138,10 +151,11 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -161,16 +175,46 @@ int main(int argc, const char* const argv[]) {
     const AzimuthalEquidistant az(geod);
     const Gnomonic gn(geod);
 
+    if (binary) {
+      // Convert columns of coordinates with the vectorized projections
+      return ProcessRecords(*input, *output, 2, 4, nthreads,
+                            [&](size_t n, const real* in[], real* out[]) {
+                              int ilat = longfirst ? 1 : 0;
+                              if (reverse) {
+                                real *lat = out[ilat], *lon = out[1 - ilat];
+                                if (cassini)
+                                  cs.Reverse(n, in[0], in[1], lat, lon,
+                                             out[2], out[3]);
+                                else if (azimuthal)
+                                  az.Reverse(lat0, lon0, n, in[0], in[1],
+                                             lat, lon, out[2], out[3]);
+                                else
+                                  gn.Reverse(lat0, lon0, n, in[0], in[1],
+                                             lat, lon, out[2], out[3]);
+                              } else {
+                                const real
+                                  *lat = in[ilat], *lon = in[1 - ilat];
+                                if (cassini)
+                                  cs.Forward(n, lat, lon, out[0], out[1],
+                                             out[2], out[3]);
+                                else if (azimuthal)
+                                  az.Forward(lat0, lon0, n, lat, lon,
+                                             out[0], out[1], out[2], out[3]);
+                                else
+                                  gn.Forward(lat0, lon0, n, lat, lon,
+                                             out[0], out[1], out[2], out[3]);
+                              }
+                            });
+    }
+
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, stra, strb, strc;
-    std::istringstream str;
-    int retval = 0;
-    std::cout << std::fixed;
-    while (std::getline(*input, s)) {
+    // Process one line; this is called concurrently if nthreads > 1.
+    auto convert = [&](const std::string& line, std::string& out) -> bool {
+      std::string s(line), eol("\n"), stra, strb, strc;
+      std::istringstream str;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -178,7 +222,7 @@ int main(int argc, const char* const argv[]) {
             s = s.substr(0, m);
           }
         }
-        str.clear(); str.str(s);
+        str.str(s);
         real lat, lon, x, y, azi, rk;
         if (!(str >> stra >> strb))
           throw GeographicErr("Incomplete input: " + s);
@@ -196,10 +240,10 @@ int main(int argc, const char* const argv[]) {
             az.Reverse(lat0, lon0, x, y, lat, lon, azi, rk);
           else
             gn.Reverse(lat0, lon0, x, y, lat, lon, azi, rk);
-          *output << Utility::str(longfirst ? lon : lat, prec + 5) << " "
-                  << Utility::str(longfirst ? lat : lon, prec + 5) << " "
-                  << Utility::str(azi, prec + 5) << " "
-                  << Utility::str(rk, prec + 6) << eol;
+          out = Utility::str(longfirst ? lon : lat, prec + 5) + " "
+            + Utility::str(longfirst ? lat : lon, prec + 5) + " "
+            + Utility::str(azi, prec + 5) + " "
+            + Utility::str(rk, prec + 6) + eol;
         } else {
           if (cassini)
             cs.Forward(lat, lon, x, y, azi, rk);
@@ -207,18 +251,20 @@ int main(int argc, const char* const argv[]) {
             az.Forward(lat0, lon0, lat, lon, x, y, azi, rk);
           else
             gn.Forward(lat0, lon0, lat, lon, x, y, azi, rk);
-          *output << Utility::str(x, prec) << " "
-                  << Utility::str(y, prec) << " "
-                  << Utility::str(azi, prec + 5) << " "
-                  << Utility::str(rk, prec + 6) << eol;
+          out = Utility::str(x, prec) + " "
+            + Utility::str(y, prec) + " "
+            + Utility::str(azi, prec + 5) + " "
+            + Utility::str(rk, prec + 6) + eol;
         }
+        return true;
       }
       catch (const std::exception& e) {
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        out = std::string("ERROR: ") + e.what() + "\n";
+        return false;
       }
-    }
-    return retval;
+    };
+    std::cout << std::fixed;
+    return ProcessLines(*input, *output, nthreads, convert);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
@@ -13,6 +13,7 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
 #include <GeographicLib/Geoid.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -25,12 +26,92 @@
 #endif
 
 #include "GeoidEval.usage"
+#include "ToolIO.hpp"
+
+typedef GeographicLib::Math::real real;
+
+// The settings needed to parse a line of input.
+class GeoidParser {
+public:
+  std::string cdelim;
+  int zonenum;
+  bool northp, longfirst;
+  GeographicLib::Geoid::convertflag heightmult;
+  GeoidParser()
+    : zonenum(GeographicLib::UTMUPS::INVALID), northp(false)
+    , longfirst(false), heightmult(GeographicLib::Geoid::NONE)
+  {}
+  // Parse the line s for the position and, if heightmult != NONE, the
+  // height.  On return s is the text to precede the converted height on the
+  // output line, suff is the text to follow it, and eol ends the line.
+  void Parse(std::string& s, std::string& suff, std::string& eol,
+             real& lat, real& lon, real& height) const;
+};
+
+void GeoidParser::Parse(std::string& s, std::string& suff, std::string& eol,
+                        real& lat, real& lon, real& height) const {
+  using namespace GeographicLib;
+  const char* spaces = " \t\n\v\f\r,"; // Include comma as space
+  GeoCoords p;
+  eol = "\n";
+  suff.clear();
+  if (!cdelim.empty()) {
+    std::string::size_type m = s.find(cdelim);
+    if (m != std::string::npos) {
+      eol = " " + s.substr(m) + "\n";
+      std::string::size_type m1 =
+        m > 0 ? s.find_last_not_of(spaces, m - 1) : std::string::npos;
+      s = s.substr(0, m1 != std::string::npos ? m1 + 1 : m);
+    }
+  }
+  height = 0;
+  if (zonenum != UTMUPS::INVALID) {
+    // Expect "easting northing" if heightmult == 0, or
+    // "easting northing height" if heightmult != 0.
+    std::string::size_type pa = 0, pb = 0;
+    real easting = 0, northing = 0;
+    for (int i = 0; i < (heightmult ? 3 : 2); ++i) {
+      if (pb == std::string::npos)
+        throw GeographicErr("Incomplete input: " + s);
+      // Start of i'th token
+      pa = s.find_first_not_of(spaces, pb);
+      if (pa == std::string::npos)
+        throw GeographicErr("Incomplete input: " + s);
+      // End of i'th token
+      pb = s.find_first_of(spaces, pa);
+      (i == 2 ? height : (i == 0 ? easting : northing)) =
+        Utility::val<real>(s.substr(pa, (pb == std::string::npos ?
+                                         pb : pb - pa)));
+    }
+    p.Reset(zonenum, northp, easting, northing);
+    if (heightmult) {
+      suff = pb == std::string::npos ? "" : s.substr(pb);
+      s = s.substr(0, pa);
+    }
+  } else {
+    if (heightmult) {
+      // Treat last token as height
+      // pb = last char of last token
+      // pa = last char preceding white space
+      // px = last char of 2nd last token
+      std::string::size_type pb = s.find_last_not_of(spaces);
+      std::string::size_type pa = s.find_last_of(spaces, pb);
+      if (pa == std::string::npos || pb == std::string::npos)
+        throw GeographicErr("Incomplete input: " + s);
+      height = Utility::val<real>(s.substr(pa + 1, pb - pa));
+      s = s.substr(0, pa + 1);
+    }
+    p.Reset(s, true, longfirst);
+  }
+  lat = p.Latitude();
+  lon = p.Longitude();
+}
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
+    ToolStats stats;
     bool cacheall = false, cachearea = false, verbose = false, cubic = true;
     real caches, cachew, cachen, cachee;
     std::string dir;
@@ -38,7 +119,8 @@ int main(int argc, const char* const argv[]) {
     Geoid::convertflag heightmult = Geoid::NONE;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
-    bool northp = false, longfirst = false;
+    bool northp = false, longfirst = false, batch = false, binary = false,
+      mapped = false, coeffs = false;
     int zonenum = UTMUPS::INVALID;
 
     for (int m = 1; m < argc; ++m) {
@@ -111,7 +193,17 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-      } else if (arg == "--version") {
+      } else if (arg == "--batch")
+        batch = true;
+      else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--mapped")
+        mapped = true;
+      else if (arg == "--coeffs")
+        coeffs = true;
+      else if (arg == "--stats")
+        stats.Enable();
+      else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
@@ -130,11 +222,16 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::in | std::ios::binary :
+                  std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -152,10 +249,11 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -165,9 +263,14 @@ int main(int argc, const char* const argv[]) {
 
     int retval = 0;
     try {
-      const Geoid g(geoid, dir, cubic);
+      const Geoid g(geoid, dir, cubic, false, mapped);
       try {
-        if (cacheall)
+        if (coeffs) {
+          if (cacheall)
+            g.CacheCoeffs(-Math::qd, 0, Math::qd, Math::td, true);
+          else if (cachearea)
+            g.CacheCoeffs(caches, cachew, cachen, cachee, true);
+        } else if (cacheall)
           g.CacheAll();
         else if (cachearea)
           g.CacheArea(caches, cachew, cachen, cachee);
@@ -190,77 +293,127 @@ int main(int argc, const char* const argv[]) {
             << "\n SW Corner: " << g.CacheSouth() << " " << g.CacheWest()
             << "\n NE Corner: " << g.CacheNorth() << " " << g.CacheEast()
             << "\n";
+        if (g.CoeffCache())
+          std::cerr << "Caching the interpolation coefficients\n";
       }
 
-      GeoCoords p;
-      std::string s, eol, suff;
-      const char* spaces = " \t\n\v\f\r,"; // Include comma as space
-      while (std::getline(*input, s)) {
-        try {
-          eol = "\n";
-          if (!cdelim.empty()) {
-            std::string::size_type m = s.find(cdelim);
-            if (m != std::string::npos) {
-              eol = " " + s.substr(m) + "\n";
-              std::string::size_type m1 =
-                m > 0 ? s.find_last_not_of(spaces, m - 1) : std::string::npos;
-              s = s.substr(0, m1 != std::string::npos ? m1 + 1 : m);
-            }
+      stats.Stage("load");
+      GeoidParser parser;
+      parser.cdelim = cdelim; parser.zonenum = zonenum;
+      parser.northp = northp; parser.longfirst = longfirst;
+      parser.heightmult = heightmult;
+      // The number of points to evaluate with each call to Geoid::Heights
+      const size_t chunk = 65536;
+      if (binary) {
+        // Each record is (lat, lon) or (easting, northing), followed by the
+        // height if heightmult != NONE.
+        const size_t nin = heightmult ? 3 : 2, nout = heightmult ? 3 : 1;
+        std::vector<double> buf(chunk * nin);
+        std::vector<real> lat(chunk), lon(chunk), h(chunk),
+          out(chunk * nout);
+        while (*input) {
+          input->read(reinterpret_cast<char*>(buf.data()),
+                      buf.size() * sizeof(double));
+          size_t nread = size_t(input->gcount()) / sizeof(double),
+            n = nread / nin;
+          if (nread % nin || input->gcount() % sizeof(double)) {
+            std::cerr << "Incomplete record at end of input\n";
+            retval = 1;
           }
-          real height = 0;
-          if (zonenum != UTMUPS::INVALID) {
-            // Expect "easting northing" if heightmult == 0, or
-            // "easting northing height" if heightmult != 0.
-            std::string::size_type pa = 0, pb = 0;
-            real easting = 0, northing = 0;
-            for (int i = 0; i < (heightmult ? 3 : 2); ++i) {
-              if (pb == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              // Start of i'th token
-              pa = s.find_first_not_of(spaces, pb);
-              if (pa == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              // End of i'th token
-              pb = s.find_first_of(spaces, pa);
-              (i == 2 ? height : (i == 0 ? easting : northing)) =
-                Utility::val<real>(s.substr(pa, (pb == std::string::npos ?
-                                                 pb : pb - pa)));
+          for (size_t i = 0; i < n; ++i) {
+            real x[3];
+            for (size_t j = 0; j < nin; ++j)
+              // input is little-endian
+              x[j] = real(Math::bigendian ?
+                          Math::swab<double>(buf[i * nin + j]) :
+                          buf[i * nin + j]);
+            if (zonenum != UTMUPS::INVALID) {
+              try {
+                real gamma, k;
+                UTMUPS::Reverse(zonenum, northp, x[0], x[1],
+                                lat[i], lon[i], gamma, k);
+              }
+              catch (const std::exception&) {
+                lat[i] = lon[i] = Math::NaN();
+              }
+            } else {
+              lat[i] = longfirst ? x[1] : x[0];
+              lon[i] = longfirst ? x[0] : x[1];
             }
-            p.Reset(zonenum, northp, easting, northing);
             if (heightmult) {
-              suff = pb == std::string::npos ? "" : s.substr(pb);
-              s = s.substr(0, pa);
+              out[i * nout] = x[0]; out[i * nout + 1] = x[1];
+              out[i * nout + 2] = x[2];
             }
-          } else {
-            if (heightmult) {
-              // Treat last token as height
-              // pb = last char of last token
-              // pa = last char preceding white space
-              // px = last char of 2nd last token
-              std::string::size_type pb = s.find_last_not_of(spaces);
-              std::string::size_type pa = s.find_last_of(spaces, pb);
-              if (pa == std::string::npos || pb == std::string::npos)
-                throw GeographicErr("Incomplete input: " + s);
-              height = Utility::val<real>(s.substr(pa + 1, pb - pa));
-              s = s.substr(0, pa + 1);
+          }
+          g.Heights(n, lat.data(), lon.data(), h.data());
+          for (size_t i = 0; i < n; ++i)
+            if (heightmult)
+              out[i * nout + 2] += real(heightmult) * h[i];
+            else
+              out[i] = h[i];
+          Utility::writearray<double, real, false>(*output, out.data(),
+                                                   n * nout);
+          stats.Rows(n);
+        }
+      } else if (batch) {
+        // Parse a chunk of lines, compute the geoid heights with a single
+        // call to Geoid::Heights, then write out the results in order.
+        std::vector<std::string> lines(chunk), suffs(chunk), eols(chunk);
+        std::vector<real> lat(chunk), lon(chunk), height(chunk), h(chunk);
+        std::vector<char> oks(chunk);
+        size_t n;
+        do {
+          for (n = 0; n < chunk && std::getline(*input, lines[n]); ++n) {
+            try {
+              parser.Parse(lines[n], suffs[n], eols[n],
+                           lat[n], lon[n], height[n]);
+              oks[n] = true;
+            }
+            catch (const std::exception& e) {
+              lines[n] = std::string("ERROR: ") + e.what();
+              lat[n] = lon[n] = Math::NaN();
+              oks[n] = false;
             }
-            p.Reset(s, true, longfirst);
           }
-          if (heightmult) {
-            real h = g(p.Latitude(), p.Longitude());
-            *output << s
-                    << Utility::str(height + real(heightmult) * h, 4)
-                    << suff << eol;
-          } else {
-            real h = g(p.Latitude(), p.Longitude());
-            *output << Utility::str(h, 4) << eol;
+          g.Heights(n, lat.data(), lon.data(), h.data());
+          for (size_t i = 0; i < n; ++i) {
+            if (!oks[i]) {
+              *output << lines[i] << "\n";
+              retval = 1;
+            } else if (heightmult)
+              *output << lines[i]
+                      << Utility::str(height[i] + real(heightmult) * h[i], 4)
+                      << suffs[i] << eols[i];
+            else
+              *output << Utility::str(h[i], 4) << eols[i];
           }
-        }
-        catch (const std::exception& e) {
-          *output << "ERROR: " << e.what() << "\n";
-          retval = 1;
+          stats.Rows(n);
+        } while (n == chunk);
+      } else {
+        std::string s, eol, suff;
+        real lat, lon, height;
+        while (std::getline(*input, s)) {
+          try {
+            parser.Parse(s, suff, eol, lat, lon, height);
+            real h = g(lat, lon);
+            if (heightmult)
+              *output << s
+                      << Utility::str(height + real(heightmult) * h, 4)
+                      << suff << eol;
+            else
+              *output << Utility::str(h, 4) << eol;
+          }
+          catch (const std::exception& e) {
+            *output << "ERROR: " << e.what() << "\n";
+            retval = 1;
+          }
+          stats.Rows();
         }
       }
+      stats.Stage("process");
+      stats.Count("block cache hits", g.BlockCacheHits());
+      stats.Count("block cache misses", g.BlockCacheMisses());
+      stats.Report(std::cerr, "GeoidEval");
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << geoid << ": " << e.what() << "\n";
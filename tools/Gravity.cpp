@@ -13,6 +13,10 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
 #include <GeographicLib/GravityModel.hpp>
 #include <GeographicLib/GravityCircle.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -25,19 +29,53 @@
 #endif
 
 #include "Gravity.usage"
+#include "ToolIO.hpp"
+
+typedef GeographicLib::Math::real real;
+
+// Decode the start, end, and spacing of a grid axis; return the number of
+// points.
+size_t DecodeAxis(const std::string& sx0, const std::string& sx1,
+                  const std::string& sdx, bool latp, real& x0, real& dx) {
+  using namespace GeographicLib;
+  using std::fabs; using std::floor;
+  DMS::flag ind0, ind1;
+  x0 = DMS::Decode(sx0, ind0);
+  real x1 = DMS::Decode(sx1, ind1);
+  if (ind0 == (latp ? DMS::LONGITUDE : DMS::LATITUDE) ||
+      ind1 == (latp ? DMS::LONGITUDE : DMS::LATITUDE))
+    throw GeographicErr(std::string("Bad hemisphere letter on ") +
+                        (latp ? "latitude" : "longitude"));
+  if (latp && !(fabs(x0) <= Math::qd && fabs(x1) <= Math::qd))
+    throw GeographicErr("Latitude not in [-" + std::to_string(Math::qd)
+                        + "d, " + std::to_string(Math::qd) + "d]");
+  dx = DMS::DecodeAngle(sdx);
+  if (!(dx > 0))
+    throw GeographicErr("Grid spacing " + sdx + " is not positive");
+  if (x1 < x0) dx = -dx;
+  // Allow for roundoff in the number of intervals
+  real n = floor((x1 - x0) / dx + real(1e-6)) + 1;
+  if (!(n >= 1 && n <= real(1e8)))
+    throw GeographicErr("Bad number of grid points");
+  return size_t(n);
+}
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
+    ToolStats stats;
     bool verbose = false, longfirst = false;
     std::string dir;
     std::string model = GravityModel::DefaultGravityName();
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
     real lat = 0, h = 0;
-    bool circle = false;
+    bool circle = false, grid = false, binary = false, mapped = false;
+    int pgm = 0;
+    real lat0 = 0, dlat = 0, lon0 = 0, dlon = 0;
+    size_t nlat = 0, nlon = 0;
+    unsigned nthreads = 1;
     int prec = -1, Nmax = -1, Mmax = -1;
     enum {
       GRAVITY = 0,
@@ -101,13 +139,52 @@ int main(int argc, const char* const argv[]) {
                                 + "d, " + std::to_string(Math::qd) + "d]");
           h = Utility::val<real>(std::string(argv[++m]));
           circle = true;
+          grid = false;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of " << arg << ": "
+                    << e.what() << "\n";
+          return 1;
+        }
+      } else if (arg == "--grid") {
+        if (m + 7 >= argc) return usage(1, true);
+        try {
+          nlat = DecodeAxis(std::string(argv[m + 1]), std::string(argv[m + 2]),
+                            std::string(argv[m + 3]), true, lat0, dlat);
+          nlon = DecodeAxis(std::string(argv[m + 4]), std::string(argv[m + 5]),
+                            std::string(argv[m + 6]), false, lon0, dlon);
+          h = Utility::val<real>(std::string(argv[m + 7]));
+          grid = true;
+          circle = false;
         }
         catch (const std::exception& e) {
           std::cerr << "Error decoding argument of " << arg << ": "
                     << e.what() << "\n";
           return 1;
         }
-      } else if (arg == "-w")
+        m += 7;
+      } else if (arg == "--geoid-pgm") {
+        if (++m == argc) return usage(1, true);
+        try {
+          pgm = Utility::val<int>(std::string(argv[m]));
+          if (pgm <= 0)
+            throw GeographicErr("is not positive");
+        }
+        catch (const std::exception&) {
+          std::cerr << "Grid intervals per degree " << argv[m]
+                    << " is not a positive number\n";
+          return 1;
+        }
+      } else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--stats")
+        stats.Enable();
+      else if (arg == "--mapped")
+        mapped = true;
+      else if (arg == "-w")
         longfirst = !longfirst;
       else if (arg == "-p") {
         if (++m == argc) return usage(1, true);
@@ -160,7 +237,7 @@ int main(int argc, const char* const argv[]) {
       return 1;
     }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
       infile.open(ifile.c_str());
@@ -181,10 +258,15 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    if (binary && !grid) {
+      std::cerr << "--binary requires --grid\n";
+      return 1;
+    }
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary || pgm ?
+                   std::ios::out | std::ios::binary : std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -208,8 +290,15 @@ int main(int argc, const char* const argv[]) {
     int retval = 0;
     try {
       using std::isfinite;
-      const GravityModel g(model, dir, Nmax, Mmax);
-      if (circle) {
+      GravityModel g(model, dir, Nmax, Mmax, false, mapped);
+      stats.Stage("load");
+      auto report = [&stats, &g]() {
+        stats.Stage("process");
+        stats.Count("circle cache hits", g.CircleCacheHits());
+        stats.Count("circle cache misses", g.CircleCacheMisses());
+        stats.Report(std::cerr, "Gravity");
+      };
+      if (circle || grid) {
         if (!isfinite(h))
           throw GeographicErr("Bad height");
         else if (mode == UNDULATION && h != 0)
@@ -221,10 +310,72 @@ int main(int argc, const char* const argv[]) {
                   << "Description: "  << g.Description()      << "\n"
                   << "Date & Time: "  << g.DateTime()         << "\n";
       }
+      if (pgm) {
+        // The rows are divided among the threads by GravityModel::Grid
+        g.SetThreads(int(nthreads));
+        g.GeoidPGM(*output, pgm);
+        report();
+        return retval;
+      }
       unsigned mask = (mode == GRAVITY ? GravityModel::GRAVITY :
                        (mode == DISTURBANCE ? GravityModel::DISTURBANCE :
                         (mode == ANOMALY ? GravityModel::SPHERICAL_ANOMALY :
                          GravityModel::GEOID_HEIGHT))); // mode == UNDULATION
+      if (grid) {
+        // Evaluate blocks of rows, one GravityCircle per row, with the rows
+        // of a block divided among the threads; write out each block in
+        // order.  The values are converted to the units of the text output.
+        const size_t ncomp = mode == UNDULATION ? 1 : 3,
+          block = std::min(nlat, size_t(4) * nthreads);
+        // mGals for accelerations and arcsecs for angles
+        const real
+          ascale = real(mode == DISTURBANCE || mode == ANOMALY ? 100000 : 1),
+          dscale = mode == ANOMALY ? real(Math::ds) : ascale,
+          scale[3] = {ascale, dscale, dscale};
+        std::vector<real> out(block * nlon * ncomp);
+        std::vector<std::string> text(binary ? 0 : block);
+        std::vector<std::exception_ptr> err(block);
+        for (size_t i0 = 0; i0 < nlat; i0 += block) {
+          size_t nb = std::min(block, nlat - i0);
+          ParallelFor(nb, nthreads, [&](size_t k0, size_t k1) {
+            std::vector<real> v(ncomp * nlon);
+            for (size_t k = k0; k < k1; ++k) {
+              try {
+                const GravityCircle
+                  c(g.Circle(lat0 + real(i0 + k) * dlat, h, mask));
+                c.Grid(mask, lon0, dlon, nlon, v.data(),
+                       ncomp > 1 ? v.data() + nlon : nullptr,
+                       ncomp > 1 ? v.data() + 2 * nlon : nullptr);
+                real* row = out.data() + k * nlon * ncomp;
+                for (size_t j = 0; j < nlon; ++j)
+                  for (size_t l = 0; l < ncomp; ++l)
+                    row[j * ncomp + l] = scale[l] * v[l * nlon + j];
+                if (!binary) {
+                  text[k].clear();
+                  for (size_t j = 0; j < nlon; ++j)
+                    for (size_t l = 0; l < ncomp; ++l)
+                      text[k] += Utility::str(row[j * ncomp + l], prec) +
+                        (l + 1 < ncomp ? " " : "\n");
+                }
+              }
+              catch (...) {
+                err[k] = std::current_exception();
+              }
+            }
+          });
+          for (size_t k = 0; k < nb; ++k)
+            if (err[k]) std::rethrow_exception(err[k]);
+          if (binary)
+            Utility::writearray<double, real, false>
+              (*output, out.data(), nb * nlon * ncomp);
+          else
+            for (size_t k = 0; k < nb; ++k)
+              *output << text[k];
+          stats.Rows(nb * nlon);
+        }
+        report();
+        return retval;
+      }
       const GravityCircle c(circle ? g.Circle(lat, h, mask) : GravityCircle());
       std::string s, eol, stra, strb;
       std::istringstream str;
@@ -316,7 +467,9 @@ int main(int argc, const char* const argv[]) {
           *output << "ERROR: " << e.what() << "\n";
           retval = 1;
         }
+        stats.Rows();
       }
+      report();
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << model << ": " << e.what() << "\n";
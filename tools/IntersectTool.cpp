@@ -14,25 +14,29 @@
 #include <sstream>
 #include <fstream>
 #include <vector>
+#include <thread>
+#include <algorithm>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
 #include <GeographicLib/Intersect.hpp>
 
 #include "IntersectTool.usage"
+#include "ToolIO.hpp"
 using namespace GeographicLib;
 typedef Math::real real;
 
 int main(int argc, const char* const argv[]) {
   try {
-    enum { CLOSE = 0, OFFSET, NEXT, SEGMENT };
+    enum { CLOSE = 0, OFFSET, NEXT, SEGMENT, ALL };
     Utility::set_digits();
+    ToolStats stats;
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f(),
       maxdist = -1;
     bool exact = false, check = false, longfirst = false;
-    int prec = 3, mode = CLOSE;
+    int prec = 3, mode = CLOSE, nthreads = 1;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
 
@@ -81,6 +85,22 @@ int main(int argc, const char* const argv[]) {
         mode = NEXT;
       else if (arg == "-i")
         mode = SEGMENT;
+      else if (arg == "-a")
+        mode = ALL;
+      else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::val<int>(std::string(argv[m]));
+          if (nthreads < 0)
+            throw GeographicErr("negative");
+        }
+        catch (const std::exception&) {
+          std::cerr << "Number of threads " << argv[m]
+                    << " is not a non-negative number\n";
+          return 1;
+        }
+      } else if (arg == "--stats")
+        stats.Enable();
       else if (arg == "-C")
         check = true;
       else if (arg == "-w")
@@ -116,8 +136,14 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (mode == ALL && maxdist >= 0) {
+      std::cerr << "Cannot specify -a and -R together\n";
+      return 1;
+    }
+    if (nthreads == 0)
+      nthreads = std::max(1, int(std::thread::hardware_concurrency()));
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
       infile.open(ifile.c_str());
@@ -138,7 +164,7 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
       outfile.open(ofile.c_str());
@@ -151,6 +177,81 @@ int main(int argc, const char* const argv[]) {
 
     Geodesic geod(a, f, exact);
     Intersect intersect(geod);
+    stats.Stage("setup");
+    if (mode == ALL) {
+      // Read the whole set of segments, find all the crossings with
+      // Intersect::Segments, and print i j x y c for each one.
+      std::vector<GeodesicLine> lines;
+      std::vector<std::string> eols;
+      std::string s, inp[4], sc;
+      std::istringstream str;
+      real lat1, lon1, lat2, lon2;
+      unsigned long nline = 0;
+      while (std::getline(*input, s)) {
+        ++nline;
+        std::string eol = "\n";
+        if (!cdelim.empty()) {
+          std::string::size_type m = s.find(cdelim);
+          if (m != std::string::npos) {
+            eol = " " + s.substr(m) + "\n";
+            s = s.substr(0, m);
+          }
+        }
+        str.clear(); str.str(s);
+        if (!(str >> inp[0]))
+          continue;             // skip blank lines
+        try {
+          for (int i = 1; i < 4; ++i) {
+            if (!(str >> inp[i]))
+              throw GeographicErr("Incomplete input: " + s);
+          }
+          if (str >> sc)
+            throw GeographicErr("Extraneous input: " + sc);
+          DMS::DecodeLatLon(inp[0], inp[1], lat1, lon1, longfirst);
+          DMS::DecodeLatLon(inp[2], inp[3], lat2, lon2, longfirst);
+        }
+        catch (const std::exception& e) {
+          // The indices in the output refer to the whole set; so give up
+          std::cerr << "ERROR on line " << nline << ": " << e.what() << "\n";
+          return 1;
+        }
+        lines.push_back(geod.InverseLine(lat1, lon1, lat2, lon2,
+                                         Intersect::LineCaps));
+        eols.push_back(eol);
+      }
+      stats.Stage("input");
+      stats.Rows(lines.size());
+      std::vector<std::pair<size_t, size_t>> ij;
+      std::vector<int> c;
+      auto v = intersect.Segments(lines, ij, &c, nthreads);
+      stats.Stage("intersect");
+      for (size_t k = 0; k < v.size(); ++k) {
+        const GeodesicLine
+          &lineX = lines[ij[k].first], &lineY = lines[ij[k].second];
+        real x = v[k].first, y = v[k].second;
+        *output << ij[k].first << " " << ij[k].second << " "
+                << Utility::str(x, prec) << " "
+                << Utility::str(y, prec) << " " << c[k]
+                << eols[ij[k].first];
+        if (check) {
+          real latX, lonX, latY, lonY, sXY;
+          lineX.Position(x, latX, lonX);
+          lineY.Position(y, latY, lonY);
+          geod.Inverse(latX, lonX, latY, lonY, sXY);
+          std::cerr << Utility::str(longfirst ? lonX : latX, prec+5) << " "
+                    << Utility::str(longfirst ? latX : lonX, prec+5) << " "
+                    << Utility::str(longfirst ? lonY : latY, prec+5) << " "
+                    << Utility::str(longfirst ? latY : lonY, prec+5) << " "
+                    << Utility::str(sXY, prec) << "\n";
+        }
+      }
+      stats.Stage("output");
+      stats.Count("intersections", v.size());
+      stats.Count("basic calls", intersect.NumBasic());
+      stats.Count("inverse calls", intersect.NumInverse());
+      stats.Report(std::cerr, "IntersectTool");
+      return 0;
+    }
     real latX1, lonX1, aziX, latY1, lonY1, aziY, latX2, lonX2, latY2, lonY2,
       x0 = 0, y0 = 0, x, y;
     std::string inp[8], s, sc, eol;
@@ -263,7 +364,12 @@ int main(int argc, const char* const argv[]) {
         *output << "ERROR: " << e.what() << "\n";
         retval = 1;
       }
+      stats.Rows();
     }
+    stats.Stage("process");
+    stats.Count("basic calls", intersect.NumBasic());
+    stats.Count("inverse calls", intersect.NumInverse());
+    stats.Report(std::cerr, "IntersectTool");
     return retval;
   }
   catch (const std::exception& e) {
@@ -13,6 +13,10 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
 #include <GeographicLib/MagneticModel.hpp>
 #include <GeographicLib/MagneticCircle.hpp>
 #include <GeographicLib/DMS.hpp>
@@ -24,19 +28,66 @@
 #endif
 
 #include "MagneticField.usage"
+#include "ToolIO.hpp"
+
+typedef GeographicLib::Math::real real;
+
+// Decode the start, end, and spacing of a grid axis; return the number of
+// points.
+size_t DecodeAxis(const std::string& sx0, const std::string& sx1,
+                  const std::string& sdx, bool latp, real& x0, real& dx) {
+  using namespace GeographicLib;
+  using std::fabs; using std::floor;
+  DMS::flag ind0, ind1;
+  x0 = DMS::Decode(sx0, ind0);
+  real x1 = DMS::Decode(sx1, ind1);
+  if (ind0 == (latp ? DMS::LONGITUDE : DMS::LATITUDE) ||
+      ind1 == (latp ? DMS::LONGITUDE : DMS::LATITUDE))
+    throw GeographicErr(std::string("Bad hemisphere letter on ") +
+                        (latp ? "latitude" : "longitude"));
+  if (latp && !(fabs(x0) <= Math::qd && fabs(x1) <= Math::qd))
+    throw GeographicErr("Latitude not in [-" + std::to_string(Math::qd)
+                        + "d, " + std::to_string(Math::qd) + "d]");
+  dx = DMS::DecodeAngle(sdx);
+  if (!(dx > 0))
+    throw GeographicErr("Grid spacing " + sdx + " is not positive");
+  if (x1 < x0) dx = -dx;
+  // Allow for roundoff in the number of intervals
+  real n = floor((x1 - x0) / dx + real(1e-6)) + 1;
+  if (!(n >= 1 && n <= real(1e8)))
+    throw GeographicErr("Bad number of grid points");
+  return size_t(n);
+}
+
+// Format the field components as in an output line: D I H By Bx -Bz F.
+std::string FieldLine(real D, real I, real H, real By, real Bx, real Bz,
+                      real F, int prec) {
+  using namespace GeographicLib;
+  return DMS::Encode(D, prec + 1, DMS::NUMBER) + " "
+    + DMS::Encode(I, prec + 1, DMS::NUMBER) + " "
+    + Utility::str(H, prec) + " "
+    + Utility::str(By, prec) + " "
+    + Utility::str(Bx, prec) + " "
+    + Utility::str(-Bz, prec) + " "
+    + Utility::str(F, prec);
+}
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
-    typedef Math::real real;
     Utility::set_digits();
+    ToolStats stats;
     bool verbose = false, longfirst = false;
     std::string dir;
     std::string model = MagneticModel::DefaultMagneticName();
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
     real time = 0, lat = 0, h = 0;
-    bool timeset = false, circle = false, rate = false;
+    bool timeset = false, circle = false, rate = false, grid = false,
+      binary = false, mapped = false;
+    real lat0 = 0, dlat = 0, lon0 = 0, dlon = 0;
+    size_t nlat = 0, nlon = 0;
+    unsigned nthreads = 1;
     real hguard = 500000, tguard = 50;
     int prec = 1, Nmax = -1, Mmax = -1;
 
@@ -80,6 +131,7 @@ int main(int argc, const char* const argv[]) {
           time = Utility::fractionalyear<real>(std::string(argv[m]));
           timeset = true;
           circle = false;
+          grid = false;
         }
         catch (const std::exception& e) {
           std::cerr << "Error decoding argument of " << arg << ": "
@@ -101,13 +153,42 @@ int main(int argc, const char* const argv[]) {
           h = Utility::val<real>(std::string(argv[++m]));
           timeset = false;
           circle = true;
+          grid = false;
+        }
+        catch (const std::exception& e) {
+          std::cerr << "Error decoding argument of " << arg << ": "
+                    << e.what() << "\n";
+          return 1;
+        }
+      } else if (arg == "--grid") {
+        if (m + 8 >= argc) return usage(1, true);
+        try {
+          time = Utility::fractionalyear<real>(std::string(argv[m + 1]));
+          nlat = DecodeAxis(std::string(argv[m + 2]), std::string(argv[m + 3]),
+                            std::string(argv[m + 4]), true, lat0, dlat);
+          nlon = DecodeAxis(std::string(argv[m + 5]), std::string(argv[m + 6]),
+                            std::string(argv[m + 7]), false, lon0, dlon);
+          h = Utility::val<real>(std::string(argv[m + 8]));
+          timeset = false;
+          circle = false;
+          grid = true;
         }
         catch (const std::exception& e) {
           std::cerr << "Error decoding argument of " << arg << ": "
                     << e.what() << "\n";
           return 1;
         }
-      } else if (arg == "-r")
+        m += 8;
+      } else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--stats")
+        stats.Enable();
+      else if (arg == "--mapped")
+        mapped = true;
+      else if (arg == "-r")
         rate = !rate;
       else if (arg == "-w")
         longfirst = !longfirst;
@@ -182,7 +263,7 @@ int main(int argc, const char* const argv[]) {
       return 1;
     }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
       infile.open(ifile.c_str());
@@ -203,10 +284,15 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    if (binary && !grid) {
+      std::cerr << "--binary requires --grid\n";
+      return 1;
+    }
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -221,8 +307,16 @@ int main(int argc, const char* const argv[]) {
     int retval = 0;
     try {
       using std::isfinite;
-      const MagneticModel m(model, dir, Geocentric::WGS84(), Nmax, Mmax);
-      if ((timeset || circle)
+      const MagneticModel m(model, dir, Geocentric::WGS84(), Nmax, Mmax,
+                            false, mapped);
+      stats.Stage("load");
+      auto report = [&stats, &m]() {
+        stats.Stage("process");
+        stats.Count("circle cache hits", m.CircleCacheHits());
+        stats.Count("circle cache misses", m.CircleCacheMisses());
+        stats.Report(std::cerr, "MagneticField");
+      };
+      if ((timeset || circle || grid)
           && (!isfinite(time) ||
               time < m.MinTime() - tguard ||
               time > m.MaxTime() + tguard))
@@ -230,7 +324,7 @@ int main(int argc, const char* const argv[]) {
                             " too far outside allowed range [" +
                             Utility::str(m.MinTime()) + "," +
                             Utility::str(m.MaxTime()) + "]");
-      if (circle
+      if ((circle || grid)
           && (!isfinite(h) ||
               h < m.MinHeight() - hguard ||
               h > m.MaxHeight() + hguard))
@@ -250,15 +344,77 @@ int main(int argc, const char* const argv[]) {
                   << m.MinHeight()/1000 << "km,"
                   << m.MaxHeight()/1000 << "km]\n";
       }
-      if ((timeset || circle) && (time < m.MinTime() || time > m.MaxTime()))
+      if ((timeset || circle || grid) &&
+          (time < m.MinTime() || time > m.MaxTime()))
         std::cerr << "WARNING: Time " << time
                   << " outside allowed range ["
                   << m.MinTime() << "," << m.MaxTime() << "]\n";
-      if (circle && (h < m.MinHeight() || h > m.MaxHeight()))
+      if ((circle || grid) && (h < m.MinHeight() || h > m.MaxHeight()))
         std::cerr << "WARNING: Height " << h/1000
                   << "km outside allowed range ["
                   << m.MinHeight()/1000 << "km,"
                   << m.MaxHeight()/1000 << "km]\n";
+      if (grid) {
+        // Evaluate blocks of rows, one MagneticCircle per row, with the rows
+        // of a block divided among the threads; write out each block in
+        // order.
+        const size_t ncomp = rate ? 14 : 7,
+          block = std::min(nlat, size_t(4) * nthreads);
+        std::vector<real> out(block * nlon * ncomp);
+        std::vector<std::string> text(binary ? 0 : block);
+        std::vector<std::exception_ptr> err(block);
+        for (size_t i0 = 0; i0 < nlat; i0 += block) {
+          size_t nb = std::min(block, nlat - i0);
+          ParallelFor(nb, nthreads, [&](size_t k0, size_t k1) {
+            std::vector<real> v(6 * nlon);
+            real *bx = v.data(), *by = bx + nlon, *bz = by + nlon,
+              *bxt = bz + nlon, *byt = bxt + nlon, *bzt = byt + nlon;
+            for (size_t k = k0; k < k1; ++k) {
+              try {
+                const MagneticCircle
+                  c(m.Circle(time, lat0 + real(i0 + k) * dlat, h));
+                c.Grid(lon0, dlon, nlon, bx, by, bz, bxt, byt, bzt);
+                real* row = out.data() + k * nlon * ncomp;
+                if (!binary) text[k].clear();
+                for (size_t j = 0; j < nlon; ++j) {
+                  real H, F, D, I, Ht, Ft, Dt, It;
+                  MagneticModel::FieldComponents(bx[j], by[j], bz[j],
+                                                 bxt[j], byt[j], bzt[j],
+                                                 H, F, D, I, Ht, Ft, Dt, It);
+                  real* x = row + j * ncomp;
+                  x[0] = D; x[1] = I; x[2] = H; x[3] = by[j]; x[4] = bx[j];
+                  x[5] = -bz[j]; x[6] = F;
+                  if (rate) {
+                    x[7] = Dt; x[8] = It; x[9] = Ht; x[10] = byt[j];
+                    x[11] = bxt[j]; x[12] = -bzt[j]; x[13] = Ft;
+                  }
+                  if (!binary) {
+                    text[k] += FieldLine(D, I, H, by[j], bx[j], bz[j], F,
+                                         prec) + "\n";
+                    if (rate)
+                      text[k] += FieldLine(Dt, It, Ht, byt[j], bxt[j], bzt[j],
+                                           Ft, prec) + "\n";
+                  }
+                }
+              }
+              catch (...) {
+                err[k] = std::current_exception();
+              }
+            }
+          });
+          for (size_t k = 0; k < nb; ++k)
+            if (err[k]) std::rethrow_exception(err[k]);
+          if (binary)
+            Utility::writearray<double, real, false>
+              (*output, out.data(), nb * nlon * ncomp);
+          else
+            for (size_t k = 0; k < nb; ++k)
+              *output << text[k];
+          stats.Rows(nb * nlon);
+        }
+        report();
+        return retval;
+      }
       const MagneticCircle c(circle ? m.Circle(time, lat, h) :
                              MagneticCircle());
       std::string s, eol, stra, strb;
@@ -328,27 +484,17 @@ int main(int argc, const char* const argv[]) {
           MagneticModel::FieldComponents(bx, by, bz, bxt, byt, bzt,
                                          H, F, D, I, Ht, Ft, Dt, It);
 
-          *output << DMS::Encode(D, prec + 1, DMS::NUMBER) << " "
-                  << DMS::Encode(I, prec + 1, DMS::NUMBER) << " "
-                  << Utility::str(H, prec) << " "
-                  << Utility::str(by, prec) << " "
-                  << Utility::str(bx, prec) << " "
-                  << Utility::str(-bz, prec) << " "
-                  << Utility::str(F, prec) << eol;
+          *output << FieldLine(D, I, H, by, bx, bz, F, prec) << eol;
           if (rate)
-            *output << DMS::Encode(Dt, prec + 1, DMS::NUMBER) << " "
-                    << DMS::Encode(It, prec + 1, DMS::NUMBER) << " "
-                    << Utility::str(Ht, prec) << " "
-                    << Utility::str(byt, prec) << " "
-                    << Utility::str(bxt, prec) << " "
-                    << Utility::str(-bzt, prec) << " "
-                    << Utility::str(Ft, prec) << eol;
+            *output << FieldLine(Dt, It, Ht, byt, bxt, bzt, Ft, prec) << eol;
         }
         catch (const std::exception& e) {
           *output << "ERROR: " << e.what() << "\n";
           retval = 1;
         }
+        stats.Rows();
       }
+      report();
     }
     catch (const std::exception& e) {
       std::cerr << "Error reading " << model << ": " << e.what() << "\n";
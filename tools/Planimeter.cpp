@@ -13,6 +13,9 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
 #include <GeographicLib/PolygonArea.hpp>
 #include <GeographicLib/DMS.hpp>
 #include <GeographicLib/Utility.hpp>
@@ -25,20 +28,22 @@
 #endif
 
 #include "Planimeter.usage"
+#include "ToolIO.hpp"
 
 int main(int argc, const char* const argv[]) {
   try {
     using namespace GeographicLib;
     typedef Math::real real;
     Utility::set_digits();
+    ToolStats stats;
     enum { GEODESIC, AUTHALIC, RHUMB };
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
     bool reverse = false, sign = true, polyline = false, longfirst = false,
-      exact = false, geoconvert_compat = false;
+      exact = false, geoconvert_compat = false, binary = false;
     int linetype = GEODESIC;
-    int prec = 6;
+    int prec = 6, nthreads = 1;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';';
 
@@ -82,6 +87,21 @@ int main(int argc, const char* const argv[]) {
         exact = true;
       else if (arg == "--geoconvert-input")
         geoconvert_compat = true;
+      else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        try {
+          nthreads = Utility::val<int>(std::string(argv[m]));
+          if (nthreads < 0)
+            throw GeographicErr("negative");
+        }
+        catch (const std::exception&) {
+          std::cerr << "Number of threads " << argv[m]
+                    << " is not a non-negative number\n";
+          return 1;
+        }
+      }
       else if (arg == "--input-string") {
         if (++m == argc) return usage(1, true);
         istring = argv[m];
@@ -101,7 +121,9 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-      } else if (arg == "--version") {
+      } else if (arg == "--stats")
+        stats.Enable();
+      else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
@@ -113,11 +135,22 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
+    if (binary && geoconvert_compat) {
+      std::cerr << "Cannot specify --geoconvert-input and --binary together\n";
+      return 1;
+    }
+    if (nthreads == 0)
+      nthreads = std::max(1, int(std::thread::hardware_concurrency()));
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::in | std::ios::binary :
+                  std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -135,10 +168,11 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -161,10 +195,95 @@ int main(int argc, const char* const argv[]) {
     PolygonArea poly(geod, polyline);
     PolygonAreaRhumb polyr(rhumb, polyline);
     GeoCoords p;
+    unsigned long long npolys = 0;
+    auto report = [&stats, &npolys]() {
+      stats.Stage("process");
+      stats.Count("polygons", npolys);
+      stats.Report(std::cerr, "Planimeter");
+    };
+    stats.Stage("setup");
 
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
+    if (binary) {
+      // Each input record is (lat, lon), or (lon, lat) with -w; a record
+      // containing a NaN ends a polygon.  The vertices for complete polygons
+      // are accumulated in the flattened layout used by PolygonAreaT::Rings
+      // and the polygons are processed in blocks of about block vertices.
+      // Each output record is (num, perimeter, area), without area for -l.
+      const size_t chunk = 65536, block = 1U << 20, nout = polyline ? 2 : 3;
+      std::vector<double> buf(2 * chunk);
+      std::vector<real> lats, lons, perimeters, areas, out;
+      std::vector<size_t> offsets(1, 0);
+      int retval = 0;
+      auto flush = [&]() -> void {
+        size_t nrings = offsets.size() - 1;
+        if (nrings == 0) return;
+        perimeters.resize(nrings); areas.resize(nrings);
+        if (linetype == RHUMB)
+          polyr.Rings(nrings, offsets.data(), lats.data(), lons.data(),
+                      reverse, sign, perimeters.data(), areas.data(),
+                      nthreads);
+        else
+          poly.Rings(nrings, offsets.data(), lats.data(), lons.data(),
+                     reverse, sign, perimeters.data(), areas.data(),
+                     nthreads);
+        npolys += nrings;
+        out.resize(nrings * nout);
+        for (size_t k = 0; k < nrings; ++k) {
+          out[k * nout] = real(offsets[k + 1] - offsets[k]);
+          out[k * nout + 1] = perimeters[k];
+          if (!polyline) out[k * nout + 2] = areas[k];
+        }
+        Utility::writearray<double, real, false>(*output, out.data(),
+                                                 out.size());
+        // Move the vertices of the incomplete polygon to the front
+        size_t n0 = offsets.back();
+        lats.erase(lats.begin(), lats.begin() + n0);
+        lons.erase(lons.begin(), lons.begin() + n0);
+        offsets.assign(1, 0);
+      };
+      while (*input) {
+        input->read(reinterpret_cast<char*>(buf.data()),
+                    buf.size() * sizeof(double));
+        size_t nread = size_t(input->gcount()) / sizeof(double),
+          n = nread / 2;
+        if (nread % 2 || input->gcount() % sizeof(double)) {
+          std::cerr << "Incomplete record at end of input\n";
+          retval = 1;
+        }
+        stats.Rows(n);
+        for (size_t i = 0; i < n; ++i) {
+          using std::isnan;
+          using std::fabs;
+          // input is little-endian
+          real
+            x = real(Math::bigendian ? Math::swab<double>(buf[2 * i]) :
+                     buf[2 * i]),
+            y = real(Math::bigendian ? Math::swab<double>(buf[2 * i + 1]) :
+                     buf[2 * i + 1]),
+            lat1 = longfirst ? y : x, lon1 = longfirst ? x : y;
+          if (isnan(lat1) || isnan(lon1) || !(fabs(lat1) <= Math::qd)) {
+            if (lats.size() > offsets.back()) {
+              offsets.push_back(lats.size());
+              if (offsets.back() >= block) flush();
+            }
+          } else {
+            lats.push_back(linetype == AUTHALIC ?
+                           ellip.Convert(AuxLatitude::PHI, AuxLatitude::XI,
+                                         lat1, exact) : lat1);
+            lons.push_back(lon1);
+          }
+        }
+      }
+      if (lats.size() > offsets.back())
+        offsets.push_back(lats.size());
+      flush();
+      report();
+      return retval;
+    }
+
     std::string s, eol("\n");
     real perimeter, area;
     unsigned num;
@@ -172,6 +291,7 @@ int main(int argc, const char* const argv[]) {
     std::string slat, slon, junk;
     real lat = 0, lon = 0;
     while (std::getline(*input, s)) {
+      stats.Rows();
       if (!cdelim.empty()) {
         std::string::size_type m = s.find(cdelim);
         if (m != std::string::npos) {
@@ -206,6 +326,7 @@ int main(int argc, const char* const argv[]) {
           linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
           poly.Compute(reverse, sign, perimeter, area); // geodesic + authalic
         if (num > 0) {
+          ++npolys;
           *output << num << " " << Utility::str(perimeter, prec);
           if (!polyline) {
             *output << " " << Utility::str(area, std::max(0, prec - 5));
@@ -226,6 +347,7 @@ int main(int argc, const char* const argv[]) {
       linetype == RHUMB ? polyr.Compute(reverse, sign, perimeter, area) :
       poly.Compute(reverse, sign, perimeter, area);
     if (num > 0) {
+      ++npolys;
       *output << num << " " << Utility::str(perimeter, prec);
       if (!polyline) {
         *output << " " << Utility::str(area, std::max(0, prec - 5));
@@ -234,6 +356,7 @@ int main(int argc, const char* const argv[]) {
     }
       linetype == RHUMB ? polyr.Clear() : poly.Clear();
     eol = "\n";
+    report();
     return 0;
   }
   catch (const std::exception& e) {
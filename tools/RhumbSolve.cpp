@@ -26,6 +26,8 @@
 #endif
 
 #include "RhumbSolve.usage"
+#include "ToolIO.hpp"
+
 using namespace GeographicLib;
 typedef Math::real real;
 
@@ -54,8 +56,10 @@ int main(int argc, const char* const argv[]) {
     real
       a = Constants::WGS84_a(),
       f = Constants::WGS84_f();
-    real lat1, lon1, azi12 = Math::NaN(), lat2, lon2, s12, S12;
+    real lat1, lon1, azi12 = Math::NaN();
     int prec = 3;
+    unsigned nthreads = 1;
+    bool binary = false;
     std::string istring, ifile, ofile, cdelim;
     char lsep = ';', dmssep = char(0);
 
@@ -129,7 +133,12 @@ int main(int argc, const char* const argv[]) {
       } else if (arg == "--comment-delimiter") {
         if (++m == argc) return usage(1, true);
         cdelim = argv[m];
-      } else if (arg == "--version") {
+      } else if (arg == "--threads") {
+        if (++m == argc) return usage(1, true);
+        if (!ParseThreads(argv[m], nthreads)) return 1;
+      } else if (arg == "--binary")
+        binary = true;
+      else if (arg == "--version") {
         std::cout << argv[0] << ": GeographicLib version "
                   << GEOGRAPHICLIB_VERSION_STRING << "\n";
         return 0;
@@ -141,11 +150,16 @@ int main(int argc, const char* const argv[]) {
       std::cerr << "Cannot specify --input-string and --input-file together\n";
       return 1;
     }
+    if (binary && !istring.empty()) {
+      std::cerr << "Cannot specify --input-string and --binary together\n";
+      return 1;
+    }
     if (ifile == "-") ifile.clear();
-    std::ifstream infile;
+    InputFile infile;
     std::istringstream instring;
     if (!ifile.empty()) {
-      infile.open(ifile.c_str());
+      infile.open(ifile.c_str(), binary ? std::ios::in | std::ios::binary :
+                  std::ios::in);
       if (!infile.is_open()) {
         std::cerr << "Cannot open " << ifile << " for reading\n";
         return 1;
@@ -163,10 +177,11 @@ int main(int argc, const char* const argv[]) {
     std::istream* input = !ifile.empty() ? &infile :
       (!istring.empty() ? &instring : &std::cin);
 
-    std::ofstream outfile;
+    OutputFile outfile;
     if (ofile == "-") ofile.clear();
     if (!ofile.empty()) {
-      outfile.open(ofile.c_str());
+      outfile.open(ofile.c_str(), binary ? std::ios::out | std::ios::binary :
+                   std::ios::out);
       if (!outfile.is_open()) {
         std::cerr << "Cannot open " << ofile << " for writing\n";
         return 1;
@@ -180,12 +195,46 @@ int main(int argc, const char* const argv[]) {
     // Max precision = 10: 0.1 nm in distance, 10^-15 deg (= 0.11 nm),
     // 10^-11 sec (= 0.3 nm).
     prec = std::min(10 + Math::extra_digits(), std::max(0, prec));
-    std::string s, eol, slat1, slon1, slat2, slon2, sazi, ss12, strc;
-    std::istringstream str;
-    int retval = 0;
-    while (std::getline(*input, s)) {
+    if (binary) {
+      const unsigned outmask = Rhumb::ALL | (unroll ? Rhumb::LONG_UNROLL : 0);
+      const int ilat = longfirst ? 1 : 0;
+      return ProcessRecords(*input, *output, linecalc ? 1 : 4, 3, nthreads,
+                            [&](size_t n, const real* in[], real* out[]) {
+                              if (linecalc)
+                                // The vectorized positions along the line
+                                rhl.Positions(n, in[0], outmask,
+                                              out[ilat], out[1 - ilat],
+                                              out[2]);
+                              else
+                                for (size_t i = 0; i < n; ++i) {
+                                  // Rhumb doesn't check the latitudes
+                                  real lat1x = in[ilat][i],
+                                    lat2x = inverse ? in[2 + ilat][i] : 0;
+                                  using std::fabs;
+                                  if (!(fabs(lat1x) <= Math::qd &&
+                                        fabs(lat2x) <= Math::qd))
+                                    out[0][i] = out[1][i] = out[2][i] =
+                                      Math::NaN();
+                                  else if (inverse)
+                                    rh.Inverse(lat1x, in[1 - ilat][i],
+                                               lat2x, in[3 - ilat][i],
+                                               out[1][i], out[0][i],
+                                               out[2][i]);
+                                  else
+                                    rh.GenDirect(lat1x, in[1 - ilat][i],
+                                                 in[2][i], in[3][i], outmask,
+                                                 out[ilat][i],
+                                                 out[1 - ilat][i], out[2][i]);
+                                }
+                            });
+    }
+    // Process one line; this is called concurrently if nthreads > 1.
+    auto convert = [&](const std::string& line, std::string& out) -> bool {
+      real lat1x, lon1x, azi12x, lat2, lon2, s12, S12;
+      std::string s(line), eol("\n"),
+        slat1, slon1, slat2, slon2, sazi, ss12, strc;
+      std::istringstream str;
       try {
-        eol = "\n";
         if (!cdelim.empty()) {
           std::string::size_type m = s.find(cdelim);
           if (m != std::string::npos) {
@@ -193,7 +242,7 @@ int main(int argc, const char* const argv[]) {
             s = s.substr(0, m);
           }
         }
-        str.clear(); str.str(s);
+        str.str(s);
         if (linecalc) {
           if (!(str >> ss12))
             throw GeographicErr("Incomplete input: " + s);
@@ -202,41 +251,42 @@ int main(int argc, const char* const argv[]) {
           s12 = Utility::val<real>(ss12);
           rhl.GenPosition(s12, Rhumb::ALL | (unroll ? Rhumb::LONG_UNROLL : 0),
                           lat2, lon2, S12);
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          out = LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
+            + " " + Utility::str(S12, std::max(prec-7, 0)) + eol;
         } else if (inverse) {
           if (!(str >> slat1 >> slon1 >> slat2 >> slon2))
             throw GeographicErr("Incomplete input: " + s);
           if (str >> strc)
             throw GeographicErr("Extraneous input: " + strc);
-          DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
+          DMS::DecodeLatLon(slat1, slon1, lat1x, lon1x, longfirst);
           DMS::DecodeLatLon(slat2, slon2, lat2, lon2, longfirst);
-          rh.Inverse(lat1, lon1, lat2, lon2, s12, azi12, S12);
-          *output << AzimuthString(azi12, prec, dms, dmssep) << " "
-                  << Utility::str(s12, prec) << " "
-                  << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          rh.Inverse(lat1x, lon1x, lat2, lon2, s12, azi12x, S12);
+          out = AzimuthString(azi12x, prec, dms, dmssep) + " "
+            + Utility::str(s12, prec) + " "
+            + Utility::str(S12, std::max(prec-7, 0)) + eol;
         } else {                // direct
           if (!(str >> slat1 >> slon1 >> sazi >> ss12))
             throw GeographicErr("Incomplete input: " + s);
           if (str >> strc)
             throw GeographicErr("Extraneous input: " + strc);
-          DMS::DecodeLatLon(slat1, slon1, lat1, lon1, longfirst);
-          azi12 = DMS::DecodeAzimuth(sazi);
+          DMS::DecodeLatLon(slat1, slon1, lat1x, lon1x, longfirst);
+          azi12x = DMS::DecodeAzimuth(sazi);
           s12 = Utility::val<real>(ss12);
-          rh.GenDirect(lat1, lon1, azi12, s12,
+          rh.GenDirect(lat1x, lon1x, azi12x, s12,
                        Rhumb::ALL | (unroll ? Rhumb::LONG_UNROLL : 0),
                        lat2, lon2, S12);
-          *output << LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
-                  << " " << Utility::str(S12, std::max(prec-7, 0)) << eol;
+          out = LatLonString(lat2, lon2, prec, dms, dmssep, longfirst)
+            + " " + Utility::str(S12, std::max(prec-7, 0)) + eol;
         }
+        return true;
       }
       catch (const std::exception& e) {
         // Write error message cout so output lines match input lines
-        *output << "ERROR: " << e.what() << "\n";
-        retval = 1;
+        out = std::string("ERROR: ") + e.what() + "\n";
+        return false;
       }
-    }
-    return retval;
+    };
+    return ProcessLines(*input, *output, nthreads, convert);
   }
   catch (const std::exception& e) {
     std::cerr << "Caught exception: " << e.what() << "\n";
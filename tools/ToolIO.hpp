@@ -0,0 +1,417 @@
+/**
+ * \file ToolIO.hpp
+ * \brief Input and output helpers shared by the command line utilities
+ *
+ * Copyright (c) Charles Karney (2024) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ **********************************************************************/
+
+#if !defined(GEOGRAPHICLIB_TOOLIO_HPP)
+#define GEOGRAPHICLIB_TOOLIO_HPP 1
+
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <streambuf>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <exception>
+#include <cstring>
+#include <chrono>
+#include <utility>
+#include <GeographicLib/Utility.hpp>
+#include <GeographicLib/Instrument.hpp>
+
+#if !defined(GEOGRAPHICLIB_HAVE_ZLIB)
+#  define GEOGRAPHICLIB_HAVE_ZLIB 0
+#endif
+
+#if GEOGRAPHICLIB_HAVE_ZLIB
+#  include <zlib.h>
+#endif
+
+// Is name a gzip-compressed file (as indicated by a .gz suffix)?
+inline bool Compressed(const std::string& name) {
+  return name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0;
+}
+
+#if GEOGRAPHICLIB_HAVE_ZLIB
+// A stream buffer which reads or writes a gzip-compressed file.
+class GzipBuf : public std::streambuf {
+private:
+  gzFile _f;
+  bool _out;
+  std::vector<char> _buf;
+  bool Flush() {
+    int n = int(pptr() - pbase());
+    if (n > 0 && gzwrite(_f, pbase(), unsigned(n)) != n)
+      return false;
+    setp(_buf.data(), _buf.data() + _buf.size());
+    return true;
+  }
+protected:
+  int_type underflow() override {
+    if (!_f || _out) return traits_type::eof();
+    int n = gzread(_f, _buf.data(), unsigned(_buf.size()));
+    if (n <= 0) return traits_type::eof();
+    setg(_buf.data(), _buf.data(), _buf.data() + n);
+    return traits_type::to_int_type(*gptr());
+  }
+  int_type overflow(int_type c) override {
+    if (!_f || !_out || !Flush()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+  int sync() override { return _f && _out && !Flush() ? -1 : 0; }
+public:
+  GzipBuf() : _f(nullptr), _out(false), _buf(size_t(1) << 16) {}
+  ~GzipBuf() override { close(); }
+  GzipBuf(const GzipBuf&) = delete;
+  GzipBuf& operator=(const GzipBuf&) = delete;
+  bool open(const std::string& name, bool out) {
+    close();
+    _f = gzopen(name.c_str(), out ? "wb" : "rb");
+    if (!_f) return false;
+    _out = out;
+    // zlib's own buffer; the default of 8 kB makes for many small reads.
+    gzbuffer(_f, 1U << 17);
+    if (_out)
+      setp(_buf.data(), _buf.data() + _buf.size());
+    else
+      setg(_buf.data(), _buf.data(), _buf.data());
+    return true;
+  }
+  bool close() {
+    if (!_f) return true;
+    bool ok = !_out || Flush();
+    ok = gzclose(_f) == Z_OK && ok;
+    _f = nullptr;
+    setg(nullptr, nullptr, nullptr); setp(nullptr, nullptr);
+    return ok;
+  }
+};
+#endif
+
+// Replacements for std::ifstream and std::ofstream which read and write
+// gzip-compressed files if the name ends in .gz.  Compressed files can only
+// be opened if the tools are compiled with zlib.
+class InputFile : public std::istream {
+private:
+  std::filebuf _file;
+#if GEOGRAPHICLIB_HAVE_ZLIB
+  GzipBuf _gz;
+#endif
+  bool _open;
+public:
+  InputFile() : std::istream(nullptr), _open(false) {}
+  void open(const std::string& name,
+            std::ios::openmode mode = std::ios::in) {
+    std::streambuf* b = nullptr;
+    if (Compressed(name)) {
+#if GEOGRAPHICLIB_HAVE_ZLIB
+      if (_gz.open(name, false)) b = &_gz;
+#endif
+    } else if (_file.open(name.c_str(), mode | std::ios::in))
+      b = &_file;
+    _open = b != nullptr;
+    rdbuf(b);                   // sets badbit if b is null
+  }
+  bool is_open() const { return _open; }
+};
+
+class OutputFile : public std::ostream {
+private:
+  std::filebuf _file;
+#if GEOGRAPHICLIB_HAVE_ZLIB
+  GzipBuf _gz;
+#endif
+  bool _open;
+public:
+  OutputFile() : std::ostream(nullptr), _open(false) {}
+  ~OutputFile() override { flush(); }
+  void open(const std::string& name,
+            std::ios::openmode mode = std::ios::out) {
+    std::streambuf* b = nullptr;
+    if (Compressed(name)) {
+#if GEOGRAPHICLIB_HAVE_ZLIB
+      if (_gz.open(name, true)) b = &_gz;
+#endif
+    } else if (_file.open(name.c_str(), mode | std::ios::out))
+      b = &_file;
+    _open = b != nullptr;
+    rdbuf(b);
+  }
+  bool is_open() const { return _open; }
+};
+
+// Read lines from a stream in large blocks instead of calling std::getline
+// for each line.  As with std::getline, the newline is not included in the
+// line and a final line without a newline is returned.
+class LineReader {
+private:
+  std::istream& _in;
+  std::vector<char> _buf;
+  size_t _beg, _end;
+public:
+  LineReader(std::istream& in, size_t bufsize = size_t(1) << 20)
+    : _in(in), _buf(bufsize), _beg(0), _end(0) {}
+  bool Next(std::string& line) {
+    while (true) {
+      const char* b = _buf.data() + _beg;
+      const char* nl =
+        static_cast<const char*>(std::memchr(b, '\n', _end - _beg));
+      if (nl) {
+        line.assign(b, nl - b);
+        _beg += (nl - b) + 1;
+        return true;
+      }
+      if (!_in) {
+        if (_beg == _end) return false;
+        line.assign(b, _end - _beg);
+        _beg = _end;
+        return true;
+      }
+      // Move the partial line to the front of the buffer and read more
+      std::memmove(_buf.data(), b, _end - _beg);
+      _end -= _beg; _beg = 0;
+      if (_end == _buf.size()) _buf.resize(2 * _buf.size());
+      _in.read(_buf.data() + _end, _buf.size() - _end);
+      _end += size_t(_in.gcount());
+    }
+  }
+};
+
+// The statistics printed by the --stats option.  The time from the
+// construction of the object (at the start of main) to each call of Stage
+// is attributed to the named stage; Time accumulates the time for a
+// sub-stage (reading, converting, writing) measured by the caller; Rows and
+// Count record the number of rows processed and other counters (e.g., cache
+// hits).  If the object is not enabled, these do nothing (apart from the
+// cheap Rows) and Report prints nothing.
+class ToolStats {
+private:
+  typedef std::chrono::steady_clock clock;
+  bool _on;
+  clock::time_point _start, _last;
+  std::vector<std::pair<std::string, double>> _stages, _times;
+  std::vector<std::pair<std::string, unsigned long long>> _counts;
+  unsigned long long _rows;
+  static double Seconds(clock::duration d)
+  { return std::chrono::duration<double>(d).count(); }
+public:
+  ToolStats() : _on(false), _start(clock::now()), _last(_start), _rows(0) {}
+  void Enable() { _on = true; }
+  bool Enabled() const { return _on; }
+  static clock::time_point Now() { return clock::now(); }
+  void Stage(const std::string& name) {
+    if (!_on) return;
+    clock::time_point t = clock::now();
+    _stages.push_back(std::make_pair(name, Seconds(t - _last)));
+    _last = t;
+  }
+  void Time(const std::string& name, clock::time_point t0) {
+    if (!_on) return;
+    double dt = Seconds(clock::now() - t0);
+    for (auto& x : _times)
+      if (x.first == name) { x.second += dt; return; }
+    _times.push_back(std::make_pair(name, dt));
+  }
+  void Rows(unsigned long long n = 1) { _rows += n; }
+  void Count(const std::string& name, unsigned long long n)
+  { if (_on) _counts.push_back(std::make_pair(name, n)); }
+  void Report(std::ostream& os, const std::string& tool) const {
+    using namespace GeographicLib;
+    if (!_on) return;
+    double total = Seconds(clock::now() - _start);
+    std::ostringstream str;
+    str << std::fixed << std::setprecision(6)
+        << tool << " statistics:\n";
+    for (const auto& x : _stages)
+      str << "  " << std::left << std::setw(22) << (x.first + " time")
+          << std::right << std::setw(14) << x.second << " s\n";
+    for (const auto& x : _times)
+      str << "    " << std::left << std::setw(20) << (x.first + " time")
+          << std::right << std::setw(14) << x.second << " s\n";
+    str << "  " << std::left << std::setw(22) << "total time"
+        << std::right << std::setw(14) << total << " s\n"
+        << "  " << std::left << std::setw(22) << "rows"
+        << std::right << std::setw(14) << _rows << "\n"
+        << std::setprecision(0)
+        << "  " << std::left << std::setw(22) << "rows per second"
+        << std::right << std::setw(14)
+        << (total > 0 ? double(_rows) / total : 0.0) << "\n";
+    for (const auto& x : _counts)
+      str << "  " << std::left << std::setw(22) << x.first
+          << std::right << std::setw(14) << x.second << "\n";
+    if (Instrument::Enabled()) {
+      for (int k = 0; k < int(Instrument::NUMSOLVERS); ++k) {
+        Instrument::solver sv = Instrument::solver(k);
+        Instrument::Counts c = Instrument::Snapshot(sv);
+        if (c.calls == 0) continue;
+        str << "  " << Instrument::Name(sv) << ": calls " << c.calls
+            << ", iterations " << c.iterations
+            << ", fallbacks " << c.fallbacks << "\n";
+      }
+    } else
+      str << "  (the library was compiled without "
+          << "GEOGRAPHICLIB_INSTRUMENT; no solver counts)\n";
+    os << str.str();
+  }
+};
+
+// Divide [0, n) into nthreads contiguous ranges and call f(i0, i1) for each
+// range in its own thread.
+template<typename F>
+void ParallelFor(size_t n, unsigned nthreads, const F& f) {
+  size_t m = std::min(size_t(nthreads), n);
+  if (m <= 1) {
+    f(size_t(0), n);
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (size_t k = 1; k < m; ++k)
+    workers.emplace_back(f, k * n / m, (k + 1) * n / m);
+  f(size_t(0), n / m);
+  for (auto& w : workers) w.join();
+}
+
+// Decode the argument of --threads, n; 0 means the number of threads the
+// hardware supports.  Return false (after printing a message) if n is
+// invalid.
+inline bool ParseThreads(const char* arg, unsigned& nthreads) {
+  try {
+    int n = GeographicLib::Utility::val<int>(std::string(arg));
+    if (n < 0)
+      throw GeographicLib::GeographicErr("is negative");
+    nthreads = n > 0 ? unsigned(n) :
+      std::max(1u, std::thread::hardware_concurrency());
+    return true;
+  }
+  catch (const std::exception&) {
+    std::cerr << "Number of threads " << arg
+              << " is not a non-negative number\n";
+    return false;
+  }
+}
+
+// Apply convert(line, out) to each line of in and write out (which should
+// include the end of line) to output; convert returns false if the line
+// could not be processed.  With one thread, each line is processed as it
+// is read, so that the tools can be used interactively.  Otherwise the
+// input is read in blocks, chunks of lines are divided among the threads
+// (so convert must be safe to call concurrently), and the results for each
+// chunk are written in order with a single write.  Return 1 if any line
+// failed, otherwise 0.  If stats is not null, the lines are counted and,
+// if the statistics are enabled, the times for reading the input,
+// converting the lines, and writing the output are recorded.
+template<typename F>
+int ProcessLines(std::istream& input, std::ostream& output,
+                 unsigned nthreads, const F& convert,
+                 ToolStats* stats = nullptr) {
+  int retval = 0;
+  const bool timep = stats && stats->Enabled();
+  if (nthreads <= 1) {
+    std::string s, os;
+    if (timep) {
+      while (true) {
+        auto t = ToolStats::Now();
+        if (!std::getline(input, s)) break;
+        stats->Time("input", t); t = ToolStats::Now();
+        if (!convert(s, os)) retval = 1;
+        stats->Time("convert", t); t = ToolStats::Now();
+        output << os;
+        stats->Time("output", t);
+        stats->Rows();
+      }
+      return retval;
+    }
+    while (std::getline(input, s)) {
+      if (!convert(s, os)) retval = 1;
+      output << os;
+      if (stats) stats->Rows();
+    }
+    return retval;
+  }
+  const size_t chunk = 4096 * nthreads;
+  LineReader reader(input);
+  std::vector<std::string> lines(chunk), outs(chunk);
+  std::vector<char> oks(chunk);
+  std::string obuf;
+  size_t n;
+  do {
+    auto t = ToolStats::Now();
+    for (n = 0; n < chunk && reader.Next(lines[n]); ++n) {}
+    if (timep) { stats->Time("input", t); t = ToolStats::Now(); }
+    ParallelFor(n, nthreads, [&](size_t i0, size_t i1) {
+      for (size_t i = i0; i < i1; ++i)
+        oks[i] = convert(lines[i], outs[i]);
+    });
+    if (timep) { stats->Time("convert", t); t = ToolStats::Now(); }
+    obuf.clear();
+    for (size_t i = 0; i < n; ++i) {
+      obuf += outs[i];
+      if (!oks[i]) retval = 1;
+    }
+    output.write(obuf.data(), obuf.size());
+    if (timep) stats->Time("output", t);
+    if (stats) stats->Rows(n);
+  } while (n == chunk);
+  return retval;
+}
+
+// Read binary records of nin little-endian doubles from input, convert
+// them, and write records of nout little-endian doubles to output.  The
+// records are read in chunks and split into columns; each chunk is divided
+// among the threads and each thread calls convert(n, in, out) where in[j],
+// for j in [0, nin), and out[j], for j in [0, nout), point to n values of
+// the jth input and output columns.  Return 1 if the input ends with an
+// incomplete record, otherwise 0.
+template<typename F>
+int ProcessRecords(std::istream& input, std::ostream& output,
+                   size_t nin, size_t nout, unsigned nthreads,
+                   const F& convert) {
+  using namespace GeographicLib;
+  typedef Math::real real;
+  int retval = 0;
+  const size_t chunk = 4096 * std::max(1u, nthreads);
+  std::vector<double> buf(chunk * nin);
+  std::vector<real> in(chunk * nin), out(chunk * nout), rec(chunk * nout);
+  while (input) {
+    input.read(reinterpret_cast<char*>(buf.data()),
+               buf.size() * sizeof(double));
+    size_t nread = size_t(input.gcount()) / sizeof(double),
+      n = nread / nin;
+    if (nread % nin || input.gcount() % sizeof(double)) {
+      std::cerr << "Incomplete record at end of input\n";
+      retval = 1;
+    }
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nin; ++j)
+        // input is little-endian
+        in[j * chunk + i] = real(Math::bigendian ?
+                                 Math::swab<double>(buf[nin * i + j]) :
+                                 buf[nin * i + j]);
+    ParallelFor(n, nthreads, [&](size_t i0, size_t i1) {
+      std::vector<const real*> pin(nin);
+      std::vector<real*> pout(nout);
+      for (size_t j = 0; j < nin; ++j) pin[j] = in.data() + j * chunk + i0;
+      for (size_t j = 0; j < nout; ++j) pout[j] = out.data() + j * chunk + i0;
+      convert(i1 - i0, pin.data(), pout.data());
+    });
+    // Interleave the results into records
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < nout; ++j)
+        rec[nout * i + j] = out[j * chunk + i];
+    Utility::writearray<double, real, false>(output, rec.data(), n * nout);
+  }
+  return retval;
+}
+
+#endif  // GEOGRAPHICLIB_TOOLIO_HPP
@@ -0,0 +1,301 @@
+#include "cgeographiclib.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include "GeographicLib/Geodesic.hpp"
+#include "GeographicLib/PolygonArea.hpp"
+#include "GeographicLib/UTMUPS.hpp"
+#include "GeographicLib/MGRS.hpp"
+#include "GeographicLib/Geoid.hpp"
+#include "GeographicLib/GravityModel.hpp"
+#include "GeographicLib/MagneticModel.hpp"
+
+using namespace GeographicLib;
+
+// The C interface passes arrays of doubles directly to the C++ library.
+static_assert(std::is_same<Math::real, double>::value,
+              "The C interface requires GEOGRAPHICLIB_PRECISION = 2");
+
+struct geographiclib_geodesic {
+  Geodesic g;
+  geographiclib_geodesic(double a, double f) : g(a, f) {}
+};
+
+struct geographiclib_geoid {
+  Geoid g;
+  geographiclib_geoid(const std::string& name, const std::string& path,
+                      bool cubic, bool threadsafe)
+    : g(name, path, cubic, threadsafe) {}
+};
+
+struct geographiclib_gravity {
+  GravityModel g;
+  geographiclib_gravity(const std::string& name, const std::string& path)
+    : g(name, path) {}
+};
+
+struct geographiclib_magnetic {
+  MagneticModel m;
+  geographiclib_magnetic(const std::string& name, const std::string& path)
+    : m(name, path) {}
+};
+
+namespace {
+
+  thread_local std::string lasterror;
+
+  // Call f() catching any exception; return 0 on success and -1 on failure
+  // (with the message saved in lasterror).
+  template<class F> int guard(F f) {
+    try {
+      f();
+      lasterror.clear();
+      return 0;
+    }
+    catch (const std::exception& e) {
+      lasterror = e.what();
+    }
+    catch (...) {
+      lasterror = "unknown error";
+    }
+    return -1;
+  }
+
+  // The same for the *_new functions which return a pointer.
+  template<class T, class F> T* guardnew(F f) {
+    T* p = nullptr;
+    if (guard([&]() -> void { p = f(); }) != 0) p = nullptr;
+    return p;
+  }
+
+  std::string str(const char* s) { return s ? std::string(s) : std::string(); }
+
+  // The number of points handled together when scratch space is needed.
+  const size_t block_ = 256;
+
+}
+
+extern "C" {
+
+  const char* geographiclib_lasterror(void) {
+    return lasterror.c_str();
+  }
+
+  geographiclib_geodesic* geographiclib_geodesic_new(double a, double f) {
+    return guardnew<geographiclib_geodesic>
+      ([&]() { return new geographiclib_geodesic(a, f); });
+  }
+
+  void geographiclib_geodesic_free(geographiclib_geodesic* g) {
+    delete g;
+  }
+
+  int geographiclib_geodesic_inverse(const geographiclib_geodesic* g,
+                                     size_t n,
+                                     const double lat1[], const double lon1[],
+                                     const double lat2[], const double lon2[],
+                                     double s12[],
+                                     double azi1[], double azi2[],
+                                     double m12[],
+                                     double M12[], double M21[],
+                                     double S12[]) {
+    return guard([&]() -> void {
+      unsigned outmask =
+        (s12 ? Geodesic::DISTANCE : Geodesic::NONE) |
+        (azi1 || azi2 ? Geodesic::AZIMUTH : Geodesic::NONE) |
+        (m12 ? Geodesic::REDUCEDLENGTH : Geodesic::NONE) |
+        (M12 || M21 ? Geodesic::GEODESICSCALE : Geodesic::NONE) |
+        (S12 ? Geodesic::AREA : Geodesic::NONE);
+      if ((!azi1 == !azi2) && (!M12 == !M21)) {
+        g->g.InverseBatch(n, lat1, lon1, lat2, lon2, outmask,
+                          s12, azi1, azi2, m12, M12, M21, S12);
+        return;
+      }
+      // One of a pair of outputs is missing; supply scratch space for it.
+      double t1[block_], t2[block_];
+      for (size_t i = 0; i < n; i += block_) {
+        size_t m = std::min(block_, n - i);
+        g->g.InverseBatch(m, lat1 + i, lon1 + i, lat2 + i, lon2 + i, outmask,
+                          s12 ? s12 + i : nullptr,
+                          azi1 ? azi1 + i : (azi2 ? t1 : nullptr),
+                          azi2 ? azi2 + i : (azi1 ? t1 : nullptr),
+                          m12 ? m12 + i : nullptr,
+                          M12 ? M12 + i : (M21 ? t2 : nullptr),
+                          M21 ? M21 + i : (M12 ? t2 : nullptr),
+                          S12 ? S12 + i : nullptr);
+      }
+    });
+  }
+
+  int geographiclib_geodesic_direct(const geographiclib_geodesic* g,
+                                    size_t n,
+                                    const double lat1[], const double lon1[],
+                                    const double azi1[], const double s12[],
+                                    double lat2[], double lon2[],
+                                    double azi2[],
+                                    double m12[],
+                                    double M12[], double M21[],
+                                    double S12[]) {
+    return guard([&]() -> void {
+      unsigned outmask =
+        (lat2 ? Geodesic::LATITUDE : Geodesic::NONE) |
+        (lon2 ? Geodesic::LONGITUDE : Geodesic::NONE) |
+        (azi2 ? Geodesic::AZIMUTH : Geodesic::NONE) |
+        (m12 ? Geodesic::REDUCEDLENGTH : Geodesic::NONE) |
+        (M12 || M21 ? Geodesic::GEODESICSCALE : Geodesic::NONE) |
+        (S12 ? Geodesic::AREA : Geodesic::NONE);
+      for (size_t i = 0; i < n; ++i) {
+        double lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x;
+        g->g.GenDirect(lat1[i], lon1[i], azi1[i], false, s12[i], outmask,
+                       lat2x, lon2x, azi2x, s12x, m12x, M12x, M21x, S12x);
+        if (lat2) lat2[i] = lat2x;
+        if (lon2) lon2[i] = lon2x;
+        if (azi2) azi2[i] = azi2x;
+        if (m12) m12[i] = m12x;
+        if (M12) M12[i] = M12x;
+        if (M21) M21[i] = M21x;
+        if (S12) S12[i] = S12x;
+      }
+    });
+  }
+
+  int geographiclib_polygon_rings(const geographiclib_geodesic* g,
+                                  int polyline, size_t nrings,
+                                  const size_t offsets[],
+                                  const double lat[], const double lon[],
+                                  int reverse, int sign,
+                                  double perimeter[], double area[]) {
+    return guard([&]() -> void {
+      PolygonArea p(g->g, polyline != 0);
+      std::vector<double> areax(!polyline && !area ? nrings : 0);
+      p.Rings(nrings, offsets, lat, lon, reverse != 0, sign != 0,
+              perimeter, area || polyline ? area : areax.data());
+    });
+  }
+
+  int geographiclib_utmups_forward(size_t n,
+                                   const double lat[], const double lon[],
+                                   int zone[], int northp[],
+                                   double x[], double y[],
+                                   double gamma[], double k[], int setzone) {
+    return guard([&]() -> void {
+      std::unique_ptr<bool[]> northx(new bool[n]);
+      UTMUPS::Forward(n, lat, lon, zone, northx.get(), x, y, gamma, k,
+                      setzone);
+      for (size_t i = 0; i < n; ++i)
+        northp[i] = northx[i] ? 1 : 0;
+    });
+  }
+
+  int geographiclib_utmups_reverse(size_t n,
+                                   const int zone[], const int northp[],
+                                   const double x[], const double y[],
+                                   double lat[], double lon[],
+                                   double gamma[], double k[]) {
+    return guard([&]() -> void {
+      for (size_t i = 0; i < n; ++i) {
+        double gammax, kx;
+        UTMUPS::Reverse(zone[i], northp[i] != 0, x[i], y[i],
+                        lat[i], lon[i], gammax, kx);
+        if (gamma) gamma[i] = gammax;
+        if (k) k[i] = kx;
+      }
+    });
+  }
+
+  int geographiclib_mgrs_forward(size_t n,
+                                 const int zone[], const int northp[],
+                                 const double x[], const double y[],
+                                 int prec, char mgrs[], size_t stride) {
+    return guard([&]() -> void {
+      std::unique_ptr<bool[]> northx(new bool[n]);
+      for (size_t i = 0; i < n; ++i)
+        northx[i] = northp[i] != 0;
+      MGRS::Forward(n, zone, northx.get(), x, y, prec, mgrs, stride);
+    });
+  }
+
+  int geographiclib_mgrs_reverse(size_t n,
+                                 const char mgrs[], size_t stride,
+                                 int zone[], int northp[],
+                                 double x[], double y[], int prec[],
+                                 int centerp) {
+    return guard([&]() -> void {
+      std::unique_ptr<bool[]> northx(new bool[n]);
+      std::vector<int> precx(prec ? 0 : n);
+      MGRS::Reverse(n, mgrs, stride, zone, northx.get(), x, y,
+                    prec ? prec : precx.data(), centerp != 0);
+      for (size_t i = 0; i < n; ++i)
+        northp[i] = northx[i] ? 1 : 0;
+    });
+  }
+
+  geographiclib_geoid* geographiclib_geoid_new(const char* name,
+                                               const char* path,
+                                               int cubic, int threadsafe) {
+    return guardnew<geographiclib_geoid>
+      ([&]() { return new geographiclib_geoid(str(name), str(path),
+                                              cubic != 0, threadsafe != 0); });
+  }
+
+  void geographiclib_geoid_free(geographiclib_geoid* g) {
+    delete g;
+  }
+
+  int geographiclib_geoid_heights(const geographiclib_geoid* g, size_t n,
+                                  const double lat[], const double lon[],
+                                  double h[]) {
+    return guard([&]() -> void { g->g.Heights(n, lat, lon, h); });
+  }
+
+  geographiclib_gravity* geographiclib_gravity_new(const char* name,
+                                                   const char* path) {
+    return guardnew<geographiclib_gravity>
+      ([&]() { return new geographiclib_gravity(str(name), str(path)); });
+  }
+
+  void geographiclib_gravity_free(geographiclib_gravity* g) {
+    delete g;
+  }
+
+  int geographiclib_gravity_gravity(const geographiclib_gravity* g, size_t n,
+                                    const double lat[], const double lon[],
+                                    const double h[],
+                                    double gx[], double gy[], double gz[],
+                                    double W[]) {
+    return guard([&]() -> void {
+      g->g.GravityBatch(n, lat, lon, h, gx, gy, gz, W);
+    });
+  }
+
+  int geographiclib_gravity_geoidheight(const geographiclib_gravity* g,
+                                        size_t n,
+                                        const double lat[],
+                                        const double lon[], double N[]) {
+    return guard([&]() -> void { g->g.GeoidHeightBatch(n, lat, lon, N); });
+  }
+
+  geographiclib_magnetic* geographiclib_magnetic_new(const char* name,
+                                                     const char* path) {
+    return guardnew<geographiclib_magnetic>
+      ([&]() { return new geographiclib_magnetic(str(name), str(path)); });
+  }
+
+  void geographiclib_magnetic_free(geographiclib_magnetic* m) {
+    delete m;
+  }
+
+  int geographiclib_magnetic_field(const geographiclib_magnetic* m, size_t n,
+                                   const double t[],
+                                   const double lat[], const double lon[],
+                                   const double h[],
+                                   double Bx[], double By[], double Bz[]) {
+    return guard([&]() -> void {
+      for (size_t i = 0; i < n; ++i)
+        m->m(t[i], lat[i], lon[i], h[i], Bx[i], By[i], Bz[i]);
+    });
+  }
+
+}
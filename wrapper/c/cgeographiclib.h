@@ -0,0 +1,154 @@
+#if !defined(CGEOGRAPHICLIB_H)
+#define CGEOGRAPHICLIB_H 1
+
+/*
+ * A C interface to some of the classes in the GeographicLib C++ library.
+ *
+ * The C++ objects are represented by opaque handles which are created by
+ * the *_new functions and destroyed by the *_free functions.  The
+ * conversion functions operate on whole arrays of points so that the cost
+ * of crossing the language boundary is paid once per call instead of once
+ * per point.  Each array holds n elements.  Output arrays which may be null
+ * are noted; the corresponding quantities are then not computed, if this
+ * saves time.
+ *
+ * The functions returning int return 0 on success and -1 on failure; the
+ * *_new functions return null on failure.  In either case,
+ * geographiclib_lasterror returns a description of the error.  If an array
+ * function fails, the contents of its output arrays are unspecified.
+ * Booleans (hemispheres, etc.) are passed as ints (0 = false, nonzero =
+ * true).
+ *
+ * A handle may be used by several threads at once, except for Geoid
+ * handles created with threadsafe = 0 (the Geoid then reads its data on
+ * demand and caches it).
+ */
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+  /* The description of the last error in the calling thread. */
+  const char* geographiclib_lasterror(void);
+
+  /* Geodesic calculations on an ellipsoid with equatorial radius a and
+     flattening f. */
+  typedef struct geographiclib_geodesic geographiclib_geodesic;
+  geographiclib_geodesic* geographiclib_geodesic_new(double a, double f);
+  void geographiclib_geodesic_free(geographiclib_geodesic* g);
+  /* The inverse problems from (lat1, lon1) to (lat2, lon2); all the output
+     arrays may be null. */
+  int geographiclib_geodesic_inverse(const geographiclib_geodesic* g,
+                                     size_t n,
+                                     const double lat1[], const double lon1[],
+                                     const double lat2[], const double lon2[],
+                                     double s12[],
+                                     double azi1[], double azi2[],
+                                     double m12[],
+                                     double M12[], double M21[],
+                                     double S12[]);
+  /* The direct problems starting at (lat1, lon1) with azimuth azi1 and
+     distance s12; all the output arrays may be null. */
+  int geographiclib_geodesic_direct(const geographiclib_geodesic* g,
+                                    size_t n,
+                                    const double lat1[], const double lon1[],
+                                    const double azi1[], const double s12[],
+                                    double lat2[], double lon2[],
+                                    double azi2[],
+                                    double m12[],
+                                    double M12[], double M21[],
+                                    double S12[]);
+
+  /* The perimeters and areas of nrings polygons (or the lengths of
+     polylines, if polyline is nonzero), using the ellipsoid of g.  The
+     vertices of polygon k have indices in [offsets[k], offsets[k+1]).  area
+     may be null and isn't set for polylines.  See PolygonArea::Rings for
+     the meaning of reverse and sign. */
+  int geographiclib_polygon_rings(const geographiclib_geodesic* g,
+                                  int polyline, size_t nrings,
+                                  const size_t offsets[],
+                                  const double lat[], const double lon[],
+                                  int reverse, int sign,
+                                  double perimeter[], double area[]);
+
+  /* Geographic to UTM/UPS coordinates (zone = 0 for UPS); gamma and k may
+     be null.  setzone is as for UTMUPS::Forward (-1 = standard zone). */
+  int geographiclib_utmups_forward(size_t n,
+                                   const double lat[], const double lon[],
+                                   int zone[], int northp[],
+                                   double x[], double y[],
+                                   double gamma[], double k[], int setzone);
+  /* UTM/UPS to geographic coordinates; gamma and k may be null. */
+  int geographiclib_utmups_reverse(size_t n,
+                                   const int zone[], const int northp[],
+                                   const double x[], const double y[],
+                                   double lat[], double lon[],
+                                   double gamma[], double k[]);
+
+  /* UTM/UPS coordinates to MGRS strings with precision prec.  The
+     null-terminated string for point i starts at mgrs + i * stride; stride
+     = 28 suffices for all prec. */
+  int geographiclib_mgrs_forward(size_t n,
+                                 const int zone[], const int northp[],
+                                 const double x[], const double y[],
+                                 int prec, char mgrs[], size_t stride);
+  /* MGRS strings (laid out as for geographiclib_mgrs_forward) to UTM/UPS
+     coordinates; prec may be null.  If centerp is nonzero, the centers of
+     the MGRS squares are returned, otherwise their SW corners. */
+  int geographiclib_mgrs_reverse(size_t n,
+                                 const char mgrs[], size_t stride,
+                                 int zone[], int northp[],
+                                 double x[], double y[], int prec[],
+                                 int centerp);
+
+  /* The geoid model name (e.g., "egm2008-1") in the directory path (or the
+     default directory if path is null or empty). */
+  typedef struct geographiclib_geoid geographiclib_geoid;
+  geographiclib_geoid* geographiclib_geoid_new(const char* name,
+                                               const char* path,
+                                               int cubic, int threadsafe);
+  void geographiclib_geoid_free(geographiclib_geoid* g);
+  /* The heights of the geoid above the ellipsoid. */
+  int geographiclib_geoid_heights(const geographiclib_geoid* g, size_t n,
+                                  const double lat[], const double lon[],
+                                  double h[]);
+
+  /* The gravity model name (e.g., "egm96"); path as for
+     geographiclib_geoid_new. */
+  typedef struct geographiclib_gravity geographiclib_gravity;
+  geographiclib_gravity* geographiclib_gravity_new(const char* name,
+                                                   const char* path);
+  void geographiclib_gravity_free(geographiclib_gravity* g);
+  /* The acceleration (gx, gy, gz) and the potential W (which may be
+     null). */
+  int geographiclib_gravity_gravity(const geographiclib_gravity* g, size_t n,
+                                    const double lat[], const double lon[],
+                                    const double h[],
+                                    double gx[], double gy[], double gz[],
+                                    double W[]);
+  /* The heights of the geoid given by the gravity model. */
+  int geographiclib_gravity_geoidheight(const geographiclib_gravity* g,
+                                        size_t n,
+                                        const double lat[],
+                                        const double lon[], double N[]);
+
+  /* The magnetic model name (e.g., "wmm2020") on the WGS84 ellipsoid; path
+     as for geographiclib_geoid_new. */
+  typedef struct geographiclib_magnetic geographiclib_magnetic;
+  geographiclib_magnetic* geographiclib_magnetic_new(const char* name,
+                                                     const char* path);
+  void geographiclib_magnetic_free(geographiclib_magnetic* m);
+  /* The magnetic field (Bx, By, Bz) at times t (fractional years). */
+  int geographiclib_magnetic_field(const geographiclib_magnetic* m, size_t n,
+                                   const double t[],
+                                   const double lat[], const double lon[],
+                                   const double h[],
+                                   double Bx[], double By[], double Bz[]);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  /* CGEOGRAPHICLIB_H */
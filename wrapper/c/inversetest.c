@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "cgeographiclib.h"
+
+#if defined(_MSC_VER)
+/* Squelch warnings about scanf */
+#  pragma warning (disable: 4996)
+#endif
+
+/* Read lat1 lon1 lat2 lon2 from standard input; solve all the inverse
+   problems on the WGS84 ellipsoid with one call and print azi1 azi2 s12. */
+int main() {
+  size_t n = 0, cap = 0, i;
+  double *lat1 = 0, *lon1 = 0, *lat2 = 0, *lon2 = 0,
+    *s12 = 0, *azi1 = 0, *azi2 = 0, a, b, c, d;
+  geographiclib_geodesic* g;
+  while (scanf("%lf %lf %lf %lf", &a, &b, &c, &d) == 4) {
+    if (n == cap) {
+      cap = cap ? 2 * cap : 1024;
+      lat1 = realloc(lat1, cap * sizeof(double));
+      lon1 = realloc(lon1, cap * sizeof(double));
+      lat2 = realloc(lat2, cap * sizeof(double));
+      lon2 = realloc(lon2, cap * sizeof(double));
+      if (!(lat1 && lon1 && lat2 && lon2)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+      }
+    }
+    lat1[n] = a; lon1[n] = b; lat2[n] = c; lon2[n] = d; ++n;
+  }
+  s12 = malloc((n ? n : 1) * sizeof(double));
+  azi1 = malloc((n ? n : 1) * sizeof(double));
+  azi2 = malloc((n ? n : 1) * sizeof(double));
+  g = geographiclib_geodesic_new(6378137, 1/298.257223563);
+  if (!(s12 && azi1 && azi2 && g) ||
+      geographiclib_geodesic_inverse(g, n, lat1, lon1, lat2, lon2,
+                                     s12, azi1, azi2, 0, 0, 0, 0) != 0) {
+    fprintf(stderr, "Error: %s\n", geographiclib_lasterror());
+    return 1;
+  }
+  for (i = 0; i < n; ++i)
+    printf("%.8f %.8f %.3f\n", azi1[i], azi2[i], s12[i]);
+  geographiclib_geodesic_free(g);
+  free(lat1); free(lon1); free(lat2); free(lon2);
+  free(s12); free(azi1); free(azi2);
+  return 0;
+}
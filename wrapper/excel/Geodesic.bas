@@ -23,6 +23,29 @@ Private Declare PtrSafe Sub rinverse Lib "cgeodesic.dll" _
  ByVal lat2 As Double, ByVal lon2 As Double, _
  ByRef s12 As Double, ByRef azi12 As Double)
 
+'   The versions for whole columns; the arrays are passed by giving their
+'   first elements ByRef
+
+Private Declare PtrSafe Sub gdirectn Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef azi1 As Double, ByRef s12 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, ByRef azi2 As Double)
+
+Private Declare PtrSafe Sub ginversen Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, _
+ ByRef s12 As Double, ByRef azi1 As Double, ByRef azi2 As Double)
+
+Private Declare PtrSafe Sub rdirectn Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef azi12 As Double, ByRef s12 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double)
+
+Private Declare PtrSafe Sub rinversen Lib "cgeodesic.dll" _
+(ByVal n As Long, ByRef lat1 As Double, ByRef lon1 As Double, _
+ ByRef lat2 As Double, ByRef lon2 As Double, _
+ ByRef s12 As Double, ByRef azi12 As Double)
+
 '   Define the custom worksheet functions that call the DLL functions
 
 Function geodesic_direct_lat2(lat1 As Double, lon1 As Double, _
@@ -130,3 +153,123 @@ Function rhumb_inverse_azi12(lat1 As Double, lon1 As Double, _
   Call rinverse(lat1, lon1, lat2, lon2, s12, azi12)
   rhumb_inverse_azi12 = azi12
 End Function
+
+'   Define the array formulas which solve the problems for whole columns
+'   of cells with a single call to the DLL
+
+'   Copy a column range (or a single cell) into a Double array indexed
+'   from 1
+Private Function column_values(x As Variant) As Double()
+  Dim a As Variant
+  Dim v() As Double
+  Dim i As Long
+  Dim n As Long
+  a = x
+  If IsArray(a) Then
+    n = UBound(a, 1) - LBound(a, 1) + 1
+    ReDim v(1 To n)
+    For i = 1 To n
+      v(i) = a(LBound(a, 1) + i - 1, LBound(a, 2))
+    Next i
+  Else
+    ReDim v(1 To 1)
+    v(1) = a
+  End If
+  column_values = v
+End Function
+
+Function geodesic_direct(lat1 As Variant, lon1 As Variant, _
+                         azi1 As Variant, s12 As Variant) As Variant
+  Attribute geodesic_direct.VB_Description = _
+    "Solves direct geodesic problems for columns; returns lat2, lon2, azi2."
+  Dim la1() As Double, lo1() As Double, az1() As Double, s() As Double
+  Dim lat2() As Double, lon2() As Double, azi2() As Double
+  Dim res() As Variant
+  Dim n As Long, i As Long
+  la1 = column_values(lat1): lo1 = column_values(lon1)
+  az1 = column_values(azi1): s = column_values(s12)
+  n = UBound(la1)
+  If UBound(lo1) <> n Or UBound(az1) <> n Or UBound(s) <> n Then
+    geodesic_direct = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim lat2(1 To n): ReDim lon2(1 To n): ReDim azi2(1 To n)
+  Call gdirectn(n, la1(1), lo1(1), az1(1), s(1), lat2(1), lon2(1), azi2(1))
+  ReDim res(1 To n, 1 To 3)
+  For i = 1 To n
+    res(i, 1) = lat2(i): res(i, 2) = lon2(i): res(i, 3) = azi2(i)
+  Next i
+  geodesic_direct = res
+End Function
+
+Function geodesic_inverse(lat1 As Variant, lon1 As Variant, _
+                          lat2 As Variant, lon2 As Variant) As Variant
+  Attribute geodesic_inverse.VB_Description = _
+    "Solves inverse geodesic problems for columns; returns s12, azi1, azi2."
+  Dim la1() As Double, lo1() As Double, la2() As Double, lo2() As Double
+  Dim s12() As Double, azi1() As Double, azi2() As Double
+  Dim res() As Variant
+  Dim n As Long, i As Long
+  la1 = column_values(lat1): lo1 = column_values(lon1)
+  la2 = column_values(lat2): lo2 = column_values(lon2)
+  n = UBound(la1)
+  If UBound(lo1) <> n Or UBound(la2) <> n Or UBound(lo2) <> n Then
+    geodesic_inverse = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim s12(1 To n): ReDim azi1(1 To n): ReDim azi2(1 To n)
+  Call ginversen(n, la1(1), lo1(1), la2(1), lo2(1), s12(1), azi1(1), azi2(1))
+  ReDim res(1 To n, 1 To 3)
+  For i = 1 To n
+    res(i, 1) = s12(i): res(i, 2) = azi1(i): res(i, 3) = azi2(i)
+  Next i
+  geodesic_inverse = res
+End Function
+
+Function rhumb_direct(lat1 As Variant, lon1 As Variant, _
+                      azi12 As Variant, s12 As Variant) As Variant
+  Attribute rhumb_direct.VB_Description = _
+    "Solves direct rhumb problems for columns; returns lat2, lon2."
+  Dim la1() As Double, lo1() As Double, az12() As Double, s() As Double
+  Dim lat2() As Double, lon2() As Double
+  Dim res() As Variant
+  Dim n As Long, i As Long
+  la1 = column_values(lat1): lo1 = column_values(lon1)
+  az12 = column_values(azi12): s = column_values(s12)
+  n = UBound(la1)
+  If UBound(lo1) <> n Or UBound(az12) <> n Or UBound(s) <> n Then
+    rhumb_direct = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim lat2(1 To n): ReDim lon2(1 To n)
+  Call rdirectn(n, la1(1), lo1(1), az12(1), s(1), lat2(1), lon2(1))
+  ReDim res(1 To n, 1 To 2)
+  For i = 1 To n
+    res(i, 1) = lat2(i): res(i, 2) = lon2(i)
+  Next i
+  rhumb_direct = res
+End Function
+
+Function rhumb_inverse(lat1 As Variant, lon1 As Variant, _
+                       lat2 As Variant, lon2 As Variant) As Variant
+  Attribute rhumb_inverse.VB_Description = _
+    "Solves inverse rhumb problems for columns; returns s12, azi12."
+  Dim la1() As Double, lo1() As Double, la2() As Double, lo2() As Double
+  Dim s12() As Double, azi12() As Double
+  Dim res() As Variant
+  Dim n As Long, i As Long
+  la1 = column_values(lat1): lo1 = column_values(lon1)
+  la2 = column_values(lat2): lo2 = column_values(lon2)
+  n = UBound(la1)
+  If UBound(lo1) <> n Or UBound(la2) <> n Or UBound(lo2) <> n Then
+    rhumb_inverse = CVErr(xlErrValue)
+    Exit Function
+  End If
+  ReDim s12(1 To n): ReDim azi12(1 To n)
+  Call rinversen(n, la1(1), lo1(1), la2(1), lo2(1), s12(1), azi12(1))
+  ReDim res(1 To n, 1 To 2)
+  For i = 1 To n
+    res(i, 1) = s12(i): res(i, 2) = azi12(i)
+  Next i
+  rhumb_inverse = res
+End Function
@@ -1,7 +1,29 @@
+#include <algorithm>
+#include <functional>
+#include <thread>
 #include "cgeodesic.h"
+#include "GeographicLib/Executor.hpp"
 #include "GeographicLib/Geodesic.hpp"
 #include "GeographicLib/Rhumb.hpp"
 
+namespace {
+
+  // Call f(i0, i1) for pieces [i0, i1) of the n problems, one piece per
+  // core, but with at least 1024 problems per piece.
+  void pieces(int n, const std::function<void(int, int)>& f) {
+    const int minpiece = 1024;
+    if (n <= 0) return;
+    int nt = std::min(std::max(1, int(std::thread::hardware_concurrency())),
+                      std::max(1, n / minpiece));
+    // Piece t starts at t * q + min(t, r)
+    int q = n / nt, r = n % nt;
+    GeographicLib::Executor::Batch(nt, [&](int t) -> void {
+      f(t * q + std::min(t, r), (t + 1) * q + std::min(t + 1, r));
+    });
+  }
+
+}
+
 extern "C" {
 
   void gdirect(double lat1, double lon1, double azi1, double s12,
@@ -28,4 +50,52 @@ extern "C" {
                                           s12, azi12);
   }
 
+  void gdirectn(int n, const double lat1[], const double lon1[],
+                const double azi1[], const double s12[],
+                double lat2[], double lon2[], double azi2[]) {
+    using GeographicLib::Geodesic;
+    if (n <= 0) return;
+    int nthreads = std::max(1, int(std::thread::hardware_concurrency()));
+    Geodesic::WGS84().DirectBatch(size_t(n), lat1, lon1, azi1, false, s12,
+                                  Geodesic::LATITUDE | Geodesic::LONGITUDE |
+                                  Geodesic::AZIMUTH,
+                                  lat2, lon2, azi2,
+                                  nullptr, nullptr, nullptr, nullptr, nullptr,
+                                  nullptr, nthreads);
+  }
+
+  void ginversen(int n, const double lat1[], const double lon1[],
+                 const double lat2[], const double lon2[],
+                 double s12[], double azi1[], double azi2[]) {
+    using GeographicLib::Geodesic;
+    pieces(n, [=](int i0, int i1) -> void {
+      Geodesic::WGS84().InverseBatch(size_t(i1 - i0),
+                                     lat1 + i0, lon1 + i0,
+                                     lat2 + i0, lon2 + i0,
+                                     Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                                     s12 + i0, azi1 + i0, azi2 + i0,
+                                     nullptr, nullptr, nullptr, nullptr);
+    });
+  }
+
+  void rdirectn(int n, const double lat1[], const double lon1[],
+                const double azi12[], const double s12[],
+                double lat2[], double lon2[]) {
+    pieces(n, [=](int i0, int i1) -> void {
+      const GeographicLib::Rhumb& rh = GeographicLib::Rhumb::WGS84();
+      for (int i = i0; i < i1; ++i)
+        rh.Direct(lat1[i], lon1[i], azi12[i], s12[i], lat2[i], lon2[i]);
+    });
+  }
+
+  void rinversen(int n, const double lat1[], const double lon1[],
+                 const double lat2[], const double lon2[],
+                 double s12[], double azi12[]) {
+    pieces(n, [=](int i0, int i1) -> void {
+      const GeographicLib::Rhumb& rh = GeographicLib::Rhumb::WGS84();
+      for (int i = i0; i < i1; ++i)
+        rh.Inverse(lat1[i], lon1[i], lat2[i], lon2[i], s12[i], azi12[i]);
+    });
+  }
+
 }
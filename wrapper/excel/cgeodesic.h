@@ -17,6 +17,26 @@ extern "C" {
   void rinverse(double lat1, double lon1, double lat2, double lon2,
                 double& s12, double& azi12);
 
+  /* The versions for whole columns of n problems; each argument is an array
+     of n elements.  The problems are divided among the cores of the
+     machine. */
+
+  void gdirectn(int n, const double lat1[], const double lon1[],
+                const double azi1[], const double s12[],
+                double lat2[], double lon2[], double azi2[]);
+
+  void ginversen(int n, const double lat1[], const double lon1[],
+                 const double lat2[], const double lon2[],
+                 double s12[], double azi1[], double azi2[]);
+
+  void rdirectn(int n, const double lat1[], const double lon1[],
+                const double azi12[], const double s12[],
+                double lat2[], double lon2[]);
+
+  void rinversen(int n, const double lat1[], const double lon1[],
+                 const double lat2[], const double lon2[],
+                 double s12[], double azi12[]);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,213 @@
+/*
+ * geographiclib-batch.js: a typed-array interface to the WebAssembly build
+ * of GeographicLib (geographiclib-wasm.js + geographiclib-wasm.wasm).
+ *
+ * Usage:
+ *   const gl = await GeographicLibBatch(GeographicLibWasm);
+ *   const r = gl.inverse(lat1, lon1, lat2, lon2);  // Float64Arrays
+ *   // r.s12, r.azi1, r.azi2 are Float64Arrays
+ *
+ * Each function takes arrays of the same length (Float64Array or anything
+ * which can be converted to one) and returns new typed arrays.  The data is
+ * copied into the WebAssembly heap, all the points are processed with a
+ * single call to the C interface (wrapper/c/cgeographiclib.h), and the
+ * results are copied out.  Errors are thrown as Error objects.
+ *
+ * Copyright (c) Charles Karney (2023) <karney@alum.mit.edu> and licensed
+ * under the MIT/X11 License.  For more information, see
+ * https://geographiclib.sourceforge.io/
+ */
+
+async function GeographicLibBatch(factory, a, f) {
+  "use strict";
+  const M = await factory();
+  if (a === undefined) a = 6378137;
+  if (f === undefined) f = 1/298.257223563;
+
+  function check(status) {
+    if (status !== 0)
+      throw new Error(M.UTF8ToString(M._geographiclib_lasterror()));
+  }
+
+  // Scratch space on the heap, freed by release.
+  let ptrs = [];
+  function alloc(bytes) {
+    const p = M._malloc(Math.max(bytes, 8));
+    if (!p) throw new Error("Out of memory");
+    ptrs.push(p);
+    return p;
+  }
+  function release() {
+    ptrs.forEach(M._free);
+    ptrs = [];
+  }
+  // The views must be fetched after any allocation since the heap may grow.
+  function doublesin(x) {
+    const p = alloc(8 * x.length);
+    M.HEAPF64.set(x, p >> 3);
+    return p;
+  }
+  function intsin(x) {
+    const p = alloc(4 * x.length);
+    M.HEAP32.set(x, p >> 2);
+    return p;
+  }
+  function doublesout(p, n) {
+    return M.HEAPF64.slice(p >> 3, (p >> 3) + n);
+  }
+  function intsout(p, n) {
+    return M.HEAP32.slice(p >> 2, (p >> 2) + n);
+  }
+  function length(...arrays) {
+    const n = arrays[0].length;
+    arrays.forEach(function(x) {
+      if (x.length !== n) throw new Error("Arrays are not the same length");
+    });
+    return n;
+  }
+  function run(body) {
+    try {
+      return body();
+    } finally {
+      release();
+    }
+  }
+
+  const g = M._geographiclib_geodesic_new(a, f);
+  if (!g) check(-1);
+
+  return {
+    /* The inverse geodesic problems; returns {s12, azi1, azi2}. */
+    inverse: function(lat1, lon1, lat2, lon2) {
+      return run(function() {
+        const n = length(lat1, lon1, lat2, lon2),
+              plat1 = doublesin(lat1), plon1 = doublesin(lon1),
+              plat2 = doublesin(lat2), plon2 = doublesin(lon2),
+              ps12 = alloc(8 * n), pazi1 = alloc(8 * n), pazi2 = alloc(8 * n);
+        check(M._geographiclib_geodesic_inverse(g, n, plat1, plon1,
+                                                plat2, plon2,
+                                                ps12, pazi1, pazi2,
+                                                0, 0, 0, 0));
+        return {s12: doublesout(ps12, n),
+                azi1: doublesout(pazi1, n), azi2: doublesout(pazi2, n)};
+      });
+    },
+
+    /* The direct geodesic problems; returns {lat2, lon2, azi2}. */
+    direct: function(lat1, lon1, azi1, s12) {
+      return run(function() {
+        const n = length(lat1, lon1, azi1, s12),
+              plat1 = doublesin(lat1), plon1 = doublesin(lon1),
+              pazi1 = doublesin(azi1), ps12 = doublesin(s12),
+              plat2 = alloc(8 * n), plon2 = alloc(8 * n), pazi2 = alloc(8 * n);
+        check(M._geographiclib_geodesic_direct(g, n, plat1, plon1,
+                                               pazi1, ps12,
+                                               plat2, plon2, pazi2,
+                                               0, 0, 0, 0));
+        return {lat2: doublesout(plat2, n),
+                lon2: doublesout(plon2, n), azi2: doublesout(pazi2, n)};
+      });
+    },
+
+    /* The perimeters and areas of polygons whose vertices are given by
+       lat and lon; the vertices of polygon k have indices in [offsets[k],
+       offsets[k+1]).  If polyline is true, only the perimeters are
+       computed.  Returns {perimeter, area}. */
+    rings: function(offsets, lat, lon, polyline, reverse, sign) {
+      return run(function() {
+        const nrings = offsets.length - 1, n = length(lat, lon);
+        if (nrings < 0) throw new Error("Empty offsets array");
+        // size_t is 32 bits in wasm32
+        const poff = alloc(4 * offsets.length);
+        M.HEAPU32.set(offsets, poff >> 2);
+        if (M.HEAPU32[(poff >> 2) + nrings] > n)
+          throw new Error("Offsets exceed the number of vertices");
+        const plat = doublesin(lat), plon = doublesin(lon),
+              pper = alloc(8 * nrings), parea = alloc(8 * nrings);
+        check(M._geographiclib_polygon_rings(g, polyline ? 1 : 0, nrings,
+                                             poff, plat, plon,
+                                             reverse ? 1 : 0, sign ? 1 : 0,
+                                             pper, polyline ? 0 : parea));
+        return {perimeter: doublesout(pper, nrings),
+                area: polyline ? null : doublesout(parea, nrings)};
+      });
+    },
+
+    /* Geographic to UTM/UPS; returns {zone, northp, x, y} (zone and
+       northp are Int32Arrays). */
+    utmupsForward: function(lat, lon, setzone) {
+      return run(function() {
+        const n = length(lat, lon),
+              plat = doublesin(lat), plon = doublesin(lon),
+              pzone = alloc(4 * n), pnorth = alloc(4 * n),
+              px = alloc(8 * n), py = alloc(8 * n);
+        check(M._geographiclib_utmups_forward(n, plat, plon, pzone, pnorth,
+                                              px, py, 0, 0,
+                                              setzone === undefined ?
+                                              -1 : setzone));
+        return {zone: intsout(pzone, n), northp: intsout(pnorth, n),
+                x: doublesout(px, n), y: doublesout(py, n)};
+      });
+    },
+
+    /* UTM/UPS to geographic; returns {lat, lon}. */
+    utmupsReverse: function(zone, northp, x, y) {
+      return run(function() {
+        const n = length(zone, northp, x, y),
+              pzone = intsin(zone), pnorth = intsin(northp),
+              px = doublesin(x), py = doublesin(y),
+              plat = alloc(8 * n), plon = alloc(8 * n);
+        check(M._geographiclib_utmups_reverse(n, pzone, pnorth, px, py,
+                                              plat, plon, 0, 0));
+        return {lat: doublesout(plat, n), lon: doublesout(plon, n)};
+      });
+    },
+
+    /* UTM/UPS to MGRS with precision prec; returns an array of strings. */
+    mgrsForward: function(zone, northp, x, y, prec) {
+      return run(function() {
+        const n = length(zone, northp, x, y), stride = 28,
+              pzone = intsin(zone), pnorth = intsin(northp),
+              px = doublesin(x), py = doublesin(y),
+              pmgrs = alloc(stride * n);
+        check(M._geographiclib_mgrs_forward(n, pzone, pnorth, px, py,
+                                            prec, pmgrs, stride));
+        const mgrs = new Array(n);
+        for (let i = 0; i < n; ++i)
+          mgrs[i] = M.UTF8ToString(pmgrs + i * stride);
+        return mgrs;
+      });
+    },
+
+    /* MGRS strings to UTM/UPS; returns {zone, northp, x, y, prec}. */
+    mgrsReverse: function(mgrs, centerp) {
+      return run(function() {
+        const n = mgrs.length, stride = 28, pmgrs = alloc(stride * n),
+              pzone = alloc(4 * n), pnorth = alloc(4 * n),
+              px = alloc(8 * n), py = alloc(8 * n), pprec = alloc(4 * n);
+        for (let i = 0; i < n; ++i) {
+          const s = String(mgrs[i]);
+          // Longer strings are illegal anyway; truncating them to the stride
+          // ensures that an error is signaled.
+          for (let j = 0; j < stride; ++j)
+            M.HEAPU8[pmgrs + i * stride + j] =
+              j < s.length ? s.charCodeAt(j) & 0xff : 0;
+        }
+        check(M._geographiclib_mgrs_reverse(n, pmgrs, stride, pzone, pnorth,
+                                            px, py, pprec,
+                                            centerp === false ? 0 : 1));
+        return {zone: intsout(pzone, n), northp: intsout(pnorth, n),
+                x: doublesout(px, n), y: doublesout(py, n),
+                prec: intsout(pprec, n)};
+      });
+    },
+
+    /* Free the underlying Geodesic object. */
+    free: function() {
+      M._geographiclib_geodesic_free(g);
+    }
+  };
+}
+
+if (typeof module !== "undefined" && module.exports)
+  module.exports = GeographicLibBatch;
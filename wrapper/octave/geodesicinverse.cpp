@@ -16,6 +16,8 @@
 //    -lGeographicLib geodesicinverse.cpp
 
 #include <algorithm>
+#include <thread>
+#include <GeographicLib/Executor.hpp>
 #include <GeographicLib/Geodesic.hpp>
 #include <GeographicLib/GeodesicExact.hpp>
 #include <mex.h>
@@ -47,16 +49,29 @@ compute(double a, double f, mwSize m, const double* latlong,
   }
 
   const G g(a, f);
+  unsigned outmask = G::DISTANCE | G::AZIMUTH |
+    (aux ? G::REDUCEDLENGTH | G::GEODESICSCALE | G::AREA : G::NONE);
+  // The rows are divided into pieces, one per core (but with at least 1024
+  // rows per piece), and each piece is solved with a single call to the
+  // batch solver.
+  mwSize nt = min(mwSize(max(1u, thread::hardware_concurrency())),
+                  max(mwSize(1), m / 1024)),
+    q = m / nt, r = m % nt;
+  Executor::Batch(int(nt), [&](int t) -> void {
+    mwSize i0 = t * q + min(mwSize(t), r), i1 = i0 + q + (mwSize(t) < r);
+    g.InverseBatch(i1 - i0, lat1 + i0, lon1 + i0, lat2 + i0, lon2 + i0,
+                   outmask, s12 + i0, azi1 + i0, azi2 + i0,
+                   aux ? m12 + i0 : NULL, aux ? M12 + i0 : NULL,
+                   aux ? M21 + i0 : NULL, aux ? S12 + i0 : NULL,
+                   aux ? a12 + i0 : NULL);
+  });
+  // Rows with invalid coordinates return NaNs
   for (mwIndex i = 0; i < m; ++i) {
-    if (abs(lat1[i]) <= 90 && lon1[i] >= -540 && lon1[i] < 540 &&
-        abs(lat2[i]) <= 90 && lon2[i] >= -540 && lon2[i] < 540) {
+    if (!(abs(lat1[i]) <= 90 && lon1[i] >= -540 && lon1[i] < 540 &&
+          abs(lat2[i]) <= 90 && lon2[i] >= -540 && lon2[i] < 540)) {
+      azi1[i] = azi2[i] = s12[i] = Math::NaN<double>();
       if (aux)
-        a12[i] = g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i],
-                           s12[i], azi1[i], azi2[i],
-                           m12[i], M12[i], M21[i], S12[i]);
-      else
-        g.Inverse(lat1[i], lon1[i], lat2[i], lon2[i],
-                  s12[i], azi1[i], azi2[i]);
+        a12[i] = m12[i] = M12[i] = M21[i] = S12[i] = Math::NaN<double>();
     }
   }
 }
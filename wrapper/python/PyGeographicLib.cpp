@@ -1,7 +1,14 @@
 #include <boost/python.hpp>
+#include <boost/python/numpy.hpp>
+#include <memory>
 #include <GeographicLib/Geoid.hpp>
+#include <GeographicLib/Geodesic.hpp>
+#include <GeographicLib/UTMUPS.hpp>
+#include <GeographicLib/GravityModel.hpp>
+#include <GeographicLib/MagneticModel.hpp>
 
 using namespace boost::python;
+namespace np = boost::python::numpy;
 using namespace GeographicLib;
 
 double EllipsoidHeight(Geoid& geoid,
@@ -9,13 +16,259 @@ double EllipsoidHeight(Geoid& geoid,
   return hmsl + Geoid::GEOIDTOELLIPSOID * geoid(lat, lon);
 }
 
+namespace {
+
+  // Release the GIL for the lifetime of this object.  The C++ calls made
+  // meanwhile must not touch any python objects.
+  class NoGIL {
+  private:
+    PyThreadState* _state;
+  public:
+    NoGIL() : _state(PyEval_SaveThread()) {}
+    ~NoGIL() { PyEval_RestoreThread(_state); }
+  };
+
+  // A view of an array-like python object as a contiguous array of T.  This
+  // is zero-copy if the object is already a C-contiguous numpy array of T;
+  // otherwise it's converted.
+  template<typename T>
+  class Array {
+  private:
+    np::ndarray _a;
+  public:
+    explicit Array(const object& obj)
+      : _a(np::from_object(obj, np::dtype::get_builtin<T>(),
+                           np::ndarray::bitflag(np::ndarray::C_CONTIGUOUS |
+                                                np::ndarray::ALIGNED))) {}
+    // A new array of T with the same shape as a.
+    template<typename S>
+    explicit Array(const Array<S>& a)
+      : _a(np::empty(a.ndarray().get_nd(), a.ndarray().get_shape(),
+                     np::dtype::get_builtin<T>())) {}
+    const np::ndarray& ndarray() const { return _a; }
+    size_t size() const {
+      size_t n = 1;
+      for (int i = 0; i < _a.get_nd(); ++i)
+        n *= size_t(_a.shape(i));
+      return n;
+    }
+    T* data() const { return reinterpret_cast<T*>(_a.get_data()); }
+  };
+
+  typedef Array<double> Doubles;
+
+  // Check that the arrays have the same number of elements.
+  size_t Size(const Doubles& a, const Doubles& b) {
+    if (a.size() != b.size())
+      throw GeographicErr("Arrays are not the same size");
+    return a.size();
+  }
+  size_t Size(const Doubles& a, const Doubles& b, const Doubles& c) {
+    if (Size(a, b) != c.size())
+      throw GeographicErr("Arrays are not the same size");
+    return a.size();
+  }
+  size_t Size(const Doubles& a, const Doubles& b,
+              const Doubles& c, const Doubles& d) {
+    if (Size(a, b, c) != d.size())
+      throw GeographicErr("Arrays are not the same size");
+    return a.size();
+  }
+
+  np::ndarray GeoidHeights(const Geoid& geoid,
+                           const object& latobj, const object& lonobj) {
+    Doubles lat(latobj), lon(lonobj), h(lat);
+    size_t n = Size(lat, lon);
+    if (geoid.ThreadSafe()) {
+      NoGIL nogil;
+      geoid.Heights(n, lat.data(), lon.data(), h.data());
+    } else
+      // A Geoid which isn't thread safe reads its data file on demand; so
+      // keep the GIL to prevent concurrent calls.
+      geoid.Heights(n, lat.data(), lon.data(), h.data());
+    return h.ndarray();
+  }
+
+  np::ndarray EllipsoidHeights(const Geoid& geoid,
+                               const object& latobj, const object& lonobj,
+                               const object& hmslobj) {
+    Doubles hmsl(hmslobj);
+    np::ndarray N = GeoidHeights(geoid, latobj, lonobj);
+    Doubles h(N);
+    if (h.size() != hmsl.size())
+      throw GeographicErr("Arrays are not the same size");
+    for (size_t i = 0; i < h.size(); ++i)
+      h.data()[i] = hmsl.data()[i] + Geoid::GEOIDTOELLIPSOID * h.data()[i];
+    return h.ndarray();
+  }
+
+  tuple GeodesicInverse(const Geodesic& g,
+                        const object& lat1obj, const object& lon1obj,
+                        const object& lat2obj, const object& lon2obj) {
+    Doubles lat1(lat1obj), lon1(lon1obj), lat2(lat2obj), lon2(lon2obj),
+      s12(lat1), azi1(lat1), azi2(lat1);
+    size_t n = Size(lat1, lon1, lat2, lon2);
+    {
+      NoGIL nogil;
+      g.InverseBatch(n, lat1.data(), lon1.data(), lat2.data(), lon2.data(),
+                     Geodesic::DISTANCE | Geodesic::AZIMUTH,
+                     s12.data(), azi1.data(), azi2.data(),
+                     nullptr, nullptr, nullptr, nullptr);
+    }
+    return make_tuple(s12.ndarray(), azi1.ndarray(), azi2.ndarray());
+  }
+
+  tuple GeodesicDirect(const Geodesic& g,
+                       const object& lat1obj, const object& lon1obj,
+                       const object& azi1obj, const object& s12obj) {
+    Doubles lat1(lat1obj), lon1(lon1obj), azi1(azi1obj), s12(s12obj),
+      lat2(lat1), lon2(lat1), azi2(lat1);
+    size_t n = Size(lat1, lon1, azi1, s12);
+    {
+      NoGIL nogil;
+      for (size_t i = 0; i < n; ++i)
+        g.Direct(lat1.data()[i], lon1.data()[i], azi1.data()[i],
+                 s12.data()[i],
+                 lat2.data()[i], lon2.data()[i], azi2.data()[i]);
+    }
+    return make_tuple(lat2.ndarray(), lon2.ndarray(), azi2.ndarray());
+  }
+
+  tuple UTMUPSForward(const object& latobj, const object& lonobj,
+                      int setzone) {
+    Doubles lat(latobj), lon(lonobj), x(lat), y(lat);
+    Array<int> zone(lat);
+    Array<bool> northp(lat);
+    size_t n = Size(lat, lon);
+    {
+      NoGIL nogil;
+      UTMUPS::Forward(n, lat.data(), lon.data(), zone.data(), northp.data(),
+                      x.data(), y.data(), nullptr, nullptr, setzone);
+    }
+    return make_tuple(zone.ndarray(), northp.ndarray(),
+                      x.ndarray(), y.ndarray());
+  }
+
+  tuple UTMUPSReverse(const object& zoneobj, const object& northpobj,
+                      const object& xobj, const object& yobj) {
+    Array<int> zone(zoneobj);
+    Array<bool> northp(northpobj);
+    Doubles x(xobj), y(yobj), lat(x), lon(x);
+    size_t n = Size(x, y);
+    if (zone.size() != n || northp.size() != n)
+      throw GeographicErr("Arrays are not the same size");
+    {
+      NoGIL nogil;
+      for (size_t i = 0; i < n; ++i)
+        UTMUPS::Reverse(zone.data()[i], northp.data()[i],
+                        x.data()[i], y.data()[i],
+                        lat.data()[i], lon.data()[i]);
+    }
+    return make_tuple(lat.ndarray(), lon.ndarray());
+  }
+
+  tuple Gravity(const GravityModel& g,
+                const object& latobj, const object& lonobj,
+                const object& hobj) {
+    Doubles lat(latobj), lon(lonobj), h(hobj), gx(lat), gy(lat), gz(lat);
+    size_t n = Size(lat, lon, h);
+    {
+      NoGIL nogil;
+      g.GravityBatch(n, lat.data(), lon.data(), h.data(),
+                     gx.data(), gy.data(), gz.data());
+    }
+    return make_tuple(gx.ndarray(), gy.ndarray(), gz.ndarray());
+  }
+
+  np::ndarray GravityGeoidHeight(const GravityModel& g,
+                                 const object& latobj, const object& lonobj) {
+    Doubles lat(latobj), lon(lonobj), N(lat);
+    size_t n = Size(lat, lon);
+    {
+      NoGIL nogil;
+      g.GeoidHeightBatch(n, lat.data(), lon.data(), N.data());
+    }
+    return N.ndarray();
+  }
+
+  tuple MagneticField(const MagneticModel& m, const object& tobj,
+                      const object& latobj, const object& lonobj,
+                      const object& hobj) {
+    Doubles t(tobj), lat(latobj), lon(lonobj), h(hobj),
+      Bx(lat), By(lat), Bz(lat);
+    size_t n = Size(t, lat, lon, h);
+    {
+      NoGIL nogil;
+      for (size_t i = 0; i < n; ++i)
+        m(t.data()[i], lat.data()[i], lon.data()[i], h.data()[i],
+          Bx.data()[i], By.data()[i], Bz.data()[i]);
+    }
+    return make_tuple(Bx.ndarray(), By.ndarray(), Bz.ndarray());
+  }
+
+}
+
 BOOST_PYTHON_MODULE(PyGeographicLib) {
 
+  np::initialize();
+
   class_<Geoid, boost::noncopyable>("Geoid", init<std::string>())
+    .def(init<std::string, std::string, bool, bool>())
     .def("EllipsoidHeight", &EllipsoidHeight,
          "Return geoid height:\n\
     input: lat, lon, height_above_geoid\n\
     output: height_above_ellipsoid")
+    .def("Heights", &GeoidHeights,
+         "Return the heights of the geoid above the ellipsoid:\n\
+    input: arrays lat, lon\n\
+    output: array height")
+    .def("EllipsoidHeights", &EllipsoidHeights,
+         "Return heights above the ellipsoid:\n\
+    input: arrays lat, lon, height_above_geoid\n\
+    output: array height_above_ellipsoid")
+    ;
+
+  class_<Geodesic>("Geodesic", init<double, double>())
+    .def("Inverse", &GeodesicInverse,
+         "Solve the inverse geodesic problems:\n\
+    input: arrays lat1, lon1, lat2, lon2\n\
+    output: tuple of arrays (s12, azi1, azi2)")
+    .def("Direct", &GeodesicDirect,
+         "Solve the direct geodesic problems:\n\
+    input: arrays lat1, lon1, azi1, s12\n\
+    output: tuple of arrays (lat2, lon2, azi2)")
+    ;
+
+  def("UTMUPSForward", &UTMUPSForward,
+      (arg("lat"), arg("lon"), arg("setzone") = int(UTMUPS::STANDARD)),
+      "Convert geographic coordinates to UTM/UPS:\n\
+    input: arrays lat, lon, optional setzone\n\
+    output: tuple of arrays (zone, northp, x, y)");
+  def("UTMUPSReverse", &UTMUPSReverse,
+      "Convert UTM/UPS coordinates to geographic:\n\
+    input: arrays zone, northp, x, y\n\
+    output: tuple of arrays (lat, lon)");
+
+  class_<GravityModel, boost::noncopyable>("GravityModel",
+                                           init<std::string>())
+    .def(init<std::string, std::string>())
+    .def("Gravity", &Gravity,
+         "Return the acceleration due to gravity:\n\
+    input: arrays lat, lon, h\n\
+    output: tuple of arrays (gx, gy, gz)")
+    .def("GeoidHeight", &GravityGeoidHeight,
+         "Return the heights of the geoid above the ellipsoid:\n\
+    input: arrays lat, lon\n\
+    output: array height")
+    ;
+
+  class_<MagneticModel, boost::noncopyable>("MagneticModel",
+                                            init<std::string>())
+    .def(init<std::string, std::string>())
+    .def("Field", &MagneticField,
+         "Return the magnetic field:\n\
+    input: arrays t, lat, lon, h\n\
+    output: tuple of arrays (Bx, By, Bz)")
     ;
 
 }